@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+  * @file           : bench.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_BENCH_HPP
+#define METAL_PLAYGROUND_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+// the benchmarks are plain executables printing one line per measurement, run them by
+// hand from a release build: cmake -DCMAKE_BUILD_TYPE=Release
+
+// keeps a result alive so the optimizer can not drop the work that made it
+template <typename T>
+inline void keepAlive( const T& value )
+{
+    asm volatile( "" : : "r,m"( value ) : "memory" );
+}
+
+// calls fn until minSeconds passed, at least once, and returns the seconds per call
+template <typename Fn>
+double timePerCall( Fn&& fn, double minSeconds = 0.25 )
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    size_t calls = 0;
+    double elapsed = 0.0;
+    do
+    {
+        fn();
+        ++calls;
+        elapsed = std::chrono::duration<double>( Clock::now() - start ).count();
+    } while ( elapsed < minSeconds );
+    return elapsed / (double)calls;
+}
+
+inline void report( const char* name, double value, const char* unit )
+{
+    __builtin_printf( "%-48s %12.3f %s\n", name, value, unit );
+}
+
+
+#endif //METAL_PLAYGROUND_BENCH_HPP
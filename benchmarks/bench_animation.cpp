@@ -0,0 +1,128 @@
+/**
+  ******************************************************************************
+  * @file           : bench_animation.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "animation.hpp"
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+static constexpr size_t kTrackCount = 64;
+static constexpr size_t kFrameCount = 300;
+static constexpr float kSampleRate = 30.f;
+
+// a crowd's worth of tracks, sampling reads two rows whatever the clip length so a
+// short clip keeps the raw keys small
+static constexpr size_t kCrowdTrackCounts[] = { 64, 1024, 4096, 16384 };
+static constexpr size_t kCrowdFrameCount = 30;
+
+// skeletons of 64 tracks swinging at different speeds
+static std::vector<Transform> makeRawKeys( size_t trackCount, size_t frameCount )
+{
+    std::vector<Transform> keys( trackCount * frameCount );
+    for ( size_t f = 0; f < frameCount; ++f )
+    {
+        for ( size_t t = 0; t < trackCount; ++t )
+        {
+            const float phase = (float)f / kSampleRate * ( 1.f + 0.1f * (float)( t % 64 ) );
+            const float half = 0.5f * sinf( phase );
+            const float axis = sinf( half ) / sqrtf( 1.f + 0.25f + 0.0625f );
+
+            Transform& key = keys[ f * trackCount + t ];
+            key.rotation = { axis, 0.5f * axis, 0.25f * axis, cosf( half ) };
+            key.translation = { 0.1f * (float)t, 0.3f * cosf( phase ), 0.f };
+            key.scale = { 1.f, 1.f + 0.1f * sinf( phase * 2.f ), 1.f };
+        }
+    }
+    return keys;
+}
+
+int main()
+{
+    const std::vector<Transform> raw = makeRawKeys( kTrackCount, kFrameCount );
+
+    AnimationClip clip;
+    const double compressSeconds = timePerCall( [&] {
+        clip = AnimationClip::compress( raw.data(), kTrackCount, kFrameCount, kSampleRate );
+    } );
+    report( "compress", (double)raw.size() / compressSeconds, "keys/s" );
+    report( "compressed size", (double)clip.sizeInBytes() / (double)raw.size(), "bytes/key" );
+    report( "raw size", (double)sizeof( Transform ), "bytes/key" );
+
+    // unpacking alone, the part of sampling that decompression costs
+    std::vector<shader_layout::host_float4> rotations( kTrackCount );
+    const double unpackSeconds = timePerCall( [&] {
+        for ( size_t f = 0; f < kFrameCount; ++f )
+        {
+            const PackedKey* row = clip.frame( f );
+            for ( size_t t = 0; t < kTrackCount; ++t )
+            {
+                rotations[ t ] = AnimationSampler::unpackRotation( row[ t ].rotation );
+            }
+        }
+        keepAlive( rotations[ 0 ] );
+    } );
+    report( "unpack rotation", (double)( kTrackCount * kFrameCount ) / unpackSeconds, "keys/s" );
+
+    // a pose at a time that falls between frames, two rows unpacked and blended per call
+    std::vector<Transform> pose( kTrackCount );
+    float time = 0.f;
+    const double sampleSeconds = timePerCall( [&] {
+        AnimationSampler::sample( clip, time, pose.data() );
+        time += 1.f / 61.f;
+        keepAlive( pose[ 0 ] );
+    } );
+    report( "sample", (double)kTrackCount / sampleSeconds, "tracks/s" );
+
+    // the same per track cost is expected once the rows no longer fit the cache
+    for ( size_t trackCount : kCrowdTrackCounts )
+    {
+        const std::vector<Transform> crowdRaw = makeRawKeys( trackCount, kCrowdFrameCount );
+        const AnimationClip crowd = AnimationClip::compress( crowdRaw.data(), trackCount, kCrowdFrameCount, kSampleRate );
+        std::vector<Transform> crowdPose( trackCount );
+        float crowdTime = 0.f;
+        const double crowdSeconds = timePerCall( [&] {
+            AnimationSampler::sample( crowd, crowdTime, crowdPose.data() );
+            crowdTime += 1.f / 61.f;
+            keepAlive( crowdPose[ 0 ] );
+        } );
+        char name[ 48 ];
+        snprintf( name, sizeof( name ), "sample %zu tracks", trackCount );
+        report( name, (double)trackCount / crowdSeconds, "tracks/s" );
+    }
+
+    std::vector<shader_layout::host_float4x4> matrices( kTrackCount );
+    const double matrixSeconds = timePerCall( [&] {
+        AnimationSampler::toMatrices( pose.data(), kTrackCount, matrices.data() );
+        keepAlive( matrices[ 0 ] );
+    } );
+    report( "to matrices", (double)kTrackCount / matrixSeconds, "tracks/s" );
+
+    // how far the compressed keys are from the raw ones, sampled on the frames
+    float rotationError = 0.f, translationError = 0.f;
+    for ( size_t f = 0; f < kFrameCount - 1; ++f )
+    {
+        AnimationSampler::sample( clip, (float)f / kSampleRate, pose.data() );
+        for ( size_t t = 0; t < kTrackCount; ++t )
+        {
+            const Transform& a = raw[ f * kTrackCount + t ];
+            const Transform& b = pose[ t ];
+            const float d = fabsf( a.rotation.x * b.rotation.x + a.rotation.y * b.rotation.y + a.rotation.z * b.rotation.z + a.rotation.w * b.rotation.w );
+            rotationError = fmaxf( rotationError, 2.f * acosf( fminf( d, 1.f ) ) );
+            translationError = fmaxf( translationError, fabsf( a.translation.y - b.translation.y ) );
+        }
+    }
+    report( "max rotation error", rotationError * 180.f / (float)M_PI, "degrees" );
+    report( "max translation error", translationError, "units" );
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+  ******************************************************************************
+  * @file           : bench_asset_file.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "asset_file.hpp"
+#include "bench.hpp"
+#include "job_system.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static constexpr size_t kAssetSize = 64 << 20;
+
+// vertex like data, positions on a smooth surface with quantized normals and uvs,
+// about what the samples stream. compresses to about a third
+static std::vector<uint8_t> makeMeshData( size_t size )
+{
+    std::vector<uint8_t> data( size );
+    float* f = (float*)data.data();
+    const size_t count = size / sizeof( float );
+    for ( size_t i = 0; i + 8 <= count; i += 8 )
+    {
+        const float t = (float)( i / 8 ) * 0.001f;
+        f[ i + 0 ] = roundf( cosf( t ) * 1024.f ) / 1024.f;
+        f[ i + 1 ] = roundf( sinf( t * 0.5f ) * 1024.f ) / 1024.f;
+        f[ i + 2 ] = roundf( t * 64.f ) / 1024.f;
+        f[ i + 3 ] = 1.f;
+        f[ i + 4 ] = 0.f;
+        f[ i + 5 ] = 1.f;
+        f[ i + 6 ] = (float)( ( i / 8 ) % 256 ) / 256.f;
+        f[ i + 7 ] = (float)( ( i / 2048 ) % 256 ) / 256.f;
+    }
+    return data;
+}
+
+// already compressed textures and the like, every chunk is stored as is
+static std::vector<uint8_t> makeNoise( size_t size )
+{
+    std::vector<uint8_t> data( size );
+    std::mt19937 rng( 1 );
+    for ( uint8_t& b : data )
+    {
+        b = (uint8_t)rng();
+    }
+    return data;
+}
+
+// a plain pread of the whole file, what the reader has to come close to
+static double readRaw( const char* path, std::vector<uint8_t>& dst, size_t size )
+{
+    const int fd = open( path, O_RDONLY );
+    if ( fd < 0 )
+    {
+        return 0.0;
+    }
+    dst.resize( size );
+    const double seconds = timePerCall( [&] {
+        size_t done = 0;
+        while ( done < size )
+        {
+            const ssize_t n = pread( fd, dst.data() + done, size - done, (off_t)done );
+            if ( n <= 0 )
+            {
+                break;
+            }
+            done += (size_t)n;
+        }
+        keepAlive( dst[ size - 1 ] );
+    } );
+    close( fd );
+    return seconds;
+}
+
+static void benchAsset( const char* name, const std::vector<uint8_t>& data, const char* path )
+{
+    JobSystem writer( 4 );
+    if ( !writeAssetFile( path, data.data(), data.size(), writer ) )
+    {
+        __builtin_printf( "failed to write %s\n", path );
+        return;
+    }
+
+    AssetFileReader reader;
+    if ( !reader.open( path ) )
+    {
+        __builtin_printf( "failed to open %s\n", path );
+        remove( path );
+        return;
+    }
+
+    char line[ 64 ];
+    snprintf( line, sizeof( line ), "%s, compressed", name );
+    report( line, 100.0 * (double)reader.compressedSize() / (double)reader.size(), "% of size" );
+
+    // the file is in the page cache after writing it, so this is the cost of the reads
+    // and the decompression, not of the disk
+    std::vector<uint8_t> raw;
+    const size_t fileSize = (size_t)reader.compressedSize();
+    const double rawSeconds = readRaw( path, raw, fileSize );
+    snprintf( line, sizeof( line ), "%s, pread of the file", name );
+    report( line, (double)fileSize / rawSeconds / ( 1 << 30 ), "gb/s" );
+
+    std::vector<uint8_t> dst( reader.size() );
+    for ( size_t threads : { 1, 2, 4 } )
+    {
+        JobSystem jobs( threads );
+        for ( size_t batch : { 1, 16 } )
+        {
+            bool ok = true;
+            const double seconds = timePerCall( [&] {
+                ok = reader.read( jobs, dst.data(), batch ) && ok;
+                keepAlive( dst[ dst.size() - 1 ] );
+            } );
+            snprintf( line, sizeof( line ), "%s, read, %zu threads, %zu chunks a read", name, threads, batch );
+            report( line, ok ? (double)reader.size() / seconds / ( 1 << 30 ) : 0.0, "gb/s" );
+        }
+    }
+
+    reader.close();
+    remove( path );
+}
+
+int main( int argc, char** argv )
+{
+    // the file goes next to the executable unless a directory on the disk to measure is given
+    const char* dir = argc > 1 ? argv[ 1 ] : ".";
+    char path[ 512 ];
+    snprintf( path, sizeof( path ), "%s/bench_asset_file.tmp", dir );
+
+    benchAsset( "mesh data", makeMeshData( kAssetSize ), path );
+    benchAsset( "noise", makeNoise( kAssetSize ), path );
+    return 0;
+}
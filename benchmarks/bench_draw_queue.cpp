@@ -0,0 +1,126 @@
+/**
+  ******************************************************************************
+  * @file           : bench_draw_queue.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "draw_queue.hpp"
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <vector>
+
+static constexpr size_t kPacketCount = 100000;
+static constexpr uint32_t kPipelines = 8;
+static constexpr uint32_t kMaterials = 64;
+
+// counts what replay forwards, the cost of a real encoder left out
+struct CountingBackend
+{
+    size_t calls = 0;
+    uint64_t checksum = 0;
+
+    void setPipeline( uint16_t v ) { ++calls; checksum += v; }
+    void setDepthStencil( uint16_t v ) { ++calls; checksum += v; }
+    void setMaterial( uint16_t v ) { ++calls; checksum += v; }
+    void setCullMode( uint8_t v ) { ++calls; checksum += v; }
+    void draw( const DrawPacket& p ) { checksum += p.baseInstance; }
+};
+
+// the same state hostile order 10-draw-queue submits in
+static DrawPacket makePacket( size_t i )
+{
+    DrawPacket packet = {};
+    packet.pipeline = (uint16_t)( ( i / 7 ) % kPipelines );
+    packet.material = (uint16_t)( ( i * 2654435761u ) % kMaterials );
+    packet.cullMode = (uint8_t)( i % 4 == 0 ? 0 : 2 );
+    packet.indexCount = 36;
+    packet.instanceCount = 1;
+    packet.baseInstance = (uint32_t)i;
+
+    const float depth = (float)( ( i * 40503u ) % 65536u ) / 65536.f;
+    packet.key = DrawKey::make( 0, packet.pipeline, packet.material, DrawKey::quantizeDepth( depth ) );
+    return packet;
+}
+
+int main()
+{
+    std::vector<DrawPacket> packets( kPacketCount );
+    for ( size_t i = 0; i < kPacketCount; ++i )
+    {
+        packets[ i ] = makePacket( i );
+    }
+
+    DrawQueue queue( kPacketCount );
+
+    const double pushSeconds = timePerCall( [&] {
+        queue.clear();
+        for ( const DrawPacket& packet : packets )
+        {
+            queue.push( packet );
+        }
+    } );
+    report( "push, 1 thread", (double)kPacketCount / pushSeconds * 1e-6, "Mpackets/s" );
+
+    JobSystem jobs( 4 );
+    const double parallelPushSeconds = timePerCall( [&] {
+        queue.clear();
+        jobs.parallelFor( kPacketCount, 4096, [&]( size_t begin, size_t end ) {
+            for ( size_t i = begin; i < end; ++i )
+            {
+                queue.push( packets[ i ] );
+            }
+        } );
+    } );
+    report( "push, 4 threads", (double)kPacketCount / parallelPushSeconds * 1e-6, "Mpackets/s" );
+
+    // sort refills the queue in submission order first, so every call sorts from scratch
+    const double fillSeconds = timePerCall( [&] {
+        queue.clear();
+        for ( const DrawPacket& packet : packets )
+        {
+            queue.push( packet );
+        }
+    } );
+    const double sortSeconds = timePerCall( [&] {
+        queue.clear();
+        for ( const DrawPacket& packet : packets )
+        {
+            queue.push( packet );
+        }
+        queue.sort();
+    } ) - fillSeconds;
+    report( "radix sort", sortSeconds * 1e3, "ms" );
+
+    // the comparison sort the radix sort replaces
+    std::vector<uint64_t> keys( kPacketCount );
+    const double stdSortSeconds = timePerCall( [&] {
+        for ( size_t i = 0; i < kPacketCount; ++i )
+        {
+            keys[ i ] = packets[ i ].key;
+        }
+        std::sort( keys.begin(), keys.end() );
+        keepAlive( keys[ 0 ] );
+    } );
+    report( "std::sort of the keys", stdSortSeconds * 1e3, "ms" );
+
+    // replay forwards only the state that changes between neighbours
+    CountingBackend backend;
+    ReplayStats stats = {};
+    const double replaySeconds = timePerCall( [&] {
+        backend = CountingBackend();
+        stats = queue.replay( backend, 0, queue.size() );
+        keepAlive( backend.checksum );
+    } );
+    report( "replay and filter", replaySeconds * 1e3, "ms" );
+    report( "state changes, sorted and filtered", (double)stats.stateChanges(), "changes" );
+    report( "state changes, unfiltered", (double)( kPacketCount * 4 ), "changes" );
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+  ******************************************************************************
+  * @file           : bench_light_clusters.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "job_system.hpp"
+#include "light_clusters.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+static constexpr uint32_t kTilesX = 16;
+static constexpr uint32_t kTilesY = 9;
+static constexpr uint32_t kSlices = 24;
+static constexpr uint32_t kMaxLightsPerCluster = 256;
+static constexpr float kFovY = 45.f * (float)M_PI / 180.f;
+static constexpr float kAspect = 16.f / 9.f;
+static constexpr float kNearZ = 0.5f;
+static constexpr float kFarZ = 50.f;
+
+// the binning kernel's loop on the cpu: every cluster tests every light against its
+// box, then spots against its bounding sphere. what LightClusters saves on
+static size_t binPerCluster( const shader_types::ClusterGrid& grid, const shader_types::ClusterLight* lights, size_t count,
+                             std::vector<uint32_t>& counts, std::vector<uint16_t>& indices )
+{
+    size_t references = 0;
+    for ( uint32_t z = 0; z < grid.slices; ++z )
+    {
+        const float dn = exp2f( ( (float)z - grid.sliceBias ) / grid.sliceScale );
+        const float df = exp2f( ( (float)( z + 1 ) - grid.sliceBias ) / grid.sliceScale );
+        for ( uint32_t y = 0; y < grid.tilesY; ++y )
+        {
+            const float top = -( -1.f + 2.f * (float)y / (float)grid.tilesY ) * grid.tanHalfFovY;
+            const float bottom = -( -1.f + 2.f * (float)( y + 1 ) / (float)grid.tilesY ) * grid.tanHalfFovY;
+            const float minY = std::min( bottom * dn, bottom * df );
+            const float maxY = std::max( top * dn, top * df );
+            for ( uint32_t x = 0; x < grid.tilesX; ++x )
+            {
+                const float left = ( -1.f + 2.f * (float)x / (float)grid.tilesX ) * grid.tanHalfFovX;
+                const float right = ( -1.f + 2.f * (float)( x + 1 ) / (float)grid.tilesX ) * grid.tanHalfFovX;
+                const float minX = std::min( left * dn, left * df );
+                const float maxX = std::max( right * dn, right * df );
+
+                const float hx = ( maxX - minX ) * 0.5f;
+                const float hy = ( maxY - minY ) * 0.5f;
+                const float hz = ( df - dn ) * 0.5f;
+                const float center[ 3 ] = { minX + hx, minY + hy, -( dn + hz ) };
+                const float radius = sqrtf( hx * hx + hy * hy + hz * hz );
+
+                const uint32_t c = ( z * grid.tilesY + y ) * grid.tilesX + x;
+                uint32_t n = 0;
+                for ( size_t i = 0; i < count; ++i )
+                {
+                    const shader_types::ClusterLight& l = lights[ i ];
+                    const float depth = -l.position.z;
+                    const float dz = std::max( std::max( dn - depth, depth - df ), 0.f );
+                    const float dy = std::max( std::max( minY - l.position.y, l.position.y - maxY ), 0.f );
+                    const float dx = std::max( std::max( minX - l.position.x, l.position.x - maxX ), 0.f );
+                    const float rem = l.range * l.range - dz * dz - dy * dy;
+                    if ( rem < 0.f || dx * dx > rem )
+                    {
+                        continue;
+                    }
+                    if ( l.spotCosOuter > -1.f )
+                    {
+                        const float v[ 3 ] = { center[ 0 ] - l.position.x, center[ 1 ] - l.position.y, center[ 2 ] - l.position.z };
+                        const float along = v[ 0 ] * l.direction.x + v[ 1 ] * l.direction.y + v[ 2 ] * l.direction.z;
+                        const float sinOuter = sqrtf( std::max( 1.f - l.spotCosOuter * l.spotCosOuter, 0.f ) );
+                        const float lenSq = v[ 0 ] * v[ 0 ] + v[ 1 ] * v[ 1 ] + v[ 2 ] * v[ 2 ];
+                        const float closest = l.spotCosOuter * sqrtf( std::max( lenSq - along * along, 0.f ) ) - along * sinOuter;
+                        if ( closest > radius || along > radius + l.range || along < -radius )
+                        {
+                            continue;
+                        }
+                    }
+                    if ( n < grid.maxLightsPerCluster )
+                    {
+                        indices[ (size_t)c * grid.maxLightsPerCluster + n ] = (uint16_t)i;
+                    }
+                    ++n;
+                }
+                counts[ c ] = std::min( n, grid.maxLightsPerCluster );
+                references += counts[ c ];
+            }
+        }
+    }
+    return references;
+}
+
+int main()
+{
+    const shader_types::ClusterGrid grid = makeClusterGrid( kTilesX, kTilesY, kSlices, kMaxLightsPerCluster,
+                                                            kFovY, kAspect, kNearZ, kFarZ, 1920, 1080 );
+
+    // 10k small lights spread through the view frustum, a quarter of them spots
+    // pointing away from the camera, ranges like the clustered lighting sample's
+    std::mt19937 rng( 1 );
+    std::uniform_real_distribution<float> u( 0.f, 1.f );
+    std::vector<shader_types::ClusterLight> lights( 10000 );
+    for ( size_t i = 0; i < lights.size(); ++i )
+    {
+        shader_types::ClusterLight& l = lights[ i ];
+        const float depth = 1.f + 44.f * u( rng );
+        l.position = { ( 2.f * u( rng ) - 1.f ) * grid.tanHalfFovX * depth,
+                       ( 2.f * u( rng ) - 1.f ) * grid.tanHalfFovY * depth,
+                       -depth };
+        l.range = 0.4f + 0.6f * u( rng );
+        l.color = { 1.f, 1.f, 1.f };
+        l.direction = { 0.f, 0.f, -1.f };
+        l.spotCosOuter = -1.f;
+        l.spotCosInner = -1.f;
+        if ( i % 4 == 0 )
+        {
+            const float a = 2.f * (float)M_PI * u( rng );
+            const float tilt = 0.5f * u( rng );
+            l.direction = { sinf( tilt ) * cosf( a ), sinf( tilt ) * sinf( a ), -cosf( tilt ) };
+            l.range *= 2.f;
+            l.spotCosOuter = cosf( 0.5f );
+            l.spotCosInner = cosf( 0.35f );
+        }
+    }
+
+    // fewer lights first, the cost grows with the lights times the clusters they reach
+    for ( size_t count : { 1000, 4000, 10000 } )
+    {
+        for ( size_t threads : { 1, 2, 4, 8 } )
+        {
+            JobSystem jobs( threads );
+            LightClusters clusters( jobs, grid );
+            const double seconds = timePerCall( [&] {
+                clusters.bin( lights.data(), count );
+                keepAlive( clusters.counts()[ 0 ] );
+            } );
+
+            char name[ 64 ];
+            snprintf( name, sizeof( name ), "bin %zu lights, %zu threads", count, jobs.threadCount() );
+            report( name, seconds * 1e3, "ms" );
+        }
+    }
+
+    // what the grid ends up holding, so a change in the numbers above can be told
+    // apart from a change in the work
+    JobSystem jobs( 1 );
+    LightClusters clusters( jobs, grid );
+    clusters.bin( lights.data(), lights.size() );
+    const LightClusterStats stats = clusters.stats();
+    __builtin_printf( "  %zu clusters, %zu occupied, %zu references, %zu dropped, at most %u lights in one\n",
+                      stats.clusters, stats.occupied, stats.references, stats.dropped, stats.maxCount );
+
+    std::vector<uint32_t> counts( clusters.clusterCount() );
+    std::vector<uint16_t> indices( clusters.clusterCount() * kMaxLightsPerCluster );
+    size_t references = 0;
+    const double seconds = timePerCall( [&] {
+        references = binPerCluster( grid, lights.data(), lights.size(), counts, indices );
+        keepAlive( counts[ 0 ] );
+    } );
+    report( "bin 10000 lights per cluster, scalar", seconds * 1e3, "ms" );
+    __builtin_printf( "  %zu references\n", references );
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+  ******************************************************************************
+  * @file           : bench_pack_file.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "job_system.hpp"
+#include "pack_file.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <sys/stat.h>
+
+static constexpr size_t kEntryCount = 64;
+static constexpr size_t kEntrySize = 1 << 20;
+
+// vertex like entries, smooth positions and quantized attributes, plus a texture like
+// run of bytes in every one so the levels have something to search for
+static std::vector<uint8_t> makeEntry( size_t index )
+{
+    std::vector<uint8_t> data( kEntrySize );
+    float* f = (float*)data.data();
+    const size_t floats = kEntrySize / 2 / sizeof( float );
+    for ( size_t i = 0; i < floats; ++i )
+    {
+        const float t = (float)( index * floats + i ) * 0.0007f;
+        f[ i ] = i % 4 == 3 ? 1.f : roundf( sinf( t * (float)( 1 + i % 4 ) ) * 512.f ) / 512.f;
+    }
+    uint32_t state = (uint32_t)index * 2654435761u + 1;
+    for ( size_t i = kEntrySize / 2; i < kEntrySize; ++i )
+    {
+        state = state * 1664525u + 1013904223u;
+        data[ i ] = (uint8_t)( ( state >> 24 ) & 0x3f ) + (uint8_t)( i / 4096 );
+    }
+    return data;
+}
+
+int main( int argc, char** argv )
+{
+    // the pack goes next to the executable unless another directory is given
+    const char* dir = argc > 1 ? argv[ 1 ] : ".";
+    char path[ 512 ];
+    snprintf( path, sizeof( path ), "%s/bench_pack_file.tmp", dir );
+
+    std::vector<std::vector<uint8_t>> entries( kEntryCount );
+    for ( size_t i = 0; i < kEntryCount; ++i )
+    {
+        entries[ i ] = makeEntry( i );
+    }
+    const double totalBytes = (double)( kEntryCount * kEntrySize );
+
+    JobSystem jobs( 4 );
+    std::vector<std::vector<uint8_t>> out( kEntryCount, std::vector<uint8_t>( kEntrySize ) );
+    std::vector<PackReader::Read> reads( kEntryCount );
+    char line[ 64 ];
+
+    // level 0 stores the entries, the rest are lz4 levels
+    for ( int level : { 0, 1, 3, 5, 9 } )
+    {
+        PackWriter writer( jobs );
+        for ( size_t i = 0; i < kEntryCount; ++i )
+        {
+            char name[ 32 ];
+            snprintf( name, sizeof( name ), "entry_%03zu", i );
+            writer.add( name, entries[ i ].data(), kEntrySize, level );
+        }
+
+        bool ok = true;
+        const double packSeconds = timePerCall( [&] {
+            ok = writer.write( path ) && ok;
+        } );
+        snprintf( line, sizeof( line ), "level %d, pack", level );
+        report( line, ok ? totalBytes / packSeconds / ( 1 << 30 ) : 0.0, "gb/s" );
+
+        PackReader reader;
+        if ( !ok || !reader.open( path ) )
+        {
+            __builtin_printf( "failed to write or open %s\n", path );
+            remove( path );
+            return 1;
+        }
+
+        for ( uint32_t i = 0; i < reader.entryCount(); ++i )
+        {
+            reads[ i ] = { i, out[ i ].data() };
+        }
+        struct stat st;
+        stat( path, &st );
+        snprintf( line, sizeof( line ), "level %d, file size", level );
+        report( line, 100.0 * (double)st.st_size / totalBytes, "% of the data" );
+
+        for ( bool verify : { true, false } )
+        {
+            const double unpackSeconds = timePerCall( [&] {
+                ok = reader.read( jobs, reads.data(), reads.size(), verify ) && ok;
+                keepAlive( out[ kEntryCount - 1 ][ kEntrySize - 1 ] );
+            } );
+            snprintf( line, sizeof( line ), "level %d, unpack%s", level, verify ? ", checksums" : "" );
+            report( line, ok ? totalBytes / unpackSeconds / ( 1 << 30 ) : 0.0, "gb/s" );
+        }
+        reader.close();
+    }
+
+    remove( path );
+    return 0;
+}
@@ -0,0 +1,147 @@
+/**
+  ******************************************************************************
+  * @file           : bench_rasterization_rate.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "rasterization_rate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static constexpr uint32_t kWidth = 1920;
+static constexpr uint32_t kHeight = 1080;
+static constexpr int kFrames = 600;
+
+struct Rect
+{
+    float u0, v0, u1, v1;
+};
+
+// the rasterization rate sample's frame: 10 x 10 x 10 cubes of 0.2 turning around a
+// point 10 in front of the camera, which sways from side to side. every cube adds its
+// bounding sphere's extent on screen, like the sample's culling does
+static void sceneRects( int frame, std::vector<Rect>& rects )
+{
+    const float ys = 1.f / tanf( 45.f * (float)M_PI / 360.f );
+    const float xs = ys * (float)kHeight / (float)kWidth;
+    const float scl = 0.2f;
+    const float radius = scl * 0.5f * sqrtf( 3.f );
+    const float angle = (float)frame * 0.01f;
+    const float c = cosf( angle ), s = sinf( angle );
+    const float sway = 1.5f * sinf( angle * 0.7f );
+
+    rects.clear();
+    for ( int i = 0; i < 1000; ++i )
+    {
+        const float x = ( (float)( i % 10 ) - 5.f ) * 2.f * scl + scl;
+        const float y = ( (float)( ( i / 10 ) % 10 ) - 5.f ) * 2.f * scl + scl;
+        const float z = ( (float)( i / 100 ) - 5.f ) * 2.f * scl;
+        const float vx = c * x + s * z + sway;
+        const float vz = -10.f - s * x + c * z;
+        const float distance = -vz;
+        if ( distance <= radius )
+        {
+            continue;
+        }
+        const float u = xs * vx / distance * 0.5f + 0.5f;
+        const float v = 0.5f - ys * y / distance * 0.5f;
+        const float extentU = xs * radius / ( distance - radius ) * 0.5f;
+        const float extentV = ys * radius / ( distance - radius ) * 0.5f;
+        rects.push_back( { u - extentU, v - extentV, u + extentU, v + extentV } );
+    }
+}
+
+struct CostSummary
+{
+    double mean, min, max;
+    double physicalWidth, physicalHeight;
+};
+
+// the focus wanders like the sample's, the estimated reduction of the fragments shaded
+static CostSummary measure( const RateMapSettings& settings )
+{
+    RateMapBuilder builder( settings );
+    std::vector<Rect> rects;
+    CostSummary summary = { 0.0, 1.0, 0.0, 0.0, 0.0 };
+    for ( int frame = 0; frame < kFrames; ++frame )
+    {
+        sceneRects( frame, rects );
+        builder.beginFrame( kWidth, kHeight );
+        for ( const Rect& r : rects )
+        {
+            builder.addContent( r.u0, r.v0, r.u1, r.v1, 1.f );
+        }
+        builder.build( 0.5f + 0.25f * cosf( (float)frame * 0.013f ), 0.5f + 0.2f * sinf( (float)frame * 0.021f ) );
+
+        const ShadingCost cost = builder.estimateCost();
+        summary.mean += cost.reduction / kFrames;
+        summary.min = std::min( summary.min, cost.reduction );
+        summary.max = std::max( summary.max, cost.reduction );
+        summary.physicalWidth += (double)cost.physicalWidth / kFrames;
+        summary.physicalHeight += (double)cost.physicalHeight / kFrames;
+    }
+    return summary;
+}
+
+int main()
+{
+    // the fragments a rate map saves, from the shading cost model. focus only keeps any
+    // zone with content at full rate, content only ignores the focus
+    const RateMapSettings settings = makeRateMapSettings( 16, 9 );
+    RateMapSettings focusOnly = settings;
+    focusOnly.fullDensity = 1e-6f;
+    RateMapSettings contentOnly = settings;
+    contentOnly.focusRadius = 10.f;
+
+    const struct
+    {
+        const char* name;
+        RateMapSettings settings;
+    } modes[] = {
+        { "focus and content", settings },
+        { "focus only", focusOnly },
+        { "content only", contentOnly },
+    };
+    for ( const auto& mode : modes )
+    {
+        const CostSummary summary = measure( mode.settings );
+        char name[ 64 ];
+        snprintf( name, sizeof( name ), "fragment reduction, %s", mode.name );
+        report( name, summary.mean * 100.0, "%" );
+        __builtin_printf( "  min %.1f%%, max %.1f%%, physical %.0fx%.0f of %ux%u\n", summary.min * 100.0, summary.max * 100.0,
+                          summary.physicalWidth, summary.physicalHeight, kWidth, kHeight );
+    }
+
+    // the cpu side of a frame, what the renderer pays for the map
+    RateMapBuilder builder( settings );
+    std::vector<Rect> rects;
+    sceneRects( 0, rects );
+    const double buildSeconds = timePerCall( [&] {
+        builder.beginFrame( kWidth, kHeight );
+        for ( const Rect& r : rects )
+        {
+            builder.addContent( r.u0, r.v0, r.u1, r.v1, 1.f );
+        }
+        builder.build( 0.5f, 0.5f );
+        keepAlive( builder.horizontal()[ 0 ] );
+    } );
+    char name[ 64 ];
+    snprintf( name, sizeof( name ), "build from %zu rects", rects.size() );
+    report( name, buildSeconds * 1e6, "us" );
+
+    const double costSeconds = timePerCall( [&] {
+        const ShadingCost cost = builder.estimateCost();
+        keepAlive( cost.shadedFragments );
+    } );
+    report( "estimateCost", costSeconds * 1e6, "us" );
+    return 0;
+}
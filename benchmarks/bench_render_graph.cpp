@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file           : bench_render_graph.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "render_graph_plan.hpp"
+
+#include <random>
+#include <vector>
+
+using Handle = RenderGraphPlan::Handle;
+
+// a post processing chain: every pass reads one or two recent results and writes a
+// new one, the last writes the backbuffer. a few passes write nothing anyone reads
+static void declare( RenderGraphPlan& plan, size_t passCount, uint32_t seed )
+{
+    std::mt19937 rng( seed );
+    plan.reset();
+    const Handle backbuffer = plan.addResource( "backbuffer", true );
+
+    Handle last = plan.addResource( "scene", false );
+    plan.write( plan.addPass( "scene" ), last );
+    std::vector<Handle> recent = { last };
+
+    for ( size_t p = 1; p < passCount; ++p )
+    {
+        const Handle pass = plan.addPass( "post" );
+        plan.read( pass, recent[ rng() % recent.size() ] );
+        plan.read( pass, recent.back() );
+        const Handle out = plan.addResource( "target", false );
+        plan.write( pass, out );
+        if ( rng() % 8 != 0 )
+        {
+            recent.push_back( out );
+            if ( recent.size() > 4 )
+            {
+                recent.erase( recent.begin() );
+            }
+        }
+    }
+
+    const Handle present = plan.addPass( "present" );
+    plan.read( present, recent.back() );
+    plan.write( present, backbuffer );
+}
+
+int main()
+{
+    RenderGraphPlan plan;
+    for ( size_t passCount : { 16, 64, 256 } )
+    {
+        const double seconds = timePerCall( [&] {
+            declare( plan, passCount, 1 );
+            plan.compile( []( Handle h ) {
+                return RenderGraphSizeAndAlign{ ( 1 + h % 4 ) * (size_t)4 << 20, 65536 };
+            } );
+            keepAlive( plan.peakBytes() );
+        } );
+
+        char name[ 64 ];
+        snprintf( name, sizeof( name ), "declare and compile, %zu passes", passCount );
+        report( name, seconds * 1e6, "us" );
+        report( "  culled", (double)plan.culledPassCount(), "passes" );
+        report( "  heap with aliasing", 100.0 * (double)plan.peakBytes() / (double)plan.unaliasedBytes(), "% of unaliased" );
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+  ******************************************************************************
+  * @file           : bench_shadow_cascades.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "shadow_cascades.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// the scalar tail of cullShadowCasters for every caster, what the 4 wide loop saves on
+static size_t cullScalar( const ShadowCascade& c, const ShadowCasters& casters, uint32_t* visible )
+{
+    size_t n = 0;
+    for ( size_t i = 0; i < casters.count; ++i )
+    {
+        const float x = casters.x[ i ], y = casters.y[ i ], z = casters.z[ i ];
+        const float reach = casters.radius[ i ] + c.radius;
+        if ( fabsf( c.right[ 0 ] * x + c.right[ 1 ] * y + c.right[ 2 ] * z - c.center[ 0 ] ) <= reach
+             && fabsf( c.up[ 0 ] * x + c.up[ 1 ] * y + c.up[ 2 ] * z - c.center[ 1 ] ) <= reach
+             && c.forward[ 0 ] * x + c.forward[ 1 ] * y + c.forward[ 2 ] * z - c.center[ 2 ] <= reach )
+        {
+            visible[ n++ ] = (uint32_t)i;
+        }
+    }
+    return n;
+}
+
+int main()
+{
+    // the samples' camera: 45 degrees, 0.03 to 500, at the origin looking down -z
+    const float nearZ = 0.03f, farZ = 500.f;
+    const float ys = 1.f / tanf( 45.f * (float)M_PI / 360.f );
+    float perspective[ 16 ] = {};
+    perspective[ 0 ] = ys * 9.f / 16.f;
+    perspective[ 5 ] = ys;
+    perspective[ 10 ] = farZ / ( nearZ - farZ );
+    perspective[ 11 ] = -1.f;
+    perspective[ 14 ] = nearZ * farZ / ( nearZ - farZ );
+    float world[ 16 ] = {};
+    world[ 0 ] = world[ 5 ] = world[ 10 ] = world[ 15 ] = 1.f;
+
+    const float light[ 3 ] = { -0.4f, -1.f, -0.3f };
+    const ShadowCascadeSettings settings = { 4, 2048, 150.f, 0.75f };
+    ShadowCascade cascades[ kMaxShadowCascades ];
+
+    // once per frame, the camera creeps so the snapping is not skipped by a constant input
+    const double fitSeconds = timePerCall( [&] {
+        world[ 12 ] += 1e-4f;
+        fitShadowCascades( perspective, world, light, settings, cascades );
+        keepAlive( cascades[ 3 ].center[ 0 ] );
+    } );
+    report( "fit 4 cascades", fitSeconds * 1e6, "us" );
+
+    world[ 12 ] = 0.f;
+    fitShadowCascades( perspective, world, light, settings, cascades );
+
+    // casters scattered over a 400 x 40 x 400 world around the camera, each cascade
+    // keeps the few near its slice of the frustum
+    std::mt19937 rng( 1 );
+    std::uniform_real_distribution<float> u( -1.f, 1.f );
+    constexpr size_t kMaxCasters = 100000;
+    std::vector<float> x( kMaxCasters ), y( kMaxCasters ), z( kMaxCasters ), r( kMaxCasters );
+    for ( size_t i = 0; i < kMaxCasters; ++i )
+    {
+        x[ i ] = 200.f * u( rng );
+        y[ i ] = 20.f * u( rng );
+        z[ i ] = 200.f * u( rng );
+        r[ i ] = 0.5f + 2.5f * fabsf( u( rng ) );
+    }
+    std::vector<uint32_t> visible( kMaxCasters );
+
+    for ( size_t count : { 1000, 10000, 100000 } )
+    {
+        const ShadowCasters casters = { x.data(), y.data(), z.data(), r.data(), count };
+        size_t kept = 0;
+        const double simdSeconds = timePerCall( [&] {
+            kept = 0;
+            for ( uint32_t i = 0; i < settings.cascadeCount; ++i )
+            {
+                kept += cullShadowCasters( cascades[ i ], casters, visible.data() );
+            }
+            keepAlive( kept );
+        } );
+        const double scalarSeconds = timePerCall( [&] {
+            size_t n = 0;
+            for ( uint32_t i = 0; i < settings.cascadeCount; ++i )
+            {
+                n += cullScalar( cascades[ i ], casters, visible.data() );
+            }
+            keepAlive( n );
+        } );
+
+        char name[ 64 ];
+        snprintf( name, sizeof( name ), "cull %zu casters x 4 cascades, 4 wide", count );
+        report( name, simdSeconds * 1e6, "us" );
+        snprintf( name, sizeof( name ), "cull %zu casters x 4 cascades, scalar", count );
+        report( name, scalarSeconds * 1e6, "us" );
+        __builtin_printf( "  %zu kept, %.1f Mcasters/s 4 wide\n", kept, (double)( count * settings.cascadeCount ) / simdSeconds * 1e-6 );
+    }
+    return 0;
+}
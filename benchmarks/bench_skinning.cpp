@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file           : bench_skinning.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "job_system.hpp"
+#include "skinning.hpp"
+
+#include <cmath>
+#include <vector>
+
+static constexpr size_t kJointCount = 32;
+static constexpr size_t kVertexCount = 256 * 1024;
+
+int main()
+{
+    // a pose with every joint turned and scaled a little, so no matrix is trivial
+    std::vector<int> parents( kJointCount );
+    std::vector<shader_layout::host_float4x4> inverseBind( kJointCount );
+    std::vector<Transform> pose( kJointCount );
+    for ( size_t j = 0; j < kJointCount; ++j )
+    {
+        parents[ j ] = (int)j - 1;
+        Transform bind = {};
+        bind.rotation = { 0.f, 0.f, 0.f, 1.f };
+        bind.translation = { 0.f, -0.1f * (float)j, 0.f };
+        bind.scale = { 1.f, 1.f, 1.f };
+        inverseBind[ j ] = AnimationSampler::toMatrix( bind );
+
+        const float half = 0.05f * (float)j;
+        pose[ j ].rotation = { 0.f, 0.f, sinf( half ), cosf( half ) };
+        pose[ j ].translation = { 0.f, j == 0 ? 0.f : 0.1f, 0.f };
+        pose[ j ].scale = { 1.f, 1.f + 0.01f * (float)j, 1.f };
+    }
+    Skeleton skeleton( parents.data(), inverseBind.data(), kJointCount );
+    std::vector<shader_layout::host_float4x4> palette( kJointCount );
+    skeleton.computePalette( pose.data(), palette.data() );
+
+    std::vector<SkinnedVertex> vertices( kVertexCount );
+    for ( size_t i = 0; i < kVertexCount; ++i )
+    {
+        const float y = 0.1f * (float)( kJointCount - 1 ) * (float)i / (float)kVertexCount;
+        const float angle = (float)i * 0.37f;
+        const uint16_t j0 = (uint16_t)( i * ( kJointCount - 1 ) / kVertexCount );
+        SkinnedVertex& v = vertices[ i ];
+        v.position = { 0.2f * cosf( angle ), y, 0.2f * sinf( angle ) };
+        v.normal = { cosf( angle ), 0.f, sinf( angle ) };
+        v.joints = { j0, (uint16_t)( j0 + 1 ), 0, 0 };
+        v.weights = { 0.75f, 0.25f, 0.f, 0.f };
+    }
+    std::vector<SkinnedOutput> out( kVertexCount );
+
+    const double paletteSeconds = timePerCall( [&] {
+        skeleton.computePalette( pose.data(), palette.data() );
+        keepAlive( palette[ kJointCount - 1 ] );
+    } );
+    report( "compute palette", (double)kJointCount / paletteSeconds * 1e-6, "Mjoints/s" );
+
+    const double singleSeconds = timePerCall( [&] {
+        CpuSkinning::skin( vertices.data(), 0, kVertexCount, palette.data(), out.data() );
+        keepAlive( out[ kVertexCount - 1 ] );
+    } );
+    report( "skin, no job system", (double)kVertexCount / singleSeconds * 1e-6, "Mverts/s" );
+
+    // past the core count the numbers only show what the extra threads cost
+    for ( size_t threads : { 1, 2, 4, 8 } )
+    {
+        JobSystem jobs( threads );
+        const double seconds = timePerCall( [&] {
+            CpuSkinning::skinParallel( jobs, vertices.data(), kVertexCount, palette.data(), out.data() );
+            keepAlive( out[ kVertexCount - 1 ] );
+        } );
+
+        char name[ 64 ];
+        snprintf( name, sizeof( name ), "skin parallel, %zu threads", jobs.threadCount() );
+        report( name, (double)kVertexCount / seconds * 1e-6, "Mverts/s" );
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file           : bench_soft_rasterizer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "job_system.hpp"
+#include "soft_rasterizer.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+static constexpr uint32_t kWidth = 1280;
+static constexpr uint32_t kHeight = 720;
+static constexpr int kGrid = 10;
+
+static void identity4( float* m )
+{
+    memset( m, 0, 16 * sizeof( float ) );
+    m[ 0 ] = m[ 5 ] = m[ 10 ] = m[ 15 ] = 1.f;
+}
+
+static void identity3( float* m )
+{
+    memset( m, 0, 9 * sizeof( float ) );
+    m[ 0 ] = m[ 4 ] = m[ 8 ] = 1.f;
+}
+
+int main()
+{
+    // the headless sample's frame: a 10 x 10 x 10 grid of turned cubes, textured and
+    // lit, half their triangles facing away
+    std::vector<SoftVertex> vertices;
+    std::vector<uint16_t> indices;
+    const float faces[ 6 ][ 3 ][ 3 ] = {
+        { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } }, { { -1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } },
+        { { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } }, { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },
+        { { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 } }, { { 0, 0, -1 }, { 0, 1, 0 }, { 1, 0, 0 } },
+    };
+    const float corners[ 4 ][ 2 ] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+    for ( const auto& face : faces )
+    {
+        const uint16_t base = (uint16_t)vertices.size();
+        for ( const auto& corner : corners )
+        {
+            SoftVertex v;
+            for ( int k = 0; k < 3; ++k )
+            {
+                v.position[ k ] = 0.5f * ( face[ 0 ][ k ] + corner[ 0 ] * face[ 1 ][ k ] + corner[ 1 ] * face[ 2 ][ k ] );
+                v.normal[ k ] = face[ 0 ][ k ];
+            }
+            v.texcoord[ 0 ] = corner[ 0 ] * 0.5f + 0.5f;
+            v.texcoord[ 1 ] = corner[ 1 ] * 0.5f + 0.5f;
+            vertices.push_back( v );
+        }
+        for ( uint16_t i : { 0, 1, 2, 0, 2, 3 } )
+        {
+            indices.push_back( base + i );
+        }
+    }
+
+    std::vector<SoftInstance> instances;
+    for ( int z = 0; z < kGrid; ++z )
+    {
+        for ( int y = 0; y < kGrid; ++y )
+        {
+            for ( int x = 0; x < kGrid; ++x )
+            {
+                const float angle = 0.3f * (float)( x + y + z );
+                const float c = cosf( angle ), s = sinf( angle );
+                SoftInstance instance;
+                identity4( instance.transform );
+                instance.transform[ 0 ] = 0.6f * c;
+                instance.transform[ 2 ] = -0.6f * s;
+                instance.transform[ 5 ] = 0.6f;
+                instance.transform[ 8 ] = 0.6f * s;
+                instance.transform[ 10 ] = 0.6f * c;
+                instance.transform[ 12 ] = ( (float)x - 4.5f ) * 1.2f;
+                instance.transform[ 13 ] = ( (float)y - 4.5f ) * 1.2f;
+                instance.transform[ 14 ] = -4.f - (float)z * 1.5f;
+                identity3( instance.normalTransform );
+                instance.normalTransform[ 0 ] = c;
+                instance.normalTransform[ 2 ] = -s;
+                instance.normalTransform[ 6 ] = s;
+                instance.normalTransform[ 8 ] = c;
+                instance.color[ 0 ] = 0.3f + 0.07f * (float)x;
+                instance.color[ 1 ] = 0.3f + 0.07f * (float)y;
+                instance.color[ 2 ] = 0.3f + 0.07f * (float)z;
+                instance.color[ 3 ] = 1.f;
+                instances.push_back( instance );
+            }
+        }
+    }
+
+    std::vector<uint8_t> texels;
+    for ( uint32_t y = 0; y < 256; ++y )
+    {
+        for ( uint32_t x = 0; x < 256; ++x )
+        {
+            const bool odd = ( ( x / 32 ) ^ ( y / 32 ) ) & 1;
+            texels.insert( texels.end(), { (uint8_t)( odd ? 255 : 64 ), (uint8_t)x, (uint8_t)y, 255 } );
+        }
+    }
+    const SoftTexture texture = { texels.data(), 256, 256 };
+
+    SoftCamera camera;
+    const float nearZ = 0.1f, farZ = 40.f;
+    const float f = 1.f / tanf( 0.5f );
+    memset( camera.projection, 0, sizeof( camera.projection ) );
+    camera.projection[ 0 ] = f * (float)kHeight / (float)kWidth;
+    camera.projection[ 5 ] = f;
+    camera.projection[ 10 ] = farZ / ( nearZ - farZ );
+    camera.projection[ 11 ] = -1.f;
+    camera.projection[ 14 ] = nearZ * farZ / ( nearZ - farZ );
+    identity4( camera.world );
+    identity3( camera.normalTransform );
+
+    SoftDraw draw = {};
+    draw.vertices = vertices.data();
+    draw.vertexCount = vertices.size();
+    draw.indices = indices.data();
+    draw.indexCount = indices.size();
+    draw.instances = instances.data();
+    draw.instanceCount = instances.size();
+    draw.texture = &texture;
+    draw.cullBack = true;
+
+    const float clearColor[ 4 ] = { 0.1f, 0.1f, 0.1f, 1.f };
+    const double triangles = (double)( instances.size() * indices.size() / 3 );
+
+    // flat shading is the setup and edge function cost, textured and lit adds the
+    // per pixel work of the samples' fragment shader
+    for ( uint32_t shading : { 0u, kSoftTextured | kSoftLit } )
+    {
+        draw.shading = shading;
+
+        // past the core count the numbers only show what the extra threads cost
+        for ( size_t threads : { 1, 2, 4, 8 } )
+        {
+            JobSystem jobs( threads );
+            SoftRasterizer rasterizer( jobs, kWidth, kHeight );
+
+            size_t frames = 0;
+            const double seconds = timePerCall( [&] {
+                rasterizer.clear( clearColor );
+                rasterizer.draw( camera, draw );
+                keepAlive( rasterizer.color()[ 0 ] );
+                ++frames;
+            } );
+
+            char name[ 64 ];
+            snprintf( name, sizeof( name ), "%s, %zu threads", shading ? "textured lit" : "flat", jobs.threadCount() );
+            report( name, triangles / seconds * 1e-6, "Mtris/s" );
+
+            // where a frame goes, from the rasterizer's own timers
+            const SoftRasterStats stats = rasterizer.stats();
+            __builtin_printf( "  vertex / bin / raster %.3f / %.3f / %.3f ms, %.1f Mpixels/s\n",
+                              stats.vertexSeconds / (double)frames * 1e3, stats.binSeconds / (double)frames * 1e3,
+                              stats.rasterSeconds / (double)frames * 1e3, (double)stats.pixels / (double)frames / seconds * 1e-6 );
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+/**
+  ******************************************************************************
+  * @file           : bench_tlsf_allocator.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "tlsf_allocator.hpp"
+
+#include <random>
+#include <vector>
+
+static constexpr uint64_t kCapacity = 512ull << 20;
+static constexpr size_t kLiveCount = 1024;
+static constexpr size_t kOps = 1 << 20;
+
+// buffer and texture sized requests, 256 bytes to 2 mb at 256 byte or 64 kb alignment
+struct Request
+{
+    uint64_t size;
+    uint64_t align;
+};
+
+static std::vector<Request> makeRequests( size_t count, uint32_t seed )
+{
+    std::mt19937 rng( seed );
+    std::vector<Request> requests( count );
+    for ( Request& r : requests )
+    {
+        r.size = (uint64_t)256 << ( rng() % 13 );
+        r.size += rng() % r.size;
+        r.align = rng() % 4 == 0 ? 65536 : 256;
+    }
+    return requests;
+}
+
+int main()
+{
+    const std::vector<Request> requests = makeRequests( kOps, 1 );
+    std::vector<uint32_t> victims( kOps );
+    std::mt19937 rng( 2 );
+    for ( uint32_t& v : victims )
+    {
+        v = rng() % kLiveCount;
+    }
+
+    // steady state: kLiveCount allocations live, every op frees a random one and
+    // allocates a new one in its place
+    TlsfAllocator tlsf( kCapacity );
+    std::vector<TlsfAllocation> live( kLiveCount );
+    for ( size_t i = 0; i < kLiveCount; ++i )
+    {
+        tlsf.allocate( requests[ i ].size, requests[ i ].align, live[ i ] );
+    }
+
+    size_t failed = 0;
+    size_t op = 0;
+    const double seconds = timePerCall( [&] {
+        for ( size_t i = 0; i < 65536; ++i, op = ( op + 1 ) % kOps )
+        {
+            TlsfAllocation& slot = live[ victims[ op ] ];
+            if ( slot.size )
+            {
+                tlsf.free( slot );
+                slot.size = 0;
+            }
+            const Request& r = requests[ op ];
+            if ( !tlsf.allocate( r.size, r.align, slot ) )
+            {
+                slot.size = 0;
+                ++failed;
+            }
+        }
+    } );
+    report( "free + allocate", 65536.0 / seconds * 1e-6, "Mops/s" );
+    report( "  failed allocations", (double)failed, "allocations" );
+
+    const TlsfStats churned = tlsf.stats();
+    report( "  used after churn", 100.0 * (double)churned.usedBytes / (double)churned.capacity, "% of capacity" );
+    report( "  fragmentation after churn", 100.0 * churned.fragmentation(), "%" );
+    report( "  free blocks after churn", (double)churned.freeBlockCount, "blocks" );
+
+    // compaction: how many moves it takes to gather the free space again
+    std::vector<TlsfAllocator::Move> moves;
+    size_t totalMoves = 0;
+    uint64_t movedBytes = 0;
+    for ( int round = 0; round < 64; ++round )
+    {
+        moves.clear();
+        const size_t moved = tlsf.defragment( 64, moves );
+        for ( const TlsfAllocator::Move& m : moves )
+        {
+            tlsf.free( m.from );
+            movedBytes += m.to.size;
+        }
+        totalMoves += moved;
+        if ( moved == 0 )
+        {
+            break;
+        }
+    }
+    const TlsfStats compacted = tlsf.stats();
+    report( "defragment", (double)totalMoves, "moves" );
+    report( "  moved", (double)movedBytes / ( 1 << 20 ), "mb" );
+    report( "  fragmentation after", 100.0 * compacted.fragmentation(), "%" );
+    return 0;
+}
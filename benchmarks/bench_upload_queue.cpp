@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file           : bench_upload_queue.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bench.hpp"
+#include "upload_queue.hpp"
+
+#include <cstring>
+#include <future>
+#include <vector>
+
+// MetalCopyEngine's ring size
+static constexpr size_t kStagingSize = 64 << 20;
+
+// the copy engine on the cpu: a thread that plays the blit queue, memcpy out of the
+// ring into host memory and a fixed wait per submission for the command buffer round
+// trip. batches complete in submission order, as on a metal queue.
+//
+// UploadCopy only carries MTL::Buffer pointers, the stand-in hands host memory through
+// them and never dereferences them as buffers.
+class HostCopyEngine : public CopyEngine {
+private:
+    struct Submission
+    {
+        std::vector<UploadCopy> copies;
+        std::function<void()> done;
+    };
+
+    std::vector<uint8_t> _staging;
+    std::chrono::microseconds _roundTrip;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::deque<Submission> _queue;
+    bool _quit;
+    std::thread _thread;
+
+    void copyMain() {
+        for ( ;; )
+        {
+            Submission s;
+            {
+                std::unique_lock<std::mutex> lock( _mutex );
+                _wake.wait( lock, [this] { return _quit || !_queue.empty(); } );
+                if ( _queue.empty() )
+                {
+                    return;
+                }
+                s = std::move( _queue.front() );
+                _queue.pop_front();
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            for ( const UploadCopy& c : s.copies )
+            {
+                uint8_t* dst = reinterpret_cast<uint8_t*>( c.buffer );
+                memcpy( dst + c.dstOffset, _staging.data() + c.srcOffset, c.length );
+            }
+            std::this_thread::sleep_until( start + _roundTrip );
+            s.done();
+        }
+    }
+
+public:
+    HostCopyEngine( size_t stagingSize, std::chrono::microseconds roundTrip )
+    : _staging( stagingSize )
+    , _roundTrip( roundTrip )
+    , _quit( false )
+    , _thread( &HostCopyEngine::copyMain, this ) {
+    }
+
+    ~HostCopyEngine() override {
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _quit = true;
+        }
+        _wake.notify_all();
+        _thread.join();
+    }
+
+    void* staging() override { return _staging.data(); }
+    size_t stagingSize() const override { return _staging.size(); }
+
+    void submit( const UploadCopy* copies, size_t count, std::function<void()> done ) override {
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _queue.push_back( { std::vector<UploadCopy>( copies, copies + count ), std::move( done ) } );
+        }
+        _wake.notify_one();
+    }
+};
+
+static MTL::Buffer* hostBuffer( std::vector<uint8_t>& memory )
+{
+    return reinterpret_cast<MTL::Buffer*>( memory.data() );
+}
+
+// uploads of size bytes back to back until total bytes went through the queue
+static void throughput( const char* name, size_t size, size_t total, std::chrono::microseconds roundTrip )
+{
+    HostCopyEngine engine( kStagingSize, roundTrip );
+    std::vector<uint8_t> source( size, 0x3c );
+    std::vector<uint8_t> destination( size );
+
+    double seconds = 0.0;
+    UploadQueueStats stats = {};
+    {
+        UploadQueue queue( engine );
+        seconds = timePerCall( [&] {
+            for ( size_t sent = 0; sent < total; sent += size )
+            {
+                queue.uploadBuffer( hostBuffer( destination ), 0, source.data(), size );
+            }
+            queue.drain();
+        } );
+        stats = queue.stats();
+    }
+    keepAlive( destination[ size - 1 ] );
+
+    char line[ 64 ];
+    snprintf( line, sizeof( line ), "%s, throughput", name );
+    report( line, (double)total / seconds / ( 1 << 30 ), "gb/s" );
+    snprintf( line, sizeof( line ), "%s, copies per batch", name );
+    report( line, (double)stats.copies / (double)stats.batches, "copies" );
+    snprintf( line, sizeof( line ), "%s, mean latency", name );
+    report( line, stats.latencySeconds / (double)stats.requests * 1e3, "ms" );
+    snprintf( line, sizeof( line ), "%s, max latency", name );
+    report( line, stats.maxLatencySeconds * 1e3, "ms" );
+}
+
+// one upload at a time, waiting on its future: the latency of an idle queue
+static void idleLatency( const char* name, size_t size, std::chrono::microseconds roundTrip )
+{
+    HostCopyEngine engine( kStagingSize, roundTrip );
+    std::vector<uint8_t> source( size, 0x3c );
+    std::vector<uint8_t> destination( size );
+
+    UploadQueue queue( engine );
+    const double seconds = timePerCall( [&] {
+        queue.uploadBuffer( hostBuffer( destination ), 0, source.data(), size ).wait();
+    } );
+    keepAlive( destination[ size - 1 ] );
+
+    char line[ 64 ];
+    snprintf( line, sizeof( line ), "%s, idle round trip", name );
+    report( line, seconds * 1e3, "ms" );
+}
+
+int main()
+{
+    // the cost of the queue and the copies alone
+    const std::chrono::microseconds none( 0 );
+    throughput( "4 kb uploads", 4 << 10, 64 << 20, none );
+    throughput( "64 kb uploads", 64 << 10, 256 << 20, none );
+    throughput( "1 mb uploads", 1 << 20, 256 << 20, none );
+    throughput( "64 mb uploads", 64 << 20, 256 << 20, none );
+    idleLatency( "4 kb upload", 4 << 10, none );
+
+    // with a command buffer round trip per batch, batching is what keeps the copies going
+    const std::chrono::microseconds roundTrip( 250 );
+    throughput( "4 kb uploads, 250 us round trip", 4 << 10, 64 << 20, roundTrip );
+    throughput( "1 mb uploads, 250 us round trip", 1 << 20, 256 << 20, roundTrip );
+    idleLatency( "4 kb upload, 250 us round trip", 4 << 10, roundTrip );
+    return 0;
+}
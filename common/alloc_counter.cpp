@@ -0,0 +1,203 @@
+/**
+  ******************************************************************************
+  * @file           : alloc_counter.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+
+static std::atomic<bool> s_counting( false );
+static std::atomic<uint64_t> s_allocations( 0 );
+static std::atomic<uint64_t> s_bytes( 0 );
+
+// runs inside the allocator: no allocation, no locks, nothing thread local
+static inline void countAllocation( size_t bytes )
+{
+    if ( s_counting.load( std::memory_order_relaxed ) )
+    {
+        s_allocations.fetch_add( 1, std::memory_order_relaxed );
+        s_bytes.fetch_add( bytes, std::memory_order_relaxed );
+    }
+}
+
+// sanitizers bring their own allocator and intercept malloc themselves
+#if defined( __SANITIZE_ADDRESS__ ) || defined( __SANITIZE_THREAD__ )
+#define ALLOC_COUNTER_SANITIZED 1
+#elif defined( __has_feature )
+#if __has_feature( address_sanitizer ) || __has_feature( thread_sanitizer )
+#define ALLOC_COUNTER_SANITIZED 1
+#endif
+#endif
+
+#if defined( ALLOC_COUNTER_SANITIZED )
+
+bool startAllocationCounting() {
+    return false;
+}
+
+void stopAllocationCounting() {
+}
+
+#elif defined( __APPLE__ )
+
+// libmalloc reports every zone operation to this hook when it is set, it is what
+// malloc stack logging runs on
+typedef void ( MallocLogger )( uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t hotFramesToSkip );
+extern "C" MallocLogger* malloc_logger;
+
+static constexpr uint32_t kMallocLogAllocate = 2;
+static constexpr uint32_t kMallocLogDeallocate = 4;
+
+static void mallocLogger( uint32_t type, uintptr_t, uintptr_t arg2, uintptr_t arg3, uintptr_t, uint32_t )
+{
+    // realloc comes as allocate | deallocate with the new size in arg3
+    if ( type & kMallocLogAllocate )
+    {
+        countAllocation( ( type & kMallocLogDeallocate ) ? arg3 : arg2 );
+    }
+}
+
+bool startAllocationCounting() {
+    malloc_logger = &mallocLogger;
+    s_counting.store( true, std::memory_order_relaxed );
+    return true;
+}
+
+void stopAllocationCounting() {
+    s_counting.store( false, std::memory_order_relaxed );
+    malloc_logger = nullptr;
+}
+
+#elif defined( __GLIBC__ )
+
+// a program may replace glibc's malloc, these forward to the real one. memalign and
+// friends are not replaced by glibc's own wrappers, so they are counted here as well.
+extern "C"
+{
+void* __libc_malloc( size_t size );
+void* __libc_calloc( size_t count, size_t size );
+void* __libc_realloc( void* p, size_t size );
+void* __libc_memalign( size_t alignment, size_t size );
+void __libc_free( void* p );
+
+void* malloc( size_t size )
+{
+    countAllocation( size );
+    return __libc_malloc( size );
+}
+
+void* calloc( size_t count, size_t size )
+{
+    countAllocation( count * size );
+    return __libc_calloc( count, size );
+}
+
+void* realloc( void* p, size_t size )
+{
+    countAllocation( size );
+    return __libc_realloc( p, size );
+}
+
+void free( void* p )
+{
+    __libc_free( p );
+}
+
+void* memalign( size_t alignment, size_t size )
+{
+    countAllocation( size );
+    return __libc_memalign( alignment, size );
+}
+
+void* aligned_alloc( size_t alignment, size_t size )
+{
+    countAllocation( size );
+    return __libc_memalign( alignment, size );
+}
+
+int posix_memalign( void** p, size_t alignment, size_t size )
+{
+    if ( alignment % sizeof( void* ) != 0 || ( alignment & ( alignment - 1 ) ) != 0 )
+    {
+        return EINVAL;
+    }
+    countAllocation( size );
+    *p = __libc_memalign( alignment, size );
+    return *p || size == 0 ? 0 : ENOMEM;
+}
+}
+
+bool startAllocationCounting() {
+    s_counting.store( true, std::memory_order_relaxed );
+    return true;
+}
+
+void stopAllocationCounting() {
+    s_counting.store( false, std::memory_order_relaxed );
+}
+
+#else
+
+bool startAllocationCounting() {
+    return false;
+}
+
+void stopAllocationCounting() {
+}
+
+#endif
+
+AllocationCounts allocationCounts() {
+    return { s_allocations.load( std::memory_order_relaxed ), s_bytes.load( std::memory_order_relaxed ) };
+}
+
+FrameAllocationCheck::FrameAllocationCheck( uint64_t warmupFrames )
+: _warmupFrames(warmupFrames)
+, _frame(0)
+, _begin{}
+, _failedFrames(0)
+, _allocations(0) {
+    if ( !startAllocationCounting() )
+    {
+        __builtin_printf( "no allocation hook in this build, frames are not checked\n" );
+    }
+}
+
+FrameAllocationCheck::~FrameAllocationCheck() {
+    stopAllocationCounting();
+}
+
+void FrameAllocationCheck::beginFrame() {
+    _begin = allocationCounts();
+}
+
+bool FrameAllocationCheck::endFrame() {
+    const AllocationCounts end = allocationCounts();
+    const uint64_t frame = _frame++;
+    if ( frame < _warmupFrames || end.allocations == _begin.allocations )
+    {
+        return true;
+    }
+
+    const uint64_t allocations = end.allocations - _begin.allocations;
+    // the report itself may allocate, it is left out of the next frame's count
+    if ( _failedFrames++ < 8 )
+    {
+        __builtin_printf( "frame %llu allocated %llu times, %llu bytes\n",
+                          (unsigned long long)frame, (unsigned long long)allocations,
+                          (unsigned long long)( end.bytes - _begin.bytes ) );
+    }
+    _allocations += allocations;
+    return false;
+}
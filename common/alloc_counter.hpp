@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file           : alloc_counter.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_ALLOC_COUNTER_HPP
+#define METAL_PLAYGROUND_ALLOC_COUNTER_HPP
+
+#include <cstdint>
+
+struct AllocationCounts
+{
+    uint64_t allocations;       // malloc, calloc, realloc and aligned allocations
+    uint64_t bytes;
+};
+
+// heap allocations of the whole process, every thread and every library, counted at
+// malloc: operator new, the objective-c runtime and blocks all end up there. linking
+// this module hooks the allocator, on apple through malloc_logger, with glibc by
+// wrapping malloc and friends around the __libc_ versions.
+//
+// counting starts with startAllocationCounting(), false where there is no hook
+// (other platforms, sanitizer builds).
+bool startAllocationCounting();
+void stopAllocationCounting();
+AllocationCounts allocationCounts();
+
+// asserts a steady state frame loop leaves the heap alone: every frame after the
+// warm up frames has to get through beginFrame() .. endFrame() without an allocation,
+// on any thread. frames that do are reported and counted.
+class FrameAllocationCheck {
+private:
+    uint64_t _warmupFrames;
+    uint64_t _frame;
+    AllocationCounts _begin;
+    uint64_t _failedFrames;
+    uint64_t _allocations;      // after the warm up
+
+public:
+    explicit FrameAllocationCheck( uint64_t warmupFrames );
+    ~FrameAllocationCheck();
+
+    FrameAllocationCheck( const FrameAllocationCheck& ) = delete;
+    FrameAllocationCheck& operator=( const FrameAllocationCheck& ) = delete;
+
+    void beginFrame();
+    // false when the frame was past the warm up and allocated
+    bool endFrame();
+
+    uint64_t failedFrames() const { return _failedFrames; }
+    uint64_t allocations() const { return _allocations; }
+    bool passed() const { return _failedFrames == 0; }
+};
+
+
+#endif //METAL_PLAYGROUND_ALLOC_COUNTER_HPP
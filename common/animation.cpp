@@ -0,0 +1,444 @@
+/**
+  ******************************************************************************
+  * @file           : animation.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "animation.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+static constexpr float kQuatComponentRange = 0.70710678f; // 1 / sqrt(2)
+static constexpr float kRotationScale = 32767.f;
+static constexpr float kRangeScale = 65535.f;
+
+// sampling runs on four tracks at a time, one per lane, the width of sse and neon
+typedef float Float4 __attribute__(( vector_size( 16 ) ));
+typedef int32_t Int4 __attribute__(( vector_size( 16 ) ));
+static constexpr size_t kLanes = 4;
+
+static Float4 splat( float v )
+{
+    return Float4{ v, v, v, v };
+}
+
+static uint16_t quantize( float v, float minValue, float extent )
+{
+    if ( extent <= 0.f )
+    {
+        return 0;
+    }
+    float n = std::clamp( ( v - minValue ) / extent, 0.f, 1.f );
+    return (uint16_t)lroundf( n * kRangeScale );
+}
+
+using shader_layout::host_float3;
+using shader_layout::host_float4;
+using shader_layout::host_float4x4;
+
+static float component( const host_float3& v, int c )
+{
+    return c == 0 ? v.x : ( c == 1 ? v.y : v.z );
+}
+
+static host_float3 dequantize( const uint16_t in[3], const host_float3& minValue, const host_float3& extent )
+{
+    const float s = 1.f / kRangeScale;
+    return { (float)in[0] * ( extent.x * s ) + minValue.x,
+             (float)in[1] * ( extent.y * s ) + minValue.y,
+             (float)in[2] * ( extent.z * s ) + minValue.z };
+}
+
+static host_float3 lerp( const host_float3& a, const host_float3& b, float w )
+{
+    return { a.x + ( b.x - a.x ) * w, a.y + ( b.y - a.y ) * w, a.z + ( b.z - a.z ) * w };
+}
+
+static host_float4 normalize( float x, float y, float z, float w )
+{
+    const float length = sqrtf( x * x + y * y + z * z + w * w );
+    const float s = length > 0.f ? 1.f / length : 0.f;
+    return { x * s, y * s, z * s, w * s };
+}
+
+static host_float4 nlerp( const host_float4& a, const host_float4& b, float w )
+{
+    // q and -q are the same rotation, take the shorter way around
+    const float d = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    const float sign = d < 0.f ? -1.f : 1.f;
+    return normalize( a.x + ( b.x * sign - a.x ) * w,
+                      a.y + ( b.y * sign - a.y ) * w,
+                      a.z + ( b.z * sign - a.z ) * w,
+                      a.w + ( b.w * sign - a.w ) * w );
+}
+
+// the smallest three of four tracks at once, the same arithmetic as unpackRotation()
+static void unpackRotations( const PackedKey* keys, Float4 out[4] )
+{
+    Int4 packed[3];
+    for ( size_t l = 0; l < kLanes; ++l )
+    {
+        for ( int c = 0; c < 3; ++c )
+        {
+            packed[ c ][ l ] = keys[ l ].rotation[ c ];
+        }
+    }
+    const Int4 largest = ( packed[0] >> 15 ) | ( ( packed[1] >> 15 ) << 1 );
+
+    Float4 abc[3];
+    for ( int c = 0; c < 3; ++c )
+    {
+        const Float4 n = __builtin_convertvector( packed[ c ] & 0x7fff, Float4 );
+        abc[ c ] = ( n * splat( 2.f / kRotationScale ) - splat( 1.f ) ) * splat( kQuatComponentRange );
+    }
+    const Float4 wSq = splat( 1.f ) - abc[0] * abc[0] - abc[1] * abc[1] - abc[2] * abc[2];
+    Float4 w = splat( 0.f );
+    for ( size_t l = 0; l < kLanes; ++l )
+    {
+        w[ l ] = sqrtf( std::max( 0.f, wSq[ l ] ) );
+    }
+
+    // the dropped component goes back in at its index, the others shift around it
+    out[0] = largest == 0 ? w : abc[0];
+    out[1] = largest == 0 ? abc[0] : ( largest == 1 ? w : abc[1] );
+    out[2] = largest <= 1 ? abc[1] : ( largest == 2 ? w : abc[2] );
+    out[3] = largest == 3 ? w : abc[2];
+}
+
+// translation or scale of four tracks, dequantized and lerped as the scalar path does
+static void sampleRange( const PackedKey* row0, const PackedKey* row1, uint16_t ( PackedKey::*key )[3],
+                         const TrackRange* ranges, host_float3 TrackRange::*minValue, host_float3 TrackRange::*extent,
+                         Float4 w, Float4 out[3] )
+{
+    for ( int c = 0; c < 3; ++c )
+    {
+        Int4 a, b;
+        Float4 lo, scale;
+        for ( size_t l = 0; l < kLanes; ++l )
+        {
+            a[ l ] = ( row0[ l ].*key )[ c ];
+            b[ l ] = ( row1[ l ].*key )[ c ];
+            lo[ l ] = component( ranges[ l ].*minValue, c );
+            scale[ l ] = component( ranges[ l ].*extent, c ) * ( 1.f / kRangeScale );
+        }
+        const Float4 v0 = __builtin_convertvector( a, Float4 ) * scale + lo;
+        const Float4 v1 = __builtin_convertvector( b, Float4 ) * scale + lo;
+        out[ c ] = v0 + ( v1 - v0 ) * w;
+    }
+}
+
+// four tracks in x / y / z / w vectors, one per lane. the operations are the ones of the
+// scalar path below, so a track samples to the same pose whichever way it goes
+static void sampleGroup( const PackedKey* row0, const PackedKey* row1, const TrackRange* ranges,
+                         float alpha, Transform* outPose )
+{
+    const Float4 w = splat( alpha );
+
+    Float4 translation[3], scale[3];
+    sampleRange( row0, row1, &PackedKey::translation, ranges, &TrackRange::translationMin, &TrackRange::translationExtent, w, translation );
+    sampleRange( row0, row1, &PackedKey::scale, ranges, &TrackRange::scaleMin, &TrackRange::scaleExtent, w, scale );
+
+    // nlerp along the shortest arc
+    Float4 q0[4], q1[4];
+    unpackRotations( row0, q0 );
+    unpackRotations( row1, q1 );
+    const Float4 d = q0[0] * q1[0] + q0[1] * q1[1] + q0[2] * q1[2] + q0[3] * q1[3];
+    const Float4 sign = d < splat( 0.f ) ? splat( -1.f ) : splat( 1.f );
+    Float4 q[4];
+    for ( int c = 0; c < 4; ++c )
+    {
+        q[ c ] = q0[ c ] + ( q1[ c ] * sign - q0[ c ] ) * w;
+    }
+    const Float4 lengthSq = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+    Float4 inverseLength = splat( 0.f );
+    for ( size_t l = 0; l < kLanes; ++l )
+    {
+        const float length = sqrtf( lengthSq[ l ] );
+        inverseLength[ l ] = length > 0.f ? 1.f / length : 0.f;
+    }
+
+    for ( size_t l = 0; l < kLanes; ++l )
+    {
+        outPose[ l ].rotation = { q[0][ l ] * inverseLength[ l ], q[1][ l ] * inverseLength[ l ],
+                                  q[2][ l ] * inverseLength[ l ], q[3][ l ] * inverseLength[ l ] };
+        outPose[ l ].translation = { translation[0][ l ], translation[1][ l ], translation[2][ l ] };
+        outPose[ l ].scale = { scale[0][ l ], scale[1][ l ], scale[2][ l ] };
+    }
+}
+
+static float wrapTime( float time, float duration )
+{
+    float t = fmodf( time, duration );
+    if ( t < 0.f )
+    {
+        t += duration;
+    }
+    return t;
+}
+
+
+AnimationClip::AnimationClip()
+: _trackCount(0)
+, _frameCount(0)
+, _sampleRate(30.f) {
+}
+
+AnimationClip AnimationClip::compress( const Transform* rawKeys, size_t trackCount, size_t frameCount, float sampleRate ) {
+    assert( trackCount > 0 && frameCount > 1 && sampleRate > 0.f );
+
+    AnimationClip clip;
+    clip._trackCount = trackCount;
+    clip._frameCount = frameCount;
+    clip._sampleRate = sampleRate;
+    clip._ranges.resize( trackCount );
+    clip._keys.resize( trackCount * frameCount );
+
+    for ( size_t t = 0; t < trackCount; ++t )
+    {
+        float tMin[3], tMax[3], sMin[3], sMax[3];
+        for ( int c = 0; c < 3; ++c )
+        {
+            tMin[ c ] = tMax[ c ] = component( rawKeys[ t ].translation, c );
+            sMin[ c ] = sMax[ c ] = component( rawKeys[ t ].scale, c );
+        }
+        for ( size_t f = 1; f < frameCount; ++f )
+        {
+            const Transform& key = rawKeys[ f * trackCount + t ];
+            for ( int c = 0; c < 3; ++c )
+            {
+                tMin[ c ] = std::min( tMin[ c ], component( key.translation, c ) );
+                tMax[ c ] = std::max( tMax[ c ], component( key.translation, c ) );
+                sMin[ c ] = std::min( sMin[ c ], component( key.scale, c ) );
+                sMax[ c ] = std::max( sMax[ c ], component( key.scale, c ) );
+            }
+        }
+
+        TrackRange& range = clip._ranges[ t ];
+        range.translationMin = { tMin[0], tMin[1], tMin[2] };
+        range.translationExtent = { tMax[0] - tMin[0], tMax[1] - tMin[1], tMax[2] - tMin[2] };
+        range.scaleMin = { sMin[0], sMin[1], sMin[2] };
+        range.scaleExtent = { sMax[0] - sMin[0], sMax[1] - sMin[1], sMax[2] - sMin[2] };
+    }
+
+    for ( size_t f = 0; f < frameCount; ++f )
+    {
+        for ( size_t t = 0; t < trackCount; ++t )
+        {
+            const Transform& key = rawKeys[ f * trackCount + t ];
+            const TrackRange& range = clip._ranges[ t ];
+            PackedKey& packed = clip._keys[ f * trackCount + t ];
+
+            AnimationSampler::packRotation( key.rotation, packed.rotation );
+            for ( int c = 0; c < 3; ++c )
+            {
+                packed.translation[ c ] = quantize( component( key.translation, c ), component( range.translationMin, c ), component( range.translationExtent, c ) );
+                packed.scale[ c ] = quantize( component( key.scale, c ), component( range.scaleMin, c ), component( range.scaleExtent, c ) );
+            }
+        }
+    }
+
+    return clip;
+}
+
+size_t AnimationClip::sizeInBytes() const {
+    return _keys.size() * sizeof( PackedKey ) + _ranges.size() * sizeof( TrackRange );
+}
+
+
+void AnimationSampler::packRotation( const host_float4& q, uint16_t out[3] ) {
+    const host_float4 n = normalize( q.x, q.y, q.z, q.w );
+    float v[4] = { n.x, n.y, n.z, n.w };
+
+    int largest = 0;
+    for ( int i = 1; i < 4; ++i )
+    {
+        if ( fabsf( v[ i ] ) > fabsf( v[ largest ] ) )
+        {
+            largest = i;
+        }
+    }
+    // the dropped component is rebuilt as positive, flip the whole quaternion if needed
+    if ( v[ largest ] < 0.f )
+    {
+        for ( float& c : v )
+        {
+            c = -c;
+        }
+    }
+
+    int c = 0;
+    for ( int i = 0; i < 4; ++i )
+    {
+        if ( i == largest )
+        {
+            continue;
+        }
+        float n = std::clamp( v[ i ] / kQuatComponentRange * 0.5f + 0.5f, 0.f, 1.f );
+        out[ c++ ] = (uint16_t)lroundf( n * kRotationScale );
+    }
+
+    // two index bits ride in the spare top bits
+    out[0] |= (uint16_t)( ( largest & 1 ) << 15 );
+    out[1] |= (uint16_t)( ( largest >> 1 ) << 15 );
+}
+
+host_float4 AnimationSampler::unpackRotation( const uint16_t in[3] ) {
+    const int largest = ( in[0] >> 15 ) | ( ( in[1] >> 15 ) << 1 );
+
+    float abc[3];
+    for ( int c = 0; c < 3; ++c )
+    {
+        abc[ c ] = ( (float)( in[ c ] & 0x7fff ) * ( 2.f / kRotationScale ) - 1.f ) * kQuatComponentRange;
+    }
+    const float w = sqrtf( std::max( 0.f, 1.f - abc[0] * abc[0] - abc[1] * abc[1] - abc[2] * abc[2] ) );
+
+    switch ( largest )
+    {
+        case 0: return { w, abc[0], abc[1], abc[2] };
+        case 1: return { abc[0], w, abc[1], abc[2] };
+        case 2: return { abc[0], abc[1], w, abc[2] };
+        default: return { abc[0], abc[1], abc[2], w };
+    }
+}
+
+void AnimationSampler::sample( const AnimationClip& clip, float time, Transform* outPose ) {
+    const float t = wrapTime( time, clip.duration() );
+
+    const float frameF = t * clip.sampleRate();
+    const size_t f0 = std::min( (size_t)frameF, clip.frameCount() - 1 );
+    const size_t f1 = std::min( f0 + 1, clip.frameCount() - 1 );
+    const float alpha = frameF - (float)f0;
+
+    const PackedKey* row0 = clip.frame( f0 );
+    const PackedKey* row1 = clip.frame( f1 );
+    const TrackRange* ranges = clip.ranges();
+
+    const size_t count = clip.trackCount();
+    const size_t groupEnd = count - count % kLanes;
+    for ( size_t i = 0; i < groupEnd; i += kLanes )
+    {
+        sampleGroup( row0 + i, row1 + i, ranges + i, alpha, outPose + i );
+    }
+
+    // the tracks left over from the last group, one at a time
+    for ( size_t i = groupEnd; i < count; ++i )
+    {
+        const TrackRange& range = ranges[ i ];
+
+        const host_float4 r0 = unpackRotation( row0[ i ].rotation );
+        const host_float4 r1 = unpackRotation( row1[ i ].rotation );
+
+        const host_float3 t0 = dequantize( row0[ i ].translation, range.translationMin, range.translationExtent );
+        const host_float3 t1 = dequantize( row1[ i ].translation, range.translationMin, range.translationExtent );
+
+        const host_float3 s0 = dequantize( row0[ i ].scale, range.scaleMin, range.scaleExtent );
+        const host_float3 s1 = dequantize( row1[ i ].scale, range.scaleMin, range.scaleExtent );
+
+        outPose[ i ].rotation = nlerp( r0, r1, alpha );
+        outPose[ i ].translation = lerp( t0, t1, alpha );
+        outPose[ i ].scale = lerp( s0, s1, alpha );
+    }
+}
+
+void AnimationSampler::blend( const Transform* a, const Transform* b, float weight, size_t count, Transform* outPose ) {
+    for ( size_t i = 0; i < count; ++i )
+    {
+        outPose[ i ].rotation = nlerp( a[ i ].rotation, b[ i ].rotation, weight );
+        outPose[ i ].translation = lerp( a[ i ].translation, b[ i ].translation, weight );
+        outPose[ i ].scale = lerp( a[ i ].scale, b[ i ].scale, weight );
+    }
+}
+
+host_float4x4 AnimationSampler::toMatrix( const Transform& t ) {
+    const float x = t.rotation.x, y = t.rotation.y, z = t.rotation.z, w = t.rotation.w;
+    const float sx = t.scale.x, sy = t.scale.y, sz = t.scale.z;
+
+    // rotation columns scaled, then the translation
+    const host_float4 c0 = { ( 1.f - 2.f * ( y * y + z * z ) ) * sx, 2.f * ( x * y + w * z ) * sx, 2.f * ( x * z - w * y ) * sx, 0.f };
+    const host_float4 c1 = { 2.f * ( x * y - w * z ) * sy, ( 1.f - 2.f * ( x * x + z * z ) ) * sy, 2.f * ( y * z + w * x ) * sy, 0.f };
+    const host_float4 c2 = { 2.f * ( x * z + w * y ) * sz, 2.f * ( y * z - w * x ) * sz, ( 1.f - 2.f * ( x * x + y * y ) ) * sz, 0.f };
+    const host_float4 c3 = { t.translation.x, t.translation.y, t.translation.z, 1.f };
+
+    host_float4x4 m;
+    m.columns[0] = c0;
+    m.columns[1] = c1;
+    m.columns[2] = c2;
+    m.columns[3] = c3;
+    return m;
+}
+
+void AnimationSampler::toMatrices( const Transform* pose, size_t count, host_float4x4* outMatrices ) {
+    for ( size_t i = 0; i < count; ++i )
+    {
+        outMatrices[ i ] = toMatrix( pose[ i ] );
+    }
+}
+
+
+AnimationPlayer::AnimationPlayer( size_t trackCount )
+: _current(nullptr)
+, _next(nullptr)
+, _currentTime(0.f)
+, _nextTime(0.f)
+, _fadeDuration(0.f)
+, _fadeElapsed(0.f)
+, _pose(trackCount)
+, _nextPose(trackCount) {
+}
+
+void AnimationPlayer::play( const AnimationClip* clip ) {
+    assert( clip && clip->trackCount() == _pose.size() );
+    _current = clip;
+    _next = nullptr;
+    _currentTime = 0.f;
+}
+
+void AnimationPlayer::crossFade( const AnimationClip* clip, float duration ) {
+    assert( clip && clip->trackCount() == _pose.size() );
+    if ( !_current || duration <= 0.f )
+    {
+        play( clip );
+        return;
+    }
+    _next = clip;
+    _nextTime = 0.f;
+    _fadeDuration = duration;
+    _fadeElapsed = 0.f;
+}
+
+void AnimationPlayer::update( float dt ) {
+    if ( !_current )
+    {
+        return;
+    }
+
+    _currentTime = wrapTime( _currentTime + dt, _current->duration() );
+    AnimationSampler::sample( *_current, _currentTime, _pose.data() );
+
+    if ( !_next )
+    {
+        return;
+    }
+
+    _nextTime = wrapTime( _nextTime + dt, _next->duration() );
+    _fadeElapsed += dt;
+    AnimationSampler::sample( *_next, _nextTime, _nextPose.data() );
+
+    const float weight = std::min( _fadeElapsed / _fadeDuration, 1.f );
+    AnimationSampler::blend( _pose.data(), _nextPose.data(), weight, _pose.size(), _pose.data() );
+
+    if ( weight >= 1.f )
+    {
+        _current = _next;
+        _currentTime = _nextTime;
+        _next = nullptr;
+    }
+}
@@ -0,0 +1,121 @@
+/**
+  ******************************************************************************
+  * @file           : animation.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_ANIMATION_HPP
+#define METAL_PLAYGROUND_ANIMATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "shader_struct.hpp"
+
+// vectors are the simd types with the apple sdks and the shader_struct.hpp stand-ins
+// elsewhere. the module only touches their components, so it builds on both
+struct Transform
+{
+    shader_layout::host_float4 rotation;       // unit quaternion, xyz vector part and w scalar
+    shader_layout::host_float3 translation;
+    shader_layout::host_float3 scale;
+};
+
+// one key of one track, 18 bytes instead of 48 for the raw Transform.
+// rotation is stored "smallest three": the largest component is dropped and
+// rebuilt from the unit length, the other three are 15 bit fixed point.
+// translation / scale are 16 bit fixed point inside the per track range.
+struct PackedKey
+{
+    uint16_t rotation[3];
+    uint16_t translation[3];
+    uint16_t scale[3];
+};
+
+struct TrackRange
+{
+    shader_layout::host_float3 translationMin;
+    shader_layout::host_float3 translationExtent;
+    shader_layout::host_float3 scaleMin;
+    shader_layout::host_float3 scaleExtent;
+};
+
+class AnimationClip {
+private:
+    size_t _trackCount;
+    size_t _frameCount;
+    float _sampleRate;
+
+    // frame major: all tracks of frame 0, then all tracks of frame 1...
+    // sampling touches two contiguous rows, whatever the track count is.
+    std::vector<PackedKey> _keys;
+    std::vector<TrackRange> _ranges;
+
+public:
+    AnimationClip();
+
+    // raw keys are frame major as well, trackCount * frameCount transforms
+    // uniformly sampled at sampleRate. the clip loops on its last frame.
+    static AnimationClip compress( const Transform* rawKeys, size_t trackCount, size_t frameCount, float sampleRate );
+
+    size_t trackCount() const { return _trackCount; }
+    size_t frameCount() const { return _frameCount; }
+    float duration() const { return (float)( _frameCount - 1 ) / _sampleRate; }
+    size_t sizeInBytes() const;
+
+    const PackedKey* frame( size_t index ) const { return _keys.data() + index * _trackCount; }
+    const TrackRange* ranges() const { return _ranges.data(); }
+    float sampleRate() const { return _sampleRate; }
+};
+
+class AnimationSampler {
+public:
+    // evaluates every track of the clip at time (wrapped to the clip duration)
+    static void sample( const AnimationClip& clip, float time, Transform* outPose );
+
+    // lerps translation / scale, nlerps rotation along the shortest arc
+    static void blend( const Transform* a, const Transform* b, float weight, size_t count, Transform* outPose );
+
+    static void toMatrices( const Transform* pose, size_t count, shader_layout::host_float4x4* outMatrices );
+    static shader_layout::host_float4x4 toMatrix( const Transform& t );
+
+    static void packRotation( const shader_layout::host_float4& q, uint16_t out[3] );
+    static shader_layout::host_float4 unpackRotation( const uint16_t in[3] );
+};
+
+// plays one clip at a time and cross fades into the next one on request
+class AnimationPlayer {
+private:
+    const AnimationClip* _current;
+    const AnimationClip* _next;
+    // kept inside the clip's duration, a float that only grows loses the fraction
+    float _currentTime;
+    float _nextTime;
+    float _fadeDuration;
+    float _fadeElapsed;
+
+    std::vector<Transform> _pose;
+    std::vector<Transform> _nextPose;
+
+public:
+    explicit AnimationPlayer( size_t trackCount );
+
+    void play( const AnimationClip* clip );
+    void crossFade( const AnimationClip* clip, float duration );
+    bool isFading() const { return _next != nullptr; }
+
+    void update( float dt );
+
+    const Transform* pose() const { return _pose.data(); }
+    size_t trackCount() const { return _pose.size(); }
+};
+
+
+#endif //METAL_PLAYGROUND_ANIMATION_HPP
@@ -0,0 +1,208 @@
+/**
+  ******************************************************************************
+  * @file           : asset_file.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "asset_file.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lz4.hpp"
+
+static bool readFully( int fd, void* dst, size_t length, uint64_t offset )
+{
+    uint8_t* out = (uint8_t*)dst;
+    while ( length > 0 )
+    {
+        const ssize_t n = pread( fd, out, length, (off_t)offset );
+        if ( n <= 0 )
+        {
+            return false;
+        }
+        out += n;
+        offset += (uint64_t)n;
+        length -= (size_t)n;
+    }
+    return true;
+}
+
+bool writeAssetFile( const char* path, const void* data, size_t size, JobSystem& jobs, size_t chunkSize )
+{
+    const uint8_t* in = (const uint8_t*)data;
+    const size_t chunkCount = ( size + chunkSize - 1 ) / chunkSize;
+
+    std::vector<std::vector<uint8_t>> chunks( chunkCount );
+    jobs.parallelFor( chunkCount, 1, [&]( size_t begin, size_t end ) {
+        for ( size_t i = begin; i < end; ++i )
+        {
+            const size_t length = std::min( chunkSize, size - i * chunkSize );
+            std::vector<uint8_t>& c = chunks[ i ];
+            c.resize( lz4CompressBound( length ) );
+            const size_t packed = lz4Compress( in + i * chunkSize, length, c.data(), c.size() );
+            if ( packed < length )
+            {
+                c.resize( packed );
+            }
+            else
+            {
+                c.assign( in + i * chunkSize, in + i * chunkSize + length );
+            }
+        }
+    } );
+
+    AssetFileHeader header = {};
+    header.magic = kAssetFileMagic;
+    header.version = kAssetFileVersion;
+    header.chunkSize = (uint32_t)chunkSize;
+    header.chunkCount = (uint32_t)chunkCount;
+    header.size = size;
+
+    std::vector<uint64_t> offsets( chunkCount + 1 );
+    offsets[ 0 ] = sizeof( AssetFileHeader ) + offsets.size() * sizeof( uint64_t );
+    for ( size_t i = 0; i < chunkCount; ++i )
+    {
+        offsets[ i + 1 ] = offsets[ i ] + chunks[ i ].size();
+    }
+
+    FILE* f = fopen( path, "wb" );
+    if ( !f )
+    {
+        return false;
+    }
+    bool ok = fwrite( &header, sizeof( header ), 1, f ) == 1;
+    ok = ok && fwrite( offsets.data(), sizeof( uint64_t ), offsets.size(), f ) == offsets.size();
+    for ( size_t i = 0; ok && i < chunkCount; ++i )
+    {
+        ok = fwrite( chunks[ i ].data(), 1, chunks[ i ].size(), f ) == chunks[ i ].size();
+    }
+    return fclose( f ) == 0 && ok;
+}
+
+AssetFileReader::AssetFileReader()
+: _fd(-1)
+, _header{} {
+}
+
+AssetFileReader::~AssetFileReader() {
+    close();
+}
+
+bool AssetFileReader::open( const char* path ) {
+    close();
+
+    _fd = ::open( path, O_RDONLY );
+    struct stat st;
+    if ( _fd < 0 || fstat( _fd, &st ) != 0 || (uint64_t)st.st_size < sizeof( _header ) )
+    {
+        close();
+        return false;
+    }
+    const uint64_t fileSize = (uint64_t)st.st_size;
+
+    // size / chunkSize rounded up without the add that wraps for a huge size
+    if ( !readFully( _fd, &_header, sizeof( _header ), 0 )
+         || _header.magic != kAssetFileMagic
+         || _header.version != kAssetFileVersion
+         || _header.chunkSize == 0
+         || _header.chunkCount != _header.size / _header.chunkSize + ( _header.size % _header.chunkSize != 0 ) )
+    {
+        close();
+        return false;
+    }
+
+    // the offset table has to fit in the file before anything is allocated for it
+    const uint64_t tableBytes = ( (uint64_t)_header.chunkCount + 1 ) * sizeof( uint64_t );
+    if ( tableBytes > fileSize - sizeof( _header ) )
+    {
+        close();
+        return false;
+    }
+
+    _offsets.resize( (size_t)_header.chunkCount + 1 );
+    if ( !readFully( _fd, _offsets.data(), tableBytes, sizeof( _header ) )
+         || _offsets.front() != sizeof( _header ) + tableBytes
+         || _offsets.back() > fileSize )
+    {
+        close();
+        return false;
+    }
+    for ( uint32_t i = 0; i < _header.chunkCount; ++i )
+    {
+        if ( _offsets[ i + 1 ] < _offsets[ i ] || _offsets[ i + 1 ] - _offsets[ i ] > lz4CompressBound( _header.chunkSize ) )
+        {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetFileReader::close() {
+    if ( _fd >= 0 )
+    {
+        ::close( _fd );
+        _fd = -1;
+    }
+    _header = {};
+    _offsets.clear();
+}
+
+uint64_t AssetFileReader::compressedSize() const {
+    return _offsets.empty() ? 0 : _offsets.back() - _offsets.front();
+}
+
+bool AssetFileReader::read( JobSystem& jobs, void* dst, size_t batchChunks ) {
+    if ( _fd < 0 )
+    {
+        return false;
+    }
+
+    uint8_t* out = (uint8_t*)dst;
+    const size_t chunkSize = _header.chunkSize;
+    std::atomic<bool> ok( true );
+
+    jobs.parallelFor( _header.chunkCount, batchChunks, [&]( size_t begin, size_t end ) {
+        // chunks are laid out back to back, one read covers the whole range
+        thread_local std::vector<uint8_t> scratch;
+        const uint64_t first = _offsets[ begin ];
+        scratch.resize( _offsets[ end ] - first );
+        if ( !readFully( _fd, scratch.data(), scratch.size(), first ) )
+        {
+            ok = false;
+            return;
+        }
+
+        for ( size_t i = begin; i < end; ++i )
+        {
+            const size_t length = (size_t)std::min<uint64_t>( chunkSize, _header.size - i * chunkSize );
+            const uint8_t* packed = scratch.data() + ( _offsets[ i ] - first );
+            const size_t packedLength = _offsets[ i + 1 ] - _offsets[ i ];
+
+            if ( packedLength == length )
+            {
+                memcpy( out + i * chunkSize, packed, length );
+            }
+            else if ( !lz4Decompress( packed, packedLength, out + i * chunkSize, length ) )
+            {
+                ok = false;
+                return;
+            }
+        }
+    } );
+
+    return ok;
+}
@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file           : asset_file.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_ASSET_FILE_HPP
+#define METAL_PLAYGROUND_ASSET_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "job_system.hpp"
+
+// one asset per file, cut into independently lz4 compressed chunks:
+//
+//   AssetFileHeader
+//   uint64_t offsets[ chunkCount + 1 ]    chunk i is [offsets[i], offsets[i + 1])
+//   chunk data
+//
+// a chunk that would not shrink is stored as is, its stored length then equals
+// its uncompressed length.
+struct AssetFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t chunkSize;
+    uint32_t chunkCount;
+    uint64_t size;          // uncompressed
+};
+
+static constexpr uint32_t kAssetFileMagic = 0x5341504d; // 'MPAS'
+static constexpr uint32_t kAssetFileVersion = 1;
+static constexpr size_t kAssetChunkSize = 64 * 1024;
+
+// compresses the chunks on jobs and writes the file
+bool writeAssetFile( const char* path, const void* data, size_t size, JobSystem& jobs, size_t chunkSize = kAssetChunkSize );
+
+// reads asset files with pread from the job system threads. neighbouring chunks
+// are fetched batchChunks at a time with a single read and decompressed straight
+// into the destination, so there is no staging copy of the whole file.
+class AssetFileReader {
+private:
+    int _fd;
+    AssetFileHeader _header;
+    std::vector<uint64_t> _offsets;
+
+public:
+    AssetFileReader();
+    ~AssetFileReader();
+
+    AssetFileReader( const AssetFileReader& ) = delete;
+    AssetFileReader& operator=( const AssetFileReader& ) = delete;
+
+    bool open( const char* path );
+    void close();
+
+    uint64_t size() const { return _header.size; }
+    uint64_t compressedSize() const;
+
+    // dst takes size() bytes. false on a short read or a corrupt chunk
+    bool read( JobSystem& jobs, void* dst, size_t batchChunks = 16 );
+};
+
+
+#endif //METAL_PLAYGROUND_ASSET_FILE_HPP
@@ -0,0 +1,265 @@
+/**
+  ******************************************************************************
+  * @file           : asset_streamer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "asset_streamer.hpp"
+
+#include <cstring>
+#include <vector>
+
+#include "asset_file.hpp"
+
+// staging ring of the cpu streamer, the widest texture row has to fit a quarter of it
+static constexpr size_t kCpuStagingSize = 32 << 20;
+
+static std::future<bool> failedLoad()
+{
+    std::promise<bool> promise;
+    promise.set_value( false );
+    return promise.get_future();
+}
+
+AssetStreamer* AssetStreamer::create( MTL::Device* device, bool allowIOQueue ) {
+    if ( allowIOQueue )
+    {
+        if ( AssetStreamer* streamer = IOQueueAssetStreamer::create( device ) )
+        {
+            return streamer;
+        }
+    }
+    return new CpuAssetStreamer( device );
+}
+
+IOQueueAssetStreamer::IOQueueAssetStreamer( MTL::Device* device, MTL::IOCommandQueue* ioQueue )
+: _device(device->retain())
+, _ioQueue(ioQueue) {
+}
+
+IOQueueAssetStreamer* IOQueueAssetStreamer::create( MTL::Device* device ) {
+    // macOS 13 and later
+    if ( !NS::Object::respondsToSelector( device, sel_registerName( "newIOCommandQueueWithDescriptor:error:" ) ) )
+    {
+        return nullptr;
+    }
+
+    MTL::IOCommandQueueDescriptor* pDesc = MTL::IOCommandQueueDescriptor::alloc()->init();
+    pDesc->setType( MTL::IOCommandQueueTypeConcurrent );
+    pDesc->setPriority( MTL::IOPriorityNormal );
+
+    NS::Error* pError = nullptr;
+    MTL::IOCommandQueue* ioQueue = device->newIOCommandQueue( pDesc, &pError );
+    pDesc->release();
+
+    if ( !ioQueue )
+    {
+        __builtin_printf( "no io command queue, %s\n", pError ? pError->localizedDescription()->utf8String() : "unsupported" );
+        return nullptr;
+    }
+    return new IOQueueAssetStreamer( device, ioQueue );
+}
+
+IOQueueAssetStreamer::~IOQueueAssetStreamer() {
+    _ioQueue->release();
+    _device->release();
+}
+
+bool IOQueueAssetStreamer::writeAsset( const char* path, const void* data, size_t size ) {
+    MTL::IOCompresionContext context = MTL::IOCreateCompressionContext( path, MTL::IOCompressionMethodLZ4, kAssetChunkSize );
+    if ( !context )
+    {
+        return false;
+    }
+    MTL::IOCompressionContextAppendData( context, data, size );
+    return MTL::IOFlushAndDestroyCompressionContext( context ) == MTL::IOCompressionStatusComplete;
+}
+
+MTL::IOFileHandle* IOQueueAssetStreamer::openHandle( const char* path ) {
+    NS::AutoreleasePool* pPool = NS::AutoreleasePool::alloc()->init();
+
+    NS::URL* pUrl = NS::URL::fileURLWithPath( NS::String::string( path, NS::StringEncoding::UTF8StringEncoding ) );
+    NS::Error* pError = nullptr;
+    MTL::IOFileHandle* handle = _device->newIOHandle( pUrl, MTL::IOCompressionMethodLZ4, &pError );
+    if ( !handle )
+    {
+        __builtin_printf( "%s: %s\n", path, pError ? pError->localizedDescription()->utf8String() : "cannot open" );
+    }
+
+    pPool->release();
+    return handle;
+}
+
+std::future<bool> IOQueueAssetStreamer::loadBuffer( const char* path, MTL::Buffer* dst, size_t dstOffset, size_t size ) {
+    MTL::IOFileHandle* handle = openHandle( path );
+    if ( !handle )
+    {
+        return failedLoad();
+    }
+
+    std::promise<bool>* promise = new std::promise<bool>();
+    std::future<bool> future = promise->get_future();
+
+    // offsets into a compressed handle are uncompressed offsets
+    MTL::IOCommandBuffer* cmd = _ioQueue->commandBuffer();
+    cmd->loadBuffer( dst, dstOffset, size, handle, 0 );
+    cmd->addCompletedHandler( ^void( MTL::IOCommandBuffer* pCmd ) {
+        promise->set_value( pCmd->status() == MTL::IOStatusComplete );
+        delete promise;
+        handle->release();
+    } );
+    cmd->commit();
+
+    return future;
+}
+
+std::future<bool> IOQueueAssetStreamer::loadTexture( const char* path, MTL::Texture* dst, uint32_t width, uint32_t height, size_t bytesPerRow ) {
+    MTL::IOFileHandle* handle = openHandle( path );
+    if ( !handle )
+    {
+        return failedLoad();
+    }
+
+    std::promise<bool>* promise = new std::promise<bool>();
+    std::future<bool> future = promise->get_future();
+
+    MTL::IOCommandBuffer* cmd = _ioQueue->commandBuffer();
+    cmd->loadTexture( dst, 0, 0, MTL::Size( width, height, 1 ), bytesPerRow, bytesPerRow * height,
+                      MTL::Origin( 0, 0, 0 ), handle, 0 );
+    cmd->addCompletedHandler( ^void( MTL::IOCommandBuffer* pCmd ) {
+        promise->set_value( pCmd->status() == MTL::IOStatusComplete );
+        delete promise;
+        handle->release();
+    } );
+    cmd->commit();
+
+    return future;
+}
+
+CpuAssetStreamer::CpuAssetStreamer( MTL::Device* device, size_t threadCount )
+: _jobs(threadCount)
+, _copyEngine(device, kCpuStagingSize)
+, _uploads(_copyEngine)
+, _quit(false)
+, _loader(&CpuAssetStreamer::loaderMain, this) {
+}
+
+CpuAssetStreamer::~CpuAssetStreamer() {
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _quit = true;
+    }
+    _wake.notify_all();
+    _loader.join();
+}
+
+bool CpuAssetStreamer::writeAsset( const char* path, const void* data, size_t size ) {
+    return writeAssetFile( path, data, size, _jobs );
+}
+
+std::future<bool> CpuAssetStreamer::enqueue( std::unique_ptr<Load> l ) {
+    std::future<bool> future = l->promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _pending.push_back( std::move( l ) );
+    }
+    _wake.notify_one();
+    return future;
+}
+
+std::future<bool> CpuAssetStreamer::loadBuffer( const char* path, MTL::Buffer* dst, size_t dstOffset, size_t size ) {
+    std::unique_ptr<Load> l( new Load() );
+    l->path = path;
+    l->buffer = dst;
+    l->dstOffset = dstOffset;
+    l->size = size;
+    return enqueue( std::move( l ) );
+}
+
+std::future<bool> CpuAssetStreamer::loadTexture( const char* path, MTL::Texture* dst, uint32_t width, uint32_t height, size_t bytesPerRow ) {
+    std::unique_ptr<Load> l( new Load() );
+    l->path = path;
+    l->texture = dst;
+    l->width = width;
+    l->height = height;
+    l->bytesPerRow = bytesPerRow;
+    l->size = bytesPerRow * height;
+    return enqueue( std::move( l ) );
+}
+
+bool CpuAssetStreamer::load( Load& l ) {
+    AssetFileReader reader;
+    if ( !reader.open( l.path.c_str() ) || reader.size() != l.size )
+    {
+        return false;
+    }
+
+    if ( l.buffer && l.buffer->storageMode() != MTL::StorageModePrivate )
+    {
+        if ( !reader.read( _jobs, (uint8_t*)l.buffer->contents() + l.dstOffset ) )
+        {
+            return false;
+        }
+        if ( l.buffer->storageMode() == MTL::StorageModeManaged )
+        {
+            l.buffer->didModifyRange( NS::Range::Make( l.dstOffset, l.size ) );
+        }
+        return true;
+    }
+
+    // private resources and textures need a copy, decompress into host memory first
+    std::vector<uint8_t> host( l.size );
+    if ( !reader.read( _jobs, host.data() ) )
+    {
+        return false;
+    }
+
+    if ( l.texture && l.texture->storageMode() != MTL::StorageModePrivate )
+    {
+        l.texture->replaceRegion( MTL::Region::Make2D( 0, 0, l.width, l.height ), 0, host.data(), l.bytesPerRow );
+        return true;
+    }
+
+    std::future<void> uploaded;
+    if ( l.buffer )
+    {
+        uploaded = _uploads.uploadBuffer( l.buffer, l.dstOffset, host.data(), l.size );
+    }
+    else
+    {
+        const uint8_t* src = host.data();
+        uploaded = _uploads.uploadTexture( l.texture, 0, l.width, l.height, l.bytesPerRow, [src]( void* out, size_t offset, size_t count ) {
+            memcpy( out, src + offset, count );
+        } );
+    }
+    uploaded.wait();
+    return true;
+}
+
+void CpuAssetStreamer::loaderMain() {
+    for ( ;; )
+    {
+        std::unique_ptr<Load> l;
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+            _wake.wait( lock, [this] { return _quit || !_pending.empty(); } );
+            if ( _pending.empty() )
+            {
+                return;
+            }
+            l = std::move( _pending.front() );
+            _pending.pop_front();
+        }
+
+        // replaceRegion and friends autorelease
+        NS::AutoreleasePool* pPool = NS::AutoreleasePool::alloc()->init();
+        l->promise.set_value( load( *l ) );
+        pPool->release();
+    }
+}
@@ -0,0 +1,117 @@
+/**
+  ******************************************************************************
+  * @file           : asset_streamer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_ASSET_STREAMER_HPP
+#define METAL_PLAYGROUND_ASSET_STREAMER_HPP
+
+#include <Metal/Metal.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "job_system.hpp"
+#include "metal_copy_engine.hpp"
+#include "upload_queue.hpp"
+
+// loads compressed, chunked asset files into buffers and textures in the background.
+// every streamer reads its own on disk format, writeAsset() bakes data into it.
+// the futures turn true once the data is in the resource and false if loading failed.
+class AssetStreamer {
+public:
+    virtual ~AssetStreamer() = default;
+
+    virtual const char* name() const = 0;
+
+    virtual bool writeAsset( const char* path, const void* data, size_t size ) = 0;
+
+    // size bytes of the asset go to [dstOffset, dstOffset + size) of dst
+    virtual std::future<bool> loadBuffer( const char* path, MTL::Buffer* dst, size_t dstOffset, size_t size ) = 0;
+    // the asset is level 0 of dst as height rows of bytesPerRow bytes
+    virtual std::future<bool> loadTexture( const char* path, MTL::Texture* dst, uint32_t width, uint32_t height, size_t bytesPerRow ) = 0;
+
+    // the io command queue when the device has one, the cpu streamer otherwise
+    static AssetStreamer* create( MTL::Device* device, bool allowIOQueue = true );
+};
+
+// MTLIOCommandQueue: metal reads and decompresses the file straight into the resource,
+// the cpu only records the load. files are written with the metal lz4 compression context.
+class IOQueueAssetStreamer : public AssetStreamer {
+private:
+    MTL::Device* _device;
+    MTL::IOCommandQueue* _ioQueue;
+
+    IOQueueAssetStreamer( MTL::Device* device, MTL::IOCommandQueue* ioQueue );
+
+    MTL::IOFileHandle* openHandle( const char* path );
+
+public:
+    // nullptr when the os or the device has no io command queues
+    static IOQueueAssetStreamer* create( MTL::Device* device );
+    ~IOQueueAssetStreamer() override;
+
+    const char* name() const override { return "io command queue"; }
+
+    bool writeAsset( const char* path, const void* data, size_t size ) override;
+    std::future<bool> loadBuffer( const char* path, MTL::Buffer* dst, size_t dstOffset, size_t size ) override;
+    std::future<bool> loadTexture( const char* path, MTL::Texture* dst, uint32_t width, uint32_t height, size_t bytesPerRow ) override;
+};
+
+// portable fallback: a loader thread takes requests in order and reads them with
+// AssetFileReader, which spreads pread batches and lz4 decompression over a job system.
+// cpu visible buffers are decompressed in place, everything else goes through an upload queue.
+class CpuAssetStreamer : public AssetStreamer {
+private:
+    struct Load
+    {
+        std::string path;
+        MTL::Buffer* buffer;
+        size_t dstOffset;
+        size_t size;
+        MTL::Texture* texture;
+        uint32_t width, height;
+        size_t bytesPerRow;
+        std::promise<bool> promise;
+    };
+
+    JobSystem _jobs;
+    MetalCopyEngine _copyEngine;
+    UploadQueue _uploads;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::deque<std::unique_ptr<Load>> _pending;
+    bool _quit;
+    std::thread _loader;
+
+    bool load( Load& l );
+    std::future<bool> enqueue( std::unique_ptr<Load> l );
+    void loaderMain();
+
+public:
+    // threadCount as in JobSystem
+    explicit CpuAssetStreamer( MTL::Device* device, size_t threadCount = 0 );
+    ~CpuAssetStreamer() override;
+
+    const char* name() const override { return "cpu fallback"; }
+
+    bool writeAsset( const char* path, const void* data, size_t size ) override;
+    std::future<bool> loadBuffer( const char* path, MTL::Buffer* dst, size_t dstOffset, size_t size ) override;
+    std::future<bool> loadTexture( const char* path, MTL::Texture* dst, uint32_t width, uint32_t height, size_t bytesPerRow ) override;
+};
+
+
+#endif //METAL_PLAYGROUND_ASSET_STREAMER_HPP
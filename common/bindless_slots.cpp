@@ -0,0 +1,51 @@
+/**
+  ******************************************************************************
+  * @file           : bindless_slots.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bindless_slots.hpp"
+
+#include <cassert>
+
+SlotAllocator::SlotAllocator( uint32_t capacity )
+: _capacity(capacity)
+, _live(capacity, false) {
+    for ( uint32_t i = 0; i < capacity; ++i )
+    {
+        _free.push( i );
+    }
+}
+
+uint32_t SlotAllocator::allocate() {
+    if ( _free.empty() )
+    {
+        return kInvalidSlot;
+    }
+    const uint32_t slot = _free.top();
+    _free.pop();
+    _live[ slot ] = true;
+    return slot;
+}
+
+void SlotAllocator::release( uint32_t slot, uint64_t frame ) {
+    assert( isLive( slot ) );
+    assert( _retired.empty() || _retired.back().frame <= frame );
+
+    _live[ slot ] = false;
+    _retired.push_back( { slot, frame } );
+}
+
+void SlotAllocator::reclaim( uint64_t completedFrame ) {
+    while ( !_retired.empty() && _retired.front().frame <= completedFrame )
+    {
+        _free.push( _retired.front().slot );
+        _retired.pop_front();
+    }
+}
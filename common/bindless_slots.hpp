@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file           : bindless_slots.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_BINDLESS_SLOTS_HPP
+#define METAL_PLAYGROUND_BINDLESS_SLOTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// hands out stable indices into a fixed size table. a released slot may still be
+// read by frames in flight, so it only goes back to the free list once the frame
+// it was released in has completed.
+class SlotAllocator {
+public:
+    static constexpr uint32_t kInvalidSlot = ~0u;
+
+private:
+    struct Retired
+    {
+        uint32_t slot;
+        uint64_t frame;
+    };
+
+    uint32_t _capacity;
+    // min heap, keeps the live slots packed at the front of the table
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> _free;
+    std::deque<Retired> _retired;   // in frame order
+    std::vector<bool> _live;
+
+public:
+    explicit SlotAllocator( uint32_t capacity );
+
+    // lowest free index first; kInvalidSlot when the table is full
+    uint32_t allocate();
+    void release( uint32_t slot, uint64_t frame );
+    // slots released in frames up to and including completedFrame become free again
+    void reclaim( uint64_t completedFrame );
+
+    bool isLive( uint32_t slot ) const { return slot < _capacity && _live[ slot ]; }
+    uint32_t capacity() const { return _capacity; }
+    size_t liveCount() const { return _capacity - _free.size() - _retired.size(); }
+    size_t retiredCount() const { return _retired.size(); }
+};
+
+// byte layout of the bindless table, metal 3 argument buffers written without an encoder:
+//
+//   uint64_t buffers[ bufferCapacity ]          MTL::Buffer::gpuAddress() + offset, 0 when empty
+//   MTL::ResourceID textures[ textureCapacity ] MTL::Texture::gpuResourceID()
+//
+// which matches the shader side
+//
+//   struct BindlessTable
+//   {
+//       device const uchar* buffers[ bufferCapacity ];
+//       texture2d<half> textures[ textureCapacity ];
+//   };
+struct BindlessLayout
+{
+    static constexpr size_t kEntrySize = 8;
+
+    uint32_t bufferCapacity;
+    uint32_t textureCapacity;
+
+    size_t bufferOffset( uint32_t slot ) const { return slot * kEntrySize; }
+    size_t textureOffset( uint32_t slot ) const { return ( bufferCapacity + slot ) * kEntrySize; }
+    size_t size() const { return ( bufferCapacity + textureCapacity ) * kEntrySize; }
+};
+
+
+#endif //METAL_PLAYGROUND_BINDLESS_SLOTS_HPP
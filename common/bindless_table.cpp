@@ -0,0 +1,96 @@
+/**
+  ******************************************************************************
+  * @file           : bindless_table.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bindless_table.hpp"
+
+#include <cassert>
+#include <cstring>
+
+static_assert( sizeof( MTL::ResourceID ) == BindlessLayout::kEntrySize, "texture entries are resource ids" );
+
+BindlessTable::BindlessTable( MTL::Device* device, uint32_t bufferCapacity, uint32_t textureCapacity )
+: _device(device->retain())
+, _layout{ bufferCapacity, textureCapacity }
+, _table(device->newBuffer( _layout.size(), MTL::ResourceStorageModeShared ))
+, _bufferSlots(bufferCapacity)
+, _textureSlots(textureCapacity)
+, _frame(1)
+, _completedFrame(0) {
+    memset( _table->contents(), 0, _layout.size() );
+}
+
+BindlessTable::~BindlessTable() {
+    _table->release();
+    _device->release();
+}
+
+void BindlessTable::write( size_t offset, uint64_t value ) {
+    memcpy( (uint8_t*)_table->contents() + offset, &value, sizeof( value ) );
+}
+
+void BindlessTable::reclaim() {
+    const uint64_t completed = completedFrame();
+    _bufferSlots.reclaim( completed );
+    _textureSlots.reclaim( completed );
+}
+
+uint32_t BindlessTable::addBuffer( MTL::Buffer* buffer, size_t offset ) {
+    reclaim();
+    const uint32_t slot = _bufferSlots.allocate();
+    if ( slot != SlotAllocator::kInvalidSlot )
+    {
+        write( _layout.bufferOffset( slot ), buffer->gpuAddress() + offset );
+    }
+    return slot;
+}
+
+uint32_t BindlessTable::addTexture( MTL::Texture* texture ) {
+    reclaim();
+    const uint32_t slot = _textureSlots.allocate();
+    if ( slot != SlotAllocator::kInvalidSlot )
+    {
+        write( _layout.textureOffset( slot ), texture->gpuResourceID()._impl );
+    }
+    return slot;
+}
+
+void BindlessTable::removeBuffer( uint32_t slot ) {
+    // the entry keeps its old value, frames in flight may still read it
+    _bufferSlots.release( slot, _frame );
+}
+
+void BindlessTable::removeTexture( uint32_t slot ) {
+    _textureSlots.release( slot, _frame );
+}
+
+void BindlessTable::setBuffer( uint32_t slot, MTL::Buffer* buffer, size_t offset ) {
+    assert( _bufferSlots.isLive( slot ) );
+    write( _layout.bufferOffset( slot ), buffer->gpuAddress() + offset );
+}
+
+void BindlessTable::setTexture( uint32_t slot, MTL::Texture* texture ) {
+    assert( _textureSlots.isLive( slot ) );
+    write( _layout.textureOffset( slot ), texture->gpuResourceID()._impl );
+}
+
+void BindlessTable::bind( MTL::RenderCommandEncoder* enc, NS::UInteger index ) const {
+    enc->setVertexBuffer( _table, 0, index );
+    enc->setFragmentBuffer( _table, 0, index );
+}
+
+void BindlessTable::commit( MTL::CommandBuffer* cmd ) {
+    // command buffers of a queue complete in order, the latest frame wins
+    const uint64_t frame = _frame++;
+    cmd->addCompletedHandler( ^void( MTL::CommandBuffer* pCmd ) {
+        this->_completedFrame.store( frame, std::memory_order_release );
+    } );
+}
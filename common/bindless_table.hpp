@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file           : bindless_table.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_BINDLESS_TABLE_HPP
+#define METAL_PLAYGROUND_BINDLESS_TABLE_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include <Metal/Metal.hpp>
+
+#include "bindless_slots.hpp"
+
+// one argument buffer holding every buffer and texture a frame may touch, laid out
+// as in BindlessLayout. shaders get a slot index instead of a binding, so switching
+// resources between draws is a constant, not an encoder call.
+//
+// entries are written in place: a slot is only handed out again after the frame
+// that removed it has completed, so no frame in flight ever sees a slot change.
+// the table does not make the resources resident, put them in heaps and call
+// useHeap (HeapAllocator::useHeaps) once per encoder.
+class BindlessTable {
+private:
+    MTL::Device* _device;
+    BindlessLayout _layout;
+    MTL::Buffer* _table;
+
+    SlotAllocator _bufferSlots;
+    SlotAllocator _textureSlots;
+
+    uint64_t _frame;
+    std::atomic<uint64_t> _completedFrame;
+
+    void write( size_t offset, uint64_t value );
+    void reclaim();
+
+public:
+    // needs a metal 3 device, entries are gpu addresses and resource ids
+    BindlessTable( MTL::Device* device, uint32_t bufferCapacity, uint32_t textureCapacity );
+    ~BindlessTable();
+
+    BindlessTable( const BindlessTable& ) = delete;
+    BindlessTable& operator=( const BindlessTable& ) = delete;
+
+    const BindlessLayout& layout() const { return _layout; }
+    MTL::Buffer* table() const { return _table; }
+
+    // SlotAllocator::kInvalidSlot when the table is full
+    uint32_t addBuffer( MTL::Buffer* buffer, size_t offset = 0 );
+    uint32_t addTexture( MTL::Texture* texture );
+    void removeBuffer( uint32_t slot );
+    void removeTexture( uint32_t slot );
+
+    // points a live slot somewhere else right away, frames in flight may see either.
+    // fine when both hold the same data, e.g. after HeapAllocator::defragment()
+    // once its copies have completed
+    void setBuffer( uint32_t slot, MTL::Buffer* buffer, size_t offset = 0 );
+    void setTexture( uint32_t slot, MTL::Texture* texture );
+
+    // the table at index of the vertex and fragment stages
+    void bind( MTL::RenderCommandEncoder* enc, NS::UInteger index ) const;
+
+    // ends the frame encoded into cmd, whatever it removed is recycled once cmd completes
+    void commit( MTL::CommandBuffer* cmd );
+
+    uint64_t frame() const { return _frame; }
+    uint64_t completedFrame() const { return _completedFrame.load( std::memory_order_acquire ); }
+    size_t liveBuffers() const { return _bufferSlots.liveCount(); }
+    size_t liveTextures() const { return _textureSlots.liveCount(); }
+};
+
+
+#endif //METAL_PLAYGROUND_BINDLESS_TABLE_HPP
@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file           : deletion_queue.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "deletion_queue.hpp"
+
+#include <cassert>
+
+DeletionQueue::DeletionQueue( size_t capacity )
+: _head(0)
+, _count(0)
+, _frame(1)
+, _completedFrame(0)
+, _collected(0) {
+    size_t size = 1;
+    while ( size < capacity )
+    {
+        size <<= 1;
+    }
+    _entries.resize( size );
+}
+
+DeletionQueue::~DeletionQueue() {
+    flush();
+}
+
+void DeletionQueue::grow() {
+    // unrolled so the oldest entry lands at index 0 again
+    std::vector<Entry> entries( _entries.size() * 2 );
+    const size_t mask = _entries.size() - 1;
+    for ( size_t i = 0; i < _count; ++i )
+    {
+        entries[ i ] = _entries[ ( _head + i ) & mask ];
+    }
+    _entries.swap( entries );
+    _head = 0;
+}
+
+void DeletionQueue::defer( Function function, void* context, uint64_t value ) {
+    if ( _count == _entries.size() )
+    {
+        grow();
+    }
+    _entries[ ( _head + _count ) & ( _entries.size() - 1 ) ] = { function, context, value, _frame };
+    ++_count;
+}
+
+void DeletionQueue::complete( uint64_t frame ) {
+    // a max, so a handler running late can not move the fence back
+    uint64_t completed = _completedFrame.load( std::memory_order_relaxed );
+    while ( completed < frame
+            && !_completedFrame.compare_exchange_weak( completed, frame, std::memory_order_release, std::memory_order_relaxed ) )
+    {
+    }
+}
+
+size_t DeletionQueue::collect() {
+    const uint64_t completed = completedFrame();
+    assert( completed < _frame );
+
+    size_t ran = 0;
+    while ( _count > 0 && _entries[ _head ].frame <= completed )
+    {
+        // popped first, the function may retire something new and grow the ring
+        const Entry e = _entries[ _head ];
+        _head = ( _head + 1 ) & ( _entries.size() - 1 );
+        --_count;
+        e.function( e.context, e.value );
+        ++ran;
+    }
+    _collected += ran;
+    return ran;
+}
+
+size_t DeletionQueue::flush() {
+    size_t ran = 0;
+    while ( _count > 0 )
+    {
+        const Entry e = _entries[ _head ];
+        _head = ( _head + 1 ) & ( _entries.size() - 1 );
+        --_count;
+        e.function( e.context, e.value );
+        ++ran;
+    }
+    _collected += ran;
+    return ran;
+}
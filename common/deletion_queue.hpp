@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file           : deletion_queue.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_DELETION_QUEUE_HPP
+#define METAL_PLAYGROUND_DELETION_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// releases held back until the gpu is done with the frame that may still use them,
+// so a buffer or texture can be swapped out mid run without waitUntilCompleted.
+//
+// every frame gets a fence value, frame(). what is deferred during a frame runs once
+// complete() reports that frame done and collect() comes around. the completion side
+// only raises an atomic fence, it never takes a lock or touches the entries; defer(),
+// collect() and endFrame() belong to the render thread.
+// metal_deletion.hpp ties the fences to command buffers.
+class DeletionQueue {
+public:
+    using Function = void (*)( void* context, uint64_t value );
+
+private:
+    struct Entry
+    {
+        Function function;
+        void* context;
+        uint64_t value;
+        uint64_t frame;
+    };
+
+    // ring in frame order, the capacity is a power of two and only grows
+    std::vector<Entry> _entries;
+    size_t _head;
+    size_t _count;
+
+    uint64_t _frame;
+    std::atomic<uint64_t> _completedFrame;
+    size_t _collected;
+
+    void grow();
+
+public:
+    explicit DeletionQueue( size_t capacity = 64 );
+    // runs whatever is still queued, the gpu has to be idle by then
+    ~DeletionQueue();
+
+    DeletionQueue( const DeletionQueue& ) = delete;
+    DeletionQueue& operator=( const DeletionQueue& ) = delete;
+
+    // function( context, value ) once the current frame has completed
+    void defer( Function function, void* context, uint64_t value );
+
+    // ends the current frame and returns its fence, for complete() once the gpu is done
+    uint64_t endFrame() { return _frame++; }
+
+    // marks frames up to and including frame done, from any thread and lock free
+    void complete( uint64_t frame );
+
+    // runs the entries of completed frames, returns how many
+    size_t collect();
+    // runs everything, for when the gpu is known to be idle
+    size_t flush();
+
+    uint64_t frame() const { return _frame; }
+    uint64_t completedFrame() const { return _completedFrame.load( std::memory_order_acquire ); }
+    size_t pendingCount() const { return _count; }
+    size_t collectedCount() const { return _collected; }
+};
+
+
+#endif //METAL_PLAYGROUND_DELETION_QUEUE_HPP
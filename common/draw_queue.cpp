@@ -0,0 +1,103 @@
+/**
+  ******************************************************************************
+  * @file           : draw_queue.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "draw_queue.hpp"
+
+#include <cassert>
+#include <utility>
+
+static constexpr int kRadixBits = 8;
+static constexpr int kRadixPasses = 64 / kRadixBits;
+static constexpr size_t kBuckets = 1 << kRadixBits;
+
+DrawQueue::DrawQueue( size_t capacity )
+: _packets(capacity)
+, _count(0)
+, _entries(capacity)
+, _scratch(capacity)
+, _sorted(false) {
+}
+
+bool DrawQueue::push( const DrawPacket& packet ) {
+    const size_t slot = _count.fetch_add( 1, std::memory_order_relaxed );
+    if ( slot >= _packets.size() )
+    {
+        return false;
+    }
+    _packets[ slot ] = packet;
+    return true;
+}
+
+void DrawQueue::clear() {
+    _count.store( 0, std::memory_order_relaxed );
+    _sorted = false;
+}
+
+size_t DrawQueue::size() const {
+    const size_t count = _count.load( std::memory_order_relaxed );
+    return count < _packets.size() ? count : _packets.size();
+}
+
+void DrawQueue::sort() {
+    const size_t count = size();
+
+    // one read of the keys builds the histograms of all eight passes
+    size_t histograms[ kRadixPasses ][ kBuckets ] = {};
+    for ( size_t i = 0; i < count; ++i )
+    {
+        const uint64_t key = _packets[ i ].key;
+        _entries[ i ] = { key, (uint32_t)i };
+        for ( int pass = 0; pass < kRadixPasses; ++pass )
+        {
+            ++histograms[ pass ][ ( key >> ( pass * kRadixBits ) ) & ( kBuckets - 1 ) ];
+        }
+    }
+
+    SortEntry* src = _entries.data();
+    SortEntry* dst = _scratch.data();
+
+    for ( int pass = 0; pass < kRadixPasses; ++pass )
+    {
+        size_t* histogram = histograms[ pass ];
+        const int shift = pass * kRadixBits;
+
+        // all keys share this byte, the pass would not move anything
+        if ( count == 0 || histogram[ ( src[0].key >> shift ) & ( kBuckets - 1 ) ] == count )
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for ( size_t b = 0; b < kBuckets; ++b )
+        {
+            const size_t n = histogram[ b ];
+            histogram[ b ] = offset;
+            offset += n;
+        }
+
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const size_t bucket = ( src[ i ].key >> shift ) & ( kBuckets - 1 );
+            dst[ histogram[ bucket ]++ ] = src[ i ];
+        }
+
+        std::swap( src, dst );
+    }
+
+    // an odd number of passes leaves the result in the scratch buffer
+    if ( src != _entries.data() )
+    {
+        _entries.swap( _scratch );
+    }
+
+    _sorted = true;
+}
@@ -0,0 +1,166 @@
+/**
+  ******************************************************************************
+  * @file           : draw_queue.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_DRAW_QUEUE_HPP
+#define METAL_PLAYGROUND_DRAW_QUEUE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 64 bit sort key, most significant first:
+//   pass 4 | pipeline 12 | material 16 | depth 32
+// sorting by key groups draws by pass, then by pipeline, then by material,
+// and orders them front to back inside a group.
+namespace DrawKey
+{
+    static constexpr int kPassShift = 60;
+    static constexpr int kPipelineShift = 48;
+    static constexpr int kMaterialShift = 32;
+
+    inline uint64_t make( uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t depth )
+    {
+        return ( (uint64_t)( pass & 0xf ) << kPassShift )
+             | ( (uint64_t)( pipeline & 0xfff ) << kPipelineShift )
+             | ( (uint64_t)( material & 0xffff ) << kMaterialShift )
+             | (uint64_t)depth;
+    }
+
+    // view depth in [0, 1] to the low 32 bits
+    inline uint32_t quantizeDepth( float depth01 )
+    {
+        depth01 = depth01 < 0.f ? 0.f : ( depth01 > 1.f ? 1.f : depth01 );
+        return (uint32_t)( depth01 * 4294967040.f );
+    }
+
+    inline uint32_t pass( uint64_t key ) { return (uint32_t)( key >> kPassShift ) & 0xf; }
+    inline uint32_t pipeline( uint64_t key ) { return (uint32_t)( key >> kPipelineShift ) & 0xfff; }
+    inline uint32_t material( uint64_t key ) { return (uint32_t)( key >> kMaterialShift ) & 0xffff; }
+}
+
+// everything replay needs to issue one draw, 32 bytes.
+// state fields are indices into tables the backend owns.
+struct DrawPacket
+{
+    uint64_t key;
+    uint16_t pipeline;
+    uint16_t depthStencil;
+    uint16_t material;
+    uint8_t cullMode;
+    uint8_t reserved;
+    uint32_t indexCount;
+    uint32_t indexOffset;
+    uint32_t instanceCount;
+    uint32_t baseInstance;
+};
+
+struct ReplayStats
+{
+    size_t draws;
+    size_t pipelineChanges;
+    size_t depthStencilChanges;
+    size_t materialChanges;
+    size_t cullModeChanges;
+
+    size_t stateChanges() const { return pipelineChanges + depthStencilChanges + materialChanges + cullModeChanges; }
+};
+
+class DrawQueue {
+private:
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t packet;
+    };
+
+    std::vector<DrawPacket> _packets;
+    std::atomic<size_t> _count;
+
+    std::vector<SortEntry> _entries;
+    std::vector<SortEntry> _scratch;
+    bool _sorted;
+
+public:
+    explicit DrawQueue( size_t capacity );
+
+    // pushes may come from several submitter threads at once, no locks taken.
+    // returns false once the queue is full.
+    bool push( const DrawPacket& packet );
+    void clear();
+
+    size_t size() const;
+    size_t capacity() const { return _packets.size(); }
+
+    // lsd radix sort on the key, 8 bits per pass. passes where every key
+    // has the same byte are skipped, so unused key fields cost nothing.
+    void sort();
+
+    // i-th packet in key order, valid after sort()
+    const DrawPacket& sorted( size_t i ) const { return _packets[ _entries[ i ].packet ]; }
+
+    // replays [begin, end) in key order, only forwarding state that actually changes.
+    // Backend: setPipeline(uint16_t), setDepthStencil(uint16_t), setMaterial(uint16_t),
+    //          setCullMode(uint8_t), draw(const DrawPacket&)
+    template <typename Backend>
+    ReplayStats replay( Backend& backend, size_t begin, size_t end ) const;
+};
+
+template <typename Backend>
+ReplayStats DrawQueue::replay( Backend& backend, size_t begin, size_t end ) const
+{
+    assert( _sorted );
+
+    ReplayStats stats = {};
+    if ( begin >= end )
+    {
+        return stats;
+    }
+
+    // the first draw of a range always binds everything, the encoder may be fresh
+    const DrawPacket* last = nullptr;
+    for ( size_t i = begin; i < end; ++i )
+    {
+        const DrawPacket& p = sorted( i );
+
+        if ( !last || p.pipeline != last->pipeline )
+        {
+            backend.setPipeline( p.pipeline );
+            ++stats.pipelineChanges;
+        }
+        if ( !last || p.depthStencil != last->depthStencil )
+        {
+            backend.setDepthStencil( p.depthStencil );
+            ++stats.depthStencilChanges;
+        }
+        if ( !last || p.material != last->material )
+        {
+            backend.setMaterial( p.material );
+            ++stats.materialChanges;
+        }
+        if ( !last || p.cullMode != last->cullMode )
+        {
+            backend.setCullMode( p.cullMode );
+            ++stats.cullModeChanges;
+        }
+
+        backend.draw( p );
+        ++stats.draws;
+        last = &p;
+    }
+
+    return stats;
+}
+
+
+#endif //METAL_PLAYGROUND_DRAW_QUEUE_HPP
@@ -0,0 +1,99 @@
+/**
+  ******************************************************************************
+  * @file           : dynamic_resolution.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "dynamic_resolution.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// the integral alone can move the area by at most ki times this per update
+static constexpr double kIntegralLimit = 1.0;
+// frame times past this multiple of the filtered time are clamped to it
+static constexpr double kOutlier = 1.5;
+
+DynamicResolutionSettings makeDynamicResolutionSettings( double targetSeconds, float minScale, float maxScale ) {
+    DynamicResolutionSettings settings;
+    settings.targetSeconds = targetSeconds;
+    settings.minScale = minScale;
+    settings.maxScale = maxScale;
+    settings.kp = 0.25f;
+    settings.ki = 0.02f;
+    settings.kd = 0.1f;
+    settings.smoothing = 0.3f;
+    settings.maxIncrease = 0.02f;
+    settings.maxDecrease = 0.15f;
+    return settings;
+}
+
+DynamicResolution::DynamicResolution( const DynamicResolutionSettings& settings )
+: _settings( settings )
+, _scale( settings.maxScale )
+, _filteredSeconds( 0.0 )
+, _integral( 0.0 )
+, _previousError( 0.0 )
+, _measured( false ) {
+    assert( settings.targetSeconds > 0.0 );
+    assert( settings.minScale > 0.f && settings.minScale <= settings.maxScale );
+}
+
+float DynamicResolution::update( double frameSeconds ) {
+    // a single slow frame, a hitch rather than load, only moves the filtered time a bit:
+    // it counts as at most kOutlier times the filtered time. a real jump in load still
+    // gets through in a few frames, the clamp compounds
+    if ( _measured )
+    {
+        const double sample = std::min( frameSeconds, _filteredSeconds * kOutlier );
+        _filteredSeconds += ( sample - _filteredSeconds ) * _settings.smoothing;
+    }
+    else
+    {
+        _filteredSeconds = frameSeconds;
+    }
+
+    const double error = ( _settings.targetSeconds - _filteredSeconds ) / _settings.targetSeconds;
+    const double derivative = _measured ? error - _previousError : 0.0;
+    _previousError = error;
+    _measured = true;
+
+    // headroom built up while the load fell must not keep the scale growing once a
+    // frame runs over, so going over drops it at once
+    if ( error < 0.0 && _integral > 0.0 )
+    {
+        _integral = 0.0;
+    }
+
+    // no integral towards a bound the scale already sits on
+    const bool atMax = _scale >= _settings.maxScale && error > 0.0;
+    const bool atMin = _scale <= _settings.minScale && error < 0.0;
+    if ( !atMax && !atMin )
+    {
+        _integral = std::clamp( _integral + error, -kIntegralLimit, kIntegralLimit );
+    }
+
+    double step = _settings.kp * error + _settings.ki * _integral + _settings.kd * derivative;
+    step = std::clamp( step, -(double)_settings.maxDecrease, (double)_settings.maxIncrease );
+
+    const double area = (double)_scale * _scale * ( 1.0 + step );
+    const double minArea = (double)_settings.minScale * _settings.minScale;
+    const double maxArea = (double)_settings.maxScale * _settings.maxScale;
+    _scale = (float)sqrt( std::clamp( area, minArea, maxArea ) );
+    return _scale;
+}
+
+void DynamicResolution::reset( float scale ) {
+    _scale = std::clamp( scale, _settings.minScale, _settings.maxScale );
+    _filteredSeconds = 0.0;
+    _integral = 0.0;
+    _previousError = 0.0;
+    _measured = false;
+}
@@ -0,0 +1,61 @@
+/**
+  ******************************************************************************
+  * @file           : dynamic_resolution.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_DYNAMIC_RESOLUTION_HPP
+#define METAL_PLAYGROUND_DYNAMIC_RESOLUTION_HPP
+
+#include <cstdint>
+
+struct DynamicResolutionSettings
+{
+    double targetSeconds;       // frame time to hold, below the refresh interval for headroom
+    float minScale;             // render size bounds as a fraction of the output per axis
+    float maxScale;
+    float kp, ki, kd;           // gains on the relative error, (target - time) / target
+    float smoothing;            // weight of a new frame time in the filtered one, 1 takes it as is
+    float maxIncrease;          // largest change of the rendered area per update, as fractions
+    float maxDecrease;
+};
+
+// sensible gains for a gpu a couple of frames behind: cuts quickly when over budget,
+// grows back slowly so the scale does not hunt
+DynamicResolutionSettings makeDynamicResolutionSettings( double targetSeconds, float minScale, float maxScale );
+
+// a pid controller from frame times to a render scale. the cost of a frame follows the
+// number of pixels it shades, so the controller steps the rendered area, scale squared,
+// by a fraction of itself and returns its square root. the integral stops growing while
+// the scale sits on a bound, so it leaves the bound as soon as the load changes.
+class DynamicResolution {
+private:
+    DynamicResolutionSettings _settings;
+    float _scale;
+    double _filteredSeconds;
+    double _integral;
+    double _previousError;
+    bool _measured;
+
+public:
+    explicit DynamicResolution( const DynamicResolutionSettings& settings );
+
+    // feeds the gpu time of one frame, returns the scale for the next one
+    float update( double frameSeconds );
+
+    // starts over at scale, e.g. when the output size changes
+    void reset( float scale );
+
+    float scale() const { return _scale; }
+    double filteredSeconds() const { return _filteredSeconds; }
+    const DynamicResolutionSettings& settings() const { return _settings; }
+};
+
+
+#endif //METAL_PLAYGROUND_DYNAMIC_RESOLUTION_HPP
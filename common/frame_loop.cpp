@@ -0,0 +1,37 @@
+/**
+  ******************************************************************************
+  * @file           : frame_loop.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "frame_loop.hpp"
+
+#include <Block.h>
+
+// what @autoreleasepool compiles to
+extern "C" void* objc_autoreleasePoolPush( void );
+extern "C" void objc_autoreleasePoolPop( void* token );
+
+AutoreleaseScope::AutoreleaseScope()
+: _token(objc_autoreleasePoolPush()) {
+}
+
+AutoreleaseScope::~AutoreleaseScope() {
+    objc_autoreleasePoolPop( _token );
+}
+
+CompletionHandler::CompletionHandler( Function function, void* context )
+: _block(Block_copy( ^( MTL::CommandBuffer* cmd ) {
+    function( context, cmd );
+} )) {
+}
+
+CompletionHandler::~CompletionHandler() {
+    Block_release( _block );
+}
@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @file           : frame_loop.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_FRAME_LOOP_HPP
+#define METAL_PLAYGROUND_FRAME_LOOP_HPP
+
+#include <Metal/Metal.hpp>
+
+// pieces of a frame loop that stays off the heap once it runs. the samples' usual
+// frame allocates an NSAutoreleasePool object and copies a fresh block for every
+// completion handler; these keep both across frames. command buffers come from
+// commandBufferWithUnretainedReferences() on top, so metal does not build a list of
+// retained resources per frame; the renderer keeps its resources alive instead.
+
+// a pool scope without a pool object: push and pop on the thread's autorelease pages,
+// which the runtime keeps around between frames
+class AutoreleaseScope {
+private:
+    void* _token;
+
+public:
+    AutoreleaseScope();
+    ~AutoreleaseScope();
+
+    AutoreleaseScope( const AutoreleaseScope& ) = delete;
+    AutoreleaseScope& operator=( const AutoreleaseScope& ) = delete;
+};
+
+// a completed handler as function pointer and context. the block calling it is made
+// once; metal retains it for every command buffer it is added to instead of copying
+// a new one. the context is read when the command buffer completes, so it has to
+// stay put until then, e.g. one handler and context per frame in flight.
+class CompletionHandler {
+public:
+    using Function = void (*)( void* context, MTL::CommandBuffer* cmd );
+
+private:
+    MTL::CommandBufferHandler _block;
+
+public:
+    CompletionHandler( Function function, void* context );
+    ~CompletionHandler();
+
+    CompletionHandler( const CompletionHandler& ) = delete;
+    CompletionHandler& operator=( const CompletionHandler& ) = delete;
+
+    void addTo( MTL::CommandBuffer* cmd ) const { cmd->addCompletedHandler( _block ); }
+};
+
+
+#endif //METAL_PLAYGROUND_FRAME_LOOP_HPP
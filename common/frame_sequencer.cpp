@@ -0,0 +1,238 @@
+/**
+  ******************************************************************************
+  * @file           : frame_sequencer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "frame_sequencer.hpp"
+
+#include <cassert>
+#include <chrono>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static double secondsSince( std::chrono::steady_clock::time_point begin )
+{
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+}
+
+FrameSequencer::FrameSequencer( const FrameSequenceDesc& desc, uint32_t slotCount )
+: _desc(desc)
+, _path(desc.path)
+, _raw(nullptr)
+, _slots(slotCount, Slot{ SlotState::Free, 0, nullptr, 0 })
+, _framesBegun(0)
+, _framesEncoded(0)
+, _framesDone(0)
+, _encoded(slotCount)
+, _encodedHead(0)
+, _encodedCount(0)
+, _quit(false)
+, _failed(false)
+, _stats{} {
+    assert( slotCount > 0 );
+    _desc.path = _path.c_str();
+    // every file buffer there can be at once, one being encoded, a full queue and one
+    // being written, sized up front so later frames leave the heap alone
+    const size_t fileSize = _desc.format == FrameFileFormat::Png
+                          ? encodedPngSize( _desc.width, _desc.height )
+                          : (size_t)_desc.width * _desc.height * 4;
+    _spare.resize( slotCount + 2 );
+    for ( std::vector<uint8_t>& bytes : _spare )
+    {
+        bytes.reserve( fileSize );
+    }
+
+    if ( _desc.format == FrameFileFormat::Raw )
+    {
+        _raw = fopen( _desc.path, "wb" );
+        if ( !_raw )
+        {
+            __builtin_printf( "cannot open %s\n", _desc.path );
+            _failed = true;
+        }
+    }
+
+    _encoder = std::thread( &FrameSequencer::encoderMain, this );
+    _writer = std::thread( &FrameSequencer::writerMain, this );
+}
+
+FrameSequencer::~FrameSequencer() {
+    finish();
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _quit = true;
+    }
+    _slotReady.notify_all();
+    _encodedReady.notify_all();
+    _encoder.join();
+    _writer.join();
+
+    if ( _raw )
+    {
+        fclose( _raw );
+    }
+}
+
+uint32_t FrameSequencer::beginFrame() {
+    std::unique_lock<std::mutex> lock( _mutex );
+    const uint32_t slot = (uint32_t)( _framesBegun % _slots.size() );
+    Slot& s = _slots[ slot ];
+    if ( s.state != SlotState::Free )
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        _slotFree.wait( lock, [&s]() { return s.state == SlotState::Free; } );
+        _stats.stallSeconds += secondsSince( begin );
+    }
+    s.state = SlotState::Rendering;
+    s.frame = _framesBegun++;
+    return slot;
+}
+
+void FrameSequencer::endFrame( uint32_t slot, const void* pixels, size_t bytesPerRow ) {
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        Slot& s = _slots[ slot ];
+        assert( s.state == SlotState::Rendering );
+        s.pixels = static_cast<const uint8_t*>( pixels );
+        s.bytesPerRow = bytesPerRow;
+        s.state = SlotState::Ready;
+    }
+    _slotReady.notify_one();
+}
+
+bool FrameSequencer::finish() {
+    std::unique_lock<std::mutex> lock( _mutex );
+    _idle.wait( lock, [this]() { return _framesDone == _framesBegun; } );
+    if ( _raw )
+    {
+        _failed = fflush( _raw ) != 0 || _failed;
+    }
+    return !_failed;
+}
+
+FrameSequenceStats FrameSequencer::stats() {
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _stats;
+}
+
+void FrameSequencer::encoderMain() {
+    std::unique_lock<std::mutex> lock( _mutex );
+    for ( ;; )
+    {
+        // frames are encoded in order, whichever slot finishes first
+        Slot& s = _slots[ _framesEncoded % _slots.size() ];
+        _slotReady.wait( lock, [this, &s]() {
+            return _quit || ( s.state == SlotState::Ready && s.frame == _framesEncoded );
+        } );
+        if ( s.state != SlotState::Ready )
+        {
+            return;
+        }
+
+        Encoded e;
+        e.frame = s.frame;
+        if ( !_spare.empty() )
+        {
+            e.bytes = std::move( _spare.back() );
+            _spare.pop_back();
+        }
+        const uint8_t* pixels = s.pixels;
+        const size_t bytesPerRow = s.bytesPerRow;
+        lock.unlock();
+
+        const auto begin = std::chrono::steady_clock::now();
+        if ( _desc.format == FrameFileFormat::Png )
+        {
+            encodePng( pixels, _desc.width, _desc.height, bytesPerRow, _desc.layout, e.bytes );
+        }
+        else
+        {
+            encodeRaw( pixels, _desc.width, _desc.height, bytesPerRow, _desc.layout, e.bytes );
+        }
+        const double seconds = secondsSince( begin );
+
+        lock.lock();
+        s.state = SlotState::Free;
+        ++_framesEncoded;
+        _stats.encodeSeconds += seconds;
+        _slotFree.notify_all();
+
+        // a slow disk backs up into the slots and from there into the renderer
+        _encodedTaken.wait( lock, [this]() { return _encodedCount < _encoded.size(); } );
+        _encoded[ ( _encodedHead + _encodedCount++ ) % _encoded.size() ] = std::move( e );
+        _encodedReady.notify_one();
+    }
+}
+
+void FrameSequencer::writerMain() {
+    std::unique_lock<std::mutex> lock( _mutex );
+    for ( ;; )
+    {
+        _encodedReady.wait( lock, [this]() { return _quit || _encodedCount > 0; } );
+        if ( _encodedCount == 0 )
+        {
+            return;
+        }
+        Encoded e = std::move( _encoded[ _encodedHead ] );
+        _encodedHead = ( _encodedHead + 1 ) % _encoded.size();
+        --_encodedCount;
+        _encodedTaken.notify_one();
+        const bool failed = _failed;
+        lock.unlock();
+
+        const auto begin = std::chrono::steady_clock::now();
+        const bool ok = !failed && write( e );
+        const double seconds = secondsSince( begin );
+
+        lock.lock();
+        if ( ok )
+        {
+            ++_stats.framesWritten;
+            _stats.bytesWritten += e.bytes.size();
+        }
+        _failed = _failed || !ok;
+        _stats.writeSeconds += seconds;
+        _spare.push_back( std::move( e.bytes ) );
+        ++_framesDone;
+        _idle.notify_all();
+    }
+}
+
+bool FrameSequencer::write( const Encoded& e ) {
+    if ( _desc.format == FrameFileFormat::Raw )
+    {
+        return fwrite( e.bytes.data(), 1, e.bytes.size(), _raw ) == e.bytes.size();
+    }
+
+    char name[ 1024 ];
+    if ( snprintf( name, sizeof( name ), "%s_%05llu.png", _desc.path, (unsigned long long)e.frame ) >= (int)sizeof( name ) )
+    {
+        return false;
+    }
+    // posix files, fopen() allocates its FILE and buffer for every frame
+    const int fd = open( name, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if ( fd < 0 )
+    {
+        __builtin_printf( "cannot open %s\n", name );
+        return false;
+    }
+    size_t written = 0;
+    while ( written < e.bytes.size() )
+    {
+        const ssize_t n = ::write( fd, e.bytes.data() + written, e.bytes.size() - written );
+        if ( n <= 0 )
+        {
+            break;
+        }
+        written += (size_t)n;
+    }
+    return close( fd ) == 0 && written == e.bytes.size();
+}
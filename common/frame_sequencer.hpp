@@ -0,0 +1,136 @@
+/**
+  ******************************************************************************
+  * @file           : frame_sequencer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_FRAME_SEQUENCER_HPP
+#define METAL_PLAYGROUND_FRAME_SEQUENCER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "image_writer.hpp"
+
+enum class FrameFileFormat
+{
+    Png,        // one file per frame, <path>_00000.png
+    Raw         // every frame appended to <path>, see encodeRaw()
+};
+
+struct FrameSequenceDesc
+{
+    const char* path;
+    FrameFileFormat format;
+    uint32_t width;
+    uint32_t height;
+    PixelLayout layout;
+};
+
+struct FrameSequenceStats
+{
+    uint64_t framesWritten;
+    uint64_t bytesWritten;
+    double encodeSeconds;
+    double writeSeconds;
+    double stallSeconds;        // the renderer waiting for a free readback slot
+};
+
+// readback ring for headless rendering. the renderer takes a slot per frame, copies
+// the frame into memory it owns for that slot and hands the pixels over once they
+// are readable; an encoder thread turns them into file bytes in frame order and a
+// writer thread puts those on disk, so rendering, encoding and writing overlap.
+//
+// slot memory is only read between endFrame() and the next beginFrame() returning
+// the same slot. endFrame() may be called from any thread, e.g. a completion handler.
+class FrameSequencer {
+private:
+    enum class SlotState
+    {
+        Free,
+        Rendering,
+        Ready
+    };
+
+    struct Slot
+    {
+        SlotState state;
+        uint64_t frame;
+        const uint8_t* pixels;
+        size_t bytesPerRow;
+    };
+
+    struct Encoded
+    {
+        uint64_t frame;
+        std::vector<uint8_t> bytes;
+    };
+
+    FrameSequenceDesc _desc;
+    std::string _path;
+    FILE* _raw;
+
+    std::mutex _mutex;
+    std::condition_variable _slotFree;
+    std::condition_variable _slotReady;
+    std::condition_variable _encodedReady;
+    std::condition_variable _encodedTaken;
+    std::condition_variable _idle;
+
+    std::vector<Slot> _slots;
+    uint64_t _framesBegun;
+    uint64_t _framesEncoded;
+    uint64_t _framesDone;
+    // ring of encoded frames waiting for the writer
+    std::vector<Encoded> _encoded;
+    size_t _encodedHead;
+    size_t _encodedCount;
+    // file buffers go back here once written, the steady state allocates nothing
+    std::vector<std::vector<uint8_t>> _spare;
+    bool _quit;
+    bool _failed;
+
+    FrameSequenceStats _stats;
+
+    std::thread _encoder;
+    std::thread _writer;
+
+    void encoderMain();
+    void writerMain();
+    bool write( const Encoded& e );
+
+public:
+    // slotCount readback slots, 3 keeps one frame on the gpu, one encoding and one spare
+    FrameSequencer( const FrameSequenceDesc& desc, uint32_t slotCount = 3 );
+    ~FrameSequencer();
+
+    FrameSequencer( const FrameSequencer& ) = delete;
+    FrameSequencer& operator=( const FrameSequencer& ) = delete;
+
+    uint32_t slotCount() const { return (uint32_t)_slots.size(); }
+
+    // waits until the slot of the next frame has been encoded and returns it
+    uint32_t beginFrame();
+    // the slot's pixels are readable, width x height in the desc's layout
+    void endFrame( uint32_t slot, const void* pixels, size_t bytesPerRow );
+
+    // waits until every begun frame is on disk, false when a write failed
+    bool finish();
+
+    FrameSequenceStats stats();
+};
+
+
+#endif //METAL_PLAYGROUND_FRAME_SEQUENCER_HPP
@@ -0,0 +1,355 @@
+/**
+  ******************************************************************************
+  * @file           : heap_allocator.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "heap_allocator.hpp"
+#include "metal_storage.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+#include <utility>
+
+static constexpr uint64_t kGranularity = 256;
+static constexpr size_t kUseHeapBatch = 64;
+
+HeapAllocator::HeapAllocator( MTL::Device* device, MTL::StorageMode storageMode, uint64_t blockSize )
+: _device(device->retain())
+, _storageMode(storageMode)
+, _blockSize(blockSize)
+, _defragCount(0)
+, _completedDefrags(0)
+, _frameStats{} {
+}
+
+HeapAllocator::~HeapAllocator() {
+    for ( Retired& r : _retired )
+    {
+        r.resource->release();
+    }
+    for ( Slot& s : _slots )
+    {
+        if ( s.resource )
+        {
+            s.resource->release();
+        }
+        if ( s.textureDesc )
+        {
+            s.textureDesc->release();
+        }
+    }
+    for ( Block& b : _blocks )
+    {
+        if ( b.heap )
+        {
+            b.heap->release();
+        }
+    }
+    _device->release();
+}
+
+uint32_t HeapAllocator::newBlock( uint64_t size, bool dedicated ) {
+    MTL::HeapDescriptor* pHeapDesc = MTL::HeapDescriptor::alloc()->init();
+    pHeapDesc->setType( MTL::HeapTypePlacement );
+    pHeapDesc->setStorageMode( _storageMode );
+    pHeapDesc->setHazardTrackingMode( MTL::HazardTrackingModeTracked );
+    pHeapDesc->setSize( size );
+
+    MTL::Heap* heap = _device->newHeap( pHeapDesc );
+    pHeapDesc->release();
+    if ( !heap )
+    {
+        __builtin_printf( "failed to create a %llu byte heap\n", (unsigned long long)size );
+        return kInvalidBlock;
+    }
+
+    Block block = { heap, TlsfAllocator( heap->size(), kGranularity ), dedicated };
+    if ( !_freeBlocks.empty() )
+    {
+        const uint32_t index = _freeBlocks.back();
+        _freeBlocks.pop_back();
+        _blocks[ index ] = std::move( block );
+        return index;
+    }
+    _blocks.push_back( std::move( block ) );
+    return (uint32_t)( _blocks.size() - 1 );
+}
+
+void HeapAllocator::releaseBlock( uint32_t block ) {
+    Block& b = _blocks[ block ];
+    b.heap->release();
+    b.heap = nullptr;
+    _freeBlocks.push_back( block );
+}
+
+bool HeapAllocator::place( MTL::SizeAndAlign sa, uint32_t& outBlock, TlsfAllocation& outAllocation ) {
+    if ( sa.size + sa.align > _blockSize )
+    {
+        outBlock = newBlock( sa.size, true );
+        if ( outBlock == kInvalidBlock )
+        {
+            return false;
+        }
+        if ( !_blocks[ outBlock ].tlsf.allocate( sa.size, sa.align, outAllocation ) )
+        {
+            releaseBlock( outBlock );
+            return false;
+        }
+        return true;
+    }
+
+    for ( uint32_t i = 0; i < _blocks.size(); ++i )
+    {
+        Block& b = _blocks[ i ];
+        if ( b.heap && !b.dedicated && b.tlsf.allocate( sa.size, sa.align, outAllocation ) )
+        {
+            outBlock = i;
+            return true;
+        }
+    }
+
+    outBlock = newBlock( _blockSize, false );
+    return outBlock != kInvalidBlock && _blocks[ outBlock ].tlsf.allocate( sa.size, sa.align, outAllocation );
+}
+
+void HeapAllocator::unplace( uint32_t block, const TlsfAllocation& allocation ) {
+    Block& b = _blocks[ block ];
+    b.tlsf.free( allocation );
+    if ( b.dedicated && b.tlsf.empty() )
+    {
+        releaseBlock( block );
+    }
+}
+
+MTL::Resource* HeapAllocator::createResource( const Slot& slot, uint32_t block, const TlsfAllocation& allocation ) const {
+    MTL::Heap* heap = _blocks[ block ].heap;
+    if ( slot.textureDesc )
+    {
+        return heap->newTexture( slot.textureDesc, allocation.offset );
+    }
+    return heap->newBuffer( slot.length, resourceOptions( _storageMode ), allocation.offset );
+}
+
+HeapAllocator::Handle HeapAllocator::newSlot() {
+    if ( !_freeSlots.empty() )
+    {
+        Handle h = _freeSlots.back();
+        _freeSlots.pop_back();
+        return h;
+    }
+    _slots.push_back( {} );
+    return (Handle)( _slots.size() - 1 );
+}
+
+HeapAllocator::Handle HeapAllocator::newBuffer( size_t length ) {
+    collectRetired();
+
+    Slot slot = {};
+    slot.length = length;
+
+    MTL::SizeAndAlign sa = _device->heapBufferSizeAndAlign( length, resourceOptions( _storageMode ) );
+    if ( !place( sa, slot.block, slot.allocation ) )
+    {
+        return kInvalidHandle;
+    }
+    slot.resource = createResource( slot, slot.block, slot.allocation );
+    if ( !slot.resource )
+    {
+        unplace( slot.block, slot.allocation );
+        return kInvalidHandle;
+    }
+
+    Handle h = newSlot();
+    _slots[ h ] = slot;
+    ++_frameStats.allocations;
+    return h;
+}
+
+HeapAllocator::Handle HeapAllocator::newTexture( const MTL::TextureDescriptor* desc ) {
+    collectRetired();
+
+    Slot slot = {};
+    slot.textureDesc = desc->copy();
+    slot.textureDesc->setStorageMode( _storageMode );
+
+    MTL::SizeAndAlign sa = _device->heapTextureSizeAndAlign( slot.textureDesc );
+    if ( !place( sa, slot.block, slot.allocation ) )
+    {
+        slot.textureDesc->release();
+        return kInvalidHandle;
+    }
+    slot.resource = createResource( slot, slot.block, slot.allocation );
+    if ( !slot.resource )
+    {
+        unplace( slot.block, slot.allocation );
+        slot.textureDesc->release();
+        return kInvalidHandle;
+    }
+
+    Handle h = newSlot();
+    _slots[ h ] = slot;
+    ++_frameStats.allocations;
+    return h;
+}
+
+void HeapAllocator::release( Handle handle ) {
+    assert( handle < _slots.size() && _slots[ handle ].resource );
+    Slot& s = _slots[ handle ];
+
+    s.resource->release();
+    if ( s.textureDesc )
+    {
+        s.textureDesc->release();
+    }
+    unplace( s.block, s.allocation );
+
+    s = {};
+    _freeSlots.push_back( handle );
+    ++_frameStats.releases;
+}
+
+void HeapAllocator::collectRetired() {
+    const uint64_t completed = _completedDefrags.load( std::memory_order_acquire );
+    for ( size_t i = 0; i < _retired.size(); )
+    {
+        Retired& r = _retired[ i ];
+        if ( r.defragId > completed )
+        {
+            ++i;
+            continue;
+        }
+        r.resource->release();
+        _blocks[ r.block ].tlsf.free( r.allocation );
+        r = _retired.back();
+        _retired.pop_back();
+    }
+}
+
+size_t HeapAllocator::defragment( MTL::CommandBuffer* cmd, size_t maxMoves ) {
+    collectRetired();
+
+    // heap block + allocator block -> slot owning it
+    std::unordered_map<uint64_t, Handle> owners;
+    for ( Handle h = 0; h < _slots.size(); ++h )
+    {
+        if ( _slots[ h ].resource )
+        {
+            owners[ ( (uint64_t)_slots[ h ].block << 32 ) | _slots[ h ].allocation.block ] = h;
+        }
+    }
+
+    const uint64_t defragId = _defragCount + 1;
+    MTL::BlitCommandEncoder* blit = nullptr;
+    std::vector<TlsfAllocator::Move> moves;
+    size_t moved = 0;
+
+    for ( uint32_t i = 0; i < _blocks.size() && moved < maxMoves; ++i )
+    {
+        if ( !_blocks[ i ].heap || _blocks[ i ].dedicated )
+        {
+            continue;
+        }
+
+        moves.clear();
+        moved += _blocks[ i ].tlsf.defragment( maxMoves - moved, moves );
+
+        for ( const TlsfAllocator::Move& m : moves )
+        {
+            Slot& s = _slots[ owners.at( ( (uint64_t)i << 32 ) | m.from.block ) ];
+            MTL::Resource* copy = createResource( s, i, m.to );
+            if ( !copy )
+            {
+                // the resource stays where it is
+                _blocks[ i ].tlsf.free( m.to );
+                continue;
+            }
+
+            if ( !blit )
+            {
+                blit = cmd->blitCommandEncoder();
+            }
+            if ( s.textureDesc )
+            {
+                blit->copyFromTexture( (MTL::Texture*)s.resource, (MTL::Texture*)copy );
+            }
+            else
+            {
+                blit->copyFromBuffer( (MTL::Buffer*)s.resource, 0, (MTL::Buffer*)copy, 0, s.length );
+            }
+
+            _retired.push_back( { s.resource, i, m.from, defragId } );
+            s.resource = copy;
+            s.allocation = m.to;
+
+            ++_frameStats.moves;
+            _frameStats.movedBytes += m.to.size;
+        }
+    }
+
+    if ( blit )
+    {
+        blit->endEncoding();
+
+        // completion handlers of one queue run in commit order, so a larger id
+        // also covers the defragmentations before it
+        _defragCount = defragId;
+        cmd->addCompletedHandler( ^void( MTL::CommandBuffer* pCmd ) {
+            this->_completedDefrags.store( defragId, std::memory_order_release );
+        } );
+    }
+    return moved;
+}
+
+void HeapAllocator::useHeaps( MTL::RenderCommandEncoder* enc, MTL::RenderStages stages ) const {
+    MTL::Heap* heaps[ kUseHeapBatch ];
+    NS::UInteger count = 0;
+    for ( const Block& b : _blocks )
+    {
+        if ( b.heap )
+        {
+            heaps[ count++ ] = b.heap;
+        }
+        if ( count == kUseHeapBatch )
+        {
+            enc->useHeaps( heaps, count, stages );
+            count = 0;
+        }
+    }
+    if ( count > 0 )
+    {
+        enc->useHeaps( heaps, count, stages );
+    }
+}
+
+HeapAllocatorStats HeapAllocator::stats() const {
+    HeapAllocatorStats s = _frameStats;
+    uint64_t freeBytes = 0;
+    for ( const Block& b : _blocks )
+    {
+        if ( !b.heap )
+        {
+            continue;
+        }
+        TlsfStats t = b.tlsf.stats();
+        ++s.heapCount;
+        s.reservedBytes += t.capacity;
+        s.usedBytes += t.usedBytes;
+        s.largestFreeBytes = std::max( s.largestFreeBytes, t.largestFreeBytes );
+        freeBytes += t.freeBytes;
+    }
+    s.allocationCount = _slots.size() - _freeSlots.size();
+    s.fragmentation = freeBytes ? 1.f - (float)s.largestFreeBytes / (float)freeBytes : 0.f;
+    return s;
+}
+
+void HeapAllocator::resetFrameStats() {
+    _frameStats = {};
+}
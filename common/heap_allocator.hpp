@@ -0,0 +1,137 @@
+/**
+  ******************************************************************************
+  * @file           : heap_allocator.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_HEAP_ALLOCATOR_HPP
+#define METAL_PLAYGROUND_HEAP_ALLOCATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Metal/Metal.hpp>
+
+#include "tlsf_allocator.hpp"
+
+struct HeapAllocatorStats
+{
+    size_t heapCount;
+    uint64_t reservedBytes;
+    uint64_t usedBytes;
+    uint64_t largestFreeBytes;
+    size_t allocationCount;
+    float fragmentation;
+
+    // since the last resetFrameStats()
+    size_t allocations;
+    size_t releases;
+    size_t moves;
+    uint64_t movedBytes;
+};
+
+// places buffers and textures into large placement heaps instead of giving every
+// resource its own device allocation. the offsets inside each heap come from a
+// TlsfAllocator; resources that do not fit a block get a dedicated heap.
+//
+// resources are referred to by handle, defragment() may move them to new objects.
+// look buffer() / texture() up when encoding instead of keeping the pointers around.
+// when the device can not make a heap or a resource, newBuffer() / newTexture()
+// return kInvalidHandle.
+class HeapAllocator {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle kInvalidHandle = ~0u;
+
+private:
+    static constexpr uint32_t kInvalidBlock = ~0u;
+
+    struct Block
+    {
+        MTL::Heap* heap;
+        TlsfAllocator tlsf;
+        bool dedicated;
+    };
+
+    struct Slot
+    {
+        MTL::Resource* resource;
+        MTL::TextureDescriptor* textureDesc;
+        size_t length;
+        uint32_t block;
+        TlsfAllocation allocation;
+    };
+
+    // old copies of moved resources, freed once the copying command buffer is done
+    struct Retired
+    {
+        MTL::Resource* resource;
+        uint32_t block;
+        TlsfAllocation allocation;
+        uint64_t defragId;
+    };
+
+    MTL::Device* _device;
+    MTL::StorageMode _storageMode;
+    uint64_t _blockSize;
+
+    // blocks with a null heap are dedicated ones already given back, reused by newBlock()
+    std::vector<Block> _blocks;
+    std::vector<uint32_t> _freeBlocks;
+    std::vector<Slot> _slots;
+    std::vector<Handle> _freeSlots;
+    std::vector<Retired> _retired;
+
+    uint64_t _defragCount;
+    std::atomic<uint64_t> _completedDefrags;
+    HeapAllocatorStats _frameStats;
+
+    // kInvalidBlock when the device has no heap of that size to give
+    uint32_t newBlock( uint64_t size, bool dedicated );
+    void releaseBlock( uint32_t block );
+    bool place( MTL::SizeAndAlign sa, uint32_t& outBlock, TlsfAllocation& outAllocation );
+    // frees an allocation, and the block with it when it was a dedicated one
+    void unplace( uint32_t block, const TlsfAllocation& allocation );
+    MTL::Resource* createResource( const Slot& slot, uint32_t block, const TlsfAllocation& allocation ) const;
+    Handle newSlot();
+    void collectRetired();
+
+public:
+    HeapAllocator( MTL::Device* device, MTL::StorageMode storageMode, uint64_t blockSize = 64ull << 20 );
+    ~HeapAllocator();
+
+    HeapAllocator( const HeapAllocator& ) = delete;
+    HeapAllocator& operator=( const HeapAllocator& ) = delete;
+
+    Handle newBuffer( size_t length );
+    Handle newTexture( const MTL::TextureDescriptor* desc );
+
+    // the caller makes sure the gpu is done with the resource
+    void release( Handle handle );
+
+    MTL::Buffer* buffer( Handle handle ) const { return (MTL::Buffer*)_slots[ handle ].resource; }
+    MTL::Texture* texture( Handle handle ) const { return (MTL::Texture*)_slots[ handle ].resource; }
+
+    // moves up to maxMoves resources into lower holes of their heaps, copying the
+    // contents with blits encoded into cmd. for cpu visible heaps, do not write the
+    // moved resources before cmd has completed.
+    size_t defragment( MTL::CommandBuffer* cmd, size_t maxMoves );
+
+    // makes every heap resident for enc in one call, resources reached through
+    // argument buffers then need no useResource of their own
+    void useHeaps( MTL::RenderCommandEncoder* enc, MTL::RenderStages stages ) const;
+
+    HeapAllocatorStats stats() const;
+    void resetFrameStats();
+};
+
+
+#endif //METAL_PLAYGROUND_HEAP_ALLOCATOR_HPP
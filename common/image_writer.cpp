@@ -0,0 +1,268 @@
+/**
+  ******************************************************************************
+  * @file           : image_writer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "image_writer.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+static constexpr size_t kMaxStoredBlock = 65535;
+static constexpr uint32_t kAdlerModulo = 65521;
+// largest run of bytes before the adler sums can overflow 32 bits
+static constexpr size_t kAdlerRun = 5552;
+static constexpr size_t kSwizzlePixels = 256;
+
+// slicing by 4, table[ 0 ] is the usual byte wise crc32 table
+static const uint32_t ( &crcTables() )[ 4 ][ 256 ]
+{
+    static uint32_t tables[ 4 ][ 256 ];
+    static const bool built = []() {
+        for ( uint32_t i = 0; i < 256; ++i )
+        {
+            uint32_t c = i;
+            for ( int k = 0; k < 8; ++k )
+            {
+                c = ( c & 1 ) ? 0xEDB88320u ^ ( c >> 1 ) : c >> 1;
+            }
+            tables[ 0 ][ i ] = c;
+        }
+        for ( uint32_t i = 0; i < 256; ++i )
+        {
+            for ( int t = 1; t < 4; ++t )
+            {
+                const uint32_t prev = tables[ t - 1 ][ i ];
+                tables[ t ][ i ] = tables[ 0 ][ prev & 0xFF ] ^ ( prev >> 8 );
+            }
+        }
+        return true;
+    }();
+    (void)built;
+    return tables;
+}
+
+static uint32_t crc32( const uint8_t* data, size_t size )
+{
+    const uint32_t ( &t )[ 4 ][ 256 ] = crcTables();
+    uint32_t c = 0xFFFFFFFFu;
+    for ( ; size >= 4; size -= 4, data += 4 )
+    {
+        c ^= (uint32_t)data[ 0 ] | ( (uint32_t)data[ 1 ] << 8 ) | ( (uint32_t)data[ 2 ] << 16 ) | ( (uint32_t)data[ 3 ] << 24 );
+        c = t[ 3 ][ c & 0xFF ] ^ t[ 2 ][ ( c >> 8 ) & 0xFF ] ^ t[ 1 ][ ( c >> 16 ) & 0xFF ] ^ t[ 0 ][ c >> 24 ];
+    }
+    for ( ; size > 0; --size, ++data )
+    {
+        c = t[ 0 ][ ( c ^ *data ) & 0xFF ] ^ ( c >> 8 );
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+static void putBigEndian( uint8_t* p, uint32_t v )
+{
+    p[ 0 ] = (uint8_t)( v >> 24 );
+    p[ 1 ] = (uint8_t)( v >> 16 );
+    p[ 2 ] = (uint8_t)( v >> 8 );
+    p[ 3 ] = (uint8_t)v;
+}
+
+// copies one row as rgba, swizzling through a small buffer when it is bgra
+template <typename Put>
+static void forEachRgbaSpan( const uint8_t* row, uint32_t width, PixelLayout layout, Put&& put )
+{
+    if ( layout == PixelLayout::RGBA8 )
+    {
+        put( row, (size_t)width * 4 );
+        return;
+    }
+    uint8_t rgba[ kSwizzlePixels * 4 ];
+    for ( uint32_t x = 0; x < width; x += kSwizzlePixels )
+    {
+        const uint32_t n = width - x < kSwizzlePixels ? width - x : (uint32_t)kSwizzlePixels;
+        const uint8_t* src = row + (size_t)x * 4;
+        for ( uint32_t i = 0; i < n; ++i )
+        {
+            rgba[ i * 4 + 0 ] = src[ i * 4 + 2 ];
+            rgba[ i * 4 + 1 ] = src[ i * 4 + 1 ];
+            rgba[ i * 4 + 2 ] = src[ i * 4 + 0 ];
+            rgba[ i * 4 + 3 ] = src[ i * 4 + 3 ];
+        }
+        put( rgba, (size_t)n * 4 );
+    }
+}
+
+// the zlib stream inside IDAT: a header, stored blocks of at most 64k and the adler32
+// of the filtered rows. the size is known up front, so out is written in place.
+class StoredDeflate {
+private:
+    uint8_t* _out;
+    size_t _blockLeft;
+    size_t _totalLeft;
+    bool _empty;
+    uint32_t _a;
+    uint32_t _b;
+
+    void adler( const uint8_t* data, size_t size ) {
+        while ( size > 0 )
+        {
+            const size_t run = size < kAdlerRun ? size : kAdlerRun;
+            for ( size_t i = 0; i < run; ++i )
+            {
+                _a += data[ i ];
+                _b += _a;
+            }
+            _a %= kAdlerModulo;
+            _b %= kAdlerModulo;
+            data += run;
+            size -= run;
+        }
+    }
+
+public:
+    static size_t encodedSize( size_t rawSize ) {
+        const size_t blocks = rawSize == 0 ? 1 : ( rawSize + kMaxStoredBlock - 1 ) / kMaxStoredBlock;
+        return 2 + blocks * 5 + rawSize + 4;
+    }
+
+    StoredDeflate( uint8_t* out, size_t rawSize )
+    : _out(out)
+    , _blockLeft(0)
+    , _totalLeft(rawSize)
+    , _empty(rawSize == 0)
+    , _a(1)
+    , _b(0) {
+        // deflate, 32k window, no dictionary, fastest
+        *_out++ = 0x78;
+        *_out++ = 0x01;
+    }
+
+    void put( const uint8_t* data, size_t size ) {
+        adler( data, size );
+        while ( size > 0 )
+        {
+            if ( _blockLeft == 0 )
+            {
+                _blockLeft = _totalLeft < kMaxStoredBlock ? _totalLeft : kMaxStoredBlock;
+                const uint16_t len = (uint16_t)_blockLeft;
+                *_out++ = _totalLeft == _blockLeft ? 1 : 0;
+                *_out++ = (uint8_t)len;
+                *_out++ = (uint8_t)( len >> 8 );
+                *_out++ = (uint8_t)~len;
+                *_out++ = (uint8_t)( (uint16_t)~len >> 8 );
+            }
+            const size_t n = size < _blockLeft ? size : _blockLeft;
+            memcpy( _out, data, n );
+            _out += n;
+            data += n;
+            size -= n;
+            _blockLeft -= n;
+            _totalLeft -= n;
+        }
+    }
+
+    uint8_t* finish() {
+        if ( _empty )
+        {
+            // a single empty final block
+            *_out++ = 1;
+            *_out++ = 0;
+            *_out++ = 0;
+            *_out++ = 0xFF;
+            *_out++ = 0xFF;
+        }
+        putBigEndian( _out, ( _b << 16 ) | _a );
+        return _out + 4;
+    }
+};
+
+static uint8_t* beginChunk( uint8_t* p, const char* type, uint32_t size )
+{
+    putBigEndian( p, size );
+    memcpy( p + 4, type, 4 );
+    return p + 8;
+}
+
+// the crc covers the type and the data, begin points at the type
+static uint8_t* endChunk( uint8_t* begin, uint8_t* end )
+{
+    putBigEndian( end, crc32( begin, end - begin ) );
+    return end + 4;
+}
+
+static const uint8_t kSignature[ 8 ] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+size_t encodedPngSize( uint32_t width, uint32_t height ) {
+    const size_t rawSize = (size_t)height * ( 1 + (size_t)width * 4 );
+    return sizeof( kSignature ) + ( 12 + 13 ) + ( 12 + StoredDeflate::encodedSize( rawSize ) ) + 12;
+}
+
+void encodePng( const uint8_t* pixels, uint32_t width, uint32_t height, size_t bytesPerRow, PixelLayout layout, std::vector<uint8_t>& out ) {
+    const size_t rawSize = (size_t)height * ( 1 + (size_t)width * 4 );
+    const size_t idatSize = StoredDeflate::encodedSize( rawSize );
+    out.resize( encodedPngSize( width, height ) );
+
+    uint8_t* p = out.data();
+    memcpy( p, kSignature, sizeof( kSignature ) );
+    p += sizeof( kSignature );
+
+    uint8_t* chunk = p + 4;
+    p = beginChunk( p, "IHDR", 13 );
+    putBigEndian( p, width );
+    putBigEndian( p + 4, height );
+    p[ 8 ] = 8;     // bits per channel
+    p[ 9 ] = 6;     // rgba
+    p[ 10 ] = 0;    // deflate
+    p[ 11 ] = 0;    // adaptive filtering, every row uses filter 0
+    p[ 12 ] = 0;    // not interlaced
+    p = endChunk( chunk, p + 13 );
+
+    chunk = p + 4;
+    p = beginChunk( p, "IDAT", (uint32_t)idatSize );
+    StoredDeflate deflate( p, rawSize );
+    for ( uint32_t y = 0; y < height; ++y )
+    {
+        static const uint8_t kFilterNone = 0;
+        deflate.put( &kFilterNone, 1 );
+        forEachRgbaSpan( pixels + y * bytesPerRow, width, layout, [&deflate]( const uint8_t* data, size_t size ) {
+            deflate.put( data, size );
+        } );
+    }
+    p = endChunk( chunk, deflate.finish() );
+
+    chunk = p + 4;
+    p = beginChunk( p, "IEND", 0 );
+    endChunk( chunk, p );
+}
+
+void encodeRaw( const uint8_t* pixels, uint32_t width, uint32_t height, size_t bytesPerRow, PixelLayout layout, std::vector<uint8_t>& out ) {
+    out.resize( (size_t)width * height * 4 );
+
+    uint8_t* p = out.data();
+    for ( uint32_t y = 0; y < height; ++y )
+    {
+        forEachRgbaSpan( pixels + y * bytesPerRow, width, layout, [&p]( const uint8_t* data, size_t size ) {
+            memcpy( p, data, size );
+            p += size;
+        } );
+    }
+}
+
+bool writePng( const char* path, const uint8_t* pixels, uint32_t width, uint32_t height, size_t bytesPerRow, PixelLayout layout ) {
+    std::vector<uint8_t> png;
+    encodePng( pixels, width, height, bytesPerRow, layout, png );
+
+    FILE* f = fopen( path, "wb" );
+    if ( !f )
+    {
+        return false;
+    }
+    const bool ok = fwrite( png.data(), 1, png.size(), f ) == png.size();
+    return fclose( f ) == 0 && ok;
+}
@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file           : image_writer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_IMAGE_WRITER_HPP
+#define METAL_PLAYGROUND_IMAGE_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// byte order of the 8 bit pixels handed in, views are usually bgra
+enum class PixelLayout
+{
+    RGBA8,
+    BGRA8
+};
+
+// png, rgba8 without compression: the deflate stream is made of stored blocks, so
+// encoding is a copy plus the checksums and any viewer still opens the file.
+// out is overwritten, its capacity is reused.
+void encodePng( const uint8_t* pixels, uint32_t width, uint32_t height, size_t bytesPerRow, PixelLayout layout, std::vector<uint8_t>& out );
+// the file size, the same for every image of that size
+size_t encodedPngSize( uint32_t width, uint32_t height );
+
+// tightly packed rgba8 rows, top row first. frames appended back to back make a
+// raw video, e.g. ffmpeg -f rawvideo -pix_fmt rgba -s WxH -i frames.rgba
+void encodeRaw( const uint8_t* pixels, uint32_t width, uint32_t height, size_t bytesPerRow, PixelLayout layout, std::vector<uint8_t>& out );
+
+bool writePng( const char* path, const uint8_t* pixels, uint32_t width, uint32_t height, size_t bytesPerRow, PixelLayout layout );
+
+
+#endif //METAL_PLAYGROUND_IMAGE_WRITER_HPP
@@ -0,0 +1,116 @@
+/**
+  ******************************************************************************
+  * @file           : job_system.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "job_system.hpp"
+
+#include <algorithm>
+
+JobSystem::JobSystem(size_t threadCount)
+: _generation(0)
+, _busy(0)
+, _quit(false)
+, _fn(nullptr)
+, _count(0)
+, _grain(1)
+, _next(0) {
+    if ( threadCount == 0 )
+    {
+        threadCount = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+
+    for ( size_t i = 1; i < threadCount; ++i )
+    {
+        _workers.emplace_back( &JobSystem::workerMain, this );
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _quit = true;
+    }
+    _wake.notify_all();
+
+    for ( std::thread& worker : _workers )
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, RangeFn fn) {
+    if ( count == 0 )
+    {
+        return;
+    }
+    grain = std::max<size_t>( grain, 1 );
+
+    if ( _workers.empty() || count <= grain )
+    {
+        fn( 0, count );
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit( _submitMutex );
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _fn = &fn;
+        _count = count;
+        _grain = grain;
+        _next.store( 0, std::memory_order_relaxed );
+        _busy = _workers.size();
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    runChunks();
+
+    // every worker has to check in before fn goes out of scope
+    std::unique_lock<std::mutex> lock( _mutex );
+    _done.wait( lock, [this]{ return _busy == 0; } );
+    _fn = nullptr;
+}
+
+void JobSystem::workerMain() {
+    uint64_t seen = 0;
+    for ( ;; )
+    {
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+            _wake.wait( lock, [&]{ return _quit || _generation != seen; } );
+            if ( _quit )
+            {
+                return;
+            }
+            seen = _generation;
+        }
+
+        runChunks();
+
+        std::lock_guard<std::mutex> lock( _mutex );
+        if ( --_busy == 0 )
+        {
+            _done.notify_one();
+        }
+    }
+}
+
+void JobSystem::runChunks() {
+    for ( ;; )
+    {
+        size_t begin = _next.fetch_add( _grain, std::memory_order_relaxed );
+        if ( begin >= _count )
+        {
+            return;
+        }
+        (*_fn)( begin, std::min( begin + _grain, _count ) );
+    }
+}
@@ -0,0 +1,88 @@
+/**
+  ******************************************************************************
+  * @file           : job_system.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_JOB_SYSTEM_HPP
+#define METAL_PLAYGROUND_JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// fixed pool of worker threads for data parallel loops.
+// the calling thread takes part in the work, so a pool of N threads
+// runs N + 1 chunks at once.
+class JobSystem {
+public:
+    // the loop body as a function pointer and the callable it is called on. it only
+    // refers to the callable, so a loop never allocates the way a std::function holding
+    // a lambda's captures would. the callable has to outlive the parallelFor() call,
+    // which a lambda written in the call does. a RangeFn can not be copied, so it is
+    // only ever made right in the call and can not be kept past it.
+    class RangeFn {
+    private:
+        void (*_call)(const void* fn, size_t begin, size_t end);
+        const void* _fn;
+
+    public:
+        template<typename _Fn, typename = typename std::enable_if<!std::is_same<typename std::decay<_Fn>::type, RangeFn>::value>::type>
+        RangeFn(const _Fn& fn)
+        : _call([](const void* f, size_t begin, size_t end) { (*static_cast<const _Fn*>(f))(begin, end); })
+        , _fn(&fn) {
+        }
+
+        RangeFn(const RangeFn&) = delete;
+        RangeFn& operator=(const RangeFn&) = delete;
+
+        void operator()(size_t begin, size_t end) const { _call(_fn, begin, end); }
+    };
+
+private:
+    std::vector<std::thread> _workers;
+
+    std::mutex _submitMutex;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    uint64_t _generation;
+    size_t _busy;
+    bool _quit;
+
+    const RangeFn* _fn;
+    size_t _count;
+    size_t _grain;
+    std::atomic<size_t> _next;
+
+    void workerMain();
+    void runChunks();
+
+public:
+    // threadCount includes the calling thread, 0 uses hardware_concurrency()
+    explicit JobSystem(size_t threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    size_t threadCount() const { return _workers.size() + 1; }
+
+    // calls fn on [begin, end) chunks of at most grain items covering [0, count)
+    // and returns when all of them are done
+    void parallelFor(size_t count, size_t grain, RangeFn fn);
+};
+
+
+#endif //METAL_PLAYGROUND_JOB_SYSTEM_HPP
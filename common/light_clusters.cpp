@@ -0,0 +1,344 @@
+/**
+  ******************************************************************************
+  * @file           : light_clusters.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "light_clusters.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+static constexpr uint32_t kMaxTilesX = 64;
+static constexpr float kOutside = 1e30f;    // bounds of the padding lanes, no light reaches them
+
+// 4 tiles at once, the width of sse and neon
+static constexpr int kLanes = 4;
+typedef float Float4 __attribute__(( vector_size( 16 ) ));
+typedef int32_t Int4 __attribute__(( vector_size( 16 ) ));
+
+static Float4 splat( float v )
+{
+    return Float4{ v, v, v, v };
+}
+
+static Float4 load4( const float* p )
+{
+    Float4 v;
+    memcpy( &v, p, sizeof( v ) );
+    return v;
+}
+
+static Float4 max4( Float4 a, Float4 b )
+{
+    return a > b ? a : b;
+}
+
+static bool anyLane( Int4 mask )
+{
+    return ( mask[ 0 ] | mask[ 1 ] | mask[ 2 ] | mask[ 3 ] ) != 0;
+}
+
+// the same formulas as the msl below, in the same order, so both sides round alike
+static float sliceDepth( const shader_types::ClusterGrid& grid, uint32_t k )
+{
+    return exp2f( ( (float)k - grid.sliceBias ) / grid.sliceScale );
+}
+
+static float tileNdc( uint32_t tile, uint32_t tiles )
+{
+    return -1.f + 2.f * (float)tile / (float)tiles;
+}
+
+// the cone against the cluster's bounding sphere, true when they can not touch
+static bool coneCulled( const shader_types::ClusterLight& l, const float center[ 3 ], float radius )
+{
+    const float v[ 3 ] = { center[ 0 ] - l.position.x, center[ 1 ] - l.position.y, center[ 2 ] - l.position.z };
+    const float lenSq = v[ 0 ] * v[ 0 ] + v[ 1 ] * v[ 1 ] + v[ 2 ] * v[ 2 ];
+    const float along = v[ 0 ] * l.direction.x + v[ 1 ] * l.direction.y + v[ 2 ] * l.direction.z;
+    const float sinOuter = sqrtf( std::max( 1.f - l.spotCosOuter * l.spotCosOuter, 0.f ) );
+    const float closest = l.spotCosOuter * sqrtf( std::max( lenSq - along * along, 0.f ) ) - along * sinOuter;
+    return closest > radius || along > radius + l.range || along < -radius;
+}
+
+shader_types::ClusterGrid makeClusterGrid( uint32_t tilesX, uint32_t tilesY, uint32_t slices, uint32_t maxLightsPerCluster,
+                                           float fovYRadians, float aspect, float nearZ, float farZ,
+                                           uint32_t viewportWidth, uint32_t viewportHeight ) {
+    shader_types::ClusterGrid grid = {};
+    grid.tilesX = tilesX;
+    grid.tilesY = tilesY;
+    grid.slices = slices;
+    grid.maxLightsPerCluster = maxLightsPerCluster;
+    grid.nearZ = nearZ;
+    grid.farZ = farZ;
+    grid.sliceScale = (float)slices / log2f( farZ / nearZ );
+    grid.sliceBias = -(float)slices * log2f( nearZ ) / log2f( farZ / nearZ );
+    grid.tanHalfFovY = tanf( fovYRadians * 0.5f );
+    grid.tanHalfFovX = grid.tanHalfFovY * aspect;
+    grid.pixelsToTiles = { (float)tilesX / (float)viewportWidth, (float)tilesY / (float)viewportHeight };
+    grid.lightCount = 0;
+    return grid;
+}
+
+LightClusters::LightClusters( JobSystem& jobs, const shader_types::ClusterGrid& grid )
+: _jobs(jobs)
+, _grid(grid)
+, _vectorsX(( grid.tilesX + kLanes - 1 ) / kLanes)
+, _stats{} {
+    assert( grid.tilesX <= kMaxTilesX );
+    assert( grid.maxLightsPerCluster > 0 );
+
+    const uint32_t paddedX = _vectorsX * kLanes;
+    _minX.assign( grid.slices * paddedX, kOutside );
+    _maxX.assign( grid.slices * paddedX, -kOutside );
+    _minY.resize( grid.slices * grid.tilesY );
+    _maxY.resize( grid.slices * grid.tilesY );
+    _sliceDepth.resize( grid.slices + 1 );
+
+    for ( uint32_t k = 0; k <= grid.slices; ++k )
+    {
+        _sliceDepth[ k ] = sliceDepth( grid, k );
+    }
+
+    // a tile's frustum widens with depth, its box spans the near and the far end
+    for ( uint32_t s = 0; s < grid.slices; ++s )
+    {
+        const float dn = _sliceDepth[ s ];
+        const float df = _sliceDepth[ s + 1 ];
+        for ( uint32_t x = 0; x < grid.tilesX; ++x )
+        {
+            const float left = tileNdc( x, grid.tilesX ) * grid.tanHalfFovX;
+            const float right = tileNdc( x + 1, grid.tilesX ) * grid.tanHalfFovX;
+            _minX[ s * paddedX + x ] = std::min( left * dn, left * df );
+            _maxX[ s * paddedX + x ] = std::max( right * dn, right * df );
+        }
+        for ( uint32_t y = 0; y < grid.tilesY; ++y )
+        {
+            // tile rows run down the screen, ndc y up
+            const float top = -tileNdc( y, grid.tilesY ) * grid.tanHalfFovY;
+            const float bottom = -tileNdc( y + 1, grid.tilesY ) * grid.tanHalfFovY;
+            _minY[ s * grid.tilesY + y ] = std::min( bottom * dn, bottom * df );
+            _maxY[ s * grid.tilesY + y ] = std::max( top * dn, top * df );
+        }
+    }
+
+    const size_t clusters = (size_t)grid.tilesX * grid.tilesY * grid.slices;
+    _counts.resize( clusters );
+    _indices.resize( clusters * grid.maxLightsPerCluster );
+    _sliceStats.resize( grid.slices );
+}
+
+void LightClusters::binSlice( uint32_t slice, const shader_types::ClusterLight* lights, size_t count ) {
+    const uint32_t tilesX = _grid.tilesX;
+    const uint32_t tilesY = _grid.tilesY;
+    const uint32_t maxLights = _grid.maxLightsPerCluster;
+    const uint32_t first = clusterIndex( 0, 0, slice );
+    uint32_t* counts = &_counts[ first ];
+    uint16_t* indices = &_indices[ (size_t)first * maxLights ];
+    std::fill( counts, counts + tilesX * tilesY, 0u );
+
+    const float dn = _sliceDepth[ slice ];
+    const float df = _sliceDepth[ slice + 1 ];
+    const float* minX = &_minX[ slice * _vectorsX * kLanes ];
+    const float* maxX = &_maxX[ slice * _vectorsX * kLanes ];
+    const float* minY = &_minY[ slice * tilesY ];
+    const float* maxY = &_maxY[ slice * tilesY ];
+
+    Float4 dx2[ kMaxTilesX / kLanes ];
+    for ( size_t i = 0; i < count; ++i )
+    {
+        const shader_types::ClusterLight& l = lights[ i ];
+        const float depth = -l.position.z;
+        const float dz = std::max( std::max( dn - depth, depth - df ), 0.f );
+        const float remZ = l.range * l.range - dz * dz;
+        if ( remZ < 0.f )
+        {
+            continue;
+        }
+
+        // squared distance from the light to every tile column of the slice
+        const Float4 px = splat( l.position.x );
+        for ( uint32_t v = 0; v < _vectorsX; ++v )
+        {
+            const Float4 d = max4( max4( load4( minX + v * kLanes ) - px, px - load4( maxX + v * kLanes ) ), splat( 0.f ) );
+            dx2[ v ] = d * d;
+        }
+
+        const bool spot = l.spotCosOuter > -1.f;
+        for ( uint32_t y = 0; y < tilesY; ++y )
+        {
+            const float dy = std::max( std::max( minY[ y ] - l.position.y, l.position.y - maxY[ y ] ), 0.f );
+            const float rem = remZ - dy * dy;
+            if ( rem < 0.f )
+            {
+                continue;
+            }
+
+            const Float4 remv = splat( rem );
+            for ( uint32_t v = 0; v < _vectorsX; ++v )
+            {
+                const Int4 hit = dx2[ v ] <= remv;
+                if ( !anyLane( hit ) )
+                {
+                    continue;
+                }
+                for ( int lane = 0; lane < kLanes; ++lane )
+                {
+                    if ( !hit[ lane ] )
+                    {
+                        continue;
+                    }
+                    const uint32_t x = v * kLanes + lane;
+                    if ( spot )
+                    {
+                        const float hx = ( maxX[ x ] - minX[ x ] ) * 0.5f;
+                        const float hy = ( maxY[ y ] - minY[ y ] ) * 0.5f;
+                        const float hz = ( df - dn ) * 0.5f;
+                        const float center[ 3 ] = { minX[ x ] + hx, minY[ y ] + hy, -( dn + hz ) };
+                        if ( coneCulled( l, center, sqrtf( hx * hx + hy * hy + hz * hz ) ) )
+                        {
+                            continue;
+                        }
+                    }
+                    const uint32_t c = y * tilesX + x;
+                    if ( counts[ c ] < maxLights )
+                    {
+                        indices[ (size_t)c * maxLights + counts[ c ] ] = (uint16_t)i;
+                    }
+                    ++counts[ c ];
+                }
+            }
+        }
+    }
+
+    LightClusterStats& stats = _sliceStats[ slice ];
+    stats = {};
+    for ( uint32_t c = 0; c < tilesX * tilesY; ++c )
+    {
+        stats.maxCount = std::max( stats.maxCount, counts[ c ] );
+        if ( counts[ c ] > maxLights )
+        {
+            stats.dropped += counts[ c ] - maxLights;
+            counts[ c ] = maxLights;
+        }
+        stats.occupied += counts[ c ] > 0;
+        stats.references += counts[ c ];
+    }
+}
+
+void LightClusters::bin( const shader_types::ClusterLight* lights, size_t count ) {
+    assert( count <= 0xFFFF );
+    const auto begin = std::chrono::steady_clock::now();
+
+    _grid.lightCount = (uint32_t)count;
+    _jobs.parallelFor( _grid.slices, 1, [&]( size_t first, size_t last ) {
+        for ( size_t s = first; s < last; ++s )
+        {
+            binSlice( (uint32_t)s, lights, count );
+        }
+    } );
+
+    _stats = {};
+    _stats.lights = count;
+    _stats.clusters = _counts.size();
+    for ( const LightClusterStats& s : _sliceStats )
+    {
+        _stats.occupied += s.occupied;
+        _stats.references += s.references;
+        _stats.dropped += s.dropped;
+        _stats.maxCount = std::max( _stats.maxCount, s.maxCount );
+    }
+    _stats.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+}
+
+const char kLightClustersSource[] = R"(
+static float clusterSliceDepth( constant ClusterGrid& grid, uint k )
+{
+    return exp2( ( float( k ) - grid.sliceBias ) / grid.sliceScale );
+}
+
+static float clusterTileNdc( uint tile, uint tiles )
+{
+    return -1.0f + 2.0f * float( tile ) / float( tiles );
+}
+
+uint clusterIndex( constant ClusterGrid& grid, float2 pixel, float depth )
+{
+    const uint x = min( uint( pixel.x * grid.pixelsToTiles.x ), grid.tilesX - 1 );
+    const uint y = min( uint( pixel.y * grid.pixelsToTiles.y ), grid.tilesY - 1 );
+    const float s = floor( log2( max( depth, grid.nearZ ) ) * grid.sliceScale + grid.sliceBias );
+    const uint slice = uint( clamp( s, 0.0f, float( grid.slices - 1 ) ) );
+    return ( slice * grid.tilesY + y ) * grid.tilesX + x;
+}
+
+kernel void binLightClusters( constant ClusterGrid& grid [[buffer(0)]],
+                              device const ClusterLight* lights [[buffer(1)]],
+                              device uint* counts [[buffer(2)]],
+                              device ushort* indices [[buffer(3)]],
+                              uint3 cluster [[thread_position_in_grid]] )
+{
+    if ( cluster.x >= grid.tilesX || cluster.y >= grid.tilesY || cluster.z >= grid.slices )
+    {
+        return;
+    }
+
+    const float dn = clusterSliceDepth( grid, cluster.z );
+    const float df = clusterSliceDepth( grid, cluster.z + 1 );
+    const float left = clusterTileNdc( cluster.x, grid.tilesX ) * grid.tanHalfFovX;
+    const float right = clusterTileNdc( cluster.x + 1, grid.tilesX ) * grid.tanHalfFovX;
+    const float top = -clusterTileNdc( cluster.y, grid.tilesY ) * grid.tanHalfFovY;
+    const float bottom = -clusterTileNdc( cluster.y + 1, grid.tilesY ) * grid.tanHalfFovY;
+    const float minX = min( left * dn, left * df );
+    const float maxX = max( right * dn, right * df );
+    const float minY = min( bottom * dn, bottom * df );
+    const float maxY = max( top * dn, top * df );
+
+    const float hx = ( maxX - minX ) * 0.5f;
+    const float hy = ( maxY - minY ) * 0.5f;
+    const float hz = ( df - dn ) * 0.5f;
+    const float3 center = float3( minX + hx, minY + hy, -( dn + hz ) );
+    const float radius = sqrt( hx * hx + hy * hy + hz * hz );
+
+    const uint c = ( cluster.z * grid.tilesY + cluster.y ) * grid.tilesX + cluster.x;
+    uint n = 0;
+    for ( uint i = 0; i < grid.lightCount; ++i )
+    {
+        const ClusterLight l = lights[ i ];
+        const float depth = -l.position.z;
+        const float dz = max( max( dn - depth, depth - df ), 0.0f );
+        const float dy = max( max( minY - l.position.y, l.position.y - maxY ), 0.0f );
+        const float dx = max( max( minX - l.position.x, l.position.x - maxX ), 0.0f );
+        const float rem = l.range * l.range - dz * dz - dy * dy;
+        if ( rem < 0.0f || dx * dx > rem )
+        {
+            continue;
+        }
+        if ( l.spotCosOuter > -1.0f )
+        {
+            const float3 v = center - float3( l.position );
+            const float along = dot( v, float3( l.direction ) );
+            const float sinOuter = sqrt( max( 1.0f - l.spotCosOuter * l.spotCosOuter, 0.0f ) );
+            const float closest = l.spotCosOuter * sqrt( max( dot( v, v ) - along * along, 0.0f ) ) - along * sinOuter;
+            if ( closest > radius || along > radius + l.range || along < -radius )
+            {
+                continue;
+            }
+        }
+        if ( n < grid.maxLightsPerCluster )
+        {
+            indices[ c * grid.maxLightsPerCluster + n ] = ushort( i );
+        }
+        ++n;
+    }
+    counts[ c ] = min( n, grid.maxLightsPerCluster );
+}
+)";
@@ -0,0 +1,138 @@
+/**
+  ******************************************************************************
+  * @file           : light_clusters.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_LIGHT_CLUSTERS_HPP
+#define METAL_PLAYGROUND_LIGHT_CLUSTERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "job_system.hpp"
+#include "shader_struct.hpp"
+
+namespace shader_types
+{
+    // view space, looking down -z like the samples' cameras. point lights have
+    // spotCosOuter = -1, spot lights light the cone around direction
+#define CLUSTER_LIGHT_FIELDS( F )               \
+    F( packed_float3, position )                \
+    F( float, range )                           \
+    F( packed_float3, color )                   \
+    F( float, spotCosOuter )                    \
+    F( packed_float3, direction )               \
+    F( float, spotCosInner )
+
+    // the froxel grid: tilesX x tilesY screen tiles, tile ( 0, 0 ) at the top left,
+    // times slices exponential depth slices between nearZ and farZ. cluster
+    // ( x, y, slice ) is ( slice * tilesY + y ) * tilesX + x, slice is
+    // floor( log2( depth ) * sliceScale + sliceBias )
+#define CLUSTER_GRID_FIELDS( F )                \
+    F( uint, tilesX )                           \
+    F( uint, tilesY )                           \
+    F( uint, slices )                           \
+    F( uint, maxLightsPerCluster )              \
+    F( float, nearZ )                           \
+    F( float, farZ )                            \
+    F( float, sliceScale )                      \
+    F( float, sliceBias )                       \
+    F( float, tanHalfFovX )                     \
+    F( float, tanHalfFovY )                     \
+    F( packed_float2, pixelsToTiles )           \
+    F( uint, lightCount )
+
+    SHADER_STRUCT( ClusterLight, CLUSTER_LIGHT_FIELDS );
+    SHADER_STRUCT( ClusterGrid, CLUSTER_GRID_FIELDS );
+
+    static_assert( sizeof( ClusterLight ) == 48 );
+}
+
+// the usual grid is 16 x 9 x 24, a cluster then holds up to 256 lights
+shader_types::ClusterGrid makeClusterGrid( uint32_t tilesX, uint32_t tilesY, uint32_t slices, uint32_t maxLightsPerCluster,
+                                           float fovYRadians, float aspect, float nearZ, float farZ,
+                                           uint32_t viewportWidth, uint32_t viewportHeight );
+
+// msl for both sides of clustered forward shading, prepend kClusterLightSource and
+// kClusterGridSource. the binning kernel runs one thread per cluster over every light,
+// making the same tests in the same order as LightClusters::bin(), so both write the
+// same lists up to rounding on cluster boundaries:
+//
+//   kernel void binLightClusters( constant ClusterGrid& grid [[buffer(0)]],
+//                                 device const ClusterLight* lights [[buffer(1)]],
+//                                 device uint* counts [[buffer(2)]],
+//                                 device ushort* indices [[buffer(3)]],
+//                                 uint3 cluster [[thread_position_in_grid]] )
+//
+// dispatched over tilesX x tilesY x slices threads. shaders find their lights with
+//
+//   uint clusterIndex( constant ClusterGrid& grid, float2 pixel, float depth )
+//
+// the lights of cluster c are indices[ c * maxLightsPerCluster + i ], i < counts[ c ].
+extern const char kLightClustersSource[];
+
+struct LightClusterStats
+{
+    size_t lights;
+    size_t clusters;
+    size_t occupied;            // clusters with at least one light
+    size_t references;          // light indices written
+    size_t dropped;             // references past maxLightsPerCluster
+    uint32_t maxCount;          // most lights seen by one cluster, before the cap
+    double seconds;
+};
+
+// cpu binning into the same froxel grid, the fallback without a binning pass on the
+// gpu and the reference to check that pass against. the slices are binned on the job
+// system; within a slice a light's distance to the clusters is separable, so every
+// light tests a whole row of tiles 4 at a time.
+class LightClusters {
+private:
+    JobSystem& _jobs;
+    shader_types::ClusterGrid _grid;
+    uint32_t _vectorsX;         // tilesX in Float4s
+
+    // cluster bounds, view space x per ( slice, tile x ) padded to whole vectors,
+    // y per ( slice, tile y ), depth per slice boundary
+    std::vector<float> _minX, _maxX;
+    std::vector<float> _minY, _maxY;
+    std::vector<float> _sliceDepth;
+
+    std::vector<uint32_t> _counts;
+    std::vector<uint16_t> _indices;
+    std::vector<LightClusterStats> _sliceStats;
+    LightClusterStats _stats;
+
+    void binSlice( uint32_t slice, const shader_types::ClusterLight* lights, size_t count );
+
+public:
+    LightClusters( JobSystem& jobs, const shader_types::ClusterGrid& grid );
+
+    LightClusters( const LightClusters& ) = delete;
+    LightClusters& operator=( const LightClusters& ) = delete;
+
+    // at most 65535 lights, the index lists are 16 bit
+    void bin( const shader_types::ClusterLight* lights, size_t count );
+
+    const shader_types::ClusterGrid& grid() const { return _grid; }
+    size_t clusterCount() const { return _counts.size(); }
+    uint32_t clusterIndex( uint32_t x, uint32_t y, uint32_t slice ) const { return ( slice * _grid.tilesY + y ) * _grid.tilesX + x; }
+
+    // counts[ c ] lights for cluster c, capped at maxLightsPerCluster
+    const uint32_t* counts() const { return _counts.data(); }
+    // clusterCount() * maxLightsPerCluster entries, ascending light index per cluster
+    const uint16_t* indices() const { return _indices.data(); }
+
+    LightClusterStats stats() const { return _stats; }
+};
+
+
+#endif //METAL_PLAYGROUND_LIGHT_CLUSTERS_HPP
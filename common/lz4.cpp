@@ -0,0 +1,375 @@
+/**
+  ******************************************************************************
+  * @file           : lz4.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "lz4.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+static constexpr size_t kMinMatch = 4;
+// the last 5 bytes are always literals and the last match starts 12 bytes before the end
+static constexpr size_t kLastLiterals = 5;
+static constexpr size_t kMatchLimit = 12;
+static constexpr size_t kMaxOffset = 65535;
+static constexpr int kHashBits = 12;
+static constexpr int kChainHashBits = 15;
+static constexpr int kLazyLevel = 5;
+
+static uint32_t read32( const uint8_t* p )
+{
+    uint32_t v;
+    memcpy( &v, p, sizeof( v ) );
+    return v;
+}
+
+static uint32_t hash4( uint32_t v )
+{
+    return ( v * 2654435761u ) >> ( 32 - kHashBits );
+}
+
+static uint32_t hashChain( uint32_t v )
+{
+    return ( v * 2654435761u ) >> ( 32 - kChainHashBits );
+}
+
+static uint8_t* writeLength( uint8_t* op, size_t length )
+{
+    while ( length >= 255 )
+    {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+static uint8_t* writeLiterals( uint8_t* op, uint8_t* token, const uint8_t* literals, size_t count )
+{
+    if ( count >= 15 )
+    {
+        *token = 15 << 4;
+        op = writeLength( op, count - 15 );
+    }
+    else
+    {
+        *token = (uint8_t)( count << 4 );
+    }
+    // an empty input may come with a null pointer, which memcpy does not take even for 0 bytes
+    if ( count > 0 )
+    {
+        memcpy( op, literals, count );
+    }
+    return op + count;
+}
+
+static uint8_t* writeSequence( uint8_t* op, const uint8_t* literals, size_t count, size_t offset, size_t length )
+{
+    uint8_t* token = op++;
+    op = writeLiterals( op, token, literals, count );
+
+    *op++ = (uint8_t)( offset & 0xff );
+    *op++ = (uint8_t)( offset >> 8 );
+
+    const size_t extra = length - kMinMatch;
+    if ( extra >= 15 )
+    {
+        *token |= 15;
+        op = writeLength( op, extra - 15 );
+    }
+    else
+    {
+        *token |= (uint8_t)extra;
+    }
+    return op;
+}
+
+// level 1: one probe per position into a small table, skipping ahead on misses
+static uint8_t* compressFast( const uint8_t* in, size_t srcSize, uint8_t* op, size_t& anchor )
+{
+    uint32_t table[ 1 << kHashBits ];
+    memset( table, 0, sizeof( table ) );
+
+    const size_t matchStartLimit = srcSize - kMatchLimit;
+    const size_t matchEndLimit = srcSize - kLastLiterals;
+    size_t ip = 1;
+
+    while ( ip <= matchStartLimit )
+    {
+        const uint32_t sequence = read32( in + ip );
+        const uint32_t h = hash4( sequence );
+        size_t ref = table[ h ];
+        table[ h ] = (uint32_t)ip;
+
+        if ( ip - ref > kMaxOffset || read32( in + ref ) != sequence )
+        {
+            // step faster through data that keeps missing
+            ip += 1 + ( ( ip - anchor ) >> 6 );
+            continue;
+        }
+
+        while ( ip > anchor && ref > 0 && in[ ip - 1 ] == in[ ref - 1 ] )
+        {
+            --ip;
+            --ref;
+        }
+        size_t length = kMinMatch;
+        while ( ip + length < matchEndLimit && in[ ip + length ] == in[ ref + length ] )
+        {
+            ++length;
+        }
+
+        op = writeSequence( op, in + anchor, ip - anchor, ip - ref, length );
+        ip += length;
+        anchor = ip;
+        // seed the table from inside the match so the next probe has a fresh candidate
+        table[ hash4( read32( in + ip - 2 ) ) ] = (uint32_t)( ip - 2 );
+    }
+    return op;
+}
+
+// higher levels: every position goes into hash chains over the 64 KB window and
+// up to attempts candidates are compared. lazy also tries the next position and
+// takes its match when that one is longer.
+static uint8_t* compressChain( const uint8_t* in, size_t srcSize, uint8_t* op, size_t& anchor, int attempts, bool lazy )
+{
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    thread_local std::vector<uint32_t> head;
+    thread_local std::vector<uint32_t> prev;
+    head.assign( (size_t)1 << kChainHashBits, kNone );
+    prev.resize( kMaxOffset + 1 );
+
+    const size_t matchStartLimit = srcSize - kMatchLimit;
+    const size_t matchEndLimit = srcSize - kLastLiterals;
+    size_t inserted = 0;
+
+    auto findMatch = [&]( size_t ip, size_t& outRef ) {
+        for ( ; inserted < ip; ++inserted )
+        {
+            const uint32_t h = hashChain( read32( in + inserted ) );
+            prev[ inserted & kMaxOffset ] = head[ h ];
+            head[ h ] = (uint32_t)inserted;
+        }
+
+        const uint32_t sequence = read32( in + ip );
+        size_t best = 0;
+        uint32_t candidate = head[ hashChain( sequence ) ];
+        for ( int a = attempts; a > 0 && candidate != kNone && ip - candidate <= kMaxOffset; --a )
+        {
+            if ( read32( in + candidate ) == sequence )
+            {
+                size_t length = kMinMatch;
+                while ( ip + length < matchEndLimit && in[ ip + length ] == in[ candidate + length ] )
+                {
+                    ++length;
+                }
+                if ( length > best )
+                {
+                    best = length;
+                    outRef = candidate;
+                }
+            }
+
+            // a slot overwritten by a newer position ends the chain
+            const uint32_t next = prev[ candidate & kMaxOffset ];
+            if ( next == kNone || next >= candidate )
+            {
+                break;
+            }
+            candidate = next;
+        }
+        return best;
+    };
+
+    size_t ip = 0;
+    while ( ip <= matchStartLimit )
+    {
+        size_t ref = 0;
+        size_t length = findMatch( ip, ref );
+        if ( length < kMinMatch )
+        {
+            ++ip;
+            continue;
+        }
+
+        while ( lazy && ip + 1 <= matchStartLimit )
+        {
+            size_t nextRef = 0;
+            const size_t nextLength = findMatch( ip + 1, nextRef );
+            if ( nextLength <= length )
+            {
+                break;
+            }
+            ++ip;
+            ref = nextRef;
+            length = nextLength;
+        }
+
+        op = writeSequence( op, in + anchor, ip - anchor, ip - ref, length );
+        ip += length;
+        anchor = ip;
+    }
+    return op;
+}
+
+size_t lz4CompressBound( size_t size )
+{
+    return size + size / 255 + 16;
+}
+
+size_t lz4Compress( const void* src, size_t srcSize, void* dst, size_t dstCapacity, int level )
+{
+    // only checked in debug builds, the encoder never writes past the bound
+    assert( dstCapacity >= lz4CompressBound( srcSize ) );
+    (void)dstCapacity;
+
+    const uint8_t* in = (const uint8_t*)src;
+    uint8_t* op = (uint8_t*)dst;
+    size_t anchor = 0;
+
+    if ( srcSize > kMatchLimit )
+    {
+        level = std::min( level, kLz4MaxLevel );
+        if ( level <= kLz4MinLevel )
+        {
+            op = compressFast( in, srcSize, op, anchor );
+        }
+        else
+        {
+            // 2 candidates at level 2 up to 256 at level 9
+            op = compressChain( in, srcSize, op, anchor, 1 << ( level - 1 ), level >= kLazyLevel );
+        }
+    }
+
+    uint8_t* token = op++;
+    op = writeLiterals( op, token, in + anchor, srcSize - anchor );
+    return (size_t)( op - (uint8_t*)dst );
+}
+
+bool lz4Decompress( const void* src, size_t srcSize, void* dst, size_t dstSize )
+{
+    const uint8_t* in = (const uint8_t*)src;
+    uint8_t* out = (uint8_t*)dst;
+    size_t ip = 0;
+    size_t op = 0;
+
+    for ( ;; )
+    {
+        if ( ip >= srcSize )
+        {
+            return false;
+        }
+        const uint8_t token = in[ ip++ ];
+
+        size_t literals = token >> 4;
+        if ( literals == 15 )
+        {
+            uint8_t b;
+            do
+            {
+                if ( ip >= srcSize )
+                {
+                    return false;
+                }
+                b = in[ ip++ ];
+                literals += b;
+            } while ( b == 255 );
+        }
+        if ( literals > srcSize - ip || literals > dstSize - op )
+        {
+            return false;
+        }
+        if ( literals <= 16 && srcSize - ip >= 16 && dstSize - op >= 16 )
+        {
+            // short runs dominate, a fixed size copy beats a call into memcpy
+            memcpy( out + op, in + ip, 16 );
+        }
+        else if ( literals > 0 )
+        {
+            memcpy( out + op, in + ip, literals );
+        }
+        ip += literals;
+        op += literals;
+
+        // the last sequence has no match
+        if ( ip == srcSize )
+        {
+            return op == dstSize;
+        }
+
+        if ( srcSize - ip < 2 )
+        {
+            return false;
+        }
+        const size_t offset = in[ ip ] | ( (size_t)in[ ip + 1 ] << 8 );
+        ip += 2;
+        if ( offset == 0 || offset > op )
+        {
+            return false;
+        }
+
+        size_t length = token & 15;
+        if ( length == 15 )
+        {
+            uint8_t b;
+            do
+            {
+                if ( ip >= srcSize )
+                {
+                    return false;
+                }
+                b = in[ ip++ ];
+                length += b;
+            } while ( b == 255 );
+        }
+        length += kMinMatch;
+        if ( length > dstSize - op )
+        {
+            return false;
+        }
+
+        uint8_t* d = out + op;
+        const uint8_t* s = d - offset;
+        // wide copies may run past the match while there is room, the source
+        // never catches up with what they write as long as offset >= width
+        if ( offset >= 16 && dstSize - op >= length + 16 )
+        {
+            for ( size_t i = 0; i < length; i += 16 )
+            {
+                memcpy( d + i, s + i, 16 );
+            }
+        }
+        else if ( offset >= 8 && dstSize - op >= length + 8 )
+        {
+            for ( size_t i = 0; i < length; i += 8 )
+            {
+                memcpy( d + i, s + i, 8 );
+            }
+        }
+        else if ( offset >= length )
+        {
+            memcpy( d, s, length );
+        }
+        else
+        {
+            // overlapping copy repeats the last offset bytes
+            for ( size_t i = 0; i < length; ++i )
+            {
+                d[ i ] = s[ i ];
+            }
+        }
+        op += length;
+    }
+}
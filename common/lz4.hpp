@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file           : lz4.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_LZ4_HPP
+#define METAL_PLAYGROUND_LZ4_HPP
+
+#include <cstddef>
+
+// lz4 block format, no frame around it. blocks are self contained, so chunks
+// compressed on their own can be decoded on any thread in any order.
+
+// worst case compressed size of size bytes
+size_t lz4CompressBound( size_t size );
+
+static constexpr int kLz4MinLevel = 1;
+static constexpr int kLz4MaxLevel = 9;
+
+// level 1 is a greedy single probe compressor, higher levels search hash chains
+// longer and longer for a better ratio, decoding speed stays the same.
+// dstCapacity has to be at least lz4CompressBound( srcSize ); returns the compressed size
+size_t lz4Compress( const void* src, size_t srcSize, void* dst, size_t dstCapacity, int level = kLz4MinLevel );
+
+// bounds checked decoder. fails unless src decodes to exactly dstSize bytes
+bool lz4Decompress( const void* src, size_t srcSize, void* dst, size_t dstSize );
+
+
+#endif //METAL_PLAYGROUND_LZ4_HPP
@@ -0,0 +1,53 @@
+/**
+  ******************************************************************************
+  * @file           : metal_copy_engine.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "metal_copy_engine.hpp"
+
+MetalCopyEngine::MetalCopyEngine( MTL::Device* device, size_t stagingSize )
+: _commandQueue(device->newCommandQueue())
+, _staging(device->newBuffer( stagingSize, MTL::ResourceStorageModeShared | MTL::ResourceCPUCacheModeWriteCombined )) {
+}
+
+MetalCopyEngine::~MetalCopyEngine() {
+    _staging->release();
+    _commandQueue->release();
+}
+
+void MetalCopyEngine::submit( const UploadCopy* copies, size_t count, std::function<void()> done ) {
+    // called from the upload worker, which has no pool of its own
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    MTL::BlitCommandEncoder* blit = cmd->blitCommandEncoder();
+    for ( size_t i = 0; i < count; ++i )
+    {
+        const UploadCopy& c = copies[ i ];
+        if ( c.texture )
+        {
+            blit->copyFromBuffer( _staging, c.srcOffset, c.bytesPerRow, c.bytesPerRow * c.height,
+                                  MTL::Size( c.width, c.height, 1 ),
+                                  c.texture, 0, c.level, MTL::Origin( c.x, c.y, 0 ) );
+        }
+        else
+        {
+            blit->copyFromBuffer( _staging, c.srcOffset, c.buffer, c.dstOffset, c.length );
+        }
+    }
+    blit->endEncoding();
+
+    cmd->addCompletedHandler( ^void( MTL::CommandBuffer* pCmd ) {
+        done();
+    } );
+    cmd->commit();
+
+    pool->release();
+}
@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file           : metal_copy_engine.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_METAL_COPY_ENGINE_HPP
+#define METAL_PLAYGROUND_METAL_COPY_ENGINE_HPP
+
+#include <Metal/Metal.hpp>
+
+#include "upload_queue.hpp"
+
+// CopyEngine on a Metal command queue: the staging ring is one shared buffer,
+// every batch becomes a command buffer with a single blit encoder.
+class MetalCopyEngine : public CopyEngine {
+private:
+    MTL::CommandQueue* _commandQueue;
+    MTL::Buffer* _staging;
+
+public:
+    // copies go through their own queue so they never wait behind frame work
+    MetalCopyEngine( MTL::Device* device, size_t stagingSize = 64 << 20 );
+    ~MetalCopyEngine() override;
+
+    void* staging() override { return _staging->contents(); }
+    size_t stagingSize() const override { return _staging->length(); }
+    void submit( const UploadCopy* copies, size_t count, std::function<void()> done ) override;
+};
+
+
+#endif //METAL_PLAYGROUND_METAL_COPY_ENGINE_HPP
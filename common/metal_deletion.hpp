@@ -0,0 +1,47 @@
+/**
+  ******************************************************************************
+  * @file           : metal_deletion.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_METAL_DELETION_HPP
+#define METAL_PLAYGROUND_METAL_DELETION_HPP
+
+#include <Metal/Metal.hpp>
+
+#include "deletion_queue.hpp"
+
+// object->release() once the current frame has completed
+inline void retire( DeletionQueue& queue, NS::Object* object )
+{
+    if ( object )
+    {
+        queue.defer( []( void* context, uint64_t ) { static_cast<NS::Object*>( context )->release(); }, object, 0 );
+    }
+}
+
+template<class _Class>
+inline void retire( DeletionQueue& queue, NS::UniquePtr<_Class>&& object )
+{
+    retire( queue, object.detach() );
+}
+
+// ends the current frame, its fence is signalled when cmd completes.
+// command buffers of a queue complete in order
+inline void commitFrame( DeletionQueue& queue, MTL::CommandBuffer* cmd )
+{
+    const uint64_t frame = queue.endFrame();
+    DeletionQueue* pQueue = &queue;
+    cmd->addCompletedHandler( ^void( MTL::CommandBuffer* pCmd ) {
+        pQueue->complete( frame );
+    } );
+}
+
+
+#endif //METAL_PLAYGROUND_METAL_DELETION_HPP
@@ -0,0 +1,37 @@
+/**
+  ******************************************************************************
+  * @file           : metal_storage.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_METAL_STORAGE_HPP
+#define METAL_PLAYGROUND_METAL_STORAGE_HPP
+
+#include <Metal/Metal.hpp>
+
+#include "resource_policy.hpp"
+
+static_assert( (int)ResourceStorage::Shared == (int)MTL::StorageModeShared, "ResourceStorage follows MTL::StorageMode" );
+static_assert( (int)ResourceStorage::Managed == (int)MTL::StorageModeManaged, "ResourceStorage follows MTL::StorageMode" );
+static_assert( (int)ResourceStorage::Private == (int)MTL::StorageModePrivate, "ResourceStorage follows MTL::StorageMode" );
+
+inline MTL::StorageMode metalStorageMode( ResourceStorage storage )
+{
+    return (MTL::StorageMode)storage;
+}
+
+// the storage mode as the ResourceOptions bits buffers and heaps take
+inline MTL::ResourceOptions resourceOptions( MTL::StorageMode storageMode )
+{
+    // MTLResourceStorageModeShift
+    return (MTL::ResourceOptions)( (NS::UInteger)storageMode << 4 );
+}
+
+
+#endif //METAL_PLAYGROUND_METAL_STORAGE_HPP
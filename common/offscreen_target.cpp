@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file           : offscreen_target.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "offscreen_target.hpp"
+
+OffscreenTarget::OffscreenTarget( MTL::Device* device, uint32_t width, uint32_t height,
+                                  MTL::PixelFormat colorFormat, MTL::PixelFormat depthFormat,
+                                  uint32_t readbackSlots, MTL::ClearColor clearColor )
+: _width(width)
+, _height(height)
+, _bytesPerRow((size_t)width * 4) {
+    MTL::TextureDescriptor* desc = MTL::TextureDescriptor::texture2DDescriptor( colorFormat, width, height, false );
+    desc->setStorageMode( MTL::StorageModePrivate );
+    desc->setUsage( MTL::TextureUsageRenderTarget );
+    _color = device->newTexture( desc );
+
+    // depth never leaves the pass, memoryless would do on apple gpus
+    desc->setPixelFormat( depthFormat );
+    _depth = device->newTexture( desc );
+
+    _passDesc = MTL::RenderPassDescriptor::alloc()->init();
+    MTL::RenderPassColorAttachmentDescriptor* color = _passDesc->colorAttachments()->object( 0 );
+    color->setTexture( _color );
+    color->setLoadAction( MTL::LoadActionClear );
+    color->setStoreAction( MTL::StoreActionStore );
+    color->setClearColor( clearColor );
+
+    MTL::RenderPassDepthAttachmentDescriptor* depth = _passDesc->depthAttachment();
+    depth->setTexture( _depth );
+    depth->setLoadAction( MTL::LoadActionClear );
+    depth->setStoreAction( MTL::StoreActionDontCare );
+    depth->setClearDepth( 1.0 );
+
+    for ( uint32_t i = 0; i < readbackSlots; ++i )
+    {
+        _readback.push_back( device->newBuffer( _bytesPerRow * height, MTL::ResourceStorageModeShared ) );
+    }
+}
+
+OffscreenTarget::~OffscreenTarget() {
+    for ( MTL::Buffer* buffer : _readback )
+    {
+        buffer->release();
+    }
+    _passDesc->release();
+    _depth->release();
+    _color->release();
+}
+
+void OffscreenTarget::encodeReadback( MTL::CommandBuffer* cmd, uint32_t slot ) const {
+    MTL::BlitCommandEncoder* blit = cmd->blitCommandEncoder();
+    blit->copyFromTexture( _color, 0, 0, MTL::Origin::Make( 0, 0, 0 ), MTL::Size::Make( _width, _height, 1 ),
+                           _readback[ slot ], 0, _bytesPerRow, _bytesPerRow * _height );
+    blit->endEncoding();
+}
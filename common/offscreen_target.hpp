@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file           : offscreen_target.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_OFFSCREEN_TARGET_HPP
+#define METAL_PLAYGROUND_OFFSCREEN_TARGET_HPP
+
+#include <Metal/Metal.hpp>
+
+#include <vector>
+
+// colour + depth textures standing in for a view's drawable, plus shared buffers the
+// colour is blitted into for the cpu. one readback buffer per FrameSequencer slot.
+// colour formats are expected to be 4 bytes per pixel.
+class OffscreenTarget {
+private:
+    uint32_t _width;
+    uint32_t _height;
+    size_t _bytesPerRow;
+
+    MTL::Texture* _color;
+    MTL::Texture* _depth;
+    MTL::RenderPassDescriptor* _passDesc;
+    std::vector<MTL::Buffer*> _readback;
+
+public:
+    OffscreenTarget( MTL::Device* device, uint32_t width, uint32_t height,
+                     MTL::PixelFormat colorFormat, MTL::PixelFormat depthFormat,
+                     uint32_t readbackSlots, MTL::ClearColor clearColor );
+    ~OffscreenTarget();
+
+    OffscreenTarget( const OffscreenTarget& ) = delete;
+    OffscreenTarget& operator=( const OffscreenTarget& ) = delete;
+
+    uint32_t width() const { return _width; }
+    uint32_t height() const { return _height; }
+
+    // clears both attachments, only the colour is stored
+    MTL::RenderPassDescriptor* renderPassDescriptor() const { return _passDesc; }
+
+    // copies the colour into the slot's buffer, readable once cmd has completed
+    void encodeReadback( MTL::CommandBuffer* cmd, uint32_t slot ) const;
+    const void* readback( uint32_t slot ) const { return _readback[ slot ]->contents(); }
+    size_t bytesPerRow() const { return _bytesPerRow; }
+};
+
+
+#endif //METAL_PLAYGROUND_OFFSCREEN_TARGET_HPP
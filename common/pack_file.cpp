@@ -0,0 +1,430 @@
+/**
+  ******************************************************************************
+  * @file           : pack_file.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "pack_file.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lz4.hpp"
+
+static constexpr uint32_t kPrime1 = 2654435761u;
+static constexpr uint32_t kPrime2 = 2246822519u;
+static constexpr uint32_t kPrime3 = 3266489917u;
+static constexpr uint32_t kPrime4 = 668265263u;
+static constexpr uint32_t kPrime5 = 374761393u;
+
+static uint32_t rotl( uint32_t v, int r )
+{
+    return ( v << r ) | ( v >> ( 32 - r ) );
+}
+
+static uint32_t read32( const uint8_t* p )
+{
+    uint32_t v;
+    memcpy( &v, p, sizeof( v ) );
+    return v;
+}
+
+static uint32_t checksumRound( uint32_t acc, uint32_t input )
+{
+    return rotl( acc + input * kPrime2, 13 ) * kPrime1;
+}
+
+static uint64_t alignUp( uint64_t value, uint64_t align )
+{
+    return ( value + align - 1 ) / align * align;
+}
+
+uint32_t packChecksum( const void* data, size_t size, uint32_t seed )
+{
+    const uint8_t* p = (const uint8_t*)data;
+    const uint8_t* end = p + size;
+    uint32_t h;
+
+    if ( size >= 16 )
+    {
+        uint32_t v1 = seed + kPrime1 + kPrime2;
+        uint32_t v2 = seed + kPrime2;
+        uint32_t v3 = seed;
+        uint32_t v4 = seed - kPrime1;
+        for ( ; p + 16 <= end; p += 16 )
+        {
+            v1 = checksumRound( v1, read32( p ) );
+            v2 = checksumRound( v2, read32( p + 4 ) );
+            v3 = checksumRound( v3, read32( p + 8 ) );
+            v4 = checksumRound( v4, read32( p + 12 ) );
+        }
+        h = rotl( v1, 1 ) + rotl( v2, 7 ) + rotl( v3, 12 ) + rotl( v4, 18 );
+    }
+    else
+    {
+        h = seed + kPrime5;
+    }
+
+    h += (uint32_t)size;
+    for ( ; p + 4 <= end; p += 4 )
+    {
+        h = rotl( h + read32( p ) * kPrime3, 17 ) * kPrime4;
+    }
+    for ( ; p < end; ++p )
+    {
+        h = rotl( h + *p * kPrime5, 11 ) * kPrime1;
+    }
+
+    h ^= h >> 15;
+    h *= kPrime2;
+    h ^= h >> 13;
+    h *= kPrime3;
+    h ^= h >> 16;
+    return h;
+}
+
+PackWriter::PackWriter( JobSystem& jobs )
+: _jobs(jobs) {
+}
+
+void PackWriter::add( const char* name, const void* data, size_t size, int level ) {
+    _entries.push_back( { name, (const uint8_t*)data, size, level } );
+}
+
+bool PackWriter::write( const char* path, uint32_t alignment ) {
+    std::vector<Entry> entries = _entries;
+    std::sort( entries.begin(), entries.end(), []( const Entry& a, const Entry& b ) { return a.name < b.name; } );
+    for ( size_t i = 1; i < entries.size(); ++i )
+    {
+        if ( entries[ i ].name == entries[ i - 1 ].name )
+        {
+            return false;
+        }
+    }
+
+    PackHeader header = {};
+    header.magic = kPackMagic;
+    header.version = kPackVersion;
+    header.alignment = alignment;
+    header.chunkSize = kPackChunkSize;
+    header.entryCount = (uint32_t)entries.size();
+
+    std::vector<PackEntry> toc( entries.size() );
+    std::string names;
+    for ( size_t i = 0; i < entries.size(); ++i )
+    {
+        toc[ i ].nameOffset = (uint32_t)names.size();
+        toc[ i ].firstChunk = header.chunkCount;
+        toc[ i ].chunkCount = (uint32_t)( ( entries[ i ].size + kPackChunkSize - 1 ) / kPackChunkSize );
+        toc[ i ].flags = entries[ i ].level <= 0 ? kPackEntryStored : 0;
+        toc[ i ].size = entries[ i ].size;
+
+        names.append( entries[ i ].name ).push_back( '\0' );
+        header.chunkCount += toc[ i ].chunkCount;
+    }
+    header.namesSize = names.size();
+
+    // which entry every chunk belongs to, so the compression loop is flat
+    std::vector<uint32_t> owners( header.chunkCount );
+    for ( uint32_t i = 0; i < header.entryCount; ++i )
+    {
+        std::fill_n( owners.begin() + toc[ i ].firstChunk, toc[ i ].chunkCount, i );
+    }
+
+    std::vector<PackChunk> chunks( header.chunkCount );
+    std::vector<std::vector<uint8_t>> packed( header.chunkCount );
+    _jobs.parallelFor( header.chunkCount, 1, [&]( size_t begin, size_t end ) {
+        for ( size_t c = begin; c < end; ++c )
+        {
+            const Entry& e = entries[ owners[ c ] ];
+            const size_t offset = ( c - toc[ owners[ c ] ].firstChunk ) * kPackChunkSize;
+            const uint8_t* src = e.data + offset;
+            const size_t length = std::min<size_t>( kPackChunkSize, e.size - offset );
+
+            // stored chunks are written from the caller's memory
+            const uint8_t* stored = src;
+            size_t storedSize = length;
+            if ( e.level > 0 )
+            {
+                std::vector<uint8_t>& out = packed[ c ];
+                out.resize( lz4CompressBound( length ) );
+                const size_t size = lz4Compress( src, length, out.data(), out.size(), e.level );
+                if ( size < length )
+                {
+                    out.resize( size );
+                    stored = out.data();
+                    storedSize = size;
+                }
+                else
+                {
+                    out.clear();
+                }
+            }
+
+            chunks[ c ].storedSize = (uint32_t)storedSize;
+            chunks[ c ].checksum = packChecksum( stored, storedSize );
+        }
+    } );
+
+    const uint64_t tocEnd = sizeof( PackHeader ) + toc.size() * sizeof( PackEntry ) + chunks.size() * sizeof( PackChunk ) + names.size();
+    uint64_t offset = tocEnd;
+    for ( PackEntry& e : toc )
+    {
+        offset = alignUp( offset, alignment );
+        e.offset = offset;
+        for ( uint32_t c = e.firstChunk; c < e.firstChunk + e.chunkCount; ++c )
+        {
+            chunks[ c ].offset = offset;
+            offset += chunks[ c ].storedSize;
+        }
+    }
+
+    // the toc goes out as one block, checksummed the way the reader sees it
+    std::vector<uint8_t> block( toc.size() * sizeof( PackEntry ) + chunks.size() * sizeof( PackChunk ) + names.size() );
+    uint8_t* p = block.data();
+    p = std::copy_n( (const uint8_t*)toc.data(), toc.size() * sizeof( PackEntry ), p );
+    p = std::copy_n( (const uint8_t*)chunks.data(), chunks.size() * sizeof( PackChunk ), p );
+    std::copy_n( names.data(), names.size(), p );
+    header.tocChecksum = packChecksum( block.data(), block.size() );
+
+    FILE* f = fopen( path, "wb" );
+    if ( !f )
+    {
+        return false;
+    }
+
+    bool ok = fwrite( &header, sizeof( header ), 1, f ) == 1;
+    ok = ok && fwrite( block.data(), 1, block.size(), f ) == block.size();
+
+    static const uint8_t zeros[ 4096 ] = {};
+    uint64_t written = tocEnd;
+    for ( size_t c = 0; ok && c < chunks.size(); ++c )
+    {
+        for ( uint64_t pad = chunks[ c ].offset - written; ok && pad > 0; )
+        {
+            const size_t n = (size_t)std::min<uint64_t>( pad, sizeof( zeros ) );
+            ok = fwrite( zeros, 1, n, f ) == n;
+            pad -= n;
+        }
+
+        const Entry& e = entries[ owners[ c ] ];
+        const uint8_t* data = packed[ c ].empty()
+                              ? e.data + ( c - toc[ owners[ c ] ].firstChunk ) * kPackChunkSize
+                              : packed[ c ].data();
+        ok = ok && fwrite( data, 1, chunks[ c ].storedSize, f ) == chunks[ c ].storedSize;
+        written = chunks[ c ].offset + chunks[ c ].storedSize;
+    }
+    return fclose( f ) == 0 && ok;
+}
+
+PackReader::PackReader()
+: _fd(-1)
+, _map(nullptr)
+, _mapSize(0)
+, _header(nullptr)
+, _entries(nullptr)
+, _chunks(nullptr)
+, _names(nullptr) {
+}
+
+PackReader::~PackReader() {
+    close();
+}
+
+bool PackReader::open( const char* path ) {
+    close();
+
+    _fd = ::open( path, O_RDONLY );
+    struct stat st;
+    if ( _fd < 0 || fstat( _fd, &st ) != 0 || (size_t)st.st_size < sizeof( PackHeader ) )
+    {
+        close();
+        return false;
+    }
+
+    _mapSize = (size_t)st.st_size;
+    void* map = mmap( nullptr, _mapSize, PROT_READ, MAP_PRIVATE, _fd, 0 );
+    if ( map == MAP_FAILED )
+    {
+        _mapSize = 0;
+        close();
+        return false;
+    }
+    _map = (const uint8_t*)map;
+
+    // the counts come from the file. every part of the toc is held against what is left
+    // of the file on its own, before anything is added up or indexed, so no sum can wrap
+    const PackHeader* header = (const PackHeader*)_map;
+    uint64_t remaining = _mapSize - sizeof( PackHeader );
+    auto take = [&remaining]( uint64_t size ) {
+        if ( size > remaining )
+        {
+            return false;
+        }
+        remaining -= size;
+        return true;
+    };
+    const bool tocFits = take( (uint64_t)header->entryCount * sizeof( PackEntry ) )
+                         && take( (uint64_t)header->chunkCount * sizeof( PackChunk ) )
+                         && take( header->namesSize );
+    const uint64_t tocSize = _mapSize - sizeof( PackHeader ) - remaining;
+    if ( header->magic != kPackMagic || header->version != kPackVersion
+         || header->chunkSize == 0 || header->alignment == 0
+         || !tocFits
+         || packChecksum( _map + sizeof( PackHeader ), (size_t)tocSize ) != header->tocChecksum
+         || ( header->namesSize > 0 && _map[ sizeof( PackHeader ) + tocSize - 1 ] != '\0' ) )
+    {
+        close();
+        return false;
+    }
+
+    _header = header;
+    _entries = (const PackEntry*)( _map + sizeof( PackHeader ) );
+    _chunks = (const PackChunk*)( _entries + header->entryCount );
+    _names = (const char*)( _chunks + header->chunkCount );
+
+    // everything the reads index with has to stay inside the file
+    for ( uint32_t i = 0; i < header->entryCount; ++i )
+    {
+        const PackEntry& e = _entries[ i ];
+        const bool ok = e.nameOffset < header->namesSize
+                        && e.firstChunk <= header->chunkCount
+                        && e.chunkCount <= header->chunkCount - e.firstChunk
+                        && e.chunkCount == e.size / header->chunkSize + ( e.size % header->chunkSize != 0 );
+        if ( !ok )
+        {
+            close();
+            return false;
+        }
+    }
+    for ( uint32_t c = 0; c < header->chunkCount; ++c )
+    {
+        const PackChunk& chunk = _chunks[ c ];
+        if ( chunk.offset > _mapSize || chunk.storedSize > _mapSize - chunk.offset )
+        {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void PackReader::close() {
+    if ( _map )
+    {
+        munmap( (void*)_map, _mapSize );
+    }
+    if ( _fd >= 0 )
+    {
+        ::close( _fd );
+    }
+    _fd = -1;
+    _map = nullptr;
+    _mapSize = 0;
+    _header = nullptr;
+    _entries = nullptr;
+    _chunks = nullptr;
+    _names = nullptr;
+}
+
+int PackReader::find( const char* name ) const {
+    uint32_t lo = 0;
+    uint32_t hi = entryCount();
+    while ( lo < hi )
+    {
+        const uint32_t mid = ( lo + hi ) / 2;
+        const int order = strcmp( this->name( mid ), name );
+        if ( order == 0 )
+        {
+            return (int)mid;
+        }
+        if ( order < 0 )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return -1;
+}
+
+const void* PackReader::mapped( uint32_t index ) const {
+    const PackEntry& e = _entries[ index ];
+    if ( !( e.flags & kPackEntryStored ) || e.offset > _mapSize || e.size > _mapSize - e.offset )
+    {
+        return nullptr;
+    }
+    return _map + e.offset;
+}
+
+bool PackReader::read( JobSystem& jobs, const Read* reads, size_t count, bool verify ) {
+    if ( !_header )
+    {
+        return false;
+    }
+
+    // chunk c of the whole batch belongs to the read whose first chunk is the last one <= c
+    std::vector<size_t> firsts( count + 1, 0 );
+    for ( size_t i = 0; i < count; ++i )
+    {
+        firsts[ i + 1 ] = firsts[ i ] + _entries[ reads[ i ].entry ].chunkCount;
+    }
+
+    const size_t chunkSize = _header->chunkSize;
+    std::atomic<bool> ok( true );
+
+    jobs.parallelFor( firsts[ count ], 4, [&]( size_t begin, size_t end ) {
+        size_t r = std::upper_bound( firsts.begin(), firsts.end(), begin ) - firsts.begin() - 1;
+        for ( size_t c = begin; c < end; ++c )
+        {
+            while ( c >= firsts[ r + 1 ] )
+            {
+                ++r;
+            }
+
+            const PackEntry& e = _entries[ reads[ r ].entry ];
+            const size_t local = c - firsts[ r ];
+            const PackChunk& chunk = _chunks[ e.firstChunk + local ];
+            const size_t length = (size_t)std::min<uint64_t>( chunkSize, e.size - local * chunkSize );
+            const uint8_t* src = _map + chunk.offset;
+            uint8_t* dst = (uint8_t*)reads[ r ].dst + local * chunkSize;
+
+            if ( verify && packChecksum( src, chunk.storedSize ) != chunk.checksum )
+            {
+                ok = false;
+                return;
+            }
+            if ( chunk.storedSize == length )
+            {
+                memcpy( dst, src, length );
+            }
+            else if ( !lz4Decompress( src, chunk.storedSize, dst, length ) )
+            {
+                ok = false;
+                return;
+            }
+        }
+    } );
+
+    return ok;
+}
+
+bool PackReader::read( JobSystem& jobs, uint32_t index, void* dst, bool verify ) {
+    const Read r = { index, dst };
+    return read( jobs, &r, 1, verify );
+}
@@ -0,0 +1,146 @@
+/**
+  ******************************************************************************
+  * @file           : pack_file.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_PACK_FILE_HPP
+#define METAL_PLAYGROUND_PACK_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "job_system.hpp"
+
+// many named assets in one file:
+//
+//   PackHeader
+//   PackEntry entries[ entryCount ]     sorted by name
+//   PackChunk chunks[ chunkCount ]      every entry owns a run of them
+//   names                               nul terminated
+//   data                                every entry starts on an alignment boundary
+//
+// entries are cut into chunkSize pieces that are lz4 compressed on their own, so any
+// chunk decodes on any thread. a chunk that would not shrink is kept as is. stored
+// entries are never compressed and can be used straight out of a mapping of the file.
+struct PackHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t alignment;
+    uint32_t chunkSize;
+    uint32_t entryCount;
+    uint32_t chunkCount;
+    uint64_t namesSize;
+    uint32_t tocChecksum;   // entries, chunks and names
+    uint32_t reserved;
+};
+
+static constexpr uint32_t kPackEntryStored = 1;
+
+struct PackEntry
+{
+    uint32_t nameOffset;
+    uint32_t firstChunk;
+    uint32_t chunkCount;
+    uint32_t flags;
+    uint64_t offset;        // of the first chunk
+    uint64_t size;          // uncompressed
+};
+
+struct PackChunk
+{
+    uint64_t offset;
+    uint32_t storedSize;    // equals the chunk length when it is not compressed
+    uint32_t checksum;      // of the stored bytes
+};
+
+static constexpr uint32_t kPackMagic = 0x4b50504d; // 'MPPK'
+static constexpr uint32_t kPackVersion = 1;
+static constexpr uint32_t kPackChunkSize = 64 * 1024;
+// page size on apple silicon, what newBufferWithBytesNoCopy wants
+static constexpr uint32_t kPackAlignment = 16 * 1024;
+
+// xxhash32
+uint32_t packChecksum( const void* data, size_t size, uint32_t seed = 0 );
+
+// collects entries and writes them in one go, compressing all chunks of all
+// entries in parallel on the job system
+class PackWriter {
+private:
+    struct Entry
+    {
+        std::string name;
+        const uint8_t* data;
+        size_t size;
+        int level;
+    };
+
+    JobSystem& _jobs;
+    std::vector<Entry> _entries;
+
+public:
+    explicit PackWriter( JobSystem& jobs );
+
+    // data has to stay alive until write(). level 0 stores the entry uncompressed,
+    // otherwise it is the lz4 level
+    void add( const char* name, const void* data, size_t size, int level );
+
+    // false on duplicate names or io errors
+    bool write( const char* path, uint32_t alignment = kPackAlignment );
+};
+
+// maps a pack and decompresses entries in parallel into caller memory
+class PackReader {
+public:
+    struct Read
+    {
+        uint32_t entry;
+        void* dst;          // entry( entry ).size bytes
+    };
+
+private:
+    int _fd;
+    const uint8_t* _map;
+    size_t _mapSize;
+    const PackHeader* _header;
+    const PackEntry* _entries;
+    const PackChunk* _chunks;
+    const char* _names;
+
+public:
+    PackReader();
+    ~PackReader();
+
+    PackReader( const PackReader& ) = delete;
+    PackReader& operator=( const PackReader& ) = delete;
+
+    // validates the toc, chunk data is only checked as it is read
+    bool open( const char* path );
+    void close();
+
+    uint32_t entryCount() const { return _header ? _header->entryCount : 0; }
+    const PackEntry& entry( uint32_t index ) const { return _entries[ index ]; }
+    const char* name( uint32_t index ) const { return _names + _entries[ index ].nameOffset; }
+    // -1 when there is no such entry
+    int find( const char* name ) const;
+
+    // the bytes of a stored entry inside the mapping, nullptr for compressed ones
+    const void* mapped( uint32_t index ) const;
+
+    // all chunks of all reads go to the job system together, so many small entries
+    // spread as well as one big one. false on a checksum mismatch or a corrupt chunk
+    bool read( JobSystem& jobs, const Read* reads, size_t count, bool verify = true );
+    bool read( JobSystem& jobs, uint32_t index, void* dst, bool verify = true );
+};
+
+
+#endif //METAL_PLAYGROUND_PACK_FILE_HPP
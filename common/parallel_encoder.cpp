@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file           : parallel_encoder.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "parallel_encoder.hpp"
+
+#include <algorithm>
+
+std::vector<DrawRange> partitionDraws( size_t drawCount, size_t partitionCount, size_t minDraws )
+{
+    std::vector<DrawRange> ranges;
+    if ( drawCount == 0 )
+    {
+        return ranges;
+    }
+
+    minDraws = std::max<size_t>( minDraws, 1 );
+    partitionCount = std::clamp<size_t>( drawCount / minDraws, 1, std::max<size_t>( partitionCount, 1 ) );
+
+    const size_t base = drawCount / partitionCount;
+    const size_t remainder = drawCount % partitionCount;
+
+    ranges.reserve( partitionCount );
+    size_t begin = 0;
+    for ( size_t i = 0; i < partitionCount; ++i )
+    {
+        // the first `remainder` ranges take one extra draw
+        const size_t size = base + ( i < remainder ? 1 : 0 );
+        ranges.push_back( { begin, begin + size } );
+        begin += size;
+    }
+
+    return ranges;
+}
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file           : parallel_encoder.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_PARALLEL_ENCODER_HPP
+#define METAL_PLAYGROUND_PARALLEL_ENCODER_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "job_system.hpp"
+
+struct DrawRange
+{
+    size_t begin;
+    size_t end;
+};
+
+// splits [0, drawCount) into at most partitionCount contiguous, ordered ranges.
+// sizes differ by at most one and no range is smaller than minDraws unless
+// there is only one. empty ranges are never returned.
+std::vector<DrawRange> partitionDraws( size_t drawCount, size_t partitionCount, size_t minDraws );
+
+// splits a draw list over the job system, one child encoder per range.
+// children are created up front on the calling thread: a parallel encoder
+// executes its children in creation order, so draw order is the list order
+// no matter which worker finishes first.
+//
+// ParallelEncoder only needs renderCommandEncoder(), its children only need
+// endEncoding(), so MTL::ParallelRenderCommandEncoder and a plain cpu stand-in
+// both fit. encode( child, begin, end ) records the draws of one range.
+template <typename ParallelEncoder, typename EncodeFn>
+size_t encodeParallel( JobSystem& jobs, ParallelEncoder* parallel, size_t drawCount, size_t minDraws, EncodeFn&& encode )
+{
+    using ChildEncoder = decltype( parallel->renderCommandEncoder() );
+
+    const std::vector<DrawRange> ranges = partitionDraws( drawCount, jobs.threadCount(), minDraws );
+
+    std::vector<ChildEncoder> children;
+    children.reserve( ranges.size() );
+    for ( size_t i = 0; i < ranges.size(); ++i )
+    {
+        children.push_back( parallel->renderCommandEncoder() );
+    }
+
+    jobs.parallelFor( ranges.size(), 1, [&]( size_t begin, size_t end ){
+        for ( size_t i = begin; i < end; ++i )
+        {
+            encode( children[ i ], ranges[ i ].begin, ranges[ i ].end );
+            children[ i ]->endEncoding();
+        }
+    } );
+
+    return ranges.size();
+}
+
+
+#endif //METAL_PLAYGROUND_PARALLEL_ENCODER_HPP
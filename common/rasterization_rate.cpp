@@ -0,0 +1,152 @@
+/**
+  ******************************************************************************
+  * @file           : rasterization_rate.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "rasterization_rate.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+RateMapSettings makeRateMapSettings( uint32_t columns, uint32_t rows ) {
+    RateMapSettings settings;
+    settings.columns = columns;
+    settings.rows = rows;
+    settings.minRate = 0.25f;
+    settings.focusRadius = 0.2f;
+    settings.focusFalloff = 0.5f;
+    settings.fullDensity = 0.5f;
+    return settings;
+}
+
+RateMapBuilder::RateMapBuilder( const RateMapSettings& settings )
+: _settings( settings )
+, _screenWidth( 0 )
+, _screenHeight( 0 )
+, _density( (size_t)settings.columns * settings.rows, 0.f )
+, _zoneRates( (size_t)settings.columns * settings.rows, 1.f )
+, _horizontal( settings.columns, 1.f )
+, _vertical( settings.rows, 1.f ) {
+    assert( settings.columns > 0 && settings.rows > 0 );
+    assert( settings.minRate > 0.f && settings.minRate <= 1.f );
+    assert( settings.fullDensity > 0.f );
+}
+
+void RateMapBuilder::beginFrame( uint32_t screenWidth, uint32_t screenHeight ) {
+    _screenWidth = screenWidth;
+    _screenHeight = screenHeight;
+    std::fill( _density.begin(), _density.end(), 0.f );
+}
+
+void RateMapBuilder::addContent( float u0, float v0, float u1, float v1, float weight ) {
+    u0 = std::clamp( u0, 0.f, 1.f );
+    v0 = std::clamp( v0, 0.f, 1.f );
+    u1 = std::clamp( u1, 0.f, 1.f );
+    v1 = std::clamp( v1, 0.f, 1.f );
+    if ( u1 <= u0 || v1 <= v0 )
+    {
+        return;
+    }
+
+    // in zone units the overlap with a zone is separable, the part of the zone's width
+    // covered times the part of its height
+    const float x0 = u0 * (float)_settings.columns;
+    const float x1 = u1 * (float)_settings.columns;
+    const float y0 = v0 * (float)_settings.rows;
+    const float y1 = v1 * (float)_settings.rows;
+    const uint32_t firstColumn = (uint32_t)x0;
+    const uint32_t lastColumn = std::min( (uint32_t)ceilf( x1 ), _settings.columns ) - 1;
+    const uint32_t firstRow = (uint32_t)y0;
+    const uint32_t lastRow = std::min( (uint32_t)ceilf( y1 ), _settings.rows ) - 1;
+
+    for ( uint32_t row = firstRow; row <= lastRow; ++row )
+    {
+        const float coveredY = std::min( y1, (float)( row + 1 ) ) - std::max( y0, (float)row );
+        float* density = &_density[ row * _settings.columns ];
+        for ( uint32_t column = firstColumn; column <= lastColumn; ++column )
+        {
+            const float coveredX = std::min( x1, (float)( column + 1 ) ) - std::max( x0, (float)column );
+            density[ column ] += weight * coveredX * coveredY;
+        }
+    }
+}
+
+void RateMapBuilder::build( float focusU, float focusV ) {
+    const float aspect = _screenHeight > 0 ? (float)_screenWidth / (float)_screenHeight : 1.f;
+    const float minRate = _settings.minRate;
+
+    std::fill( _horizontal.begin(), _horizontal.end(), minRate );
+    std::fill( _vertical.begin(), _vertical.end(), minRate );
+
+    for ( uint32_t row = 0; row < _settings.rows; ++row )
+    {
+        // distances to the nearest point of the zone, so a zone the focus circle touches
+        // is at full rate all over
+        const float top = (float)row / (float)_settings.rows;
+        const float bottom = (float)( row + 1 ) / (float)_settings.rows;
+        const float dy = std::max( { top - focusV, focusV - bottom, 0.f } );
+
+        for ( uint32_t column = 0; column < _settings.columns; ++column )
+        {
+            const float left = (float)column / (float)_settings.columns;
+            const float right = (float)( column + 1 ) / (float)_settings.columns;
+            const float dx = std::max( { left - focusU, focusU - right, 0.f } ) * aspect;
+
+            const float distance = sqrtf( dx * dx + dy * dy );
+            const float t = _settings.focusFalloff > 0.f ? ( distance - _settings.focusRadius ) / _settings.focusFalloff : ( distance > _settings.focusRadius ? 1.f : 0.f );
+            const float focusRate = 1.f - ( 1.f - minRate ) * std::clamp( t, 0.f, 1.f );
+
+            const size_t zone = (size_t)row * _settings.columns + column;
+            const float content = std::min( _density[ zone ] / _settings.fullDensity, 1.f );
+            const float contentRate = minRate + ( 1.f - minRate ) * content;
+
+            const float rate = std::max( focusRate * contentRate, minRate );
+            _zoneRates[ zone ] = rate;
+            _horizontal[ column ] = std::max( _horizontal[ column ], rate );
+            _vertical[ row ] = std::max( _vertical[ row ], rate );
+        }
+    }
+}
+
+ShadingCost RateMapBuilder::estimateCost() const {
+    ShadingCost cost = {};
+
+    // zones split the screen evenly, the last ones take what does not divide
+    auto zoneEdge = []( uint32_t index, uint32_t count, uint32_t pixels ) {
+        return (double)( (uint64_t)index * pixels / count );
+    };
+
+    double physicalWidth = 0.0;
+    for ( uint32_t column = 0; column < _settings.columns; ++column )
+    {
+        const double width = zoneEdge( column + 1, _settings.columns, _screenWidth ) - zoneEdge( column, _settings.columns, _screenWidth );
+        physicalWidth += width * _horizontal[ column ];
+    }
+    double physicalHeight = 0.0;
+    for ( uint32_t row = 0; row < _settings.rows; ++row )
+    {
+        const double height = zoneEdge( row + 1, _settings.rows, _screenHeight ) - zoneEdge( row, _settings.rows, _screenHeight );
+        physicalHeight += height * _vertical[ row ];
+
+        for ( uint32_t column = 0; column < _settings.columns; ++column )
+        {
+            const double width = zoneEdge( column + 1, _settings.columns, _screenWidth ) - zoneEdge( column, _settings.columns, _screenWidth );
+            const double fragments = width * height * _density[ (size_t)row * _settings.columns + column ];
+            cost.screenFragments += fragments;
+            cost.shadedFragments += fragments * _horizontal[ column ] * _vertical[ row ];
+        }
+    }
+
+    cost.reduction = cost.screenFragments > 0.0 ? 1.0 - cost.shadedFragments / cost.screenFragments : 0.0;
+    cost.physicalWidth = (uint32_t)ceil( physicalWidth );
+    cost.physicalHeight = (uint32_t)ceil( physicalHeight );
+    return cost;
+}
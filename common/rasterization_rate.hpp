@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file           : rasterization_rate.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RASTERIZATION_RATE_HPP
+#define METAL_PLAYGROUND_RASTERIZATION_RATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct RateMapSettings
+{
+    uint32_t columns, rows;     // zones of the map, at most the device's maxSampleCount
+    float minRate;              // lowest rate per axis, 1 shades every pixel
+    float focusRadius;          // full rate this far from the focus, in screen heights
+    float focusFalloff;         // then down to minRate over this distance
+    float fullDensity;          // content per zone that keeps full rate, in layers of coverage
+};
+
+// 16 x 9 zones, a quarter rate per axis at the edges and in empty zones
+RateMapSettings makeRateMapSettings( uint32_t columns, uint32_t rows );
+
+struct ShadingCost
+{
+    double screenFragments;     // fragments a pass at full rate shades, zone pixels times density
+    double shadedFragments;     // the same with the map's rates
+    double reduction;           // 1 - shaded / screen
+    uint32_t physicalWidth;     // size of the target the map renders into
+    uint32_t physicalHeight;
+};
+
+// builds the rates of a rasterization rate map from a focus point and the content on
+// screen. every zone wants the focus rate, falling off with the distance from the focus,
+// times a content rate that grows with the layers of geometry drawn into it. metal's maps
+// are separable, a rate per column and one per row, so each takes the highest rate any
+// of its zones wants: no zone gets less than it asked for.
+class RateMapBuilder {
+private:
+    RateMapSettings _settings;
+    uint32_t _screenWidth, _screenHeight;
+
+    // columns x rows, row major from the top left
+    std::vector<float> _density;
+    std::vector<float> _zoneRates;
+    std::vector<float> _horizontal;
+    std::vector<float> _vertical;
+
+public:
+    explicit RateMapBuilder( const RateMapSettings& settings );
+
+    RateMapBuilder( const RateMapBuilder& ) = delete;
+    RateMapBuilder& operator=( const RateMapBuilder& ) = delete;
+
+    // clears the content of the last frame
+    void beginFrame( uint32_t screenWidth, uint32_t screenHeight );
+
+    // a rect of geometry in screen uv, 0..1 from the top left, e.g. the bounds of an
+    // instance that passed culling. the zones it overlaps get weight layers of content
+    // for the part of them it covers
+    void addContent( float u0, float v0, float u1, float v1, float weight );
+
+    // the rates for a focus point in screen uv
+    void build( float focusU, float focusV );
+
+    // what the rates save on the content added this frame, pixels not covered by any
+    // content cost nothing either way
+    ShadingCost estimateCost() const;
+
+    const RateMapSettings& settings() const { return _settings; }
+    const float* horizontal() const { return _horizontal.data(); }
+    const float* vertical() const { return _vertical.data(); }
+    float density( uint32_t column, uint32_t row ) const { return _density[ row * _settings.columns + column ]; }
+    float zoneRate( uint32_t column, uint32_t row ) const { return _zoneRates[ row * _settings.columns + column ]; }
+};
+
+
+#endif //METAL_PLAYGROUND_RASTERIZATION_RATE_HPP
@@ -0,0 +1,164 @@
+/**
+  ******************************************************************************
+  * @file           : render_graph.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "render_graph.hpp"
+
+#include <cassert>
+
+static MTL::TextureDescriptor* makeTextureDescriptor( const RenderGraphTextureDesc& desc )
+{
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::texture2DDescriptor( desc.pixelFormat, desc.width, desc.height, false );
+    pTextureDesc->setStorageMode( MTL::StorageModePrivate );
+    pTextureDesc->setUsage( desc.usage );
+    return pTextureDesc;
+}
+
+RenderGraph::RenderGraph( size_t frameSlots )
+: _heaps(frameSlots, nullptr) {
+}
+
+RenderGraph::~RenderGraph() {
+    for ( MTL::Heap* heap : _heaps )
+    {
+        if ( heap )
+        {
+            heap->release();
+        }
+    }
+}
+
+void RenderGraph::reset() {
+    _plan.reset();
+    _resources.clear();
+    _execute.clear();
+}
+
+RenderGraph::Handle RenderGraph::addResource( const char* name, bool imported, const Resource& resource ) {
+    const Handle h = _plan.addResource( name, imported );
+    _resources.push_back( resource );
+    assert( h == _resources.size() - 1 );
+    return h;
+}
+
+RenderGraph::Handle RenderGraph::createTexture( const char* name, const RenderGraphTextureDesc& desc ) {
+    Resource r = {};
+    r.isBuffer = false;
+    r.textureDesc = desc;
+    return addResource( name, false, r );
+}
+
+RenderGraph::Handle RenderGraph::createBuffer( const char* name, size_t length ) {
+    Resource r = {};
+    r.isBuffer = true;
+    r.bufferLength = length;
+    return addResource( name, false, r );
+}
+
+RenderGraph::Handle RenderGraph::importTexture( const char* name, MTL::Texture* texture ) {
+    Resource r = {};
+    r.isBuffer = false;
+    r.texture = texture;
+    return addResource( name, true, r );
+}
+
+RenderGraph::Handle RenderGraph::addPass( const char* name, ExecuteFn execute ) {
+    const Handle h = _plan.addPass( name );
+    _execute.push_back( std::move( execute ) );
+    assert( h == _execute.size() - 1 );
+    return h;
+}
+
+bool RenderGraph::compile( const SizeFn& sizeOf ) {
+    return _plan.compile( [&]( Handle h ) {
+        const MTL::SizeAndAlign sa = sizeOf( _resources[ h ] );
+        return RenderGraphSizeAndAlign{ sa.size, sa.align };
+    } );
+}
+
+bool RenderGraph::compile( MTL::Device* device ) {
+    return compile( [device]( const Resource& r ) {
+        if ( r.isBuffer )
+        {
+            return device->heapBufferSizeAndAlign( r.bufferLength, MTL::ResourceStorageModePrivate );
+        }
+        MTL::TextureDescriptor* pTextureDesc = makeTextureDescriptor( r.textureDesc );
+        MTL::SizeAndAlign sa = device->heapTextureSizeAndAlign( pTextureDesc );
+        return sa;
+    } );
+}
+
+void RenderGraph::execute( MTL::Device* device, MTL::CommandBuffer* cmd, size_t frameSlot ) {
+    assert( _plan.compiled() && frameSlot < _heaps.size() );
+
+    const size_t peakBytes = _plan.peakBytes();
+    MTL::Heap*& heap = _heaps[ frameSlot ];
+    if ( peakBytes > 0 && ( !heap || heap->size() < peakBytes ) )
+    {
+        if ( heap )
+        {
+            heap->release();
+        }
+
+        MTL::HeapDescriptor* pHeapDesc = MTL::HeapDescriptor::alloc()->init();
+        pHeapDesc->setType( MTL::HeapTypePlacement );
+        pHeapDesc->setStorageMode( MTL::StorageModePrivate );
+        // tracked: the aliased resources are ordered by the heap itself, no fences needed
+        pHeapDesc->setHazardTrackingMode( MTL::HazardTrackingModeTracked );
+        pHeapDesc->setSize( peakBytes );
+        heap = device->newHeap( pHeapDesc );
+        pHeapDesc->release();
+    }
+
+    for ( size_t i = 0; i < _resources.size(); ++i )
+    {
+        const RenderGraphPlan::Resource& placed = _plan.resource( (Handle)i );
+        if ( placed.imported || placed.firstUse < 0 )
+        {
+            continue;
+        }
+
+        Resource& r = _resources[ i ];
+        if ( r.isBuffer )
+        {
+            r.buffer = heap->newBuffer( r.bufferLength, MTL::ResourceStorageModePrivate, placed.offset );
+        }
+        else
+        {
+            MTL::TextureDescriptor* pTextureDesc = makeTextureDescriptor( r.textureDesc );
+            r.texture = heap->newTexture( pTextureDesc, placed.offset );
+        }
+    }
+
+    for ( Handle h : _plan.order() )
+    {
+        _execute[ h ]( *this, cmd );
+    }
+
+    for ( size_t i = 0; i < _resources.size(); ++i )
+    {
+        if ( _plan.resource( (Handle)i ).imported )
+        {
+            continue;
+        }
+        Resource& r = _resources[ i ];
+        if ( r.buffer )
+        {
+            r.buffer->release();
+            r.buffer = nullptr;
+        }
+        if ( r.texture )
+        {
+            r.texture->release();
+            r.texture = nullptr;
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/**
+  ******************************************************************************
+  * @file           : render_graph.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDER_GRAPH_HPP
+#define METAL_PLAYGROUND_RENDER_GRAPH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <Metal/Metal.hpp>
+
+#include "render_graph_plan.hpp"
+
+struct RenderGraphTextureDesc
+{
+    uint32_t width;
+    uint32_t height;
+    MTL::PixelFormat pixelFormat;
+    MTL::TextureUsage usage;
+};
+
+// per frame graph of passes and the resources they read and write.
+// the frame is rebuilt from scratch every frame: reset(), declare, compile(), execute().
+//
+// culling, lifetimes and heap placement are RenderGraphPlan's, this adds the metal
+// resources and the pass callbacks under the same handles.
+class RenderGraph {
+public:
+    using Handle = RenderGraphPlan::Handle;
+    static constexpr Handle kInvalidHandle = RenderGraphPlan::kInvalidHandle;
+
+    using ExecuteFn = std::function<void(RenderGraph& graph, MTL::CommandBuffer* cmd)>;
+
+    struct Resource
+    {
+        bool isBuffer;
+        RenderGraphTextureDesc textureDesc;
+        size_t bufferLength;
+
+        // imported, or created by execute() for the current frame
+        MTL::Texture* texture;
+        MTL::Buffer* buffer;
+    };
+
+    // returns the heap size and alignment of a transient resource
+    using SizeFn = std::function<MTL::SizeAndAlign(const Resource& resource)>;
+
+private:
+    RenderGraphPlan _plan;
+    std::vector<Resource> _resources;
+    std::vector<ExecuteFn> _execute;
+
+    // one heap per frame in flight, so a frame never aliases memory the gpu still reads
+    std::vector<MTL::Heap*> _heaps;
+
+    Handle addResource( const char* name, bool imported, const Resource& resource );
+
+public:
+    explicit RenderGraph( size_t frameSlots );
+    ~RenderGraph();
+
+    RenderGraph( const RenderGraph& ) = delete;
+    RenderGraph& operator=( const RenderGraph& ) = delete;
+
+    void reset();
+
+    Handle createTexture( const char* name, const RenderGraphTextureDesc& desc );
+    Handle createBuffer( const char* name, size_t length );
+    Handle importTexture( const char* name, MTL::Texture* texture );
+
+    Handle addPass( const char* name, ExecuteFn execute );
+    void read( Handle pass, Handle resource ) { _plan.read( pass, resource ); }
+    void write( Handle pass, Handle resource ) { _plan.write( pass, resource ); }
+    void markSideEffect( Handle pass ) { _plan.markSideEffect( pass ); }
+
+    // false when a pass reads a transient resource before any pass writes it
+    bool compile( const SizeFn& sizeOf );
+    bool compile( MTL::Device* device );
+
+    // allocates the transient resources out of the heap for frameSlot and
+    // runs the live passes in order. transient resources are released again
+    // before returning, the command buffer keeps what it uses alive.
+    void execute( MTL::Device* device, MTL::CommandBuffer* cmd, size_t frameSlot );
+
+    MTL::Texture* texture( Handle resource ) const { return _resources[ resource ].texture; }
+    MTL::Buffer* buffer( Handle resource ) const { return _resources[ resource ].buffer; }
+
+    const RenderGraphPlan& plan() const { return _plan; }
+    const std::vector<Handle>& order() const { return _plan.order(); }
+    const RenderGraphPlan::Pass& pass( Handle pass ) const { return _plan.pass( pass ); }
+    const Resource& resource( Handle resource ) const { return _resources[ resource ]; }
+
+    size_t passCount() const { return _plan.passCount(); }
+    size_t culledPassCount() const { return _plan.culledPassCount(); }
+
+    // heap bytes with aliasing vs. every transient resource getting its own memory
+    size_t peakBytes() const { return _plan.peakBytes(); }
+    size_t unaliasedBytes() const { return _plan.unaliasedBytes(); }
+};
+
+
+#endif //METAL_PLAYGROUND_RENDER_GRAPH_HPP
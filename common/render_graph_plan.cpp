@@ -0,0 +1,249 @@
+/**
+  ******************************************************************************
+  * @file           : render_graph_plan.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "render_graph_plan.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+static size_t alignUp( size_t value, size_t align )
+{
+    return align ? ( value + align - 1 ) / align * align : value;
+}
+
+RenderGraphPlan::RenderGraphPlan()
+: _peakBytes(0)
+, _unaliasedBytes(0)
+, _compiled(false) {
+}
+
+void RenderGraphPlan::reset() {
+    _resources.clear();
+    _passes.clear();
+    _order.clear();
+    _peakBytes = 0;
+    _unaliasedBytes = 0;
+    _compiled = false;
+}
+
+RenderGraphPlan::Handle RenderGraphPlan::addResource( const char* name, bool imported ) {
+    Resource r = {};
+    r.name = name;
+    r.imported = imported;
+    r.firstUse = -1;
+    r.lastUse = -1;
+    _resources.push_back( r );
+    return (Handle)( _resources.size() - 1 );
+}
+
+RenderGraphPlan::Handle RenderGraphPlan::addPass( const char* name ) {
+    Pass p;
+    p.name = name;
+    p.sideEffect = false;
+    p.live = false;
+    _passes.push_back( std::move( p ) );
+    return (Handle)( _passes.size() - 1 );
+}
+
+void RenderGraphPlan::read( Handle pass, Handle resource ) {
+    assert( pass < _passes.size() && resource < _resources.size() );
+    _passes[ pass ].reads.push_back( resource );
+}
+
+void RenderGraphPlan::write( Handle pass, Handle resource ) {
+    assert( pass < _passes.size() && resource < _resources.size() );
+    _passes[ pass ].writes.push_back( resource );
+    if ( _resources[ resource ].imported )
+    {
+        // results leave the graph, whoever writes them has to run
+        _passes[ pass ].sideEffect = true;
+    }
+}
+
+void RenderGraphPlan::markSideEffect( Handle pass ) {
+    _passes[ pass ].sideEffect = true;
+}
+
+bool RenderGraphPlan::validate() const {
+    std::vector<bool> written( _resources.size(), false );
+    for ( const Pass& p : _passes )
+    {
+        for ( Handle r : p.reads )
+        {
+            if ( !_resources[ r ].imported && !written[ r ] )
+            {
+                __builtin_printf( "render graph: pass %s reads %s before any pass writes it\n",
+                                  p.name.c_str(), _resources[ r ].name.c_str() );
+                return false;
+            }
+        }
+        for ( Handle w : p.writes )
+        {
+            written[ w ] = true;
+        }
+    }
+    return true;
+}
+
+void RenderGraphPlan::cull() {
+    // passes can only consume what earlier passes produced, so walking the
+    // declaration order backwards visits every consumer before its producers
+    std::vector<bool> needed( _resources.size(), false );
+
+    for ( size_t i = _passes.size(); i-- > 0; )
+    {
+        Pass& p = _passes[ i ];
+
+        p.live = p.sideEffect;
+        for ( Handle w : p.writes )
+        {
+            p.live = p.live || needed[ w ];
+        }
+        if ( !p.live )
+        {
+            continue;
+        }
+
+        // a write may only touch part of a resource, earlier writers stay needed
+        for ( Handle r : p.reads )
+        {
+            needed[ r ] = true;
+        }
+        for ( Handle w : p.writes )
+        {
+            needed[ w ] = true;
+        }
+    }
+
+    _order.clear();
+    for ( size_t i = 0; i < _passes.size(); ++i )
+    {
+        if ( _passes[ i ].live )
+        {
+            _order.push_back( (Handle)i );
+        }
+    }
+}
+
+void RenderGraphPlan::computeLifetimes() {
+    for ( Resource& r : _resources )
+    {
+        r.firstUse = -1;
+        r.lastUse = -1;
+    }
+
+    for ( int step = 0; step < (int)_order.size(); ++step )
+    {
+        const Pass& p = _passes[ _order[ step ] ];
+        auto touch = [&]( Handle h ) {
+            Resource& r = _resources[ h ];
+            if ( r.firstUse < 0 )
+            {
+                r.firstUse = step;
+            }
+            r.lastUse = step;
+        };
+        std::for_each( p.reads.begin(), p.reads.end(), touch );
+        std::for_each( p.writes.begin(), p.writes.end(), touch );
+    }
+}
+
+void RenderGraphPlan::placeResources() {
+    std::vector<Handle> transients;
+    for ( size_t i = 0; i < _resources.size(); ++i )
+    {
+        if ( !_resources[ i ].imported && _resources[ i ].firstUse >= 0 )
+        {
+            transients.push_back( (Handle)i );
+        }
+    }
+
+    // biggest first leaves the smaller ones to fill the gaps
+    std::sort( transients.begin(), transients.end(), [this]( Handle a, Handle b ) {
+        const Resource& ra = _resources[ a ];
+        const Resource& rb = _resources[ b ];
+        return ra.size != rb.size ? ra.size > rb.size : a < b;
+    } );
+
+    struct Interval
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    std::vector<Handle> placed;
+    std::vector<Interval> busy;
+    _peakBytes = 0;
+    _unaliasedBytes = 0;
+
+    for ( Handle h : transients )
+    {
+        Resource& r = _resources[ h ];
+
+        // memory held by resources alive at the same time as this one
+        busy.clear();
+        for ( Handle other : placed )
+        {
+            const Resource& o = _resources[ other ];
+            if ( o.firstUse <= r.lastUse && r.firstUse <= o.lastUse )
+            {
+                busy.push_back( { o.offset, o.offset + o.size } );
+            }
+        }
+        std::sort( busy.begin(), busy.end(), []( const Interval& a, const Interval& b ) { return a.begin < b.begin; } );
+
+        // lowest aligned gap that fits
+        size_t offset = 0;
+        for ( const Interval& interval : busy )
+        {
+            if ( alignUp( offset, r.align ) + r.size <= interval.begin )
+            {
+                break;
+            }
+            offset = std::max( offset, interval.end );
+        }
+        r.offset = alignUp( offset, r.align );
+
+        placed.push_back( h );
+        _peakBytes = std::max( _peakBytes, r.offset + r.size );
+        _unaliasedBytes = alignUp( _unaliasedBytes, r.align ) + r.size;
+    }
+}
+
+bool RenderGraphPlan::compile( const SizeFn& sizeOf ) {
+    _compiled = false;
+    if ( !validate() )
+    {
+        _order.clear();
+        _peakBytes = 0;
+        _unaliasedBytes = 0;
+        return false;
+    }
+
+    cull();
+    computeLifetimes();
+
+    for ( size_t i = 0; i < _resources.size(); ++i )
+    {
+        Resource& r = _resources[ i ];
+        if ( !r.imported && r.firstUse >= 0 )
+        {
+            const RenderGraphSizeAndAlign sa = sizeOf( (Handle)i );
+            r.size = sa.size;
+            r.align = std::max<size_t>( sa.align, 1 );
+        }
+    }
+
+    placeResources();
+    _compiled = true;
+    return true;
+}
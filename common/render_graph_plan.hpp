@@ -0,0 +1,111 @@
+/**
+  ******************************************************************************
+  * @file           : render_graph_plan.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDER_GRAPH_PLAN_HPP
+#define METAL_PLAYGROUND_RENDER_GRAPH_PLAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct RenderGraphSizeAndAlign
+{
+    size_t size;
+    size_t align;
+};
+
+// the metal free half of RenderGraph: passes, the resources they read and write, and
+// what compile() makes of them. resources are names with a size here, RenderGraph
+// keeps what they are on the gpu next to them under the same handles.
+//
+// compile() culls every pass that does not contribute to a side effect (writing an
+// imported resource, or markSideEffect()), computes the lifetime of every transient
+// resource over the surviving passes and packs them into one placement heap,
+// letting resources whose lifetimes do not overlap share memory.
+class RenderGraphPlan {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle kInvalidHandle = ~0u;
+
+    struct Resource
+    {
+        std::string name;
+        bool imported;
+
+        // filled by compile()
+        size_t size;
+        size_t align;
+        size_t offset;
+        int firstUse;
+        int lastUse;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        std::vector<Handle> reads;
+        std::vector<Handle> writes;
+        bool sideEffect;
+        bool live;
+    };
+
+    // returns the heap size and alignment of a transient resource
+    using SizeFn = std::function<RenderGraphSizeAndAlign(Handle resource)>;
+
+private:
+    std::vector<Resource> _resources;
+    std::vector<Pass> _passes;
+    std::vector<Handle> _order;
+
+    size_t _peakBytes;
+    size_t _unaliasedBytes;
+    bool _compiled;
+
+    bool validate() const;
+    void cull();
+    void computeLifetimes();
+    void placeResources();
+
+public:
+    RenderGraphPlan();
+
+    void reset();
+
+    Handle addResource( const char* name, bool imported );
+    Handle addPass( const char* name );
+    void read( Handle pass, Handle resource );
+    void write( Handle pass, Handle resource );
+    void markSideEffect( Handle pass );
+
+    // sizeOf is only asked for the transient resources a live pass uses. passes run in
+    // declaration order, so a pass reading a transient resource no earlier pass writes
+    // is an error: compile() then returns false and plans nothing
+    bool compile( const SizeFn& sizeOf );
+    bool compiled() const { return _compiled; }
+
+    const std::vector<Handle>& order() const { return _order; }
+    const Pass& pass( Handle pass ) const { return _passes[ pass ]; }
+    const Resource& resource( Handle resource ) const { return _resources[ resource ]; }
+
+    size_t passCount() const { return _passes.size(); }
+    size_t resourceCount() const { return _resources.size(); }
+    size_t culledPassCount() const { return _passes.size() - _order.size(); }
+
+    // heap bytes with aliasing vs. every transient resource getting its own memory
+    size_t peakBytes() const { return _peakBytes; }
+    size_t unaliasedBytes() const { return _unaliasedBytes; }
+};
+
+
+#endif //METAL_PLAYGROUND_RENDER_GRAPH_PLAN_HPP
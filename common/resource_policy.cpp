@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file           : resource_policy.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "resource_policy.hpp"
+
+StoragePolicy chooseStoragePolicy( ResourceUsage usage, bool unifiedMemory )
+{
+    switch ( usage )
+    {
+        case ResourceUsage::Static:
+            return { ResourceStorage::Private, true, false };
+
+        case ResourceUsage::Dynamic:
+            if ( unifiedMemory )
+            {
+                return { ResourceStorage::Shared, false, false };
+            }
+            return { ResourceStorage::Managed, false, true };
+
+        case ResourceUsage::Streaming:
+            // read about once per write, a gpu side copy would cost more than it saves
+            return { ResourceStorage::Shared, false, false };
+
+        case ResourceUsage::Readback:
+            if ( unifiedMemory )
+            {
+                return { ResourceStorage::Shared, false, false };
+            }
+            return { ResourceStorage::Managed, false, true };
+    }
+    return { ResourceStorage::Shared, false, false };
+}
+
+StoragePolicy chooseTexturePolicy( ResourceUsage usage, bool unifiedMemory )
+{
+    const StoragePolicy policy = chooseStoragePolicy( usage, unifiedMemory );
+    if ( policy.storage == ResourceStorage::Shared && !unifiedMemory )
+    {
+        return { ResourceStorage::Managed, false, true };
+    }
+    return policy;
+}
+
+const char* resourceUsageName( ResourceUsage usage )
+{
+    switch ( usage )
+    {
+        case ResourceUsage::Static: return "static";
+        case ResourceUsage::Dynamic: return "dynamic";
+        case ResourceUsage::Streaming: return "streaming";
+        case ResourceUsage::Readback: return "readback";
+    }
+    return "unknown";
+}
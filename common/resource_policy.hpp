@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file           : resource_policy.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RESOURCE_POLICY_HPP
+#define METAL_PLAYGROUND_RESOURCE_POLICY_HPP
+
+// how the cpu and gpu are going to use a resource over its lifetime
+enum class ResourceUsage
+{
+    Static,     // written once at load, read by the gpu from then on
+    Dynamic,    // rewritten now and then, read by the gpu over many frames
+    Streaming,  // rewritten by the cpu every frame, read once or twice
+    Readback,   // written by the gpu, read back on the cpu
+};
+
+// the MTL::StorageMode a policy picks, with the same values
+enum class ResourceStorage
+{
+    Shared = 0,
+    Managed = 1,
+    Private = 2,
+};
+
+struct StoragePolicy
+{
+    ResourceStorage storage;
+    // initial data goes through a staging buffer and a blit, the cpu never maps it
+    bool staged;
+    // managed: didModifyRange() after cpu writes, synchronizeResource() before cpu reads
+    bool synchronized;
+};
+
+// unifiedMemory is MTL::Device::hasUnifiedMemory(). without it managed resources
+// keep a gpu side copy, which pays off for data the gpu reads more than once.
+StoragePolicy chooseStoragePolicy( ResourceUsage usage, bool unifiedMemory );
+
+// the same for textures, which a discrete gpu does not take in shared memory
+StoragePolicy chooseTexturePolicy( ResourceUsage usage, bool unifiedMemory );
+
+const char* resourceUsageName( ResourceUsage usage );
+
+
+#endif //METAL_PLAYGROUND_RESOURCE_POLICY_HPP
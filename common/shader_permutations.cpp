@@ -0,0 +1,144 @@
+/**
+  ******************************************************************************
+  * @file           : shader_permutations.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "shader_permutations.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+ShaderFeatures PermutationSpace::addFeature( const char* name ) {
+    assert( _names.size() < kMaxShaderFeatures );
+    _names.emplace_back( name );
+    _requires.push_back( 0 );
+    _excludes.push_back( 0 );
+    return 1u << ( _names.size() - 1 );
+}
+
+void PermutationSpace::require( ShaderFeatures features, ShaderFeatures dependencies ) {
+    for ( uint32_t i = 0; i < _names.size(); ++i )
+    {
+        if ( features & ( 1u << i ) )
+        {
+            _requires[ i ] |= dependencies;
+        }
+    }
+}
+
+void PermutationSpace::exclude( ShaderFeatures a, ShaderFeatures b ) {
+    for ( uint32_t i = 0; i < _names.size(); ++i )
+    {
+        if ( a & ( 1u << i ) )
+        {
+            _excludes[ i ] |= b;
+        }
+        if ( b & ( 1u << i ) )
+        {
+            _excludes[ i ] |= a;
+        }
+    }
+}
+
+ShaderFeatures PermutationSpace::allFeatures() const {
+    return _names.size() == kMaxShaderFeatures ? ~0u : ( 1u << _names.size() ) - 1;
+}
+
+bool PermutationSpace::isValid( ShaderFeatures features ) const {
+    if ( features & ~allFeatures() )
+    {
+        return false;
+    }
+    for ( uint32_t i = 0; i < _names.size(); ++i )
+    {
+        if ( !( features & ( 1u << i ) ) )
+        {
+            continue;
+        }
+        if ( ( features & _requires[ i ] ) != _requires[ i ] || ( features & _excludes[ i ] ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<ShaderFeatures> PermutationSpace::enumerate() const {
+    assert( _names.size() < kMaxShaderFeatures );
+    std::vector<ShaderFeatures> variants;
+    for ( ShaderFeatures f = 0; f <= allFeatures(); ++f )
+    {
+        if ( isValid( f ) )
+        {
+            variants.push_back( f );
+        }
+    }
+    return variants;
+}
+
+std::vector<ShaderFeatures> PermutationSpace::prune( const ShaderFeatures* used, size_t count ) const {
+    std::vector<ShaderFeatures> variants;
+    for ( size_t i = 0; i < count; ++i )
+    {
+        if ( isValid( used[ i ] ) )
+        {
+            variants.push_back( used[ i ] );
+        }
+        else
+        {
+            __builtin_printf( "shader permutation %s is not valid, skipped\n", describe( used[ i ] ).c_str() );
+        }
+    }
+    std::sort( variants.begin(), variants.end() );
+    variants.erase( std::unique( variants.begin(), variants.end() ), variants.end() );
+    return variants;
+}
+
+std::string PermutationSpace::describe( ShaderFeatures features ) const {
+    std::string s;
+    for ( uint32_t i = 0; i < kMaxShaderFeatures; ++i )
+    {
+        if ( !( features & ( 1u << i ) ) )
+        {
+            continue;
+        }
+        if ( !s.empty() )
+        {
+            s += '|';
+        }
+        s += i < _names.size() ? _names[ i ] : "bit" + std::to_string( i );
+    }
+    return s.empty() ? "none" : s;
+}
+
+uint64_t shaderHash( const void* data, size_t size, uint64_t seed )
+{
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t h = seed;
+    for ( size_t i = 0; i < size; ++i )
+    {
+        h ^= p[ i ];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t shaderHash( const char* str, uint64_t seed )
+{
+    return shaderHash( str, strlen( str ), seed );
+}
+
+size_t ShaderVariantKeyHash::operator()( const ShaderVariantKey& key ) const {
+    // the program hash is already well mixed, stir the feature bits in
+    uint64_t h = key.program ^ ( (uint64_t)key.features * 0x9e3779b97f4a7c15ull );
+    h ^= h >> 32;
+    return (size_t)h;
+}
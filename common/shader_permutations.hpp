@@ -0,0 +1,196 @@
+/**
+  ******************************************************************************
+  * @file           : shader_permutations.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SHADER_PERMUTATIONS_HPP
+#define METAL_PLAYGROUND_SHADER_PERMUTATIONS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// one bit per feature, bit i is function constant i in the shader
+using ShaderFeatures = uint32_t;
+
+static constexpr uint32_t kMaxShaderFeatures = 32;
+
+// the features a program has and the rules between them. of the 2^n combinations
+// only the valid ones can become variants, and only the ones materials ask for
+// are worth compiling up front.
+class PermutationSpace {
+private:
+    std::vector<std::string> _names;
+    std::vector<ShaderFeatures> _requires;   // per feature, bits that have to be set with it
+    std::vector<ShaderFeatures> _excludes;   // per feature, bits that can not be set with it
+
+public:
+    // returns the feature bit
+    ShaderFeatures addFeature( const char* name );
+
+    // every feature in features needs all of dependencies
+    void require( ShaderFeatures features, ShaderFeatures dependencies );
+    // a and b never appear together
+    void exclude( ShaderFeatures a, ShaderFeatures b );
+
+    size_t featureCount() const { return _names.size(); }
+    ShaderFeatures allFeatures() const;
+    const char* featureName( uint32_t index ) const { return _names[ index ].c_str(); }
+
+    bool isValid( ShaderFeatures features ) const;
+    // every valid combination, in increasing order
+    std::vector<ShaderFeatures> enumerate() const;
+    // the valid, distinct combinations out of used, in increasing order
+    std::vector<ShaderFeatures> prune( const ShaderFeatures* used, size_t count ) const;
+
+    // "TEXTURED|LIT", "none" for no features
+    std::string describe( ShaderFeatures features ) const;
+};
+
+// fnv-1a
+uint64_t shaderHash( const void* data, size_t size, uint64_t seed = 14695981039346656037ull );
+uint64_t shaderHash( const char* str, uint64_t seed = 14695981039346656037ull );
+
+struct ShaderVariantKey
+{
+    uint64_t program;   // hash of everything but the features, functions, formats...
+    ShaderFeatures features;
+
+    bool operator==( const ShaderVariantKey& o ) const { return program == o.program && features == o.features; }
+};
+
+struct ShaderVariantKeyHash
+{
+    size_t operator()( const ShaderVariantKey& key ) const;
+};
+
+// variants by key, compiled the first time they are asked for. nothing here knows
+// about metal, the compile callback does the work. a compile that fails returns T{},
+// which is not cached: the next get tries again.
+template <typename T>
+class VariantCache {
+private:
+    std::unordered_map<ShaderVariantKey, T, ShaderVariantKeyHash> _variants;
+    size_t _hits = 0;
+    size_t _misses = 0;
+
+public:
+    template <typename Compile>
+    T get( const ShaderVariantKey& key, Compile&& compile ) {
+        auto it = _variants.find( key );
+        if ( it != _variants.end() )
+        {
+            ++_hits;
+            return it->second;
+        }
+        ++_misses;
+        T variant = compile( key );
+        if ( variant != T{} )
+        {
+            _variants.emplace( key, variant );
+        }
+        return variant;
+    }
+
+    const T* find( const ShaderVariantKey& key ) const {
+        auto it = _variants.find( key );
+        return it == _variants.end() ? nullptr : &it->second;
+    }
+
+    template <typename Fn>
+    void forEach( Fn&& fn ) const {
+        for ( const auto& v : _variants )
+        {
+            fn( v.first, v.second );
+        }
+    }
+
+    void clear() { _variants.clear(); }
+
+    size_t size() const { return _variants.size(); }
+    size_t hits() const { return _hits; }
+    size_t misses() const { return _misses; }
+};
+
+// the variants of one program: validity, caching, prewarming and compile time. the
+// compile callback turns a valid feature set into a variant and release frees one,
+// ShaderVariants plugs metal pipelines in, the tests a stub compiler.
+template <typename T>
+class ShaderVariantSet {
+public:
+    using CompileFn = std::function<T( ShaderFeatures features )>;
+    using ReleaseFn = std::function<void( T variant )>;
+
+private:
+    const PermutationSpace& _space;
+    uint64_t _program;
+    CompileFn _compile;
+    ReleaseFn _release;
+
+    VariantCache<T> _cache;
+    double _compileSeconds;
+
+public:
+    ShaderVariantSet( const PermutationSpace& space, uint64_t program, CompileFn compile, ReleaseFn release )
+    : _space( space )
+    , _program( program )
+    , _compile( std::move( compile ) )
+    , _release( std::move( release ) )
+    , _compileSeconds( 0.0 ) {
+    }
+
+    ~ShaderVariantSet() {
+        _cache.forEach( [this]( const ShaderVariantKey&, T variant ) {
+            _release( variant );
+        } );
+    }
+
+    ShaderVariantSet( const ShaderVariantSet& ) = delete;
+    ShaderVariantSet& operator=( const ShaderVariantSet& ) = delete;
+
+    // compiled on first use, which stalls the frame asking for it. a feature set the
+    // space does not allow gives T{} without compiling, so does a failed compile
+    T get( ShaderFeatures features ) {
+        if ( !_space.isValid( features ) )
+        {
+            __builtin_printf( "shader variant %s is not valid\n", _space.describe( features ).c_str() );
+            return T{};
+        }
+        return _cache.get( { _program, features }, [this]( const ShaderVariantKey& key ) {
+            auto begin = std::chrono::steady_clock::now();
+            T variant = _compile( key.features );
+            _compileSeconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+            return variant;
+        } );
+    }
+
+    // compiles the pruned set of used up front, returns how many variants that is
+    size_t prewarm( const ShaderFeatures* used, size_t count ) {
+        const std::vector<ShaderFeatures> variants = _space.prune( used, count );
+        for ( ShaderFeatures f : variants )
+        {
+            get( f );
+        }
+        return variants.size();
+    }
+
+    uint64_t program() const { return _program; }
+    size_t compiledCount() const { return _cache.size(); }
+    size_t hits() const { return _cache.hits(); }
+    size_t misses() const { return _cache.misses(); }
+    double compileSeconds() const { return _compileSeconds; }
+};
+
+
+#endif //METAL_PLAYGROUND_SHADER_PERMUTATIONS_HPP
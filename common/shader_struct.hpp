@@ -0,0 +1,152 @@
+/**
+  ******************************************************************************
+  * @file           : shader_struct.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SHADER_STRUCT_HPP
+#define METAL_PLAYGROUND_SHADER_STRUCT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined( __APPLE__ )
+#include <simd/simd.h>
+#endif
+
+// structs shared between c++ and msl, written once as a field list:
+//
+//   #define CAMERA_DATA_FIELDS( F ) F( float4x4, perspectiveTransform ) F( float3x3, worldNormalTransform )
+//
+//   SHADER_STRUCT( CameraData, CAMERA_DATA_FIELDS )
+//
+// declares struct CameraData for the host and kCameraDataSource, the msl
+// definition to prepend to the shader source. every field is checked at compile
+// time against the msl size and alignment of its type, so the host struct can
+// not drift from what the shader reads. field types are msl type names, the
+// packed_ ones drop the vector alignment and are how a struct is shrunk.
+//
+// the checks need nothing from the apple sdks and also run in a linux build.
+
+namespace shader_layout
+{
+    // msl name, size, alignment, from the metal shading language spec
+#define SHADER_LAYOUT_TYPES( X )     \
+    X( float, 4, 4 )                 \
+    X( float2, 8, 8 )                \
+    X( float3, 16, 16 )              \
+    X( float4, 16, 16 )              \
+    X( packed_float2, 8, 4 )         \
+    X( packed_float3, 12, 4 )        \
+    X( packed_float4, 16, 4 )        \
+    X( float3x3, 48, 16 )            \
+    X( float4x4, 64, 16 )            \
+    X( int, 4, 4 )                   \
+    X( int2, 8, 8 )                  \
+    X( int4, 16, 16 )                \
+    X( uint, 4, 4 )                  \
+    X( uint2, 8, 8 )                 \
+    X( uint4, 16, 16 )               \
+    X( ushort, 2, 2 )                \
+    X( ushort2, 4, 4 )               \
+    X( ushort4, 8, 8 )               \
+    X( uchar4, 4, 4 )
+
+    // stand-in with the msl size and alignment of a type
+    template <size_t Size, size_t Align>
+    struct alignas( Align ) MslStorage
+    {
+        unsigned char bytes[ Size ];
+    };
+
+#define SHADER_LAYOUT_MSL_TYPE( type, size, align ) using msl_##type = MslStorage<size, align>;
+    SHADER_LAYOUT_TYPES( SHADER_LAYOUT_MSL_TYPE )
+#undef SHADER_LAYOUT_MSL_TYPE
+
+    struct PackedFloat2 { float x, y; };
+    struct PackedFloat3 { float x, y, z; };
+    struct PackedFloat4 { float x, y, z, w; };
+
+    // host types, the simd ones where there are any
+    using host_float = float;
+    using host_int = int32_t;
+    using host_uint = uint32_t;
+    using host_ushort = uint16_t;
+    using host_packed_float2 = PackedFloat2;
+    using host_packed_float3 = PackedFloat3;
+    using host_packed_float4 = PackedFloat4;
+
+#if defined( __APPLE__ )
+    using host_float2 = simd::float2;
+    using host_float3 = simd::float3;
+    using host_float4 = simd::float4;
+    using host_float3x3 = simd::float3x3;
+    using host_float4x4 = simd::float4x4;
+    using host_int2 = simd::int2;
+    using host_int4 = simd::int4;
+    using host_uint2 = simd::uint2;
+    using host_uint4 = simd::uint4;
+    using host_ushort2 = simd::ushort2;
+    using host_ushort4 = simd::ushort4;
+    using host_uchar4 = simd::uchar4;
+#else
+    // same size, alignment and component names as the simd types, enough to check
+    // layouts and for common code that only reads and writes components
+    struct alignas( 8 ) host_float2 { float x, y; };
+    struct alignas( 16 ) host_float3 { float x, y, z; };
+    struct alignas( 16 ) host_float4 { float x, y, z, w; };
+    struct host_float3x3 { host_float3 columns[ 3 ]; };
+    struct host_float4x4 { host_float4 columns[ 4 ]; };
+    struct alignas( 8 ) host_int2 { int32_t x, y; };
+    struct alignas( 16 ) host_int4 { int32_t x, y, z, w; };
+    struct alignas( 8 ) host_uint2 { uint32_t x, y; };
+    struct alignas( 16 ) host_uint4 { uint32_t x, y, z, w; };
+    struct alignas( 4 ) host_ushort2 { uint16_t x, y; };
+    struct alignas( 8 ) host_ushort4 { uint16_t x, y, z, w; };
+    struct alignas( 4 ) host_uchar4 { uint8_t x, y, z, w; };
+#endif
+
+    // a host type that differs from msl breaks every struct using it, catch it here
+#define SHADER_LAYOUT_CHECK_TYPE( type, size, align )                                  \
+    static_assert( sizeof( host_##type ) == size && alignof( host_##type ) == align,    \
+                   "host " #type " does not match the msl layout" );
+    SHADER_LAYOUT_TYPES( SHADER_LAYOUT_CHECK_TYPE )
+#undef SHADER_LAYOUT_CHECK_TYPE
+}
+
+#define SHADER_STRUCT_HOST_FIELD( type, name ) shader_layout::host_##type name;
+#define SHADER_STRUCT_MSL_FIELD( type, name ) shader_layout::msl_##type name;
+#define SHADER_STRUCT_SOURCE_FIELD( type, name ) "    " #type " " #name ";\n"
+#define SHADER_STRUCT_CHECK_FIELD( type, name ) \
+    static_assert( offsetof( Host, name ) == offsetof( Msl, name ), #name " offset differs from msl" );
+
+// the mirror lays out the msl types with the same rules msl uses, natural
+// alignment and the size rounded up to the largest member alignment
+#define SHADER_STRUCT( name, FIELDS )                                                       \
+    struct name                                                                             \
+    {                                                                                       \
+        FIELDS( SHADER_STRUCT_HOST_FIELD )                                                  \
+    };                                                                                      \
+    struct name##MslLayout                                                                  \
+    {                                                                                       \
+        FIELDS( SHADER_STRUCT_MSL_FIELD )                                                   \
+    };                                                                                      \
+    struct name##LayoutCheck                                                                \
+    {                                                                                       \
+        using Host = name;                                                                  \
+        using Msl = name##MslLayout;                                                        \
+        FIELDS( SHADER_STRUCT_CHECK_FIELD )                                                 \
+        static_assert( sizeof( Host ) == sizeof( Msl ), #name " size differs from msl" );   \
+        static_assert( alignof( Host ) == alignof( Msl ), #name " alignment differs from msl" ); \
+    };                                                                                      \
+    inline constexpr const char k##name##Source[] =                                         \
+        "struct " #name "\n{\n" FIELDS( SHADER_STRUCT_SOURCE_FIELD ) "};\n"
+
+
+#endif //METAL_PLAYGROUND_SHADER_STRUCT_HPP
@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file           : shader_variants.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "shader_variants.hpp"
+
+
+// everything but the features, two programs with the same hash share variants
+static uint64_t programHash( const ShaderProgramDesc& desc )
+{
+    uint64_t h = shaderHash( desc.vertexFunction );
+    h = shaderHash( desc.fragmentFunction, h );
+    h = shaderHash( &desc.colorFormat, sizeof( desc.colorFormat ), h );
+    h = shaderHash( &desc.depthFormat, sizeof( desc.depthFormat ), h );
+    return h;
+}
+
+ShaderVariants::ShaderVariants( MTL::Device* device, MTL::Library* library, const PermutationSpace& space, const ShaderProgramDesc& desc )
+: _device(device->retain())
+, _library(library->retain())
+, _space(space)
+, _desc(desc)
+, _variants(space, programHash( desc ),
+            [this]( ShaderFeatures features ) { return compile( features ); },
+            []( MTL::RenderPipelineState* pso ) { pso->release(); }) {
+}
+
+ShaderVariants::~ShaderVariants() {
+    // the variants are a member, they release their pipelines after this body
+    _library->release();
+    _device->release();
+}
+
+MTL::RenderPipelineState* ShaderVariants::compile( ShaderFeatures features ) {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    // every constant gets a value, an undefined one would fail the specialisation
+    MTL::FunctionConstantValues* constants = MTL::FunctionConstantValues::alloc()->init();
+    for ( uint32_t i = 0; i < _space.featureCount(); ++i )
+    {
+        const bool enabled = ( features & ( 1u << i ) ) != 0;
+        constants->setConstantValue( &enabled, MTL::DataTypeBool, i );
+    }
+
+    NS::Error* error = nullptr;
+    MTL::Function* vertexFn = _library->newFunction( NS::String::string( _desc.vertexFunction, UTF8StringEncoding ), constants, &error );
+    MTL::Function* fragFn = vertexFn ? _library->newFunction( NS::String::string( _desc.fragmentFunction, UTF8StringEncoding ), constants, &error ) : nullptr;
+    constants->release();
+    if ( !vertexFn || !fragFn )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        if ( vertexFn )
+        {
+            vertexFn->release();
+        }
+        return nullptr;
+    }
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction( vertexFn );
+    desc->setFragmentFunction( fragFn );
+    desc->colorAttachments()->object( 0 )->setPixelFormat( _desc.colorFormat );
+    desc->setDepthAttachmentPixelFormat( _desc.depthFormat );
+
+    MTL::RenderPipelineState* pso = _device->newRenderPipelineState( desc, &error );
+    if ( !pso )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+
+    return pso;
+}
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file           : shader_variants.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SHADER_VARIANTS_HPP
+#define METAL_PLAYGROUND_SHADER_VARIANTS_HPP
+
+#include <Metal/Metal.hpp>
+
+#include "shader_permutations.hpp"
+
+struct ShaderProgramDesc
+{
+    const char* vertexFunction;
+    const char* fragmentFunction;
+    MTL::PixelFormat colorFormat;
+    MTL::PixelFormat depthFormat;
+};
+
+// render pipelines of one program, specialised through function constants. feature
+// bit i is set as the bool function constant at index i, so the shader declares
+//
+//   constant bool kTextured [[function_constant(0)]];
+//
+// and branches on it; the compiler strips whatever the variant does not use.
+class ShaderVariants {
+private:
+    MTL::Device* _device;
+    MTL::Library* _library;
+    const PermutationSpace& _space;
+    ShaderProgramDesc _desc;
+
+    ShaderVariantSet<MTL::RenderPipelineState*> _variants;
+
+    MTL::RenderPipelineState* compile( ShaderFeatures features );
+
+public:
+    ShaderVariants( MTL::Device* device, MTL::Library* library, const PermutationSpace& space, const ShaderProgramDesc& desc );
+    ~ShaderVariants();
+
+    ShaderVariants( const ShaderVariants& ) = delete;
+    ShaderVariants& operator=( const ShaderVariants& ) = delete;
+
+    // compiled on first use, which stalls the frame asking for it. nullptr for a
+    // feature set the space does not allow or a pipeline that fails to build
+    MTL::RenderPipelineState* get( ShaderFeatures features ) { return _variants.get( features ); }
+
+    // compiles the pruned set of used up front, returns how many variants that is
+    size_t prewarm( const ShaderFeatures* used, size_t count ) { return _variants.prewarm( used, count ); }
+
+    size_t compiledCount() const { return _variants.compiledCount(); }
+    size_t hits() const { return _variants.hits(); }
+    size_t misses() const { return _variants.misses(); }
+    double compileSeconds() const { return _variants.compileSeconds(); }
+};
+
+
+#endif //METAL_PLAYGROUND_SHADER_VARIANTS_HPP
@@ -0,0 +1,238 @@
+/**
+  ******************************************************************************
+  * @file           : shadow_cascades.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "shadow_cascades.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+// radii are rounded up to this, so float noise in the fit never changes the box size
+static constexpr float kRadiusStep = 1.f / 16.f;
+
+// 4 casters at once, the width of sse and neon
+static constexpr int kLanes = 4;
+typedef float Float4 __attribute__(( vector_size( 16 ) ));
+typedef int32_t Int4 __attribute__(( vector_size( 16 ) ));
+
+static Float4 splat( float v )
+{
+    return Float4{ v, v, v, v };
+}
+
+static Float4 load4( const float* p )
+{
+    Float4 v;
+    memcpy( &v, p, sizeof( v ) );
+    return v;
+}
+
+static Float4 abs4( Float4 v )
+{
+    return v < 0.f ? -v : v;
+}
+
+static bool anyLane( Int4 mask )
+{
+    return ( mask[ 0 ] | mask[ 1 ] | mask[ 2 ] | mask[ 3 ] ) != 0;
+}
+
+static float dot3( const float* a, const float* b )
+{
+    return a[ 0 ] * b[ 0 ] + a[ 1 ] * b[ 1 ] + a[ 2 ] * b[ 2 ];
+}
+
+static void cross3( const float* a, const float* b, float* out )
+{
+    out[ 0 ] = a[ 1 ] * b[ 2 ] - a[ 2 ] * b[ 1 ];
+    out[ 1 ] = a[ 2 ] * b[ 0 ] - a[ 0 ] * b[ 2 ];
+    out[ 2 ] = a[ 0 ] * b[ 1 ] - a[ 1 ] * b[ 0 ];
+}
+
+static void normalize3( float* v )
+{
+    const float s = 1.f / sqrtf( dot3( v, v ) );
+    v[ 0 ] *= s;
+    v[ 1 ] *= s;
+    v[ 2 ] *= s;
+}
+
+// a view space point back to world space. the world transform is usually rigid, but
+// a general inverse costs little once per frame
+static void viewToWorld( const float m[ 16 ], const float p[ 3 ], float out[ 3 ] )
+{
+    float inv[ 16 ];
+    inv[ 0 ] = m[ 5 ] * m[ 10 ] * m[ 15 ] - m[ 5 ] * m[ 11 ] * m[ 14 ] - m[ 9 ] * m[ 6 ] * m[ 15 ] + m[ 9 ] * m[ 7 ] * m[ 14 ] + m[ 13 ] * m[ 6 ] * m[ 11 ] - m[ 13 ] * m[ 7 ] * m[ 10 ];
+    inv[ 4 ] = -m[ 4 ] * m[ 10 ] * m[ 15 ] + m[ 4 ] * m[ 11 ] * m[ 14 ] + m[ 8 ] * m[ 6 ] * m[ 15 ] - m[ 8 ] * m[ 7 ] * m[ 14 ] - m[ 12 ] * m[ 6 ] * m[ 11 ] + m[ 12 ] * m[ 7 ] * m[ 10 ];
+    inv[ 8 ] = m[ 4 ] * m[ 9 ] * m[ 15 ] - m[ 4 ] * m[ 11 ] * m[ 13 ] - m[ 8 ] * m[ 5 ] * m[ 15 ] + m[ 8 ] * m[ 7 ] * m[ 13 ] + m[ 12 ] * m[ 5 ] * m[ 11 ] - m[ 12 ] * m[ 7 ] * m[ 9 ];
+    inv[ 12 ] = -m[ 4 ] * m[ 9 ] * m[ 14 ] + m[ 4 ] * m[ 10 ] * m[ 13 ] + m[ 8 ] * m[ 5 ] * m[ 14 ] - m[ 8 ] * m[ 6 ] * m[ 13 ] - m[ 12 ] * m[ 5 ] * m[ 10 ] + m[ 12 ] * m[ 6 ] * m[ 9 ];
+    inv[ 1 ] = -m[ 1 ] * m[ 10 ] * m[ 15 ] + m[ 1 ] * m[ 11 ] * m[ 14 ] + m[ 9 ] * m[ 2 ] * m[ 15 ] - m[ 9 ] * m[ 3 ] * m[ 14 ] - m[ 13 ] * m[ 2 ] * m[ 11 ] + m[ 13 ] * m[ 3 ] * m[ 10 ];
+    inv[ 5 ] = m[ 0 ] * m[ 10 ] * m[ 15 ] - m[ 0 ] * m[ 11 ] * m[ 14 ] - m[ 8 ] * m[ 2 ] * m[ 15 ] + m[ 8 ] * m[ 3 ] * m[ 14 ] + m[ 12 ] * m[ 2 ] * m[ 11 ] - m[ 12 ] * m[ 3 ] * m[ 10 ];
+    inv[ 9 ] = -m[ 0 ] * m[ 9 ] * m[ 15 ] + m[ 0 ] * m[ 11 ] * m[ 13 ] + m[ 8 ] * m[ 1 ] * m[ 15 ] - m[ 8 ] * m[ 3 ] * m[ 13 ] - m[ 12 ] * m[ 1 ] * m[ 11 ] + m[ 12 ] * m[ 3 ] * m[ 9 ];
+    inv[ 13 ] = m[ 0 ] * m[ 9 ] * m[ 14 ] - m[ 0 ] * m[ 10 ] * m[ 13 ] - m[ 8 ] * m[ 1 ] * m[ 14 ] + m[ 8 ] * m[ 2 ] * m[ 13 ] + m[ 12 ] * m[ 1 ] * m[ 10 ] - m[ 12 ] * m[ 2 ] * m[ 9 ];
+    inv[ 2 ] = m[ 1 ] * m[ 6 ] * m[ 15 ] - m[ 1 ] * m[ 7 ] * m[ 14 ] - m[ 5 ] * m[ 2 ] * m[ 15 ] + m[ 5 ] * m[ 3 ] * m[ 14 ] + m[ 13 ] * m[ 2 ] * m[ 7 ] - m[ 13 ] * m[ 3 ] * m[ 6 ];
+    inv[ 6 ] = -m[ 0 ] * m[ 6 ] * m[ 15 ] + m[ 0 ] * m[ 7 ] * m[ 14 ] + m[ 4 ] * m[ 2 ] * m[ 15 ] - m[ 4 ] * m[ 3 ] * m[ 14 ] - m[ 12 ] * m[ 2 ] * m[ 7 ] + m[ 12 ] * m[ 3 ] * m[ 6 ];
+    inv[ 10 ] = m[ 0 ] * m[ 5 ] * m[ 15 ] - m[ 0 ] * m[ 7 ] * m[ 13 ] - m[ 4 ] * m[ 1 ] * m[ 15 ] + m[ 4 ] * m[ 3 ] * m[ 13 ] + m[ 12 ] * m[ 1 ] * m[ 7 ] - m[ 12 ] * m[ 3 ] * m[ 5 ];
+    inv[ 14 ] = -m[ 0 ] * m[ 5 ] * m[ 14 ] + m[ 0 ] * m[ 6 ] * m[ 13 ] + m[ 4 ] * m[ 1 ] * m[ 14 ] - m[ 4 ] * m[ 2 ] * m[ 13 ] - m[ 12 ] * m[ 1 ] * m[ 6 ] + m[ 12 ] * m[ 2 ] * m[ 5 ];
+    inv[ 3 ] = -m[ 1 ] * m[ 6 ] * m[ 11 ] + m[ 1 ] * m[ 7 ] * m[ 10 ] + m[ 5 ] * m[ 2 ] * m[ 11 ] - m[ 5 ] * m[ 3 ] * m[ 10 ] - m[ 9 ] * m[ 2 ] * m[ 7 ] + m[ 9 ] * m[ 3 ] * m[ 6 ];
+    inv[ 7 ] = m[ 0 ] * m[ 6 ] * m[ 11 ] - m[ 0 ] * m[ 7 ] * m[ 10 ] - m[ 4 ] * m[ 2 ] * m[ 11 ] + m[ 4 ] * m[ 3 ] * m[ 10 ] + m[ 8 ] * m[ 2 ] * m[ 7 ] - m[ 8 ] * m[ 3 ] * m[ 6 ];
+    inv[ 11 ] = -m[ 0 ] * m[ 5 ] * m[ 11 ] + m[ 0 ] * m[ 7 ] * m[ 9 ] + m[ 4 ] * m[ 1 ] * m[ 11 ] - m[ 4 ] * m[ 3 ] * m[ 9 ] - m[ 8 ] * m[ 1 ] * m[ 7 ] + m[ 8 ] * m[ 3 ] * m[ 5 ];
+    inv[ 15 ] = m[ 0 ] * m[ 5 ] * m[ 10 ] - m[ 0 ] * m[ 6 ] * m[ 9 ] - m[ 4 ] * m[ 1 ] * m[ 10 ] + m[ 4 ] * m[ 2 ] * m[ 9 ] + m[ 8 ] * m[ 1 ] * m[ 6 ] - m[ 8 ] * m[ 2 ] * m[ 5 ];
+
+    const float det = m[ 0 ] * inv[ 0 ] + m[ 1 ] * inv[ 4 ] + m[ 2 ] * inv[ 8 ] + m[ 3 ] * inv[ 12 ];
+    assert( det != 0.f );
+
+    float h[ 4 ];
+    for ( int r = 0; r < 4; ++r )
+    {
+        h[ r ] = ( inv[ r ] * p[ 0 ] + inv[ 4 + r ] * p[ 1 ] + inv[ 8 + r ] * p[ 2 ] + inv[ 12 + r ] ) / det;
+    }
+    out[ 0 ] = h[ 0 ] / h[ 3 ];
+    out[ 1 ] = h[ 1 ] / h[ 3 ];
+    out[ 2 ] = h[ 2 ] / h[ 3 ];
+}
+
+void fitShadowCascades( const float perspective[ 16 ], const float world[ 16 ], const float lightDirection[ 3 ],
+                        const ShadowCascadeSettings& settings, ShadowCascade* cascades ) {
+    assert( settings.cascadeCount > 0 && settings.cascadeCount <= kMaxShadowCascades );
+    assert( settings.resolution > 2 );
+
+    // the frustum from the projection: x and y grow by these per unit of depth, and
+    // metal's 0..1 depth puts near and far at m[ 14 ] / m[ 10 ] and m[ 14 ] / ( m[ 10 ] + 1 )
+    const float xs = 1.f / perspective[ 0 ];
+    const float ys = 1.f / perspective[ 5 ];
+    const float nearZ = perspective[ 14 ] / perspective[ 10 ];
+    const float farZ = perspective[ 10 ] + 1.f != 0.f ? perspective[ 14 ] / ( perspective[ 10 ] + 1.f ) : INFINITY;
+    const float endZ = std::min( farZ, settings.maxDistance );
+    const float spread = xs * xs + ys * ys;
+
+    float forward[ 3 ] = { lightDirection[ 0 ], lightDirection[ 1 ], lightDirection[ 2 ] };
+    normalize3( forward );
+    const float worldUp[ 3 ] = { 0.f, 1.f, 0.f };
+    const float worldForward[ 3 ] = { 0.f, 0.f, 1.f };
+    float right[ 3 ], up[ 3 ];
+    cross3( forward, fabsf( forward[ 1 ] ) < 0.99f ? worldUp : worldForward, right );
+    normalize3( right );
+    cross3( right, forward, up );
+
+    const uint32_t count = settings.cascadeCount;
+    float splitNear = nearZ;
+    for ( uint32_t i = 0; i < count; ++i )
+    {
+        // practical split scheme, a blend of logarithmic and even splits
+        const float t = (float)( i + 1 ) / (float)count;
+        const float logSplit = nearZ * powf( endZ / nearZ, t );
+        const float evenSplit = nearZ + ( endZ - nearZ ) * t;
+        const float splitFar = i + 1 == count ? endZ : settings.splitLambda * logSplit + ( 1.f - settings.splitLambda ) * evenSplit;
+
+        // smallest sphere around the slice: on the view axis, equally far from the near
+        // and far corners, or around the far cap when the slice is wide
+        float centerDepth = ( spread + 1.f ) * ( splitNear + splitFar ) * 0.5f;
+        float radius;
+        if ( centerDepth >= splitFar )
+        {
+            centerDepth = splitFar;
+            radius = sqrtf( spread ) * splitFar;
+        }
+        else
+        {
+            radius = sqrtf( spread * splitFar * splitFar + ( splitFar - centerDepth ) * ( splitFar - centerDepth ) );
+        }
+        radius = ceilf( radius / kRadiusStep ) * kRadiusStep;
+
+        // snapping moves the box by up to a texel, the one texel border keeps the slice inside
+        const float texelSize = 2.f * radius / (float)( settings.resolution - 2 );
+        radius += texelSize;
+
+        const float viewCenter[ 3 ] = { 0.f, 0.f, -centerDepth };
+        float worldCenter[ 3 ];
+        viewToWorld( world, viewCenter, worldCenter );
+
+        // the box moves in whole texels, so it samples the scene on the same grid every frame
+        const float cx = floorf( dot3( right, worldCenter ) / texelSize ) * texelSize;
+        const float cy = floorf( dot3( up, worldCenter ) / texelSize ) * texelSize;
+        const float cz = dot3( forward, worldCenter );
+
+        ShadowCascade& c = cascades[ i ];
+        c.splitNear = splitNear;
+        c.splitFar = splitFar;
+        c.radius = radius;
+        c.texelSize = texelSize;
+        c.center[ 0 ] = cx;
+        c.center[ 1 ] = cy;
+        c.center[ 2 ] = cz;
+        memcpy( c.right, right, sizeof( right ) );
+        memcpy( c.up, up, sizeof( up ) );
+        memcpy( c.forward, forward, sizeof( forward ) );
+
+        // rows x = ( right.p - cx ) / r, y = ( up.p - cy ) / r, z = ( forward.p - cz + r ) / 2r
+        float* m = c.viewProjection;
+        const float invR = 1.f / radius;
+        const float invDepth = 0.5f / radius;
+        for ( int k = 0; k < 3; ++k )
+        {
+            m[ k * 4 + 0 ] = right[ k ] * invR;
+            m[ k * 4 + 1 ] = up[ k ] * invR;
+            m[ k * 4 + 2 ] = forward[ k ] * invDepth;
+            m[ k * 4 + 3 ] = 0.f;
+        }
+        m[ 12 ] = -cx * invR;
+        m[ 13 ] = -cy * invR;
+        m[ 14 ] = ( radius - cz ) * invDepth;
+        m[ 15 ] = 1.f;
+
+        splitNear = splitFar;
+    }
+}
+
+size_t cullShadowCasters( const ShadowCascade& cascade, const ShadowCasters& casters, uint32_t* visible ) {
+    const float* r = cascade.right;
+    const float* u = cascade.up;
+    const float* f = cascade.forward;
+    const float* c = cascade.center;
+
+    // light space position against the box, open on the side towards the light
+    size_t n = 0;
+    size_t i = 0;
+    for ( ; i + kLanes <= casters.count; i += kLanes )
+    {
+        const Float4 x = load4( casters.x + i );
+        const Float4 y = load4( casters.y + i );
+        const Float4 z = load4( casters.z + i );
+        const Float4 reach = load4( casters.radius + i ) + splat( cascade.radius );
+        const Float4 lx = x * splat( r[ 0 ] ) + y * splat( r[ 1 ] ) + z * splat( r[ 2 ] ) - splat( c[ 0 ] );
+        const Float4 ly = x * splat( u[ 0 ] ) + y * splat( u[ 1 ] ) + z * splat( u[ 2 ] ) - splat( c[ 1 ] );
+        const Float4 lz = x * splat( f[ 0 ] ) + y * splat( f[ 1 ] ) + z * splat( f[ 2 ] ) - splat( c[ 2 ] );
+        const Int4 keep = ( abs4( lx ) <= reach ) & ( abs4( ly ) <= reach ) & ( lz <= reach );
+        if ( !anyLane( keep ) )
+        {
+            continue;
+        }
+        for ( int lane = 0; lane < kLanes; ++lane )
+        {
+            // branch free append, the slot past the last kept one is overwritten next time
+            visible[ n ] = (uint32_t)( i + lane );
+            n += keep[ lane ] & 1;
+        }
+    }
+    for ( ; i < casters.count; ++i )
+    {
+        const float p[ 3 ] = { casters.x[ i ], casters.y[ i ], casters.z[ i ] };
+        const float reach = casters.radius[ i ] + cascade.radius;
+        if ( fabsf( dot3( r, p ) - c[ 0 ] ) <= reach && fabsf( dot3( u, p ) - c[ 1 ] ) <= reach && dot3( f, p ) - c[ 2 ] <= reach )
+        {
+            visible[ n++ ] = (uint32_t)i;
+        }
+    }
+    return n;
+}
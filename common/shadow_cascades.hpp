@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file           : shadow_cascades.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SHADOW_CASCADES_HPP
+#define METAL_PLAYGROUND_SHADOW_CASCADES_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+static constexpr uint32_t kMaxShadowCascades = 4;
+
+struct ShadowCascadeSettings
+{
+    uint32_t cascadeCount;      // up to kMaxShadowCascades
+    uint32_t resolution;        // texels along a side of every cascade's map
+    float maxDistance;          // view depth the last cascade ends at
+    float splitLambda;          // 0 splits the depth range evenly, 1 logarithmically
+};
+
+// one cascade: an orthographic box around the bounding sphere of a slice of the
+// camera frustum, looking along the light
+struct ShadowCascade
+{
+    float viewProjection[ 16 ]; // world to the cascade's clip space, z 0..1 like metal
+    float splitNear;            // view depths the cascade covers
+    float splitFar;
+    float radius;               // half the box's width in world units, the sphere plus a texel
+    float texelSize;            // world units per shadow map texel
+    float center[ 3 ];          // box centre in light space, snapped to whole texels
+    float right[ 3 ];           // light space axes in world space, forward is where the light goes
+    float up[ 3 ];
+    float forward[ 3 ];
+};
+
+// fits the cascades to the frustum of a camera, given as the samples' CameraData
+// perspectiveTransform and worldTransform (column major like simd, world to view).
+// the boxes are stable: a sphere's radius does not change when the camera turns, and
+// the box centre only moves in whole texels, so shadow edges do not shimmer when the
+// camera moves. that costs resolution against a tight fit.
+void fitShadowCascades( const float perspective[ 16 ], const float world[ 16 ], const float lightDirection[ 3 ],
+                        const ShadowCascadeSettings& settings, ShadowCascade* cascades );
+
+// bounding spheres of the shadow casters in world space, as structure of arrays
+// so 4 of them are tested at once
+struct ShadowCasters
+{
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* radius;
+    size_t count;
+};
+
+// writes the indices of the casters that can shadow something in the cascade, in
+// order, and returns how many. the box is open towards the light: casters in front of
+// it still throw shadows into it, so draw with DepthClipModeClamp, which flattens
+// them onto the near plane.
+size_t cullShadowCasters( const ShadowCascade& cascade, const ShadowCasters& casters, uint32_t* visible );
+
+
+#endif //METAL_PLAYGROUND_SHADOW_CASCADES_HPP
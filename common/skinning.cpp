@@ -0,0 +1,119 @@
+/**
+  ******************************************************************************
+  * @file           : skinning.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "skinning.hpp"
+#include "job_system.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+using shader_layout::host_float4x4;
+
+static constexpr size_t kSkinningGrain = 1024;
+
+// a matrix column at a time, the width of sse and neon
+typedef float Float4 __attribute__(( vector_size( 16 ) ));
+
+static Float4 splat( float v )
+{
+    return Float4{ v, v, v, v };
+}
+
+static Float4 column( const host_float4x4& m, int c )
+{
+    Float4 v;
+    memcpy( &v, &m.columns[ c ], sizeof( v ) );
+    return v;
+}
+
+static Float4 cross3( Float4 a, Float4 b )
+{
+    return Float4{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0], 0.f };
+}
+
+static host_float4x4 multiply( const host_float4x4& a, const host_float4x4& b )
+{
+    const Float4 a0 = column( a, 0 ), a1 = column( a, 1 ), a2 = column( a, 2 ), a3 = column( a, 3 );
+    host_float4x4 m;
+    for ( int c = 0; c < 4; ++c )
+    {
+        const Float4 bc = column( b, c );
+        const Float4 r = a0 * splat( bc[0] ) + a1 * splat( bc[1] ) + a2 * splat( bc[2] ) + a3 * splat( bc[3] );
+        memcpy( &m.columns[ c ], &r, sizeof( r ) );
+    }
+    return m;
+}
+
+Skeleton::Skeleton( const int* parents, const host_float4x4* inverseBind, size_t jointCount )
+: _parents(parents, parents + jointCount)
+, _inverseBind(inverseBind, inverseBind + jointCount)
+, _global(jointCount) {
+    for ( size_t j = 0; j < jointCount; ++j )
+    {
+        assert( _parents[ j ] < (int)j );
+    }
+}
+
+void Skeleton::computePalette( const Transform* localPose, host_float4x4* outPalette ) {
+    for ( size_t j = 0; j < _parents.size(); ++j )
+    {
+        const host_float4x4 local = AnimationSampler::toMatrix( localPose[ j ] );
+        const int parent = _parents[ j ];
+        _global[ j ] = parent < 0 ? local : multiply( _global[ parent ], local );
+        outPalette[ j ] = multiply( _global[ j ], _inverseBind[ j ] );
+    }
+}
+
+void CpuSkinning::skin( const SkinnedVertex* vertices, size_t begin, size_t end,
+                        const host_float4x4* palette, SkinnedOutput* out ) {
+    for ( size_t i = begin; i < end; ++i )
+    {
+        const SkinnedVertex& v = vertices[ i ];
+
+        // blend the four matrices column by column, one float4 madd per column
+        const host_float4x4& m0 = palette[ v.joints.x ];
+        const host_float4x4& m1 = palette[ v.joints.y ];
+        const host_float4x4& m2 = palette[ v.joints.z ];
+        const host_float4x4& m3 = palette[ v.joints.w ];
+        const Float4 w0 = splat( v.weights.x ), w1 = splat( v.weights.y ), w2 = splat( v.weights.z ), w3 = splat( v.weights.w );
+
+        Float4 m[4];
+        for ( int c = 0; c < 4; ++c )
+        {
+            m[ c ] = column( m0, c ) * w0 + column( m1, c ) * w1 + column( m2, c ) * w2 + column( m3, c ) * w3;
+        }
+
+        const Float4 p = m[0] * splat( v.position.x ) + m[1] * splat( v.position.y ) + m[2] * splat( v.position.z ) + m[3];
+
+        // the cofactor columns are the inverse transpose times the determinant
+        const Float4 n = cross3( m[1], m[2] ) * splat( v.normal.x )
+                       + cross3( m[2], m[0] ) * splat( v.normal.y )
+                       + cross3( m[0], m[1] ) * splat( v.normal.z );
+        const float length = sqrtf( n[0] * n[0] + n[1] * n[1] + n[2] * n[2] );
+        const float scale = length > 0.f ? 1.f / length : 0.f;
+
+        out[ i ].position.x = p[0];
+        out[ i ].position.y = p[1];
+        out[ i ].position.z = p[2];
+        out[ i ].normal.x = n[0] * scale;
+        out[ i ].normal.y = n[1] * scale;
+        out[ i ].normal.z = n[2] * scale;
+    }
+}
+
+void CpuSkinning::skinParallel( JobSystem& jobs, const SkinnedVertex* vertices, size_t count,
+                                const host_float4x4* palette, SkinnedOutput* out ) {
+    jobs.parallelFor( count, kSkinningGrain, [&]( size_t begin, size_t end ){
+        skin( vertices, begin, end, palette, out );
+    } );
+}
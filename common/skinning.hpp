@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file           : skinning.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SKINNING_HPP
+#define METAL_PLAYGROUND_SKINNING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "animation.hpp"
+#include "shader_struct.hpp"
+
+class JobSystem;
+
+static constexpr size_t kMaxJointInfluences = 4;
+
+// same layout as the msl struct: float3, float3, ushort4, float4 -> 64 bytes
+struct SkinnedVertex
+{
+    shader_layout::host_float3 position;
+    shader_layout::host_float3 normal;
+    shader_layout::host_ushort4 joints;
+    shader_layout::host_float4 weights;
+};
+
+struct SkinnedOutput
+{
+    shader_layout::host_float3 position;
+    shader_layout::host_float3 normal;
+};
+
+class Skeleton {
+private:
+    // parents always come before their children, root has parent -1
+    std::vector<int> _parents;
+    std::vector<shader_layout::host_float4x4> _inverseBind;
+    std::vector<shader_layout::host_float4x4> _global;
+
+public:
+    Skeleton( const int* parents, const shader_layout::host_float4x4* inverseBind, size_t jointCount );
+
+    size_t jointCount() const { return _parents.size(); }
+
+    // palette[j] = global(j) * inverseBind(j), localPose is one Transform per joint
+    void computePalette( const Transform* localPose, shader_layout::host_float4x4* outPalette );
+};
+
+class CpuSkinning {
+public:
+    // linear blend skinning of [begin, end), the reference for the vertex shader.
+    // normals go through the inverse transpose of the blended matrix, its cofactors
+    // up to a scale the normalize drops, so non uniform joint scale keeps them
+    // perpendicular. palettes must not mirror, a negative determinant flips them
+    static void skin( const SkinnedVertex* vertices, size_t begin, size_t end,
+                      const shader_layout::host_float4x4* palette, SkinnedOutput* out );
+
+    // same thing spread over the job system
+    static void skinParallel( JobSystem& jobs, const SkinnedVertex* vertices, size_t count,
+                              const shader_layout::host_float4x4* palette, SkinnedOutput* out );
+};
+
+
+#endif //METAL_PLAYGROUND_SKINNING_HPP
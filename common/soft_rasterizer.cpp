@@ -0,0 +1,625 @@
+/**
+  ******************************************************************************
+  * @file           : soft_rasterizer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "soft_rasterizer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static constexpr uint32_t kBinSize = 64;
+static constexpr uint32_t kBlockSize = 8;
+static constexpr size_t kTriangleGrain = 1024;
+static constexpr size_t kInstanceGrain = 16;
+static constexpr size_t kSrgbTableSize = 4096;
+
+// 4 pixels at once, the width of sse and neon; wider gcc vectors get split into
+// element wise code on targets without avx
+static constexpr int kLanes = 4;
+typedef float Float4 __attribute__(( vector_size( 16 ) ));
+typedef int32_t Int4 __attribute__(( vector_size( 16 ) ));
+
+static const Float4 kLaneOffsets = { 0.f, 1.f, 2.f, 3.f };
+
+static Float4 splat( float v )
+{
+    return Float4{ v, v, v, v };
+}
+
+static Int4 splat( int32_t v )
+{
+    return Int4{ v, v, v, v };
+}
+
+static bool anyLane( Int4 mask )
+{
+    return ( mask[ 0 ] | mask[ 1 ] | mask[ 2 ] | mask[ 3 ] ) != 0;
+}
+
+static double secondsSince( std::chrono::steady_clock::time_point begin )
+{
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+}
+
+// out = a * b, 4x4 column major
+static void multiply4( const float* a, const float* b, float* out )
+{
+    for ( int c = 0; c < 4; ++c )
+    {
+        for ( int r = 0; r < 4; ++r )
+        {
+            out[ c * 4 + r ] = a[ r ] * b[ c * 4 ] + a[ 4 + r ] * b[ c * 4 + 1 ] + a[ 8 + r ] * b[ c * 4 + 2 ] + a[ 12 + r ] * b[ c * 4 + 3 ];
+        }
+    }
+}
+
+static void multiply3( const float* a, const float* b, float* out )
+{
+    for ( int c = 0; c < 3; ++c )
+    {
+        for ( int r = 0; r < 3; ++r )
+        {
+            out[ c * 3 + r ] = a[ r ] * b[ c * 3 ] + a[ 3 + r ] * b[ c * 3 + 1 ] + a[ 6 + r ] * b[ c * 3 + 2 ];
+        }
+    }
+}
+
+static uint8_t encodeUnorm( float v )
+{
+    return (uint8_t)( std::min( std::max( v, 0.f ), 1.f ) * 255.f + 0.5f );
+}
+
+// linear to srgb, indexed by the linear value in kSrgbTableSize steps
+static const uint8_t* srgbTable()
+{
+    static const std::vector<uint8_t> table = [] {
+        std::vector<uint8_t> t( kSrgbTableSize );
+        for ( size_t i = 0; i < kSrgbTableSize; ++i )
+        {
+            const float l = i / (float)( kSrgbTableSize - 1 );
+            const float s = l <= 0.0031308f ? l * 12.92f : 1.055f * powf( l, 1.f / 2.4f ) - 0.055f;
+            t[ i ] = encodeUnorm( s );
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+static uint8_t encodeSrgb( float v )
+{
+    return srgbTable()[ (size_t)( std::min( std::max( v, 0.f ), 1.f ) * ( kSrgbTableSize - 1 ) + 0.5f ) ];
+}
+
+static uint16_t encodeDepth( float z )
+{
+    return (uint16_t)( z * 65535.f + 0.5f );
+}
+
+static void sampleBilinear( const SoftTexture& t, float u, float v, float* out )
+{
+    const float fx = u * t.width - 0.5f;
+    const float fy = v * t.height - 0.5f;
+    const float x0f = floorf( fx );
+    const float y0f = floorf( fy );
+    const float tx = fx - x0f;
+    const float ty = fy - y0f;
+
+    auto wrap = []( float c, uint32_t size ) {
+        const int32_t i = (int32_t)fmodf( c, (float)size );
+        return (uint32_t)( i < 0 ? i + (int32_t)size : i );
+    };
+    const uint32_t x0 = wrap( x0f, t.width );
+    const uint32_t y0 = wrap( y0f, t.height );
+    const uint32_t x1 = ( x0 + 1 ) % t.width;
+    const uint32_t y1 = ( y0 + 1 ) % t.height;
+
+    const uint8_t* p00 = t.rgba + ( (size_t)y0 * t.width + x0 ) * 4;
+    const uint8_t* p10 = t.rgba + ( (size_t)y0 * t.width + x1 ) * 4;
+    const uint8_t* p01 = t.rgba + ( (size_t)y1 * t.width + x0 ) * 4;
+    const uint8_t* p11 = t.rgba + ( (size_t)y1 * t.width + x1 ) * 4;
+    for ( int c = 0; c < 3; ++c )
+    {
+        const float top = p00[ c ] + ( p10[ c ] - p00[ c ] ) * tx;
+        const float bottom = p01[ c ] + ( p11[ c ] - p01[ c ] ) * tx;
+        out[ c ] = ( top + ( bottom - top ) * ty ) * ( 1.f / 255.f );
+    }
+}
+
+SoftRasterizer::SoftRasterizer( JobSystem& jobs, uint32_t width, uint32_t height, bool srgb )
+: _jobs(jobs)
+, _width(width)
+, _height(height)
+, _binsX((width + kBinSize - 1) / kBinSize)
+, _binsY((height + kBinSize - 1) / kBinSize)
+, _srgb(srgb)
+, _color((size_t)width * height * 4)
+, _depth((size_t)width * height)
+, _stats{} {
+}
+
+void SoftRasterizer::clear( const float color[ 4 ], float depth ) {
+    uint8_t c[ 4 ];
+    for ( int i = 0; i < 3; ++i )
+    {
+        c[ i ] = _srgb ? encodeSrgb( color[ i ] ) : encodeUnorm( color[ i ] );
+    }
+    c[ 3 ] = encodeUnorm( color[ 3 ] );
+
+    for ( size_t i = 0; i < _depth.size(); ++i )
+    {
+        memcpy( &_color[ i * 4 ], c, 4 );
+    }
+    std::fill( _depth.begin(), _depth.end(), encodeDepth( depth ) );
+}
+
+void SoftRasterizer::draw( const SoftCamera& camera, const SoftDraw& draw ) {
+    // vertex stage, every vertex of every instance once
+    auto begin = std::chrono::steady_clock::now();
+
+    float view[ 16 ];
+    multiply4( camera.projection, camera.world, view );
+
+    const size_t vertexCount = draw.vertexCount;
+    _clipVertices.resize( draw.instanceCount * vertexCount );
+    _jobs.parallelFor( draw.instanceCount, kInstanceGrain, [&]( size_t first, size_t last ) {
+        for ( size_t i = first; i < last; ++i )
+        {
+            const SoftInstance& instance = draw.instances[ i ];
+            float m[ 16 ];
+            float n[ 9 ];
+            multiply4( view, instance.transform, m );
+            multiply3( camera.normalTransform, instance.normalTransform, n );
+
+            for ( size_t v = 0; v < vertexCount; ++v )
+            {
+                const SoftVertex& in = draw.vertices[ v ];
+                ClipVertex& out = _clipVertices[ i * vertexCount + v ];
+                for ( int r = 0; r < 4; ++r )
+                {
+                    out.position[ r ] = m[ r ] * in.position[ 0 ] + m[ 4 + r ] * in.position[ 1 ] + m[ 8 + r ] * in.position[ 2 ] + m[ 12 + r ];
+                }
+                for ( int r = 0; r < 3; ++r )
+                {
+                    out.attributes[ r ] = n[ r ] * in.normal[ 0 ] + n[ 3 + r ] * in.normal[ 1 ] + n[ 6 + r ] * in.normal[ 2 ];
+                }
+                out.attributes[ 3 ] = in.texcoord[ 0 ];
+                out.attributes[ 4 ] = in.texcoord[ 1 ];
+                out.attributes[ 5 ] = instance.color[ 0 ];
+                out.attributes[ 6 ] = instance.color[ 1 ];
+                out.attributes[ 7 ] = instance.color[ 2 ];
+            }
+        }
+    } );
+    _stats.vertexSeconds += secondsSince( begin );
+
+    // clip, set up and bin, each job fills its own chunk so bins need no locks
+    begin = std::chrono::steady_clock::now();
+
+    const size_t trianglesPerInstance = draw.indexCount / 3;
+    const size_t triangleCount = draw.instanceCount * trianglesPerInstance;
+    const size_t chunkCount = ( triangleCount + kTriangleGrain - 1 ) / kTriangleGrain;
+    const size_t binCount = (size_t)_binsX * _binsY;
+    if ( _chunks.size() < chunkCount )
+    {
+        const size_t first = _chunks.size();
+        _chunks.resize( chunkCount );
+        for ( size_t c = first; c < chunkCount; ++c )
+        {
+            // only triangles cut at the near plane can take a chunk past this, and
+            // most triangles touch few bins
+            _chunks[ c ].triangles.reserve( kTriangleGrain );
+            _chunks[ c ].entries.reserve( kTriangleGrain * 4 );
+        }
+    }
+
+    _jobs.parallelFor( chunkCount, 1, [&]( size_t first, size_t last ) {
+        for ( size_t c = first; c < last; ++c )
+        {
+            Chunk& chunk = _chunks[ c ];
+            chunk.triangles.clear();
+            chunk.culled = 0;
+            chunk.clipped = 0;
+
+            const size_t end = std::min( triangleCount, ( c + 1 ) * kTriangleGrain );
+            for ( size_t t = c * kTriangleGrain; t < end; ++t )
+            {
+                const size_t instance = t / trianglesPerInstance;
+                const uint16_t* index = draw.indices + ( t % trianglesPerInstance ) * 3;
+                const ClipVertex* base = _clipVertices.data() + instance * vertexCount;
+                clipAndSetup( base[ index[ 0 ] ], base[ index[ 1 ] ], base[ index[ 2 ] ], draw.cullBack, chunk );
+            }
+            binTriangles( chunk, binCount );
+        }
+    } );
+
+    _stats.triangles += triangleCount;
+    for ( size_t c = 0; c < chunkCount; ++c )
+    {
+        _stats.culled += _chunks[ c ].culled;
+        _stats.clipped += _chunks[ c ].clipped;
+        _stats.binEntries += _chunks[ c ].entries.size();
+    }
+    _stats.binSeconds += secondsSince( begin );
+
+    // bins own disjoint pixels, each walks the chunks in submission order
+    begin = std::chrono::steady_clock::now();
+
+    std::atomic<size_t> pixels( 0 );
+    _jobs.parallelFor( binCount, 1, [&]( size_t first, size_t last ) {
+        size_t shaded = 0;
+        for ( size_t b = first; b < last; ++b )
+        {
+            shaded += rasterBin( (uint32_t)b, draw, chunkCount );
+        }
+        pixels += shaded;
+    } );
+
+    _stats.pixels += pixels;
+    _stats.rasterSeconds += secondsSince( begin );
+}
+
+void SoftRasterizer::clipAndSetup( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, bool cullBack, Chunk& chunk ) {
+    const ClipVertex* v[ 3 ] = { &v0, &v1, &v2 };
+
+    // all three outside the same plane
+    uint32_t outside = ~0u;
+    for ( const ClipVertex* p : v )
+    {
+        const float x = p->position[ 0 ], y = p->position[ 1 ], z = p->position[ 2 ], w = p->position[ 3 ];
+        outside &= ( x < -w ? 1u : 0u ) | ( x > w ? 2u : 0u ) | ( y < -w ? 4u : 0u ) | ( y > w ? 8u : 0u )
+                 | ( z < 0.f ? 16u : 0u ) | ( z > w ? 32u : 0u );
+    }
+    if ( outside )
+    {
+        ++chunk.culled;
+        return;
+    }
+
+    if ( v0.position[ 2 ] >= 0.f && v1.position[ 2 ] >= 0.f && v2.position[ 2 ] >= 0.f )
+    {
+        setup( v0, v1, v2, cullBack, chunk );
+        return;
+    }
+
+    // cut at the near plane z = 0, which keeps w positive; x, y and far are left
+    // to the viewport and the per pixel depth range check
+    ClipVertex polygon[ 4 ];
+    int count = 0;
+    for ( int i = 0; i < 3; ++i )
+    {
+        const ClipVertex& a = *v[ i ];
+        const ClipVertex& b = *v[ ( i + 1 ) % 3 ];
+        const float da = a.position[ 2 ];
+        const float db = b.position[ 2 ];
+        if ( da >= 0.f )
+        {
+            polygon[ count++ ] = a;
+        }
+        if ( ( da >= 0.f ) != ( db >= 0.f ) )
+        {
+            const float t = da / ( da - db );
+            ClipVertex& out = polygon[ count++ ];
+            for ( int k = 0; k < 4; ++k )
+            {
+                out.position[ k ] = a.position[ k ] + ( b.position[ k ] - a.position[ k ] ) * t;
+            }
+            for ( int k = 0; k < 8; ++k )
+            {
+                out.attributes[ k ] = a.attributes[ k ] + ( b.attributes[ k ] - a.attributes[ k ] ) * t;
+            }
+        }
+    }
+
+    ++chunk.clipped;
+    for ( int i = 1; i + 1 < count; ++i )
+    {
+        setup( polygon[ 0 ], polygon[ i ], polygon[ i + 1 ], cullBack, chunk );
+    }
+}
+
+void SoftRasterizer::setup( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, bool cullBack, Chunk& chunk ) {
+    const ClipVertex* v[ 3 ] = { &v0, &v1, &v2 };
+
+    float x[ 3 ], y[ 3 ];
+    Triangle t;
+    for ( int i = 0; i < 3; ++i )
+    {
+        const float invW = 1.f / v[ i ]->position[ 3 ];
+        x[ i ] = ( v[ i ]->position[ 0 ] * invW * 0.5f + 0.5f ) * _width;
+        y[ i ] = ( 0.5f - v[ i ]->position[ 1 ] * invW * 0.5f ) * _height;
+        t.z[ i ] = v[ i ]->position[ 2 ] * invW;
+        t.invW[ i ] = invW;
+        for ( int k = 0; k < 8; ++k )
+        {
+            t.attributes[ i ][ k ] = v[ i ]->attributes[ k ] * invW;
+        }
+    }
+
+    // y points down on screen, counter clockwise front faces have a negative area
+    float area = ( x[ 1 ] - x[ 0 ] ) * ( y[ 2 ] - y[ 0 ] ) - ( x[ 2 ] - x[ 0 ] ) * ( y[ 1 ] - y[ 0 ] );
+    if ( area == 0.f || !std::isfinite( area ) || ( cullBack && area > 0.f ) )
+    {
+        ++chunk.culled;
+        return;
+    }
+    if ( area < 0.f )
+    {
+        std::swap( x[ 1 ], x[ 2 ] );
+        std::swap( y[ 1 ], y[ 2 ] );
+        std::swap( t.z[ 1 ], t.z[ 2 ] );
+        std::swap( t.invW[ 1 ], t.invW[ 2 ] );
+        std::swap( t.attributes[ 1 ], t.attributes[ 2 ] );
+        area = -area;
+    }
+    t.invArea = 1.f / area;
+
+    // edge i runs between the other two vertices and is the weight of vertex i
+    for ( int i = 0; i < 3; ++i )
+    {
+        const int a = ( i + 1 ) % 3;
+        const int b = ( i + 2 ) % 3;
+        t.edgeA[ i ] = y[ a ] - y[ b ];
+        t.edgeB[ i ] = x[ b ] - x[ a ];
+        t.edgeC[ i ] = -( t.edgeA[ i ] * x[ a ] + t.edgeB[ i ] * y[ a ] );
+        // a shared edge has opposite coefficients in its two triangles, exactly one owns it
+        t.ownsZero[ i ] = ( t.edgeA[ i ] > 0.f || ( t.edgeA[ i ] == 0.f && t.edgeB[ i ] > 0.f ) ) ? -1 : 0;
+    }
+
+    // pixel centres inside the bounds, clamped in float before the conversion
+    const float minX = std::max( std::min( { x[ 0 ], x[ 1 ], x[ 2 ] } ), 0.f );
+    const float maxX = std::min( std::max( { x[ 0 ], x[ 1 ], x[ 2 ] } ), (float)_width );
+    const float minY = std::max( std::min( { y[ 0 ], y[ 1 ], y[ 2 ] } ), 0.f );
+    const float maxY = std::min( std::max( { y[ 0 ], y[ 1 ], y[ 2 ] } ), (float)_height );
+    t.minX = (int32_t)ceilf( minX - 0.5f );
+    t.maxX = std::min( (int32_t)floorf( maxX - 0.5f ), (int32_t)_width - 1 );
+    t.minY = (int32_t)ceilf( minY - 0.5f );
+    t.maxY = std::min( (int32_t)floorf( maxY - 0.5f ), (int32_t)_height - 1 );
+    if ( t.minX > t.maxX || t.minY > t.maxY )
+    {
+        ++chunk.culled;
+        return;
+    }
+
+    chunk.triangles.push_back( t );
+}
+
+void SoftRasterizer::binTriangles( Chunk& chunk, size_t binCount ) {
+    // count, prefix sum, scatter; indices stay in submission order within a bin
+    chunk.binStart.assign( binCount + 1, 0 );
+    for ( const Triangle& t : chunk.triangles )
+    {
+        for ( uint32_t by = t.minY / kBinSize; by <= t.maxY / kBinSize; ++by )
+        {
+            for ( uint32_t bx = t.minX / kBinSize; bx <= t.maxX / kBinSize; ++bx )
+            {
+                ++chunk.binStart[ by * _binsX + bx + 1 ];
+            }
+        }
+    }
+    for ( size_t b = 0; b < binCount; ++b )
+    {
+        chunk.binStart[ b + 1 ] += chunk.binStart[ b ];
+    }
+
+    // the count moves with the scene, room to spare keeps later frames off the heap
+    const size_t entryCount = chunk.binStart[ binCount ];
+    if ( entryCount > chunk.entries.capacity() )
+    {
+        chunk.entries.reserve( entryCount * 2 );
+    }
+    chunk.entries.resize( entryCount );
+    for ( uint32_t index = 0; index < chunk.triangles.size(); ++index )
+    {
+        const Triangle& t = chunk.triangles[ index ];
+        for ( uint32_t by = t.minY / kBinSize; by <= t.maxY / kBinSize; ++by )
+        {
+            for ( uint32_t bx = t.minX / kBinSize; bx <= t.maxX / kBinSize; ++bx )
+            {
+                // binStart[ b ] walks up to the old binStart[ b + 1 ] ...
+                chunk.entries[ chunk.binStart[ by * _binsX + bx ]++ ] = index;
+            }
+        }
+    }
+    // ... and is moved back down a slot, bin 0 starts at 0 again
+    for ( size_t b = binCount; b > 0; --b )
+    {
+        chunk.binStart[ b ] = chunk.binStart[ b - 1 ];
+    }
+    chunk.binStart[ 0 ] = 0;
+}
+
+size_t SoftRasterizer::rasterBin( uint32_t bin, const SoftDraw& draw, size_t chunkCount ) {
+    const int32_t binX = ( bin % _binsX ) * kBinSize;
+    const int32_t binY = ( bin / _binsX ) * kBinSize;
+    const int32_t binMaxX = std::min( binX + (int32_t)kBinSize, (int32_t)_width ) - 1;
+    const int32_t binMaxY = std::min( binY + (int32_t)kBinSize, (int32_t)_height ) - 1;
+
+    static const float light[ 3 ] = { 0.5970223f, 0.5970223f, 0.4776178f };   // normalize( 1, 1, 0.8 )
+    const bool textured = ( draw.shading & kSoftTextured ) && draw.texture;
+    const bool lit = ( draw.shading & kSoftLit ) != 0;
+    const uint8_t* srgb = _srgb ? srgbTable() : nullptr;
+    const float encodeScale = _srgb ? (float)( kSrgbTableSize - 1 ) : 255.f;
+    size_t shaded = 0;
+
+    for ( size_t c = 0; c < chunkCount; ++c )
+    {
+        const Chunk& chunk = _chunks[ c ];
+        for ( uint32_t e = chunk.binStart[ bin ]; e < chunk.binStart[ bin + 1 ]; ++e )
+        {
+            const Triangle& t = chunk.triangles[ chunk.entries[ e ] ];
+            const int32_t x0 = std::max( t.minX, binX );
+            const int32_t x1 = std::min( t.maxX, binMaxX );
+            const int32_t y0 = std::max( t.minY, binY );
+            const int32_t y1 = std::min( t.maxY, binMaxY );
+
+            for ( int32_t blockY = y0 & ~( kBlockSize - 1 ); blockY <= y1; blockY += kBlockSize )
+            {
+                for ( int32_t blockX = x0 & ~( kBlockSize - 1 ); blockX <= x1; blockX += kBlockSize )
+                {
+                    // an edge that is negative at all four corners misses the whole block
+                    bool outside = false;
+                    for ( int e = 0; e < 3 && !outside; ++e )
+                    {
+                        const float left = t.edgeA[ e ] * ( blockX + 0.5f );
+                        const float right = t.edgeA[ e ] * ( blockX + kBlockSize - 0.5f );
+                        const float top = t.edgeB[ e ] * ( blockY + 0.5f );
+                        const float bottom = t.edgeB[ e ] * ( blockY + kBlockSize - 0.5f );
+                        outside = std::max( left, right ) + std::max( top, bottom ) + t.edgeC[ e ] < 0.f;
+                    }
+                    if ( outside )
+                    {
+                        continue;
+                    }
+
+                    const int32_t rowEnd = std::min( blockY + (int32_t)kBlockSize - 1, y1 );
+                    for ( int32_t row = std::max( blockY, y0 ); row <= rowEnd; ++row )
+                    {
+                        const Float4 py = splat( row + 0.5f );
+                        for ( int32_t quadX = blockX; quadX < blockX + (int32_t)kBlockSize && quadX <= x1; quadX += kLanes )
+                        {
+                            const Float4 lane = splat( (float)quadX ) + kLaneOffsets;
+                            const Float4 px = lane + splat( 0.5f );
+                            Int4 mask = ( lane >= splat( (float)x0 ) ) & ( lane <= splat( (float)x1 ) );
+
+                            Float4 b[ 3 ];
+                            for ( int e = 0; e < 3; ++e )
+                            {
+                                const Float4 w = splat( t.edgeA[ e ] ) * px + splat( t.edgeB[ e ] ) * py + splat( t.edgeC[ e ] );
+                                mask &= ( w > splat( 0.f ) ) | ( ( w == splat( 0.f ) ) & splat( t.ownsZero[ e ] ) );
+                                b[ e ] = w * splat( t.invArea );
+                            }
+                            if ( !anyLane( mask ) )
+                            {
+                                continue;
+                            }
+
+                            // depth range and test, lanes outside the triangle never
+                            // touch memory so the end of a row is safe
+                            const Float4 z = b[ 0 ] * splat( t.z[ 0 ] ) + b[ 1 ] * splat( t.z[ 1 ] ) + b[ 2 ] * splat( t.z[ 2 ] );
+                            mask &= ( z >= splat( 0.f ) ) & ( z <= splat( 1.f ) );
+
+                            const size_t pixel = (size_t)row * _width + quadX;
+                            uint16_t* depthRow = &_depth[ pixel ];
+                            const Int4 depth = __builtin_convertvector( z * splat( 65535.f ) + splat( 0.5f ), Int4 );
+                            Int4 stored;
+                            for ( int l = 0; l < kLanes; ++l )
+                            {
+                                stored[ l ] = mask[ l ] ? depthRow[ l ] : 0;
+                            }
+                            mask &= depth < stored;
+                            if ( !anyLane( mask ) )
+                            {
+                                continue;
+                            }
+
+                            // perspective correct attributes, only the ones the shading reads
+                            const Float4 w = splat( 1.f ) / ( b[ 0 ] * splat( t.invW[ 0 ] ) + b[ 1 ] * splat( t.invW[ 1 ] ) + b[ 2 ] * splat( t.invW[ 2 ] ) );
+                            auto attribute = [&]( int k ) {
+                                return ( b[ 0 ] * splat( t.attributes[ 0 ][ k ] ) + b[ 1 ] * splat( t.attributes[ 1 ][ k ] ) + b[ 2 ] * splat( t.attributes[ 2 ][ k ] ) ) * w;
+                            };
+
+                            Float4 color[ 3 ] = { attribute( 5 ), attribute( 6 ), attribute( 7 ) };
+                            if ( textured )
+                            {
+                                const Float4 u = attribute( 3 );
+                                const Float4 v = attribute( 4 );
+                                for ( int l = 0; l < kLanes; ++l )
+                                {
+                                    if ( mask[ l ] )
+                                    {
+                                        float texel[ 3 ];
+                                        sampleBilinear( *draw.texture, u[ l ], v[ l ], texel );
+                                        color[ 0 ][ l ] *= texel[ 0 ];
+                                        color[ 1 ][ l ] *= texel[ 1 ];
+                                        color[ 2 ][ l ] *= texel[ 2 ];
+                                    }
+                                }
+                            }
+                            if ( lit )
+                            {
+                                const Float4 n[ 3 ] = { attribute( 0 ), attribute( 1 ), attribute( 2 ) };
+                                const Float4 lengthSq = n[ 0 ] * n[ 0 ] + n[ 1 ] * n[ 1 ] + n[ 2 ] * n[ 2 ];
+                                Float4 length = splat( 0.f );
+                                for ( int l = 0; l < kLanes; ++l )
+                                {
+                                    length[ l ] = sqrtf( lengthSq[ l ] );
+                                }
+                                Float4 ndotl = ( n[ 0 ] * splat( light[ 0 ] ) + n[ 1 ] * splat( light[ 1 ] ) + n[ 2 ] * splat( light[ 2 ] ) ) / length;
+                                ndotl = ndotl > splat( 0.f ) ? ndotl : splat( 0.f );   // also drops the nan of a zero normal
+                                ndotl = ndotl < splat( 1.f ) ? ndotl : splat( 1.f );
+                                for ( int k = 0; k < 3; ++k )
+                                {
+                                    color[ k ] = color[ k ] * splat( 0.1f ) + color[ k ] * ndotl;
+                                }
+                            }
+
+                            // clamp and scale to the encoding, srgb goes through its table
+                            Int4 encoded[ 3 ];
+                            for ( int k = 0; k < 3; ++k )
+                            {
+                                Float4 c = color[ k ] > splat( 0.f ) ? color[ k ] : splat( 0.f );
+                                c = c < splat( 1.f ) ? c : splat( 1.f );
+                                encoded[ k ] = __builtin_convertvector( c * splat( encodeScale ) + splat( 0.5f ), Int4 );
+                            }
+
+                            // rgba8 packed into one word per lane
+                            Int4 rgba = splat( (int32_t)0xFF000000 );
+                            for ( int k = 0; k < 3; ++k )
+                            {
+                                Int4 channel = encoded[ k ];
+                                if ( srgb )
+                                {
+                                    for ( int l = 0; l < kLanes; ++l )
+                                    {
+                                        channel[ l ] = srgb[ channel[ l ] ];
+                                    }
+                                }
+                                rgba |= channel << ( 8 * k );
+                            }
+
+                            uint32_t* colorRow = (uint32_t*)&_color[ pixel * 4 ];
+                            for ( int l = 0; l < kLanes; ++l )
+                            {
+                                if ( mask[ l ] )
+                                {
+                                    depthRow[ l ] = (uint16_t)depth[ l ];
+                                    colorRow[ l ] = (uint32_t)rgba[ l ];
+                                    ++shaded;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return shaded;
+}
+
+SoftImageDiff compareImages( const uint8_t* a, const uint8_t* b, size_t pixelCount, uint32_t tolerance )
+{
+    SoftImageDiff diff = {};
+    for ( size_t i = 0; i < pixelCount; ++i )
+    {
+        uint32_t delta = 0;
+        for ( int c = 0; c < 4; ++c )
+        {
+            delta = std::max<uint32_t>( delta, (uint32_t)std::abs( a[ i * 4 + c ] - b[ i * 4 + c ] ) );
+        }
+        diff.maxDelta = std::max( diff.maxDelta, delta );
+        diff.mismatched += delta > tolerance ? 1 : 0;
+    }
+    return diff;
+}
@@ -0,0 +1,169 @@
+/**
+  ******************************************************************************
+  * @file           : soft_rasterizer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SOFT_RASTERIZER_HPP
+#define METAL_PLAYGROUND_SOFT_RASTERIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "job_system.hpp"
+
+// matrices are column major like simd, m[ column * 4 + row ] and n[ column * 3 + row ]
+struct SoftVertex
+{
+    float position[ 3 ];
+    float normal[ 3 ];
+    float texcoord[ 2 ];
+};
+
+struct SoftInstance
+{
+    float transform[ 16 ];
+    float normalTransform[ 9 ];
+    float color[ 4 ];
+};
+
+struct SoftCamera
+{
+    float projection[ 16 ];
+    float world[ 16 ];
+    float normalTransform[ 9 ];
+};
+
+// rgba8 unorm, sampled bilinear with repeat like the samples' sampler
+struct SoftTexture
+{
+    const uint8_t* rgba;
+    uint32_t width;
+    uint32_t height;
+};
+
+// fragment logic of the samples: the instance colour, times the texture, then
+// ambient + n.l from the fixed light the shaders use
+static constexpr uint32_t kSoftTextured = 1u << 0;
+static constexpr uint32_t kSoftLit = 1u << 1;
+
+struct SoftDraw
+{
+    const SoftVertex* vertices;
+    size_t vertexCount;
+    const uint16_t* indices;
+    size_t indexCount;
+    const SoftInstance* instances;
+    size_t instanceCount;
+    uint32_t shading;
+    const SoftTexture* texture;
+    bool cullBack;              // counter clockwise front faces
+};
+
+struct SoftRasterStats
+{
+    size_t triangles;
+    size_t culled;              // back facing, degenerate or outside the view
+    size_t clipped;             // split at the near plane
+    size_t binEntries;
+    size_t pixels;              // passed the depth test
+    double vertexSeconds;
+    double binSeconds;
+    double rasterSeconds;
+};
+
+struct SoftImageDiff
+{
+    size_t mismatched;          // pixels with a channel off by more than the tolerance
+    uint32_t maxDelta;
+};
+
+// cpu reference for what the samples draw, to check their output against golden
+// images on machines without a gpu. it runs the samples' vertex transform and
+// fragment logic, bins triangles into 64x64 bins and rasterises every bin on the
+// job system in 8x8 blocks with 4 wide edge functions. depth is stored and
+// compared like Depth16Unorm with CompareFunctionLess, colour goes to rgba8,
+// sRGB encoded when the view it mirrors is.
+//
+// clip space follows metal, 0 <= z <= w and y up.
+class SoftRasterizer {
+private:
+    struct ClipVertex
+    {
+        float position[ 4 ];
+        float attributes[ 8 ];  // normal, texcoord, colour
+    };
+
+    struct Triangle
+    {
+        float edgeA[ 3 ], edgeB[ 3 ], edgeC[ 3 ];
+        int32_t ownsZero[ 3 ];  // -1 when pixels exactly on the edge belong to this triangle
+        float z[ 3 ];
+        float invW[ 3 ];
+        float attributes[ 3 ][ 8 ];    // divided by w
+        float invArea;
+        int32_t minX, minY, maxX, maxY;
+    };
+
+    // triangles set up by one binning job. bin b holds the indices
+    // entries[ binStart[ b ] .. binStart[ b + 1 ] ), one flat list per chunk so the
+    // steady state reuses its storage instead of growing a vector per bin.
+    struct Chunk
+    {
+        std::vector<Triangle> triangles;
+        std::vector<uint32_t> entries;
+        std::vector<uint32_t> binStart;
+        size_t culled;
+        size_t clipped;
+    };
+
+    JobSystem& _jobs;
+    uint32_t _width;
+    uint32_t _height;
+    uint32_t _binsX;
+    uint32_t _binsY;
+    bool _srgb;
+
+    std::vector<uint8_t> _color;
+    std::vector<uint16_t> _depth;
+
+    std::vector<ClipVertex> _clipVertices;
+    std::vector<Chunk> _chunks;
+
+    SoftRasterStats _stats;
+
+    void clipAndSetup( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, bool cullBack, Chunk& chunk );
+    void setup( const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, bool cullBack, Chunk& chunk );
+    void binTriangles( Chunk& chunk, size_t binCount );
+    size_t rasterBin( uint32_t bin, const SoftDraw& draw, size_t chunkCount );
+
+public:
+    SoftRasterizer( JobSystem& jobs, uint32_t width, uint32_t height, bool srgb = true );
+
+    SoftRasterizer( const SoftRasterizer& ) = delete;
+    SoftRasterizer& operator=( const SoftRasterizer& ) = delete;
+
+    void clear( const float color[ 4 ], float depth = 1.f );
+    void draw( const SoftCamera& camera, const SoftDraw& draw );
+
+    uint32_t width() const { return _width; }
+    uint32_t height() const { return _height; }
+    // rgba8, width * height * 4 bytes, top row first
+    const uint8_t* color() const { return _color.data(); }
+    const uint16_t* depth() const { return _depth.data(); }
+
+    SoftRasterStats stats() const { return _stats; }
+    void resetStats() { _stats = {}; }
+};
+
+SoftImageDiff compareImages( const uint8_t* a, const uint8_t* b, size_t pixelCount, uint32_t tolerance );
+
+
+#endif //METAL_PLAYGROUND_SOFT_RASTERIZER_HPP
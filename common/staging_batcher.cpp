@@ -0,0 +1,147 @@
+/**
+  ******************************************************************************
+  * @file           : staging_batcher.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "staging_batcher.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+static size_t alignUp( size_t value, size_t align )
+{
+    return ( value + align - 1 ) & ~( align - 1 );
+}
+
+StagingBatcher::StagingBatcher( size_t chunkSize, NewChunkFn newChunk, ReleaseChunkFn releaseChunk )
+: _chunkSize( chunkSize )
+, _newChunk( std::move( newChunk ) )
+, _releaseChunk( std::move( releaseChunk ) )
+, _nextSerial( 1 )
+, _chunksCreated( 0 ) {
+    assert( chunkSize > 0 );
+}
+
+StagingBatcher::~StagingBatcher() {
+    // whatever is still open was never flushed, in flight batches lost their
+    // completion with the command buffer that never ran
+    for ( const OpenChunk& c : _open )
+    {
+        _releaseChunk( c.chunk );
+    }
+    for ( const Batch& b : _inFlight )
+    {
+        for ( const StagingChunk& c : b.chunks )
+        {
+            _releaseChunk( c );
+        }
+    }
+    for ( const StagingChunk& c : _free )
+    {
+        _releaseChunk( c );
+    }
+}
+
+bool StagingBatcher::stage( const void* data, size_t length, size_t align, StagingPlacement& outPlacement ) {
+    assert( align > 0 && ( align & ( align - 1 ) ) == 0 );
+
+    if ( _open.empty() || alignUp( _open.back().used, align ) + length > _open.back().chunk.capacity )
+    {
+        StagingChunk chunk = {};
+        bool recycled = false;
+        if ( length <= _chunkSize )
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            if ( !_free.empty() )
+            {
+                chunk = _free.back();
+                _free.pop_back();
+                recycled = true;
+            }
+        }
+        if ( !recycled )
+        {
+            // oversized uploads get a chunk of their own that is not recycled
+            chunk = _newChunk( std::max( length, _chunkSize ) );
+            if ( !chunk.memory )
+            {
+                return false;
+            }
+            ++_chunksCreated;
+        }
+        _open.push_back( { chunk, 0 } );
+    }
+
+    OpenChunk& open = _open.back();
+    const size_t offset = alignUp( open.used, align );
+    memcpy( open.chunk.memory + offset, data, length );
+    open.used = offset + length;
+
+    outPlacement.chunk = (uint32_t)( _open.size() - 1 );
+    outPlacement.offset = offset;
+    return true;
+}
+
+uint64_t StagingBatcher::closeBatch() {
+    Batch batch;
+    batch.serial = _nextSerial++;
+    batch.chunks.reserve( _open.size() );
+    for ( const OpenChunk& c : _open )
+    {
+        batch.chunks.push_back( c.chunk );
+    }
+    _open.clear();
+
+    std::lock_guard<std::mutex> lock( _mutex );
+    _inFlight.push_back( std::move( batch ) );
+    return _inFlight.back().serial;
+}
+
+void StagingBatcher::batchCompleted( uint64_t serial ) {
+    std::vector<StagingChunk> oversized;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        auto it = std::find_if( _inFlight.begin(), _inFlight.end(), [serial]( const Batch& b ) { return b.serial == serial; } );
+        assert( it != _inFlight.end() );
+        if ( it == _inFlight.end() )
+        {
+            return;
+        }
+
+        for ( const StagingChunk& c : it->chunks )
+        {
+            if ( c.capacity == _chunkSize )
+            {
+                _free.push_back( c );
+            }
+            else
+            {
+                oversized.push_back( c );
+            }
+        }
+        _inFlight.erase( it );
+    }
+
+    for ( const StagingChunk& c : oversized )
+    {
+        _releaseChunk( c );
+    }
+}
+
+size_t StagingBatcher::inFlightBatches() const {
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _inFlight.size();
+}
+
+size_t StagingBatcher::freeChunks() const {
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _free.size();
+}
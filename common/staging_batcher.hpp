@@ -0,0 +1,100 @@
+/**
+  ******************************************************************************
+  * @file           : staging_batcher.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_STAGING_BATCHER_HPP
+#define METAL_PLAYGROUND_STAGING_BATCHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// cpu visible memory the copies of a batch read from. handle is whatever owns it,
+// an MTL::Buffer for the uploader
+struct StagingChunk
+{
+    void* handle;
+    uint8_t* memory;
+    size_t capacity;
+};
+
+struct StagingPlacement
+{
+    uint32_t chunk;     // index into the open batch, see chunk()
+    size_t offset;
+};
+
+// the staging memory side of StagingUploader, without metal. data is copied into
+// chunks as it is staged, closeBatch() hands the chunks to the gpu and
+// batchCompleted() gets them back, from any thread and in any order. chunks of
+// chunkSize are recycled, bigger ones are released on completion.
+//
+// owners keep it in a shared_ptr that completion handlers hold on to, so the
+// batcher outlives the last batch whichever goes away first. the destructor
+// releases every chunk, in flight or not.
+class StagingBatcher {
+public:
+    using NewChunkFn = std::function<StagingChunk(size_t capacity)>;
+    using ReleaseChunkFn = std::function<void(const StagingChunk& chunk)>;
+
+private:
+    struct OpenChunk
+    {
+        StagingChunk chunk;
+        size_t used;
+    };
+
+    struct Batch
+    {
+        uint64_t serial;
+        std::vector<StagingChunk> chunks;
+    };
+
+    size_t _chunkSize;
+    NewChunkFn _newChunk;
+    ReleaseChunkFn _releaseChunk;
+
+    std::vector<OpenChunk> _open;
+    uint64_t _nextSerial;
+    size_t _chunksCreated;
+
+    // completion runs on whatever thread the gpu calls back on
+    mutable std::mutex _mutex;
+    std::vector<Batch> _inFlight;
+    std::vector<StagingChunk> _free;
+
+public:
+    StagingBatcher( size_t chunkSize, NewChunkFn newChunk, ReleaseChunkFn releaseChunk );
+    ~StagingBatcher();
+
+    StagingBatcher( const StagingBatcher& ) = delete;
+    StagingBatcher& operator=( const StagingBatcher& ) = delete;
+
+    // copies length bytes at an offset aligned to align (a power of two). false when
+    // newChunk could not make a chunk
+    bool stage( const void* data, size_t length, size_t align, StagingPlacement& outPlacement );
+
+    const StagingChunk& chunk( uint32_t index ) const { return _open[ index ].chunk; }
+    size_t openChunkCount() const { return _open.size(); }
+
+    // the open chunks become a batch in flight, the serial is what batchCompleted() takes
+    uint64_t closeBatch();
+    void batchCompleted( uint64_t serial );
+
+    size_t inFlightBatches() const;
+    size_t freeChunks() const;
+    size_t chunksCreated() const { return _chunksCreated; }
+};
+
+
+#endif //METAL_PLAYGROUND_STAGING_BATCHER_HPP
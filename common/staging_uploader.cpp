@@ -0,0 +1,180 @@
+/**
+  ******************************************************************************
+  * @file           : staging_uploader.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "staging_uploader.hpp"
+#include "metal_storage.hpp"
+
+#include <cassert>
+#include <cstring>
+
+static constexpr size_t kBufferAlign = 16;
+// buffer to texture copies want the source offset aligned to the pixel size, stay generous
+static constexpr size_t kTextureAlign = 256;
+
+StagingUploader::StagingUploader( MTL::Device* device, size_t chunkSize )
+: _device(device->retain())
+, _unifiedMemory(device->hasUnifiedMemory())
+, _stats{} {
+    // chunks are only made while staging, the uploader and so the device are alive then
+    _batcher = std::make_shared<StagingBatcher>( chunkSize,
+        [device]( size_t capacity ) -> StagingChunk {
+            MTL::Buffer* buffer = device->newBuffer( capacity, MTL::ResourceStorageModeShared );
+            if ( !buffer )
+            {
+                return {};
+            }
+            return { buffer, (uint8_t*)buffer->contents(), capacity };
+        },
+        []( const StagingChunk& chunk ) {
+            static_cast<MTL::Buffer*>( chunk.handle )->release();
+        } );
+}
+
+StagingUploader::~StagingUploader() {
+    // batches in flight hold their own reference, the batcher goes with the last one
+    _batcher.reset();
+    _device->release();
+}
+
+MTL::Buffer* StagingUploader::newBuffer( size_t length, ResourceUsage usage, const void* data ) {
+    const StoragePolicy policy = chooseStoragePolicy( usage, _unifiedMemory );
+    MTL::Buffer* buffer = _device->newBuffer( length, resourceOptions( metalStorageMode( policy.storage ) ) );
+
+    if ( !data )
+    {
+        return buffer;
+    }
+    if ( policy.staged )
+    {
+        uploadBuffer( buffer, 0, data, length );
+        return buffer;
+    }
+
+    memcpy( buffer->contents(), data, length );
+    if ( policy.synchronized )
+    {
+        buffer->didModifyRange( NS::Range::Make( 0, length ) );
+    }
+    return buffer;
+}
+
+MTL::Texture* StagingUploader::newTexture( const MTL::TextureDescriptor* desc, ResourceUsage usage, const void* data, size_t bytesPerRow ) {
+    const StoragePolicy policy = chooseTexturePolicy( usage, _unifiedMemory );
+
+    MTL::TextureDescriptor* pTextureDesc = desc->copy();
+    pTextureDesc->setStorageMode( metalStorageMode( policy.storage ) );
+    MTL::Texture* texture = _device->newTexture( pTextureDesc );
+    pTextureDesc->release();
+
+    if ( !data )
+    {
+        return texture;
+    }
+
+    MTL::Region region = MTL::Region::Make2D( 0, 0, texture->width(), texture->height() );
+    if ( policy.staged )
+    {
+        uploadTexture( texture, region, 0, data, bytesPerRow );
+    }
+    else
+    {
+        texture->replaceRegion( region, 0, data, bytesPerRow );
+    }
+    return texture;
+}
+
+void StagingUploader::uploadBuffer( MTL::Buffer* dst, size_t dstOffset, const void* data, size_t length ) {
+    assert( dstOffset + length <= dst->length() );
+
+    StagingPlacement placement;
+    if ( !_batcher->stage( data, length, kBufferAlign, placement ) )
+    {
+        __builtin_printf( "StagingUploader: failed to allocate a %zu byte staging chunk\n", length );
+        return;
+    }
+
+    Copy c = {};
+    c.chunk = placement.chunk;
+    c.srcOffset = placement.offset;
+    c.length = length;
+    c.dstBuffer = dst;
+    c.dstOffset = dstOffset;
+    _copies.push_back( c );
+
+    ++_stats.copies;
+    _stats.bytes += length;
+}
+
+void StagingUploader::uploadTexture( MTL::Texture* dst, MTL::Region region, NS::UInteger level, const void* data, size_t bytesPerRow ) {
+    Copy c = {};
+    c.bytesPerRow = bytesPerRow;
+    c.bytesPerImage = bytesPerRow * region.size.height;
+    c.length = c.bytesPerImage * region.size.depth;
+
+    StagingPlacement placement;
+    if ( !_batcher->stage( data, c.length, kTextureAlign, placement ) )
+    {
+        __builtin_printf( "StagingUploader: failed to allocate a %zu byte staging chunk\n", c.length );
+        return;
+    }
+    c.chunk = placement.chunk;
+    c.srcOffset = placement.offset;
+    c.dstTexture = dst;
+    c.region = region;
+    c.level = level;
+    _copies.push_back( c );
+
+    ++_stats.copies;
+    _stats.bytes += c.length;
+}
+
+size_t StagingUploader::flush( MTL::CommandBuffer* cmd ) {
+    if ( _copies.empty() )
+    {
+        return 0;
+    }
+
+    MTL::BlitCommandEncoder* blit = cmd->blitCommandEncoder();
+    for ( const Copy& c : _copies )
+    {
+        MTL::Buffer* src = static_cast<MTL::Buffer*>( _batcher->chunk( c.chunk ).handle );
+        if ( c.dstTexture )
+        {
+            blit->copyFromBuffer( src, c.srcOffset, c.bytesPerRow, c.bytesPerImage, c.region.size,
+                                  c.dstTexture, 0, c.level, c.region.origin );
+        }
+        else
+        {
+            blit->copyFromBuffer( src, c.srcOffset, c.dstBuffer, c.dstOffset, c.length );
+        }
+    }
+    blit->endEncoding();
+
+    // the gpu reads the chunks until cmd completes, hand them back from there. the
+    // handler holds the batcher, not the uploader, which may be gone by then
+    const uint64_t serial = _batcher->closeBatch();
+    std::shared_ptr<StagingBatcher> batcher = _batcher;
+    cmd->addCompletedHandler( ^void( MTL::CommandBuffer* pCmd ) {
+        batcher->batchCompleted( serial );
+    } );
+
+    const size_t copies = _copies.size();
+    _copies.clear();
+    ++_stats.batches;
+    return copies;
+}
+
+UploadStats StagingUploader::stats() const {
+    UploadStats stats = _stats;
+    stats.chunks = _batcher->chunksCreated();
+    return stats;
+}
@@ -0,0 +1,88 @@
+/**
+  ******************************************************************************
+  * @file           : staging_uploader.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_STAGING_UPLOADER_HPP
+#define METAL_PLAYGROUND_STAGING_UPLOADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Metal/Metal.hpp>
+
+#include "resource_policy.hpp"
+#include "staging_batcher.hpp"
+
+struct UploadStats
+{
+    size_t copies;
+    size_t batches;
+    size_t chunks;
+    uint64_t bytes;
+};
+
+// creates resources for a ResourceUsage and fills them along the path its
+// StoragePolicy asks for. staged uploads are copied into shared staging chunks
+// right away and turned into blits by flush(), one blit encoder per batch.
+// the uploader may go away while batches are still in flight, their completion
+// handlers keep the staging chunks alive until the gpu is done with them.
+class StagingUploader {
+private:
+    struct Copy
+    {
+        uint32_t chunk;
+        size_t srcOffset;
+        size_t length;
+        MTL::Buffer* dstBuffer;
+        size_t dstOffset;
+        MTL::Texture* dstTexture;
+        MTL::Region region;
+        NS::UInteger level;
+        size_t bytesPerRow;
+        size_t bytesPerImage;
+    };
+
+    MTL::Device* _device;
+    bool _unifiedMemory;
+
+    // shared with the completion handlers of the batches in flight
+    std::shared_ptr<StagingBatcher> _batcher;
+    std::vector<Copy> _copies;
+
+    UploadStats _stats;
+
+public:
+    explicit StagingUploader( MTL::Device* device, size_t chunkSize = 4 << 20 );
+    ~StagingUploader();
+
+    StagingUploader( const StagingUploader& ) = delete;
+    StagingUploader& operator=( const StagingUploader& ) = delete;
+
+    // data may be nullptr, the resource is then left uninitialized
+    MTL::Buffer* newBuffer( size_t length, ResourceUsage usage, const void* data );
+    MTL::Texture* newTexture( const MTL::TextureDescriptor* desc, ResourceUsage usage, const void* data, size_t bytesPerRow );
+
+    // queue a copy into a private resource, data is copied before returning
+    void uploadBuffer( MTL::Buffer* dst, size_t dstOffset, const void* data, size_t length );
+    void uploadTexture( MTL::Texture* dst, MTL::Region region, NS::UInteger level, const void* data, size_t bytesPerRow );
+
+    // encodes every queued copy into cmd with one blit encoder. the staging
+    // chunks are recycled once cmd completes. returns the number of copies.
+    size_t flush( MTL::CommandBuffer* cmd );
+    size_t pendingCopies() const { return _copies.size(); }
+
+    UploadStats stats() const;
+};
+
+
+#endif //METAL_PLAYGROUND_STAGING_UPLOADER_HPP
@@ -0,0 +1,215 @@
+/**
+  ******************************************************************************
+  * @file           : temporal_upscale.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "temporal_upscale.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+// phases per output pixel that an input pixel covers
+static constexpr uint32_t kPhasesPerPixel = 8;
+// how much of a sample that lands on an output pixel's centre goes into it, the rest
+// is history
+static constexpr float kSampleWeight = 0.5f;
+
+float halton( uint32_t index, uint32_t base ) {
+    float f = 1.f;
+    float r = 0.f;
+    while ( index > 0 )
+    {
+        f /= (float)base;
+        r += f * (float)( index % base );
+        index /= base;
+    }
+    return r;
+}
+
+TemporalJitter::TemporalJitter()
+: _phaseCount( kPhasesPerPixel )
+, _phase( kPhasesPerPixel - 1 )
+, _x( 0.f )
+, _y( 0.f ) {
+}
+
+void TemporalJitter::reset( uint32_t inputWidth, uint32_t inputHeight, uint32_t outputWidth, uint32_t outputHeight ) {
+    const float scale = ( (float)outputWidth / (float)inputWidth ) * ( (float)outputHeight / (float)inputHeight );
+    _phaseCount = std::max( kPhasesPerPixel, (uint32_t)ceilf( (float)kPhasesPerPixel * scale ) );
+    // the first advance() lands on phase 0
+    _phase = _phaseCount - 1;
+    _x = 0.f;
+    _y = 0.f;
+}
+
+void TemporalJitter::advance() {
+    _phase = ( _phase + 1 ) % _phaseCount;
+    // index 0 of the sequence is 0 in every base, start at 1 so the offsets centre on 0
+    _x = halton( _phase + 1, 2 ) - 0.5f;
+    _y = halton( _phase + 1, 3 ) - 0.5f;
+}
+
+void TemporalJitter::apply( float projection[ 16 ], uint32_t inputWidth, uint32_t inputHeight ) const {
+    // the image moves the other way from the samples, and ndc y points up
+    const float dx = -2.f * _x / (float)inputWidth;
+    const float dy = 2.f * _y / (float)inputHeight;
+
+    // a translation in ndc before the divide, so scaled by each column's w
+    for ( int c = 0; c < 4; ++c )
+    {
+        projection[ c * 4 + 0 ] += dx * projection[ c * 4 + 3 ];
+        projection[ c * 4 + 1 ] += dy * projection[ c * 4 + 3 ];
+    }
+}
+
+MotionHistory::MotionHistory( size_t count )
+: _count( count )
+, _transforms( count * 16 )
+, _previousTransforms( count * 16 )
+, _viewProjection{}
+, _previousViewProjection{}
+, _width( 0 )
+, _height( 0 )
+, _valid( false )
+, _reset( true ) {
+}
+
+bool MotionHistory::beginFrame( uint32_t inputWidth, uint32_t inputHeight ) {
+    _reset = !_valid || inputWidth != _width || inputHeight != _height;
+    _width = inputWidth;
+    _height = inputHeight;
+    _valid = true;
+
+    // every transform is set again this frame, so swapping is all the copying needed
+    _transforms.swap( _previousTransforms );
+    memcpy( _previousViewProjection, _viewProjection, sizeof( _viewProjection ) );
+    return _reset;
+}
+
+void MotionHistory::setViewProjection( const float viewProjection[ 16 ] ) {
+    memcpy( _viewProjection, viewProjection, sizeof( _viewProjection ) );
+    if ( _reset )
+    {
+        memcpy( _previousViewProjection, viewProjection, sizeof( _previousViewProjection ) );
+    }
+}
+
+void MotionHistory::setTransform( size_t index, const float transform[ 16 ] ) {
+    assert( index < _count );
+    memcpy( &_transforms[ index * 16 ], transform, 16 * sizeof( float ) );
+    if ( _reset )
+    {
+        memcpy( &_previousTransforms[ index * 16 ], transform, 16 * sizeof( float ) );
+    }
+}
+
+void motionVector( const float current[ 4 ], const float previous[ 4 ], float motion[ 2 ] ) {
+    motion[ 0 ] = ( previous[ 0 ] / previous[ 3 ] - current[ 0 ] / current[ 3 ] ) * 0.5f;
+    motion[ 1 ] = ( previous[ 1 ] / previous[ 3 ] - current[ 1 ] / current[ 3 ] ) * -0.5f;
+}
+
+const char kMotionVectorSource[] = R"(
+    float2 motionVector( float4 currentClip, float4 previousClip )
+    {
+        const float2 current = currentClip.xy / currentClip.w;
+        const float2 previous = previousClip.xy / previousClip.w;
+        return ( previous - current ) * float2( 0.5, -0.5 );
+    }
+)";
+
+CpuTemporalUpscaler::CpuTemporalUpscaler( uint32_t inputWidth, uint32_t inputHeight, uint32_t outputWidth, uint32_t outputHeight )
+: _inputWidth( inputWidth )
+, _inputHeight( inputHeight )
+, _outputWidth( outputWidth )
+, _outputHeight( outputHeight )
+, _history( (size_t)outputWidth * outputHeight * kChannels )
+, _output( (size_t)outputWidth * outputHeight * kChannels ) {
+}
+
+void CpuTemporalUpscaler::encode( const float* color, const float* motion, float jitterX, float jitterY, bool reset ) {
+    const int inW = (int)_inputWidth;
+    const int inH = (int)_inputHeight;
+    const int outW = (int)_outputWidth;
+    const int outH = (int)_outputHeight;
+    const float inputPerOutputX = (float)inW / (float)outW;
+    const float inputPerOutputY = (float)inH / (float)outH;
+
+    for ( int oy = 0; oy < outH; ++oy )
+    {
+        for ( int ox = 0; ox < outW; ++ox )
+        {
+            const float u = ( (float)ox + 0.5f ) / (float)outW;
+            const float v = ( (float)oy + 0.5f ) / (float)outH;
+
+            // the nearest sample of the new frame, input pixel k sampled at k + 0.5 + jitter
+            const float px = u * (float)inW;
+            const float py = v * (float)inH;
+            const int ix = std::clamp( (int)floorf( px - jitterX ), 0, inW - 1 );
+            const int iy = std::clamp( (int)floorf( py - jitterY ), 0, inH - 1 );
+            const float* sample = color + ( (size_t)iy * inW + ix ) * kChannels;
+            float* out = &_output[ ( (size_t)oy * outW + ox ) * kChannels ];
+
+            const float* m = motion + ( (size_t)iy * inW + ix ) * 2;
+            const float hu = u + m[ 0 ];
+            const float hv = v + m[ 1 ];
+            if ( reset || hu < 0.f || hu > 1.f || hv < 0.f || hv > 1.f )
+            {
+                memcpy( out, sample, kChannels * sizeof( float ) );
+                continue;
+            }
+
+            // bilinear history where the surface was last frame
+            const float hx = std::clamp( hu * (float)outW - 0.5f, 0.f, (float)( outW - 1 ) );
+            const float hy = std::clamp( hv * (float)outH - 0.5f, 0.f, (float)( outH - 1 ) );
+            const int x0 = (int)hx;
+            const int y0 = (int)hy;
+            const int x1 = std::min( x0 + 1, outW - 1 );
+            const int y1 = std::min( y0 + 1, outH - 1 );
+            const float fx = hx - (float)x0;
+            const float fy = hy - (float)y0;
+            const float* h00 = &_history[ ( (size_t)y0 * outW + x0 ) * kChannels ];
+            const float* h10 = &_history[ ( (size_t)y0 * outW + x1 ) * kChannels ];
+            const float* h01 = &_history[ ( (size_t)y1 * outW + x0 ) * kChannels ];
+            const float* h11 = &_history[ ( (size_t)y1 * outW + x1 ) * kChannels ];
+
+            // a sample on the output pixel's centre counts fully, one a pixel away not at all
+            const float dx = ( (float)ix + 0.5f + jitterX - px ) / inputPerOutputX;
+            const float dy = ( (float)iy + 0.5f + jitterY - py ) / inputPerOutputY;
+            const float weight = std::max( 0.f, 1.f - fabsf( dx ) ) * std::max( 0.f, 1.f - fabsf( dy ) ) * kSampleWeight;
+
+            for ( uint32_t c = 0; c < kChannels; ++c )
+            {
+                float h = ( h00[ c ] * ( 1.f - fx ) + h10[ c ] * fx ) * ( 1.f - fy )
+                        + ( h01[ c ] * ( 1.f - fx ) + h11[ c ] * fx ) * fy;
+
+                // history outside the colours around the sample is stale, disocclusion or
+                // a change in lighting, pull it back in
+                float lo = sample[ c ];
+                float hi = sample[ c ];
+                for ( int ny = std::max( iy - 1, 0 ); ny <= std::min( iy + 1, inH - 1 ); ++ny )
+                {
+                    for ( int nx = std::max( ix - 1, 0 ); nx <= std::min( ix + 1, inW - 1 ); ++nx )
+                    {
+                        const float s = color[ ( (size_t)ny * inW + nx ) * kChannels + c ];
+                        lo = std::min( lo, s );
+                        hi = std::max( hi, s );
+                    }
+                }
+                h = std::clamp( h, lo, hi );
+
+                out[ c ] = h + ( sample[ c ] - h ) * weight;
+            }
+        }
+    }
+
+    _history = _output;
+}
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file           : temporal_upscale.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_TEMPORAL_UPSCALE_HPP
+#define METAL_PLAYGROUND_TEMPORAL_UPSCALE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// the cpu side of temporal upscaling: a frame is rendered below the output resolution
+// with its projection nudged by a sub-pixel jitter, and an upscaler (MetalFX on the
+// gpu, CpuTemporalUpscaler here) accumulates the jittered frames into the output,
+// following the motion vectors to find each pixel in its history.
+//
+// conventions: jitter is in input pixels, x right and y down, and is where the frame's
+// samples lie relative to the pixel centres. motion vectors are in uv units, x right
+// and y down, and point from a pixel to where its surface was in the previous frame.
+
+// element index of the radical inverse sequence in base, in [ 0, 1 )
+float halton( uint32_t index, uint32_t base );
+
+// halton ( 2, 3 ) sub-pixel offsets. the more output pixels share an input pixel the
+// more phases it takes to cover them, 8 per output pixel per input pixel
+class TemporalJitter {
+private:
+    uint32_t _phaseCount;
+    uint32_t _phase;
+    float _x, _y;
+
+public:
+    TemporalJitter();
+
+    // starts over with a phase count for the scale between the sizes
+    void reset( uint32_t inputWidth, uint32_t inputHeight, uint32_t outputWidth, uint32_t outputHeight );
+
+    // moves to the next phase, once at the start of every frame
+    void advance();
+
+    float x() const { return _x; }
+    float y() const { return _y; }
+    uint32_t phase() const { return _phase; }
+    uint32_t phaseCount() const { return _phaseCount; }
+
+    // shifts a column major projection, like the samples' makePerspective, so its
+    // pixels sample at the jitter offset. works for perspective and orthographic
+    void apply( float projection[ 16 ], uint32_t inputWidth, uint32_t inputHeight ) const;
+};
+
+// the previous frame's view projection and instance transforms next to the current
+// ones, for motion vectors. the history belongs to one input size: changing it, or
+// invalidate() on a camera cut, starts a frame without history, whose motion is zero
+// and whose upscaler has to reset.
+class MotionHistory {
+private:
+    size_t _count;
+    std::vector<float> _transforms;
+    std::vector<float> _previousTransforms;
+    float _viewProjection[ 16 ];
+    float _previousViewProjection[ 16 ];
+    uint32_t _width, _height;
+    bool _valid;
+    bool _reset;
+
+public:
+    explicit MotionHistory( size_t count );
+
+    MotionHistory( const MotionHistory& ) = delete;
+    MotionHistory& operator=( const MotionHistory& ) = delete;
+
+    // the current frame becomes the previous one, returns true when the upscaler has to
+    // drop its history. every transform and the view projection are set after it
+    bool beginFrame( uint32_t inputWidth, uint32_t inputHeight );
+    void invalidate() { _valid = false; }
+
+    // unjittered, the jitter is not motion
+    void setViewProjection( const float viewProjection[ 16 ] );
+    void setTransform( size_t index, const float transform[ 16 ] );
+
+    size_t count() const { return _count; }
+    bool reset() const { return _reset; }
+    const float* viewProjection() const { return _viewProjection; }
+    const float* previousViewProjection() const { return _previousViewProjection; }
+    const float* transform( size_t index ) const { return &_transforms[ index * 16 ]; }
+    const float* previousTransform( size_t index ) const { return &_previousTransforms[ index * 16 ]; }
+};
+
+// motion of a point from its current and previous clip space positions, the formula
+// of kMotionVectorSource's motionVector()
+void motionVector( const float current[ 4 ], const float previous[ 4 ], float motion[ 2 ] );
+
+// msl for the vertex and fragment side of motion vectors:
+//
+//   float2 motionVector( float4 currentClip, float4 previousClip )
+//
+// interpolate both clip positions from the vertex shader, and divide in the fragment
+// shader. a motion texture in uv units is scaled to pixels with the scaler's
+// motionVectorScale set to the input size
+extern const char kMotionVectorSource[];
+
+// a small temporal upscaler on the cpu with the inputs MetalFX takes: jittered colour,
+// motion vectors, the jitter and a reset flag. every output pixel reprojects its
+// history, clamps it to the colours around it in the new frame and blends in the new
+// frame's sample, weighted by how close the sample fell. slow, it is the stand-in to
+// test jitter, motion and history handling against without a gpu.
+class CpuTemporalUpscaler {
+private:
+    uint32_t _inputWidth, _inputHeight;
+    uint32_t _outputWidth, _outputHeight;
+    std::vector<float> _history;
+    std::vector<float> _output;
+
+public:
+    static constexpr uint32_t kChannels = 4;
+
+    CpuTemporalUpscaler( uint32_t inputWidth, uint32_t inputHeight, uint32_t outputWidth, uint32_t outputHeight );
+
+    CpuTemporalUpscaler( const CpuTemporalUpscaler& ) = delete;
+    CpuTemporalUpscaler& operator=( const CpuTemporalUpscaler& ) = delete;
+
+    // color is rgba per input pixel, motion 2 floats per input pixel
+    void encode( const float* color, const float* motion, float jitterX, float jitterY, bool reset );
+
+    // rgba per output pixel
+    const float* output() const { return _output.data(); }
+    uint32_t outputWidth() const { return _outputWidth; }
+    uint32_t outputHeight() const { return _outputHeight; }
+};
+
+
+#endif //METAL_PLAYGROUND_TEMPORAL_UPSCALE_HPP
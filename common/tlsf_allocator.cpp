@@ -0,0 +1,378 @@
+/**
+  ******************************************************************************
+  * @file           : tlsf_allocator.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "tlsf_allocator.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+static int highestBit( uint32_t v )
+{
+    return 31 - __builtin_clz( v );
+}
+
+static int lowestBit( uint32_t v )
+{
+    return __builtin_ctz( v );
+}
+
+static uint32_t alignUp( uint32_t value, uint32_t align )
+{
+    return ( value + align - 1 ) & ~( align - 1 );
+}
+
+TlsfAllocator::TlsfAllocator( uint64_t capacity, uint64_t granularity )
+: _granularity(granularity)
+, _capacity(0)
+, _usedGranules(0)
+, _allocationCount(0)
+, _freeBlockCount(0)
+, _lastPhysical(0)
+, _firstLevelBitmap(0) {
+    assert( granularity && ( granularity & ( granularity - 1 ) ) == 0 );
+    assert( capacity / granularity > 0 && capacity / granularity <= UINT32_MAX );
+
+    _capacity = (uint32_t)( capacity / granularity );
+    std::fill( std::begin( _secondLevelBitmap ), std::end( _secondLevelBitmap ), 0u );
+    for ( auto& list : _freeLists )
+    {
+        std::fill( std::begin( list ), std::end( list ), kInvalidBlock );
+    }
+
+    // block 0 always starts at offset 0, nothing ever gets split off in front of it
+    uint32_t first = newBlock();
+    Block& b = _blocks[ first ];
+    b.offset = 0;
+    b.size = _capacity;
+    insertFree( first );
+}
+
+void TlsfAllocator::mapping( uint32_t size, int& fl, int& sl ) {
+    if ( size < kSecondLevelCount )
+    {
+        fl = 0;
+        sl = (int)size;
+        return;
+    }
+    const int msb = highestBit( size );
+    fl = msb - kSecondLevelBits + 1;
+    sl = (int)( size >> ( msb - kSecondLevelBits ) ) - kSecondLevelCount;
+}
+
+uint32_t TlsfAllocator::newBlock() {
+    uint32_t index;
+    if ( !_unusedBlocks.empty() )
+    {
+        index = _unusedBlocks.back();
+        _unusedBlocks.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)_blocks.size();
+        _blocks.emplace_back();
+    }
+    _blocks[ index ] = { 0, 0, 1, kInvalidBlock, kInvalidBlock, kInvalidBlock, kInvalidBlock, false };
+    return index;
+}
+
+void TlsfAllocator::insertFree( uint32_t block ) {
+    Block& b = _blocks[ block ];
+    int fl, sl;
+    mapping( b.size, fl, sl );
+
+    b.free = true;
+    b.prevFree = kInvalidBlock;
+    b.nextFree = _freeLists[ fl ][ sl ];
+    if ( b.nextFree != kInvalidBlock )
+    {
+        _blocks[ b.nextFree ].prevFree = block;
+    }
+    _freeLists[ fl ][ sl ] = block;
+
+    _firstLevelBitmap |= 1u << fl;
+    _secondLevelBitmap[ fl ] |= 1u << sl;
+    ++_freeBlockCount;
+}
+
+void TlsfAllocator::removeFree( uint32_t block ) {
+    Block& b = _blocks[ block ];
+    int fl, sl;
+    mapping( b.size, fl, sl );
+
+    if ( b.prevFree != kInvalidBlock )
+    {
+        _blocks[ b.prevFree ].nextFree = b.nextFree;
+    }
+    else
+    {
+        _freeLists[ fl ][ sl ] = b.nextFree;
+    }
+    if ( b.nextFree != kInvalidBlock )
+    {
+        _blocks[ b.nextFree ].prevFree = b.prevFree;
+    }
+
+    if ( _freeLists[ fl ][ sl ] == kInvalidBlock )
+    {
+        _secondLevelBitmap[ fl ] &= ~( 1u << sl );
+        if ( !_secondLevelBitmap[ fl ] )
+        {
+            _firstLevelBitmap &= ~( 1u << fl );
+        }
+    }
+
+    b.free = false;
+    --_freeBlockCount;
+}
+
+uint32_t TlsfAllocator::findFree( uint32_t size ) const {
+    // round up to the next bin boundary, every block in that bin is big enough
+    uint64_t rounded = size;
+    if ( size >= kSecondLevelCount )
+    {
+        rounded += ( 1ull << ( highestBit( size ) - kSecondLevelBits ) ) - 1;
+    }
+    if ( rounded > UINT32_MAX )
+    {
+        return kInvalidBlock;
+    }
+
+    int fl, sl;
+    mapping( (uint32_t)rounded, fl, sl );
+
+    uint32_t slMap = _secondLevelBitmap[ fl ] & ( ~0u << sl );
+    if ( !slMap )
+    {
+        const uint32_t flMap = fl + 1 < kFirstLevelCount ? _firstLevelBitmap & ( ~0u << ( fl + 1 ) ) : 0;
+        if ( !flMap )
+        {
+            return kInvalidBlock;
+        }
+        fl = lowestBit( flMap );
+        slMap = _secondLevelBitmap[ fl ];
+    }
+    return _freeLists[ fl ][ lowestBit( slMap ) ];
+}
+
+uint32_t TlsfAllocator::findAligned( uint32_t size, uint32_t align ) const {
+    // first fit in address order, the padding in front of the aligned start included
+    for ( uint32_t i = 0; i != kInvalidBlock; i = _blocks[ i ].nextPhysical )
+    {
+        const Block& f = _blocks[ i ];
+        if ( f.free && alignUp( f.offset, align ) - f.offset + size <= f.size )
+        {
+            return i;
+        }
+    }
+    return kInvalidBlock;
+}
+
+uint32_t TlsfAllocator::split( uint32_t block, uint32_t size ) {
+    // returns the remainder behind the first size granules of block
+    uint32_t rest = newBlock();
+    Block& b = _blocks[ block ];
+    Block& r = _blocks[ rest ];
+
+    r.offset = b.offset + size;
+    r.size = b.size - size;
+    r.prevPhysical = block;
+    r.nextPhysical = b.nextPhysical;
+    if ( b.nextPhysical != kInvalidBlock )
+    {
+        _blocks[ b.nextPhysical ].prevPhysical = rest;
+    }
+    else
+    {
+        _lastPhysical = rest;
+    }
+    b.nextPhysical = rest;
+    b.size = size;
+    return rest;
+}
+
+uint32_t TlsfAllocator::carve( uint32_t block, uint32_t size, uint32_t align ) {
+    // block is already off the free lists and big enough for size at align
+    const uint32_t pad = alignUp( _blocks[ block ].offset, align ) - _blocks[ block ].offset;
+    if ( pad )
+    {
+        uint32_t aligned = split( block, pad );
+        insertFree( block );
+        block = aligned;
+    }
+    if ( _blocks[ block ].size > size )
+    {
+        insertFree( split( block, size ) );
+    }
+
+    Block& b = _blocks[ block ];
+    b.free = false;
+    b.align = align;
+    _usedGranules += b.size;
+    ++_allocationCount;
+    return block;
+}
+
+uint32_t TlsfAllocator::merge( uint32_t block ) {
+    uint32_t prev = _blocks[ block ].prevPhysical;
+    if ( prev != kInvalidBlock && _blocks[ prev ].free )
+    {
+        removeFree( prev );
+        Block& p = _blocks[ prev ];
+        const Block& b = _blocks[ block ];
+        p.size += b.size;
+        p.nextPhysical = b.nextPhysical;
+        if ( b.nextPhysical != kInvalidBlock )
+        {
+            _blocks[ b.nextPhysical ].prevPhysical = prev;
+        }
+        else
+        {
+            _lastPhysical = prev;
+        }
+        _unusedBlocks.push_back( block );
+        block = prev;
+    }
+
+    uint32_t next = _blocks[ block ].nextPhysical;
+    if ( next != kInvalidBlock && _blocks[ next ].free )
+    {
+        removeFree( next );
+        Block& b = _blocks[ block ];
+        const Block& n = _blocks[ next ];
+        b.size += n.size;
+        b.nextPhysical = n.nextPhysical;
+        if ( n.nextPhysical != kInvalidBlock )
+        {
+            _blocks[ n.nextPhysical ].prevPhysical = block;
+        }
+        else
+        {
+            _lastPhysical = block;
+        }
+        _unusedBlocks.push_back( next );
+    }
+    return block;
+}
+
+TlsfAllocation TlsfAllocator::describe( uint32_t block ) const {
+    const Block& b = _blocks[ block ];
+    return { (uint64_t)b.offset * _granularity, (uint64_t)b.size * _granularity, block };
+}
+
+bool TlsfAllocator::allocate( uint64_t size, uint64_t align, TlsfAllocation& outAllocation ) {
+    const uint64_t granules = std::max<uint64_t>( ( size + _granularity - 1 ) / _granularity, 1 );
+    const uint64_t alignGranules = std::max<uint64_t>( align / _granularity, 1 );
+    assert( ( alignGranules & ( alignGranules - 1 ) ) == 0 );
+
+    if ( granules > _capacity )
+    {
+        return false;
+    }
+
+    // worst case the block starts just past an aligned offset
+    const uint64_t request = granules + alignGranules - 1;
+    uint32_t block = request <= _capacity ? findFree( (uint32_t)request ) : kInvalidBlock;
+    if ( block == kInvalidBlock )
+    {
+        // a block that happens to be aligned can still hold the exact size, e.g. all of
+        // a heap sized for one resource. only walked when the bins have nothing
+        block = findAligned( (uint32_t)granules, (uint32_t)alignGranules );
+        if ( block == kInvalidBlock )
+        {
+            return false;
+        }
+    }
+
+    removeFree( block );
+    outAllocation = describe( carve( block, (uint32_t)granules, (uint32_t)alignGranules ) );
+    return true;
+}
+
+void TlsfAllocator::free( const TlsfAllocation& allocation ) {
+    assert( allocation.block < _blocks.size() );
+    Block& b = _blocks[ allocation.block ];
+    assert( !b.free && (uint64_t)b.offset * _granularity == allocation.offset );
+
+    _usedGranules -= b.size;
+    --_allocationCount;
+    insertFree( merge( allocation.block ) );
+}
+
+size_t TlsfAllocator::defragment( size_t maxMoves, std::vector<Move>& outMoves ) {
+    // snapshot the used blocks from the top down, targets created below are not revisited
+    std::vector<uint32_t> candidates;
+    for ( uint32_t i = _lastPhysical; i != kInvalidBlock; i = _blocks[ i ].prevPhysical )
+    {
+        if ( !_blocks[ i ].free )
+        {
+            candidates.push_back( i );
+        }
+    }
+
+    size_t moves = 0;
+    for ( uint32_t source : candidates )
+    {
+        if ( moves == maxMoves )
+        {
+            break;
+        }
+
+        const uint32_t sourceOffset = _blocks[ source ].offset;
+        const uint32_t size = _blocks[ source ].size;
+        const uint32_t align = _blocks[ source ].align;
+
+        // lowest hole that fits, in address order
+        uint32_t target = kInvalidBlock;
+        for ( uint32_t i = 0; i != kInvalidBlock && _blocks[ i ].offset < sourceOffset; i = _blocks[ i ].nextPhysical )
+        {
+            const Block& f = _blocks[ i ];
+            if ( f.free && alignUp( f.offset, align ) - f.offset + size <= f.size )
+            {
+                target = i;
+                break;
+            }
+        }
+        if ( target == kInvalidBlock )
+        {
+            continue;
+        }
+
+        removeFree( target );
+        const uint32_t placed = carve( target, size, align );
+        outMoves.push_back( { describe( source ), describe( placed ) } );
+        ++moves;
+    }
+    return moves;
+}
+
+TlsfStats TlsfAllocator::stats() const {
+    TlsfStats s = {};
+    s.capacity = capacity();
+    s.usedBytes = (uint64_t)_usedGranules * _granularity;
+    s.freeBytes = s.capacity - s.usedBytes;
+    s.allocationCount = _allocationCount;
+    s.freeBlockCount = _freeBlockCount;
+
+    // the largest block sits in the highest non empty bin
+    if ( _firstLevelBitmap )
+    {
+        const int fl = highestBit( _firstLevelBitmap );
+        const int sl = highestBit( _secondLevelBitmap[ fl ] );
+        uint32_t largest = 0;
+        for ( uint32_t i = _freeLists[ fl ][ sl ]; i != kInvalidBlock; i = _blocks[ i ].nextFree )
+        {
+            largest = std::max( largest, _blocks[ i ].size );
+        }
+        s.largestFreeBytes = (uint64_t)largest * _granularity;
+    }
+    return s;
+}
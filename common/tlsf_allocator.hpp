@@ -0,0 +1,119 @@
+/**
+  ******************************************************************************
+  * @file           : tlsf_allocator.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_TLSF_ALLOCATOR_HPP
+#define METAL_PLAYGROUND_TLSF_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct TlsfAllocation
+{
+    uint64_t offset;
+    uint64_t size;
+    uint32_t block;
+};
+
+struct TlsfStats
+{
+    uint64_t capacity;
+    uint64_t usedBytes;
+    uint64_t freeBytes;
+    uint64_t largestFreeBytes;
+    size_t allocationCount;
+    size_t freeBlockCount;
+
+    // 0 when all free memory is one block, towards 1 the more it is scattered
+    float fragmentation() const { return freeBytes ? 1.f - (float)largestFreeBytes / (float)freeBytes : 0.f; }
+};
+
+// two level segregated fit allocator over an abstract range of [0, capacity) bytes.
+// it only hands out offsets, the memory itself lives somewhere else (a MTL::Heap).
+//
+// free blocks are binned by size: the first level is the power of two, the second
+// level splits every power of two into kSecondLevelCount linear steps. two bitmaps
+// find a non empty bin that fits in O(1); neighbours are merged on free.
+class TlsfAllocator {
+public:
+    static constexpr uint32_t kInvalidBlock = ~0u;
+
+    struct Move
+    {
+        TlsfAllocation from;
+        TlsfAllocation to;
+    };
+
+private:
+    static constexpr int kSecondLevelBits = 5;
+    static constexpr int kSecondLevelCount = 1 << kSecondLevelBits;
+    static constexpr int kFirstLevelCount = 32 - kSecondLevelBits + 1;
+
+    // sizes and offsets are kept in granules to keep everything 32 bit
+    struct Block
+    {
+        uint32_t offset;
+        uint32_t size;
+        uint32_t align;
+        uint32_t prevPhysical;
+        uint32_t nextPhysical;
+        uint32_t prevFree;
+        uint32_t nextFree;
+        bool free;
+    };
+
+    uint64_t _granularity;
+    uint32_t _capacity;
+    uint32_t _usedGranules;
+    size_t _allocationCount;
+    size_t _freeBlockCount;
+
+    std::vector<Block> _blocks;
+    std::vector<uint32_t> _unusedBlocks;
+    uint32_t _lastPhysical;
+
+    uint32_t _firstLevelBitmap;
+    uint32_t _secondLevelBitmap[ kFirstLevelCount ];
+    uint32_t _freeLists[ kFirstLevelCount ][ kSecondLevelCount ];
+
+    static void mapping( uint32_t size, int& fl, int& sl );
+    uint32_t newBlock();
+    void insertFree( uint32_t block );
+    void removeFree( uint32_t block );
+    uint32_t findFree( uint32_t size ) const;
+    uint32_t findAligned( uint32_t size, uint32_t align ) const;
+    uint32_t split( uint32_t block, uint32_t size );
+    uint32_t carve( uint32_t block, uint32_t size, uint32_t align );
+    uint32_t merge( uint32_t block );
+    TlsfAllocation describe( uint32_t block ) const;
+
+public:
+    // granularity is the smallest unit handed out, a power of two
+    TlsfAllocator( uint64_t capacity, uint64_t granularity = 256 );
+
+    // false when no free block can hold size bytes at align
+    bool allocate( uint64_t size, uint64_t align, TlsfAllocation& outAllocation );
+    void free( const TlsfAllocation& allocation );
+
+    // plans up to maxMoves moves of allocations into free space below them, highest
+    // offsets first. targets are already allocated when this returns, the sources
+    // are not touched: copy the data over, then free() every move's from.
+    size_t defragment( size_t maxMoves, std::vector<Move>& outMoves );
+
+    TlsfStats stats() const;
+    uint64_t capacity() const { return (uint64_t)_capacity * _granularity; }
+    size_t allocationCount() const { return _allocationCount; }
+    bool empty() const { return _allocationCount == 0; }
+};
+
+
+#endif //METAL_PLAYGROUND_TLSF_ALLOCATOR_HPP
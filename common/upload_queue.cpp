@@ -0,0 +1,268 @@
+/**
+  ******************************************************************************
+  * @file           : upload_queue.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "upload_queue.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// buffer to texture copies want the source offset aligned to the pixel size, stay generous
+static constexpr size_t kStagingAlign = 256;
+
+static size_t alignUp( size_t value, size_t align )
+{
+    return ( value + align - 1 ) / align * align;
+}
+
+UploadQueue::UploadQueue( CopyEngine& engine )
+: _engine(engine)
+, _ring((uint8_t*)engine.staging())
+, _ringCapacity(engine.stagingSize())
+, _ringHead(0)
+, _ringTail(0)
+, _ringLive(0)
+, _batching(false)
+, _quit(false)
+, _stats{}
+, _worker(&UploadQueue::workerMain, this) {
+}
+
+UploadQueue::~UploadQueue() {
+    // completion callbacks still point at us, let them all come back first
+    drain();
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _quit = true;
+    }
+    _wake.notify_all();
+    _worker.join();
+}
+
+bool UploadQueue::ringAllocate( size_t length, size_t align, size_t& outOffset ) {
+    if ( _ringLive == 0 )
+    {
+        _ringHead = 0;
+        _ringTail = 0;
+    }
+
+    // free space is [head, capacity) + [0, tail) while head is ahead of tail,
+    // [head, tail) once it has wrapped, and nothing when they meet
+    size_t start = alignUp( _ringHead, align );
+    if ( _ringLive == 0 || _ringHead > _ringTail )
+    {
+        if ( start + length > _ringCapacity )
+        {
+            if ( _ringLive == 0 || length > _ringTail )
+            {
+                return false;
+            }
+            start = 0;
+        }
+    }
+    else if ( _ringHead == _ringTail || start + length > _ringTail )
+    {
+        return false;
+    }
+
+    _ringHead = start + length;
+    ++_ringLive;
+    outOffset = start;
+    return true;
+}
+
+void UploadQueue::complete() {
+    std::vector<std::shared_ptr<Request>> finished;
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        Batch& batch = _inFlight.front();
+        _ringTail = batch.ringEnd;
+        _ringLive -= batch.allocations;
+        finished.swap( batch.finished );
+        _inFlight.pop_front();
+
+        const Clock::time_point now = Clock::now();
+        for ( const std::shared_ptr<Request>& r : finished )
+        {
+            const double latency = std::chrono::duration<double>( now - r->enqueued ).count();
+            _stats.latencySeconds += latency;
+            _stats.maxLatencySeconds = std::max( _stats.maxLatencySeconds, latency );
+        }
+    }
+    _batchDone.notify_all();
+
+    for ( const std::shared_ptr<Request>& r : finished )
+    {
+        r->promise.set_value();
+    }
+}
+
+void UploadQueue::enqueue( std::vector<Piece>& pieces ) {
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        for ( Piece& p : pieces )
+        {
+            _pending.push_back( std::move( p ) );
+        }
+        ++_stats.requests;
+    }
+    _wake.notify_one();
+}
+
+std::future<void> UploadQueue::uploadBuffer( MTL::Buffer* dst, size_t dstOffset, size_t length, Fill fill ) {
+    std::shared_ptr<Request> request = std::make_shared<Request>();
+    request->fill = std::move( fill );
+    request->enqueued = Clock::now();
+    std::future<void> future = request->promise.get_future();
+
+    if ( length == 0 )
+    {
+        request->promise.set_value();
+        return future;
+    }
+
+    const size_t maxPiece = _ringCapacity / 4;
+    std::vector<Piece> pieces;
+    for ( size_t offset = 0; offset < length; offset += maxPiece )
+    {
+        Piece p = {};
+        p.request = request;
+        p.sourceOffset = offset;
+        p.copy.length = std::min( maxPiece, length - offset );
+        p.copy.buffer = dst;
+        p.copy.dstOffset = dstOffset + offset;
+        p.last = offset + p.copy.length >= length;
+        pieces.push_back( std::move( p ) );
+    }
+
+    enqueue( pieces );
+    return future;
+}
+
+std::future<void> UploadQueue::uploadBuffer( MTL::Buffer* dst, size_t dstOffset, const void* data, size_t length ) {
+    return uploadBuffer( dst, dstOffset, length, [data]( void* out, size_t offset, size_t count ) {
+        memcpy( out, (const uint8_t*)data + offset, count );
+    } );
+}
+
+std::future<void> UploadQueue::uploadTexture( MTL::Texture* dst, uint32_t level, uint32_t width, uint32_t height, size_t bytesPerRow, Fill fill ) {
+    const size_t maxPiece = _ringCapacity / 4;
+    assert( bytesPerRow <= maxPiece );
+
+    std::shared_ptr<Request> request = std::make_shared<Request>();
+    request->fill = std::move( fill );
+    request->enqueued = Clock::now();
+    std::future<void> future = request->promise.get_future();
+
+    if ( height == 0 )
+    {
+        request->promise.set_value();
+        return future;
+    }
+
+    // bands of whole rows
+    const uint32_t rowsPerPiece = (uint32_t)std::max<size_t>( maxPiece / bytesPerRow, 1 );
+    std::vector<Piece> pieces;
+    for ( uint32_t row = 0; row < height; row += rowsPerPiece )
+    {
+        const uint32_t rows = std::min( rowsPerPiece, height - row );
+
+        Piece p = {};
+        p.request = request;
+        p.sourceOffset = row * bytesPerRow;
+        p.copy.length = rows * bytesPerRow;
+        p.copy.texture = dst;
+        p.copy.level = level;
+        p.copy.x = 0;
+        p.copy.y = row;
+        p.copy.width = width;
+        p.copy.height = rows;
+        p.copy.bytesPerRow = bytesPerRow;
+        p.last = row + rows >= height;
+        pieces.push_back( std::move( p ) );
+    }
+
+    enqueue( pieces );
+    return future;
+}
+
+void UploadQueue::workerMain() {
+    std::vector<UploadCopy> copies;
+
+    for ( ;; )
+    {
+        std::unique_lock<std::mutex> lock( _mutex );
+        _wake.wait( lock, [this] { return _quit || !_pending.empty(); } );
+        if ( _pending.empty() )
+        {
+            return;
+        }
+
+        // take pending pieces until half the ring is spoken for, so the next
+        // batch can be filled while this one is copied
+        _batching = true;
+        copies.clear();
+        Batch batch = {};
+        size_t batchBytes = 0;
+
+        while ( !_pending.empty() && batchBytes < _ringCapacity / 2 )
+        {
+            size_t offset = 0;
+            if ( !ringAllocate( _pending.front().copy.length, kStagingAlign, offset ) )
+            {
+                // submit what is there, or wait for older batches to free space
+                if ( !copies.empty() )
+                {
+                    break;
+                }
+                _batchDone.wait( lock, [&] { return ringAllocate( _pending.front().copy.length, kStagingAlign, offset ); } );
+            }
+
+            Piece piece = std::move( _pending.front() );
+            _pending.pop_front();
+            ++batch.allocations;
+
+            lock.unlock();
+            piece.request->fill( _ring + offset, piece.sourceOffset, piece.copy.length );
+            lock.lock();
+
+            piece.copy.srcOffset = offset;
+            copies.push_back( piece.copy );
+            batchBytes += piece.copy.length;
+            if ( piece.last )
+            {
+                batch.finished.push_back( piece.request );
+            }
+        }
+
+        batch.ringEnd = _ringHead;
+        _inFlight.push_back( std::move( batch ) );
+        _batching = false;
+
+        ++_stats.batches;
+        _stats.copies += copies.size();
+        _stats.bytes += batchBytes;
+        lock.unlock();
+
+        _engine.submit( copies.data(), copies.size(), [this] { complete(); } );
+    }
+}
+
+void UploadQueue::drain() {
+    std::unique_lock<std::mutex> lock( _mutex );
+    _batchDone.wait( lock, [this] { return _pending.empty() && _inFlight.empty() && !_batching; } );
+}
+
+UploadQueueStats UploadQueue::stats() {
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _stats;
+}
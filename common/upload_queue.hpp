@@ -0,0 +1,152 @@
+/**
+  ******************************************************************************
+  * @file           : upload_queue.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_UPLOAD_QUEUE_HPP
+#define METAL_PLAYGROUND_UPLOAD_QUEUE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MTL
+{
+    class Buffer;
+    class Texture;
+}
+
+// one copy out of the staging ring, either into a buffer or a texture region
+struct UploadCopy
+{
+    size_t srcOffset;
+    size_t length;
+
+    MTL::Buffer* buffer;
+    size_t dstOffset;
+
+    MTL::Texture* texture;
+    uint32_t level;
+    uint32_t x, y;
+    uint32_t width, height;
+    size_t bytesPerRow;
+};
+
+// the part of the queue that talks to the gpu. staging() is cpu visible memory the
+// copies read from; done must be called once every copy of a batch has landed.
+// batches complete in submission order.
+class CopyEngine {
+public:
+    virtual ~CopyEngine() = default;
+
+    virtual void* staging() = 0;
+    virtual size_t stagingSize() const = 0;
+    virtual void submit( const UploadCopy* copies, size_t count, std::function<void()> done ) = 0;
+};
+
+struct UploadQueueStats
+{
+    size_t requests;
+    size_t batches;
+    size_t copies;
+    uint64_t bytes;
+    double latencySeconds;      // summed over requests, enqueue to completion
+    double maxLatencySeconds;
+};
+
+// background upload service. callers enqueue uploads and get a future back,
+// a worker thread fills the staging ring, batches whatever is pending into one
+// submission and recycles ring space as batches complete.
+//
+// the fill callback runs on the worker thread and writes [offset, offset + length)
+// of the source into dst, so sources can be generated right into staging memory.
+// big uploads are split into pieces of at most a quarter of the ring.
+class UploadQueue {
+public:
+    using Fill = std::function<void(void* dst, size_t offset, size_t length)>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request
+    {
+        std::promise<void> promise;
+        Fill fill;
+        Clock::time_point enqueued;
+    };
+
+    struct Piece
+    {
+        std::shared_ptr<Request> request;
+        UploadCopy copy;
+        size_t sourceOffset;
+        bool last;
+    };
+
+    struct Batch
+    {
+        size_t ringEnd;
+        size_t allocations;
+        std::vector<std::shared_ptr<Request>> finished;
+    };
+
+    CopyEngine& _engine;
+    uint8_t* _ring;
+    size_t _ringCapacity;
+    size_t _ringHead;
+    size_t _ringTail;
+    size_t _ringLive;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _batchDone;
+    std::deque<Piece> _pending;
+    std::deque<Batch> _inFlight;
+    bool _batching;
+    bool _quit;
+
+    UploadQueueStats _stats;
+    std::thread _worker;
+
+    bool ringAllocate( size_t length, size_t align, size_t& outOffset );
+    void complete();
+    void enqueue( std::vector<Piece>& pieces );
+    void workerMain();
+
+public:
+    explicit UploadQueue( CopyEngine& engine );
+    ~UploadQueue();
+
+    UploadQueue( const UploadQueue& ) = delete;
+    UploadQueue& operator=( const UploadQueue& ) = delete;
+
+    std::future<void> uploadBuffer( MTL::Buffer* dst, size_t dstOffset, size_t length, Fill fill );
+    // data has to stay alive until the future is ready
+    std::future<void> uploadBuffer( MTL::Buffer* dst, size_t dstOffset, const void* data, size_t length );
+
+    // the source is height rows of bytesPerRow bytes, tightly packed
+    std::future<void> uploadTexture( MTL::Texture* dst, uint32_t level, uint32_t width, uint32_t height, size_t bytesPerRow, Fill fill );
+
+    // blocks until everything enqueued so far has completed
+    void drain();
+
+    UploadQueueStats stats();
+};
+
+
+#endif //METAL_PLAYGROUND_UPLOAD_QUEUE_HPP
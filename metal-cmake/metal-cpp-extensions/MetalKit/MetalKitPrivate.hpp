@@ -45,16 +45,26 @@
 #define  _MTK_PRIVATE_OBJC_LOOKUP_CLASS( symbol  )   objc_lookUpClass( # symbol ) 
 #endif // __OBJC__
 
+#if defined( METALCPP_LAZY_REGISTRATION )
+#define _MTK_PRIVATE_DEF_CLS( symbol )				::NS::Private::LazyClass		s_k ## symbol	_MTK_PRIVATE_VISIBILITY { # symbol };
+#define _MTK_PRIVATE_DEF_SEL( accessor, symbol )	 ::NS::Private::LazySelector	s_k ## accessor	_MTK_PRIVATE_VISIBILITY { symbol };
+#else
 #define _MTK_PRIVATE_DEF_CLS( symbol )			   void*				   s_k ## symbol	   _MTK_PRIVATE_VISIBILITY = _MTK_PRIVATE_OBJC_LOOKUP_CLASS( symbol );
 #define _MTK_PRIVATE_DEF_SEL( accessor, symbol )	 SEL					 s_k ## accessor	 _MTK_PRIVATE_VISIBILITY = sel_registerName( symbol );
+#endif // METALCPP_LAZY_REGISTRATION
 #define _MTK_PRIVATE_DEF_CONST( type, symbol )	   _NS_EXTERN type const   MTK ## symbo		_MTK_PRIVATE_IMPORT; \
 													 type const			  MTK::symbol	 = ( nullptr != &MTK ## symbol ) ? MTK ## symbol : nullptr;
 
 
 #else
 
+#if defined( METALCPP_LAZY_REGISTRATION )
+#define _MTK_PRIVATE_DEF_CLS( symbol )				extern ::NS::Private::LazyClass		s_k ## symbol;
+#define _MTK_PRIVATE_DEF_SEL( accessor, symbol )	 extern ::NS::Private::LazySelector	s_k ## accessor;
+#else
 #define _MTK_PRIVATE_DEF_CLS( symbol )				extern void*			s_k ## symbol;
 #define _MTK_PRIVATE_DEF_SEL( accessor, symbol )	 extern SEL			  s_k ## accessor;
+#endif // METALCPP_LAZY_REGISTRATION
 #define _MTK_PRIVATE_DEF_CONST( type, symbol )
 
 
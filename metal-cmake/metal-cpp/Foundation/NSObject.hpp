@@ -88,6 +88,8 @@ protected:
     static _Ret sendMessage(const void* pObj, SEL selector, _Args... args);
     template <typename _Ret, typename... _Args>
     static _Ret sendMessageSafe(const void* pObj, SEL selector, _Args... args);
+    template <typename _Ret, typename... _Args>
+    static _Ret sendMessageCached(Private::ImpCache& cache, const void* pObj, SEL selector, _Args... args);
 
 private:
     Object() = delete;
@@ -103,7 +105,8 @@ private:
 template <class _Class, class _Base /* = Object */>
 _NS_INLINE _Class* NS::Referencing<_Class, _Base>::retain()
 {
-    return Object::sendMessage<_Class*>(this, _NS_PRIVATE_SEL(retain));
+    static Private::ImpCache s_impCache;
+    return Object::sendMessageCached<_Class*>(s_impCache, this, _NS_PRIVATE_SEL(retain));
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -111,7 +114,8 @@ _NS_INLINE _Class* NS::Referencing<_Class, _Base>::retain()
 template <class _Class, class _Base /* = Object */>
 _NS_INLINE void NS::Referencing<_Class, _Base>::release()
 {
-    Object::sendMessage<void>(this, _NS_PRIVATE_SEL(release));
+    static Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _NS_PRIVATE_SEL(release));
 }
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -219,6 +223,29 @@ _NS_INLINE _Ret NS::Object::sendMessage(const void* pObj, SEL selector, _Args...
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
 
+template <typename _Ret, typename... _Args>
+_NS_INLINE _Ret NS::Object::sendMessageCached(Private::ImpCache& cache, const void* pObj, SEL selector, _Args... args)
+{
+#if defined(METALCPP_IMP_CACHE)
+    // an IMP is a plain function, struct and floating point returns need no special entry
+    // point. nil receivers keep objc_msgSend's zero result.
+    if (const IMP imp = cache.lookup(pObj, selector))
+    {
+        using MethodProc = _Ret (*)(const void*, SEL, _Args...);
+
+        const MethodProc pProc = reinterpret_cast<MethodProc>(imp);
+
+        return (*pProc)(pObj, selector, args...);
+    }
+#else
+    (void)cache;
+#endif // METALCPP_IMP_CACHE
+
+    return sendMessage<_Ret>(pObj, selector, args...);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+
 _NS_INLINE NS::MethodSignature* NS::Object::methodSignatureForSelector(const void* pObj, SEL selector)
 {
     return sendMessage<MethodSignature*>(pObj, _NS_PRIVATE_SEL(methodSignatureForSelector_), selector);
@@ -31,6 +31,217 @@
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
 
+#if defined(METALCPP_LAZY_REGISTRATION)
+
+#include <atomic>
+#include <cstdint>
+
+namespace NS
+{
+namespace Private
+{
+    // with METALCPP_LAZY_REGISTRATION the s_k* selectors, classes and protocols of every
+    // framework are resolved on first use instead of by static initializers in the
+    // *_PRIVATE_IMPLEMENTATION translation unit. the objects are constant initialized, and
+    // sel_registerName / objc_lookUpClass are idempotent and thread safe, so racing first
+    // uses store the same value and the cache needs no lock.
+    inline std::atomic<uint32_t> s_lazyResolveCount { 0 };
+
+    class LazySelector
+    {
+    public:
+        constexpr LazySelector(const char* pName)
+            : _pName(pName)
+            , _selector(nullptr)
+        {
+        }
+
+        operator SEL() const
+        {
+            SEL selector = _selector.load(std::memory_order_acquire);
+            return selector ? selector : resolve();
+        }
+
+    private:
+        const char*              _pName;
+        mutable std::atomic<SEL> _selector;
+
+        // out of line, the call sites only carry the load and the branch
+        __attribute__((noinline, cold)) SEL resolve() const
+        {
+            SEL selector = sel_registerName(_pName);
+            _selector.store(selector, std::memory_order_release);
+            s_lazyResolveCount.fetch_add(1, std::memory_order_relaxed);
+            return selector;
+        }
+    };
+
+    class LazyClass
+    {
+    public:
+        constexpr LazyClass(const char* pName, bool protocol = false)
+            : _pName(pName)
+            , _protocol(protocol)
+            , _pObject(nullptr)
+        {
+        }
+
+        // void* for sendMessage, Class for the runtime functions
+        template <typename _Type>
+        operator _Type*() const
+        {
+            void* pObject = _pObject.load(std::memory_order_acquire);
+            return static_cast<_Type*>(pObject ? pObject : resolve());
+        }
+
+    private:
+        const char*                _pName;
+        bool                       _protocol;
+        mutable std::atomic<void*> _pObject;
+
+        __attribute__((noinline, cold)) void* resolve() const
+        {
+#ifdef __OBJC__
+            void* pObject = _protocol ? (__bridge void*)objc_getProtocol(_pName) : (__bridge void*)objc_lookUpClass(_pName);
+#else
+            void* pObject = _protocol ? (void*)objc_getProtocol(_pName) : (void*)objc_lookUpClass(_pName);
+#endif // __OBJC__
+            _pObject.store(pObject, std::memory_order_release);
+            s_lazyResolveCount.fetch_add(1, std::memory_order_relaxed);
+            return pObject;
+        }
+    };
+
+    // selectors, classes and protocols resolved so far, for startup measurements
+    inline uint32_t lazyResolveCount()
+    {
+        return s_lazyResolveCount.load(std::memory_order_relaxed);
+    }
+} // Private
+} // NS
+
+#endif // METALCPP_LAZY_REGISTRATION
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#if defined(METALCPP_IMP_CACHE)
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace NS
+{
+namespace Private
+{
+    // with METALCPP_IMP_CACHE the hot messages (encoder state and draws, buffer contents,
+    // retain / release) call the method's IMP directly instead of going through
+    // objc_msgSend. every call site keeps a few (class, IMP) entries, picked by the
+    // receiver's class, so sites that see a handful of classes (retain / release) stay
+    // on the fast path. a class new to the site looks its entry up in a table shared by
+    // all call sites. entries are never freed, so a call site can hold plain pointers.
+    //
+    // methods added or replaced at runtime after the first call are not seen.
+    struct ImpCacheEntry
+    {
+        Class cls;
+        IMP   imp;
+    };
+
+    __attribute__((noinline, cold)) inline const ImpCacheEntry* findImp(Class cls, SEL selector)
+    {
+        struct Key
+        {
+            Class cls;
+            SEL   selector;
+
+            bool operator==(const Key& other) const { return cls == other.cls && selector == other.selector; }
+        };
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                return std::hash<const void*>()(key.cls) ^ (std::hash<const void*>()(key.selector) * 31);
+            }
+        };
+
+        // never destroyed, messages sent from static destructors still find the table
+        static std::mutex&                                        mutex = *new std::mutex;
+        static std::unordered_map<Key, const ImpCacheEntry*, KeyHash>& entries = *new std::unordered_map<Key, const ImpCacheEntry*, KeyHash>;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        const ImpCacheEntry*&       pEntry = entries[Key { cls, selector }];
+        if (!pEntry)
+        {
+            pEntry = new ImpCacheEntry { cls, class_getMethodImplementation(cls, selector) };
+        }
+        return pEntry;
+    }
+
+    class ImpCache
+    {
+    public:
+        static constexpr size_t kWays = 4;
+
+        constexpr ImpCache()
+            : _entries {}
+        {
+        }
+
+        // nullptr for nil receivers, known from the class rather than the pointer: a
+        // method called through a null this may have had its pointer test folded away
+        IMP lookup(const void* pObj, SEL selector)
+        {
+#ifdef __OBJC__
+            const Class cls = object_getClass((__bridge id)pObj);
+#else
+            const Class cls = object_getClass((id)pObj);
+#endif // __OBJC__
+            if (!cls)
+            {
+                return nullptr;
+            }
+
+            // classes are at least 16 byte aligned
+            std::atomic<const ImpCacheEntry*>& way = _entries[(reinterpret_cast<uintptr_t>(cls) >> 4) % kWays];
+
+            const ImpCacheEntry* pEntry = way.load(std::memory_order_acquire);
+            if (!pEntry || pEntry->cls != cls)
+            {
+                pEntry = findImp(cls, selector);
+                way.store(pEntry, std::memory_order_release);
+            }
+            return pEntry->imp;
+        }
+
+    private:
+        std::atomic<const ImpCacheEntry*> _entries[kWays];
+    };
+} // Private
+} // NS
+
+#else
+
+namespace NS
+{
+namespace Private
+{
+    // stands in at the call sites when the cache is off, sendMessageCached ignores it
+    class ImpCache
+    {
+    public:
+        constexpr ImpCache() { }
+    };
+} // Private
+} // NS
+
+#endif // METALCPP_IMP_CACHE
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+
 #if defined(NS_PRIVATE_IMPLEMENTATION)
 
 #ifdef METALCPP_SYMBOL_VISIBILITY_HIDDEN
@@ -49,18 +260,30 @@
 #define _NS_PRIVATE_OBJC_GET_PROTOCOL(symbol) objc_getProtocol(#symbol)
 #endif // __OBJC__
 
+#if defined(METALCPP_LAZY_REGISTRATION)
+#define _NS_PRIVATE_DEF_CLS(symbol) ::NS::Private::LazyClass s_k##symbol _NS_PRIVATE_VISIBILITY { #symbol }
+#define _NS_PRIVATE_DEF_PRO(symbol) ::NS::Private::LazyClass s_k##symbol _NS_PRIVATE_VISIBILITY { #symbol, true }
+#define _NS_PRIVATE_DEF_SEL(accessor, symbol) ::NS::Private::LazySelector s_k##accessor _NS_PRIVATE_VISIBILITY { symbol }
+#else
 #define _NS_PRIVATE_DEF_CLS(symbol) void* s_k##symbol _NS_PRIVATE_VISIBILITY = _NS_PRIVATE_OBJC_LOOKUP_CLASS(symbol)
 #define _NS_PRIVATE_DEF_PRO(symbol) void* s_k##symbol _NS_PRIVATE_VISIBILITY = _NS_PRIVATE_OBJC_GET_PROTOCOL(symbol)
 #define _NS_PRIVATE_DEF_SEL(accessor, symbol) SEL s_k##accessor _NS_PRIVATE_VISIBILITY = sel_registerName(symbol)
+#endif // METALCPP_LAZY_REGISTRATION
 #define _NS_PRIVATE_DEF_CONST(type, symbol)              \
     _NS_EXTERN type const NS##symbol _NS_PRIVATE_IMPORT; \
     type const                       NS::symbol = (nullptr != &NS##symbol) ? NS##symbol : nullptr
 
 #else
 
+#if defined(METALCPP_LAZY_REGISTRATION)
+#define _NS_PRIVATE_DEF_CLS(symbol) extern ::NS::Private::LazyClass s_k##symbol
+#define _NS_PRIVATE_DEF_PRO(symbol) extern ::NS::Private::LazyClass s_k##symbol
+#define _NS_PRIVATE_DEF_SEL(accessor, symbol) extern ::NS::Private::LazySelector s_k##accessor
+#else
 #define _NS_PRIVATE_DEF_CLS(symbol) extern void* s_k##symbol
 #define _NS_PRIVATE_DEF_PRO(symbol) extern void* s_k##symbol
 #define _NS_PRIVATE_DEF_SEL(accessor, symbol) extern SEL s_k##accessor
+#endif // METALCPP_LAZY_REGISTRATION
 #define _NS_PRIVATE_DEF_CONST(type, symbol) extern type const NS::symbol
 
 #endif // NS_PRIVATE_IMPLEMENTATION
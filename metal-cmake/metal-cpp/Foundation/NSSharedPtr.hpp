@@ -309,3 +309,182 @@ _NS_INLINE bool operator!=(const NS::SharedPtr<_ClassLhs>& lhs, const NS::Shared
 {
     return lhs.get() != rhs.get();
 }
+
+namespace NS
+{
+/**
+ * Move-only owner of one reference, built on SharedPtr.
+ * Moving hands the reference over without retain or release messages, get() and operator-> borrow the pointee
+ * at no cost. There is no copy, share() is the one place that sends retain.
+ *
+ * Take ownership from the SharedPtr factories:
+ *     NS::UniquePtr<MTL::Buffer> pBuffer = NS::TransferPtr(pDevice->newBuffer(size, options));
+ *     NS::UniquePtr<MTL::Device> pDevice = NS::RetainPtr(pBorrowedDevice);
+ */
+template <class _Class>
+class UniquePtr
+{
+public:
+    /**
+     * Create a new null pointer.
+     */
+    UniquePtr();
+
+    /**
+     * Take over the reference held by a SharedPtr, which is left null.
+     */
+    UniquePtr(SharedPtr<_Class>&& other) noexcept;
+
+    /**
+     * UniquePtr move constructor.
+     */
+    UniquePtr(UniquePtr<_Class>&& other) noexcept;
+
+    /**
+     * Move from another pointee type.
+     */
+    template <class _OtherClass>
+    UniquePtr(UniquePtr<_OtherClass>&& other, typename std::enable_if_t<std::is_convertible_v<_OtherClass *, _Class *>> * = nullptr) noexcept;
+
+    UniquePtr(const UniquePtr<_Class>& other) = delete;
+    UniquePtr& operator=(const UniquePtr<_Class>& other) = delete;
+
+    /**
+     * Move assignment operator.
+     * Releases the previous pointee, the moved-from object is reset to nullptr.
+     */
+    UniquePtr& operator=(UniquePtr<_Class>&& other) noexcept;
+
+    /**
+     * Take over the reference held by a SharedPtr, releasing the previous pointee.
+     */
+    UniquePtr& operator=(SharedPtr<_Class>&& other) noexcept;
+
+    /**
+     * Borrow the raw pointee, the reference count is unchanged.
+     */
+    _Class* get() const;
+
+    /**
+     * Call operations directly on the pointee.
+     */
+    _Class* operator->() const;
+
+    /**
+     * Implicit cast to bool.
+     */
+    explicit operator bool() const;
+
+    /**
+     * Another reference to the pointee, increasing the reference count.
+     */
+    SharedPtr<_Class> share() const;
+
+    /**
+     * Reset this UniquePtr to null, decreasing the reference count.
+     */
+    void reset();
+
+    /**
+     * Give up the reference without decreasing the reference count and return the pointee.
+     */
+    _Class* detach();
+
+private:
+    SharedPtr<_Class> m_ptr;
+};
+}
+
+template <class _Class>
+_NS_INLINE NS::UniquePtr<_Class>::UniquePtr()
+{
+}
+
+template <class _Class>
+_NS_INLINE NS::UniquePtr<_Class>::UniquePtr(NS::SharedPtr<_Class>&& other) noexcept
+    : m_ptr(static_cast<NS::SharedPtr<_Class>&&>(other))
+{
+}
+
+template <class _Class>
+_NS_INLINE NS::UniquePtr<_Class>::UniquePtr(NS::UniquePtr<_Class>&& other) noexcept
+    : m_ptr(static_cast<NS::SharedPtr<_Class>&&>(other.m_ptr))
+{
+}
+
+template <class _Class>
+template <class _OtherClass>
+_NS_INLINE NS::UniquePtr<_Class>::UniquePtr(NS::UniquePtr<_OtherClass>&& other, typename std::enable_if_t<std::is_convertible_v<_OtherClass *, _Class *>> *) noexcept
+    : m_ptr(NS::TransferPtr(reinterpret_cast<_Class*>(other.detach())))
+{
+}
+
+template <class _Class>
+_NS_INLINE NS::UniquePtr<_Class>& NS::UniquePtr<_Class>::operator=(NS::UniquePtr<_Class>&& other) noexcept
+{
+    if (this != &other)
+    {
+        m_ptr = static_cast<NS::SharedPtr<_Class>&&>(other.m_ptr);
+    }
+    return *this;
+}
+
+template <class _Class>
+_NS_INLINE NS::UniquePtr<_Class>& NS::UniquePtr<_Class>::operator=(NS::SharedPtr<_Class>&& other) noexcept
+{
+    m_ptr = static_cast<NS::SharedPtr<_Class>&&>(other);
+    return *this;
+}
+
+template <class _Class>
+_NS_INLINE _Class* NS::UniquePtr<_Class>::get() const
+{
+    return m_ptr.get();
+}
+
+template <class _Class>
+_NS_INLINE _Class* NS::UniquePtr<_Class>::operator->() const
+{
+    return m_ptr.get();
+}
+
+template <class _Class>
+_NS_INLINE NS::UniquePtr<_Class>::operator bool() const
+{
+    return nullptr != m_ptr.get();
+}
+
+template <class _Class>
+_NS_INLINE NS::SharedPtr<_Class> NS::UniquePtr<_Class>::share() const
+{
+    return m_ptr;
+}
+
+template <class _Class>
+_NS_INLINE void NS::UniquePtr<_Class>::reset()
+{
+    if (m_ptr)
+    {
+        m_ptr.reset();
+    }
+}
+
+template <class _Class>
+_NS_INLINE _Class* NS::UniquePtr<_Class>::detach()
+{
+    _Class* pObject = m_ptr.get();
+    m_ptr.detach();
+    return pObject;
+}
+
+template <class _ClassLhs, class _ClassRhs>
+_NS_INLINE bool operator==(const NS::UniquePtr<_ClassLhs>& lhs, const NS::UniquePtr<_ClassRhs>& rhs)
+{
+    return lhs.get() == rhs.get();
+}
+
+template <class _ClassLhs, class _ClassRhs>
+_NS_INLINE bool operator!=(const NS::UniquePtr<_ClassLhs>& lhs, const NS::UniquePtr<_ClassRhs>& rhs)
+{
+    return lhs.get() != rhs.get();
+}
@@ -57,19 +57,22 @@ public:
 // property: length
 _MTL_INLINE NS::UInteger MTL::Buffer::length() const
 {
-    return Object::sendMessage<NS::UInteger>(this, _MTL_PRIVATE_SEL(length));
+    static NS::Private::ImpCache s_impCache;
+    return Object::sendMessageCached<NS::UInteger>(s_impCache, this, _MTL_PRIVATE_SEL(length));
 }
 
 // method: contents
 _MTL_INLINE void* MTL::Buffer::contents()
 {
-    return Object::sendMessage<void*>(this, _MTL_PRIVATE_SEL(contents));
+    static NS::Private::ImpCache s_impCache;
+    return Object::sendMessageCached<void*>(s_impCache, this, _MTL_PRIVATE_SEL(contents));
 }
 
 // method: didModifyRange:
 _MTL_INLINE void MTL::Buffer::didModifyRange(NS::Range range)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(didModifyRange_), range);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(didModifyRange_), range);
 }
 
 // method: newTextureWithDescriptor:offset:bytesPerRow:
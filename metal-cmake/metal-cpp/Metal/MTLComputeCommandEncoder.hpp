@@ -136,19 +136,22 @@ _MTL_INLINE MTL::DispatchType MTL::ComputeCommandEncoder::dispatchType() const
 // method: setComputePipelineState:
 _MTL_INLINE void MTL::ComputeCommandEncoder::setComputePipelineState(const MTL::ComputePipelineState* state)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setComputePipelineState_), state);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setComputePipelineState_), state);
 }
 
 // method: setBytes:length:atIndex:
 _MTL_INLINE void MTL::ComputeCommandEncoder::setBytes(const void* bytes, NS::UInteger length, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setBytes_length_atIndex_), bytes, length, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setBytes_length_atIndex_), bytes, length, index);
 }
 
 // method: setBuffer:offset:atIndex:
 _MTL_INLINE void MTL::ComputeCommandEncoder::setBuffer(const MTL::Buffer* buffer, NS::UInteger offset, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setBuffer_offset_atIndex_), buffer, offset, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setBuffer_offset_atIndex_), buffer, offset, index);
 }
 
 // method: setBufferOffset:atIndex:
@@ -166,7 +169,8 @@ _MTL_INLINE void MTL::ComputeCommandEncoder::setBuffers(const MTL::Buffer* const
 // method: setBuffer:offset:attributeStride:atIndex:
 _MTL_INLINE void MTL::ComputeCommandEncoder::setBuffer(const MTL::Buffer* buffer, NS::UInteger offset, NS::UInteger stride, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setBuffer_offset_attributeStride_atIndex_), buffer, offset, stride, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setBuffer_offset_attributeStride_atIndex_), buffer, offset, stride, index);
 }
 
 // method: setBuffers:offsets:attributeStrides:withRange:
@@ -184,7 +188,8 @@ _MTL_INLINE void MTL::ComputeCommandEncoder::setBufferOffset(NS::UInteger offset
 // method: setBytes:length:attributeStride:atIndex:
 _MTL_INLINE void MTL::ComputeCommandEncoder::setBytes(const void* bytes, NS::UInteger length, NS::UInteger stride, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setBytes_length_attributeStride_atIndex_), bytes, length, stride, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setBytes_length_attributeStride_atIndex_), bytes, length, stride, index);
 }
 
 // method: setVisibleFunctionTable:atBufferIndex:
@@ -220,7 +225,8 @@ _MTL_INLINE void MTL::ComputeCommandEncoder::setAccelerationStructure(const MTL:
 // method: setTexture:atIndex:
 _MTL_INLINE void MTL::ComputeCommandEncoder::setTexture(const MTL::Texture* texture, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setTexture_atIndex_), texture, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setTexture_atIndex_), texture, index);
 }
 
 // method: setTextures:withRange:
@@ -280,19 +286,22 @@ _MTL_INLINE void MTL::ComputeCommandEncoder::setStageInRegion(const MTL::Buffer*
 // method: dispatchThreadgroups:threadsPerThreadgroup:
 _MTL_INLINE void MTL::ComputeCommandEncoder::dispatchThreadgroups(MTL::Size threadgroupsPerGrid, MTL::Size threadsPerThreadgroup)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(dispatchThreadgroups_threadsPerThreadgroup_), threadgroupsPerGrid, threadsPerThreadgroup);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(dispatchThreadgroups_threadsPerThreadgroup_), threadgroupsPerGrid, threadsPerThreadgroup);
 }
 
 // method: dispatchThreadgroupsWithIndirectBuffer:indirectBufferOffset:threadsPerThreadgroup:
 _MTL_INLINE void MTL::ComputeCommandEncoder::dispatchThreadgroups(const MTL::Buffer* indirectBuffer, NS::UInteger indirectBufferOffset, MTL::Size threadsPerThreadgroup)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(dispatchThreadgroupsWithIndirectBuffer_indirectBufferOffset_threadsPerThreadgroup_), indirectBuffer, indirectBufferOffset, threadsPerThreadgroup);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(dispatchThreadgroupsWithIndirectBuffer_indirectBufferOffset_threadsPerThreadgroup_), indirectBuffer, indirectBufferOffset, threadsPerThreadgroup);
 }
 
 // method: dispatchThreads:threadsPerThreadgroup:
 _MTL_INLINE void MTL::ComputeCommandEncoder::dispatchThreads(MTL::Size threadsPerGrid, MTL::Size threadsPerThreadgroup)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(dispatchThreads_threadsPerThreadgroup_), threadsPerGrid, threadsPerThreadgroup);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(dispatchThreads_threadsPerThreadgroup_), threadsPerGrid, threadsPerThreadgroup);
 }
 
 // method: updateFence:
@@ -26,6 +26,10 @@
 
 #include <objc/runtime.h>
 
+#if defined(METALCPP_LAZY_REGISTRATION)
+#include "../Foundation/NSPrivate.hpp"
+#endif // METALCPP_LAZY_REGISTRATION
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #define _MTL_PRIVATE_CLS(symbol) (Private::Class::s_k##symbol)
@@ -51,9 +55,15 @@
 #define _MTL_PRIVATE_OBJC_GET_PROTOCOL(symbol) objc_getProtocol(#symbol)
 #endif // __OBJC__
 
+#if defined(METALCPP_LAZY_REGISTRATION)
+#define _MTL_PRIVATE_DEF_CLS(symbol) ::NS::Private::LazyClass s_k##symbol _MTL_PRIVATE_VISIBILITY { #symbol }
+#define _MTL_PRIVATE_DEF_PRO(symbol) ::NS::Private::LazyClass s_k##symbol _MTL_PRIVATE_VISIBILITY { #symbol, true }
+#define _MTL_PRIVATE_DEF_SEL(accessor, symbol) ::NS::Private::LazySelector s_k##accessor _MTL_PRIVATE_VISIBILITY { symbol }
+#else
 #define _MTL_PRIVATE_DEF_CLS(symbol) void* s_k##symbol _MTL_PRIVATE_VISIBILITY = _MTL_PRIVATE_OBJC_LOOKUP_CLASS(symbol)
 #define _MTL_PRIVATE_DEF_PRO(symbol) void* s_k##symbol _MTL_PRIVATE_VISIBILITY = _MTL_PRIVATE_OBJC_GET_PROTOCOL(symbol)
 #define _MTL_PRIVATE_DEF_SEL(accessor, symbol) SEL s_k##accessor _MTL_PRIVATE_VISIBILITY = sel_registerName(symbol)
+#endif // METALCPP_LAZY_REGISTRATION
 
 #include <dlfcn.h>
 #define MTL_DEF_FUNC( name, signature ) \
@@ -101,9 +111,15 @@ namespace MTL::Private
 
 #else
 
+#if defined(METALCPP_LAZY_REGISTRATION)
+#define _MTL_PRIVATE_DEF_CLS(symbol) extern ::NS::Private::LazyClass s_k##symbol
+#define _MTL_PRIVATE_DEF_PRO(symbol) extern ::NS::Private::LazyClass s_k##symbol
+#define _MTL_PRIVATE_DEF_SEL(accessor, symbol) extern ::NS::Private::LazySelector s_k##accessor
+#else
 #define _MTL_PRIVATE_DEF_CLS(symbol) extern void* s_k##symbol
 #define _MTL_PRIVATE_DEF_PRO(symbol) extern void* s_k##symbol
 #define _MTL_PRIVATE_DEF_SEL(accessor, symbol) extern SEL s_k##accessor
+#endif // METALCPP_LAZY_REGISTRATION
 #define _MTL_PRIVATE_DEF_STR(type, symbol) extern type const MTL::symbol
 #define _MTL_PRIVATE_DEF_CONST(type, symbol) extern type const MTL::symbol
 #define _MTL_PRIVATE_DEF_WEAK_CONST(type, symbol) extern type const MTL::symbol
@@ -405,19 +405,22 @@ public:
 // method: setRenderPipelineState:
 _MTL_INLINE void MTL::RenderCommandEncoder::setRenderPipelineState(const MTL::RenderPipelineState* pipelineState)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setRenderPipelineState_), pipelineState);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setRenderPipelineState_), pipelineState);
 }
 
 // method: setVertexBytes:length:atIndex:
 _MTL_INLINE void MTL::RenderCommandEncoder::setVertexBytes(const void* bytes, NS::UInteger length, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setVertexBytes_length_atIndex_), bytes, length, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setVertexBytes_length_atIndex_), bytes, length, index);
 }
 
 // method: setVertexBuffer:offset:atIndex:
 _MTL_INLINE void MTL::RenderCommandEncoder::setVertexBuffer(const MTL::Buffer* buffer, NS::UInteger offset, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setVertexBuffer_offset_atIndex_), buffer, offset, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setVertexBuffer_offset_atIndex_), buffer, offset, index);
 }
 
 // method: setVertexBufferOffset:atIndex:
@@ -435,7 +438,8 @@ _MTL_INLINE void MTL::RenderCommandEncoder::setVertexBuffers(const MTL::Buffer*
 // method: setVertexBuffer:offset:attributeStride:atIndex:
 _MTL_INLINE void MTL::RenderCommandEncoder::setVertexBuffer(const MTL::Buffer* buffer, NS::UInteger offset, NS::UInteger stride, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setVertexBuffer_offset_attributeStride_atIndex_), buffer, offset, stride, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setVertexBuffer_offset_attributeStride_atIndex_), buffer, offset, stride, index);
 }
 
 // method: setVertexBuffers:offsets:attributeStrides:withRange:
@@ -453,13 +457,15 @@ _MTL_INLINE void MTL::RenderCommandEncoder::setVertexBufferOffset(NS::UInteger o
 // method: setVertexBytes:length:attributeStride:atIndex:
 _MTL_INLINE void MTL::RenderCommandEncoder::setVertexBytes(const void* bytes, NS::UInteger length, NS::UInteger stride, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setVertexBytes_length_attributeStride_atIndex_), bytes, length, stride, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setVertexBytes_length_attributeStride_atIndex_), bytes, length, stride, index);
 }
 
 // method: setVertexTexture:atIndex:
 _MTL_INLINE void MTL::RenderCommandEncoder::setVertexTexture(const MTL::Texture* texture, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setVertexTexture_atIndex_), texture, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setVertexTexture_atIndex_), texture, index);
 }
 
 // method: setVertexTextures:withRange:
@@ -585,13 +591,15 @@ _MTL_INLINE void MTL::RenderCommandEncoder::setTriangleFillMode(MTL::TriangleFil
 // method: setFragmentBytes:length:atIndex:
 _MTL_INLINE void MTL::RenderCommandEncoder::setFragmentBytes(const void* bytes, NS::UInteger length, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setFragmentBytes_length_atIndex_), bytes, length, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setFragmentBytes_length_atIndex_), bytes, length, index);
 }
 
 // method: setFragmentBuffer:offset:atIndex:
 _MTL_INLINE void MTL::RenderCommandEncoder::setFragmentBuffer(const MTL::Buffer* buffer, NS::UInteger offset, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setFragmentBuffer_offset_atIndex_), buffer, offset, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setFragmentBuffer_offset_atIndex_), buffer, offset, index);
 }
 
 // method: setFragmentBufferOffset:atIndex:
@@ -609,7 +617,8 @@ _MTL_INLINE void MTL::RenderCommandEncoder::setFragmentBuffers(const MTL::Buffer
 // method: setFragmentTexture:atIndex:
 _MTL_INLINE void MTL::RenderCommandEncoder::setFragmentTexture(const MTL::Texture* texture, NS::UInteger index)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setFragmentTexture_atIndex_), texture, index);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setFragmentTexture_atIndex_), texture, index);
 }
 
 // method: setFragmentTextures:withRange:
@@ -681,7 +690,8 @@ _MTL_INLINE void MTL::RenderCommandEncoder::setBlendColor(float red, float green
 // method: setDepthStencilState:
 _MTL_INLINE void MTL::RenderCommandEncoder::setDepthStencilState(const MTL::DepthStencilState* depthStencilState)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(setDepthStencilState_), depthStencilState);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(setDepthStencilState_), depthStencilState);
 }
 
 // method: setStencilReferenceValue:
@@ -885,49 +895,57 @@ _MTL_INLINE void MTL::RenderCommandEncoder::drawMeshThreadgroups(const MTL::Buff
 // method: drawPrimitives:vertexStart:vertexCount:instanceCount:
 _MTL_INLINE void MTL::RenderCommandEncoder::drawPrimitives(MTL::PrimitiveType primitiveType, NS::UInteger vertexStart, NS::UInteger vertexCount, NS::UInteger instanceCount)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(drawPrimitives_vertexStart_vertexCount_instanceCount_), primitiveType, vertexStart, vertexCount, instanceCount);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(drawPrimitives_vertexStart_vertexCount_instanceCount_), primitiveType, vertexStart, vertexCount, instanceCount);
 }
 
 // method: drawPrimitives:vertexStart:vertexCount:
 _MTL_INLINE void MTL::RenderCommandEncoder::drawPrimitives(MTL::PrimitiveType primitiveType, NS::UInteger vertexStart, NS::UInteger vertexCount)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(drawPrimitives_vertexStart_vertexCount_), primitiveType, vertexStart, vertexCount);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(drawPrimitives_vertexStart_vertexCount_), primitiveType, vertexStart, vertexCount);
 }
 
 // method: drawIndexedPrimitives:indexCount:indexType:indexBuffer:indexBufferOffset:instanceCount:
 _MTL_INLINE void MTL::RenderCommandEncoder::drawIndexedPrimitives(MTL::PrimitiveType primitiveType, NS::UInteger indexCount, MTL::IndexType indexType, const MTL::Buffer* indexBuffer, NS::UInteger indexBufferOffset, NS::UInteger instanceCount)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(drawIndexedPrimitives_indexCount_indexType_indexBuffer_indexBufferOffset_instanceCount_), primitiveType, indexCount, indexType, indexBuffer, indexBufferOffset, instanceCount);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(drawIndexedPrimitives_indexCount_indexType_indexBuffer_indexBufferOffset_instanceCount_), primitiveType, indexCount, indexType, indexBuffer, indexBufferOffset, instanceCount);
 }
 
 // method: drawIndexedPrimitives:indexCount:indexType:indexBuffer:indexBufferOffset:
 _MTL_INLINE void MTL::RenderCommandEncoder::drawIndexedPrimitives(MTL::PrimitiveType primitiveType, NS::UInteger indexCount, MTL::IndexType indexType, const MTL::Buffer* indexBuffer, NS::UInteger indexBufferOffset)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(drawIndexedPrimitives_indexCount_indexType_indexBuffer_indexBufferOffset_), primitiveType, indexCount, indexType, indexBuffer, indexBufferOffset);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(drawIndexedPrimitives_indexCount_indexType_indexBuffer_indexBufferOffset_), primitiveType, indexCount, indexType, indexBuffer, indexBufferOffset);
 }
 
 // method: drawPrimitives:vertexStart:vertexCount:instanceCount:baseInstance:
 _MTL_INLINE void MTL::RenderCommandEncoder::drawPrimitives(MTL::PrimitiveType primitiveType, NS::UInteger vertexStart, NS::UInteger vertexCount, NS::UInteger instanceCount, NS::UInteger baseInstance)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(drawPrimitives_vertexStart_vertexCount_instanceCount_baseInstance_), primitiveType, vertexStart, vertexCount, instanceCount, baseInstance);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(drawPrimitives_vertexStart_vertexCount_instanceCount_baseInstance_), primitiveType, vertexStart, vertexCount, instanceCount, baseInstance);
 }
 
 // method: drawIndexedPrimitives:indexCount:indexType:indexBuffer:indexBufferOffset:instanceCount:baseVertex:baseInstance:
 _MTL_INLINE void MTL::RenderCommandEncoder::drawIndexedPrimitives(MTL::PrimitiveType primitiveType, NS::UInteger indexCount, MTL::IndexType indexType, const MTL::Buffer* indexBuffer, NS::UInteger indexBufferOffset, NS::UInteger instanceCount, NS::Integer baseVertex, NS::UInteger baseInstance)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(drawIndexedPrimitives_indexCount_indexType_indexBuffer_indexBufferOffset_instanceCount_baseVertex_baseInstance_), primitiveType, indexCount, indexType, indexBuffer, indexBufferOffset, instanceCount, baseVertex, baseInstance);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(drawIndexedPrimitives_indexCount_indexType_indexBuffer_indexBufferOffset_instanceCount_baseVertex_baseInstance_), primitiveType, indexCount, indexType, indexBuffer, indexBufferOffset, instanceCount, baseVertex, baseInstance);
 }
 
 // method: drawPrimitives:indirectBuffer:indirectBufferOffset:
 _MTL_INLINE void MTL::RenderCommandEncoder::drawPrimitives(MTL::PrimitiveType primitiveType, const MTL::Buffer* indirectBuffer, NS::UInteger indirectBufferOffset)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(drawPrimitives_indirectBuffer_indirectBufferOffset_), primitiveType, indirectBuffer, indirectBufferOffset);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(drawPrimitives_indirectBuffer_indirectBufferOffset_), primitiveType, indirectBuffer, indirectBufferOffset);
 }
 
 // method: drawIndexedPrimitives:indexType:indexBuffer:indexBufferOffset:indirectBuffer:indirectBufferOffset:
 _MTL_INLINE void MTL::RenderCommandEncoder::drawIndexedPrimitives(MTL::PrimitiveType primitiveType, MTL::IndexType indexType, const MTL::Buffer* indexBuffer, NS::UInteger indexBufferOffset, const MTL::Buffer* indirectBuffer, NS::UInteger indirectBufferOffset)
 {
-    Object::sendMessage<void>(this, _MTL_PRIVATE_SEL(drawIndexedPrimitives_indexType_indexBuffer_indexBufferOffset_indirectBuffer_indirectBufferOffset_), primitiveType, indexType, indexBuffer, indexBufferOffset, indirectBuffer, indirectBufferOffset);
+    static NS::Private::ImpCache s_impCache;
+    Object::sendMessageCached<void>(s_impCache, this, _MTL_PRIVATE_SEL(drawIndexedPrimitives_indexType_indexBuffer_indexBufferOffset_indirectBuffer_indirectBufferOffset_), primitiveType, indexType, indexBuffer, indexBufferOffset, indirectBuffer, indirectBufferOffset);
 }
 
 // method: textureBarrier
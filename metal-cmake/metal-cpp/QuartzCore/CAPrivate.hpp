@@ -26,6 +26,10 @@
 
 #include <objc/runtime.h>
 
+#if defined(METALCPP_LAZY_REGISTRATION)
+#include "../Foundation/NSPrivate.hpp"
+#endif // METALCPP_LAZY_REGISTRATION
+
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #define _CA_PRIVATE_CLS(symbol) (Private::Class::s_k##symbol)
@@ -51,18 +55,30 @@
 #define _CA_PRIVATE_OBJC_GET_PROTOCOL(symbol) objc_getProtocol(#symbol)
 #endif // __OBJC__
 
+#if defined(METALCPP_LAZY_REGISTRATION)
+#define _CA_PRIVATE_DEF_CLS(symbol) ::NS::Private::LazyClass s_k##symbol _CA_PRIVATE_VISIBILITY { #symbol }
+#define _CA_PRIVATE_DEF_PRO(symbol) ::NS::Private::LazyClass s_k##symbol _CA_PRIVATE_VISIBILITY { #symbol, true }
+#define _CA_PRIVATE_DEF_SEL(accessor, symbol) ::NS::Private::LazySelector s_k##accessor _CA_PRIVATE_VISIBILITY { symbol }
+#else
 #define _CA_PRIVATE_DEF_CLS(symbol) void* s_k##symbol _CA_PRIVATE_VISIBILITY = _CA_PRIVATE_OBJC_LOOKUP_CLASS(symbol)
 #define _CA_PRIVATE_DEF_PRO(symbol) void* s_k##symbol _CA_PRIVATE_VISIBILITY = _CA_PRIVATE_OBJC_GET_PROTOCOL(symbol)
 #define _CA_PRIVATE_DEF_SEL(accessor, symbol) SEL s_k##accessor _CA_PRIVATE_VISIBILITY = sel_registerName(symbol)
+#endif // METALCPP_LAZY_REGISTRATION
 #define _CA_PRIVATE_DEF_STR(type, symbol)                \
     _CA_EXTERN type const CA##symbol _CA_PRIVATE_IMPORT; \
     type const                       CA::symbol = (nullptr != &CA##symbol) ? CA##symbol : nullptr
 
 #else
 
+#if defined(METALCPP_LAZY_REGISTRATION)
+#define _CA_PRIVATE_DEF_CLS(symbol) extern ::NS::Private::LazyClass s_k##symbol
+#define _CA_PRIVATE_DEF_PRO(symbol) extern ::NS::Private::LazyClass s_k##symbol
+#define _CA_PRIVATE_DEF_SEL(accessor, symbol) extern ::NS::Private::LazySelector s_k##accessor
+#else
 #define _CA_PRIVATE_DEF_CLS(symbol) extern void* s_k##symbol
 #define _CA_PRIVATE_DEF_PRO(symbol) extern void* s_k##symbol
 #define _CA_PRIVATE_DEF_SEL(accessor, symbol) extern SEL s_k##accessor
+#endif // METALCPP_LAZY_REGISTRATION
 #define _CA_PRIVATE_DEF_STR(type, symbol) extern type const CA::symbol
 
 #endif // CA_PRIVATE_IMPLEMENTATION
@@ -12,6 +12,8 @@
 
 #include "renderer.hpp"
 
+#include <string>
+
 static constexpr size_t kMaxFramesInFlight = 3;
 static constexpr size_t kNumInstances = 32;
 
@@ -60,7 +62,7 @@ void Renderer::draw(MTK::View *view) {
 
     const float scl = 0.1f;
 
-    InstanceData* pInstanceData = reinterpret_cast<InstanceData *>(pInstanceDataBuffer->contents());
+    shader_types::InstanceData* pInstanceData = reinterpret_cast<shader_types::InstanceData *>(pInstanceDataBuffer->contents());
     for ( size_t i = 0; i < kNumInstances; ++i )
     {
         float iDivNumInstances = i / (float)kNumInstances;
@@ -102,10 +104,7 @@ void Renderer::draw(MTK::View *view) {
 void Renderer::buildShaders() {
     using NS::StringEncoding::UTF8StringEncoding;
 
-    const char* shaderSrc = R"(
-        #include <metal_stdlib>
-        using namespace metal;
-
+    const char* shaderBody = R"(
         struct v2f
         {
             float4 position [[position]];
@@ -117,12 +116,6 @@ void Renderer::buildShaders() {
             float3 position;
         };
 
-        struct InstanceData
-        {
-            float4x4 instanceTransform;
-            float4 instanceColor;
-        };
-
         v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
                                device const InstanceData* instanceData [[buffer(1)]],
                                uint vertexId [[vertex_id]],
@@ -141,8 +134,12 @@ void Renderer::buildShaders() {
         }
     )";
 
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kInstanceDataSource
+                                + shaderBody;
+
     NS::Error* error = nullptr;
-    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc, UTF8StringEncoding), nullptr, &error);
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
     if(!library) {
         __builtin_printf("%s", error->localizedDescription()->utf8String());
         assert(false);
@@ -205,7 +202,7 @@ void Renderer::buildBuffers() {
     using NS::StringEncoding::UTF8StringEncoding;
     assert( _shaderLibrary );
 
-    const size_t instanceDataSize = kMaxFramesInFlight * kNumInstances * sizeof(InstanceData);
+    const size_t instanceDataSize = kMaxFramesInFlight * kNumInstances * sizeof(shader_types::InstanceData);
 
     for (size_t i = 0; i < kMaxFramesInFlight; ++i) {
         _instanceDataBuffer[i] = _device->newBuffer(instanceDataSize, MTL::ResourceStorageModeManaged);
@@ -19,11 +19,7 @@
 
 #include <simd/simd.h>
 
-struct InstanceData
-{
-    simd::float4x4 instanceTransform;
-    simd::float4 instanceColor;
-};
+#include "shader_types.hpp"
 
 class Renderer {
 private:
@@ -0,0 +1,27 @@
+/**
+  ******************************************************************************
+  * @file           : shader_types.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SHADER_TYPES_HPP
+#define METAL_PLAYGROUND_SHADER_TYPES_HPP
+
+#include "shader_struct.hpp"
+
+namespace shader_types
+{
+#define INSTANCE_DATA_FIELDS( F )               \
+    F( float4x4, instanceTransform )            \
+    F( float4, instanceColor )
+
+    SHADER_STRUCT( InstanceData, INSTANCE_DATA_FIELDS );
+}
+
+#endif //METAL_PLAYGROUND_SHADER_TYPES_HPP
@@ -13,15 +13,18 @@
 #include "renderer.hpp"
 #include "math.hpp"
 
+#include <string>
+#include <utility>
+
 static constexpr size_t kMaxFramesInFlight = 3;
 static constexpr size_t kNumInstances = 32;
 
 Renderer::Renderer(MTL::Device *device)
-: _device(device->retain())
+: _device(NS::RetainPtr(device))
 , _angle(0.f)
 , _frame(0) {
 
-    _commandQueue = _device->newCommandQueue();
+    _commandQueue = NS::TransferPtr(_device->newCommandQueue());
     buildShaders();
     buildDepthStencilStates();
     buildBuffers();
@@ -30,23 +33,6 @@ Renderer::Renderer(MTL::Device *device)
 }
 
 Renderer::~Renderer() {
-    _commandQueue->release();
-    _device->release();
-    _PSO->release();
-
-    _shaderLibrary->release();
-    _vertexDataBuffer->release();
-    _indexBuffer->release();
-    _depthStencilState->release();
-
-    for ( int i = 0; i < kMaxFramesInFlight; ++i )
-    {
-        _instanceDataBuffer[i]->release();
-    }
-    for ( int i = 0; i < kMaxFramesInFlight; ++i )
-    {
-        _cameraDataBuffer[i]->release();
-    }
 }
 
 void Renderer::draw(MTK::View *view) {
@@ -58,7 +44,7 @@ void Renderer::draw(MTK::View *view) {
     NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
 
     _frame = (_frame + 1) % kMaxFramesInFlight;
-    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ].get();
 
     MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
     dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
@@ -70,7 +56,7 @@ void Renderer::draw(MTK::View *view) {
 
     const float scl = 0.1f;
 
-    InstanceData* pInstanceData = reinterpret_cast<InstanceData *>(pInstanceDataBuffer->contents());
+    shader_types::InstanceData* pInstanceData = reinterpret_cast<shader_types::InstanceData *>(pInstanceDataBuffer->contents());
 
     float3 objectPosition = { 0.f, 0.f, -5.f };
 
@@ -101,21 +87,21 @@ void Renderer::draw(MTK::View *view) {
 
     // Update camera state:
 
-    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
-    CameraData* pCameraData = reinterpret_cast< CameraData *>( pCameraDataBuffer->contents() );
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ].get();
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( pCameraDataBuffer->contents() );
     pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
     pCameraData->worldTransform = Math::makeIdentity();
-    pCameraDataBuffer->didModifyRange( NS::Range::Make( 0, sizeof( CameraData ) ) );
+    pCameraDataBuffer->didModifyRange( NS::Range::Make( 0, sizeof( shader_types::CameraData ) ) );
 
     // begin render pass
 
     MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
     MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
     // add draw calls here
-    enc->setRenderPipelineState(_PSO);
-    enc->setDepthStencilState( _depthStencilState );
+    enc->setRenderPipelineState(_PSO.get());
+    enc->setDepthStencilState( _depthStencilState.get() );
 
-    enc->setVertexBuffer(_vertexDataBuffer, 0, 0);
+    enc->setVertexBuffer(_vertexDataBuffer.get(), 0, 0);
     enc->setVertexBuffer(pInstanceDataBuffer, 0, 1);
     enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
 
@@ -124,7 +110,7 @@ void Renderer::draw(MTK::View *view) {
 
     enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
                                  6 * 6, MTL::IndexType::IndexTypeUInt16,
-                                 _indexBuffer,
+                                 _indexBuffer.get(),
                                  0,
                                  kNumInstances );
 
@@ -138,10 +124,7 @@ void Renderer::draw(MTK::View *view) {
 void Renderer::buildShaders() {
     using NS::StringEncoding::UTF8StringEncoding;
 
-    const char* shaderSrc = R"(
-        #include <metal_stdlib>
-        using namespace metal;
-
+    const char* shaderBody = R"(
         struct v2f
         {
             float4 position [[position]];
@@ -153,18 +136,6 @@ void Renderer::buildShaders() {
             float3 position;
         };
 
-        struct InstanceData
-        {
-            float4x4 instanceTransform;
-            float4 instanceColor;
-        };
-
-        struct CameraData
-        {
-            float4x4 perspectiveTransform;
-            float4x4 worldTransform;
-        };
-
         v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
                                device const InstanceData* instanceData [[buffer(1)]],
                                device const CameraData& cameraData [[buffer(2)]],
@@ -186,33 +157,34 @@ void Renderer::buildShaders() {
         }
     )";
 
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
     NS::Error* error = nullptr;
-    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc, UTF8StringEncoding), nullptr, &error);
+    NS::UniquePtr<MTL::Library> library = NS::TransferPtr(_device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error));
     if(!library) {
         __builtin_printf("%s", error->localizedDescription()->utf8String());
         assert(false);
     }
 
-    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
-    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+    NS::UniquePtr<MTL::Function> vertexFn = NS::TransferPtr(library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding)));
+    NS::UniquePtr<MTL::Function> fragFn = NS::TransferPtr(library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) ));
 
-    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
-    desc->setVertexFunction(vertexFn);
-    desc->setFragmentFunction(fragFn);
+    NS::UniquePtr<MTL::RenderPipelineDescriptor> desc = NS::TransferPtr(MTL::RenderPipelineDescriptor::alloc()->init());
+    desc->setVertexFunction(vertexFn.get());
+    desc->setFragmentFunction(fragFn.get());
     desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatRGBA8Unorm_sRGB);
     desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
 
-    _PSO = _device->newRenderPipelineState(desc, &error);
+    _PSO = NS::TransferPtr(_device->newRenderPipelineState(desc.get(), &error));
     if(!_PSO) {
         __builtin_printf( "%s", error->localizedDescription()->utf8String() );
         assert( false );
     }
 
-    vertexFn->release();
-    fragFn->release();
-    desc->release();
-
-    _shaderLibrary = library;
+    _shaderLibrary = std::move(library);
 }
 
 void Renderer::buildBuffers() {
@@ -256,11 +228,8 @@ void Renderer::buildBuffers() {
     const size_t vertexDataSize = sizeof( verts );
     const size_t indexDataSize = sizeof( indices );
 
-    MTL::Buffer* pVertexBuffer = _device->newBuffer( vertexDataSize, MTL::ResourceStorageModeManaged );
-    MTL::Buffer* pIndexBuffer = _device->newBuffer( indexDataSize, MTL::ResourceStorageModeManaged );
-
-    _vertexDataBuffer = pVertexBuffer;
-    _indexBuffer = pIndexBuffer;
+    _vertexDataBuffer = NS::TransferPtr( _device->newBuffer( vertexDataSize, MTL::ResourceStorageModeManaged ) );
+    _indexBuffer = NS::TransferPtr( _device->newBuffer( indexDataSize, MTL::ResourceStorageModeManaged ) );
 
     memcpy( _vertexDataBuffer->contents(), verts, vertexDataSize );
     memcpy( _indexBuffer->contents(), indices, indexDataSize );
@@ -271,26 +240,24 @@ void Renderer::buildBuffers() {
     using NS::StringEncoding::UTF8StringEncoding;
     assert( _shaderLibrary );
 
-    const size_t instanceDataSize = kMaxFramesInFlight * kNumInstances * sizeof(InstanceData);
+    const size_t instanceDataSize = kMaxFramesInFlight * kNumInstances * sizeof(shader_types::InstanceData);
 
     for (size_t i = 0; i < kMaxFramesInFlight; ++i) {
-        _instanceDataBuffer[i] = _device->newBuffer(instanceDataSize, MTL::ResourceStorageModeManaged);
+        _instanceDataBuffer[i] = NS::TransferPtr(_device->newBuffer(instanceDataSize, MTL::ResourceStorageModeManaged));
     }
 
-    const size_t cameraDataSize = kMaxFramesInFlight * sizeof( CameraData );
+    const size_t cameraDataSize = kMaxFramesInFlight * sizeof( shader_types::CameraData );
     for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
     {
-        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeManaged );
+        _cameraDataBuffer[ i ] = NS::TransferPtr( _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeManaged ) );
     }
 }
 
 void Renderer::buildDepthStencilStates() {
-    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    NS::UniquePtr<MTL::DepthStencilDescriptor> pDsDesc = NS::TransferPtr(MTL::DepthStencilDescriptor::alloc()->init());
     pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
     pDsDesc->setDepthWriteEnabled( true );
 
-    _depthStencilState = _device->newDepthStencilState( pDsDesc );
-
-    pDsDesc->release();
+    _depthStencilState = NS::TransferPtr( _device->newDepthStencilState( pDsDesc.get() ) );
 }
 
@@ -19,34 +19,25 @@
 
 #include <simd/simd.h>
 
-struct InstanceData
-{
-    simd::float4x4 instanceTransform;
-    simd::float4 instanceColor;
-};
-
-struct CameraData
-{
-    simd::float4x4 perspectiveTransform;
-    simd::float4x4 worldTransform;
-};
+#include "shader_types.hpp"
 
 class Renderer {
 private:
-    MTL::Device* _device;
-    MTL::CommandQueue* _commandQueue;
-    MTL::RenderPipelineState* _PSO;
-    MTL::Library* _shaderLibrary;
+    // each owns one reference, released when the renderer goes
+    NS::UniquePtr<MTL::Device> _device;
+    NS::UniquePtr<MTL::CommandQueue> _commandQueue;
+    NS::UniquePtr<MTL::RenderPipelineState> _PSO;
+    NS::UniquePtr<MTL::Library> _shaderLibrary;
 
-    MTL::Buffer* _vertexDataBuffer;
-    MTL::Buffer* _instanceDataBuffer[3];
-    MTL::Buffer* _cameraDataBuffer[3];
-    MTL::Buffer* _indexBuffer;
+    NS::UniquePtr<MTL::Buffer> _vertexDataBuffer;
+    NS::UniquePtr<MTL::Buffer> _instanceDataBuffer[3];
+    NS::UniquePtr<MTL::Buffer> _cameraDataBuffer[3];
+    NS::UniquePtr<MTL::Buffer> _indexBuffer;
 
     float _angle;
     int _frame;
     dispatch_semaphore_t _semaphore;
-    MTL::DepthStencilState* _depthStencilState;
+    NS::UniquePtr<MTL::DepthStencilState> _depthStencilState;
 
 public:
     explicit Renderer(MTL::Device* device);
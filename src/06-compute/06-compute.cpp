@@ -17,6 +17,8 @@
 
 #include <cassert>
 #include <iostream>
+#include <string>
+#include <utility>
 
 #define NS_PRIVATE_IMPLEMENTATION
 #define MTL_PRIVATE_IMPLEMENTATION
@@ -28,6 +30,8 @@
 
 #include <simd/simd.h>
 
+#include "shader_types.hpp"
+
 static constexpr size_t kInstanceRows = 10;
 static constexpr size_t kInstanceColumns = 10;
 static constexpr size_t kInstanceDepth = 10;
@@ -66,17 +70,18 @@ class Renderer
         void draw( MTK::View* pView );
 
     private:
-        MTL::Device* _pDevice;
-        MTL::CommandQueue* _pCommandQueue;
-        MTL::Library* _pShaderLibrary;
-        MTL::RenderPipelineState* _pPSO;
-        MTL::ComputePipelineState* _pComputePSO;
-        MTL::DepthStencilState* _pDepthStencilState;
-        MTL::Texture* _pTexture;
-        MTL::Buffer* _pVertexDataBuffer;
-        MTL::Buffer* _pInstanceDataBuffer[kMaxFramesInFlight];
-        MTL::Buffer* _pCameraDataBuffer[kMaxFramesInFlight];
-        MTL::Buffer* _pIndexBuffer;
+        // owning handles, released in reverse order when the renderer goes away
+        NS::UniquePtr< MTL::Device > _pDevice;
+        NS::UniquePtr< MTL::CommandQueue > _pCommandQueue;
+        NS::UniquePtr< MTL::Library > _pShaderLibrary;
+        NS::UniquePtr< MTL::RenderPipelineState > _pPSO;
+        NS::UniquePtr< MTL::ComputePipelineState > _pComputePSO;
+        NS::UniquePtr< MTL::DepthStencilState > _pDepthStencilState;
+        NS::UniquePtr< MTL::Texture > _pTexture;
+        NS::UniquePtr< MTL::Buffer > _pVertexDataBuffer;
+        NS::UniquePtr< MTL::Buffer > _pInstanceDataBuffer[kMaxFramesInFlight];
+        NS::UniquePtr< MTL::Buffer > _pCameraDataBuffer[kMaxFramesInFlight];
+        NS::UniquePtr< MTL::Buffer > _pIndexBuffer;
         float _angle;
         int _frame;
         dispatch_semaphore_t _semaphore;
@@ -345,11 +350,11 @@ namespace math
 const int Renderer::kMaxFramesInFlight = 3;
 
 Renderer::Renderer( MTL::Device* pDevice )
-: _pDevice( pDevice->retain() )
+: _pDevice( NS::RetainPtr( pDevice ) )
 , _angle ( 0.f )
 , _frame( 0 )
 {
-    _pCommandQueue = _pDevice->newCommandQueue();
+    _pCommandQueue = NS::TransferPtr( _pDevice->newCommandQueue() );
     buildShaders();
     buildComputePipeline();
     buildDepthStencilStates();
@@ -362,57 +367,13 @@ Renderer::Renderer( MTL::Device* pDevice )
 
 Renderer::~Renderer()
 {
-    _pTexture->release();
-    _pShaderLibrary->release();
-    _pDepthStencilState->release();
-    _pVertexDataBuffer->release();
-    for ( int i = 0; i < kMaxFramesInFlight; ++i )
-    {
-        _pInstanceDataBuffer[i]->release();
-    }
-    for ( int i = 0; i < kMaxFramesInFlight; ++i )
-    {
-        _pCameraDataBuffer[i]->release();
-    }
-    _pIndexBuffer->release();
-    _pComputePSO->release();
-    _pPSO->release();
-    _pCommandQueue->release();
-    _pDevice->release();
-}
-
-namespace shader_types
-{
-    struct VertexData
-    {
-        simd::float3 position;
-        simd::float3 normal;
-        simd::float2 texcoord;
-    };
-
-    struct InstanceData
-    {
-        simd::float4x4 instanceTransform;
-        simd::float3x3 instanceNormalTransform;
-        simd::float4 instanceColor;
-    };
-
-    struct CameraData
-    {
-        simd::float4x4 perspectiveTransform;
-        simd::float4x4 worldTransform;
-        simd::float3x3 worldNormalTransform;
-    };
 }
 
 void Renderer::buildShaders()
 {
     using NS::StringEncoding::UTF8StringEncoding;
 
-    const char* shaderSrc = R"(
-        #include <metal_stdlib>
-        using namespace metal;
-
+    const char* shaderBody = R"(
         struct v2f
         {
             float4 position [[position]];
@@ -421,27 +382,6 @@ void Renderer::buildShaders()
             float2 texcoord;
         };
 
-        struct VertexData
-        {
-            float3 position;
-            float3 normal;
-            float2 texcoord;
-        };
-
-        struct InstanceData
-        {
-            float4x4 instanceTransform;
-            float3x3 instanceNormalTransform;
-            float4 instanceColor;
-        };
-
-        struct CameraData
-        {
-            float4x4 perspectiveTransform;
-            float4x4 worldTransform;
-            float3x3 worldNormalTransform;
-        };
-
         v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
                                device const InstanceData* instanceData [[buffer(1)]],
                                device const CameraData& cameraData [[buffer(2)]],
@@ -482,34 +422,37 @@ void Renderer::buildShaders()
         }
     )";
 
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
     NS::Error* pError = nullptr;
-    MTL::Library* pLibrary = _pDevice->newLibrary( NS::String::string(shaderSrc, UTF8StringEncoding), nullptr, &pError );
+    NS::UniquePtr< MTL::Library > pLibrary = NS::TransferPtr( _pDevice->newLibrary( NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &pError ) );
     if ( !pLibrary )
     {
         __builtin_printf( "%s", pError->localizedDescription()->utf8String() );
         assert( false );
     }
 
-    MTL::Function* pVertexFn = pLibrary->newFunction( NS::String::string("vertexMain", UTF8StringEncoding) );
-    MTL::Function* pFragFn = pLibrary->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+    NS::UniquePtr< MTL::Function > pVertexFn = NS::TransferPtr( pLibrary->newFunction( NS::String::string("vertexMain", UTF8StringEncoding) ) );
+    NS::UniquePtr< MTL::Function > pFragFn = NS::TransferPtr( pLibrary->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) ) );
 
-    MTL::RenderPipelineDescriptor* pDesc = MTL::RenderPipelineDescriptor::alloc()->init();
-    pDesc->setVertexFunction( pVertexFn );
-    pDesc->setFragmentFunction( pFragFn );
+    NS::UniquePtr< MTL::RenderPipelineDescriptor > pDesc = NS::TransferPtr( MTL::RenderPipelineDescriptor::alloc()->init() );
+    pDesc->setVertexFunction( pVertexFn.get() );
+    pDesc->setFragmentFunction( pFragFn.get() );
     pDesc->colorAttachments()->object(0)->setPixelFormat( MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB );
     pDesc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
 
-    _pPSO = _pDevice->newRenderPipelineState( pDesc, &pError );
+    _pPSO = NS::TransferPtr( _pDevice->newRenderPipelineState( pDesc.get(), &pError ) );
     if ( !_pPSO )
     {
         __builtin_printf( "%s", pError->localizedDescription()->utf8String() );
         assert( false );
     }
 
-    pVertexFn->release();
-    pFragFn->release();
-    pDesc->release();
-    _pShaderLibrary = pLibrary;
+    _pShaderLibrary = std::move( pLibrary );
 }
 
 void Renderer::buildComputePipeline()
@@ -546,39 +489,34 @@ void Renderer::buildComputePipeline()
         })";
     NS::Error* pError = nullptr;
 
-    MTL::Library* pComputeLibrary = _pDevice->newLibrary( NS::String::string(kernelSrc, NS::UTF8StringEncoding), nullptr, &pError );
+    NS::UniquePtr< MTL::Library > pComputeLibrary = NS::TransferPtr( _pDevice->newLibrary( NS::String::string(kernelSrc, NS::UTF8StringEncoding), nullptr, &pError ) );
     if ( !pComputeLibrary )
     {
         __builtin_printf( "%s", pError->localizedDescription()->utf8String() );
         assert(false);
     }
 
-    MTL::Function* pMandelbrotFn = pComputeLibrary->newFunction( NS::String::string("mandelbrot_set", NS::UTF8StringEncoding) );
-    _pComputePSO = _pDevice->newComputePipelineState( pMandelbrotFn, &pError );
+    NS::UniquePtr< MTL::Function > pMandelbrotFn = NS::TransferPtr( pComputeLibrary->newFunction( NS::String::string("mandelbrot_set", NS::UTF8StringEncoding) ) );
+    _pComputePSO = NS::TransferPtr( _pDevice->newComputePipelineState( pMandelbrotFn.get(), &pError ) );
     if ( !_pComputePSO )
     {
         __builtin_printf( "%s", pError->localizedDescription()->utf8String() );
         assert(false);
     }
-
-    pMandelbrotFn->release();
-    pComputeLibrary->release();
 }
 
 void Renderer::buildDepthStencilStates()
 {
-    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    NS::UniquePtr< MTL::DepthStencilDescriptor > pDsDesc = NS::TransferPtr( MTL::DepthStencilDescriptor::alloc()->init() );
     pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
     pDsDesc->setDepthWriteEnabled( true );
 
-    _pDepthStencilState = _pDevice->newDepthStencilState( pDsDesc );
-
-    pDsDesc->release();
+    _pDepthStencilState = NS::TransferPtr( _pDevice->newDepthStencilState( pDsDesc.get() ) );
 }
 
 void Renderer::buildTextures()
 {
-    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    NS::UniquePtr< MTL::TextureDescriptor > pTextureDesc = NS::TransferPtr( MTL::TextureDescriptor::alloc()->init() );
     pTextureDesc->setWidth( kTextureWidth );
     pTextureDesc->setHeight( kTextureHeight );
     pTextureDesc->setPixelFormat( MTL::PixelFormatRGBA8Unorm );
@@ -586,10 +524,7 @@ void Renderer::buildTextures()
     pTextureDesc->setStorageMode( MTL::StorageModeManaged );
     pTextureDesc->setUsage( MTL::ResourceUsageSample | MTL::ResourceUsageRead | MTL::ResourceUsageWrite);
 
-    MTL::Texture *pTexture = _pDevice->newTexture( pTextureDesc );
-    _pTexture = pTexture;
-
-    pTextureDesc->release();
+    _pTexture = NS::TransferPtr( _pDevice->newTexture( pTextureDesc.get() ) );
 }
 
 void Renderer::buildBuffers()
@@ -645,11 +580,8 @@ void Renderer::buildBuffers()
     const size_t vertexDataSize = sizeof( verts );
     const size_t indexDataSize = sizeof( indices );
 
-    MTL::Buffer* pVertexBuffer = _pDevice->newBuffer( vertexDataSize, MTL::ResourceStorageModeManaged );
-    MTL::Buffer* pIndexBuffer = _pDevice->newBuffer( indexDataSize, MTL::ResourceStorageModeManaged );
-
-    _pVertexDataBuffer = pVertexBuffer;
-    _pIndexBuffer = pIndexBuffer;
+    _pVertexDataBuffer = NS::TransferPtr( _pDevice->newBuffer( vertexDataSize, MTL::ResourceStorageModeManaged ) );
+    _pIndexBuffer = NS::TransferPtr( _pDevice->newBuffer( indexDataSize, MTL::ResourceStorageModeManaged ) );
 
     memcpy( _pVertexDataBuffer->contents(), verts, vertexDataSize );
     memcpy( _pIndexBuffer->contents(), indices, indexDataSize );
@@ -660,13 +592,13 @@ void Renderer::buildBuffers()
     const size_t instanceDataSize = kMaxFramesInFlight * kNumInstances * sizeof( shader_types::InstanceData );
     for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
     {
-        _pInstanceDataBuffer[ i ] = _pDevice->newBuffer( instanceDataSize, MTL::ResourceStorageModeManaged );
+        _pInstanceDataBuffer[ i ] = NS::TransferPtr( _pDevice->newBuffer( instanceDataSize, MTL::ResourceStorageModeManaged ) );
     }
 
     const size_t cameraDataSize = kMaxFramesInFlight * sizeof( shader_types::CameraData );
     for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
     {
-        _pCameraDataBuffer[ i ] = _pDevice->newBuffer( cameraDataSize, MTL::ResourceStorageModeManaged );
+        _pCameraDataBuffer[ i ] = NS::TransferPtr( _pDevice->newBuffer( cameraDataSize, MTL::ResourceStorageModeManaged ) );
     }
 }
 
@@ -681,8 +613,8 @@ void Renderer::generateMandelbrotTexture()
 
     MTL::ComputeCommandEncoder* pComputeEncoder = pCommandBuffer->computeCommandEncoder();
 
-    pComputeEncoder->setComputePipelineState( _pComputePSO );
-    pComputeEncoder->setTexture( _pTexture, 0 );
+    pComputeEncoder->setComputePipelineState( _pComputePSO.get() );
+    pComputeEncoder->setTexture( _pTexture.get(), 0 );
 
     MTL::Size gridSize = MTL::Size( kTextureWidth, kTextureHeight, 1 );
 
@@ -705,7 +637,7 @@ void Renderer::draw( MTK::View* pView )
     NS::AutoreleasePool* pPool = NS::AutoreleasePool::alloc()->init();
 
     _frame = (_frame + 1) % Renderer::kMaxFramesInFlight;
-    MTL::Buffer* pInstanceDataBuffer = _pInstanceDataBuffer[ _frame ];
+    MTL::Buffer* pInstanceDataBuffer = _pInstanceDataBuffer[ _frame ].get();
 
     MTL::CommandBuffer* pCmd = _pCommandQueue->commandBuffer();
     dispatch_semaphore_wait( _semaphore, DISPATCH_TIME_FOREVER );
@@ -767,7 +699,7 @@ void Renderer::draw( MTK::View* pView )
 
     // Update camera state:
 
-    MTL::Buffer* pCameraDataBuffer = _pCameraDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _pCameraDataBuffer[ _frame ].get();
     shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( pCameraDataBuffer->contents() );
     pCameraData->perspectiveTransform = math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
     pCameraData->worldTransform = math::makeIdentity();
@@ -779,21 +711,21 @@ void Renderer::draw( MTK::View* pView )
     MTL::RenderPassDescriptor* pRpd = pView->currentRenderPassDescriptor();
     MTL::RenderCommandEncoder* pEnc = pCmd->renderCommandEncoder( pRpd );
 
-    pEnc->setRenderPipelineState( _pPSO );
-    pEnc->setDepthStencilState( _pDepthStencilState );
+    pEnc->setRenderPipelineState( _pPSO.get() );
+    pEnc->setDepthStencilState( _pDepthStencilState.get() );
 
-    pEnc->setVertexBuffer( _pVertexDataBuffer, /* offset */ 0, /* index */ 0 );
+    pEnc->setVertexBuffer( _pVertexDataBuffer.get(), /* offset */ 0, /* index */ 0 );
     pEnc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
     pEnc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
 
-    pEnc->setFragmentTexture( _pTexture, /* index */ 0 );
+    pEnc->setFragmentTexture( _pTexture.get(), /* index */ 0 );
 
     pEnc->setCullMode( MTL::CullModeBack );
     pEnc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
 
     pEnc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
                                 6 * 6, MTL::IndexType::IndexTypeUInt16,
-                                _pIndexBuffer,
+                                _pIndexBuffer.get(),
                                 0,
                                 kNumInstances );
 
@@ -0,0 +1,364 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+
+static constexpr size_t kClipFrames = 61;
+static constexpr float kClipSampleRate = 30.f;
+static constexpr float kClipSwitchSeconds = 4.f;
+static constexpr float kCrossFadeSeconds = 1.f;
+static constexpr float kFrameSeconds = 1.f / 60.f;
+static constexpr uint64_t kStatsInterval = 300;
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _uploader(device)
+, _player(kNumInstances)
+, _clipTime(0.f)
+, _waveActive(true)
+, _sampleSeconds(0.0)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+    buildClips();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    _commandQueue->release();
+    _device->release();
+    _PSO->release();
+
+    _shaderLibrary->release();
+    _vertexDataBuffer->release();
+    _indexBuffer->release();
+    _depthStencilState->release();
+
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[i]->release();
+    }
+}
+
+void Renderer::draw(MTK::View *view) {
+
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    _angle += 0.002f;
+
+    // Advance the animation, cross fading between the two clips:
+
+    _clipTime += kFrameSeconds;
+    if ( _clipTime >= kClipSwitchSeconds )
+    {
+        _clipTime = 0.f;
+        _waveActive = !_waveActive;
+        _player.crossFade( _waveActive ? &_waveClip : &_spinClip, kCrossFadeSeconds );
+    }
+
+    auto sampleBegin = std::chrono::steady_clock::now();
+
+    _player.update( kFrameSeconds );
+
+    shader_types::InstanceData* pInstanceData = reinterpret_cast<shader_types::InstanceData *>(pInstanceDataBuffer->contents());
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    // clip translations are relative to the object center
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5f );
+    float4x4 objectTransform = rt * rr1 * rr0;
+
+    const Transform* pose = _player.pose();
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        pInstanceData[ i ].instanceTransform = objectTransform * AnimationSampler::toMatrix( pose[ i ] );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+    }
+
+    _sampleSeconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - sampleBegin ).count();
+    if ( ++_frameCount % kStatsInterval == 0 )
+    {
+        __builtin_printf( "animation: %zu tracks, %.2f us/frame, %zu bytes compressed per clip\n",
+                          kNumInstances,
+                          _sampleSeconds * 1e6 / kStatsInterval,
+                          _waveClip.sizeInBytes() );
+        _sampleSeconds = 0.0;
+    }
+
+    // Update camera state:
+
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( pCameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+
+    // begin render pass
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+    // add draw calls here
+    enc->setRenderPipelineState(_PSO);
+    enc->setDepthStencilState( _depthStencilState );
+
+    enc->setVertexBuffer(_vertexDataBuffer, 0, 0);
+    enc->setVertexBuffer(pInstanceDataBuffer, 0, 1);
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                 6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                 _indexBuffer,
+                                 0,
+                                 kNumInstances );
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            half3 color;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+            float4 pos = float4( vertexData[ vertexId ].position, 1.0 );
+            pos = instanceData[ instanceId ].instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]] )
+        {
+            return half4( in.color, 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+
+    _shaderLibrary = library;
+}
+
+void Renderer::buildBuffers() {
+
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+            { { -s, -s, +s } },
+            { { +s, -s, +s } },
+            { { +s, +s, +s } },
+            { { -s, +s, +s } },
+
+            { { -s, -s, -s } },
+            { { -s, +s, -s } },
+            { { +s, +s, -s } },
+            { { +s, -s, -s } }
+    };
+
+    uint16_t indices[] = {
+            0, 1, 2, /* front */
+            2, 3, 0,
+
+            1, 7, 6, /* right */
+            6, 2, 1,
+
+            7, 4, 5, /* back */
+            5, 6, 7,
+
+            4, 0, 3, /* left */
+            3, 5, 4,
+
+            3, 2, 6, /* top */
+            6, 5, 3,
+
+            4, 7, 1, /* bottom */
+            1, 0, 4
+    };
+
+    const size_t vertexDataSize = sizeof( verts );
+    const size_t indexDataSize = sizeof( indices );
+
+    // static geometry lives in private memory, per frame data is streamed through shared buffers
+    _vertexDataBuffer = _uploader.newBuffer( vertexDataSize, ResourceUsage::Static, verts );
+    _indexBuffer = _uploader.newBuffer( indexDataSize, ResourceUsage::Static, indices );
+
+    using NS::StringEncoding::UTF8StringEncoding;
+    assert( _shaderLibrary );
+
+    const size_t instanceDataSize = kNumInstances * sizeof(shader_types::InstanceData);
+
+    for (size_t i = 0; i < kMaxFramesInFlight; ++i) {
+        _instanceDataBuffer[i] = _uploader.newBuffer( instanceDataSize, ResourceUsage::Streaming, nullptr );
+    }
+
+    const size_t cameraDataSize = kMaxFramesInFlight * sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _uploader.newBuffer( cameraDataSize, ResourceUsage::Streaming, nullptr );
+    }
+
+    // one blit for all the static data, ahead of the first frame on the same queue
+    MTL::CommandBuffer* uploadCmd = _commandQueue->commandBuffer();
+    _uploader.flush( uploadCmd );
+    uploadCmd->commit();
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
+
+void Renderer::buildClips() {
+    using simd::float3;
+
+    const float scl = 0.2f;
+    std::vector<Transform> keys( kNumInstances * kClipFrames );
+
+    // grid position of every instance, relative to the object center
+    std::vector<float3> home( kNumInstances );
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+        home[ i ] = (float3){ ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl,
+                              ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl,
+                              ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl) };
+    }
+
+    // wave: every cube bobs up and down, phase shifted along x and z
+    for ( size_t f = 0; f < kClipFrames; ++f )
+    {
+        float phase = 2.f * M_PI * (float)f / (float)( kClipFrames - 1 );
+        for ( size_t i = 0; i < kNumInstances; ++i )
+        {
+            float offset = home[ i ].x + home[ i ].z;
+            Transform& key = keys[ f * kNumInstances + i ];
+            key.rotation = simd_quaternion( phase + offset, (float3){ 0.f, 1.f, 0.f } ).vector;
+            key.translation = home[ i ] + (float3){ 0.f, 0.3f * sinf( phase + offset * 2.f ), 0.f };
+            key.scale = (float3){ scl, scl, scl };
+        }
+    }
+    _waveClip = AnimationClip::compress( keys.data(), kNumInstances, kClipFrames, kClipSampleRate );
+
+    // spin: the grid breathes outwards while every cube tumbles around its own diagonal
+    for ( size_t f = 0; f < kClipFrames; ++f )
+    {
+        float phase = 2.f * M_PI * (float)f / (float)( kClipFrames - 1 );
+        float spread = 1.f + 0.25f * ( 1.f - cosf( phase ) );
+        for ( size_t i = 0; i < kNumInstances; ++i )
+        {
+            Transform& key = keys[ f * kNumInstances + i ];
+            key.rotation = simd_quaternion( phase, simd_normalize( (float3){ 1.f, 1.f, 1.f } ) ).vector;
+            key.translation = home[ i ] * spread;
+            key.scale = (float3){ scl, scl, scl } * ( 0.75f + 0.25f * cosf( phase ) );
+        }
+    }
+    _spinClip = AnimationClip::compress( keys.data(), kNumInstances, kClipFrames, kClipSampleRate );
+
+    _player.play( &_waveClip );
+}
@@ -0,0 +1,448 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 6;
+static constexpr size_t kInstanceColumns = 6;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns);
+
+static constexpr size_t kJointCount = 8;
+static constexpr size_t kRingCount = 33;
+static constexpr float kSegmentLength = 0.25f;
+static constexpr float kRadius = 0.08f;
+
+static constexpr size_t kClipFrames = 61;
+static constexpr float kClipSampleRate = 30.f;
+static constexpr float kFrameSeconds = 1.f / 60.f;
+static constexpr uint64_t kStatsInterval = 600;
+static constexpr int kBenchRepeats = 16;
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _indexCount(0)
+, _localPose(kJointCount)
+, _clipTime(0.f)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildSkeleton();
+    buildBuffers();
+
+    const size_t hardwareThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    for ( size_t threads = 1; threads < hardwareThreads; threads *= 2 )
+    {
+        _jobSystems.emplace_back( new JobSystem( threads ) );
+    }
+    _jobSystems.emplace_back( new JobSystem( hardwareThreads ) );
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    _commandQueue->release();
+    _device->release();
+    _PSO->release();
+
+    _shaderLibrary->release();
+    _vertexDataBuffer->release();
+    _indexBuffer->release();
+    _depthStencilState->release();
+
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _paletteBuffer[i]->release();
+    }
+}
+
+void Renderer::draw(MTK::View *view) {
+
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pPaletteBuffer = _paletteBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    _angle += 0.002f;
+    _clipTime += kFrameSeconds;
+
+    // Update palettes, every instance plays the clip with its own phase:
+
+    float4x4* pPalettes = reinterpret_cast<float4x4 *>(pPaletteBuffer->contents());
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        AnimationSampler::sample( _clip, _clipTime + 0.37f * (float)i, _localPose.data() );
+        _skeleton->computePalette( _localPose.data(), pPalettes + i * kJointCount );
+    }
+    pPaletteBuffer->didModifyRange( NS::Range::Make( 0, pPaletteBuffer->length() ) );
+
+    if ( ++_frameCount % kStatsInterval == 0 )
+    {
+        benchmarkCpuSkinning( pPalettes );
+    }
+
+    // Update instance state:
+
+    shader_types::InstanceData* pInstanceData = reinterpret_cast<shader_types::InstanceData *>(pInstanceDataBuffer->contents());
+
+    float3 objectPosition = { 0.f, -1.f, -6.f };
+    float4x4 objectTransform = Math::makeTranslate( objectPosition ) * Math::makeYRotate( -_angle );
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iz = i / kInstanceRows;
+        float x = ((float)ix - (float)kInstanceRows/2.f) * 0.6f + 0.3f;
+        float z = ((float)iz - (float)kInstanceColumns/2.f) * 0.6f + 0.3f;
+
+        pInstanceData[ i ].instanceTransform = objectTransform * Math::makeTranslate( { x, 0.f, z } ) * Math::makeYRotate( (float)i );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+    }
+    pInstanceDataBuffer->didModifyRange( NS::Range::Make( 0, pInstanceDataBuffer->length() ) );
+
+    // Update camera state:
+
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( pCameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+    pCameraDataBuffer->didModifyRange( NS::Range::Make( 0, sizeof( shader_types::CameraData ) ) );
+
+    // begin render pass
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+
+    enc->setRenderPipelineState(_PSO);
+    enc->setDepthStencilState( _depthStencilState );
+
+    const uint32_t jointCount = kJointCount;
+    enc->setVertexBuffer(_vertexDataBuffer, 0, 0);
+    enc->setVertexBuffer(pInstanceDataBuffer, 0, 1);
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+    enc->setVertexBuffer( pPaletteBuffer, /* offset */ 0, /* index */ 3 );
+    enc->setVertexBytes( &jointCount, sizeof( jointCount ), /* index */ 4 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                 _indexCount, MTL::IndexType::IndexTypeUInt16,
+                                 _indexBuffer,
+                                 0,
+                                 kNumInstances );
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+}
+
+void Renderer::benchmarkCpuSkinning(const simd::float4x4* palettes) {
+    const size_t vertexCount = _cpuVertices.size();
+
+    for ( const std::unique_ptr<JobSystem>& jobs : _jobSystems )
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for ( int i = 0; i < kBenchRepeats; ++i )
+        {
+            CpuSkinning::skinParallel( *jobs, _cpuVertices.data(), vertexCount, palettes, _cpuOutput.data() );
+        }
+        double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+
+        __builtin_printf( "cpu skinning: %zu threads, %.1f Mverts/s\n",
+                          jobs->threadCount(),
+                          (double)( vertexCount * kBenchRepeats ) / seconds * 1e-6 );
+    }
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               device const float4x4* palettes [[buffer(3)]],
+                               constant uint& jointCount [[buffer(4)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            device const float4x4* palette = palettes + instanceId * jointCount;
+
+            float4x4 skin = palette[ vd.joints.x ] * vd.weights.x
+                          + palette[ vd.joints.y ] * vd.weights.y
+                          + palette[ vd.joints.z ] * vd.weights.z
+                          + palette[ vd.joints.w ] * vd.weights.w;
+
+            float4 pos = skin * float4( vd.position, 1.0 );
+            pos = instanceData[ instanceId ].instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+
+            // the inverse transpose of the skin matrix up to scale, as CpuSkinning does
+            float3 normal = cross( skin[1].xyz, skin[2].xyz ) * vd.normal.x
+                          + cross( skin[2].xyz, skin[0].xyz ) * vd.normal.y
+                          + cross( skin[0].xyz, skin[1].xyz ) * vd.normal.z;
+            o.normal = ( instanceData[ instanceId ].instanceTransform * float4( normal, 0.0 ) ).xyz;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]] )
+        {
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            half3 illum = (in.color * 0.1) + (in.color * ndotl);
+            return half4( illum, 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+
+    _shaderLibrary = library;
+}
+
+void Renderer::buildSkeleton() {
+    using simd::float3;
+
+    // a chain of joints straight up the y axis, bind pose is the identity rotation
+    int parents[ kJointCount ];
+    simd::float4x4 inverseBind[ kJointCount ];
+    for ( size_t j = 0; j < kJointCount; ++j )
+    {
+        parents[ j ] = (int)j - 1;
+        inverseBind[ j ] = Math::makeTranslate( { 0.f, -kSegmentLength * (float)j, 0.f } );
+    }
+    _skeleton.reset( new Skeleton( parents, inverseBind, kJointCount ) );
+
+    std::vector<Transform> keys( kJointCount * kClipFrames );
+    for ( size_t f = 0; f < kClipFrames; ++f )
+    {
+        float phase = 2.f * M_PI * (float)f / (float)( kClipFrames - 1 );
+        for ( size_t j = 0; j < kJointCount; ++j )
+        {
+            simd_quatf swing = simd_quaternion( 0.4f * sinf( phase + 0.7f * (float)j ), (float3){ 0.f, 0.f, 1.f } );
+            simd_quatf twist = simd_quaternion( 0.25f * cosf( phase + 0.5f * (float)j ), (float3){ 1.f, 0.f, 0.f } );
+
+            Transform& key = keys[ f * kJointCount + j ];
+            key.rotation = simd_mul( swing, twist ).vector;
+            key.translation = (float3){ 0.f, j == 0 ? 0.f : kSegmentLength, 0.f };
+            key.scale = (float3){ 1.f, 1.f, 1.f };
+        }
+    }
+    _clip = AnimationClip::compress( keys.data(), kJointCount, kClipFrames, kClipSampleRate );
+}
+
+void Renderer::buildBuffers() {
+
+    using simd::float3;
+    using simd::float4;
+
+    const float height = kSegmentLength * (float)( kJointCount - 1 );
+
+    std::vector<SkinnedVertex> verts;
+    std::vector<uint16_t> indices;
+
+    // each ring blends between the two joints it sits between
+    auto influence = [&]( float y, SkinnedVertex& v ) {
+        float jf = y / kSegmentLength;
+        size_t j0 = std::min( (size_t)jf, kJointCount - 1 );
+        size_t j1 = std::min( j0 + 1, kJointCount - 1 );
+        float t = std::min( jf - (float)j0, 1.f );
+        v.joints = (simd::ushort4){ (uint16_t)j0, (uint16_t)j1, 0, 0 };
+        v.weights = (float4){ 1.f - t, t, 0.f, 0.f };
+    };
+
+    // quads keep their own vertices so every face gets a flat normal
+    auto addQuad = [&]( float3 p0, float3 p1, float3 p2, float3 p3, float3 n ) {
+        if ( simd_dot( simd_cross( p1 - p0, p2 - p0 ), n ) < 0.f )
+        {
+            std::swap( p1, p3 );
+        }
+        const uint16_t base = (uint16_t)verts.size();
+        for ( float3 p : { p0, p1, p2, p3 } )
+        {
+            SkinnedVertex v;
+            v.position = p;
+            v.normal = n;
+            influence( p.y, v );
+            verts.push_back( v );
+        }
+        for ( uint16_t i : { 0, 1, 2, 2, 3, 0 } )
+        {
+            indices.push_back( base + i );
+        }
+    };
+
+    const float3 up = { 0.f, 1.f, 0.f };
+    const float3 sides[] = { { 0.f, 0.f, 1.f }, { 1.f, 0.f, 0.f }, { 0.f, 0.f, -1.f }, { -1.f, 0.f, 0.f } };
+
+    for ( const float3& n : sides )
+    {
+        const float3 tangent = simd_cross( up, n );
+        for ( size_t r = 0; r + 1 < kRingCount; ++r )
+        {
+            float y0 = height * (float)r / (float)( kRingCount - 1 );
+            float y1 = height * (float)( r + 1 ) / (float)( kRingCount - 1 );
+            float w0 = kRadius * ( 1.f - 0.6f * y0 / height );
+            float w1 = kRadius * ( 1.f - 0.6f * y1 / height );
+
+            addQuad( n * w0 - tangent * w0 + up * y0,
+                     n * w0 + tangent * w0 + up * y0,
+                     n * w1 + tangent * w1 + up * y1,
+                     n * w1 - tangent * w1 + up * y1,
+                     n );
+        }
+    }
+
+    const float wTop = kRadius * 0.4f;
+    addQuad( { -wTop, height, -wTop }, { wTop, height, -wTop }, { wTop, height, wTop }, { -wTop, height, wTop }, up );
+    addQuad( { -kRadius, 0.f, -kRadius }, { -kRadius, 0.f, kRadius }, { kRadius, 0.f, kRadius }, { kRadius, 0.f, -kRadius }, -up );
+
+    _indexCount = indices.size();
+
+    const size_t vertexDataSize = verts.size() * sizeof( SkinnedVertex );
+    const size_t indexDataSize = indices.size() * sizeof( uint16_t );
+
+    MTL::Buffer* pVertexBuffer = _device->newBuffer( vertexDataSize, MTL::ResourceStorageModeManaged );
+    MTL::Buffer* pIndexBuffer = _device->newBuffer( indexDataSize, MTL::ResourceStorageModeManaged );
+
+    _vertexDataBuffer = pVertexBuffer;
+    _indexBuffer = pIndexBuffer;
+
+    memcpy( _vertexDataBuffer->contents(), verts.data(), vertexDataSize );
+    memcpy( _indexBuffer->contents(), indices.data(), indexDataSize );
+
+    _vertexDataBuffer->didModifyRange( NS::Range::Make( 0, _vertexDataBuffer->length() ) );
+    _indexBuffer->didModifyRange( NS::Range::Make( 0, _indexBuffer->length() ) );
+
+    // cpu copy of the mesh for every instance, indexing straight into the shared palette array
+    _cpuVertices.reserve( verts.size() * kNumInstances );
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        const uint16_t jointOffset = (uint16_t)( i * kJointCount );
+        for ( SkinnedVertex v : verts )
+        {
+            v.joints += jointOffset;
+            _cpuVertices.push_back( v );
+        }
+    }
+    _cpuOutput.resize( _cpuVertices.size() );
+
+    const size_t instanceDataSize = kNumInstances * sizeof(shader_types::InstanceData);
+    for (size_t i = 0; i < kMaxFramesInFlight; ++i) {
+        _instanceDataBuffer[i] = _device->newBuffer(instanceDataSize, MTL::ResourceStorageModeManaged);
+    }
+
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeManaged );
+    }
+
+    const size_t paletteDataSize = kNumInstances * kJointCount * sizeof( simd::float4x4 );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _paletteBuffer[ i ] = _device->newBuffer( paletteDataSize, MTL::ResourceStorageModeManaged );
+    }
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
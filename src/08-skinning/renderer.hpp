@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include <memory>
+#include <vector>
+
+#include "animation.hpp"
+#include "job_system.hpp"
+#include "shader_types.hpp"
+#include "skinning.hpp"
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::RenderPipelineState* _PSO;
+    MTL::Library* _shaderLibrary;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _paletteBuffer[3];
+    MTL::Buffer* _indexBuffer;
+    size_t _indexCount;
+
+    std::unique_ptr<Skeleton> _skeleton;
+    AnimationClip _clip;
+    std::vector<Transform> _localPose;
+    float _clipTime;
+
+    // cpu reference: every instance's copy of the mesh, joints pre-offset into one palette array
+    std::vector<SkinnedVertex> _cpuVertices;
+    std::vector<SkinnedOutput> _cpuOutput;
+    std::vector<std::unique_ptr<JobSystem>> _jobSystems;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+    MTL::DepthStencilState* _depthStencilState;
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildDepthStencilStates();
+    void buildSkeleton();
+    void benchmarkCpuSkinning(const simd::float4x4* palettes);
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,59 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include "job_system.hpp"
+#include "shader_types.hpp"
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::RenderPipelineState* _PSO;
+    MTL::Library* _shaderLibrary;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+
+    JobSystem _jobs;
+    double _encodeSeconds;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+    MTL::DepthStencilState* _depthStencilState;
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildDepthStencilStates();
+    void encodeDraws(MTL::RenderCommandEncoder* enc, size_t begin, size_t end,
+                     MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file           : shader_types.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SHADER_TYPES_HPP
+#define METAL_PLAYGROUND_SHADER_TYPES_HPP
+
+#include "shader_struct.hpp"
+
+namespace shader_types
+{
+#define VERTEX_DATA_FIELDS( F )                 \
+    F( float3, position )
+
+#define INSTANCE_DATA_FIELDS( F )               \
+    F( float4x4, instanceTransform )            \
+    F( float4, instanceColor )
+
+#define CAMERA_DATA_FIELDS( F )                 \
+    F( float4x4, perspectiveTransform )         \
+    F( float4x4, worldTransform )
+
+    SHADER_STRUCT( VertexData, VERTEX_DATA_FIELDS );
+    SHADER_STRUCT( InstanceData, INSTANCE_DATA_FIELDS );
+    SHADER_STRUCT( CameraData, CAMERA_DATA_FIELDS );
+}
+
+#endif //METAL_PLAYGROUND_SHADER_TYPES_HPP
@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include "draw_queue.hpp"
+#include "job_system.hpp"
+#include "shader_types.hpp"
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::RenderPipelineState* _PSO[2];
+    MTL::Library* _shaderLibrary;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+    MTL::Buffer* _materialBuffer;
+
+    JobSystem _jobs;
+    DrawQueue _drawQueue;
+    double _sortSeconds;
+    double _encodeSeconds;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+    MTL::DepthStencilState* _depthStencilState;
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildDepthStencilStates();
+    ReplayStats encodeDraws(MTL::RenderCommandEncoder* enc, size_t begin, size_t end,
+                            MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
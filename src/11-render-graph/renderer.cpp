@@ -0,0 +1,614 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <chrono>
+#include <string>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr uint32_t kTextureWidth = 2048;
+static constexpr uint32_t kTextureHeight = 2048;
+static constexpr uint32_t kHistogramBins = 256;
+static constexpr uint64_t kStatsInterval = 300;
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _graph(kMaxFramesInFlight)
+, _compileSeconds(0.0)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[i]->release();
+    }
+    _indexBuffer->release();
+    _histogramPSO->release();
+    _blurVPSO->release();
+    _blurHPSO->release();
+    _brightPSO->release();
+    _mandelbrotPSO->release();
+    _compositePSO->release();
+    _scenePSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    // Declare, compile and run this frame's graph:
+
+    auto compileBegin = std::chrono::steady_clock::now();
+    buildFrameGraph( view, pInstanceDataBuffer, pCameraDataBuffer );
+    _graph.compile( _device );
+    _compileSeconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - compileBegin ).count();
+
+    _graph.execute( _device, cmd, _frame );
+
+    if ( ++_frameCount % kStatsInterval == 0 )
+    {
+        __builtin_printf( "render graph: %zu passes (%zu culled), compile %.1f us, transient memory %.1f MB (%.1f MB without aliasing)\n",
+                          _graph.passCount(), _graph.culledPassCount(),
+                          _compileSeconds * 1e6 / kStatsInterval,
+                          _graph.peakBytes() / ( 1024.0 * 1024.0 ),
+                          _graph.unaliasedBytes() / ( 1024.0 * 1024.0 ) );
+        _compileSeconds = 0.0;
+    }
+
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+}
+
+void Renderer::buildFrameGraph(MTK::View *view, MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using Handle = RenderGraph::Handle;
+
+    const CGSize drawableSize = view->drawableSize();
+    const uint32_t width = (uint32_t)drawableSize.width;
+    const uint32_t height = (uint32_t)drawableSize.height;
+
+    const MTL::TextureUsage readWrite = MTL::TextureUsageShaderRead | MTL::TextureUsageShaderWrite;
+    const MTL::TextureUsage renderTarget = MTL::TextureUsageRenderTarget | MTL::TextureUsageShaderRead;
+
+    _graph.reset();
+
+    Handle mandelbrot = _graph.createTexture( "mandelbrot", { kTextureWidth, kTextureHeight, MTL::PixelFormatRGBA8Unorm, readWrite } );
+    Handle sceneColor = _graph.createTexture( "sceneColor", { width, height, MTL::PixelFormatRGBA16Float, renderTarget } );
+    Handle sceneDepth = _graph.createTexture( "sceneDepth", { width, height, MTL::PixelFormatDepth16Unorm, MTL::TextureUsageRenderTarget } );
+    Handle bright = _graph.createTexture( "bright", { width / 2, height / 2, MTL::PixelFormatRGBA16Float, readWrite } );
+    Handle blurA = _graph.createTexture( "blurA", { width / 2, height / 2, MTL::PixelFormatRGBA16Float, readWrite } );
+    Handle blurB = _graph.createTexture( "blurB", { width / 2, height / 2, MTL::PixelFormatRGBA16Float, readWrite } );
+    Handle histogram = _graph.createBuffer( "histogram", kHistogramBins * sizeof( uint32_t ) );
+    Handle backbuffer = _graph.importTexture( "backbuffer", view->currentDrawable()->texture() );
+
+    auto dispatch2D = []( MTL::ComputeCommandEncoder* enc, MTL::ComputePipelineState* pso, uint32_t w, uint32_t h ) {
+        enc->setComputePipelineState( pso );
+        enc->dispatchThreads( MTL::Size( w, h, 1 ), MTL::Size( 16, 16, 1 ) );
+    };
+
+    // the texture is regenerated every frame while panning, so it only lives until the scene pass is done
+    Handle mandelbrotPass = _graph.addPass( "mandelbrot", [=]( RenderGraph& g, MTL::CommandBuffer* cmd ) {
+        const float zoom = 1.f + 0.5f * sinf( _angle * 5.f );
+        MTL::ComputeCommandEncoder* enc = cmd->computeCommandEncoder();
+        enc->setTexture( g.texture( mandelbrot ), 0 );
+        enc->setBytes( &zoom, sizeof( zoom ), 0 );
+        dispatch2D( enc, _mandelbrotPSO, kTextureWidth, kTextureHeight );
+        enc->endEncoding();
+    } );
+    _graph.write( mandelbrotPass, mandelbrot );
+
+    Handle scenePass = _graph.addPass( "scene", [=]( RenderGraph& g, MTL::CommandBuffer* cmd ) {
+        MTL::RenderPassDescriptor* rpd = MTL::RenderPassDescriptor::renderPassDescriptor();
+        MTL::RenderPassColorAttachmentDescriptor* color = rpd->colorAttachments()->object( 0 );
+        color->setTexture( g.texture( sceneColor ) );
+        color->setLoadAction( MTL::LoadActionClear );
+        color->setStoreAction( MTL::StoreActionStore );
+        color->setClearColor( MTL::ClearColor::Make( 0.1, 0.1, 0.1, 1.0 ) );
+        rpd->depthAttachment()->setTexture( g.texture( sceneDepth ) );
+        rpd->depthAttachment()->setLoadAction( MTL::LoadActionClear );
+        rpd->depthAttachment()->setStoreAction( MTL::StoreActionDontCare );
+        rpd->depthAttachment()->setClearDepth( 1.0 );
+
+        MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder( rpd );
+        enc->setRenderPipelineState( _scenePSO );
+        enc->setDepthStencilState( _depthStencilState );
+        enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+        enc->setVertexBuffer( instanceDataBuffer, /* offset */ 0, /* index */ 1 );
+        enc->setVertexBuffer( cameraDataBuffer, /* offset */ 0, /* index */ 2 );
+        enc->setFragmentTexture( g.texture( mandelbrot ), /* index */ 0 );
+        enc->setCullMode( MTL::CullModeBack );
+        enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+        enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                    6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                    _indexBuffer,
+                                    0,
+                                    kNumInstances );
+        enc->endEncoding();
+    } );
+    _graph.read( scenePass, mandelbrot );
+    _graph.write( scenePass, sceneColor );
+    _graph.write( scenePass, sceneDepth );
+
+    // nothing consumes the histogram yet, the graph drops this pass
+    Handle histogramPass = _graph.addPass( "histogram", [=]( RenderGraph& g, MTL::CommandBuffer* cmd ) {
+        MTL::ComputeCommandEncoder* enc = cmd->computeCommandEncoder();
+        enc->setTexture( g.texture( sceneColor ), 0 );
+        enc->setBuffer( g.buffer( histogram ), 0, 0 );
+        dispatch2D( enc, _histogramPSO, width, height );
+        enc->endEncoding();
+    } );
+    _graph.read( histogramPass, sceneColor );
+    _graph.write( histogramPass, histogram );
+
+    Handle brightPass = _graph.addPass( "bright", [=]( RenderGraph& g, MTL::CommandBuffer* cmd ) {
+        MTL::ComputeCommandEncoder* enc = cmd->computeCommandEncoder();
+        enc->setTexture( g.texture( sceneColor ), 0 );
+        enc->setTexture( g.texture( bright ), 1 );
+        dispatch2D( enc, _brightPSO, width / 2, height / 2 );
+        enc->endEncoding();
+    } );
+    _graph.read( brightPass, sceneColor );
+    _graph.write( brightPass, bright );
+
+    Handle blurHPass = _graph.addPass( "blurH", [=]( RenderGraph& g, MTL::CommandBuffer* cmd ) {
+        MTL::ComputeCommandEncoder* enc = cmd->computeCommandEncoder();
+        enc->setTexture( g.texture( bright ), 0 );
+        enc->setTexture( g.texture( blurA ), 1 );
+        dispatch2D( enc, _blurHPSO, width / 2, height / 2 );
+        enc->endEncoding();
+    } );
+    _graph.read( blurHPass, bright );
+    _graph.write( blurHPass, blurA );
+
+    Handle blurVPass = _graph.addPass( "blurV", [=]( RenderGraph& g, MTL::CommandBuffer* cmd ) {
+        MTL::ComputeCommandEncoder* enc = cmd->computeCommandEncoder();
+        enc->setTexture( g.texture( blurA ), 0 );
+        enc->setTexture( g.texture( blurB ), 1 );
+        dispatch2D( enc, _blurVPSO, width / 2, height / 2 );
+        enc->endEncoding();
+    } );
+    _graph.read( blurVPass, blurA );
+    _graph.write( blurVPass, blurB );
+
+    Handle compositePass = _graph.addPass( "composite", [=]( RenderGraph& g, MTL::CommandBuffer* cmd ) {
+        MTL::RenderPassDescriptor* rpd = MTL::RenderPassDescriptor::renderPassDescriptor();
+        MTL::RenderPassColorAttachmentDescriptor* color = rpd->colorAttachments()->object( 0 );
+        color->setTexture( g.texture( backbuffer ) );
+        color->setLoadAction( MTL::LoadActionDontCare );
+        color->setStoreAction( MTL::StoreActionStore );
+
+        MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder( rpd );
+        enc->setRenderPipelineState( _compositePSO );
+        enc->setFragmentTexture( g.texture( sceneColor ), 0 );
+        enc->setFragmentTexture( g.texture( blurB ), 1 );
+        enc->drawPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle, NS::UInteger(0), NS::UInteger(3) );
+        enc->endEncoding();
+    } );
+    _graph.read( compositePass, sceneColor );
+    _graph.read( compositePass, blurB );
+    _graph.write( compositePass, backbuffer );
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        pInstanceData[ i ].instanceTransform = fullObjectRot * translate * yrot * zrot * scale;
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( pInstanceData[ i ].instanceTransform );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+    }
+    instanceDataBuffer->didModifyRange( NS::Range::Make( 0, instanceDataBuffer->length() ) );
+
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+    cameraDataBuffer->didModifyRange( NS::Range::Make( 0, sizeof( shader_types::CameraData ) ) );
+}
+
+MTL::ComputePipelineState* Renderer::buildKernel(MTL::Library *library, const char *name) {
+    NS::Error* error = nullptr;
+
+    MTL::Function* fn = library->newFunction( NS::String::string(name, NS::UTF8StringEncoding) );
+    MTL::ComputePipelineState* pso = _device->newComputePipelineState( fn, &error );
+    if ( !pso )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert(false);
+    }
+
+    fn->release();
+    return pso;
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+            float2 texcoord;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = float4( vd.position, 1.0 );
+            pos = instanceData[ instanceId ].instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+
+            float3 normal = instanceData[ instanceId ].instanceNormalTransform * vd.normal;
+            normal = cameraData.worldNormalTransform * normal;
+            o.normal = normal;
+
+            o.texcoord = vd.texcoord.xy;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]], texture2d< half, access::sample > tex [[texture(0)]] )
+        {
+            constexpr sampler s( address::repeat, filter::linear );
+            half3 texel = tex.sample( s, in.texcoord ).rgb;
+
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            half3 illum = (in.color * texel * 0.1) + (in.color * texel * ndotl) * 2.0;
+            return half4( illum, 1.0 );
+        }
+
+        struct CompositeOut
+        {
+            float4 position [[position]];
+            float2 texcoord;
+        };
+
+        CompositeOut vertex compositeVertex( uint vertexId [[vertex_id]] )
+        {
+            // one triangle covering the whole screen
+            float2 uv = float2( ( vertexId << 1 ) & 2, vertexId & 2 );
+            CompositeOut o;
+            o.position = float4( uv * float2( 2.0, -2.0 ) + float2( -1.0, 1.0 ), 0.0, 1.0 );
+            o.texcoord = uv;
+            return o;
+        }
+
+        half4 fragment compositeFragment( CompositeOut in [[stage_in]],
+                                          texture2d< half, access::sample > scene [[texture(0)]],
+                                          texture2d< half, access::sample > bloom [[texture(1)]] )
+        {
+            constexpr sampler s( address::clamp_to_edge, filter::linear );
+            half3 color = scene.sample( s, in.texcoord ).rgb + bloom.sample( s, in.texcoord ).rgb * 0.6;
+            return half4( color / ( color + 1.0 ), 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    const char* kernelSrc = R"(
+        #include <metal_stdlib>
+        using namespace metal;
+
+        kernel void mandelbrot_set(texture2d< half, access::write > tex [[texture(0)]],
+                                   constant float& zoom [[buffer(0)]],
+                                   uint2 index [[thread_position_in_grid]],
+                                   uint2 gridSize [[threads_per_grid]])
+        {
+            // Scale
+            float x0 = ( 2.0 * index.x / gridSize.x - 1.5 ) / zoom;
+            float y0 = ( 2.0 * index.y / gridSize.y - 1.0 ) / zoom;
+
+            // Implement Mandelbrot set
+            float x = 0.0;
+            float y = 0.0;
+            uint iteration = 0;
+            uint max_iteration = 256;
+            float xtmp = 0.0;
+            while(x * x + y * y <= 4 && iteration < max_iteration)
+            {
+                xtmp = x * x - y * y + x0;
+                y = 2 * x * y + y0;
+                x = xtmp;
+                iteration += 1;
+            }
+
+            // Convert iteration result to colors
+            half color = (0.5 + 0.5 * cos(3.0 + iteration * 0.15));
+            tex.write(half4(color, color, color, 1.0), index, 0);
+        }
+
+        kernel void bright_pass(texture2d< half, access::read > src [[texture(0)]],
+                                texture2d< half, access::write > dst [[texture(1)]],
+                                uint2 index [[thread_position_in_grid]])
+        {
+            // 2x2 box down sample, keep what is brighter than 1
+            uint2 p = index * 2;
+            half3 c = ( src.read( p ).rgb + src.read( p + uint2( 1, 0 ) ).rgb
+                      + src.read( p + uint2( 0, 1 ) ).rgb + src.read( p + uint2( 1, 1 ) ).rgb ) * 0.25;
+            dst.write( half4( max( c - 1.0, 0.0 ), 1.0 ), index );
+        }
+
+        constant float kWeights[5] = { 0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216 };
+
+        static half3 blur(texture2d< half, access::read > src, int2 index, int2 step)
+        {
+            int2 size = int2( src.get_width(), src.get_height() ) - 1;
+            half3 c = src.read( uint2( index ) ).rgb * kWeights[0];
+            for ( int i = 1; i < 5; ++i )
+            {
+                c += src.read( uint2( clamp( index + step * i, int2( 0 ), size ) ) ).rgb * kWeights[i];
+                c += src.read( uint2( clamp( index - step * i, int2( 0 ), size ) ) ).rgb * kWeights[i];
+            }
+            return c;
+        }
+
+        kernel void blur_h(texture2d< half, access::read > src [[texture(0)]],
+                           texture2d< half, access::write > dst [[texture(1)]],
+                           uint2 index [[thread_position_in_grid]])
+        {
+            dst.write( half4( blur( src, int2( index ), int2( 1, 0 ) ), 1.0 ), index );
+        }
+
+        kernel void blur_v(texture2d< half, access::read > src [[texture(0)]],
+                           texture2d< half, access::write > dst [[texture(1)]],
+                           uint2 index [[thread_position_in_grid]])
+        {
+            dst.write( half4( blur( src, int2( index ), int2( 0, 1 ) ), 1.0 ), index );
+        }
+
+        kernel void luminance_histogram(texture2d< half, access::read > src [[texture(0)]],
+                                        device atomic_uint* bins [[buffer(0)]],
+                                        uint2 index [[thread_position_in_grid]])
+        {
+            half3 c = src.read( index ).rgb;
+            half l = dot( c, half3( 0.2126, 0.7152, 0.0722 ) );
+            uint bin = min( uint( l / ( l + 1.0 ) * 255.0 ), 255u );
+            atomic_fetch_add_explicit( &bins[ bin ], 1, memory_order_relaxed );
+        }
+    )";
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatRGBA16Float);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _scenePSO = _device->newRenderPipelineState(desc, &error);
+    if(!_scenePSO) {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+
+    vertexFn = library->newFunction(NS::String::string("compositeVertex", UTF8StringEncoding));
+    fragFn = library->newFunction( NS::String::string("compositeFragment", UTF8StringEncoding) );
+
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatInvalid );
+
+    _compositePSO = _device->newRenderPipelineState(desc, &error);
+    if(!_compositePSO) {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+
+    _shaderLibrary = library;
+
+    MTL::Library* computeLibrary = _device->newLibrary( NS::String::string(kernelSrc, UTF8StringEncoding), nullptr, &error );
+    if ( !computeLibrary )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert(false);
+    }
+
+    _mandelbrotPSO = buildKernel( computeLibrary, "mandelbrot_set" );
+    _brightPSO = buildKernel( computeLibrary, "bright_pass" );
+    _blurHPSO = buildKernel( computeLibrary, "blur_h" );
+    _blurVPSO = buildKernel( computeLibrary, "blur_v" );
+    _histogramPSO = buildKernel( computeLibrary, "luminance_histogram" );
+
+    computeLibrary->release();
+}
+
+void Renderer::buildBuffers() {
+    using simd::float2;
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //                                         Texture
+        //   Positions           Normals         Coordinates
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 0.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 0.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 0.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f }, { 0.f, 0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    const size_t vertexDataSize = sizeof( verts );
+    const size_t indexDataSize = sizeof( indices );
+
+    MTL::Buffer* pVertexBuffer = _device->newBuffer( vertexDataSize, MTL::ResourceStorageModeManaged );
+    MTL::Buffer* pIndexBuffer = _device->newBuffer( indexDataSize, MTL::ResourceStorageModeManaged );
+
+    _vertexDataBuffer = pVertexBuffer;
+    _indexBuffer = pIndexBuffer;
+
+    memcpy( _vertexDataBuffer->contents(), verts, vertexDataSize );
+    memcpy( _indexBuffer->contents(), indices, indexDataSize );
+
+    _vertexDataBuffer->didModifyRange( NS::Range::Make( 0, _vertexDataBuffer->length() ) );
+    _indexBuffer->didModifyRange( NS::Range::Make( 0, _indexBuffer->length() ) );
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeManaged );
+    }
+
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeManaged );
+    }
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include "render_graph.hpp"
+#include "shader_types.hpp"
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _scenePSO;
+    MTL::RenderPipelineState* _compositePSO;
+    MTL::ComputePipelineState* _mandelbrotPSO;
+    MTL::ComputePipelineState* _brightPSO;
+    MTL::ComputePipelineState* _blurHPSO;
+    MTL::ComputePipelineState* _blurVPSO;
+    MTL::ComputePipelineState* _histogramPSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+
+    RenderGraph _graph;
+    double _compileSeconds;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    MTL::ComputePipelineState* buildKernel(MTL::Library* library, const char* name);
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+    void buildFrameGraph(MTK::View* view, MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,490 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <chrono>
+#include <string>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr uint32_t kTextureWidth = 2048;
+static constexpr uint32_t kTextureHeight = 2048;
+
+static constexpr size_t kScratchPerFrame = 8;
+static constexpr uint64_t kScratchMinLifetime = kMaxFramesInFlight + 1;
+static constexpr uint64_t kScratchMaxLifetime = 120;
+static constexpr uint64_t kDefragInterval = 120;
+static constexpr size_t kDefragMaxMoves = 32;
+static constexpr uint64_t kStatsInterval = 300;
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _sharedHeap(device, MTL::StorageModeShared, 16ull << 20)
+, _privateHeap(device, MTL::StorageModePrivate, 64ull << 20)
+, _rng(42)
+, _allocSeconds(0.0)
+, _allocCalls(0)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+    if ( buildTextures() )
+    {
+        generateMandelbrotTexture();
+    }
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    // the heaps release whatever is still allocated out of them
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _computePSO->release();
+    _PSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _sharedHeap.buffer( _instanceDataBuffer[ _frame ] );
+    MTL::Buffer* pCameraDataBuffer = _sharedHeap.buffer( _cameraDataBuffer[ _frame ] );
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    ++_frameCount;
+    churnScratch( cmd );
+
+    // only the private heap is compacted, moving the shared buffers would race the cpu writes below
+    if ( _frameCount % kDefragInterval == 0 )
+    {
+        _privateHeap.defragment( cmd, kDefragMaxMoves );
+    }
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+
+    enc->setRenderPipelineState(_PSO);
+    enc->setDepthStencilState( _depthStencilState );
+
+    enc->setVertexBuffer( _sharedHeap.buffer( _vertexDataBuffer ), /* offset */ 0, /* index */ 0 );
+    enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    // without the texture the pass only clears, buildTextures() said why
+    if ( _texture != HeapAllocator::kInvalidHandle )
+    {
+        enc->setFragmentTexture( _privateHeap.texture( _texture ), /* index */ 0 );
+        enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                    6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                    _sharedHeap.buffer( _indexBuffer ),
+                                    0,
+                                    kNumInstances );
+    }
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    if ( _frameCount % kStatsInterval == 0 )
+    {
+        printStats();
+    }
+
+    pool->release();
+}
+
+void Renderer::churnScratch(MTL::CommandBuffer *cmd) {
+    auto begin = std::chrono::steady_clock::now();
+
+    // the frame that last used an expired buffer has completed, the semaphore saw to that
+    for ( size_t i = 0; i < _scratch.size(); )
+    {
+        if ( _scratch[ i ].releaseFrame > _frameCount )
+        {
+            ++i;
+            continue;
+        }
+        _privateHeap.release( _scratch[ i ].buffer );
+        _scratch[ i ] = _scratch.back();
+        _scratch.pop_back();
+        ++_allocCalls;
+    }
+
+    // 4 KB to 4 MB, log uniform
+    std::uniform_real_distribution<float> sizeLog2( 12.f, 22.f );
+    std::uniform_int_distribution<uint64_t> lifetime( kScratchMinLifetime, kScratchMaxLifetime );
+
+    size_t first = _scratch.size();
+    for ( size_t i = 0; i < kScratchPerFrame; ++i )
+    {
+        const size_t length = (size_t)exp2f( sizeLog2( _rng ) );
+        Handle h = _privateHeap.newBuffer( length );
+        if ( h == HeapAllocator::kInvalidHandle )
+        {
+            continue;
+        }
+        _scratch.push_back( { h, _frameCount + lifetime( _rng ) } );
+        ++_allocCalls;
+    }
+
+    _allocSeconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+
+    // touch the new memory so the gpu actually uses it
+    MTL::BlitCommandEncoder* blit = cmd->blitCommandEncoder();
+    for ( size_t i = first; i < _scratch.size(); ++i )
+    {
+        MTL::Buffer* buffer = _privateHeap.buffer( _scratch[ i ].buffer );
+        blit->fillBuffer( buffer, NS::Range::Make( 0, buffer->length() ), (uint8_t)i );
+    }
+    blit->endEncoding();
+}
+
+void Renderer::printStats() {
+    const double mb = 1.0 / ( 1024.0 * 1024.0 );
+
+    auto print = [&]( const char* name, HeapAllocator& heap ) {
+        HeapAllocatorStats s = heap.stats();
+        __builtin_printf( "%s heap: %zu heaps, %.1f / %.1f MB used, %zu resources, fragmentation %.2f, "
+                          "%.1f allocs %.1f releases %.2f moves (%.2f MB) per frame\n",
+                          name, s.heapCount, s.usedBytes * mb, s.reservedBytes * mb, s.allocationCount, s.fragmentation,
+                          (double)s.allocations / kStatsInterval, (double)s.releases / kStatsInterval,
+                          (double)s.moves / kStatsInterval, s.movedBytes * mb / kStatsInterval );
+        heap.resetFrameStats();
+    };
+
+    print( "shared", _sharedHeap );
+    print( "private", _privateHeap );
+    __builtin_printf( "scratch: %.2f M allocs+releases/s on the cpu\n", _allocCalls / _allocSeconds * 1e-6 );
+
+    _allocSeconds = 0.0;
+    _allocCalls = 0;
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        pInstanceData[ i ].instanceTransform = fullObjectRot * translate * yrot * zrot * scale;
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( pInstanceData[ i ].instanceTransform );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+    }
+
+    // shared storage, no didModifyRange needed
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+}
+
+void Renderer::generateMandelbrotTexture() {
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+
+    MTL::ComputeCommandEncoder* enc = cmd->computeCommandEncoder();
+    enc->setComputePipelineState( _computePSO );
+    enc->setTexture( _privateHeap.texture( _texture ), 0 );
+    enc->dispatchThreads( MTL::Size( kTextureWidth, kTextureHeight, 1 ), MTL::Size( 16, 16, 1 ) );
+    enc->endEncoding();
+
+    cmd->commit();
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+            float2 texcoord;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = float4( vd.position, 1.0 );
+            pos = instanceData[ instanceId ].instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+
+            float3 normal = instanceData[ instanceId ].instanceNormalTransform * vd.normal;
+            normal = cameraData.worldNormalTransform * normal;
+            o.normal = normal;
+
+            o.texcoord = vd.texcoord.xy;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]], texture2d< half, access::sample > tex [[texture(0)]] )
+        {
+            constexpr sampler s( address::repeat, filter::linear );
+            half3 texel = tex.sample( s, in.texcoord ).rgb;
+
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            half3 illum = (in.color * texel * 0.1) + (in.color * texel * ndotl);
+            return half4( illum, 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    const char* kernelSrc = R"(
+        #include <metal_stdlib>
+        using namespace metal;
+
+        kernel void mandelbrot_set(texture2d< half, access::write > tex [[texture(0)]],
+                                   uint2 index [[thread_position_in_grid]],
+                                   uint2 gridSize [[threads_per_grid]])
+        {
+            // Scale
+            float x0 = 2.0 * index.x / gridSize.x - 1.5;
+            float y0 = 2.0 * index.y / gridSize.y - 1.0;
+
+            // Implement Mandelbrot set
+            float x = 0.0;
+            float y = 0.0;
+            uint iteration = 0;
+            uint max_iteration = 1000;
+            float xtmp = 0.0;
+            while(x * x + y * y <= 4 && iteration < max_iteration)
+            {
+                xtmp = x * x - y * y + x0;
+                y = 2 * x * y + y0;
+                x = xtmp;
+                iteration += 1;
+            }
+
+            // Convert iteration result to colors
+            half color = (0.5 + 0.5 * cos(3.0 + iteration * 0.15));
+            tex.write(half4(color, color, color, 1.0), index, 0);
+        }
+    )";
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+    _shaderLibrary = library;
+
+    MTL::Library* computeLibrary = _device->newLibrary( NS::String::string(kernelSrc, UTF8StringEncoding), nullptr, &error );
+    if ( !computeLibrary )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert(false);
+    }
+
+    MTL::Function* mandelbrotFn = computeLibrary->newFunction( NS::String::string("mandelbrot_set", UTF8StringEncoding) );
+    _computePSO = _device->newComputePipelineState( mandelbrotFn, &error );
+    if ( !_computePSO )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert(false);
+    }
+
+    mandelbrotFn->release();
+    computeLibrary->release();
+}
+
+void Renderer::buildBuffers() {
+    using simd::float2;
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //                                         Texture
+        //   Positions           Normals         Coordinates
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 0.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 0.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 0.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f }, { 0.f, 0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    const size_t vertexDataSize = sizeof( verts );
+    const size_t indexDataSize = sizeof( indices );
+
+    _vertexDataBuffer = _sharedHeap.newBuffer( vertexDataSize );
+    _indexBuffer = _sharedHeap.newBuffer( indexDataSize );
+
+    memcpy( _sharedHeap.buffer( _vertexDataBuffer )->contents(), verts, vertexDataSize );
+    memcpy( _sharedHeap.buffer( _indexBuffer )->contents(), indices, indexDataSize );
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _sharedHeap.newBuffer( instanceDataSize );
+    }
+
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _sharedHeap.newBuffer( cameraDataSize );
+    }
+}
+
+bool Renderer::buildTextures() {
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    pTextureDesc->setWidth( kTextureWidth );
+    pTextureDesc->setHeight( kTextureHeight );
+    pTextureDesc->setPixelFormat( MTL::PixelFormatRGBA8Unorm );
+    pTextureDesc->setTextureType( MTL::TextureType2D );
+    pTextureDesc->setUsage( MTL::ResourceUsageSample | MTL::ResourceUsageRead | MTL::ResourceUsageWrite );
+
+    _texture = _privateHeap.newTexture( pTextureDesc );
+
+    pTextureDesc->release();
+
+    if ( _texture == HeapAllocator::kInvalidHandle )
+    {
+        __builtin_printf( "failed to place the %ux%u texture in the private heap\n", kTextureWidth, kTextureHeight );
+        return false;
+    }
+    return true;
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
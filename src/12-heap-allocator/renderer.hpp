@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include <random>
+#include <vector>
+
+#include "heap_allocator.hpp"
+#include "shader_types.hpp"
+
+class Renderer {
+private:
+    using Handle = HeapAllocator::Handle;
+
+    // short lived gpu scratch memory, stands in for per frame streaming data
+    struct Scratch
+    {
+        Handle buffer;
+        uint64_t releaseFrame;
+    };
+
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _PSO;
+    MTL::ComputePipelineState* _computePSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    // cpu written data lives in a shared heap, gpu only data in a private one
+    HeapAllocator _sharedHeap;
+    HeapAllocator _privateHeap;
+
+    Handle _vertexDataBuffer;
+    Handle _instanceDataBuffer[3];
+    Handle _cameraDataBuffer[3];
+    Handle _indexBuffer;
+    Handle _texture;
+
+    std::vector<Scratch> _scratch;
+    std::mt19937 _rng;
+    double _allocSeconds;
+    size_t _allocCalls;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    void generateMandelbrotTexture();
+    void churnScratch(MTL::CommandBuffer* cmd);
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+    void printStats();
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    // false when the texture does not fit, the cubes are not drawn then
+    bool buildTextures();
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,460 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr uint32_t kTextureWidth = 4096;
+static constexpr uint32_t kTextureHeight = 4096;
+static constexpr uint32_t kMaxIterations = 96;
+static constexpr uint64_t kTextureHoldFrames = 120;
+static constexpr uint64_t kStatsInterval = 300;
+
+static bool isReady( const std::future<void>& future )
+{
+    return future.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _displayed(-1)
+, _zoom(1.f)
+, _swapFrame(0)
+, _copyEngine(device)
+, _uploads(_copyEngine)
+, _textureUploading(false)
+, _frameSeconds(0.0)
+, _worstFrameSeconds(0.0)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+    buildTextures();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    // the upload worker may still be writing into our resources
+    _uploads.drain();
+
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[i]->release();
+    }
+    _indexBuffer->release();
+    _textures[0]->release();
+    _textures[1]->release();
+    _placeholder->release();
+    _PSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    auto frameBegin = std::chrono::steady_clock::now();
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    ++_frameCount;
+    pollUploads();
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+
+    // nothing to draw until the cube made it to the gpu, the frame still goes out
+    if ( !_geometryReady.valid() )
+    {
+        enc->setRenderPipelineState(_PSO);
+        enc->setDepthStencilState( _depthStencilState );
+
+        enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+        enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+        enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+
+        enc->setFragmentTexture( _displayed < 0 ? _placeholder : _textures[ _displayed ], /* index */ 0 );
+
+        enc->setCullMode( MTL::CullModeBack );
+        enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+        enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                    6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                    _indexBuffer,
+                                    0,
+                                    kNumInstances );
+    }
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+
+    const double frameSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - frameBegin ).count();
+    _frameSeconds += frameSeconds;
+    _worstFrameSeconds = std::max( _worstFrameSeconds, frameSeconds );
+
+    if ( _frameCount % kStatsInterval == 0 )
+    {
+        UploadQueueStats s = _uploads.stats();
+        __builtin_printf( "uploads: %zu requests in %zu batches, %.1f MB, latency avg %.1f ms max %.1f ms | frame cpu avg %.2f ms worst %.2f ms\n",
+                          s.requests, s.batches, s.bytes / ( 1024.0 * 1024.0 ),
+                          s.requests ? s.latencySeconds * 1e3 / s.requests : 0.0, s.maxLatencySeconds * 1e3,
+                          _frameSeconds * 1e3 / kStatsInterval, _worstFrameSeconds * 1e3 );
+        _frameSeconds = 0.0;
+        _worstFrameSeconds = 0.0;
+    }
+}
+
+void Renderer::pollUploads() {
+    if ( _geometryReady.valid() && isReady( _geometryReady ) )
+    {
+        _geometryReady = {};
+    }
+
+    if ( _textureUploading && isReady( _textureReady ) )
+    {
+        _textureUploading = false;
+        _displayed = ( _displayed + 1 ) % 2;
+        _swapFrame = _frameCount;
+    }
+
+    // frames in flight may still sample the texture we are about to overwrite
+    if ( !_textureUploading && _frameCount >= _swapFrame + kMaxFramesInFlight + kTextureHoldFrames )
+    {
+        _zoom = _zoom > 64.f ? 1.f : _zoom * 1.5f;
+        uploadTexture( ( _displayed + 1 ) % 2, _zoom );
+    }
+}
+
+void Renderer::uploadTexture(int index, float zoom) {
+    const size_t bytesPerRow = kTextureWidth * 4;
+
+    // generated row band by row band on the upload thread, straight into staging memory
+    _textureReady = _uploads.uploadTexture( _textures[ index ], 0, kTextureWidth, kTextureHeight, bytesPerRow,
+                                            [zoom, bytesPerRow]( void* dst, size_t offset, size_t length ) {
+        const uint32_t firstRow = (uint32_t)( offset / bytesPerRow );
+        const uint32_t rows = (uint32_t)( length / bytesPerRow );
+        uint8_t* out = (uint8_t*)dst;
+
+        for ( uint32_t row = firstRow; row < firstRow + rows; ++row )
+        {
+            for ( uint32_t col = 0; col < kTextureWidth; ++col )
+            {
+                float x0 = ( 2.f * col / kTextureWidth - 1.f ) / zoom - 0.7436f;
+                float y0 = ( 2.f * row / kTextureHeight - 1.f ) / zoom + 0.1318f;
+
+                float x = 0.f;
+                float y = 0.f;
+                uint32_t iteration = 0;
+                while ( x * x + y * y <= 4.f && iteration < kMaxIterations )
+                {
+                    float xtmp = x * x - y * y + x0;
+                    y = 2.f * x * y + y0;
+                    x = xtmp;
+                    ++iteration;
+                }
+
+                const uint8_t c = (uint8_t)( 255.f * ( 0.5f + 0.5f * cosf( 3.f + iteration * 0.15f ) ) );
+                out[0] = c;
+                out[1] = c;
+                out[2] = c;
+                out[3] = 255;
+                out += 4;
+            }
+        }
+    } );
+    _textureUploading = true;
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        pInstanceData[ i ].instanceTransform = fullObjectRot * translate * yrot * zrot * scale;
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( pInstanceData[ i ].instanceTransform );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+    }
+
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+            float2 texcoord;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = float4( vd.position, 1.0 );
+            pos = instanceData[ instanceId ].instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+
+            float3 normal = instanceData[ instanceId ].instanceNormalTransform * vd.normal;
+            normal = cameraData.worldNormalTransform * normal;
+            o.normal = normal;
+
+            o.texcoord = vd.texcoord.xy;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]], texture2d< half, access::sample > tex [[texture(0)]] )
+        {
+            constexpr sampler s( address::repeat, filter::linear );
+            half3 texel = tex.sample( s, in.texcoord ).rgb;
+
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            half3 illum = (in.color * texel * 0.1) + (in.color * texel * ndotl);
+            return half4( illum, 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+    _shaderLibrary = library;
+}
+
+void Renderer::buildBuffers() {
+    using simd::float2;
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //                                         Texture
+        //   Positions           Normals         Coordinates
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 0.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 0.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 0.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f }, { 0.f, 0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    const size_t vertexDataSize = sizeof( verts );
+    const size_t indexDataSize = sizeof( indices );
+
+    _vertexDataBuffer = _device->newBuffer( vertexDataSize, MTL::ResourceStorageModePrivate );
+    _indexBuffer = _device->newBuffer( indexDataSize, MTL::ResourceStorageModePrivate );
+
+    // the arrays die with this scope, the upload keeps its own copy
+    auto upload = [this]( MTL::Buffer* dst, const void* data, size_t size ) {
+        auto bytes = std::make_shared< std::vector<uint8_t> >( (const uint8_t*)data, (const uint8_t*)data + size );
+        return _uploads.uploadBuffer( dst, 0, size, [bytes]( void* out, size_t offset, size_t length ) {
+            memcpy( out, bytes->data() + offset, length );
+        } );
+    };
+
+    // uploads complete in order, the index buffer landing means the vertices did too
+    upload( _vertexDataBuffer, verts, vertexDataSize );
+    _geometryReady = upload( _indexBuffer, indices, indexDataSize );
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+    }
+
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::buildTextures() {
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    pTextureDesc->setWidth( 1 );
+    pTextureDesc->setHeight( 1 );
+    pTextureDesc->setPixelFormat( MTL::PixelFormatRGBA8Unorm );
+    pTextureDesc->setTextureType( MTL::TextureType2D );
+    pTextureDesc->setStorageMode( MTL::StorageModeManaged );
+    pTextureDesc->setUsage( MTL::ResourceUsageSample | MTL::ResourceUsageRead );
+
+    // shown until the first upload lands
+    const uint8_t white[4] = { 255, 255, 255, 255 };
+    _placeholder = _device->newTexture( pTextureDesc );
+    _placeholder->replaceRegion( MTL::Region::Make2D( 0, 0, 1, 1 ), 0, white, sizeof( white ) );
+
+    pTextureDesc->setWidth( kTextureWidth );
+    pTextureDesc->setHeight( kTextureHeight );
+    pTextureDesc->setStorageMode( MTL::StorageModePrivate );
+
+    _textures[0] = _device->newTexture( pTextureDesc );
+    _textures[1] = _device->newTexture( pTextureDesc );
+
+    pTextureDesc->release();
+
+    uploadTexture( 0, _zoom );
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include <future>
+
+#include "metal_copy_engine.hpp"
+#include "shader_types.hpp"
+#include "upload_queue.hpp"
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _PSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+
+    // the sampled texture is swapped for the other one once its upload lands
+    MTL::Texture* _placeholder;
+    MTL::Texture* _textures[2];
+    int _displayed;
+    float _zoom;
+    uint64_t _swapFrame;
+
+    MetalCopyEngine _copyEngine;
+    UploadQueue _uploads;
+    std::future<void> _geometryReady;
+    std::future<void> _textureReady;
+    bool _textureUploading;
+
+    double _frameSeconds;
+    double _worstFrameSeconds;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    void uploadTexture(int index, float zoom);
+    void pollUploads();
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildTextures();
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
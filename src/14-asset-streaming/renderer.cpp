@@ -0,0 +1,515 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "job_system.hpp"
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr size_t kCubeVertexCount = 24;
+static constexpr size_t kCubeIndexCount = 36;
+static constexpr uint32_t kTextureWidth = 4096;
+static constexpr uint32_t kTextureHeight = 4096;
+static constexpr uint32_t kMaxIterations = 96;
+static constexpr size_t kTextureAssets = 4;
+static constexpr uint64_t kTextureHoldFrames = 120;
+static constexpr uint64_t kStatsInterval = 300;
+
+static bool isReady( const std::future<bool>& future )
+{
+    return future.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _displayed(-1)
+, _swapFrame(0)
+, _streamer(AssetStreamer::create( device, getenv( "PLAYGROUND_CPU_STREAMING" ) == nullptr ))
+, _nextAsset(0)
+, _geometryLoading(false)
+, _textureLoading(false)
+, _loadSeconds(0.0)
+, _loadBytes(0)
+, _frameSeconds(0.0)
+, _worstFrameSeconds(0.0)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    const char* tmp = getenv( "TMPDIR" );
+    _assetDir = tmp ? tmp : "/tmp/";
+    if ( _assetDir.back() != '/' )
+    {
+        _assetDir += '/';
+    }
+    __builtin_printf( "streaming through the %s\n", _streamer->name() );
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildAssets();
+    buildBuffers();
+    buildTextures();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    // loads still in flight write into our resources
+    if ( _geometryLoading )
+    {
+        _vertexReady.wait();
+        _indexReady.wait();
+    }
+    if ( _textureLoading )
+    {
+        _textureReady.wait();
+    }
+    delete _streamer;
+
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[i]->release();
+    }
+    _indexBuffer->release();
+    _textures[0]->release();
+    _textures[1]->release();
+    _placeholder->release();
+    _PSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    auto frameBegin = std::chrono::steady_clock::now();
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    ++_frameCount;
+    pollLoads();
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+
+    // nothing to draw until the cube is loaded, the frame still goes out
+    if ( !_geometryLoading )
+    {
+        enc->setRenderPipelineState(_PSO);
+        enc->setDepthStencilState( _depthStencilState );
+
+        enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+        enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+        enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+
+        enc->setFragmentTexture( _displayed < 0 ? _placeholder : _textures[ _displayed ], /* index */ 0 );
+
+        enc->setCullMode( MTL::CullModeBack );
+        enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+        enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                    kCubeIndexCount, MTL::IndexType::IndexTypeUInt16,
+                                    _indexBuffer,
+                                    0,
+                                    kNumInstances );
+    }
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+
+    const double frameSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - frameBegin ).count();
+    _frameSeconds += frameSeconds;
+    _worstFrameSeconds = std::max( _worstFrameSeconds, frameSeconds );
+
+    if ( _frameCount % kStatsInterval == 0 )
+    {
+        __builtin_printf( "%s: %.1f MB in %.1f ms, %.2f GB/s | frame cpu avg %.2f ms worst %.2f ms\n",
+                          _streamer->name(), _loadBytes / ( 1024.0 * 1024.0 ), _loadSeconds * 1e3,
+                          _loadSeconds > 0.0 ? _loadBytes / _loadSeconds * 1e-9 : 0.0,
+                          _frameSeconds * 1e3 / kStatsInterval, _worstFrameSeconds * 1e3 );
+        _loadSeconds = 0.0;
+        _loadBytes = 0;
+        _frameSeconds = 0.0;
+        _worstFrameSeconds = 0.0;
+    }
+}
+
+void Renderer::pollLoads() {
+    if ( _geometryLoading && isReady( _vertexReady ) && isReady( _indexReady ) )
+    {
+        _geometryLoading = false;
+        if ( !_vertexReady.get() || !_indexReady.get() )
+        {
+            __builtin_printf( "cube failed to load\n" );
+            assert( false );
+        }
+    }
+
+    if ( _textureLoading && isReady( _textureReady ) )
+    {
+        _textureLoading = false;
+        _loadSeconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - _loadBegin ).count();
+        _loadBytes += (uint64_t)kTextureWidth * kTextureHeight * 4;
+
+        // a failed load keeps showing the previous texture
+        if ( _textureReady.get() )
+        {
+            _displayed = ( _displayed + 1 ) % 2;
+            _swapFrame = _frameCount;
+        }
+    }
+
+    // frames in flight may still sample the texture we are about to overwrite
+    if ( !_textureLoading && _frameCount >= _swapFrame + kMaxFramesInFlight + kTextureHoldFrames )
+    {
+        loadTexture( ( _displayed + 1 ) % 2 );
+    }
+}
+
+std::string Renderer::assetPath(const char* name) const {
+    return _assetDir + "metal-playground-" + name + ".asset";
+}
+
+void Renderer::loadTexture(int index) {
+    const std::string path = assetPath( ( "mandelbrot" + std::to_string( _nextAsset ) ).c_str() );
+    _nextAsset = ( _nextAsset + 1 ) % kTextureAssets;
+
+    _loadBegin = std::chrono::steady_clock::now();
+    _textureReady = _streamer->loadTexture( path.c_str(), _textures[ index ], kTextureWidth, kTextureHeight, kTextureWidth * 4 );
+    _textureLoading = true;
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        pInstanceData[ i ].instanceTransform = fullObjectRot * translate * yrot * zrot * scale;
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( pInstanceData[ i ].instanceTransform );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+    }
+
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+            float2 texcoord;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = float4( vd.position, 1.0 );
+            pos = instanceData[ instanceId ].instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+
+            float3 normal = instanceData[ instanceId ].instanceNormalTransform * vd.normal;
+            normal = cameraData.worldNormalTransform * normal;
+            o.normal = normal;
+
+            o.texcoord = vd.texcoord.xy;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]], texture2d< half, access::sample > tex [[texture(0)]] )
+        {
+            constexpr sampler s( address::repeat, filter::linear );
+            half3 texel = tex.sample( s, in.texcoord ).rgb;
+
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            half3 illum = (in.color * texel * 0.1) + (in.color * texel * ndotl);
+            return half4( illum, 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+    _shaderLibrary = library;
+}
+
+void Renderer::buildAssets() {
+    auto bake = [this]( const char* name, const void* data, size_t size ) {
+        if ( !_streamer->writeAsset( assetPath( name ).c_str(), data, size ) )
+        {
+            __builtin_printf( "cannot write %s\n", assetPath( name ).c_str() );
+            assert( false );
+        }
+    };
+
+    using simd::float2;
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //                                         Texture
+        //   Positions           Normals         Coordinates
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 0.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 0.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 0.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f }, { 0.f, 0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    static_assert( sizeof( verts ) / sizeof( verts[0] ) == kCubeVertexCount );
+    static_assert( sizeof( indices ) / sizeof( indices[0] ) == kCubeIndexCount );
+
+    bake( "cube-vertices", verts, sizeof( verts ) );
+    bake( "cube-indices", indices, sizeof( indices ) );
+
+    // zooms into the same spot of the mandelbrot set, one texture each
+    JobSystem jobs;
+    std::vector<uint8_t> pixels( (size_t)kTextureWidth * kTextureHeight * 4 );
+    float zoom = 1.f;
+    for ( size_t i = 0; i < kTextureAssets; ++i, zoom *= 6.f )
+    {
+        jobs.parallelFor( kTextureHeight, 16, [&]( size_t begin, size_t end ) {
+            uint8_t* out = pixels.data() + begin * kTextureWidth * 4;
+            for ( size_t row = begin; row < end; ++row )
+            {
+                for ( uint32_t col = 0; col < kTextureWidth; ++col )
+                {
+                    float x0 = ( 2.f * col / kTextureWidth - 1.f ) / zoom - 0.7436f;
+                    float y0 = ( 2.f * row / kTextureHeight - 1.f ) / zoom + 0.1318f;
+
+                    float x = 0.f;
+                    float y = 0.f;
+                    uint32_t iteration = 0;
+                    while ( x * x + y * y <= 4.f && iteration < kMaxIterations )
+                    {
+                        float xtmp = x * x - y * y + x0;
+                        y = 2.f * x * y + y0;
+                        x = xtmp;
+                        ++iteration;
+                    }
+
+                    const uint8_t c = (uint8_t)( 255.f * ( 0.5f + 0.5f * cosf( 3.f + iteration * 0.15f ) ) );
+                    out[0] = c;
+                    out[1] = c;
+                    out[2] = c;
+                    out[3] = 255;
+                    out += 4;
+                }
+            }
+        } );
+
+        bake( ( "mandelbrot" + std::to_string( i ) ).c_str(), pixels.data(), pixels.size() );
+    }
+}
+
+void Renderer::buildBuffers() {
+    const size_t vertexDataSize = kCubeVertexCount * sizeof( shader_types::VertexData );
+    const size_t indexDataSize = kCubeIndexCount * sizeof( uint16_t );
+
+    _vertexDataBuffer = _device->newBuffer( vertexDataSize, MTL::ResourceStorageModePrivate );
+    _indexBuffer = _device->newBuffer( indexDataSize, MTL::ResourceStorageModePrivate );
+
+    _vertexReady = _streamer->loadBuffer( assetPath( "cube-vertices" ).c_str(), _vertexDataBuffer, 0, vertexDataSize );
+    _indexReady = _streamer->loadBuffer( assetPath( "cube-indices" ).c_str(), _indexBuffer, 0, indexDataSize );
+    _geometryLoading = true;
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+    }
+
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::buildTextures() {
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    pTextureDesc->setWidth( 1 );
+    pTextureDesc->setHeight( 1 );
+    pTextureDesc->setPixelFormat( MTL::PixelFormatRGBA8Unorm );
+    pTextureDesc->setTextureType( MTL::TextureType2D );
+    pTextureDesc->setStorageMode( MTL::StorageModeManaged );
+    pTextureDesc->setUsage( MTL::ResourceUsageSample | MTL::ResourceUsageRead );
+
+    // shown until the first load lands
+    const uint8_t white[4] = { 255, 255, 255, 255 };
+    _placeholder = _device->newTexture( pTextureDesc );
+    _placeholder->replaceRegion( MTL::Region::Make2D( 0, 0, 1, 1 ), 0, white, sizeof( white ) );
+
+    pTextureDesc->setWidth( kTextureWidth );
+    pTextureDesc->setHeight( kTextureHeight );
+    pTextureDesc->setStorageMode( MTL::StorageModePrivate );
+
+    _textures[0] = _device->newTexture( pTextureDesc );
+    _textures[1] = _device->newTexture( pTextureDesc );
+
+    pTextureDesc->release();
+
+    loadTexture( 0 );
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
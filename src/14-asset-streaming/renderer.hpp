@@ -0,0 +1,86 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include <chrono>
+#include <future>
+#include <string>
+
+#include "asset_streamer.hpp"
+#include "shader_types.hpp"
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _PSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+
+    // the sampled texture is swapped for the other one once its load lands
+    MTL::Texture* _placeholder;
+    MTL::Texture* _textures[2];
+    int _displayed;
+    uint64_t _swapFrame;
+
+    AssetStreamer* _streamer;
+    std::string _assetDir;
+    size_t _nextAsset;
+    std::future<bool> _vertexReady;
+    std::future<bool> _indexReady;
+    bool _geometryLoading;
+    std::future<bool> _textureReady;
+    bool _textureLoading;
+    std::chrono::steady_clock::time_point _loadBegin;
+
+    double _loadSeconds;
+    uint64_t _loadBytes;
+    double _frameSeconds;
+    double _worstFrameSeconds;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    std::string assetPath(const char* name) const;
+    void loadTexture(int index);
+    void pollLoads();
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildAssets();
+    void buildBuffers();
+    void buildTextures();
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,461 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr uint32_t kTextureWidth = 4096;
+static constexpr uint32_t kTextureHeight = 4096;
+static constexpr uint32_t kMaxIterations = 96;
+// small entries squeeze hard, the texture is stored so it can be used from the mapping
+static constexpr int kPackLevel = 9;
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince( Clock::time_point begin )
+{
+    return std::chrono::duration<double>( Clock::now() - begin ).count();
+}
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _angle(0.f)
+, _frame(0) {
+
+    const char* tmp = getenv( "TMPDIR" );
+    std::string path = tmp ? tmp : "/tmp/";
+    if ( path.back() != '/' )
+    {
+        path += '/';
+    }
+    path += "metal-playground.pack";
+
+    buildPack( path );
+    if ( !_pack.open( path.c_str() ) )
+    {
+        __builtin_printf( "cannot open %s\n", path.c_str() );
+        assert( false );
+    }
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+    buildTextures();
+
+    // everything was copied out, the mapping can go
+    _pack.close();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[i]->release();
+    }
+    _indexBuffer->release();
+    _texture->release();
+    _PSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+
+    enc->setRenderPipelineState(_PSO);
+    enc->setDepthStencilState( _depthStencilState );
+
+    enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+    enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+
+    enc->setFragmentTexture( _texture, /* index */ 0 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                _indexCount, MTL::IndexType::IndexTypeUInt16,
+                                _indexBuffer,
+                                0,
+                                kNumInstances );
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+}
+
+uint32_t Renderer::findEntry(const char* name) const {
+    const int index = _pack.find( name );
+    if ( index < 0 )
+    {
+        __builtin_printf( "%s is not in the pack\n", name );
+        assert( false );
+    }
+    return (uint32_t)index;
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        pInstanceData[ i ].instanceTransform = fullObjectRot * translate * yrot * zrot * scale;
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( pInstanceData[ i ].instanceTransform );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+    }
+
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+}
+
+void Renderer::buildPack(const std::string& path) {
+    // stands in for an offline packer, the rest of the renderer only sees the pack
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+            float2 texcoord;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = float4( vd.position, 1.0 );
+            pos = instanceData[ instanceId ].instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+
+            float3 normal = instanceData[ instanceId ].instanceNormalTransform * vd.normal;
+            normal = cameraData.worldNormalTransform * normal;
+            o.normal = normal;
+
+            o.texcoord = vd.texcoord.xy;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]], texture2d< half, access::sample > tex [[texture(0)]] )
+        {
+            constexpr sampler s( address::repeat, filter::linear );
+            half3 texel = tex.sample( s, in.texcoord ).rgb;
+
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            half3 illum = (in.color * texel * 0.1) + (in.color * texel * ndotl);
+            return half4( illum, 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    using simd::float2;
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //                                         Texture
+        //   Positions           Normals         Coordinates
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 0.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 0.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 0.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f }, { 0.f, 0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    std::vector<uint8_t> pixels( (size_t)kTextureWidth * kTextureHeight * 4 );
+    _jobs.parallelFor( kTextureHeight, 16, [&]( size_t begin, size_t end ) {
+        uint8_t* out = pixels.data() + begin * kTextureWidth * 4;
+        for ( size_t row = begin; row < end; ++row )
+        {
+            for ( uint32_t col = 0; col < kTextureWidth; ++col )
+            {
+                float x0 = ( 2.f * col / kTextureWidth - 1.f ) - 0.7436f;
+                float y0 = ( 2.f * row / kTextureHeight - 1.f ) + 0.1318f;
+
+                float x = 0.f;
+                float y = 0.f;
+                uint32_t iteration = 0;
+                while ( x * x + y * y <= 4.f && iteration < kMaxIterations )
+                {
+                    float xtmp = x * x - y * y + x0;
+                    y = 2.f * x * y + y0;
+                    x = xtmp;
+                    ++iteration;
+                }
+
+                const uint8_t c = (uint8_t)( 255.f * ( 0.5f + 0.5f * cosf( 3.f + iteration * 0.15f ) ) );
+                out[0] = c;
+                out[1] = c;
+                out[2] = c;
+                out[3] = 255;
+                out += 4;
+            }
+        }
+    } );
+
+    PackWriter writer( _jobs );
+    writer.add( "shaders/cube.metal", shaderSrc.data(), shaderSrc.size(), kPackLevel );
+    writer.add( "meshes/cube.vertices", verts, sizeof( verts ), kPackLevel );
+    writer.add( "meshes/cube.indices", indices, sizeof( indices ), kPackLevel );
+    writer.add( "textures/mandelbrot.rgba", pixels.data(), pixels.size(), 0 );
+
+    Clock::time_point begin = Clock::now();
+    if ( !writer.write( path.c_str() ) )
+    {
+        __builtin_printf( "cannot write %s\n", path.c_str() );
+        assert( false );
+    }
+    __builtin_printf( "packed %zu bytes in %.1f ms on %zu threads\n",
+                      sizeof( verts ) + sizeof( indices ) + shaderSrc.size() + pixels.size(),
+                      secondsSince( begin ) * 1e3, _jobs.threadCount() );
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const uint32_t entry = findEntry( "shaders/cube.metal" );
+    std::string shaderSrc( _pack.entry( entry ).size, '\0' );
+    if ( !_pack.read( _jobs, entry, shaderSrc.data() ) )
+    {
+        __builtin_printf( "shaders/cube.metal is corrupt\n" );
+        assert( false );
+    }
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+    _shaderLibrary = library;
+}
+
+void Renderer::buildBuffers() {
+    const uint32_t vertexEntry = findEntry( "meshes/cube.vertices" );
+    const uint32_t indexEntry = findEntry( "meshes/cube.indices" );
+    const size_t vertexDataSize = _pack.entry( vertexEntry ).size;
+    const size_t indexDataSize = _pack.entry( indexEntry ).size;
+    _indexCount = (uint32_t)( indexDataSize / sizeof( uint16_t ) );
+
+    _vertexDataBuffer = _device->newBuffer( vertexDataSize, MTL::ResourceStorageModeShared );
+    _indexBuffer = _device->newBuffer( indexDataSize, MTL::ResourceStorageModeShared );
+
+    // decompressed straight into the buffers, both in one parallel read
+    const PackReader::Read reads[] = {
+        { vertexEntry, _vertexDataBuffer->contents() },
+        { indexEntry, _indexBuffer->contents() },
+    };
+    Clock::time_point begin = Clock::now();
+    if ( !_pack.read( _jobs, reads, 2 ) )
+    {
+        __builtin_printf( "cube meshes are corrupt\n" );
+        assert( false );
+    }
+    __builtin_printf( "unpacked %zu bytes of geometry in %.3f ms\n", vertexDataSize + indexDataSize, secondsSince( begin ) * 1e3 );
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+    }
+
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::buildTextures() {
+    const uint32_t entry = findEntry( "textures/mandelbrot.rgba" );
+    const void* pixels = _pack.mapped( entry );
+    const size_t size = _pack.entry( entry ).size;
+    assert( pixels && size == (size_t)kTextureWidth * kTextureHeight * 4 );
+
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    pTextureDesc->setWidth( kTextureWidth );
+    pTextureDesc->setHeight( kTextureHeight );
+    pTextureDesc->setPixelFormat( MTL::PixelFormatRGBA8Unorm );
+    pTextureDesc->setTextureType( MTL::TextureType2D );
+    pTextureDesc->setStorageMode( MTL::StorageModePrivate );
+    pTextureDesc->setUsage( MTL::ResourceUsageSample | MTL::ResourceUsageRead );
+
+    _texture = _device->newTexture( pTextureDesc );
+    pTextureDesc->release();
+
+    // the stored entry sits page aligned in the mapping, wrap it and blit from the
+    // file pages, the mapping has to outlive the copy
+    Clock::time_point begin = Clock::now();
+    MTL::Buffer* source = _device->newBuffer( pixels, size, MTL::ResourceStorageModeShared, nullptr );
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    MTL::BlitCommandEncoder* blit = cmd->blitCommandEncoder();
+    blit->copyFromBuffer( source, 0, kTextureWidth * 4, size, MTL::Size( kTextureWidth, kTextureHeight, 1 ),
+                          _texture, 0, 0, MTL::Origin( 0, 0, 0 ) );
+    blit->endEncoding();
+    cmd->commit();
+    cmd->waitUntilCompleted();
+
+    source->release();
+    __builtin_printf( "texture from the mapping in %.1f ms\n", secondsSince( begin ) * 1e3 );
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
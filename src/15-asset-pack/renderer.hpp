@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include <string>
+
+#include "job_system.hpp"
+#include "pack_file.hpp"
+#include "shader_types.hpp"
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _PSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+    MTL::Texture* _texture;
+    uint32_t _indexCount;
+
+    JobSystem _jobs;
+    PackReader _pack;
+
+    float _angle;
+    int _frame;
+    dispatch_semaphore_t _semaphore;
+
+    uint32_t findEntry(const char* name) const;
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildPack(const std::string& path);
+    void buildShaders();
+    void buildBuffers();
+    void buildTextures();
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,491 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr uint32_t kBufferCapacity = 256;
+static constexpr uint32_t kTextureCapacity = 256;
+static constexpr uint32_t kTextureSize = 256;
+static constexpr uint64_t kChurnInterval = 30;
+static constexpr uint64_t kStatsInterval = 300;
+
+static void releaseHeapResource( void* heap, uint64_t handle ) {
+    static_cast<HeapAllocator*>( heap )->release( (HeapAllocator::Handle)handle );
+}
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _heap(device, MTL::StorageModePrivate)
+, _uploader(device)
+, _table(device, kBufferCapacity, kTextureCapacity)
+, _generation(0)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    if ( !_device->supportsFamily( MTL::GPUFamilyMetal3 ) )
+    {
+        __builtin_printf( "the bindless table needs a metal 3 gpu\n" );
+        assert( false );
+    }
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+    buildTextures();
+
+    // everything the first frame samples is in place before it is encoded
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    _uploader.flush( cmd );
+    cmd->commit();
+    cmd->waitUntilCompleted();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    // frames in flight still read the table and the heap resources
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        dispatch_semaphore_wait( _semaphore, DISPATCH_TIME_FOREVER );
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        dispatch_semaphore_signal( _semaphore );
+    }
+    _deletions.flush();
+    for ( size_t i = 0; i < kTextureCount; ++i )
+    {
+        _heap.release( _textures[ i ] );
+    }
+    for ( size_t i = 0; i < kMaterialCount; ++i )
+    {
+        _heap.release( _materials[ i ] );
+    }
+    _heap.release( _vertexData );
+    _heap.release( _indexData );
+
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[i]->release();
+    }
+    _PSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    ++_frameCount;
+    _deletions.collect();
+
+    // swap a material and a texture for new ones now and then, the old resources and
+    // slots are reused once the frames that could still read them are done
+    if ( _frameCount % kChurnInterval == 0 )
+    {
+        replaceMaterial( _generation % kMaterialCount );
+        replaceTexture( _generation % kTextureCount );
+    }
+    _uploader.flush( cmd );
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+
+    enc->setRenderPipelineState(_PSO);
+    enc->setDepthStencilState( _depthStencilState );
+
+    // one call makes every mesh, material and texture resident
+    _heap.useHeaps( enc, MTL::RenderStageVertex | MTL::RenderStageFragment );
+    _table.bind( enc, /* index */ 0 );
+
+    enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+    enc->setVertexBytes( &_vertexSlot, sizeof( _vertexSlot ), /* index */ 3 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                _heap.buffer( _indexData ),
+                                0,
+                                kNumInstances );
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    _table.commit( cmd );
+    commitFrame( _deletions, cmd );
+    cmd->commit();
+
+    pool->release();
+
+    if ( _frameCount % kStatsInterval == 0 )
+    {
+        HeapAllocatorStats s = _heap.stats();
+        __builtin_printf( "table: %zu buffers, %zu textures live, %zu replaced, %zu awaiting release | %zu heaps resident through one useHeaps, %zu resources\n",
+                          _table.liveBuffers(), _table.liveTextures(), (size_t)_generation, _deletions.pendingCount(),
+                          s.heapCount, s.allocationCount );
+    }
+}
+
+HeapAllocator::Handle Renderer::newPatternTexture(uint32_t seed) {
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    pTextureDesc->setWidth( kTextureSize );
+    pTextureDesc->setHeight( kTextureSize );
+    pTextureDesc->setPixelFormat( MTL::PixelFormatRGBA8Unorm );
+    pTextureDesc->setTextureType( MTL::TextureType2D );
+    pTextureDesc->setUsage( MTL::ResourceUsageSample | MTL::ResourceUsageRead );
+
+    HeapAllocator::Handle handle = _heap.newTexture( pTextureDesc );
+    pTextureDesc->release();
+    assert( handle != HeapAllocator::kInvalidHandle );
+
+    // checkers of a size and colour that depend on the seed
+    const uint32_t cell = 8u << ( seed % 4 );
+    const uint8_t r = (uint8_t)( 96 + ( seed * 53 ) % 160 );
+    const uint8_t g = (uint8_t)( 96 + ( seed * 97 ) % 160 );
+    const uint8_t b = (uint8_t)( 96 + ( seed * 31 ) % 160 );
+
+    std::vector<uint8_t> pixels( kTextureSize * kTextureSize * 4 );
+    for ( uint32_t y = 0; y < kTextureSize; ++y )
+    {
+        for ( uint32_t x = 0; x < kTextureSize; ++x )
+        {
+            const bool dark = ( ( x / cell ) + ( y / cell ) ) % 2 == 0;
+            uint8_t* p = &pixels[ ( y * kTextureSize + x ) * 4 ];
+            p[0] = dark ? r / 3 : r;
+            p[1] = dark ? g / 3 : g;
+            p[2] = dark ? b / 3 : b;
+            p[3] = 255;
+        }
+    }
+
+    _uploader.uploadTexture( _heap.texture( handle ), MTL::Region::Make2D( 0, 0, kTextureSize, kTextureSize ), 0,
+                             pixels.data(), kTextureSize * 4 );
+    return handle;
+}
+
+void Renderer::replaceTexture(size_t index) {
+    // the upload is flushed ahead of this frame's draws into the same command buffer
+    HeapAllocator::Handle handle = newPatternTexture( (uint32_t)( kTextureCount + _generation ) );
+    const uint32_t slot = _table.addTexture( _heap.texture( handle ) );
+    assert( slot != SlotAllocator::kInvalidSlot );
+
+    _table.removeTexture( _textureSlots[ index ] );
+    _deletions.defer( releaseHeapResource, &_heap, _textures[ index ] );
+
+    _textures[ index ] = handle;
+    _textureSlots[ index ] = slot;
+    ++_generation;
+}
+
+HeapAllocator::Handle Renderer::newMaterial(float t) {
+    const shader_types::Material material = { { t, 1.f - t, 0.5f + 0.5f * sinf( (float)M_PI * 2.f * t ), 1.f } };
+
+    HeapAllocator::Handle handle = _heap.newBuffer( sizeof( material ) );
+    assert( handle != HeapAllocator::kInvalidHandle );
+    _uploader.uploadBuffer( _heap.buffer( handle ), 0, &material, sizeof( material ) );
+    return handle;
+}
+
+void Renderer::replaceMaterial(size_t index) {
+    // a new buffer rather than writing the old one, frames in flight still read it
+    const float t = ( index + 0.5f * ( _generation / kMaterialCount % 2 ) ) / (float)kMaterialCount;
+    HeapAllocator::Handle handle = newMaterial( t );
+    const uint32_t slot = _table.addBuffer( _heap.buffer( handle ) );
+    assert( slot != SlotAllocator::kInvalidSlot );
+
+    _table.removeBuffer( _materialSlots[ index ] );
+    _deletions.defer( releaseHeapResource, &_heap, _materials[ index ] );
+
+    _materials[ index ] = handle;
+    _materialSlots[ index ] = slot;
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        pInstanceData[ i ].instanceTransform = fullObjectRot * translate * yrot * zrot * scale;
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( pInstanceData[ i ].instanceTransform );
+
+        pInstanceData[ i ].textureSlot = _textureSlots[ i % kTextureCount ];
+        pInstanceData[ i ].materialSlot = _materialSlots[ i % kMaterialCount ];
+    }
+
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        // BindlessLayout
+        struct BindlessTable
+        {
+            device const uchar* buffers[ BINDLESS_BUFFERS ];
+            texture2d< half, access::sample > textures[ BINDLESS_TEXTURES ];
+        };
+
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+            float2 texcoord;
+            uint textureSlot [[flat]];
+        };
+
+        v2f vertex vertexMain( device const BindlessTable& table [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               constant uint& vertexSlot [[buffer(3)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            device const VertexData* vertexData = (device const VertexData*)table.buffers[ vertexSlot ];
+            const device InstanceData& instance = instanceData[ instanceId ];
+            device const Material* material = (device const Material*)table.buffers[ instance.materialSlot ];
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = float4( float3( vd.position ), 1.0 );
+            pos = instance.instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+
+            float3 normal = instance.instanceNormalTransform * float3( vd.normal );
+            normal = cameraData.worldNormalTransform * normal;
+            o.normal = normal;
+
+            o.texcoord = vd.texcoord.xy;
+            o.textureSlot = instance.textureSlot;
+
+            o.color = half3( material->tint.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]], device const BindlessTable& table [[buffer(0)]] )
+        {
+            constexpr sampler s( address::repeat, filter::linear );
+            half3 texel = table.textures[ in.textureSlot ].sample( s, in.texcoord ).rgb;
+
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            half3 illum = (in.color * texel * 0.1) + (in.color * texel * ndotl);
+            return half4( illum, 1.0 );
+        }
+    )";
+
+    // the table capacities are array sizes on the shader side, the structs come
+    // from the same field lists as the host ones
+    char defines[ 128 ];
+    snprintf( defines, sizeof( defines ), "#define BINDLESS_BUFFERS %u\n#define BINDLESS_TEXTURES %u\n",
+              _table.layout().bufferCapacity, _table.layout().textureCapacity );
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + defines
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kMaterialSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+    _shaderLibrary = library;
+}
+
+void Renderer::buildBuffers() {
+    using simd::float2;
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //                                         Texture
+        //   Positions           Normals         Coordinates
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 0.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 0.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 0.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f }, { 0.f, 0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    const size_t vertexDataSize = sizeof( verts );
+    const size_t indexDataSize = sizeof( indices );
+
+    _vertexData = _heap.newBuffer( vertexDataSize );
+    _indexData = _heap.newBuffer( indexDataSize );
+    _uploader.uploadBuffer( _heap.buffer( _vertexData ), 0, verts, vertexDataSize );
+    _uploader.uploadBuffer( _heap.buffer( _indexData ), 0, indices, indexDataSize );
+
+    // the index buffer is bound for the draw, only the vertices go through the table
+    _vertexSlot = _table.addBuffer( _heap.buffer( _vertexData ) );
+
+    for ( size_t i = 0; i < kMaterialCount; ++i )
+    {
+        _materials[ i ] = newMaterial( i / (float)kMaterialCount );
+        _materialSlots[ i ] = _table.addBuffer( _heap.buffer( _materials[ i ] ) );
+    }
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+    }
+
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::buildTextures() {
+    for ( size_t i = 0; i < kTextureCount; ++i )
+    {
+        _textures[ i ] = newPatternTexture( (uint32_t)i );
+        _textureSlots[ i ] = _table.addTexture( _heap.texture( _textures[ i ] ) );
+    }
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
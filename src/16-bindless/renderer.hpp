@@ -0,0 +1,81 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include "bindless_table.hpp"
+#include "metal_deletion.hpp"
+#include "heap_allocator.hpp"
+#include "shader_types.hpp"
+#include "staging_uploader.hpp"
+
+class Renderer {
+private:
+    static constexpr size_t kTextureCount = 64;
+    static constexpr size_t kMaterialCount = 16;
+
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _PSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    HeapAllocator _heap;
+    StagingUploader _uploader;
+    BindlessTable _table;
+
+    HeapAllocator::Handle _vertexData;
+    HeapAllocator::Handle _indexData;
+    uint32_t _vertexSlot;
+
+    HeapAllocator::Handle _materials[kMaterialCount];
+    uint32_t _materialSlots[kMaterialCount];
+    HeapAllocator::Handle _textures[kTextureCount];
+    uint32_t _textureSlots[kTextureCount];
+    // heap resources removed from the table, released once no frame reads them
+    DeletionQueue _deletions;
+    uint32_t _generation;
+
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    HeapAllocator::Handle newPatternTexture(uint32_t seed);
+    HeapAllocator::Handle newMaterial(float t);
+    void replaceTexture(size_t index);
+    void replaceMaterial(size_t index);
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildTextures();
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,50 @@
+/**
+  ******************************************************************************
+  * @file           : shader_types.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SHADER_TYPES_HPP
+#define METAL_PLAYGROUND_SHADER_TYPES_HPP
+
+#include "shader_struct.hpp"
+
+namespace shader_types
+{
+    // packed vertices, 32 bytes instead of the 48 two float3 would take
+#define VERTEX_DATA_FIELDS( F )                 \
+    F( packed_float3, position )                \
+    F( packed_float3, normal )                  \
+    F( float2, texcoord )
+
+    // which table slots the instance samples and tints with
+#define INSTANCE_DATA_FIELDS( F )               \
+    F( float4x4, instanceTransform )            \
+    F( float3x3, instanceNormalTransform )      \
+    F( uint, textureSlot )                      \
+    F( uint, materialSlot )
+
+#define MATERIAL_FIELDS( F )                    \
+    F( float4, tint )
+
+#define CAMERA_DATA_FIELDS( F )                 \
+    F( float4x4, perspectiveTransform )         \
+    F( float4x4, worldTransform )               \
+    F( float3x3, worldNormalTransform )
+
+    SHADER_STRUCT( VertexData, VERTEX_DATA_FIELDS );
+    SHADER_STRUCT( InstanceData, INSTANCE_DATA_FIELDS );
+    SHADER_STRUCT( Material, MATERIAL_FIELDS );
+    SHADER_STRUCT( CameraData, CAMERA_DATA_FIELDS );
+
+    static_assert( sizeof( VertexData ) == 32 );
+}
+
+
+#endif //METAL_PLAYGROUND_SHADER_TYPES_HPP
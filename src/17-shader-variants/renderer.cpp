@@ -0,0 +1,393 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <string>
+#include <vector>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr uint32_t kTextureSize = 256;
+static constexpr uint64_t kMaterialSwapFrame = 600;
+static constexpr uint64_t kStatsInterval = 300;
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+    buildTextures();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    _variants.reset();
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[i]->release();
+    }
+    _indexBuffer->release();
+    _texture->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    ++_frameCount;
+
+    // a combination nobody asked for at load time, compiled the first time it is drawn
+    if ( _frameCount == kMaterialSwapFrame )
+    {
+        _materials[ 2 ] = _tinted;
+    }
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+
+    enc->setDepthStencilState( _depthStencilState );
+
+    enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+    enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+    enc->setFragmentTexture( _texture, /* index */ 0 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    // the instances are split evenly between the materials, one draw each
+    const size_t instancesPerMaterial = kNumInstances / kMaterialCount;
+    for ( size_t m = 0; m < kMaterialCount; ++m )
+    {
+        MTL::RenderPipelineState* pso = _variants->get( _materials[ m ] );
+        if ( !pso )
+        {
+            continue;
+        }
+        enc->setRenderPipelineState( pso );
+        enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                    6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                    _indexBuffer,
+                                    0,
+                                    instancesPerMaterial,
+                                    0,
+                                    m * instancesPerMaterial );
+    }
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+
+    if ( _frameCount % kStatsInterval == 0 )
+    {
+        __builtin_printf( "variants: %zu compiled of %zu valid (%zu possible), %zu hits, %.1f ms compiling\n",
+                          _variants->compiledCount(), _permutations.enumerate().size(),
+                          (size_t)1 << _permutations.featureCount(),
+                          _variants->hits(), _variants->compileSeconds() * 1e3 );
+    }
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        pInstanceData[ i ].instanceTransform = fullObjectRot * translate * yrot * zrot * scale;
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( pInstanceData[ i ].instanceTransform );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+    }
+
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( 45.f * M_PI / 180.f, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    // feature bits are handed out in order, they have to match the constant indices below
+    _textured = _permutations.addFeature( "TEXTURED" );
+    _lit = _permutations.addFeature( "LIT" );
+    _tinted = _permutations.addFeature( "TINTED" );
+    _showNormals = _permutations.addFeature( "SHOW_NORMALS" );
+    _permutations.exclude( _showNormals, _textured | _lit | _tinted );
+
+    const char* shaderBody = R"(
+        constant bool kTextured [[function_constant(0)]];
+        constant bool kLit [[function_constant(1)]];
+        constant bool kTinted [[function_constant(2)]];
+        constant bool kShowNormals [[function_constant(3)]];
+
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+            float2 texcoord;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = float4( vd.position, 1.0 );
+            pos = instanceData[ instanceId ].instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+
+            float3 normal = instanceData[ instanceId ].instanceNormalTransform * vd.normal;
+            normal = cameraData.worldNormalTransform * normal;
+            o.normal = normal;
+
+            o.texcoord = vd.texcoord.xy;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        // the texture only exists in variants that sample it
+        half4 fragment fragmentMain( v2f in [[stage_in]],
+                                     texture2d< half, access::sample > tex [[texture(0), function_constant(kTextured)]] )
+        {
+            half3 c = half3( 1.0 );
+            if ( kTinted )
+            {
+                c *= in.color;
+            }
+            if ( kTextured )
+            {
+                constexpr sampler s( address::repeat, filter::linear );
+                c *= tex.sample( s, in.texcoord ).rgb;
+            }
+            if ( kLit )
+            {
+                // assume light coming from (front-top-right)
+                float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+                float3 n = normalize( in.normal );
+
+                half ndotl = half( saturate( dot( n, l ) ) );
+                c = (c * 0.1) + (c * ndotl);
+            }
+            if ( kShowNormals )
+            {
+                c = half3( normalize( in.normal ) * 0.5 + 0.5 );
+            }
+            return half4( c, 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+    _shaderLibrary = library;
+
+    const ShaderProgramDesc program = { "vertexMain", "fragmentMain",
+                                        MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB,
+                                        MTL::PixelFormat::PixelFormatDepth16Unorm };
+    _variants = std::make_unique<ShaderVariants>( _device, library, _permutations, program );
+
+    _materials[ 0 ] = _textured | _lit | _tinted;
+    _materials[ 1 ] = _lit | _tinted;
+    _materials[ 2 ] = _textured;
+    _materials[ 3 ] = _textured | _lit | _tinted;
+
+    // only what the materials use is compiled at load, SHOW_NORMALS never is
+    const size_t compiled = _variants->prewarm( _materials, kMaterialCount );
+    __builtin_printf( "prewarmed %zu of %zu valid variants in %.1f ms\n",
+                      compiled, _permutations.enumerate().size(), _variants->compileSeconds() * 1e3 );
+}
+
+void Renderer::buildBuffers() {
+    using simd::float2;
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //                                         Texture
+        //   Positions           Normals         Coordinates
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f }, { 1.f, 0.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f }, { 0.f, 0.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f }, { 1.f, 0.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 1.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 1.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f }, { 0.f, 0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f }, { 0.f, 1.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f }, { 1.f, 1.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f }, { 1.f, 0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f }, { 0.f, 0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    const size_t vertexDataSize = sizeof( verts );
+    const size_t indexDataSize = sizeof( indices );
+
+    _vertexDataBuffer = _device->newBuffer( verts, vertexDataSize, MTL::ResourceStorageModeShared );
+    _indexBuffer = _device->newBuffer( indices, indexDataSize, MTL::ResourceStorageModeShared );
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+    }
+
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::buildTextures() {
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    pTextureDesc->setWidth( kTextureSize );
+    pTextureDesc->setHeight( kTextureSize );
+    pTextureDesc->setPixelFormat( MTL::PixelFormatRGBA8Unorm );
+    pTextureDesc->setTextureType( MTL::TextureType2D );
+    pTextureDesc->setStorageMode( MTL::StorageModeManaged );
+    pTextureDesc->setUsage( MTL::ResourceUsageSample | MTL::ResourceUsageRead );
+
+    _texture = _device->newTexture( pTextureDesc );
+    pTextureDesc->release();
+
+    std::vector<uint8_t> pixels( kTextureSize * kTextureSize * 4 );
+    for ( uint32_t y = 0; y < kTextureSize; ++y )
+    {
+        for ( uint32_t x = 0; x < kTextureSize; ++x )
+        {
+            const uint8_t c = ( ( x / 32 ) + ( y / 32 ) ) % 2 ? 0xFF : 0x60;
+            uint8_t* p = &pixels[ ( y * kTextureSize + x ) * 4 ];
+            p[0] = c;
+            p[1] = c;
+            p[2] = c;
+            p[3] = 0xFF;
+        }
+    }
+    _texture->replaceRegion( MTL::Region::Make2D( 0, 0, kTextureSize, kTextureSize ), 0, pixels.data(), kTextureSize * 4 );
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
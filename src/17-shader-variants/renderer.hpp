@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include <memory>
+
+#include "shader_permutations.hpp"
+#include "shader_struct.hpp"
+#include "shader_variants.hpp"
+
+namespace shader_types
+{
+#define VERTEX_DATA_FIELDS( F )                 \
+    F( float3, position )                       \
+    F( float3, normal )                         \
+    F( float2, texcoord )
+
+#define INSTANCE_DATA_FIELDS( F )               \
+    F( float4x4, instanceTransform )            \
+    F( float3x3, instanceNormalTransform )      \
+    F( float4, instanceColor )
+
+#define CAMERA_DATA_FIELDS( F )                 \
+    F( float4x4, perspectiveTransform )         \
+    F( float4x4, worldTransform )               \
+    F( float3x3, worldNormalTransform )
+
+    SHADER_STRUCT( VertexData, VERTEX_DATA_FIELDS );
+    SHADER_STRUCT( InstanceData, INSTANCE_DATA_FIELDS );
+    SHADER_STRUCT( CameraData, CAMERA_DATA_FIELDS );
+}
+
+class Renderer {
+private:
+    static constexpr size_t kMaterialCount = 4;
+
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::DepthStencilState* _depthStencilState;
+
+    // one program, the materials pick their variant by feature bits
+    PermutationSpace _permutations;
+    ShaderFeatures _textured;
+    ShaderFeatures _lit;
+    ShaderFeatures _tinted;
+    ShaderFeatures _showNormals;
+    std::unique_ptr<ShaderVariants> _variants;
+    ShaderFeatures _materials[kMaterialCount];
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+    MTL::Texture* _texture;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+
+public:
+    explicit Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildTextures();
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,184 @@
+/**
+  ******************************************************************************
+  * @file           : main.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+#if defined( __APPLE__ )
+#define NS_PRIVATE_IMPLEMENTATION
+#define MTL_PRIVATE_IMPLEMENTATION
+#define MTK_PRIVATE_IMPLEMENTATION
+#define CA_PRIVATE_IMPLEMENTATION
+
+#include "renderer.hpp"
+#endif
+
+#include "alloc_counter.hpp"
+#include "frame_sequencer.hpp"
+#include "soft_renderer.hpp"
+
+// one frame on the gpu, one being encoded and one being handed back
+static constexpr uint32_t kReadbackSlots = 3;
+// every slot and file buffer has been through once, the pipelines are compiled
+static constexpr uint64_t kWarmupFrames = 8;
+
+template <typename _Renderer>
+static void renderFrames( _Renderer& renderer, FrameSequencer& sequencer, uint64_t frames, FrameAllocationCheck* check )
+{
+    for ( uint64_t i = 0; i < frames; ++i )
+    {
+        if ( check )
+        {
+            check->beginFrame();
+        }
+        renderer.draw( sequencer );
+        if ( check )
+        {
+            check->endFrame();
+        }
+    }
+}
+
+// no window, no NS::Application: renders a fixed number of frames and writes them out.
+// --check-allocs fails the run when a frame after the warm up touches the heap. builds
+// without metal always render on the cpu.
+//
+//   18-headless [--frames N] [--size WxH] [--raw] [--cpu] [--out path] [--check-allocs]
+int main( int argc, char* argv[] )
+{
+
+    std::cout << "headless" << std::endl;
+
+    uint64_t frames = 120;
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    FrameFileFormat format = FrameFileFormat::Png;
+    bool cpu = false;
+    bool checkAllocations = false;
+    const char* out = nullptr;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( !strcmp( argv[ i ], "--frames" ) && i + 1 < argc )
+        {
+            frames = strtoull( argv[ ++i ], nullptr, 10 );
+        }
+        else if ( !strcmp( argv[ i ], "--size" ) && i + 1 < argc )
+        {
+            if ( sscanf( argv[ ++i ], "%ux%u", &width, &height ) != 2 || width == 0 || height == 0 )
+            {
+                __builtin_printf( "bad size %s\n", argv[ i ] );
+                return 1;
+            }
+        }
+        else if ( !strcmp( argv[ i ], "--raw" ) )
+        {
+            format = FrameFileFormat::Raw;
+        }
+        else if ( !strcmp( argv[ i ], "--cpu" ) )
+        {
+            cpu = true;
+        }
+        else if ( !strcmp( argv[ i ], "--out" ) && i + 1 < argc )
+        {
+            out = argv[ ++i ];
+        }
+        else if ( !strcmp( argv[ i ], "--check-allocs" ) )
+        {
+            checkAllocations = true;
+        }
+        else
+        {
+            __builtin_printf( "usage: %s [--frames N] [--size WxH] [--raw] [--cpu] [--out path] [--check-allocs]\n", argv[ 0 ] );
+            return 1;
+        }
+    }
+    if ( !out )
+    {
+        out = format == FrameFileFormat::Raw ? "frames.rgba" : "frame";
+    }
+
+#if defined( __APPLE__ )
+    NS::AutoreleasePool* autoreleasePool = NS::AutoreleasePool::alloc()->init();
+
+    // without a metal device the cpu rasterizer stands in
+    MTL::Device* device = cpu ? nullptr : MTL::CreateSystemDefaultDevice();
+    const bool gpu = device != nullptr;
+#else
+    if ( !cpu )
+    {
+        __builtin_printf( "built without metal, rendering on the cpu\n" );
+    }
+    const bool gpu = false;
+#endif
+
+    // the gpu renders bgra like a view would, the rasterizer rgba
+    const FrameSequenceDesc desc = { out, format, width, height, gpu ? PixelLayout::BGRA8 : PixelLayout::RGBA8 };
+    FrameSequencer sequencer( desc, kReadbackSlots );
+
+    // the encoder thread reads the renderer's readback slots, finish() before the
+    // renderer goes away
+    std::unique_ptr<FrameAllocationCheck> check;
+    bool ok = false;
+    const auto begin = std::chrono::steady_clock::now();
+#if defined( __APPLE__ )
+    if ( device )
+    {
+        Renderer renderer( device, width, height, kReadbackSlots );
+        if ( checkAllocations )
+        {
+            check = std::make_unique<FrameAllocationCheck>( kWarmupFrames );
+        }
+        renderFrames( renderer, sequencer, frames, check.get() );
+        ok = sequencer.finish();
+        device->release();
+    }
+    else
+#endif
+    {
+        SoftRenderer renderer( width, height, kReadbackSlots );
+        if ( checkAllocations )
+        {
+            check = std::make_unique<FrameAllocationCheck>( kWarmupFrames );
+        }
+        renderFrames( renderer, sequencer, frames, check.get() );
+        ok = sequencer.finish();
+    }
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+
+    const FrameSequenceStats stats = sequencer.stats();
+    const double perFrame = stats.framesWritten ? 1e3 / (double)stats.framesWritten : 0.0;
+    __builtin_printf( "%s: %llu frames %ux%u in %.2f s (%.1f fps), %.1f MB written\n",
+                      gpu ? "gpu" : "cpu",
+                      (unsigned long long)stats.framesWritten, width, height, seconds, (double)stats.framesWritten / seconds,
+                      (double)stats.bytesWritten / ( 1 << 20 ) );
+    __builtin_printf( "encode %.2f ms/frame, write %.2f ms/frame, renderer waited %.1f ms on readback slots\n",
+                      stats.encodeSeconds * perFrame, stats.writeSeconds * perFrame, stats.stallSeconds * 1e3 );
+    if ( check )
+    {
+        const uint64_t checked = frames > kWarmupFrames ? frames - kWarmupFrames : 0;
+        __builtin_printf( "allocation check: %llu of %llu frames after the warm up allocated, %llu allocations\n",
+                          (unsigned long long)check->failedFrames(), (unsigned long long)checked,
+                          (unsigned long long)check->allocations() );
+        ok = ok && check->passed();
+    }
+
+#if defined( __APPLE__ )
+    autoreleasePool->release();
+#endif
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/**
+  ******************************************************************************
+  * @file           : math.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "math.hpp"
+
+#include <cmath>
+#include <cstring>
+
+static Matrix4 fromRows( float m00, float m01, float m02, float m03,
+                         float m10, float m11, float m12, float m13,
+                         float m20, float m21, float m22, float m23,
+                         float m30, float m31, float m32, float m33 )
+{
+    return { { m00, m10, m20, m30,
+               m01, m11, m21, m31,
+               m02, m12, m22, m32,
+               m03, m13, m23, m33 } };
+}
+
+Matrix4 Matrix4::operator*( const Matrix4& b ) const
+{
+    Matrix4 r;
+    for ( int c = 0; c < 4; ++c )
+    {
+        for ( int row = 0; row < 4; ++row )
+        {
+            r.m[ c * 4 + row ] = m[ 0 * 4 + row ] * b.m[ c * 4 + 0 ]
+                               + m[ 1 * 4 + row ] * b.m[ c * 4 + 1 ]
+                               + m[ 2 * 4 + row ] * b.m[ c * 4 + 2 ]
+                               + m[ 3 * 4 + row ] * b.m[ c * 4 + 3 ];
+        }
+    }
+    return r;
+}
+
+Matrix4 Math::makeIdentity()
+{
+    return fromRows( 1.f, 0.f, 0.f, 0.f,
+                     0.f, 1.f, 0.f, 0.f,
+                     0.f, 0.f, 1.f, 0.f,
+                     0.f, 0.f, 0.f, 1.f );
+}
+
+Matrix4 Math::makePerspective( float fovRadians, float aspect, float znear, float zfar )
+{
+    float ys = 1.f / tanf(fovRadians * 0.5f);
+    float xs = ys / aspect;
+    float zs = zfar / ( znear - zfar );
+    return fromRows( xs, 0.0f, 0.0f, 0.0f,
+                     0.0f, ys, 0.0f, 0.0f,
+                     0.0f, 0.0f, zs, znear * zs,
+                     0.0f, 0.0f, -1.0f, 0.0f );
+}
+
+Matrix4 Math::makeXRotate( float angleRadians )
+{
+    const float a = angleRadians;
+    return fromRows( 1.0f, 0.0f, 0.0f, 0.0f,
+                     0.0f, cosf( a ), sinf( a ), 0.0f,
+                     0.0f, -sinf( a ), cosf( a ), 0.0f,
+                     0.0f, 0.0f, 0.0f, 1.0f );
+}
+
+Matrix4 Math::makeYRotate( float angleRadians )
+{
+    const float a = angleRadians;
+    return fromRows( cosf( a ), 0.0f, sinf( a ), 0.0f,
+                     0.0f, 1.0f, 0.0f, 0.0f,
+                     -sinf( a ), 0.0f, cosf( a ), 0.0f,
+                     0.0f, 0.0f, 0.0f, 1.0f );
+}
+
+Matrix4 Math::makeZRotate( float angleRadians )
+{
+    const float a = angleRadians;
+    return fromRows( cosf( a ), sinf( a ), 0.0f, 0.0f,
+                     -sinf( a ), cosf( a ), 0.0f, 0.0f,
+                     0.0f, 0.0f, 1.0f, 0.0f,
+                     0.0f, 0.0f, 0.0f, 1.0f );
+}
+
+Matrix4 Math::makeTranslate( float x, float y, float z )
+{
+    return fromRows( 1.0f, 0.0f, 0.0f, x,
+                     0.0f, 1.0f, 0.0f, y,
+                     0.0f, 0.0f, 1.0f, z,
+                     0.0f, 0.0f, 0.0f, 1.0f );
+}
+
+Matrix4 Math::makeScale( float x, float y, float z )
+{
+    return fromRows( x, 0.0f, 0.0f, 0.0f,
+                     0.0f, y, 0.0f, 0.0f,
+                     0.0f, 0.0f, z, 0.0f,
+                     0.0f, 0.0f, 0.0f, 1.0f );
+}
+
+void Math::store( const Matrix4& m, shader_layout::host_float4x4& out )
+{
+    static_assert( sizeof( out ) == sizeof( m.m ), "float4x4 is not 16 packed floats" );
+    memcpy( &out, m.m, sizeof( m.m ) );
+}
+
+void Math::storeNormal( const Matrix4& m, shader_layout::host_float3x3& out )
+{
+    // every column is padded to 4 floats
+    float columns[ 12 ] = {};
+    for ( int c = 0; c < 3; ++c )
+    {
+        memcpy( &columns[ c * 4 ], &m.m[ c * 4 ], 3 * sizeof( float ) );
+    }
+    static_assert( sizeof( out ) == sizeof( columns ), "float3x3 is not 3 padded columns" );
+    memcpy( &out, columns, sizeof( columns ) );
+}
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file           : math.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_MATH_HPP
+#define METAL_PLAYGROUND_MATH_HPP
+
+#include "shader_struct.hpp"
+
+// plain float matrices, column major like the shader structs' float4x4, so the scene
+// builds without the simd headers and stores a matrix with one copy on every platform
+struct Matrix4
+{
+    float m[ 16 ];
+
+    Matrix4 operator*( const Matrix4& b ) const;
+};
+
+class Math {
+public:
+    static Matrix4 makeIdentity();
+    static Matrix4 makePerspective( float fovRadians, float aspect, float znear, float zfar );
+    static Matrix4 makeXRotate( float angleRadians );
+    static Matrix4 makeYRotate( float angleRadians );
+    static Matrix4 makeZRotate( float angleRadians );
+    static Matrix4 makeTranslate( float x, float y, float z );
+    static Matrix4 makeScale( float x, float y, float z );
+
+    static void store( const Matrix4& m, shader_layout::host_float4x4& out );
+    // the upper 3x3, translation discarded
+    static void storeNormal( const Matrix4& m, shader_layout::host_float3x3& out );
+};
+
+
+#endif //METAL_PLAYGROUND_MATH_HPP
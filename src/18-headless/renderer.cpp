@@ -0,0 +1,265 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr MTL::PixelFormat kColorFormat = MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB;
+static constexpr MTL::PixelFormat kDepthFormat = MTL::PixelFormat::PixelFormatDepth16Unorm;
+
+Renderer::Renderer(MTL::Device *device, uint32_t width, uint32_t height, uint32_t readbackSlots)
+: _device(device->retain())
+, _target(device, width, height, kColorFormat, kDepthFormat, readbackSlots, MTL::ClearColor::Make(0.1, 0.1, 0.1, 1.0))
+, _frame(0)
+, _frameCount(0) {
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+    buildTextures();
+
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _inFlight[ i ] = { this, nullptr, 0, nullptr };
+        _completed[ i ] = std::make_unique<CompletionHandler>( &Renderer::frameCompleted, &_inFlight[ i ] );
+    }
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    // the completion handlers still hand frames to the sequencer
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        dispatch_semaphore_wait( _semaphore, DISPATCH_TIME_FOREVER );
+    }
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        dispatch_semaphore_signal( _semaphore );
+    }
+
+    _shaderLibrary->release();
+    _pso->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+    }
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[i]->release();
+    }
+    _indexBuffer->release();
+    _texture->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::frameCompleted(void* context, MTL::CommandBuffer* cmd) {
+    InFlight* frame = static_cast<InFlight*>( context );
+    frame->sequencer->endFrame( frame->slot, frame->pixels, frame->renderer->_target.bytesPerRow() );
+    dispatch_semaphore_signal( frame->renderer->_semaphore );
+}
+
+void Renderer::draw(FrameSequencer& sequencer) {
+    AutoreleaseScope pool;
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+
+    // waits for the encoder when the disk or the encoding falls behind
+    const uint32_t slot = sequencer.beginFrame();
+
+    // the renderer owns everything the frame uses until it is done
+    MTL::CommandBuffer* cmd = _commandQueue->commandBufferWithUnretainedReferences();
+
+    // the semaphore wait above means this frame's previous use has completed
+    InFlight& frame = _inFlight[ _frame ];
+    frame.sequencer = &sequencer;
+    frame.slot = slot;
+    frame.pixels = _target.readback( slot );
+    _completed[ _frame ]->addTo( cmd );
+
+    const float aspect = (float)_target.width() / (float)_target.height();
+    Scene::update( _frameCount, aspect,
+                   reinterpret_cast<shader_types::InstanceData*>( pInstanceDataBuffer->contents() ),
+                   reinterpret_cast<shader_types::CameraData*>( pCameraDataBuffer->contents() ) );
+    ++_frameCount;
+
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder( _target.renderPassDescriptor() );
+
+    enc->setRenderPipelineState( _pso );
+    enc->setDepthStencilState( _depthStencilState );
+
+    enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+    enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+    enc->setFragmentTexture( _texture, /* index */ 0 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                Scene::kIndexCount, MTL::IndexType::IndexTypeUInt16,
+                                _indexBuffer,
+                                0,
+                                Scene::kNumInstances );
+
+    enc->endEncoding();
+
+    // no drawable to present, the frame goes back to the cpu instead
+    _target.encodeReadback( cmd, slot );
+    cmd->commit();
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+            float2 texcoord;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = float4( vd.position, 1.0 );
+            pos = instanceData[ instanceId ].instanceTransform * pos;
+            pos = cameraData.perspectiveTransform * cameraData.worldTransform * pos;
+            o.position = pos;
+
+            float3 normal = instanceData[ instanceId ].instanceNormalTransform * vd.normal;
+            normal = cameraData.worldNormalTransform * normal;
+            o.normal = normal;
+
+            o.texcoord = vd.texcoord.xy;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]], texture2d< half, access::sample > tex [[texture(0)]] )
+        {
+            constexpr sampler s( address::repeat, filter::linear );
+            half3 texel = tex.sample( s, in.texcoord ).rgb;
+
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            half3 illum = (in.color * texel * 0.1) + (in.color * texel * ndotl);
+            return half4( illum, 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction( NS::String::string("vertexMain", UTF8StringEncoding) );
+    MTL::Function* fragFn = library->newFunction( NS::String::string("fragmentMain", UTF8StringEncoding) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction( vertexFn );
+    desc->setFragmentFunction( fragFn );
+    desc->colorAttachments()->object(0)->setPixelFormat( kColorFormat );
+    desc->setDepthAttachmentPixelFormat( kDepthFormat );
+
+    _pso = _device->newRenderPipelineState( desc, &error );
+    if ( !_pso )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert(false);
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    desc->release();
+    _shaderLibrary = library;
+}
+
+void Renderer::buildBuffers() {
+    const size_t vertexDataSize = Scene::kVertexCount * sizeof( shader_types::VertexData );
+    const size_t indexDataSize = Scene::kIndexCount * sizeof( uint16_t );
+
+    _vertexDataBuffer = _device->newBuffer( Scene::vertices(), vertexDataSize, MTL::ResourceStorageModeShared );
+    _indexBuffer = _device->newBuffer( Scene::indices(), indexDataSize, MTL::ResourceStorageModeShared );
+
+    const size_t instanceDataSize = Scene::kNumInstances * sizeof( shader_types::InstanceData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+    }
+
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::buildTextures() {
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    pTextureDesc->setWidth( Scene::kTextureSize );
+    pTextureDesc->setHeight( Scene::kTextureSize );
+    pTextureDesc->setPixelFormat( MTL::PixelFormatRGBA8Unorm );
+    pTextureDesc->setTextureType( MTL::TextureType2D );
+    pTextureDesc->setStorageMode( MTL::StorageModeManaged );
+    pTextureDesc->setUsage( MTL::ResourceUsageSample | MTL::ResourceUsageRead );
+
+    _texture = _device->newTexture( pTextureDesc );
+    pTextureDesc->release();
+
+    std::vector<uint8_t> pixels;
+    Scene::buildTexture( pixels );
+    _texture->replaceRegion( MTL::Region::Make2D( 0, 0, Scene::kTextureSize, Scene::kTextureSize ), 0, pixels.data(), Scene::kTextureSize * 4 );
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
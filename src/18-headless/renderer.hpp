@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+
+#include <simd/simd.h>
+
+#include <memory>
+
+#include "frame_loop.hpp"
+#include "frame_sequencer.hpp"
+#include "offscreen_target.hpp"
+#include "scene.hpp"
+
+// draws the scene into an offscreen target instead of a view, every frame ends with
+// a blit into the sequencer slot's readback buffer. once warmed up a frame does not
+// allocate on our side, see frame_loop.hpp.
+class Renderer {
+private:
+    // what a frame's completed handler hands over, one per frame in flight
+    struct InFlight
+    {
+        Renderer* renderer;
+        FrameSequencer* sequencer;
+        uint32_t slot;
+        const void* pixels;
+    };
+
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _pso;
+    MTL::DepthStencilState* _depthStencilState;
+
+    OffscreenTarget _target;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+    MTL::Texture* _texture;
+
+    InFlight _inFlight[3];
+    std::unique_ptr<CompletionHandler> _completed[3];
+
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    static void frameCompleted(void* context, MTL::CommandBuffer* cmd);
+
+public:
+    Renderer(MTL::Device* device, uint32_t width, uint32_t height, uint32_t readbackSlots);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildTextures();
+    void buildDepthStencilStates();
+    void draw(FrameSequencer& sequencer);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,132 @@
+/**
+  ******************************************************************************
+  * @file           : scene.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "scene.hpp"
+#include "math.hpp"
+
+#include <cmath>
+
+// half the cube's edge
+static constexpr float kHalf = 0.5f;
+
+static const shader_types::VertexData kVertices[ Scene::kVertexCount ] = {
+    //                                                     Texture
+    //         Positions                 Normals         Coordinates
+    { { -kHalf, -kHalf, +kHalf }, {  0.f,  0.f,  1.f }, { 0.f, 1.f } },
+    { { +kHalf, -kHalf, +kHalf }, {  0.f,  0.f,  1.f }, { 1.f, 1.f } },
+    { { +kHalf, +kHalf, +kHalf }, {  0.f,  0.f,  1.f }, { 1.f, 0.f } },
+    { { -kHalf, +kHalf, +kHalf }, {  0.f,  0.f,  1.f }, { 0.f, 0.f } },
+
+    { { +kHalf, -kHalf, +kHalf }, {  1.f,  0.f,  0.f }, { 0.f, 1.f } },
+    { { +kHalf, -kHalf, -kHalf }, {  1.f,  0.f,  0.f }, { 1.f, 1.f } },
+    { { +kHalf, +kHalf, -kHalf }, {  1.f,  0.f,  0.f }, { 1.f, 0.f } },
+    { { +kHalf, +kHalf, +kHalf }, {  1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+    { { +kHalf, -kHalf, -kHalf }, {  0.f,  0.f, -1.f }, { 0.f, 1.f } },
+    { { -kHalf, -kHalf, -kHalf }, {  0.f,  0.f, -1.f }, { 1.f, 1.f } },
+    { { -kHalf, +kHalf, -kHalf }, {  0.f,  0.f, -1.f }, { 1.f, 0.f } },
+    { { +kHalf, +kHalf, -kHalf }, {  0.f,  0.f, -1.f }, { 0.f, 0.f } },
+
+    { { -kHalf, -kHalf, -kHalf }, { -1.f,  0.f,  0.f }, { 0.f, 1.f } },
+    { { -kHalf, -kHalf, +kHalf }, { -1.f,  0.f,  0.f }, { 1.f, 1.f } },
+    { { -kHalf, +kHalf, +kHalf }, { -1.f,  0.f,  0.f }, { 1.f, 0.f } },
+    { { -kHalf, +kHalf, -kHalf }, { -1.f,  0.f,  0.f }, { 0.f, 0.f } },
+
+    { { -kHalf, +kHalf, +kHalf }, {  0.f,  1.f,  0.f }, { 0.f, 1.f } },
+    { { +kHalf, +kHalf, +kHalf }, {  0.f,  1.f,  0.f }, { 1.f, 1.f } },
+    { { +kHalf, +kHalf, -kHalf }, {  0.f,  1.f,  0.f }, { 1.f, 0.f } },
+    { { -kHalf, +kHalf, -kHalf }, {  0.f,  1.f,  0.f }, { 0.f, 0.f } },
+
+    { { -kHalf, -kHalf, -kHalf }, {  0.f, -1.f,  0.f }, { 0.f, 1.f } },
+    { { +kHalf, -kHalf, -kHalf }, {  0.f, -1.f,  0.f }, { 1.f, 1.f } },
+    { { +kHalf, -kHalf, +kHalf }, {  0.f, -1.f,  0.f }, { 1.f, 0.f } },
+    { { -kHalf, -kHalf, +kHalf }, {  0.f, -1.f,  0.f }, { 0.f, 0.f } }
+};
+
+static const uint16_t kIndices[ Scene::kIndexCount ] = {
+     0,  1,  2,  2,  3,  0, /* front */
+     4,  5,  6,  6,  7,  4, /* right */
+     8,  9, 10, 10, 11,  8, /* back */
+    12, 13, 14, 14, 15, 12, /* left */
+    16, 17, 18, 18, 19, 16, /* top */
+    20, 21, 22, 22, 23, 20, /* bottom */
+};
+
+const shader_types::VertexData* Scene::vertices() {
+    return kVertices;
+}
+
+const uint16_t* Scene::indices() {
+    return kIndices;
+}
+
+void Scene::buildTexture( std::vector<uint8_t>& rgba ) {
+    rgba.resize( kTextureSize * kTextureSize * 4 );
+    for ( uint32_t y = 0; y < kTextureSize; ++y )
+    {
+        for ( uint32_t x = 0; x < kTextureSize; ++x )
+        {
+            const uint8_t c = ( ( x / 32 ) + ( y / 32 ) ) % 2 ? 0xFF : 0x60;
+            uint8_t* p = &rgba[ ( y * kTextureSize + x ) * 4 ];
+            p[0] = c;
+            p[1] = c;
+            p[2] = c;
+            p[3] = 0xFF;
+        }
+    }
+}
+
+void Scene::update( uint64_t frame, float aspect, shader_types::InstanceData* instances, shader_types::CameraData* camera ) {
+    const float angle = kAngleStep * (float)frame;
+    const float scl = 0.2f;
+
+    const float objectX = 0.f;
+    const float objectY = 0.f;
+    const float objectZ = -10.f;
+
+    Matrix4 rt = Math::makeTranslate( objectX, objectY, objectZ );
+    Matrix4 rr1 = Math::makeYRotate( -angle );
+    Matrix4 rr0 = Math::makeXRotate( angle * 0.5 );
+    Matrix4 rtInv = Math::makeTranslate( -objectX, -objectY, -objectZ );
+    Matrix4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        Matrix4 scale = Math::makeScale( scl, scl, scl );
+        Matrix4 zrot = Math::makeZRotate( angle * sinf((float)ix) );
+        Matrix4 yrot = Math::makeYRotate( angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        Matrix4 translate = Math::makeTranslate( objectX + x, objectY + y, objectZ + z );
+
+        const Matrix4 transform = fullObjectRot * translate * yrot * zrot * scale;
+        Math::store( transform, instances[ i ].instanceTransform );
+        Math::storeNormal( transform, instances[ i ].instanceNormalTransform );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        instances[ i ].instanceColor = { r, g, b, 1.0f };
+    }
+
+    const Matrix4 world = Math::makeIdentity();
+    Math::store( Math::makePerspective( 45.f * M_PI / 180.f, aspect, 0.03f, 500.0f ), camera->perspectiveTransform );
+    Math::store( world, camera->worldTransform );
+    Math::storeNormal( world, camera->worldNormalTransform );
+}
@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file           : scene.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SCENE_HPP
+#define METAL_PLAYGROUND_SCENE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "shader_struct.hpp"
+
+namespace shader_types
+{
+#define VERTEX_DATA_FIELDS( F )                 \
+    F( float3, position )                       \
+    F( float3, normal )                         \
+    F( float2, texcoord )
+
+#define INSTANCE_DATA_FIELDS( F )               \
+    F( float4x4, instanceTransform )            \
+    F( float3x3, instanceNormalTransform )      \
+    F( float4, instanceColor )
+
+#define CAMERA_DATA_FIELDS( F )                 \
+    F( float4x4, perspectiveTransform )         \
+    F( float4x4, worldTransform )               \
+    F( float3x3, worldNormalTransform )
+
+    SHADER_STRUCT( VertexData, VERTEX_DATA_FIELDS );
+    SHADER_STRUCT( InstanceData, INSTANCE_DATA_FIELDS );
+    SHADER_STRUCT( CameraData, CAMERA_DATA_FIELDS );
+}
+
+// the cube grid of the earlier samples, shared by the metal and the cpu renderer so
+// frame n is the same picture on both. time advances a fixed step per frame.
+class Scene {
+public:
+    static constexpr size_t kInstanceRows = 10;
+    static constexpr size_t kInstanceColumns = 10;
+    static constexpr size_t kInstanceDepth = 10;
+    static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+    static constexpr size_t kVertexCount = 24;
+    static constexpr size_t kIndexCount = 36;
+    static constexpr uint32_t kTextureSize = 256;
+    static constexpr float kAngleStep = 0.01f;
+
+    static const shader_types::VertexData* vertices();
+    static const uint16_t* indices();
+    static void buildTexture( std::vector<uint8_t>& rgba );
+
+    static void update( uint64_t frame, float aspect, shader_types::InstanceData* instances, shader_types::CameraData* camera );
+};
+
+
+#endif //METAL_PLAYGROUND_SCENE_HPP
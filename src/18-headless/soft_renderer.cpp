@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file           : soft_renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "soft_renderer.hpp"
+
+#include <cstring>
+
+// shader struct matrices keep every column 16 byte aligned, the rasterizer takes them packed
+static void packColumns( const float* columns, int count, int rows, float* out )
+{
+    for ( int c = 0; c < count; ++c )
+    {
+        memcpy( out + c * rows, columns + c * 4, rows * sizeof( float ) );
+    }
+}
+
+SoftRenderer::SoftRenderer( uint32_t width, uint32_t height, uint32_t readbackSlots )
+: _rasterizer(_jobs, width, height)
+, _instances(Scene::kNumInstances)
+, _instanceData(Scene::kNumInstances)
+, _readback(readbackSlots, std::vector<uint8_t>((size_t)width * height * 4))
+, _frameCount(0) {
+    const shader_types::VertexData* vertices = Scene::vertices();
+    for ( size_t i = 0; i < Scene::kVertexCount; ++i )
+    {
+        SoftVertex v;
+        packColumns( (const float*)&vertices[ i ].position, 1, 3, v.position );
+        packColumns( (const float*)&vertices[ i ].normal, 1, 3, v.normal );
+        packColumns( (const float*)&vertices[ i ].texcoord, 1, 2, v.texcoord );
+        _vertices.push_back( v );
+    }
+
+    Scene::buildTexture( _texels );
+    _texture = { _texels.data(), Scene::kTextureSize, Scene::kTextureSize };
+}
+
+void SoftRenderer::draw( FrameSequencer& sequencer ) {
+    const uint32_t slot = sequencer.beginFrame();
+
+    shader_types::CameraData cameraData;
+    const float aspect = (float)_rasterizer.width() / (float)_rasterizer.height();
+    Scene::update( _frameCount++, aspect, _instanceData.data(), &cameraData );
+
+    for ( size_t i = 0; i < Scene::kNumInstances; ++i )
+    {
+        const shader_types::InstanceData& src = _instanceData[ i ];
+        packColumns( (const float*)&src.instanceTransform, 4, 4, _instances[ i ].transform );
+        packColumns( (const float*)&src.instanceNormalTransform, 3, 3, _instances[ i ].normalTransform );
+        packColumns( (const float*)&src.instanceColor, 1, 4, _instances[ i ].color );
+    }
+
+    SoftCamera camera;
+    packColumns( (const float*)&cameraData.perspectiveTransform, 4, 4, camera.projection );
+    packColumns( (const float*)&cameraData.worldTransform, 4, 4, camera.world );
+    packColumns( (const float*)&cameraData.worldNormalTransform, 3, 3, camera.normalTransform );
+
+    SoftDraw draw = {};
+    draw.vertices = _vertices.data();
+    draw.vertexCount = _vertices.size();
+    draw.indices = Scene::indices();
+    draw.indexCount = Scene::kIndexCount;
+    draw.instances = _instances.data();
+    draw.instanceCount = _instances.size();
+    draw.shading = kSoftTextured | kSoftLit;
+    draw.texture = &_texture;
+    draw.cullBack = true;
+
+    const float clearColor[ 4 ] = { 0.1f, 0.1f, 0.1f, 1.f };
+    _rasterizer.clear( clearColor );
+    _rasterizer.draw( camera, draw );
+
+    std::vector<uint8_t>& pixels = _readback[ slot ];
+    memcpy( pixels.data(), _rasterizer.color(), pixels.size() );
+    sequencer.endFrame( slot, pixels.data(), (size_t)_rasterizer.width() * 4 );
+}
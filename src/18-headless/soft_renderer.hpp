@@ -0,0 +1,46 @@
+/**
+  ******************************************************************************
+  * @file           : soft_renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SOFT_RENDERER_HPP
+#define METAL_PLAYGROUND_SOFT_RENDERER_HPP
+
+#include <vector>
+
+#include "frame_sequencer.hpp"
+#include "job_system.hpp"
+#include "scene.hpp"
+#include "soft_rasterizer.hpp"
+
+// the same frames on the cpu, for machines without a metal device. the rasterizer
+// draws into its own image, which is copied into the sequencer slot afterwards.
+class SoftRenderer {
+private:
+    JobSystem _jobs;
+    SoftRasterizer _rasterizer;
+
+    std::vector<SoftVertex> _vertices;
+    std::vector<SoftInstance> _instances;
+    std::vector<shader_types::InstanceData> _instanceData;
+    std::vector<uint8_t> _texels;
+    SoftTexture _texture;
+
+    std::vector<std::vector<uint8_t>> _readback;
+    uint64_t _frameCount;
+
+public:
+    SoftRenderer( uint32_t width, uint32_t height, uint32_t readbackSlots );
+
+    void draw( FrameSequencer& sequencer );
+};
+
+
+#endif //METAL_PLAYGROUND_SOFT_RENDERER_HPP
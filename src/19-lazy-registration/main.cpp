@@ -0,0 +1,165 @@
+/**
+  ******************************************************************************
+  * @file           : main.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+
+#include <sys/sysctl.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define NS_PRIVATE_IMPLEMENTATION
+#define MTL_PRIVATE_IMPLEMENTATION
+#define MTK_PRIVATE_IMPLEMENTATION
+#define CA_PRIVATE_IMPLEMENTATION
+
+#include <Metal/Metal.hpp>
+
+#include "offscreen_target.hpp"
+
+static constexpr uint32_t kTargetSize = 256;
+static constexpr size_t kMessageLoops = 10000000;
+
+// startup benchmark for METALCPP_LAZY_REGISTRATION: build once with the cmake option
+// METAL_CPP_LAZY_REGISTRATION off and once on, then compare over a few runs
+//
+//   for i in $(seq 20); do ./19-lazy-registration; done
+
+// from the kernel's process start, so it covers dyld and every static initializer
+static double secondsSinceLaunch()
+{
+    int mib[ 4 ] = { CTL_KERN, KERN_PROC, KERN_PROC_PID, getpid() };
+    kinfo_proc info;
+    size_t size = sizeof( info );
+    if ( sysctl( mib, 4, &info, &size, nullptr, 0 ) != 0 )
+    {
+        return -1.0;
+    }
+    timeval now;
+    gettimeofday( &now, nullptr );
+    return (double)( now.tv_sec - info.kp_proc.p_starttime.tv_sec )
+         + (double)( now.tv_usec - info.kp_proc.p_starttime.tv_usec ) * 1e-6;
+}
+
+static double secondsSince( std::chrono::steady_clock::time_point begin )
+{
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+}
+
+// the few dozen messages a sample needs up to its first frame
+static void firstFrame( MTL::Device* device )
+{
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderSrc = R"(
+        #include <metal_stdlib>
+        using namespace metal;
+
+        float4 vertex vertexMain( uint vertexId [[vertex_id]] )
+        {
+            const float2 p[ 3 ] = { float2( -0.8, -0.8 ), float2( 0.8, -0.8 ), float2( 0.0, 0.8 ) };
+            return float4( p[ vertexId ], 0.5, 1.0 );
+        }
+
+        half4 fragment fragmentMain()
+        {
+            return half4( 1.0, 0.5, 0.2, 1.0 );
+        }
+    )";
+
+    MTL::CommandQueue* queue = device->newCommandQueue();
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = device->newLibrary( NS::String::string( shaderSrc, UTF8StringEncoding ), nullptr, &error );
+    if ( !library )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+    MTL::Function* vertexFn = library->newFunction( NS::String::string( "vertexMain", UTF8StringEncoding ) );
+    MTL::Function* fragFn = library->newFunction( NS::String::string( "fragmentMain", UTF8StringEncoding ) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction( vertexFn );
+    desc->setFragmentFunction( fragFn );
+    desc->colorAttachments()->object( 0 )->setPixelFormat( MTL::PixelFormat::PixelFormatBGRA8Unorm );
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+    MTL::RenderPipelineState* pso = device->newRenderPipelineState( desc, &error );
+    if ( !pso )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    OffscreenTarget target( device, kTargetSize, kTargetSize,
+                            MTL::PixelFormat::PixelFormatBGRA8Unorm, MTL::PixelFormat::PixelFormatDepth16Unorm,
+                            1, MTL::ClearColor::Make( 0.1, 0.1, 0.1, 1.0 ) );
+
+    MTL::CommandBuffer* cmd = queue->commandBuffer();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder( target.renderPassDescriptor() );
+    enc->setRenderPipelineState( pso );
+    enc->drawPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle, NS::UInteger( 0 ), NS::UInteger( 3 ) );
+    enc->endEncoding();
+    target.encodeReadback( cmd, 0 );
+    cmd->commit();
+    cmd->waitUntilCompleted();
+
+    pso->release();
+    desc->release();
+    fragFn->release();
+    vertexFn->release();
+    library->release();
+    queue->release();
+}
+
+int main( int argc, char* argv[] )
+{
+    const double launchToMain = secondsSinceLaunch();
+#if defined( METALCPP_LAZY_REGISTRATION )
+    const uint32_t resolvedAtMain = NS::Private::lazyResolveCount();
+#endif
+
+    std::cout << "lazy registration" << std::endl;
+
+    NS::AutoreleasePool* autoreleasePool = NS::AutoreleasePool::alloc()->init();
+
+    auto begin = std::chrono::steady_clock::now();
+    MTL::Device* device = MTL::CreateSystemDefaultDevice();
+    firstFrame( device );
+    const double firstFrameSeconds = secondsSince( begin );
+
+#if defined( METALCPP_LAZY_REGISTRATION )
+    __builtin_printf( "lazy: %u selectors and classes resolved before main, %u after the first frame\n",
+                      resolvedAtMain, NS::Private::lazyResolveCount() );
+#else
+    __builtin_printf( "eager: every selector and class registered before main\n" );
+#endif
+    __builtin_printf( "launch to main %.2f ms, first frame %.2f ms\n", launchToMain * 1e3, firstFrameSeconds * 1e3 );
+
+    // steady state: a cached selector costs one load on top of objc_msgSend
+    MTL::Buffer* buffer = device->newBuffer( 256, MTL::ResourceStorageModeShared );
+    size_t sum = 0;
+    begin = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < kMessageLoops; ++i )
+    {
+        sum += buffer->length();
+    }
+    const double messageSeconds = secondsSince( begin );
+    __builtin_printf( "buffer->length(): %.2f ns per message (%zu)\n", messageSeconds * 1e9 / kMessageLoops, sum / kMessageLoops );
+
+    buffer->release();
+    device->release();
+    autoreleasePool->release();
+
+    return 0;
+}
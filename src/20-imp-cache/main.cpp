@@ -0,0 +1,182 @@
+/**
+  ******************************************************************************
+  * @file           : main.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#define NS_PRIVATE_IMPLEMENTATION
+#define MTL_PRIVATE_IMPLEMENTATION
+#define MTK_PRIVATE_IMPLEMENTATION
+#define CA_PRIVATE_IMPLEMENTATION
+
+#include <Metal/Metal.hpp>
+
+#include "offscreen_target.hpp"
+
+static constexpr uint32_t kTargetSize = 64;
+static constexpr size_t kDraws = 100000;
+static constexpr size_t kCallsPerDraw = 4;
+static constexpr size_t kRuns = 5;
+static constexpr size_t kRetainLoops = 1000000;
+
+// encode throughput for METALCPP_IMP_CACHE: build once with the cmake option
+// METAL_CPP_IMP_CACHE off and once on, then compare the calls per second
+
+static double secondsSince( std::chrono::steady_clock::time_point begin )
+{
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+}
+
+static MTL::RenderPipelineState* buildPipeline( MTL::Device* device )
+{
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderSrc = R"(
+        #include <metal_stdlib>
+        using namespace metal;
+
+        struct v2f
+        {
+            float4 position [[position]];
+            half4 color;
+        };
+
+        v2f vertex vertexMain( uint vertexId [[vertex_id]],
+                               device const float4* positions [[buffer(0)]],
+                               constant uint& drawId [[buffer(1)]],
+                               device const float4* colors [[buffer(2)]] )
+        {
+            v2f o;
+            o.position = positions[ vertexId ];
+            o.color = half4( colors[ drawId & 255 ] );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]] )
+        {
+            return in.color;
+        }
+    )";
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = device->newLibrary( NS::String::string( shaderSrc, UTF8StringEncoding ), nullptr, &error );
+    if ( !library )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+    MTL::Function* vertexFn = library->newFunction( NS::String::string( "vertexMain", UTF8StringEncoding ) );
+    MTL::Function* fragFn = library->newFunction( NS::String::string( "fragmentMain", UTF8StringEncoding ) );
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction( vertexFn );
+    desc->setFragmentFunction( fragFn );
+    desc->colorAttachments()->object( 0 )->setPixelFormat( MTL::PixelFormat::PixelFormatBGRA8Unorm );
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+    MTL::RenderPipelineState* pso = device->newRenderPipelineState( desc, &error );
+    if ( !pso )
+    {
+        __builtin_printf( "%s", error->localizedDescription()->utf8String() );
+        assert( false );
+    }
+
+    desc->release();
+    fragFn->release();
+    vertexFn->release();
+    library->release();
+    return pso;
+}
+
+int main( int argc, char* argv[] )
+{
+    std::cout << "imp cache" << std::endl;
+
+    NS::AutoreleasePool* autoreleasePool = NS::AutoreleasePool::alloc()->init();
+
+    MTL::Device* device = MTL::CreateSystemDefaultDevice();
+    MTL::CommandQueue* queue = device->newCommandQueue();
+    MTL::RenderPipelineState* pso = buildPipeline( device );
+
+    OffscreenTarget target( device, kTargetSize, kTargetSize,
+                            MTL::PixelFormat::PixelFormatBGRA8Unorm, MTL::PixelFormat::PixelFormatDepth16Unorm,
+                            1, MTL::ClearColor::Make( 0.1, 0.1, 0.1, 1.0 ) );
+
+    // one triangle per draw, every draw rebinds its vertices at another offset
+    const float triangle[ 12 ] = { -0.1f, -0.1f, 0.5f, 1.f, 0.1f, -0.1f, 0.5f, 1.f, 0.f, 0.1f, 0.5f, 1.f };
+    const size_t triangleSize = sizeof( triangle );
+    MTL::Buffer* positions = device->newBuffer( triangleSize * 256, MTL::ResourceStorageModeShared );
+    MTL::Buffer* colors = device->newBuffer( sizeof( float ) * 4 * 256, MTL::ResourceStorageModeShared );
+    for ( size_t i = 0; i < 256; ++i )
+    {
+        memcpy( (uint8_t*)positions->contents() + i * triangleSize, triangle, triangleSize );
+        const float color[ 4 ] = { (float)( i & 7 ) / 7.f, (float)( ( i >> 3 ) & 7 ) / 7.f, (float)( i >> 6 ) / 3.f, 1.f };
+        memcpy( (uint8_t*)colors->contents() + i * sizeof( color ), color, sizeof( color ) );
+    }
+
+    // only the encoding is timed, the gpu work is waited for outside of it
+    double bestSeconds = 1e9;
+    for ( size_t run = 0; run < kRuns; ++run )
+    {
+        NS::AutoreleasePool* runPool = NS::AutoreleasePool::alloc()->init();
+
+        MTL::CommandBuffer* cmd = queue->commandBuffer();
+        MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder( target.renderPassDescriptor() );
+        enc->setRenderPipelineState( pso );
+        enc->setVertexBuffer( colors, 0, 2 );
+
+        auto begin = std::chrono::steady_clock::now();
+        for ( uint32_t draw = 0; draw < kDraws; ++draw )
+        {
+            enc->setVertexBuffer( positions, ( draw & 255 ) * triangleSize, 0 );
+            enc->setVertexBytes( &draw, sizeof( draw ), 1 );
+            enc->setFragmentBuffer( colors, 0, 0 );
+            enc->drawPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle, NS::UInteger( 0 ), NS::UInteger( 3 ) );
+        }
+        bestSeconds = std::min( bestSeconds, secondsSince( begin ) );
+
+        enc->endEncoding();
+        cmd->commit();
+        cmd->waitUntilCompleted();
+
+        runPool->release();
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < kRetainLoops; ++i )
+    {
+        positions->retain();
+        positions->release();
+    }
+    const double retainSeconds = secondsSince( begin );
+
+#if defined( METALCPP_IMP_CACHE )
+    __builtin_printf( "imp cache on\n" );
+#else
+    __builtin_printf( "imp cache off, objc_msgSend\n" );
+#endif
+    __builtin_printf( "%zu draws encoded in %.2f ms (best of %zu): %.1f M calls/s, %.1f ns per call\n",
+                      kDraws, bestSeconds * 1e3, kRuns,
+                      kDraws * kCallsPerDraw / bestSeconds * 1e-6, bestSeconds * 1e9 / ( kDraws * kCallsPerDraw ) );
+    __builtin_printf( "retain + release: %.1f ns per pair\n", retainSeconds * 1e9 / kRetainLoops );
+
+    colors->release();
+    positions->release();
+    pso->release();
+    queue->release();
+    device->release();
+    autoreleasePool->release();
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file           : main.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+#include <cstring>
+#include <iostream>
+
+#define NS_PRIVATE_IMPLEMENTATION
+#define MTL_PRIVATE_IMPLEMENTATION
+#define MTK_PRIVATE_IMPLEMENTATION
+#define CA_PRIVATE_IMPLEMENTATION
+
+#include "renderer.hpp"
+#include "delegates.hpp"
+
+int main( int argc, char* argv[] )
+{
+    // the lights are binned by a compute pass, --cpu-binning bins them on the cpu instead
+    bool cpuBinning = false;
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( !strcmp( argv[ i ], "--cpu-binning" ) )
+        {
+            cpuBinning = true;
+        }
+        else
+        {
+            __builtin_printf( "usage: %s [--cpu-binning]\n", argv[ 0 ] );
+            return 1;
+        }
+    }
+
+    std::cout << "clustered lighting";
+
+    NS::AutoreleasePool* autoreleasePool = NS::AutoreleasePool::alloc()->init();
+
+    MyAppDelegate appDelegate( cpuBinning );
+
+    NS::Application* sharedApplication = NS::Application::sharedApplication();
+    sharedApplication->setDelegate(&appDelegate);
+    sharedApplication->run();
+
+    autoreleasePool->release();
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,465 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <cstring>
+#include <random>
+#include <string>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr size_t kLightCount = 4096;
+static constexpr float kFovY = 45.f * M_PI / 180.f;
+// the clusters only cover the depths the cubes and lights are at, the projection goes further
+static constexpr float kClusterNear = 0.5f;
+static constexpr float kClusterFar = 50.f;
+static constexpr uint32_t kTilesX = 16;
+static constexpr uint32_t kTilesY = 9;
+static constexpr uint32_t kSlices = 24;
+static constexpr uint32_t kMaxLightsPerCluster = 256;
+static constexpr uint64_t kStatsInterval = 300;
+
+Renderer::Renderer(MTL::Device *device, bool cpuBinning)
+: _device(device->retain())
+, _cpuBinning(cpuBinning)
+, _clusters(_jobs, makeClusterGrid( kTilesX, kTilesY, kSlices, kMaxLightsPerCluster, kFovY, 1.f, kClusterNear, kClusterFar,
+                                     /* pixelsToTiles is set per frame from the drawable */ 1, 1 ))
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+    buildLights();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+        _cameraDataBuffer[i]->release();
+        _lightBuffer[i]->release();
+        _clusterCounts[i]->release();
+        _clusterIndices[i]->release();
+    }
+    _indexBuffer->release();
+    _binningPSO->release();
+    _PSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+    MTL::Buffer* pLightBuffer = _lightBuffer[ _frame ];
+    MTL::Buffer* pClusterCounts = _clusterCounts[ _frame ];
+    MTL::Buffer* pClusterIndices = _clusterIndices[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    ++_frameCount;
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+    updateLights( pLightBuffer );
+
+    const CGSize drawableSize = view->drawableSize();
+    shader_types::ClusterGrid grid = _clusters.grid();
+    grid.lightCount = (uint32_t)_lights.size();
+    grid.pixelsToTiles = { (float)( kTilesX / drawableSize.width ), (float)( kTilesY / drawableSize.height ) };
+
+    if ( _cpuBinning )
+    {
+        _clusters.bin( _lights.data(), _lights.size() );
+        memcpy( pClusterCounts->contents(), _clusters.counts(), _clusters.clusterCount() * sizeof( uint32_t ) );
+        memcpy( pClusterIndices->contents(), _clusters.indices(), _clusters.clusterCount() * kMaxLightsPerCluster * sizeof( uint16_t ) );
+    }
+    else
+    {
+        // one thread per cluster, a threadgroup per slice
+        MTL::ComputeCommandEncoder* binEnc = cmd->computeCommandEncoder();
+        binEnc->setComputePipelineState( _binningPSO );
+        binEnc->setBytes( &grid, sizeof( grid ), /* index */ 0 );
+        binEnc->setBuffer( pLightBuffer, /* offset */ 0, /* index */ 1 );
+        binEnc->setBuffer( pClusterCounts, /* offset */ 0, /* index */ 2 );
+        binEnc->setBuffer( pClusterIndices, /* offset */ 0, /* index */ 3 );
+        binEnc->dispatchThreads( MTL::Size( kTilesX, kTilesY, kSlices ), MTL::Size( kTilesX, kTilesY, 1 ) );
+        binEnc->endEncoding();
+    }
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+
+    enc->setRenderPipelineState(_PSO);
+    enc->setDepthStencilState( _depthStencilState );
+
+    enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+    enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+
+    enc->setFragmentBytes( &grid, sizeof( grid ), /* index */ 0 );
+    enc->setFragmentBuffer( pLightBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setFragmentBuffer( pClusterCounts, /* offset */ 0, /* index */ 2 );
+    enc->setFragmentBuffer( pClusterIndices, /* offset */ 0, /* index */ 3 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                _indexBuffer,
+                                0,
+                                kNumInstances );
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    if ( _frameCount % kStatsInterval == 0 )
+    {
+        // a stall now and then, to hold the frame's lists against the cpu reference
+        cmd->waitUntilCompleted();
+        checkBinning( grid, cmd->GPUEndTime() - cmd->GPUStartTime() );
+    }
+
+    pool->release();
+}
+
+void Renderer::checkBinning(const shader_types::ClusterGrid& grid, double gpuSeconds) {
+    const uint32_t* counts = (const uint32_t*)_clusterCounts[ _frame ]->contents();
+    const uint16_t* indices = (const uint16_t*)_clusterIndices[ _frame ]->contents();
+
+    if ( !_cpuBinning )
+    {
+        _clusters.bin( _lights.data(), _lights.size() );
+    }
+    const LightClusterStats stats = _clusters.stats();
+
+    // the gpu rounds its own way, a light exactly on a cluster boundary may differ
+    size_t mismatched = 0;
+    for ( size_t c = 0; c < _clusters.clusterCount(); ++c )
+    {
+        const size_t first = c * grid.maxLightsPerCluster;
+        if ( counts[ c ] != _clusters.counts()[ c ]
+             || memcmp( indices + first, _clusters.indices() + first, counts[ c ] * sizeof( uint16_t ) ) != 0 )
+        {
+            ++mismatched;
+        }
+    }
+
+    __builtin_printf( "%s binning: %zu lights into %zu clusters, %zu occupied, %.1f lights per occupied cluster, max %u, %zu dropped | "
+                      "cpu bin %.2f ms on %zu threads, frame on the gpu %.2f ms, %zu clusters differ from the cpu reference\n",
+                      _cpuBinning ? "cpu" : "gpu", stats.lights, stats.clusters, stats.occupied,
+                      (double)stats.references / ( stats.occupied ? stats.occupied : 1 ), stats.maxCount, stats.dropped,
+                      stats.seconds * 1e3, _jobs.threadCount(), gpuSeconds * 1e3, mismatched );
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        pInstanceData[ i ].instanceTransform = fullObjectRot * translate * yrot * zrot * scale;
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( pInstanceData[ i ].instanceTransform );
+
+        // lit by the lights alone, so a pale albedo
+        pInstanceData[ i ].instanceColor = (float4){ 0.8f, 0.8f, 0.8f, 1.0f };
+    }
+
+    // the world is the view space the lights are binned in
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( kFovY, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = Math::makeIdentity();
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+}
+
+void Renderer::updateLights(MTL::Buffer *lightBuffer) {
+    for ( size_t i = 0; i < _orbits.size(); ++i )
+    {
+        const LightOrbit& o = _orbits[ i ];
+        const float a = o.phase + _angle * o.speed;
+        shader_types::ClusterLight& l = _lights[ i ];
+        l.position = { o.center.x + o.radius * cosf( a ), o.center.y, o.center.z + o.radius * sinf( a ) };
+
+        // spot lights keep facing the middle of the cubes
+        if ( l.spotCosOuter > -1.f )
+        {
+            const simd::float3 d = simd::normalize( (simd::float3){ 0.f, 0.f, -10.f } - (simd::float3){ l.position.x, l.position.y, l.position.z } );
+            l.direction = { d.x, d.y, d.z };
+        }
+    }
+    memcpy( lightBuffer->contents(), _lights.data(), _lights.size() * sizeof( shader_types::ClusterLight ) );
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 viewPosition;
+            float3 normal;
+            half3 color;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = float4( vd.position, 1.0 );
+            pos = cameraData.worldTransform * instanceData[ instanceId ].instanceTransform * pos;
+            o.viewPosition = pos.xyz;
+            o.position = cameraData.perspectiveTransform * pos;
+
+            float3 normal = instanceData[ instanceId ].instanceNormalTransform * vd.normal;
+            o.normal = cameraData.worldNormalTransform * normal;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        // the lights of the fragment's cluster instead of one fixed direction
+        half4 fragment fragmentMain( v2f in [[stage_in]],
+                                     constant ClusterGrid& grid [[buffer(0)]],
+                                     device const ClusterLight* lights [[buffer(1)]],
+                                     device const uint* counts [[buffer(2)]],
+                                     device const ushort* indices [[buffer(3)]] )
+        {
+            const float3 n = normalize( in.normal );
+            const uint cluster = clusterIndex( grid, in.position.xy, -in.viewPosition.z );
+            device const ushort* list = indices + cluster * grid.maxLightsPerCluster;
+
+            float3 lit = float3( 0.02 );
+            for ( uint i = 0; i < counts[ cluster ]; ++i )
+            {
+                const ClusterLight l = lights[ list[ i ] ];
+                const float3 toLight = float3( l.position ) - in.viewPosition;
+                const float d2 = dot( toLight, toLight );
+                const float d = sqrt( d2 );
+                const float3 dir = toLight / max( d, 1e-4 );
+
+                // smooth window to zero at the range the light was binned with
+                const float x = d / l.range;
+                float falloff = saturate( 1.0 - x * x * x * x );
+                falloff = falloff * falloff / ( d2 + 1.0 );
+                if ( l.spotCosOuter > -1.0 )
+                {
+                    falloff *= smoothstep( l.spotCosOuter, l.spotCosInner, dot( -dir, float3( l.direction ) ) );
+                }
+                lit += float3( l.color ) * saturate( dot( n, dir ) ) * falloff;
+            }
+            return half4( in.color * half3( lit ), 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shader_types::kClusterLightSource
+                                + shader_types::kClusterGridSource
+                                + kLightClustersSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction(NS::String::string("fragmentMain", UTF8StringEncoding));
+    MTL::Function* binFn = library->newFunction(NS::String::string("binLightClusters", UTF8StringEncoding));
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    _binningPSO = _device->newComputePipelineState(binFn, &error);
+    if(!_binningPSO) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    binFn->release();
+    desc->release();
+    _shaderLibrary = library;
+}
+
+void Renderer::buildBuffers() {
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //   Positions           Normals
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    _vertexDataBuffer = _device->newBuffer( verts, sizeof( verts ), MTL::ResourceStorageModeShared );
+    _indexBuffer = _device->newBuffer( indices, sizeof( indices ), MTL::ResourceStorageModeShared );
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    const size_t lightDataSize = kLightCount * sizeof( shader_types::ClusterLight );
+    const size_t countsSize = _clusters.clusterCount() * sizeof( uint32_t );
+    const size_t indicesSize = _clusters.clusterCount() * kMaxLightsPerCluster * sizeof( uint16_t );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+        _lightBuffer[ i ] = _device->newBuffer( lightDataSize, MTL::ResourceStorageModeShared );
+        // shared so the cpu path can write them and the reference check can read them
+        _clusterCounts[ i ] = _device->newBuffer( countsSize, MTL::ResourceStorageModeShared );
+        _clusterIndices[ i ] = _device->newBuffer( indicesSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::buildLights() {
+    // a cloud of small lights circling through the cubes, a quarter of them spots
+    std::mt19937 rng( 1 );
+    std::uniform_real_distribution<float> u( 0.f, 1.f );
+
+    _orbits.resize( kLightCount );
+    _lights.resize( kLightCount );
+    for ( size_t i = 0; i < kLightCount; ++i )
+    {
+        LightOrbit& o = _orbits[ i ];
+        o.center = { 0.f, -2.5f + 5.f * u( rng ), -10.f };
+        o.radius = 0.3f + 3.2f * u( rng );
+        o.speed = ( u( rng ) < 0.5f ? -1.f : 1.f ) * ( 2.f + 6.f * u( rng ) );
+        o.phase = 2.f * (float)M_PI * u( rng );
+
+        shader_types::ClusterLight& l = _lights[ i ];
+        l.range = 0.4f + 0.6f * u( rng );
+        l.color = { 0.2f + 0.8f * u( rng ), 0.2f + 0.8f * u( rng ), 0.2f + 0.8f * u( rng ) };
+        l.direction = { 0.f, 0.f, -1.f };
+        l.spotCosOuter = -1.f;
+        l.spotCosInner = -1.f;
+        if ( i % 4 == 0 )
+        {
+            l.range *= 2.f;
+            l.spotCosOuter = cosf( 0.5f );
+            l.spotCosInner = cosf( 0.35f );
+        }
+    }
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
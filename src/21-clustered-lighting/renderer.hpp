@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include <vector>
+
+#include "job_system.hpp"
+#include "light_clusters.hpp"
+#include "shader_types.hpp"
+
+class Renderer {
+private:
+    // orbit of one light around the cubes, the lights are placed from these every frame
+    struct LightOrbit
+    {
+        simd::float3 center;
+        float radius;
+        float speed;
+        float phase;
+    };
+
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _PSO;
+    MTL::ComputePipelineState* _binningPSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+
+    // per frame in flight, so binning a frame never waits for the last one's shading
+    MTL::Buffer* _lightBuffer[3];
+    MTL::Buffer* _clusterCounts[3];
+    MTL::Buffer* _clusterIndices[3];
+
+    bool _cpuBinning;
+    JobSystem _jobs;
+    LightClusters _clusters;
+    std::vector<LightOrbit> _orbits;
+    std::vector<shader_types::ClusterLight> _lights;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+    void updateLights(MTL::Buffer* lightBuffer);
+    void checkBinning(const shader_types::ClusterGrid& grid, double gpuSeconds);
+
+public:
+    Renderer(MTL::Device* device, bool cpuBinning);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildLights();
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,517 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumCubes = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+// the cubes and a ground slab under them to catch their shadows
+static constexpr size_t kNumInstances = kNumCubes + 1;
+static constexpr float kFovY = 45.f * M_PI / 180.f;
+static constexpr uint32_t kShadowCascades = 4;
+static constexpr uint32_t kShadowResolution = 2048;
+static constexpr float kShadowDistance = 40.f;
+static constexpr float kSplitLambda = 0.75f;
+static constexpr uint64_t kStatsInterval = 300;
+
+Renderer::Renderer(MTL::Device *device)
+: _device(device->retain())
+, _shadowSettings{ kShadowCascades, kShadowResolution, kShadowDistance, kSplitLambda }
+, _visibleCount{}
+, _lightDirection(simd::normalize( (simd::float3){ -1.f, -1.f, -0.8f } ))
+, _cullSeconds(0.0)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+    buildShadowMap();
+
+    _casterX.resize( kNumInstances );
+    _casterY.resize( kNumInstances );
+    _casterZ.resize( kNumInstances );
+    _casterRadius.resize( kNumInstances );
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+        _cameraDataBuffer[i]->release();
+        _visibleBuffer[i]->release();
+    }
+    _indexBuffer->release();
+    _shadowMap->release();
+    _shadowPSO->release();
+    _PSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+    MTL::Buffer* pVisibleBuffer = _visibleBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    ++_frameCount;
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    const shader_types::CameraData& camera = *reinterpret_cast< shader_types::CameraData *>( pCameraDataBuffer->contents() );
+    updateCascades( camera, pVisibleBuffer );
+    encodeShadows( cmd, pInstanceDataBuffer, pVisibleBuffer );
+
+    shader_types::ShadowCascadeData cascadeData[ kMaxShadowCascades ];
+    for ( uint32_t i = 0; i < _shadowSettings.cascadeCount; ++i )
+    {
+        memcpy( &cascadeData[ i ].viewProjection, _cascades[ i ].viewProjection, sizeof( _cascades[ i ].viewProjection ) );
+        cascadeData[ i ].splitFar = _cascades[ i ].splitFar;
+    }
+    shader_types::ShadowData shadowData;
+    shadowData.toLight = camera.worldNormalTransform * -_lightDirection;
+    shadowData.cascadeCount = _shadowSettings.cascadeCount;
+
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder(rpd);
+
+    enc->setRenderPipelineState(_PSO);
+    enc->setDepthStencilState( _depthStencilState );
+
+    enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+    enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+
+    enc->setFragmentBytes( cascadeData, sizeof( cascadeData ), /* index */ 0 );
+    enc->setFragmentBytes( &shadowData, sizeof( shadowData ), /* index */ 1 );
+    enc->setFragmentTexture( _shadowMap, /* index */ 0 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                _indexBuffer,
+                                0,
+                                kNumInstances );
+
+    enc->endEncoding();
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+
+    if ( _frameCount % kStatsInterval == 0 )
+    {
+        for ( uint32_t i = 0; i < _shadowSettings.cascadeCount; ++i )
+        {
+            const ShadowCascade& c = _cascades[ i ];
+            __builtin_printf( "cascade %u: depth %.2f..%.2f, radius %.3f, texel %.4f, %zu of %zu casters\n",
+                              i, c.splitNear, c.splitFar, c.radius, c.texelSize, _visibleCount[ i ], kNumInstances );
+        }
+        __builtin_printf( "fitting and culling %.1f us\n", _cullSeconds * 1e6 );
+    }
+}
+
+void Renderer::updateCascades(const shader_types::CameraData& camera, MTL::Buffer *visibleBuffer) {
+    const auto begin = std::chrono::steady_clock::now();
+
+    const float lightDirection[ 3 ] = { _lightDirection.x, _lightDirection.y, _lightDirection.z };
+    fitShadowCascades( (const float*)&camera.perspectiveTransform, (const float*)&camera.worldTransform,
+                       lightDirection, _shadowSettings, _cascades );
+
+    const ShadowCasters casters = { _casterX.data(), _casterY.data(), _casterZ.data(), _casterRadius.data(), kNumInstances };
+    uint32_t* visible = reinterpret_cast< uint32_t *>( visibleBuffer->contents() );
+    for ( uint32_t i = 0; i < _shadowSettings.cascadeCount; ++i )
+    {
+        _visibleCount[ i ] = cullShadowCasters( _cascades[ i ], casters, visible + i * kNumInstances );
+    }
+
+    _cullSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+}
+
+void Renderer::encodeShadows(MTL::CommandBuffer *cmd, MTL::Buffer *instanceDataBuffer, MTL::Buffer *visibleBuffer) {
+    // a depth only pass per cascade into its slice of the map
+    MTL::RenderPassDescriptor* rpd = MTL::RenderPassDescriptor::alloc()->init();
+    MTL::RenderPassDepthAttachmentDescriptor* depth = rpd->depthAttachment();
+    depth->setTexture( _shadowMap );
+    depth->setLoadAction( MTL::LoadActionClear );
+    depth->setStoreAction( MTL::StoreActionStore );
+    depth->setClearDepth( 1.0 );
+
+    for ( uint32_t i = 0; i < _shadowSettings.cascadeCount; ++i )
+    {
+        depth->setSlice( i );
+        MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder( rpd );
+
+        enc->setRenderPipelineState( _shadowPSO );
+        enc->setDepthStencilState( _depthStencilState );
+
+        // casters between the light and the box are flattened onto its near plane
+        // instead of clipped, the culling leaves them in for that
+        enc->setDepthClipMode( MTL::DepthClipModeClamp );
+        enc->setDepthBias( /* depthBias */ 2.f, /* slopeScale */ 2.f, /* clamp */ 0.01f );
+
+        enc->setCullMode( MTL::CullModeBack );
+        enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+        enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+        enc->setVertexBuffer( instanceDataBuffer, /* offset */ 0, /* index */ 1 );
+        enc->setVertexBuffer( visibleBuffer, /* offset */ i * kNumInstances * sizeof( uint32_t ), /* index */ 2 );
+        enc->setVertexBytes( _cascades[ i ].viewProjection, sizeof( _cascades[ i ].viewProjection ), /* index */ 3 );
+
+        if ( _visibleCount[ i ] > 0 )
+        {
+            enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                        6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                        _indexBuffer,
+                                        0,
+                                        _visibleCount[ i ] );
+        }
+
+        enc->endEncoding();
+    }
+
+    rpd->release();
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    // the half diagonal of a unit cube
+    const float cubeRadius = 0.5f * sqrtf( 3.f );
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumCubes; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        pInstanceData[ i ].instanceTransform = fullObjectRot * translate * yrot * zrot * scale;
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( pInstanceData[ i ].instanceTransform );
+
+        float iDivNumInstances = i / (float)kNumCubes;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+
+        const float4 center = pInstanceData[ i ].instanceTransform.columns[ 3 ];
+        _casterX[ i ] = center.x;
+        _casterY[ i ] = center.y;
+        _casterZ[ i ] = center.z;
+        _casterRadius[ i ] = cubeRadius * scl;
+    }
+
+    // the ground, wide enough to catch the shadows as the cubes turn
+    const float3 groundSize = { 24.f, 0.5f, 24.f };
+    const float3 groundPosition = { 0.f, -4.75f, -10.f };
+    shader_types::InstanceData& ground = pInstanceData[ kNumCubes ];
+    ground.instanceTransform = Math::makeTranslate( groundPosition ) * Math::makeScale( groundSize );
+    ground.instanceNormalTransform = Math::discardTranslation( ground.instanceTransform );
+    ground.instanceColor = (float4){ 0.7f, 0.7f, 0.7f, 1.0f };
+    _casterX[ kNumCubes ] = groundPosition.x;
+    _casterY[ kNumCubes ] = groundPosition.y;
+    _casterZ[ kNumCubes ] = groundPosition.z;
+    _casterRadius[ kNumCubes ] = 0.5f * simd::length( groundSize );
+
+    // the camera looks down at the cubes and sways, shadow edges stay put while it moves
+    const float sway = (float)_frameCount * 0.01f;
+    float4x4 pitch = Math::makeXRotate( 0.25f );
+    float4x4 yaw = Math::makeYRotate( 0.2f * sinf( sway * 0.7f ) );
+    float4x4 eye = Math::makeTranslate( { -0.5f * sinf( sway ), -2.f, -0.5f * cosf( sway * 0.5f ) } );
+
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = Math::makePerspective( kFovY, 1.f, 0.03f, 500.0f ) ;
+    pCameraData->worldTransform = pitch * yaw * eye;
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 worldPosition;
+            float viewDepth;
+            float3 normal;
+            half3 color;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            float4 pos = instanceData[ instanceId ].instanceTransform * float4( vd.position, 1.0 );
+            o.worldPosition = pos.xyz;
+            pos = cameraData.worldTransform * pos;
+            o.viewDepth = -pos.z;
+            o.position = cameraData.perspectiveTransform * pos;
+
+            float3 normal = instanceData[ instanceId ].instanceNormalTransform * vd.normal;
+            o.normal = cameraData.worldNormalTransform * normal;
+
+            o.color = half3( instanceData[ instanceId ].instanceColor.rgb );
+            return o;
+        }
+
+        // depth only, the instances come through the cascade's list of visible casters
+        vertex float4 shadowVertex( device const VertexData* vertexData [[buffer(0)]],
+                                    device const InstanceData* instanceData [[buffer(1)]],
+                                    device const uint* visible [[buffer(2)]],
+                                    constant float4x4& viewProjection [[buffer(3)]],
+                                    uint vertexId [[vertex_id]],
+                                    uint instanceId [[instance_id]] )
+        {
+            const float4 pos = instanceData[ visible[ instanceId ] ].instanceTransform * float4( vertexData[ vertexId ].position, 1.0 );
+            return viewProjection * pos;
+        }
+
+        // 3x3 hardware filtered taps, 1 when lit
+        float shadowFactor( float3 worldPosition, float viewDepth,
+                            constant ShadowCascadeData* cascades, constant ShadowData& shadow,
+                            depth2d_array< float > shadowMap )
+        {
+            uint cascade = 0;
+            while ( cascade < shadow.cascadeCount && viewDepth > cascades[ cascade ].splitFar )
+            {
+                ++cascade;
+            }
+            if ( cascade == shadow.cascadeCount )
+            {
+                return 1.0;
+            }
+
+            const float4 p = cascades[ cascade ].viewProjection * float4( worldPosition, 1.0 );
+            const float2 uv = float2( p.x * 0.5 + 0.5, 0.5 - p.y * 0.5 );
+            const float depth = saturate( p.z );
+
+            constexpr sampler s( coord::normalized, filter::linear, address::clamp_to_edge, compare_func::less_equal );
+            float lit = 0.0;
+            for ( int y = -1; y <= 1; ++y )
+            {
+                for ( int x = -1; x <= 1; ++x )
+                {
+                    lit += shadowMap.sample_compare( s, uv, cascade, depth, int2( x, y ) );
+                }
+            }
+            return lit / 9.0;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]],
+                                     constant ShadowCascadeData* cascades [[buffer(0)]],
+                                     constant ShadowData& shadow [[buffer(1)]],
+                                     depth2d_array< float > shadowMap [[texture(0)]] )
+        {
+            half3 c = in.color;
+
+            float3 l = normalize( shadow.toLight );
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+            if ( ndotl > 0.0 )
+            {
+                ndotl *= half( shadowFactor( in.worldPosition, in.viewDepth, cascades, shadow, shadowMap ) );
+            }
+            c = (c * 0.1) + (c * ndotl);
+            return half4( c, 1.0 );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shader_types::kShadowCascadeDataSource
+                                + shader_types::kShadowDataSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction(NS::String::string("fragmentMain", UTF8StringEncoding));
+    MTL::Function* shadowFn = library->newFunction(NS::String::string("shadowVertex", UTF8StringEncoding));
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    desc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    // no fragment function and no colour, the rasterizer alone writes the depth
+    MTL::RenderPipelineDescriptor* shadowDesc = MTL::RenderPipelineDescriptor::alloc()->init();
+    shadowDesc->setVertexFunction(shadowFn);
+    shadowDesc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth32Float );
+
+    _shadowPSO = _device->newRenderPipelineState(shadowDesc, &error);
+    if(!_shadowPSO) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    shadowFn->release();
+    desc->release();
+    shadowDesc->release();
+    _shaderLibrary = library;
+}
+
+void Renderer::buildBuffers() {
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //   Positions           Normals
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    _vertexDataBuffer = _device->newBuffer( verts, sizeof( verts ), MTL::ResourceStorageModeShared );
+    _indexBuffer = _device->newBuffer( indices, sizeof( indices ), MTL::ResourceStorageModeShared );
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    const size_t visibleSize = kMaxShadowCascades * kNumInstances * sizeof( uint32_t );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+        _visibleBuffer[ i ] = _device->newBuffer( visibleSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::buildShadowMap() {
+    // one slice per cascade, only ever touched by the gpu
+    MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::alloc()->init();
+    pTextureDesc->setWidth( kShadowResolution );
+    pTextureDesc->setHeight( kShadowResolution );
+    pTextureDesc->setArrayLength( kShadowCascades );
+    pTextureDesc->setPixelFormat( MTL::PixelFormatDepth32Float );
+    pTextureDesc->setTextureType( MTL::TextureType2DArray );
+    pTextureDesc->setStorageMode( MTL::StorageModePrivate );
+    pTextureDesc->setUsage( MTL::TextureUsageRenderTarget | MTL::TextureUsageShaderRead );
+
+    _shadowMap = _device->newTexture( pTextureDesc );
+    pTextureDesc->release();
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include <vector>
+
+#include "shader_types.hpp"
+#include "shadow_cascades.hpp"
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _PSO;
+    MTL::RenderPipelineState* _shadowPSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+
+    // every cascade draws its casters through a list of instance indices, one list per
+    // cascade in each buffer
+    MTL::Buffer* _visibleBuffer[3];
+    MTL::Texture* _shadowMap;
+
+    ShadowCascadeSettings _shadowSettings;
+    ShadowCascade _cascades[ kMaxShadowCascades ];
+    size_t _visibleCount[ kMaxShadowCascades ];
+    simd::float3 _lightDirection;
+
+    // caster bounding spheres in world space, rebuilt from the instances every frame
+    std::vector<float> _casterX, _casterY, _casterZ, _casterRadius;
+    double _cullSeconds;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+    void updateCascades(const shader_types::CameraData& camera, MTL::Buffer* visibleBuffer);
+    void encodeShadows(MTL::CommandBuffer* cmd, MTL::Buffer* instanceDataBuffer, MTL::Buffer* visibleBuffer);
+
+public:
+    Renderer(MTL::Device* device);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildShadowMap();
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
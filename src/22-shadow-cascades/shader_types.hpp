@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file           : shader_types.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_SHADER_TYPES_HPP
+#define METAL_PLAYGROUND_SHADER_TYPES_HPP
+
+#include "shader_struct.hpp"
+
+namespace shader_types
+{
+#define VERTEX_DATA_FIELDS( F )                 \
+    F( float3, position )                       \
+    F( float3, normal )
+
+#define INSTANCE_DATA_FIELDS( F )               \
+    F( float4x4, instanceTransform )            \
+    F( float3x3, instanceNormalTransform )      \
+    F( float4, instanceColor )
+
+#define CAMERA_DATA_FIELDS( F )                 \
+    F( float4x4, perspectiveTransform )         \
+    F( float4x4, worldTransform )               \
+    F( float3x3, worldNormalTransform )
+
+    // one per cascade, the fragment shader takes the first whose splitFar is past its depth
+#define SHADOW_CASCADE_DATA_FIELDS( F )         \
+    F( float4x4, viewProjection )               \
+    F( float, splitFar )
+
+    // toLight is in view space like the normals
+#define SHADOW_DATA_FIELDS( F )                 \
+    F( float3, toLight )                        \
+    F( uint, cascadeCount )
+
+    SHADER_STRUCT( VertexData, VERTEX_DATA_FIELDS );
+    SHADER_STRUCT( InstanceData, INSTANCE_DATA_FIELDS );
+    SHADER_STRUCT( CameraData, CAMERA_DATA_FIELDS );
+    SHADER_STRUCT( ShadowCascadeData, SHADOW_CASCADE_DATA_FIELDS );
+    SHADER_STRUCT( ShadowData, SHADOW_DATA_FIELDS );
+}
+
+
+#endif //METAL_PLAYGROUND_SHADER_TYPES_HPP
@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file           : main.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#define NS_PRIVATE_IMPLEMENTATION
+#define MTL_PRIVATE_IMPLEMENTATION
+#define MTK_PRIVATE_IMPLEMENTATION
+#define CA_PRIVATE_IMPLEMENTATION
+#define MTLFX_PRIVATE_IMPLEMENTATION
+
+#include "renderer.hpp"
+#include "delegates.hpp"
+
+int main( int argc, char* argv[] )
+{
+    // frames are rendered at half the view's size and upscaled, --scale picks another size.
+    // --dynamic lets the size follow the gpu time up to that scale, --heavy adds the load
+    RenderOptions options = { 0.5f, false, false };
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( !strcmp( argv[ i ], "--scale" ) && i + 1 < argc )
+        {
+            options.renderScale = strtof( argv[ ++i ], nullptr );
+        }
+        else if ( !strcmp( argv[ i ], "--dynamic" ) )
+        {
+            options.dynamicResolution = true;
+        }
+        else if ( !strcmp( argv[ i ], "--heavy" ) )
+        {
+            options.heavyShading = true;
+        }
+        else
+        {
+            options.renderScale = 0.f;
+        }
+        if ( options.renderScale < 0.25f || options.renderScale > 1.f )
+        {
+            __builtin_printf( "usage: %s [--scale 0.25..1] [--dynamic] [--heavy]\n", argv[ 0 ] );
+            return 1;
+        }
+    }
+
+    std::cout << "temporal upscale";
+
+    NS::AutoreleasePool* autoreleasePool = NS::AutoreleasePool::alloc()->init();
+
+    MyAppDelegate appDelegate( options );
+
+    NS::Application* sharedApplication = NS::Application::sharedApplication();
+    sharedApplication->setDelegate(&appDelegate);
+    sharedApplication->run();
+
+    autoreleasePool->release();
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,564 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr float kFovY = 45.f * M_PI / 180.f;
+static constexpr uint64_t kStatsInterval = 300;
+// dynamic resolution holds 60 fps with some headroom, and never goes below this scale
+static constexpr double kTargetFrameSeconds = 0.9 / 60.0;
+static constexpr float kMinDynamicScale = 0.33f;
+// loop iterations per pixel with heavy shading
+static constexpr uint32_t kHeavyIterations = 512;
+
+static constexpr MTL::PixelFormat kColorFormat = MTL::PixelFormat::PixelFormatRGBA16Float;
+static constexpr MTL::PixelFormat kDepthFormat = MTL::PixelFormat::PixelFormatDepth32Float;
+static constexpr MTL::PixelFormat kMotionFormat = MTL::PixelFormat::PixelFormatRG16Float;
+static constexpr MTL::PixelFormat kOutputFormat = MTL::PixelFormat::PixelFormatRGBA16Float;
+
+Renderer::Renderer(MTL::Device *device, const RenderOptions& options)
+: _device(device->retain())
+, _scaler(nullptr)
+, _colorTexture(nullptr)
+, _depthTexture(nullptr)
+, _motionTexture(nullptr)
+, _upscaledTexture(nullptr)
+, _inputWidth(0)
+, _inputHeight(0)
+, _outputWidth(0)
+, _outputHeight(0)
+, _contentWidth(0)
+, _contentHeight(0)
+, _options(options)
+, _history(kNumInstances)
+, _resolution(makeDynamicResolutionSettings( kTargetFrameSeconds, std::min( kMinDynamicScale, options.renderScale ), options.renderScale ))
+, _gpuSeconds(-1.0)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    if ( !MTLFX::TemporalScalerDescriptor::supportsDevice( _device ) )
+    {
+        __builtin_printf( "MetalFX temporal scaling is not supported on %s\n", _device->name()->utf8String() );
+        assert(false);
+    }
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    releaseTargets();
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+        _cameraDataBuffer[i]->release();
+    }
+    _indexBuffer->release();
+    _presentPSO->release();
+    _PSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        this->_gpuSeconds.store( pCmd->GPUEndTime() - pCmd->GPUStartTime() );
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    ++_frameCount;
+
+    // frames in flight keep the old targets alive, command buffers retain what they use
+    const CGSize drawableSize = view->drawableSize();
+    if ( (uint32_t)drawableSize.width != _outputWidth || (uint32_t)drawableSize.height != _outputHeight )
+    {
+        buildTargets( (uint32_t)drawableSize.width, (uint32_t)drawableSize.height );
+    }
+
+    // the newest gpu time picks the size of this frame, a couple of frames late. the
+    // inputs stay allocated at the largest size, only the part drawn to changes
+    if ( _options.dynamicResolution )
+    {
+        const double gpuSeconds = _gpuSeconds.exchange( -1.0 );
+        if ( gpuSeconds >= 0.0 )
+        {
+            const float scale = _resolution.update( gpuSeconds );
+            _contentWidth = std::clamp( (uint32_t)lroundf( (float)_outputWidth * scale ), 1u, _inputWidth );
+            _contentHeight = std::clamp( (uint32_t)lroundf( (float)_outputHeight * scale ), 1u, _inputHeight );
+        }
+    }
+
+    _jitter.advance();
+    const bool reset = _history.beginFrame( _inputWidth, _inputHeight );
+
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    // the scene at the render size, colour, motion and depth for the scaler
+    MTL::RenderPassDescriptor* scenePass = MTL::RenderPassDescriptor::alloc()->init();
+    MTL::RenderPassColorAttachmentDescriptor* color = scenePass->colorAttachments()->object( 0 );
+    color->setTexture( _colorTexture );
+    color->setLoadAction( MTL::LoadActionClear );
+    color->setStoreAction( MTL::StoreActionStore );
+    color->setClearColor( MTL::ClearColor::Make( 0.1, 0.1, 0.1, 1.0 ) );
+    MTL::RenderPassColorAttachmentDescriptor* motion = scenePass->colorAttachments()->object( 1 );
+    motion->setTexture( _motionTexture );
+    motion->setLoadAction( MTL::LoadActionClear );
+    motion->setStoreAction( MTL::StoreActionStore );
+    motion->setClearColor( MTL::ClearColor::Make( 0.0, 0.0, 0.0, 0.0 ) );
+    MTL::RenderPassDepthAttachmentDescriptor* depth = scenePass->depthAttachment();
+    depth->setTexture( _depthTexture );
+    depth->setLoadAction( MTL::LoadActionClear );
+    depth->setStoreAction( MTL::StoreActionStore );
+    depth->setClearDepth( 1.0 );
+
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder( scenePass );
+    scenePass->release();
+
+    enc->setRenderPipelineState(_PSO);
+    enc->setDepthStencilState( _depthStencilState );
+    enc->setViewport( MTL::Viewport{ 0.0, 0.0, (double)_contentWidth, (double)_contentHeight, 0.0, 1.0 } );
+
+    const uint32_t shadingIterations = _options.heavyShading ? kHeavyIterations : 0;
+    enc->setFragmentBytes( &shadingIterations, sizeof( shadingIterations ), /* index */ 0 );
+
+    enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+    enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                _indexBuffer,
+                                0,
+                                kNumInstances );
+
+    enc->endEncoding();
+
+    // the motion texture is in uv units of the drawn part, the scaler wants pixels
+    if ( _options.dynamicResolution )
+    {
+        _scaler->setInputContentWidth( _contentWidth );
+        _scaler->setInputContentHeight( _contentHeight );
+    }
+    _scaler->setColorTexture( _colorTexture );
+    _scaler->setDepthTexture( _depthTexture );
+    _scaler->setMotionTexture( _motionTexture );
+    _scaler->setOutputTexture( _upscaledTexture );
+    _scaler->setJitterOffsetX( _jitter.x() );
+    _scaler->setJitterOffsetY( _jitter.y() );
+    _scaler->setMotionVectorScaleX( (float)_contentWidth );
+    _scaler->setMotionVectorScaleY( (float)_contentHeight );
+    _scaler->setReset( reset );
+    _scaler->encodeToCommandBuffer( cmd );
+
+    // the upscaled frame onto the drawable, same size so one texel per pixel
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* presentEnc = cmd->renderCommandEncoder( rpd );
+    presentEnc->setRenderPipelineState( _presentPSO );
+    presentEnc->setFragmentTexture( _upscaledTexture, /* index */ 0 );
+    presentEnc->drawPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle, NS::UInteger( 0 ), NS::UInteger( 3 ) );
+    presentEnc->endEncoding();
+
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+
+    if ( _frameCount % kStatsInterval == 0 )
+    {
+        __builtin_printf( "rendering %ux%u, upscaled to %ux%u, jitter phase %u of %u (%.3f, %.3f)",
+                          _contentWidth, _contentHeight, _outputWidth, _outputHeight,
+                          _jitter.phase(), _jitter.phaseCount(), _jitter.x(), _jitter.y() );
+        if ( _options.dynamicResolution )
+        {
+            __builtin_printf( ", scale %.3f for %.2f ms on the gpu against %.2f ms",
+                              _resolution.scale(), _resolution.filteredSeconds() * 1e3, kTargetFrameSeconds * 1e3 );
+        }
+        __builtin_printf( "\n" );
+    }
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        const float4x4 transform = fullObjectRot * translate * yrot * zrot * scale;
+        _history.setTransform( i, (const float*)&transform );
+
+        pInstanceData[ i ].instanceTransform = transform;
+        memcpy( &pInstanceData[ i ].previousInstanceTransform, _history.previousTransform( i ), sizeof( float4x4 ) );
+        pInstanceData[ i ].instanceNormalTransform = Math::discardTranslation( transform );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ i ].instanceColor = (float4){ r, g, b, 1.0f };
+    }
+
+    // the camera sways, so still cubes have motion too
+    const float sway = (float)_frameCount * 0.01f;
+    const float4x4 world = Math::makeYRotate( 0.3f * sinf( sway ) ) * Math::makeTranslate( { 0.5f * sinf( sway * 0.7f ), 0.f, 0.f } );
+    const float4x4 perspective = Math::makePerspective( kFovY, (float)_outputWidth / (float)_outputHeight, 0.03f, 500.0f );
+    const float4x4 viewProjection = perspective * world;
+    _history.setViewProjection( (const float*)&viewProjection );
+
+    float4x4 jittered = perspective;
+    _jitter.apply( (float*)&jittered, _contentWidth, _contentHeight );
+
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = jittered;
+    pCameraData->worldTransform = world;
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+    pCameraData->viewProjection = viewProjection;
+    memcpy( &pCameraData->previousViewProjection, _history.previousViewProjection(), sizeof( float4x4 ) );
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float4 currentClip;
+            float4 previousClip;
+            float3 normal;
+            half3 color;
+        };
+
+        struct FragmentOut
+        {
+            half4 color [[color(0)]];
+            float2 motion [[color(1)]];
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            const device InstanceData& instance = instanceData[ instanceId ];
+            const float4 pos = float4( vd.position, 1.0 );
+            o.position = cameraData.perspectiveTransform * cameraData.worldTransform * instance.instanceTransform * pos;
+
+            // both without the jitter, it is not motion
+            o.currentClip = cameraData.viewProjection * instance.instanceTransform * pos;
+            o.previousClip = cameraData.previousViewProjection * instance.previousInstanceTransform * pos;
+
+            float3 normal = instance.instanceNormalTransform * vd.normal;
+            o.normal = cameraData.worldNormalTransform * normal;
+
+            o.color = half3( instance.instanceColor.rgb );
+            return o;
+        }
+
+        FragmentOut fragment fragmentMain( v2f in [[stage_in]],
+                                           constant uint& shadingIterations [[buffer(0)]] )
+        {
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            // a mandelbrot orbit per pixel, work that grows with the pixels drawn
+            float2 z = float2( 0.0 );
+            const float2 c = in.normal.xy * 0.6 - float2( 0.5, 0.0 );
+            uint i = 0;
+            for ( ; i < shadingIterations && dot( z, z ) < 4.0; ++i )
+            {
+                z = float2( z.x * z.x - z.y * z.y, 2.0 * z.x * z.y ) + c;
+            }
+            const half detail = shadingIterations > 0 ? half( 0.8 + 0.2 * float( i ) / float( shadingIterations ) ) : 1.0;
+
+            FragmentOut o;
+            o.color = half4( ( (in.color * 0.1) + (in.color * ndotl) ) * detail, 1.0 );
+            o.motion = motionVector( in.currentClip, in.previousClip );
+            return o;
+        }
+
+        struct PresentV2f
+        {
+            float4 position [[position]];
+            float2 uv;
+        };
+
+        // one triangle over the whole target
+        PresentV2f vertex presentVertex( uint vertexId [[vertex_id]] )
+        {
+            PresentV2f o;
+            o.uv = float2( ( vertexId << 1 ) & 2, vertexId & 2 );
+            o.position = float4( o.uv * float2( 2.0, -2.0 ) + float2( -1.0, 1.0 ), 0.0, 1.0 );
+            return o;
+        }
+
+        half4 fragment presentFragment( PresentV2f in [[stage_in]],
+                                        texture2d< half, access::sample > upscaled [[texture(0)]] )
+        {
+            constexpr sampler s( address::clamp_to_edge, filter::nearest );
+            return upscaled.sample( s, in.uv );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + kMotionVectorSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction(NS::String::string("fragmentMain", UTF8StringEncoding));
+    MTL::Function* presentVertexFn = library->newFunction(NS::String::string("presentVertex", UTF8StringEncoding));
+    MTL::Function* presentFragFn = library->newFunction(NS::String::string("presentFragment", UTF8StringEncoding));
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat( kColorFormat );
+    desc->colorAttachments()->object(1)->setPixelFormat( kMotionFormat );
+    desc->setDepthAttachmentPixelFormat( kDepthFormat );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::RenderPipelineDescriptor* presentDesc = MTL::RenderPipelineDescriptor::alloc()->init();
+    presentDesc->setVertexFunction(presentVertexFn);
+    presentDesc->setFragmentFunction(presentFragFn);
+    presentDesc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    presentDesc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _presentPSO = _device->newRenderPipelineState(presentDesc, &error);
+    if(!_presentPSO) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    presentVertexFn->release();
+    presentFragFn->release();
+    desc->release();
+    presentDesc->release();
+    _shaderLibrary = library;
+}
+
+void Renderer::buildBuffers() {
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //   Positions           Normals
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    _vertexDataBuffer = _device->newBuffer( verts, sizeof( verts ), MTL::ResourceStorageModeShared );
+    _indexBuffer = _device->newBuffer( indices, sizeof( indices ), MTL::ResourceStorageModeShared );
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::releaseTargets() {
+    if ( !_scaler )
+    {
+        return;
+    }
+    _scaler->release();
+    _colorTexture->release();
+    _depthTexture->release();
+    _motionTexture->release();
+    _upscaledTexture->release();
+    _scaler = nullptr;
+}
+
+void Renderer::buildTargets(uint32_t outputWidth, uint32_t outputHeight) {
+    releaseTargets();
+
+    _outputWidth = outputWidth;
+    _outputHeight = outputHeight;
+    _inputWidth = std::max( 1u, (uint32_t)lroundf( (float)outputWidth * _options.renderScale ) );
+    _inputHeight = std::max( 1u, (uint32_t)lroundf( (float)outputHeight * _options.renderScale ) );
+    _contentWidth = _inputWidth;
+    _contentHeight = _inputHeight;
+
+    MTLFX::TemporalScalerDescriptor* scalerDesc = MTLFX::TemporalScalerDescriptor::alloc()->init();
+    scalerDesc->setColorTextureFormat( kColorFormat );
+    scalerDesc->setDepthTextureFormat( kDepthFormat );
+    scalerDesc->setMotionTextureFormat( kMotionFormat );
+    scalerDesc->setOutputTextureFormat( kOutputFormat );
+    scalerDesc->setInputWidth( _inputWidth );
+    scalerDesc->setInputHeight( _inputHeight );
+    scalerDesc->setOutputWidth( _outputWidth );
+    scalerDesc->setOutputHeight( _outputHeight );
+    if ( _options.dynamicResolution )
+    {
+        // metalfx scales are output over content size: the smallest is with the whole
+        // inputs drawn, the largest with the scale the controller stops at
+        scalerDesc->setInputContentPropertiesEnabled( true );
+        scalerDesc->setInputContentMinScale( 1.f / _options.renderScale );
+        scalerDesc->setInputContentMaxScale( 1.f / _resolution.settings().minScale );
+    }
+
+    _scaler = scalerDesc->newTemporalScaler( _device );
+    scalerDesc->release();
+    if ( !_scaler )
+    {
+        __builtin_printf( "failed to create a temporal scaler from %ux%u to %ux%u\n", _inputWidth, _inputHeight, _outputWidth, _outputHeight );
+        assert(false);
+    }
+
+    // the scaler says how it uses each texture, the passes around it add theirs
+    auto newTarget = [this]( MTL::PixelFormat format, uint32_t width, uint32_t height, MTL::TextureUsage usage ) {
+        MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::texture2DDescriptor( format, width, height, false );
+        pTextureDesc->setStorageMode( MTL::StorageModePrivate );
+        pTextureDesc->setUsage( usage );
+        return _device->newTexture( pTextureDesc );
+    };
+    _colorTexture = newTarget( kColorFormat, _inputWidth, _inputHeight, _scaler->colorTextureUsage() | MTL::TextureUsageRenderTarget );
+    _depthTexture = newTarget( kDepthFormat, _inputWidth, _inputHeight, _scaler->depthTextureUsage() | MTL::TextureUsageRenderTarget );
+    _motionTexture = newTarget( kMotionFormat, _inputWidth, _inputHeight, _scaler->motionTextureUsage() | MTL::TextureUsageRenderTarget );
+    _upscaledTexture = newTarget( kOutputFormat, _outputWidth, _outputHeight, _scaler->outputTextureUsage() | MTL::TextureUsageShaderRead );
+
+    // the history is for the old size, the next frame starts it over. the jitter has the
+    // phases for the smallest size the frame may be drawn at
+    const float minScale = _options.dynamicResolution ? _resolution.settings().minScale : _options.renderScale;
+    _jitter.reset( std::max( 1u, (uint32_t)lroundf( (float)outputWidth * minScale ) ),
+                   std::max( 1u, (uint32_t)lroundf( (float)outputHeight * minScale ) ),
+                   _outputWidth, _outputHeight );
+    _resolution.reset( _options.renderScale );
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
@@ -0,0 +1,89 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+#include <MetalFX/MetalFX.hpp>
+
+#include <simd/simd.h>
+
+#include <atomic>
+
+#include "dynamic_resolution.hpp"
+#include "shader_types.hpp"
+#include "temporal_upscale.hpp"
+
+struct RenderOptions
+{
+    float renderScale;          // fixed scale, or the largest one with dynamicResolution
+    bool dynamicResolution;     // scale follows the gpu time to hold 60 fps
+    bool heavyShading;          // extra work per pixel, a load only a lower scale helps with
+};
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _PSO;
+    MTL::RenderPipelineState* _presentPSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+
+    // the scene at the largest render size, and MetalFX's output at the view's size.
+    // rebuilt with the scaler when the view is resized
+    MTLFX::TemporalScaler* _scaler;
+    MTL::Texture* _colorTexture;
+    MTL::Texture* _depthTexture;
+    MTL::Texture* _motionTexture;
+    MTL::Texture* _upscaledTexture;
+    uint32_t _inputWidth, _inputHeight;
+    uint32_t _outputWidth, _outputHeight;
+
+    // a frame renders into the top left contentWidth x contentHeight of the inputs
+    uint32_t _contentWidth, _contentHeight;
+
+    RenderOptions _options;
+    TemporalJitter _jitter;
+    MotionHistory _history;
+    DynamicResolution _resolution;
+    std::atomic<double> _gpuSeconds;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    void releaseTargets();
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+
+public:
+    Renderer(MTL::Device* device, const RenderOptions& options);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildTargets(uint32_t outputWidth, uint32_t outputHeight);
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
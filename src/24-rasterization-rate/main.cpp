@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file           : main.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+#include <cstring>
+#include <iostream>
+
+#define NS_PRIVATE_IMPLEMENTATION
+#define MTL_PRIVATE_IMPLEMENTATION
+#define MTK_PRIVATE_IMPLEMENTATION
+#define CA_PRIVATE_IMPLEMENTATION
+
+#include "renderer.hpp"
+#include "delegates.hpp"
+
+int main( int argc, char* argv[] )
+{
+    // the scene is shaded through a rate map from the focus and the content on screen,
+    // --uniform shades every pixel to compare against, --heavy adds work per pixel
+    RenderOptions options = { true, false };
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( !strcmp( argv[ i ], "--uniform" ) )
+        {
+            options.variableRate = false;
+        }
+        else if ( !strcmp( argv[ i ], "--heavy" ) )
+        {
+            options.heavyShading = true;
+        }
+        else
+        {
+            __builtin_printf( "usage: %s [--uniform] [--heavy]\n", argv[ 0 ] );
+            return 1;
+        }
+    }
+
+    std::cout << "rasterization rate";
+
+    NS::AutoreleasePool* autoreleasePool = NS::AutoreleasePool::alloc()->init();
+
+    MyAppDelegate appDelegate( options );
+
+    NS::Application* sharedApplication = NS::Application::sharedApplication();
+    sharedApplication->setDelegate(&appDelegate);
+    sharedApplication->run();
+
+    autoreleasePool->release();
+
+    return 0;
+}
\ No newline at end of file
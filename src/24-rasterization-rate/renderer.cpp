@@ -0,0 +1,544 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "renderer.hpp"
+#include "math.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+static constexpr size_t kMaxFramesInFlight = 3;
+static constexpr size_t kInstanceRows = 10;
+static constexpr size_t kInstanceColumns = 10;
+static constexpr size_t kInstanceDepth = 10;
+static constexpr size_t kNumInstances = (kInstanceRows * kInstanceColumns * kInstanceDepth);
+static constexpr float kFovY = 45.f * M_PI / 180.f;
+static constexpr float kNearZ = 0.03f;
+static constexpr float kFarZ = 500.f;
+static constexpr uint64_t kStatsInterval = 300;
+// zones of the rate map, 16:9 like most screens
+static constexpr uint32_t kRateColumns = 16;
+static constexpr uint32_t kRateRows = 9;
+// loop iterations per pixel with heavy shading
+static constexpr uint32_t kHeavyIterations = 512;
+
+static constexpr MTL::PixelFormat kColorFormat = MTL::PixelFormat::PixelFormatRGBA16Float;
+static constexpr MTL::PixelFormat kDepthFormat = MTL::PixelFormat::PixelFormatDepth32Float;
+
+Renderer::Renderer(MTL::Device *device, const RenderOptions& options)
+: _device(device->retain())
+, _rateMap{}
+, _rateMapDataBuffer{}
+, _colorTexture(nullptr)
+, _depthTexture(nullptr)
+, _screenWidth(0)
+, _screenHeight(0)
+, _options(options)
+, _rates(makeRateMapSettings( kRateColumns, kRateRows ))
+, _cost{}
+, _visibleInstances(0)
+, _gpuSeconds(0.0)
+, _angle(0.f)
+, _frame(0)
+, _frameCount(0) {
+
+    if ( !_device->supportsRasterizationRateMap( 1 ) )
+    {
+        __builtin_printf( "rasterization rate maps are not supported on %s\n", _device->name()->utf8String() );
+        assert(false);
+    }
+
+    _commandQueue = _device->newCommandQueue();
+    buildShaders();
+    buildDepthStencilStates();
+    buildBuffers();
+
+    _semaphore = dispatch_semaphore_create(kMaxFramesInFlight);
+}
+
+Renderer::~Renderer() {
+    releaseTargets();
+    _shaderLibrary->release();
+    _depthStencilState->release();
+    _vertexDataBuffer->release();
+    for ( int i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[i]->release();
+        _cameraDataBuffer[i]->release();
+        if ( _rateMap[i] )
+        {
+            _rateMap[i]->release();
+            _rateMapDataBuffer[i]->release();
+        }
+    }
+    _indexBuffer->release();
+    _presentPSO->release();
+    _PSO->release();
+    _commandQueue->release();
+    _device->release();
+}
+
+void Renderer::draw(MTK::View *view) {
+    NS::AutoreleasePool* pool = NS::AutoreleasePool::alloc()->init();
+
+    _frame = (_frame + 1) % kMaxFramesInFlight;
+    MTL::Buffer* pInstanceDataBuffer = _instanceDataBuffer[ _frame ];
+    MTL::Buffer* pCameraDataBuffer = _cameraDataBuffer[ _frame ];
+
+    MTL::CommandBuffer* cmd = _commandQueue->commandBuffer();
+    dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+    cmd->addCompletedHandler(^void(MTL::CommandBuffer* pCmd) {
+        this->_gpuSeconds.store( pCmd->GPUEndTime() - pCmd->GPUStartTime() );
+        dispatch_semaphore_signal(this->_semaphore);
+    });
+
+    ++_frameCount;
+
+    // frames in flight keep the old targets alive, command buffers retain what they use
+    const CGSize drawableSize = view->drawableSize();
+    if ( (uint32_t)drawableSize.width != _screenWidth || (uint32_t)drawableSize.height != _screenHeight )
+    {
+        buildTargets( (uint32_t)drawableSize.width, (uint32_t)drawableSize.height );
+    }
+
+    // culling adds what is left of the scene to the map's content, the focus wanders
+    // over the screen the way a gaze would
+    _rates.beginFrame( _screenWidth, _screenHeight );
+    _angle += 0.002f;
+    updateInstances( pInstanceDataBuffer, pCameraDataBuffer );
+
+    const float focusU = 0.5f + 0.25f * cosf( (float)_frameCount * 0.013f );
+    const float focusV = 0.5f + 0.2f * sinf( (float)_frameCount * 0.021f );
+    buildRateMap( _frame, focusU, focusV );
+
+    // the scene in physical pixels, the top left of the targets the map says
+    MTL::RenderPassDescriptor* scenePass = MTL::RenderPassDescriptor::alloc()->init();
+    MTL::RenderPassColorAttachmentDescriptor* color = scenePass->colorAttachments()->object( 0 );
+    color->setTexture( _colorTexture );
+    color->setLoadAction( MTL::LoadActionClear );
+    color->setStoreAction( MTL::StoreActionStore );
+    color->setClearColor( MTL::ClearColor::Make( 0.1, 0.1, 0.1, 1.0 ) );
+    MTL::RenderPassDepthAttachmentDescriptor* depth = scenePass->depthAttachment();
+    depth->setTexture( _depthTexture );
+    depth->setLoadAction( MTL::LoadActionClear );
+    depth->setStoreAction( MTL::StoreActionDontCare );
+    depth->setClearDepth( 1.0 );
+    scenePass->setRasterizationRateMap( _rateMap[ _frame ] );
+
+    MTL::RenderCommandEncoder* enc = cmd->renderCommandEncoder( scenePass );
+    scenePass->release();
+
+    // the viewport is in screen pixels, the map takes it to physical ones
+    enc->setRenderPipelineState(_PSO);
+    enc->setDepthStencilState( _depthStencilState );
+    enc->setViewport( MTL::Viewport{ 0.0, 0.0, (double)_screenWidth, (double)_screenHeight, 0.0, 1.0 } );
+
+    const uint32_t shadingIterations = _options.heavyShading ? kHeavyIterations : 0;
+    enc->setFragmentBytes( &shadingIterations, sizeof( shadingIterations ), /* index */ 0 );
+
+    enc->setVertexBuffer( _vertexDataBuffer, /* offset */ 0, /* index */ 0 );
+    enc->setVertexBuffer( pInstanceDataBuffer, /* offset */ 0, /* index */ 1 );
+    enc->setVertexBuffer( pCameraDataBuffer, /* offset */ 0, /* index */ 2 );
+
+    enc->setCullMode( MTL::CullModeBack );
+    enc->setFrontFacingWinding( MTL::Winding::WindingCounterClockwise );
+
+    if ( _visibleInstances > 0 )
+    {
+        enc->drawIndexedPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle,
+                                    6 * 6, MTL::IndexType::IndexTypeUInt16,
+                                    _indexBuffer,
+                                    0,
+                                    _visibleInstances );
+    }
+
+    enc->endEncoding();
+
+    // every screen pixel finds its physical one through the map's parameters
+    MTL::RenderPassDescriptor* rpd = view->currentRenderPassDescriptor();
+    MTL::RenderCommandEncoder* presentEnc = cmd->renderCommandEncoder( rpd );
+    presentEnc->setRenderPipelineState( _presentPSO );
+    presentEnc->setFragmentTexture( _colorTexture, /* index */ 0 );
+    presentEnc->setFragmentBuffer( _rateMapDataBuffer[ _frame ], /* offset */ 0, /* index */ 0 );
+    presentEnc->drawPrimitives( MTL::PrimitiveType::PrimitiveTypeTriangle, NS::UInteger( 0 ), NS::UInteger( 3 ) );
+    presentEnc->endEncoding();
+
+    cmd->presentDrawable(view->currentDrawable());
+    cmd->commit();
+
+    pool->release();
+
+    if ( _frameCount % kStatsInterval == 0 )
+    {
+        const MTL::Size physical = _rateMap[ _frame ]->physicalSize( 0 );
+        __builtin_printf( "%s: %zu of %zu instances, %lux%lu physical of %ux%u, focus (%.2f, %.2f), "
+                          "the map shades an estimated %.1f%% fewer fragments, %.2f ms on the gpu\n",
+                          _options.variableRate ? "variable rate" : "uniform rate",
+                          _visibleInstances, kNumInstances,
+                          (unsigned long)physical.width, (unsigned long)physical.height, _screenWidth, _screenHeight,
+                          focusU, focusV, _cost.reduction * 100.0, _gpuSeconds.load() * 1e3 );
+    }
+}
+
+void Renderer::buildRateMap(uint32_t frame, float focusU, float focusV) {
+    // the map of this slot was last used frames in flight ago, the semaphore says it is done
+    if ( _rateMap[ frame ] )
+    {
+        _rateMap[ frame ]->release();
+    }
+
+    // the estimate is there with uniform shading too, to hold the gpu times against
+    _rates.build( focusU, focusV );
+    _cost = _rates.estimateCost();
+
+    MTL::RasterizationRateLayerDescriptor* layer = MTL::RasterizationRateLayerDescriptor::alloc()->init( MTL::Size( kRateColumns, kRateRows, 0 ) );
+    float* horizontal = layer->horizontalSampleStorage();
+    float* vertical = layer->verticalSampleStorage();
+    if ( _options.variableRate )
+    {
+        memcpy( horizontal, _rates.horizontal(), kRateColumns * sizeof( float ) );
+        memcpy( vertical, _rates.vertical(), kRateRows * sizeof( float ) );
+    }
+    else
+    {
+        std::fill( horizontal, horizontal + kRateColumns, 1.f );
+        std::fill( vertical, vertical + kRateRows, 1.f );
+    }
+
+    MTL::RasterizationRateMapDescriptor* mapDesc = MTL::RasterizationRateMapDescriptor::rasterizationRateMapDescriptor( MTL::Size( _screenWidth, _screenHeight, 0 ), layer );
+    _rateMap[ frame ] = _device->newRasterizationRateMap( mapDesc );
+    layer->release();
+
+    // the parameters have the same size for every map of this many zones
+    const MTL::SizeAndAlign parameterSize = _rateMap[ frame ]->parameterBufferSizeAndAlign();
+    if ( !_rateMapDataBuffer[ frame ] )
+    {
+        _rateMapDataBuffer[ frame ] = _device->newBuffer( parameterSize.size, MTL::ResourceStorageModeShared );
+    }
+    _rateMap[ frame ]->copyParameterDataToBuffer( _rateMapDataBuffer[ frame ], 0 );
+}
+
+void Renderer::updateInstances(MTL::Buffer *instanceDataBuffer, MTL::Buffer *cameraDataBuffer) {
+    using simd::float3;
+    using simd::float4;
+    using simd::float4x4;
+
+    const float scl = 0.2f;
+    shader_types::InstanceData* pInstanceData = reinterpret_cast< shader_types::InstanceData *>( instanceDataBuffer->contents() );
+
+    float3 objectPosition = { 0.f, 0.f, -10.f };
+
+    float4x4 rt = Math::makeTranslate( objectPosition );
+    float4x4 rr1 = Math::makeYRotate( -_angle );
+    float4x4 rr0 = Math::makeXRotate( _angle * 0.5 );
+    float4x4 rtInv = Math::makeTranslate( { -objectPosition.x, -objectPosition.y, -objectPosition.z } );
+    float4x4 fullObjectRot = rt * rr1 * rr0 * rtInv;
+
+    // the camera sways, so the content moves over the map
+    const float sway = (float)_frameCount * 0.01f;
+    const float4x4 world = Math::makeYRotate( 0.3f * sinf( sway ) ) * Math::makeTranslate( { 1.5f * sinf( sway * 0.7f ), 0.f, 0.f } );
+    const float4x4 perspective = Math::makePerspective( kFovY, (float)_screenWidth / (float)_screenHeight, kNearZ, kFarZ );
+
+    // a cube's bounding sphere against the side planes of the frustum, a plane through
+    // the eye with normal ( xs, 0, 1 ) for x' = xs * x <= -z and the like
+    const float xs = perspective.columns[ 0 ][ 0 ];
+    const float ys = perspective.columns[ 1 ][ 1 ];
+    const float radius = scl * 0.5f * sqrtf( 3.f );
+    const float xPlaneRadius = radius * sqrtf( xs * xs + 1.f );
+    const float yPlaneRadius = radius * sqrtf( ys * ys + 1.f );
+
+    size_t visible = 0;
+    for ( size_t i = 0; i < kNumInstances; ++i )
+    {
+        size_t ix = i % kInstanceRows;
+        size_t iy = ( i / kInstanceRows ) % kInstanceColumns;
+        size_t iz = i / ( kInstanceRows * kInstanceColumns );
+
+        float4x4 scale = Math::makeScale( (float3){ scl, scl, scl } );
+        float4x4 zrot = Math::makeZRotate( _angle * sinf((float)ix) );
+        float4x4 yrot = Math::makeYRotate( _angle * cosf((float)iy));
+
+        float x = ((float)ix - (float)kInstanceRows/2.f) * (2.f * scl) + scl;
+        float y = ((float)iy - (float)kInstanceColumns/2.f) * (2.f * scl) + scl;
+        float z = ((float)iz - (float)kInstanceDepth/2.f) * (2.f * scl);
+        float4x4 translate = Math::makeTranslate( Math::add( objectPosition, { x, y, z } ) );
+
+        const float4x4 transform = fullObjectRot * translate * yrot * zrot * scale;
+        const float4 center = world * transform.columns[ 3 ];
+        const float distance = -center.z;
+        if ( distance < kNearZ - radius || distance > kFarZ + radius ||
+             xs * center.x + center.z > xPlaneRadius || -xs * center.x + center.z > xPlaneRadius ||
+             ys * center.y + center.z > yPlaneRadius || -ys * center.y + center.z > yPlaneRadius )
+        {
+            continue;
+        }
+
+        // the sphere's extent on screen, widened to the nearest point so it stays
+        // conservative. a sphere around the eye covers it all
+        if ( distance > radius )
+        {
+            const float u = xs * center.x / distance * 0.5f + 0.5f;
+            const float v = 0.5f - ys * center.y / distance * 0.5f;
+            const float extentU = xs * radius / ( distance - radius ) * 0.5f;
+            const float extentV = ys * radius / ( distance - radius ) * 0.5f;
+            _rates.addContent( u - extentU, v - extentV, u + extentU, v + extentV, 1.f );
+        }
+        else
+        {
+            _rates.addContent( 0.f, 0.f, 1.f, 1.f, 1.f );
+        }
+
+        pInstanceData[ visible ].instanceTransform = transform;
+        pInstanceData[ visible ].instanceNormalTransform = Math::discardTranslation( transform );
+
+        float iDivNumInstances = i / (float)kNumInstances;
+        float r = iDivNumInstances;
+        float g = 1.0f - r;
+        float b = sinf( M_PI * 2.0f * iDivNumInstances );
+        pInstanceData[ visible ].instanceColor = (float4){ r, g, b, 1.0f };
+        ++visible;
+    }
+    _visibleInstances = visible;
+
+    shader_types::CameraData* pCameraData = reinterpret_cast< shader_types::CameraData *>( cameraDataBuffer->contents() );
+    pCameraData->perspectiveTransform = perspective;
+    pCameraData->worldTransform = world;
+    pCameraData->worldNormalTransform = Math::discardTranslation( pCameraData->worldTransform );
+}
+
+void Renderer::buildShaders() {
+    using NS::StringEncoding::UTF8StringEncoding;
+
+    const char* shaderBody = R"(
+        struct v2f
+        {
+            float4 position [[position]];
+            float3 normal;
+            half3 color;
+        };
+
+        v2f vertex vertexMain( device const VertexData* vertexData [[buffer(0)]],
+                               device const InstanceData* instanceData [[buffer(1)]],
+                               device const CameraData& cameraData [[buffer(2)]],
+                               uint vertexId [[vertex_id]],
+                               uint instanceId [[instance_id]] )
+        {
+            v2f o;
+
+            const device VertexData& vd = vertexData[ vertexId ];
+            const device InstanceData& instance = instanceData[ instanceId ];
+            const float4 pos = float4( vd.position, 1.0 );
+            o.position = cameraData.perspectiveTransform * cameraData.worldTransform * instance.instanceTransform * pos;
+
+            float3 normal = instance.instanceNormalTransform * vd.normal;
+            o.normal = cameraData.worldNormalTransform * normal;
+
+            o.color = half3( instance.instanceColor.rgb );
+            return o;
+        }
+
+        half4 fragment fragmentMain( v2f in [[stage_in]],
+                                     constant uint& shadingIterations [[buffer(0)]] )
+        {
+            // assume light coming from (front-top-right)
+            float3 l = normalize(float3( 1.0, 1.0, 0.8 ));
+            float3 n = normalize( in.normal );
+
+            half ndotl = half( saturate( dot( n, l ) ) );
+
+            // a mandelbrot orbit per pixel, work that grows with the fragments shaded
+            float2 z = float2( 0.0 );
+            const float2 c = in.normal.xy * 0.6 - float2( 0.5, 0.0 );
+            uint i = 0;
+            for ( ; i < shadingIterations && dot( z, z ) < 4.0; ++i )
+            {
+                z = float2( z.x * z.x - z.y * z.y, 2.0 * z.x * z.y ) + c;
+            }
+            const half detail = shadingIterations > 0 ? half( 0.8 + 0.2 * float( i ) / float( shadingIterations ) ) : 1.0;
+
+            return half4( ( (in.color * 0.1) + (in.color * ndotl) ) * detail, 1.0 );
+        }
+
+        struct PresentV2f
+        {
+            float4 position [[position]];
+        };
+
+        // one triangle over the whole target
+        PresentV2f vertex presentVertex( uint vertexId [[vertex_id]] )
+        {
+            PresentV2f o;
+            const float2 uv = float2( ( vertexId << 1 ) & 2, vertexId & 2 );
+            o.position = float4( uv * float2( 2.0, -2.0 ) + float2( -1.0, 1.0 ), 0.0, 1.0 );
+            return o;
+        }
+
+        // the position is the screen pixel's centre, the decoder finds where the map put it
+        half4 fragment presentFragment( PresentV2f in [[stage_in]],
+                                        texture2d< half, access::sample > scene [[texture(0)]],
+                                        constant rasterization_rate_map_data& rateMapData [[buffer(0)]] )
+        {
+            constexpr sampler s( coord::pixel, address::clamp_to_edge, filter::linear );
+            rasterization_rate_map_decoder decoder( rateMapData );
+            const float2 physical = decoder.map_screen_to_physical_coordinates( in.position.xy );
+            return scene.sample( s, physical );
+        }
+    )";
+
+    const std::string shaderSrc = std::string( "#include <metal_stdlib>\nusing namespace metal;\n" )
+                                + shader_types::kVertexDataSource
+                                + shader_types::kInstanceDataSource
+                                + shader_types::kCameraDataSource
+                                + shaderBody;
+
+    NS::Error* error = nullptr;
+    MTL::Library* library = _device->newLibrary(NS::String::string(shaderSrc.c_str(), UTF8StringEncoding), nullptr, &error);
+    if(!library) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::Function* vertexFn = library->newFunction(NS::String::string("vertexMain", UTF8StringEncoding));
+    MTL::Function* fragFn = library->newFunction(NS::String::string("fragmentMain", UTF8StringEncoding));
+    MTL::Function* presentVertexFn = library->newFunction(NS::String::string("presentVertex", UTF8StringEncoding));
+    MTL::Function* presentFragFn = library->newFunction(NS::String::string("presentFragment", UTF8StringEncoding));
+
+    MTL::RenderPipelineDescriptor* desc = MTL::RenderPipelineDescriptor::alloc()->init();
+    desc->setVertexFunction(vertexFn);
+    desc->setFragmentFunction(fragFn);
+    desc->colorAttachments()->object(0)->setPixelFormat( kColorFormat );
+    desc->setDepthAttachmentPixelFormat( kDepthFormat );
+
+    _PSO = _device->newRenderPipelineState(desc, &error);
+    if(!_PSO) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    MTL::RenderPipelineDescriptor* presentDesc = MTL::RenderPipelineDescriptor::alloc()->init();
+    presentDesc->setVertexFunction(presentVertexFn);
+    presentDesc->setFragmentFunction(presentFragFn);
+    presentDesc->colorAttachments()->object(0)->setPixelFormat(MTL::PixelFormat::PixelFormatBGRA8Unorm_sRGB);
+    presentDesc->setDepthAttachmentPixelFormat( MTL::PixelFormat::PixelFormatDepth16Unorm );
+
+    _presentPSO = _device->newRenderPipelineState(presentDesc, &error);
+    if(!_presentPSO) {
+        __builtin_printf("%s", error->localizedDescription()->utf8String());
+        assert(false);
+    }
+
+    vertexFn->release();
+    fragFn->release();
+    presentVertexFn->release();
+    presentFragFn->release();
+    desc->release();
+    presentDesc->release();
+    _shaderLibrary = library;
+}
+
+void Renderer::buildBuffers() {
+    using simd::float3;
+
+    const float s = 0.5f;
+
+    shader_types::VertexData verts[] = {
+        //   Positions           Normals
+        { { -s, -s, +s }, {  0.f,  0.f,  1.f } },
+        { { +s, -s, +s }, {  0.f,  0.f,  1.f } },
+        { { +s, +s, +s }, {  0.f,  0.f,  1.f } },
+        { { -s, +s, +s }, {  0.f,  0.f,  1.f } },
+
+        { { +s, -s, +s }, {  1.f,  0.f,  0.f } },
+        { { +s, -s, -s }, {  1.f,  0.f,  0.f } },
+        { { +s, +s, -s }, {  1.f,  0.f,  0.f } },
+        { { +s, +s, +s }, {  1.f,  0.f,  0.f } },
+
+        { { +s, -s, -s }, {  0.f,  0.f, -1.f } },
+        { { -s, -s, -s }, {  0.f,  0.f, -1.f } },
+        { { -s, +s, -s }, {  0.f,  0.f, -1.f } },
+        { { +s, +s, -s }, {  0.f,  0.f, -1.f } },
+
+        { { -s, -s, -s }, { -1.f,  0.f,  0.f } },
+        { { -s, -s, +s }, { -1.f,  0.f,  0.f } },
+        { { -s, +s, +s }, { -1.f,  0.f,  0.f } },
+        { { -s, +s, -s }, { -1.f,  0.f,  0.f } },
+
+        { { -s, +s, +s }, {  0.f,  1.f,  0.f } },
+        { { +s, +s, +s }, {  0.f,  1.f,  0.f } },
+        { { +s, +s, -s }, {  0.f,  1.f,  0.f } },
+        { { -s, +s, -s }, {  0.f,  1.f,  0.f } },
+
+        { { -s, -s, -s }, {  0.f, -1.f,  0.f } },
+        { { +s, -s, -s }, {  0.f, -1.f,  0.f } },
+        { { +s, -s, +s }, {  0.f, -1.f,  0.f } },
+        { { -s, -s, +s }, {  0.f, -1.f,  0.f } }
+    };
+
+    uint16_t indices[] = {
+         0,  1,  2,  2,  3,  0, /* front */
+         4,  5,  6,  6,  7,  4, /* right */
+         8,  9, 10, 10, 11,  8, /* back */
+        12, 13, 14, 14, 15, 12, /* left */
+        16, 17, 18, 18, 19, 16, /* top */
+        20, 21, 22, 22, 23, 20, /* bottom */
+    };
+
+    _vertexDataBuffer = _device->newBuffer( verts, sizeof( verts ), MTL::ResourceStorageModeShared );
+    _indexBuffer = _device->newBuffer( indices, sizeof( indices ), MTL::ResourceStorageModeShared );
+
+    const size_t instanceDataSize = kNumInstances * sizeof( shader_types::InstanceData );
+    const size_t cameraDataSize = sizeof( shader_types::CameraData );
+    for ( size_t i = 0; i < kMaxFramesInFlight; ++i )
+    {
+        _instanceDataBuffer[ i ] = _device->newBuffer( instanceDataSize, MTL::ResourceStorageModeShared );
+        _cameraDataBuffer[ i ] = _device->newBuffer( cameraDataSize, MTL::ResourceStorageModeShared );
+    }
+}
+
+void Renderer::releaseTargets() {
+    if ( !_colorTexture )
+    {
+        return;
+    }
+    _colorTexture->release();
+    _depthTexture->release();
+    _colorTexture = nullptr;
+}
+
+void Renderer::buildTargets(uint32_t screenWidth, uint32_t screenHeight) {
+    releaseTargets();
+
+    _screenWidth = screenWidth;
+    _screenHeight = screenHeight;
+
+    // a map with every rate at 1 renders into all of it
+    auto newTarget = [this]( MTL::PixelFormat format, MTL::TextureUsage usage ) {
+        MTL::TextureDescriptor* pTextureDesc = MTL::TextureDescriptor::texture2DDescriptor( format, _screenWidth, _screenHeight, false );
+        pTextureDesc->setStorageMode( MTL::StorageModePrivate );
+        pTextureDesc->setUsage( usage );
+        return _device->newTexture( pTextureDesc );
+    };
+    _colorTexture = newTarget( kColorFormat, MTL::TextureUsageRenderTarget | MTL::TextureUsageShaderRead );
+    _depthTexture = newTarget( kDepthFormat, MTL::TextureUsageRenderTarget );
+}
+
+void Renderer::buildDepthStencilStates() {
+    MTL::DepthStencilDescriptor* pDsDesc = MTL::DepthStencilDescriptor::alloc()->init();
+    pDsDesc->setDepthCompareFunction( MTL::CompareFunction::CompareFunctionLess );
+    pDsDesc->setDepthWriteEnabled( true );
+
+    _depthStencilState = _device->newDepthStencilState( pDsDesc );
+
+    pDsDesc->release();
+}
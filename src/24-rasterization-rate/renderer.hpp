@@ -0,0 +1,85 @@
+/**
+  ******************************************************************************
+  * @file           : renderer.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_RENDERER_HPP
+#define METAL_PLAYGROUND_RENDERER_HPP
+
+#include <Metal/Metal.hpp>
+#include <AppKit/AppKit.hpp>
+#include <MetalKit/MetalKit.hpp>
+
+#include <simd/simd.h>
+
+#include <atomic>
+
+#include "rasterization_rate.hpp"
+#include "shader_types.hpp"
+
+struct RenderOptions
+{
+    bool variableRate;          // shade through the rate map, or every pixel at full rate
+    bool heavyShading;          // extra work per pixel, what a lower rate saves on
+};
+
+class Renderer {
+private:
+    MTL::Device* _device;
+    MTL::CommandQueue* _commandQueue;
+    MTL::Library* _shaderLibrary;
+    MTL::RenderPipelineState* _PSO;
+    MTL::RenderPipelineState* _presentPSO;
+    MTL::DepthStencilState* _depthStencilState;
+
+    MTL::Buffer* _vertexDataBuffer;
+    MTL::Buffer* _instanceDataBuffer[3];
+    MTL::Buffer* _cameraDataBuffer[3];
+    MTL::Buffer* _indexBuffer;
+
+    // a rate map per frame in flight, maps are immutable so every frame makes its own.
+    // the parameter buffers let the present pass map screen pixels into the scene
+    MTL::RasterizationRateMap* _rateMap[3];
+    MTL::Buffer* _rateMapDataBuffer[3];
+
+    // the scene at the view's size, the largest a rate map renders into. rebuilt when
+    // the view is resized
+    MTL::Texture* _colorTexture;
+    MTL::Texture* _depthTexture;
+    uint32_t _screenWidth, _screenHeight;
+
+    RenderOptions _options;
+    RateMapBuilder _rates;
+    ShadingCost _cost;
+    size_t _visibleInstances;
+    std::atomic<double> _gpuSeconds;
+
+    float _angle;
+    int _frame;
+    uint64_t _frameCount;
+    dispatch_semaphore_t _semaphore;
+
+    void releaseTargets();
+    void buildRateMap(uint32_t frame, float focusU, float focusV);
+    void updateInstances(MTL::Buffer* instanceDataBuffer, MTL::Buffer* cameraDataBuffer);
+
+public:
+    Renderer(MTL::Device* device, const RenderOptions& options);
+    ~Renderer();
+
+    void buildShaders();
+    void buildBuffers();
+    void buildTargets(uint32_t screenWidth, uint32_t screenHeight);
+    void buildDepthStencilStates();
+    void draw(MTK::View* view);
+};
+
+
+#endif //METAL_PLAYGROUND_RENDERER_HPP
@@ -0,0 +1,44 @@
+/**
+  ******************************************************************************
+  * @file           : check.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_CHECK_HPP
+#define METAL_PLAYGROUND_CHECK_HPP
+
+#include <cstdio>
+
+// the tests are plain executables run by ctest: every failed check is reported and
+// counted, main returns checkResult() so any failure fails the test.
+inline int g_checkFailures = 0;
+
+#define CHECK( condition )                                                                  \
+    do                                                                                      \
+    {                                                                                       \
+        if ( !( condition ) )                                                               \
+        {                                                                                   \
+            __builtin_printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition ); \
+            ++g_checkFailures;                                                              \
+        }                                                                                   \
+    } while ( 0 )
+
+inline int checkResult()
+{
+    if ( g_checkFailures )
+    {
+        __builtin_printf( "%d checks failed\n", g_checkFailures );
+        return 1;
+    }
+    __builtin_printf( "all checks passed\n" );
+    return 0;
+}
+
+
+#endif //METAL_PLAYGROUND_CHECK_HPP
@@ -0,0 +1,19 @@
+/**
+  ******************************************************************************
+  * @file           : CoreFoundation.h
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_OBJC_STUB_CORE_FOUNDATION_H
+#define METAL_PLAYGROUND_OBJC_STUB_CORE_FOUNDATION_H
+
+// Foundation/NSTypes.hpp includes it, nothing the stubbed headers use comes from it
+
+
+#endif //METAL_PLAYGROUND_OBJC_STUB_CORE_FOUNDATION_H
@@ -0,0 +1,24 @@
+/**
+  ******************************************************************************
+  * @file           : message.h
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_OBJC_STUB_MESSAGE_H
+#define METAL_PLAYGROUND_OBJC_STUB_MESSAGE_H
+
+#include "runtime.h"
+
+// declared without arguments like the sdk's, callers cast them to the method's type
+extern "C" void objc_msgSend( void );
+extern "C" void objc_msgSend_fpret( void );
+extern "C" void objc_msgSend_stret( void );
+
+
+#endif //METAL_PLAYGROUND_OBJC_STUB_MESSAGE_H
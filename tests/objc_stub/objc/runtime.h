@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file           : runtime.h
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_OBJC_STUB_RUNTIME_H
+#define METAL_PLAYGROUND_OBJC_STUB_RUNTIME_H
+
+#include <cstddef>
+
+// the part of the objc runtime metal-cpp's private headers call, for testing them
+// where there is no objc runtime. objc_stub.cpp implements it.
+typedef struct objc_selector* SEL;
+typedef struct objc_class* Class;
+typedef struct objc_object* id;
+typedef struct objc_object Protocol;
+typedef void (*IMP)( void );
+
+// every object starts with its class, like the runtime's
+struct objc_object
+{
+    Class isa;
+};
+
+extern "C" SEL sel_registerName( const char* name );
+extern "C" Class objc_lookUpClass( const char* name );
+extern "C" Protocol* objc_getProtocol( const char* name );
+extern "C" bool class_addMethod( Class cls, SEL selector, IMP imp, const char* types );
+extern "C" Class object_getClass( id object );
+extern "C" IMP class_getMethodImplementation( Class cls, SEL selector );
+extern "C" bool class_respondsToSelector( Class cls, SEL selector );
+
+
+#endif //METAL_PLAYGROUND_OBJC_STUB_RUNTIME_H
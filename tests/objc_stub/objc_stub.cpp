@@ -0,0 +1,245 @@
+/**
+  ******************************************************************************
+  * @file           : objc_stub.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "objc_stub.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// selectors, classes and protocols are interned by name, the same name always gives
+// the same pointer like in the runtime. a class is also an object, its isa unused
+struct objc_class
+{
+    objc_object object;
+    std::string name;
+    std::unordered_map<SEL, IMP> methods;
+};
+
+namespace
+{
+    struct Name
+    {
+        std::string name;
+    };
+
+    // the runtime is called from static initializers, before any global here would
+    // be constructed
+    struct Runtime
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, Name*> selectors;
+        std::unordered_map<std::string, objc_class*> classes;
+        std::unordered_map<std::string, Name*> protocols;
+    };
+
+    Runtime& runtime()
+    {
+        static Runtime* r = new Runtime;
+        return *r;
+    }
+
+    std::atomic<size_t> s_selectors { 0 };
+    std::atomic<size_t> s_classes { 0 };
+    std::atomic<size_t> s_protocols { 0 };
+    std::atomic<size_t> s_messages { 0 };
+    std::atomic<size_t> s_methodLookups { 0 };
+
+    IMP findMethod( Class cls, SEL selector )
+    {
+        Runtime& r = runtime();
+        std::lock_guard<std::mutex> lock( r.mutex );
+        auto it = cls->methods.find( selector );
+        if ( it == cls->methods.end() )
+        {
+            // the runtime would forward the message, a test sending one its class
+            // never got is broken
+            __builtin_printf( "%s does not respond to %s\n", cls->name.c_str(), ( (const Name*)selector )->name.c_str() );
+            abort();
+        }
+        return it->second;
+    }
+
+    Name* intern( std::unordered_map<std::string, Name*>& names, const char* name )
+    {
+        Name*& n = names[ name ];
+        if ( !n )
+        {
+            n = new Name { name };
+        }
+        return n;
+    }
+}
+
+extern "C" SEL sel_registerName( const char* name )
+{
+    ++s_selectors;
+    Runtime& r = runtime();
+    std::lock_guard<std::mutex> lock( r.mutex );
+    return (SEL)intern( r.selectors, name );
+}
+
+extern "C" Class objc_lookUpClass( const char* name )
+{
+    ++s_classes;
+    Runtime& r = runtime();
+    std::lock_guard<std::mutex> lock( r.mutex );
+    objc_class*& cls = r.classes[ name ];
+    if ( !cls )
+    {
+        cls = new objc_class { { nullptr }, name, {} };
+    }
+    return cls;
+}
+
+extern "C" Protocol* objc_getProtocol( const char* name )
+{
+    ++s_protocols;
+    Runtime& r = runtime();
+    std::lock_guard<std::mutex> lock( r.mutex );
+    return (Protocol*)intern( r.protocols, name );
+}
+
+extern "C" bool class_addMethod( Class cls, SEL selector, IMP imp, const char* )
+{
+    Runtime& r = runtime();
+    std::lock_guard<std::mutex> lock( r.mutex );
+    return cls->methods.emplace( selector, imp ).second;
+}
+
+extern "C" Class object_getClass( id object )
+{
+    return object ? object->isa : nullptr;
+}
+
+extern "C" IMP class_getMethodImplementation( Class cls, SEL selector )
+{
+    ++s_methodLookups;
+    return findMethod( cls, selector );
+}
+
+extern "C" bool class_respondsToSelector( Class cls, SEL selector )
+{
+    Runtime& r = runtime();
+    std::lock_guard<std::mutex> lock( r.mutex );
+    return cls->methods.count( selector ) != 0;
+}
+
+// what the dispatchers below jump to. a nil receiver gets zero in every return
+// register and leaves a struct result alone, like objc_msgSend
+extern "C" void objcStubNilReturn();
+
+extern "C" IMP objcStubDispatch( id object, SEL selector )
+{
+    ++s_messages;
+    if ( !object )
+    {
+        return (IMP)&objcStubNilReturn;
+    }
+    return findMethod( object->isa, selector );
+}
+
+// objc_msgSend looks the method up and tail calls it with the caller's arguments, so
+// every argument register survives the lookup. _stret has the result pointer first.
+#if defined(__x86_64__)
+asm( R"(
+    .text
+
+    .globl objcStubNilReturn
+    .type objcStubNilReturn, @function
+objcStubNilReturn:
+    xorl %eax, %eax
+    xorl %edx, %edx
+    pxor %xmm0, %xmm0
+    pxor %xmm1, %xmm1
+    ret
+
+    .macro DISPATCH receiver, selector
+    pushq %rbp
+    movq %rsp, %rbp
+    subq $0xb0, %rsp
+    movq %rdi, 0x00(%rsp)
+    movq %rsi, 0x08(%rsp)
+    movq %rdx, 0x10(%rsp)
+    movq %rcx, 0x18(%rsp)
+    movq %r8, 0x20(%rsp)
+    movq %r9, 0x28(%rsp)
+    movdqu %xmm0, 0x30(%rsp)
+    movdqu %xmm1, 0x40(%rsp)
+    movdqu %xmm2, 0x50(%rsp)
+    movdqu %xmm3, 0x60(%rsp)
+    movdqu %xmm4, 0x70(%rsp)
+    movdqu %xmm5, 0x80(%rsp)
+    movdqu %xmm6, 0x90(%rsp)
+    movdqu %xmm7, 0xa0(%rsp)
+    movq \receiver, %rdi
+    movq \selector, %rsi
+    call objcStubDispatch
+    movq 0x00(%rsp), %rdi
+    movq 0x08(%rsp), %rsi
+    movq 0x10(%rsp), %rdx
+    movq 0x18(%rsp), %rcx
+    movq 0x20(%rsp), %r8
+    movq 0x28(%rsp), %r9
+    movdqu 0x30(%rsp), %xmm0
+    movdqu 0x40(%rsp), %xmm1
+    movdqu 0x50(%rsp), %xmm2
+    movdqu 0x60(%rsp), %xmm3
+    movdqu 0x70(%rsp), %xmm4
+    movdqu 0x80(%rsp), %xmm5
+    movdqu 0x90(%rsp), %xmm6
+    movdqu 0xa0(%rsp), %xmm7
+    leave
+    jmpq *%rax
+    .endm
+
+    .globl objc_msgSend
+    .type objc_msgSend, @function
+objc_msgSend:
+    DISPATCH %rdi, %rsi
+
+    .globl objc_msgSend_fpret
+    .type objc_msgSend_fpret, @function
+objc_msgSend_fpret:
+    DISPATCH %rdi, %rsi
+
+    .globl objc_msgSend_stret
+    .type objc_msgSend_stret, @function
+objc_msgSend_stret:
+    DISPATCH %rsi, %rdx
+)" );
+#else
+#error "the stub runtime's objc_msgSend is only written for x86-64"
+#endif // __x86_64__
+
+ObjcStubCounts objcStubCounts()
+{
+    return { s_selectors.load(), s_classes.load(), s_protocols.load(), s_messages.load(), s_methodLookups.load() };
+}
+
+const char* objcStubName( const void* object )
+{
+    // a class keeps its name behind the object header, selectors and protocols are
+    // just the name
+    Runtime& r = runtime();
+    std::lock_guard<std::mutex> lock( r.mutex );
+    for ( const auto& cls : r.classes )
+    {
+        if ( cls.second == object )
+        {
+            return cls.second->name.c_str();
+        }
+    }
+    return static_cast<const Name*>( object )->name.c_str();
+}
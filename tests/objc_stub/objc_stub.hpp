@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file           : objc_stub.hpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#ifndef METAL_PLAYGROUND_OBJC_STUB_HPP
+#define METAL_PLAYGROUND_OBJC_STUB_HPP
+
+#include <cstddef>
+
+#include <objc/runtime.h>
+
+// how often each runtime function was called since the start of the program
+struct ObjcStubCounts
+{
+    size_t selectors;           // sel_registerName
+    size_t classes;             // objc_lookUpClass
+    size_t protocols;           // objc_getProtocol
+    size_t messages;            // objc_msgSend and its _fpret / _stret variants, nil receivers too
+    size_t methodLookups;       // class_getMethodImplementation
+};
+
+ObjcStubCounts objcStubCounts();
+
+// the name a selector, class or protocol was registered or looked up with
+const char* objcStubName( const void* object );
+
+
+#endif //METAL_PLAYGROUND_OBJC_STUB_HPP
@@ -0,0 +1,15 @@
+/**
+  ******************************************************************************
+  * @file           : shader_layout.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+// built once per sample with SHADER_TYPES naming its shader_types.hpp. the layout
+// checks of SHADER_STRUCT are static_asserts, compiling this is the whole test
+#include SHADER_TYPES
@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file           : test_alloc_counter.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "alloc_counter.hpp"
+#include "check.hpp"
+
+#include <cstdlib>
+
+// kept out of the optimizer's reach, a malloc it can see through may be dropped
+static void* volatile s_sink;
+
+static void allocate()
+{
+    s_sink = malloc( 64 );
+    free( s_sink );
+}
+
+// new[] goes through the hook too, through the same sink so release builds keep it
+static void allocateArray()
+{
+    int* array = new int[ 16 ];
+    s_sink = array;
+    delete[] static_cast<int*>( s_sink );
+}
+
+// the hook has to see an allocation for the frame check to mean anything
+int main()
+{
+    if ( !startAllocationCounting() )
+    {
+        __builtin_printf( "no allocation hook in this build, skipped\n" );
+        return 0;
+    }
+    const AllocationCounts before = allocationCounts();
+    allocate();
+    allocateArray();
+    const AllocationCounts after = allocationCounts();
+    CHECK( after.allocations >= before.allocations + 2 );
+    CHECK( after.bytes >= before.bytes + 64 + 16 * sizeof( int ) );
+    stopAllocationCounting();
+
+    // allocating in the warm up is fine, after it the frame fails
+    FrameAllocationCheck check( 2 );
+    for ( int frame = 0; frame < 5; ++frame )
+    {
+        check.beginFrame();
+        if ( frame == 1 || frame == 3 )
+        {
+            allocate();
+        }
+        const bool passed = check.endFrame();
+        CHECK( passed == ( frame != 3 ) );
+    }
+    CHECK( check.failedFrames() == 1 );
+    CHECK( check.allocations() == 1 );
+    CHECK( !check.passed() );
+
+    return checkResult();
+}
@@ -0,0 +1,176 @@
+/**
+  ******************************************************************************
+  * @file           : test_animation.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "animation.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// a group of four sampled together and a tail sampled one track at a time
+static constexpr size_t kTrackCount = 7;
+static constexpr size_t kFrameCount = 31;
+static constexpr float kSampleRate = 30.f;
+
+// every track of a clip with a single track is on the scalar path
+static std::vector<Transform> makeRawKeys( size_t trackCount = kTrackCount, float offset = 0.f )
+{
+    std::vector<Transform> keys( trackCount * kFrameCount );
+    for ( size_t f = 0; f < kFrameCount; ++f )
+    {
+        for ( size_t t = 0; t < trackCount; ++t )
+        {
+            // about the y axis, a full turn over the clip
+            const float half = (float)M_PI * (float)f / (float)( kFrameCount - 1 ) + 0.3f * (float)t + offset;
+            Transform& key = keys[ f * trackCount + t ];
+            key.rotation = { 0.f, sinf( half ), 0.f, cosf( half ) };
+            key.translation = { (float)t, sinf( (float)f * 0.2f + offset ), -2.f };
+            key.scale = { 1.f, 1.f + 0.5f * (float)f / (float)kFrameCount, 1.f };
+        }
+    }
+    return keys;
+}
+
+static float rotationDot( const Transform& a, const Transform& b )
+{
+    return fabsf( a.rotation.x * b.rotation.x + a.rotation.y * b.rotation.y + a.rotation.z * b.rotation.z + a.rotation.w * b.rotation.w );
+}
+
+// component for component, the float3 padding is not written
+static bool sameTransform( const Transform& a, const Transform& b )
+{
+    return a.rotation.x == b.rotation.x && a.rotation.y == b.rotation.y && a.rotation.z == b.rotation.z && a.rotation.w == b.rotation.w &&
+           a.translation.x == b.translation.x && a.translation.y == b.translation.y && a.translation.z == b.translation.z &&
+           a.scale.x == b.scale.x && a.scale.y == b.scale.y && a.scale.z == b.scale.z;
+}
+
+int main()
+{
+    const std::vector<Transform> raw = makeRawKeys();
+    const AnimationClip clip = AnimationClip::compress( raw.data(), kTrackCount, kFrameCount, kSampleRate );
+    CHECK( clip.sizeInBytes() < raw.size() * sizeof( Transform ) );
+
+    // on the frames the keys come back within the quantization
+    std::vector<Transform> pose( kTrackCount );
+    for ( size_t f = 0; f < kFrameCount - 1; ++f )
+    {
+        AnimationSampler::sample( clip, (float)f / kSampleRate, pose.data() );
+        for ( size_t t = 0; t < kTrackCount; ++t )
+        {
+            const Transform& key = raw[ f * kTrackCount + t ];
+            CHECK( rotationDot( key, pose[ t ] ) > 0.99999f );
+            CHECK( fabsf( key.translation.y - pose[ t ].translation.y ) < 1e-4f );
+            CHECK( fabsf( key.scale.y - pose[ t ].scale.y ) < 1e-4f );
+            CHECK( key.translation.x == pose[ t ].translation.x );
+        }
+    }
+
+    // the lanes of a group give the same pose bit for bit as the scalar path, the
+    // tracks of a one track clip and of a clip repeating it four times compress alike
+    const std::vector<Transform> single = makeRawKeys( 1, 0.7f );
+    std::vector<Transform> repeated;
+    for ( const Transform& key : single )
+    {
+        repeated.insert( repeated.end(), 4, key );
+    }
+    const AnimationClip singleClip = AnimationClip::compress( single.data(), 1, kFrameCount, kSampleRate );
+    const AnimationClip repeatedClip = AnimationClip::compress( repeated.data(), 4, kFrameCount, kSampleRate );
+    for ( float time : { 0.f, 0.21f, 0.5f, 0.987f } )
+    {
+        Transform scalar;
+        Transform lanes[ 4 ];
+        AnimationSampler::sample( singleClip, time, &scalar );
+        AnimationSampler::sample( repeatedClip, time, lanes );
+        for ( const Transform& lane : lanes )
+        {
+            CHECK( sameTransform( lane, scalar ) );
+        }
+    }
+
+    // a rotation about y makes a matrix that turns x towards -z
+    Transform turn = {};
+    turn.rotation = { 0.f, sinf( (float)M_PI / 4.f ), 0.f, cosf( (float)M_PI / 4.f ) };
+    turn.translation = { 1.f, 2.f, 3.f };
+    turn.scale = { 2.f, 2.f, 2.f };
+    const shader_layout::host_float4x4 m = AnimationSampler::toMatrix( turn );
+    CHECK( fabsf( m.columns[0].x ) < 1e-6f && fabsf( m.columns[0].z + 2.f ) < 1e-6f );
+    CHECK( fabsf( m.columns[1].y - 2.f ) < 1e-6f );
+    CHECK( m.columns[3].x == 1.f && m.columns[3].y == 2.f && m.columns[3].z == 3.f && m.columns[3].w == 1.f );
+
+    // hours of small steps stay within a frame of the same time kept in double precision,
+    // an unwrapped float clock stops advancing long before
+    AnimationPlayer player( kTrackCount );
+    player.play( &clip );
+    const float dt = 1.f / 144.f;
+    const size_t steps = 144 * 60 * 60 * 2;
+    for ( size_t i = 0; i < steps; ++i )
+    {
+        player.update( dt );
+    }
+    const double expected = fmod( (double)steps * (double)dt, (double)clip.duration() );
+    AnimationSampler::sample( clip, (float)expected, pose.data() );
+    for ( size_t t = 0; t < kTrackCount; ++t )
+    {
+        // a frame turns the tracks by 2 pi / 30, half that between the quaternions
+        CHECK( rotationDot( player.pose()[ t ], pose[ t ] ) > cosf( (float)M_PI / 30.f ) );
+    }
+
+    // a cross fade blends the two clips by the elapsed share of the fade, then hands over
+    // to the second clip at its own time
+    const std::vector<Transform> rawB = makeRawKeys( kTrackCount, 1.1f );
+    const AnimationClip clipB = AnimationClip::compress( rawB.data(), kTrackCount, kFrameCount, kSampleRate );
+    std::vector<Transform> poseA( kTrackCount ), poseB( kTrackCount ), blended( kTrackCount );
+    const float step = 1.f / 64.f;
+    const float fade = 16.f * step;
+
+    AnimationPlayer fader( kTrackCount );
+    fader.crossFade( &clip, fade );
+    CHECK( !fader.isFading() );       // nothing to fade from, plays at once
+    for ( int i = 0; i < 8; ++i )
+    {
+        fader.update( step );
+    }
+    fader.crossFade( &clipB, fade );
+    CHECK( fader.isFading() );
+
+    float timeA = 8.f * step, timeB = 0.f;
+    for ( int i = 1; i <= 16; ++i )
+    {
+        fader.update( step );
+        timeA += step;
+        timeB += step;
+        const float weight = std::min( (float)i * step / fade, 1.f );
+        AnimationSampler::sample( clip, timeA, poseA.data() );
+        AnimationSampler::sample( clipB, timeB, poseB.data() );
+        AnimationSampler::blend( poseA.data(), poseB.data(), weight, kTrackCount, blended.data() );
+        for ( size_t t = 0; t < kTrackCount; ++t )
+        {
+            CHECK( rotationDot( fader.pose()[ t ], blended[ t ] ) > 0.99999f );
+            CHECK( fabsf( fader.pose()[ t ].translation.y - blended[ t ].translation.y ) < 1e-5f );
+            CHECK( fabsf( fader.pose()[ t ].scale.y - blended[ t ].scale.y ) < 1e-5f );
+        }
+        CHECK( fader.isFading() == ( i < 16 ) );
+    }
+
+    // past the fade only the second clip plays, carrying on from where the fade left it
+    fader.update( step );
+    timeB += step;
+    AnimationSampler::sample( clipB, timeB, poseB.data() );
+    for ( size_t t = 0; t < kTrackCount; ++t )
+    {
+        CHECK( rotationDot( fader.pose()[ t ], poseB[ t ] ) > 0.99999f );
+        CHECK( fabsf( fader.pose()[ t ].translation.y - poseB[ t ].translation.y ) < 1e-5f );
+    }
+
+    return checkResult();
+}
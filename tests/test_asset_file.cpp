@@ -0,0 +1,130 @@
+/**
+  ******************************************************************************
+  * @file           : test_asset_file.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "asset_file.hpp"
+#include "check.hpp"
+#include "job_system.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static std::vector<uint8_t> readFile( const char* path )
+{
+    std::vector<uint8_t> bytes;
+    FILE* f = fopen( path, "rb" );
+    if ( !f )
+    {
+        return bytes;
+    }
+    uint8_t buffer[ 4096 ];
+    for ( size_t n; ( n = fread( buffer, 1, sizeof( buffer ), f ) ) > 0; )
+    {
+        bytes.insert( bytes.end(), buffer, buffer + n );
+    }
+    fclose( f );
+    return bytes;
+}
+
+static bool writeFile( const char* path, const std::vector<uint8_t>& bytes )
+{
+    FILE* f = fopen( path, "wb" );
+    if ( !f )
+    {
+        return false;
+    }
+    const bool ok = fwrite( bytes.data(), 1, bytes.size(), f ) == bytes.size();
+    return fclose( f ) == 0 && ok;
+}
+
+// a file with its header changed opens or not, whatever it claims
+static bool opensWith( const char* path, const std::vector<uint8_t>& file, const AssetFileHeader& header )
+{
+    std::vector<uint8_t> bytes = file;
+    memcpy( bytes.data(), &header, sizeof( header ) );
+    AssetFileReader reader;
+    return writeFile( path, bytes ) && reader.open( path );
+}
+
+// the same with one offset of the table changed
+static bool opensWithOffset( const char* path, const std::vector<uint8_t>& file, size_t index, uint64_t offset )
+{
+    std::vector<uint8_t> bytes = file;
+    memcpy( bytes.data() + sizeof( AssetFileHeader ) + index * sizeof( uint64_t ), &offset, sizeof( offset ) );
+    AssetFileReader reader;
+    return writeFile( path, bytes ) && reader.open( path );
+}
+
+int main()
+{
+    const char* path = "test_asset_file.tmp";
+    JobSystem jobs( 2 );
+
+    // four full chunks and a short one, compressible
+    const size_t chunkSize = 4096;
+    std::vector<uint8_t> data( 4 * chunkSize + 100 );
+    for ( size_t i = 0; i < data.size(); ++i )
+    {
+        data[ i ] = (uint8_t)( i / 32 );
+    }
+    CHECK( writeAssetFile( path, data.data(), data.size(), jobs, chunkSize ) );
+
+    {
+        AssetFileReader reader;
+        CHECK( reader.open( path ) );
+        CHECK( reader.size() == data.size() && reader.compressedSize() < data.size() );
+        std::vector<uint8_t> out( data.size() );
+        CHECK( reader.read( jobs, out.data(), 2 ) && out == data );
+    }
+
+    const std::vector<uint8_t> file = readFile( path );
+    CHECK( file.size() > sizeof( AssetFileHeader ) );
+    AssetFileHeader header;
+    memcpy( &header, file.data(), sizeof( header ) );
+    CHECK( header.chunkCount == 5 );
+    CHECK( opensWith( path, file, header ) );
+
+    // a chunk count that agrees with the size but whose offset table is far bigger
+    // than the file, it must not be allocated or read
+    AssetFileHeader huge = header;
+    huge.chunkSize = 1;
+    huge.size = ~0u;
+    huge.chunkCount = ~0u;
+    CHECK( !opensWith( path, file, huge ) );
+
+    // a size where rounding up with an add wraps to a small count
+    AssetFileHeader wrapped = header;
+    wrapped.chunkSize = 2;
+    wrapped.size = ~0ull;
+    wrapped.chunkCount = 0;
+    CHECK( !opensWith( path, file, wrapped ) );
+
+    // offsets that run past the end of the file or don't start after the table
+    CHECK( opensWithOffset( path, file, 0, sizeof( AssetFileHeader ) + 6 * sizeof( uint64_t ) ) );
+    CHECK( !opensWithOffset( path, file, 5, file.size() + 1 ) );
+    CHECK( !opensWithOffset( path, file, 0, 0 ) );
+
+    // a cut off file: in the header, in the table and in the last chunk
+    AssetFileReader reader;
+    for ( size_t size : { sizeof( AssetFileHeader ) - 1, sizeof( AssetFileHeader ) + 8, file.size() - 1 } )
+    {
+        const std::vector<uint8_t> truncated( file.begin(), file.begin() + (long)size );
+        CHECK( writeFile( path, truncated ) && !reader.open( path ) );
+    }
+
+    // nothing at all still round trips
+    CHECK( writeAssetFile( path, nullptr, 0, jobs, chunkSize ) );
+    CHECK( reader.open( path ) && reader.size() == 0 && reader.read( jobs, nullptr ) );
+
+    remove( path );
+    return checkResult();
+}
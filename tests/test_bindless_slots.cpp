@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file           : test_bindless_slots.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "bindless_slots.hpp"
+#include "check.hpp"
+
+#include <cstddef>
+#include <set>
+#include <vector>
+
+static void checkAllocation()
+{
+    // lowest index first, until the table is full
+    SlotAllocator slots( 8 );
+    for ( uint32_t i = 0; i < 8; ++i )
+    {
+        CHECK( slots.allocate() == i );
+        CHECK( slots.isLive( i ) );
+    }
+    CHECK( slots.allocate() == SlotAllocator::kInvalidSlot );
+    CHECK( slots.liveCount() == 8 );
+    CHECK( !slots.isLive( 8 ) && !slots.isLive( SlotAllocator::kInvalidSlot ) );
+}
+
+static void checkDeferredReclaim()
+{
+    SlotAllocator slots( 4 );
+    for ( uint32_t i = 0; i < 4; ++i )
+    {
+        slots.allocate();
+    }
+
+    // released slots are dead at once but stay taken until their frame completes
+    slots.release( 2, 10 );
+    slots.release( 0, 10 );
+    slots.release( 3, 12 );
+    CHECK( !slots.isLive( 2 ) && !slots.isLive( 0 ) && !slots.isLive( 3 ) );
+    CHECK( slots.liveCount() == 1 && slots.retiredCount() == 3 );
+    CHECK( slots.allocate() == SlotAllocator::kInvalidSlot );
+
+    // frames before the release free nothing
+    slots.reclaim( 9 );
+    CHECK( slots.retiredCount() == 3 );
+    CHECK( slots.allocate() == SlotAllocator::kInvalidSlot );
+
+    // frame 10 frees both of its slots, not the one from frame 12
+    slots.reclaim( 10 );
+    CHECK( slots.retiredCount() == 1 );
+    CHECK( slots.allocate() == 0 );
+    CHECK( slots.allocate() == 2 );
+    CHECK( slots.allocate() == SlotAllocator::kInvalidSlot );
+
+    // completions may skip frames, everything up to the completed one comes back
+    slots.reclaim( 20 );
+    CHECK( slots.retiredCount() == 0 );
+    CHECK( slots.allocate() == 3 );
+}
+
+// a renderer's loop: every frame removes a few entries and adds as many, with three
+// frames in flight. an index never comes back while a frame that saw it may still run,
+// and reused indices are the lowest free ones, so the live slots stay packed
+static void checkReuse()
+{
+    static constexpr uint32_t kCapacity = 64;
+    static constexpr uint64_t kFramesInFlight = 3;
+
+    SlotAllocator slots( kCapacity );
+    std::vector<uint32_t> live;
+    for ( uint32_t i = 0; i < 48; ++i )
+    {
+        live.push_back( slots.allocate() );
+    }
+
+    // the frame each index was last released in
+    std::vector<uint64_t> releasedIn( kCapacity, 0 );
+    std::vector<bool> everReleased( kCapacity, false );
+    uint32_t state = 1;
+    for ( uint64_t frame = 1; frame <= 500; ++frame )
+    {
+        if ( frame > kFramesInFlight )
+        {
+            slots.reclaim( frame - kFramesInFlight );
+        }
+
+        for ( int i = 0; i < 4; ++i )
+        {
+            state = state * 1664525u + 1013904223u;
+            const size_t victim = ( state >> 8 ) % live.size();
+            slots.release( live[ victim ], frame );
+            releasedIn[ live[ victim ] ] = frame;
+            everReleased[ live[ victim ] ] = true;
+            live[ victim ] = live.back();
+            live.pop_back();
+        }
+
+        std::set<uint32_t> taken( live.begin(), live.end() );
+        for ( int i = 0; i < 4; ++i )
+        {
+            const uint32_t slot = slots.allocate();
+            CHECK( slot != SlotAllocator::kInvalidSlot );
+            if ( slot == SlotAllocator::kInvalidSlot )
+            {
+                return;
+            }
+            CHECK( !taken.count( slot ) );
+            CHECK( !everReleased[ slot ] || releasedIn[ slot ] + kFramesInFlight <= frame );
+            taken.insert( slot );
+            live.push_back( slot );
+        }
+        CHECK( slots.liveCount() == live.size() );
+    }
+
+    // 48 live and 12 retired at most, the rest of the table was never needed
+    CHECK( slots.retiredCount() <= 4 * kFramesInFlight );
+    for ( uint32_t slot : live )
+    {
+        CHECK( slot < 48 + 4 * kFramesInFlight );
+    }
+}
+
+static void checkLayout()
+{
+    // the shader side struct, pointers and resource ids are 8 bytes each
+    struct Table
+    {
+        uint64_t buffers[ 100 ];
+        uint64_t textures[ 37 ];
+    };
+
+    const BindlessLayout layout = { 100, 37 };
+    CHECK( layout.bufferOffset( 0 ) == offsetof( Table, buffers ) );
+    CHECK( layout.bufferOffset( 99 ) == offsetof( Table, buffers ) + 99 * sizeof( uint64_t ) );
+    CHECK( layout.textureOffset( 0 ) == offsetof( Table, textures ) );
+    CHECK( layout.textureOffset( 36 ) == offsetof( Table, textures ) + 36 * sizeof( uint64_t ) );
+    CHECK( layout.size() == sizeof( Table ) );
+
+    // the last buffer entry ends where the first texture entry starts
+    CHECK( layout.bufferOffset( 99 ) + BindlessLayout::kEntrySize == layout.textureOffset( 0 ) );
+    CHECK( layout.textureOffset( 36 ) + BindlessLayout::kEntrySize == layout.size() );
+
+    const BindlessLayout texturesOnly = { 0, 16 };
+    CHECK( texturesOnly.textureOffset( 0 ) == 0 && texturesOnly.size() == 16 * BindlessLayout::kEntrySize );
+}
+
+int main()
+{
+    checkAllocation();
+    checkDeferredReclaim();
+    checkReuse();
+    checkLayout();
+    return checkResult();
+}
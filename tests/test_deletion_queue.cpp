@@ -0,0 +1,260 @@
+/**
+  ******************************************************************************
+  * @file           : test_deletion_queue.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "deletion_queue.hpp"
+#include "check.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// appends the value to the vector in context, so the order entries ran in shows
+static void record( void* context, uint64_t value )
+{
+    static_cast<std::vector<uint64_t>*>( context )->push_back( value );
+}
+
+static void checkDeferUntilComplete()
+{
+    // declared first, the queue's destructor may still run entries into it
+    std::vector<uint64_t> ran;
+    DeletionQueue queue;
+    CHECK( queue.frame() == 1 && queue.completedFrame() == 0 );
+
+    queue.defer( record, &ran, 10 );
+    queue.defer( record, &ran, 11 );
+    CHECK( queue.endFrame() == 1 );
+    queue.defer( record, &ran, 20 );
+    CHECK( queue.endFrame() == 2 );
+    queue.defer( record, &ran, 30 );
+    CHECK( queue.pendingCount() == 4 );
+
+    // nothing has completed yet
+    CHECK( queue.collect() == 0 );
+    CHECK( ran.empty() );
+
+    // frame 1 runs in the order it was deferred, frame 2 waits for its fence
+    queue.complete( 1 );
+    CHECK( queue.collect() == 2 );
+    CHECK( ( ran == std::vector<uint64_t>{ 10, 11 } ) );
+    CHECK( queue.pendingCount() == 2 );
+
+    queue.complete( 2 );
+    CHECK( queue.collect() == 1 );
+    CHECK( ( ran == std::vector<uint64_t>{ 10, 11, 20 } ) );
+
+    // the current frame never collects, only flush() runs it
+    CHECK( queue.collect() == 0 );
+    CHECK( queue.flush() == 1 );
+    CHECK( ( ran == std::vector<uint64_t>{ 10, 11, 20, 30 } ) );
+    CHECK( queue.pendingCount() == 0 && queue.collectedCount() == 4 );
+}
+
+static void checkRingWrap()
+{
+    // a few entries a frame against a capacity of 8 and frames collected one behind,
+    // the head walks around the ring many times without growing it
+    std::vector<uint64_t> ran;
+    DeletionQueue queue( 8 );
+    uint64_t next = 0;
+    uint64_t expected = 0;
+    bool inOrder = true;
+    for ( int i = 0; i < 100; ++i )
+    {
+        for ( int j = 0; j < 3; ++j )
+        {
+            queue.defer( record, &ran, next++ );
+        }
+        const uint64_t frame = queue.endFrame();
+        if ( frame > 1 )
+        {
+            queue.complete( frame - 1 );
+        }
+        queue.collect();
+        for ( uint64_t value : ran )
+        {
+            inOrder = inOrder && value == expected++;
+        }
+        ran.clear();
+    }
+    CHECK( inOrder );
+    CHECK( queue.pendingCount() == 3 );
+    CHECK( queue.collectedCount() == 297 );
+
+    // wrapped and then grown: the unrolled ring keeps the order
+    DeletionQueue wrapped( 4 );
+    for ( uint64_t i = 0; i < 3; ++i )
+    {
+        wrapped.defer( record, &ran, i );
+    }
+    wrapped.complete( wrapped.endFrame() );
+    CHECK( wrapped.collect() == 3 );
+    ran.clear();
+    for ( uint64_t i = 0; i < 11; ++i )
+    {
+        wrapped.defer( record, &ran, 100 + i );
+    }
+    CHECK( wrapped.pendingCount() == 11 );
+    wrapped.complete( wrapped.endFrame() );
+    CHECK( wrapped.collect() == 11 );
+    bool grownInOrder = ran.size() == 11;
+    for ( size_t i = 0; grownInOrder && i < ran.size(); ++i )
+    {
+        grownInOrder = ran[ i ] == 100 + i;
+    }
+    CHECK( grownInOrder );
+}
+
+struct Retirer
+{
+    DeletionQueue* queue;
+    std::vector<uint64_t> ran;
+};
+
+// defers one more entry while collect() runs, the ring may grow under it
+static void retireAgain( void* context, uint64_t value )
+{
+    Retirer* retirer = static_cast<Retirer*>( context );
+    retirer->ran.push_back( value );
+    if ( value < 1000 )
+    {
+        retirer->queue->defer( retireAgain, retirer, value + 1000 );
+    }
+}
+
+static void checkDeferDuringCollect()
+{
+    DeletionQueue queue( 2 );
+    Retirer retirer = { &queue, {} };
+    for ( uint64_t i = 0; i < 2; ++i )
+    {
+        queue.defer( retireAgain, &retirer, i );
+    }
+    queue.complete( queue.endFrame() );
+
+    // what the functions deferred belongs to the current frame, not the completed one
+    CHECK( queue.collect() == 2 );
+    CHECK( ( retirer.ran == std::vector<uint64_t>{ 0, 1 } ) );
+    CHECK( queue.pendingCount() == 2 );
+
+    queue.complete( queue.endFrame() );
+    CHECK( queue.collect() == 2 );
+    CHECK( ( retirer.ran == std::vector<uint64_t>{ 0, 1, 1000, 1001 } ) );
+    CHECK( queue.pendingCount() == 0 );
+}
+
+static void countRun( void* context, uint64_t )
+{
+    ++*static_cast<int*>( context );
+}
+
+static void checkFlushOnDestruction()
+{
+    int ran = 0;
+    {
+        DeletionQueue queue;
+        queue.defer( countRun, &ran, 0 );
+        queue.endFrame();
+        queue.defer( countRun, &ran, 0 );
+    }
+    CHECK( ran == 2 );
+}
+
+static void checkConcurrentComplete()
+{
+    // completion handlers of several queues, or late ones, report frames out of order
+    // from their own threads. the fence only ever moves forward, to the highest frame
+    constexpr size_t kThreads = 8;
+    constexpr uint64_t kFrames = 20000;
+
+    DeletionQueue queue;
+    for ( uint64_t i = 0; i < kFrames; ++i )
+    {
+        queue.endFrame();
+    }
+
+    std::atomic<bool> start( false );
+    std::atomic<int> wentBack( 0 );
+    std::vector<std::thread> threads;
+    for ( size_t t = 0; t < kThreads; ++t )
+    {
+        threads.emplace_back( [&, t] {
+            while ( !start.load( std::memory_order_acquire ) )
+            {
+            }
+            // every thread reports its share of the frames, half of them backwards
+            const uint64_t last = t + ( kFrames - 1 - t ) / kThreads * kThreads;
+            for ( uint64_t i = t; i < kFrames; i += kThreads )
+            {
+                const uint64_t frame = ( t & 1 ) ? last - ( i - t ) + 1 : i + 1;
+                const uint64_t before = queue.completedFrame();
+                queue.complete( frame );
+                if ( queue.completedFrame() < before )
+                {
+                    wentBack.fetch_add( 1, std::memory_order_relaxed );
+                }
+            }
+        } );
+    }
+    start.store( true, std::memory_order_release );
+    for ( std::thread& thread : threads )
+    {
+        thread.join();
+    }
+
+    CHECK( wentBack.load() == 0 );
+    CHECK( queue.completedFrame() == kFrames );
+
+    // the render thread collects against fences other threads raise while it runs
+    std::vector<uint64_t> ran;
+    DeletionQueue live;
+    std::atomic<uint64_t> raised( 0 );
+    constexpr uint64_t kLiveFrames = 2000;
+    std::thread signaller( [&] {
+        while ( raised.load( std::memory_order_acquire ) < kLiveFrames )
+        {
+            const uint64_t frame = live.completedFrame() + 1;
+            if ( frame <= raised.load( std::memory_order_acquire ) )
+            {
+                live.complete( frame );
+            }
+        }
+        live.complete( kLiveFrames );
+    } );
+    for ( uint64_t i = 0; i < kLiveFrames; ++i )
+    {
+        live.defer( record, &ran, i );
+        raised.store( live.endFrame(), std::memory_order_release );
+        live.collect();
+    }
+    signaller.join();
+    live.collect();
+
+    bool inOrder = ran.size() == kLiveFrames;
+    for ( size_t i = 0; inOrder && i < ran.size(); ++i )
+    {
+        inOrder = ran[ i ] == i;
+    }
+    CHECK( inOrder );
+    CHECK( live.pendingCount() == 0 );
+}
+
+int main()
+{
+    checkDeferUntilComplete();
+    checkRingWrap();
+    checkDeferDuringCollect();
+    checkFlushOnDestruction();
+    checkConcurrentComplete();
+    return checkResult();
+}
@@ -0,0 +1,229 @@
+/**
+  ******************************************************************************
+  * @file           : test_draw_queue.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "draw_queue.hpp"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+static constexpr size_t kCapacity = 4096;
+
+// counts what reaches the encoder
+struct RecordingBackend
+{
+    ReplayStats calls = {};
+    std::vector<uint32_t> drawn;
+
+    void setPipeline( uint16_t ) { ++calls.pipelineChanges; }
+    void setDepthStencil( uint16_t ) { ++calls.depthStencilChanges; }
+    void setMaterial( uint16_t ) { ++calls.materialChanges; }
+    void setCullMode( uint8_t ) { ++calls.cullModeChanges; }
+    void draw( const DrawPacket& p ) { ++calls.draws; drawn.push_back( p.baseInstance ); }
+};
+
+// the packet fields follow the key, baseInstance is the push order
+static DrawPacket makePacket( uint64_t key, uint32_t index )
+{
+    DrawPacket p = {};
+    p.key = key;
+    p.pipeline = (uint16_t)DrawKey::pipeline( key );
+    p.material = (uint16_t)DrawKey::material( key );
+    p.depthStencil = (uint16_t)DrawKey::pass( key );
+    p.cullMode = (uint8_t)( index % 2 );
+    p.indexCount = 36;
+    p.instanceCount = 1;
+    p.baseInstance = index;
+    return p;
+}
+
+// sorts the keys through the queue and compares with std::stable_sort, equal keys
+// have to stay in push order
+static void checkSort( DrawQueue& queue, const std::vector<uint64_t>& keys )
+{
+    queue.clear();
+    for ( size_t i = 0; i < keys.size(); ++i )
+    {
+        CHECK( queue.push( makePacket( keys[ i ], (uint32_t)i ) ) );
+    }
+    queue.sort();
+
+    std::vector<uint32_t> expected( keys.size() );
+    for ( size_t i = 0; i < keys.size(); ++i )
+    {
+        expected[ i ] = (uint32_t)i;
+    }
+    std::stable_sort( expected.begin(), expected.end(), [&]( uint32_t a, uint32_t b ) { return keys[ a ] < keys[ b ]; } );
+
+    CHECK( queue.size() == keys.size() );
+    size_t mismatches = 0;
+    for ( size_t i = 0; i < keys.size(); ++i )
+    {
+        mismatches += queue.sorted( i ).baseInstance != expected[ i ];
+    }
+    CHECK( mismatches == 0 );
+}
+
+// what replay should forward for [begin, end): everything on the first draw, then
+// only the fields that differ from the draw before
+static ReplayStats expectedStats( const DrawQueue& queue, size_t begin, size_t end )
+{
+    ReplayStats stats = {};
+    for ( size_t i = begin; i < end; ++i )
+    {
+        const DrawPacket& p = queue.sorted( i );
+        const DrawPacket* last = i > begin ? &queue.sorted( i - 1 ) : nullptr;
+        stats.pipelineChanges += !last || last->pipeline != p.pipeline;
+        stats.depthStencilChanges += !last || last->depthStencil != p.depthStencil;
+        stats.materialChanges += !last || last->material != p.material;
+        stats.cullModeChanges += !last || last->cullMode != p.cullMode;
+        ++stats.draws;
+    }
+    return stats;
+}
+
+static bool sameStats( const ReplayStats& a, const ReplayStats& b )
+{
+    return a.draws == b.draws && a.pipelineChanges == b.pipelineChanges && a.depthStencilChanges == b.depthStencilChanges &&
+           a.materialChanges == b.materialChanges && a.cullModeChanges == b.cullModeChanges;
+}
+
+int main()
+{
+    DrawQueue queue( kCapacity );
+    std::mt19937_64 rng( 3 );
+
+    // every byte differs, all eight passes run
+    std::vector<uint64_t> keys( kCapacity );
+    for ( uint64_t& key : keys )
+    {
+        key = rng();
+    }
+    checkSort( queue, keys );
+
+    // a few passes, pipelines and materials over a coarse depth: the top bytes are the
+    // same for every key so their passes are skipped, and equal keys are common
+    for ( uint64_t& key : keys )
+    {
+        key = DrawKey::make( 1, (uint32_t)( rng() % 4 ), (uint32_t)( rng() % 8 ), (uint32_t)( rng() % 16 ) << 8 );
+    }
+    checkSort( queue, keys );
+
+    // one byte of key, an odd number of passes leaves the result in the scratch buffer
+    for ( uint64_t& key : keys )
+    {
+        key = rng() % 16;
+    }
+    checkSort( queue, keys );
+
+    // three bytes, the middle one constant
+    for ( uint64_t& key : keys )
+    {
+        key = ( rng() % 256 ) << 16 | 0x4200 | ( rng() % 4 );
+    }
+    checkSort( queue, keys );
+
+    // no pass runs at all, the push order is the sorted order
+    checkSort( queue, std::vector<uint64_t>( 100, DrawKey::make( 2, 7, 9, 123 ) ) );
+    checkSort( queue, {} );
+    checkSort( queue, { 5 } );
+
+    // a full queue refuses pushes and keeps what it has
+    queue.clear();
+    for ( size_t i = 0; i < kCapacity; ++i )
+    {
+        queue.push( makePacket( 0, (uint32_t)i ) );
+    }
+    CHECK( !queue.push( makePacket( 0, 0 ) ) );
+    CHECK( queue.size() == kCapacity );
+
+    // submitters push from their own threads, every packet lands once
+    queue.clear();
+    std::vector<std::thread> threads;
+    const size_t threadCount = 4;
+    for ( size_t t = 0; t < threadCount; ++t )
+    {
+        threads.emplace_back( [&queue, t] {
+            for ( size_t i = t; i < kCapacity; i += threadCount )
+            {
+                queue.push( makePacket( ( i * 2654435761u ) % 1000, (uint32_t)i ) );
+            }
+        } );
+    }
+    for ( std::thread& thread : threads )
+    {
+        thread.join();
+    }
+    queue.sort();
+    std::vector<bool> seen( kCapacity, false );
+    size_t duplicates = 0;
+    for ( size_t i = 0; i < queue.size(); ++i )
+    {
+        const uint32_t index = queue.sorted( i ).baseInstance;
+        duplicates += seen[ index ];
+        seen[ index ] = true;
+        if ( i > 0 )
+        {
+            CHECK( queue.sorted( i - 1 ).key <= queue.sorted( i ).key );
+        }
+    }
+    CHECK( queue.size() == kCapacity && duplicates == 0 );
+
+    // replay: a hand made scene, two pipelines with three materials between them. in
+    // key order each pipeline is bound once and each material once per pipeline, but
+    // for material 2 which pipeline 1 starts with where pipeline 0 left off
+    queue.clear();
+    const uint32_t scene[][2] = { { 1, 3 }, { 0, 1 }, { 1, 3 }, { 0, 2 }, { 1, 2 }, { 0, 1 }, { 0, 2 }, { 1, 3 } };
+    for ( uint32_t i = 0; i < 8; ++i )
+    {
+        DrawPacket p = makePacket( DrawKey::make( 0, scene[ i ][ 0 ], scene[ i ][ 1 ], 1000 - i ), i );
+        p.cullMode = 0;
+        queue.push( p );
+    }
+    queue.sort();
+    RecordingBackend backend;
+    ReplayStats stats = queue.replay( backend, 0, queue.size() );
+    CHECK( stats.draws == 8 && stats.pipelineChanges == 2 && stats.materialChanges == 3 );
+    CHECK( stats.depthStencilChanges == 1 && stats.cullModeChanges == 1 && stats.stateChanges() == 7 );
+    CHECK( sameStats( stats, backend.calls ) );
+    // front to back inside a pipeline and material, the later pushes are nearer
+    CHECK( ( backend.drawn == std::vector<uint32_t>{ 5, 1, 6, 3, 4, 7, 2, 0 } ) );
+
+    // random keys: the counts match the filtered transitions of the sorted order, for
+    // the whole queue and for the ranges the encoder threads take
+    queue.clear();
+    for ( uint32_t i = 0; i < 1000; ++i )
+    {
+        const uint64_t key = DrawKey::make( (uint32_t)( rng() % 3 ), (uint32_t)( rng() % 6 ), (uint32_t)( rng() % 20 ),
+                                            DrawKey::quantizeDepth( (float)( rng() % 1000 ) / 1000.f ) );
+        queue.push( makePacket( key, i ) );
+    }
+    queue.sort();
+    for ( size_t begin : { 0, 250, 500, 750 } )
+    {
+        for ( size_t end : { begin, begin + 1, begin + 250, (size_t)1000 } )
+        {
+            RecordingBackend ranged;
+            const ReplayStats s = queue.replay( ranged, begin, end );
+            CHECK( sameStats( s, expectedStats( queue, begin, end ) ) );
+            CHECK( sameStats( s, ranged.calls ) );
+        }
+    }
+    RecordingBackend whole;
+    stats = queue.replay( whole, 0, queue.size() );
+    CHECK( stats.draws == 1000 && stats.pipelineChanges <= 3 * 6 && stats.materialChanges <= 3 * 6 * 20 );
+    CHECK( stats.cullModeChanges > stats.pipelineChanges );
+
+    return checkResult();
+}
@@ -0,0 +1,241 @@
+/**
+  ******************************************************************************
+  * @file           : test_dynamic_resolution.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "dynamic_resolution.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+static constexpr double kTargetSeconds = 1.0 / 60.0;
+// the part of a frame that does not shrink with the render size, vertex work and the
+// upscale to the drawable
+static constexpr double kFixedSeconds = 0.0015;
+// frames in flight: the time of a frame is known two frames after its scale was chosen
+static constexpr size_t kLatency = 2;
+
+// a trace is the gpu time of every frame at full resolution, in ms, one per line and
+// # for comments. see traces/ for what each one holds
+static std::vector<double> loadTrace( const char* name )
+{
+    std::vector<double> seconds;
+    const std::string path = std::string( TRACE_DIR ) + "/" + name;
+    FILE* file = fopen( path.c_str(), "r" );
+    if ( !file )
+    {
+        __builtin_printf( "can not open %s\n", path.c_str() );
+        return seconds;
+    }
+    char line[ 256 ];
+    while ( fgets( line, sizeof( line ), file ) )
+    {
+        double ms;
+        if ( line[ 0 ] != '#' && sscanf( line, "%lf", &ms ) == 1 )
+        {
+            seconds.push_back( ms * 1e-3 );
+        }
+    }
+    fclose( file );
+    return seconds;
+}
+
+struct TraceRun
+{
+    std::vector<float> scale;       // the scale every frame rendered at
+    std::vector<double> seconds;    // and what it cost
+};
+
+// replays a trace through the controller: a frame at scale s costs the fixed part plus
+// the rest of its full resolution time times the area, s squared. fixedScale > 0 holds
+// the scale instead, for comparison
+static TraceRun replay( const std::vector<double>& trace, float minScale, float fixedScale = 0.f )
+{
+    DynamicResolution controller( makeDynamicResolutionSettings( kTargetSeconds, minScale, 1.f ) );
+    std::deque<double> inFlight;
+    float scale = fixedScale > 0.f ? fixedScale : controller.scale();
+
+    TraceRun run;
+    for ( double full : trace )
+    {
+        const double seconds = kFixedSeconds + ( full - kFixedSeconds ) * (double)scale * scale;
+        run.scale.push_back( scale );
+        run.seconds.push_back( seconds );
+
+        inFlight.push_back( seconds );
+        if ( inFlight.size() > kLatency )
+        {
+            const float next = controller.update( inFlight.front() );
+            inFlight.pop_front();
+            scale = fixedScale > 0.f ? fixedScale : next;
+        }
+    }
+    return run;
+}
+
+static double mean( const std::vector<double>& v, size_t first, size_t last )
+{
+    double sum = 0.0;
+    for ( size_t i = first; i < last; ++i )
+    {
+        sum += v[ i ];
+    }
+    return sum / (double)( last - first );
+}
+
+static bool overBudget( double seconds )
+{
+    return seconds > kTargetSeconds * 1.1;
+}
+
+// frames from first until 10 in a row are within budget, -1 when that never happens
+static int framesToBudget( const TraceRun& run, size_t first )
+{
+    for ( size_t f = first; f + 10 <= run.seconds.size(); ++f )
+    {
+        if ( std::none_of( run.seconds.begin() + f, run.seconds.begin() + f + 10, overBudget ) )
+        {
+            return (int)( f - first );
+        }
+    }
+    return -1;
+}
+
+static void checkSteadyLoad()
+{
+    // twice the budget at full resolution: the scale settles where frames take the
+    // target, 16.67 ms, and stays there through the hitches
+    const std::vector<double> trace = loadTrace( "steady_heavy.txt" );
+    CHECK( trace.size() == 1200 );
+    const TraceRun run = replay( trace, 0.33f );
+
+    CHECK( framesToBudget( run, 0 ) >= 0 && framesToBudget( run, 0 ) < 40 );
+
+    std::vector<double> settled;
+    std::vector<double> scales;
+    size_t over = 0;
+    for ( size_t f = 100; f < trace.size(); ++f )
+    {
+        // a hitch is a frame three times its neighbours, no scale hides it
+        const bool hitch = trace[ f ] > 2.0 * trace[ f - 1 ];
+        if ( !hitch )
+        {
+            settled.push_back( run.seconds[ f ] );
+            over += overBudget( run.seconds[ f ] );
+        }
+        scales.push_back( run.scale[ f ] );
+    }
+    const double settledSeconds = mean( settled, 0, settled.size() );
+    CHECK( fabs( settledSeconds - kTargetSeconds ) < kTargetSeconds * 0.03 );
+    CHECK( over < settled.size() / 50 );
+
+    double meanScale = mean( scales, 0, scales.size() );
+    double variance = 0.0;
+    for ( double s : scales )
+    {
+        variance += ( s - meanScale ) * ( s - meanScale );
+    }
+    CHECK( sqrt( variance / (double)scales.size() ) < 0.02 );
+
+    // the area the fixed and scaled parts of a 30 ms frame fit 16.67 ms in
+    const double idealArea = ( kTargetSeconds - kFixedSeconds ) / ( 0.030 - kFixedSeconds );
+    CHECK( fabs( meanScale * meanScale - idealArea ) < idealArea * 0.08 );
+}
+
+static void checkStep()
+{
+    const std::vector<double> trace = loadTrace( "step.txt" );
+    CHECK( trace.size() == 1500 );
+    const TraceRun run = replay( trace, 0.33f );
+
+    // under budget the scale never leaves full resolution
+    CHECK( std::all_of( run.scale.begin(), run.scale.begin() + 400, []( float s ) { return s == 1.f; } ) );
+
+    // the step is seen two frames late, the scale is back within budget soon after and
+    // then holds the target
+    const int recovered = framesToBudget( run, 400 );
+    CHECK( recovered >= 0 && recovered < 40 );
+    CHECK( fabs( mean( run.seconds, 500, 900 ) - kTargetSeconds ) < kTargetSeconds * 0.03 );
+
+    // once the load drops the scale grows back to full, slowly so it does not overshoot
+    const auto full = std::find( run.scale.begin() + 900, run.scale.end(), 1.f );
+    CHECK( full != run.scale.end() && full - ( run.scale.begin() + 900 ) < 150 );
+    CHECK( std::none_of( run.seconds.begin() + 900, run.seconds.end(), overBudget ) );
+}
+
+static void checkOverload()
+{
+    // more than the lowest scale can hold sits on the bound, and the integral wound up
+    // meanwhile does not keep it there once the load drops
+    const std::vector<double> trace = loadTrace( "overload.txt" );
+    CHECK( trace.size() == 1200 );
+    const TraceRun run = replay( trace, 0.33f );
+
+    CHECK( run.scale[ 590 ] <= 0.331f );
+    const auto leaves = std::find_if( run.scale.begin() + 600, run.scale.end(), []( float s ) { return s > 0.34f; } );
+    CHECK( leaves != run.scale.end() && leaves - ( run.scale.begin() + 600 ) <= 10 );
+    CHECK( fabs( mean( run.seconds, 800, 1200 ) - kTargetSeconds ) < kTargetSeconds * 0.03 );
+}
+
+static void checkOrbit()
+{
+    // a load that keeps changing: the controller misses the budget far less often than
+    // the same average scale held fixed, and than full resolution
+    const std::vector<double> trace = loadTrace( "orbit.txt" );
+    CHECK( trace.size() == 2000 );
+    const TraceRun run = replay( trace, 0.33f );
+
+    std::vector<double> scales( run.scale.begin() + 100, run.scale.end() );
+    const float meanScale = (float)mean( scales, 0, scales.size() );
+    const TraceRun fixed = replay( trace, 0.33f, meanScale );
+    const TraceRun full = replay( trace, 0.33f, 1.f );
+
+    auto overFraction = []( const TraceRun& r ) {
+        return (double)std::count_if( r.seconds.begin() + 100, r.seconds.end(), overBudget ) / (double)( r.seconds.size() - 100 );
+    };
+    CHECK( overFraction( run ) < 0.15 );
+    CHECK( overFraction( run ) < 0.5 * overFraction( fixed ) );
+    CHECK( overFraction( run ) < 0.25 * overFraction( full ) );
+}
+
+static void checkBounds()
+{
+    DynamicResolution controller( makeDynamicResolutionSettings( kTargetSeconds, 0.5f, 0.9f ) );
+    CHECK( controller.scale() == 0.9f );
+    for ( int i = 0; i < 500; ++i )
+    {
+        controller.update( 1.0 );
+    }
+    CHECK( controller.scale() == 0.5f );
+    controller.reset( 2.f );
+    CHECK( controller.scale() == 0.9f );
+    controller.reset( 0.7f );
+    CHECK( controller.scale() == 0.7f );
+    CHECK( controller.filteredSeconds() == 0.0 );
+
+    // the first frame after a reset is taken as is, no outlier clamp against nothing
+    controller.update( 0.010 );
+    CHECK( controller.filteredSeconds() == 0.010 );
+}
+
+int main()
+{
+    checkSteadyLoad();
+    checkStep();
+    checkOverload();
+    checkOrbit();
+    checkBounds();
+    return checkResult();
+}
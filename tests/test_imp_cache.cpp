@@ -0,0 +1,223 @@
+/**
+  ******************************************************************************
+  * @file           : test_imp_cache.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+// sendMessageCached on the stub runtime, built with METALCPP_IMP_CACHE and without:
+// the results are the same either way, only who dispatches the messages changes
+#define NS_PRIVATE_IMPLEMENTATION
+
+#include <Foundation/NSObject.hpp>
+
+#include "check.hpp"
+#include "objc_stub.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(METALCPP_IMP_CACHE)
+static constexpr bool kCached = true;
+#else
+static constexpr bool kCached = false;
+#endif
+
+// a result over two registers, which objc_msgSend_stret returns on x86-64
+struct Range
+{
+    NS::UInteger location;
+    NS::UInteger length;
+    NS::UInteger stride;
+};
+
+// a metal-cpp wrapper the way the headers write one, every method with its own cache
+class Buffer : public NS::Referencing<Buffer>
+{
+public:
+    NS::UInteger length() const { return lengthOf( this ); }
+    double scaled( double factor ) const { return scaledOf( this, factor ); }
+
+    // the same call sites for any receiver, a nil one included, without calling a
+    // member through a null pointer
+    static NS::UInteger lengthOf( const void* object )
+    {
+        static SEL s_selector = sel_registerName( "length" );
+        static NS::Private::ImpCache s_impCache;
+        return Object::sendMessageCached<NS::UInteger>( s_impCache, object, s_selector );
+    }
+
+    static double scaledOf( const void* object, double factor )
+    {
+        static SEL s_selector = sel_registerName( "scaled:" );
+        static NS::Private::ImpCache s_impCache;
+        return Object::sendMessageCached<double>( s_impCache, object, s_selector, factor );
+    }
+
+    Range rangeAt( NS::UInteger index ) const
+    {
+        static SEL s_selector = sel_registerName( "rangeAt:" );
+        static NS::Private::ImpCache s_impCache;
+        return Object::sendMessageCached<Range>( s_impCache, this, s_selector, index );
+    }
+};
+
+// the objects behind Buffer pointers
+struct StubBuffer
+{
+    objc_object header;
+    NS::UInteger length;
+    std::atomic<long> references;
+};
+
+static NS::UInteger sharedLength( StubBuffer* self, SEL )
+{
+    return self->length;
+}
+
+static NS::UInteger managedLength( StubBuffer* self, SEL )
+{
+    return self->length + 1000;
+}
+
+static Range rangeAt( StubBuffer* self, SEL, NS::UInteger index )
+{
+    return { index, self->length, 16 };
+}
+
+static double scaled( StubBuffer* self, SEL, double factor )
+{
+    return (double)self->length * factor;
+}
+
+static StubBuffer* retain( StubBuffer* self, SEL )
+{
+    ++self->references;
+    return self;
+}
+
+static void release( StubBuffer* self, SEL )
+{
+    --self->references;
+}
+
+// two classes behind the same wrapper, like a shared and a managed buffer, with
+// different length implementations
+static Class makeClass( const char* name, IMP length )
+{
+    Class cls = objc_lookUpClass( name );
+    class_addMethod( cls, sel_registerName( "length" ), length, "Q@:" );
+    class_addMethod( cls, sel_registerName( "rangeAt:" ), (IMP)&rangeAt, "{Range=QQQ}@:Q" );
+    class_addMethod( cls, sel_registerName( "scaled:" ), (IMP)&scaled, "d@:d" );
+    class_addMethod( cls, sel_registerName( "retain" ), (IMP)&retain, "@@:" );
+    class_addMethod( cls, sel_registerName( "release" ), (IMP)&release, "v@:" );
+    return cls;
+}
+
+static StubBuffer s_shared;
+static StubBuffer s_managed;
+
+static void checkResults()
+{
+    const ObjcStubCounts before = objcStubCounts();
+    Buffer* shared = reinterpret_cast<Buffer*>( &s_shared );
+    Buffer* managed = reinterpret_cast<Buffer*>( &s_managed );
+
+    // one call site switching between classes gets each class's method
+    size_t sends = 0;
+    for ( int i = 0; i < 1000; ++i )
+    {
+        CHECK( shared->length() == 64 );
+        CHECK( managed->length() == 1128 );
+        sends += 2;
+    }
+
+    const Range range = managed->rangeAt( 3 );
+    CHECK( range.location == 3 && range.length == 128 && range.stride == 16 );
+    CHECK( shared->scaled( 0.5 ) == 32.0 );
+    CHECK( shared->retain() == shared && s_shared.references == 1 );
+    shared->release();
+    CHECK( s_shared.references == 0 );
+    sends += 4;
+
+    // with the cache every (class, selector) is looked up once and no message goes
+    // through objc_msgSend, without it every message does and nothing is looked up
+    const ObjcStubCounts after = objcStubCounts();
+    if ( kCached )
+    {
+        CHECK( after.messages == before.messages );
+        CHECK( after.methodLookups - before.methodLookups == 6 );
+    }
+    else
+    {
+        CHECK( after.messages - before.messages == sends );
+        CHECK( after.methodLookups == before.methodLookups );
+    }
+}
+
+// nil receivers give zero either way, the cache hands them to objc_msgSend
+static void checkNil()
+{
+    const ObjcStubCounts before = objcStubCounts();
+    CHECK( Buffer::lengthOf( nullptr ) == 0 );
+    CHECK( Buffer::scaledOf( nullptr, 2.0 ) == 0.0 );
+    CHECK( objcStubCounts().messages - before.messages == 2 );
+}
+
+// call sites shared by threads switching classes, the counts have to add up
+static void checkThreads()
+{
+    static constexpr int kThreads = 4;
+    static constexpr int kIterations = 20000;
+
+    const ObjcStubCounts before = objcStubCounts();
+    std::atomic<int> wrong( 0 );
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < kThreads; ++t )
+    {
+        threads.emplace_back( [ &, t ] {
+            for ( int i = 0; i < kIterations; ++i )
+            {
+                const bool isShared = ( ( i + t ) & 1 ) != 0;
+                Buffer* buffer = reinterpret_cast<Buffer*>( isShared ? &s_shared : &s_managed );
+                wrong += buffer->length() != ( isShared ? 64u : 1128u ) ? 1 : 0;
+                buffer->retain();
+                buffer->release();
+            }
+        } );
+    }
+    for ( std::thread& t : threads )
+    {
+        t.join();
+    }
+
+    CHECK( wrong == 0 );
+    CHECK( s_shared.references == 0 && s_managed.references == 0 );
+    const ObjcStubCounts after = objcStubCounts();
+    CHECK( kCached ? after.messages == before.messages : after.messages - before.messages == (size_t)kThreads * kIterations * 3 );
+    if ( kCached )
+    {
+        // only the managed buffer's retain and release are new, looked up once however
+        // many threads miss on them together
+        CHECK( after.methodLookups - before.methodLookups == 2 );
+    }
+}
+
+int main()
+{
+    s_shared.header.isa = makeClass( "StubSharedBuffer", (IMP)&sharedLength );
+    s_shared.length = 64;
+    s_managed.header.isa = makeClass( "StubManagedBuffer", (IMP)&managedLength );
+    s_managed.length = 128;
+
+    checkResults();
+    checkNil();
+    checkThreads();
+    return checkResult();
+}
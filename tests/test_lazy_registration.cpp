@@ -0,0 +1,164 @@
+/**
+  ******************************************************************************
+  * @file           : test_lazy_registration.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+// the private implementation of every framework, on the stub runtime. built twice,
+// once as metal-cpp ships and once with METALCPP_LAZY_REGISTRATION
+#define NS_PRIVATE_IMPLEMENTATION
+#define MTL_PRIVATE_IMPLEMENTATION
+#define MTK_PRIVATE_IMPLEMENTATION
+#define CA_PRIVATE_IMPLEMENTATION
+
+#include <Foundation/NSDefines.hpp>
+#include <Foundation/NSPrivate.hpp>
+#include <Metal/MTLHeaderBridge.hpp>
+#include <QuartzCore/CAPrivate.hpp>
+#include <AppKit/AppKitPrivate.hpp>
+#include <MetalKit/MetalKitPrivate.hpp>
+
+#include "check.hpp"
+#include "objc_stub.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(METALCPP_LAZY_REGISTRATION)
+static constexpr bool kLazy = true;
+#else
+static constexpr bool kLazy = false;
+#endif
+
+static size_t runtimeCalls( const ObjcStubCounts& counts )
+{
+    return counts.selectors + counts.classes + counts.protocols;
+}
+
+static void noop()
+{
+}
+
+// eager registration asks the runtime for every symbol of every framework before
+// main, lazy registration for none of them
+static void checkStartup( const ObjcStubCounts& atMain )
+{
+    if ( kLazy )
+    {
+        CHECK( runtimeCalls( atMain ) == 0 );
+    }
+    else
+    {
+        CHECK( atMain.selectors > 1000 );
+        CHECK( atMain.classes > 100 );
+        CHECK( atMain.protocols > 10 );
+    }
+}
+
+// the symbols come out the same either way, lazy ones cost a runtime call on first use
+// and nothing after
+static void checkResolve()
+{
+    const size_t before = runtimeCalls( objcStubCounts() );
+
+    const void* symbols[ 7 ];
+    {
+        using namespace MTL;
+        symbols[ 0 ] = _MTL_PRIVATE_SEL( newBufferWithLength_options_ );
+        symbols[ 1 ] = _MTL_PRIVATE_CLS( MTLRenderPipelineDescriptor );
+        symbols[ 2 ] = MTL::Private::Protocol::s_kMTLBuffer;
+    }
+    {
+        using namespace CA;
+        symbols[ 3 ] = _CA_PRIVATE_SEL( nextDrawable );
+    }
+    {
+        using namespace MTK;
+        symbols[ 4 ] = _MTK_PRIVATE_CLS( MTKView );
+    }
+    {
+        using namespace NS;
+        symbols[ 5 ] = _APPKIT_PRIVATE_SEL( applicationDidFinishLaunching_ );
+        symbols[ 6 ] = _NS_PRIVATE_CLS( NSValue );
+    }
+
+    const char* names[ 7 ] = { "newBufferWithLength:options:", "MTLRenderPipelineDescriptor", "MTLBuffer",
+                               "nextDrawable", "MTKView", "applicationDidFinishLaunching:", "NSValue" };
+    for ( int i = 0; i < 7; ++i )
+    {
+        CHECK( symbols[ i ] && strcmp( objcStubName( symbols[ i ] ), names[ i ] ) == 0 );
+    }
+    CHECK( runtimeCalls( objcStubCounts() ) - before == ( kLazy ? 7 : 0 ) );
+
+    // cached from here on, and the conversions the frameworks rely on still work
+    for ( int i = 0; i < 1000; ++i )
+    {
+        using namespace MTL;
+        CHECK( (const void*)_MTL_PRIVATE_SEL( newBufferWithLength_options_ ) == symbols[ 0 ] );
+        CHECK( (const void*)_MTL_PRIVATE_CLS( MTLRenderPipelineDescriptor ) == symbols[ 1 ] );
+    }
+    {
+        using namespace NS;
+        CHECK( class_addMethod( (Class)_NS_PRIVATE_CLS( NSValue ), _APPKIT_PRIVATE_SEL( applicationDidFinishLaunching_ ), (IMP)&noop, "v@:@" ) );
+    }
+    CHECK( runtimeCalls( objcStubCounts() ) - before == ( kLazy ? 7 : 0 ) );
+
+#if defined(METALCPP_LAZY_REGISTRATION)
+    CHECK( NS::Private::lazyResolveCount() == 7 );
+#endif
+}
+
+// threads racing on the first use of a symbol all get the same one. the runtime may be
+// asked once per thread, never more
+static void checkRace()
+{
+    static constexpr int kThreads = 8;
+
+    const size_t before = objcStubCounts().selectors;
+    std::atomic<bool> go( false );
+    std::vector<SEL> seen( kThreads );
+    std::vector<std::thread> threads;
+    for ( int i = 0; i < kThreads; ++i )
+    {
+        threads.emplace_back( [ &, i ] {
+            while ( !go.load() )
+            {
+            }
+            using namespace MTL;
+            seen[ i ] = _MTL_PRIVATE_SEL( newCommandQueue );
+        } );
+    }
+    go = true;
+    for ( std::thread& t : threads )
+    {
+        t.join();
+    }
+
+    for ( SEL selector : seen )
+    {
+        CHECK( selector == seen[ 0 ] );
+    }
+    CHECK( strcmp( objcStubName( seen[ 0 ] ), "newCommandQueue" ) == 0 );
+    const size_t calls = objcStubCounts().selectors - before;
+    CHECK( kLazy ? calls >= 1 && calls <= kThreads : calls == 0 );
+}
+
+int main()
+{
+    const ObjcStubCounts atMain = objcStubCounts();
+    __builtin_printf( "%s registration, before main: %zu selectors, %zu classes, %zu protocols\n", kLazy ? "lazy" : "eager",
+                      atMain.selectors, atMain.classes, atMain.protocols );
+
+    checkStartup( atMain );
+    checkResolve();
+    checkRace();
+    return checkResult();
+}
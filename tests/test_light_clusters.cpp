@@ -0,0 +1,237 @@
+/**
+  ******************************************************************************
+  * @file           : test_light_clusters.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "job_system.hpp"
+#include "light_clusters.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using shader_types::ClusterGrid;
+using shader_types::ClusterLight;
+
+static constexpr float kFovY = 45.f * (float)M_PI / 180.f;
+static constexpr float kAspect = 16.f / 9.f;
+
+// the binning kernel's loop, as benchmarks/bench_light_clusters.cpp has it: every
+// cluster tests every light against its box, then spots against its bounding sphere
+static void binPerCluster( const ClusterGrid& grid, const ClusterLight* lights, size_t count,
+                           std::vector<uint32_t>& counts, std::vector<uint16_t>& indices )
+{
+    for ( uint32_t z = 0; z < grid.slices; ++z )
+    {
+        const float dn = exp2f( ( (float)z - grid.sliceBias ) / grid.sliceScale );
+        const float df = exp2f( ( (float)( z + 1 ) - grid.sliceBias ) / grid.sliceScale );
+        for ( uint32_t y = 0; y < grid.tilesY; ++y )
+        {
+            const float top = -( -1.f + 2.f * (float)y / (float)grid.tilesY ) * grid.tanHalfFovY;
+            const float bottom = -( -1.f + 2.f * (float)( y + 1 ) / (float)grid.tilesY ) * grid.tanHalfFovY;
+            const float minY = std::min( bottom * dn, bottom * df );
+            const float maxY = std::max( top * dn, top * df );
+            for ( uint32_t x = 0; x < grid.tilesX; ++x )
+            {
+                const float left = ( -1.f + 2.f * (float)x / (float)grid.tilesX ) * grid.tanHalfFovX;
+                const float right = ( -1.f + 2.f * (float)( x + 1 ) / (float)grid.tilesX ) * grid.tanHalfFovX;
+                const float minX = std::min( left * dn, left * df );
+                const float maxX = std::max( right * dn, right * df );
+
+                const float hx = ( maxX - minX ) * 0.5f;
+                const float hy = ( maxY - minY ) * 0.5f;
+                const float hz = ( df - dn ) * 0.5f;
+                const float center[ 3 ] = { minX + hx, minY + hy, -( dn + hz ) };
+                const float radius = sqrtf( hx * hx + hy * hy + hz * hz );
+
+                const uint32_t c = ( z * grid.tilesY + y ) * grid.tilesX + x;
+                uint32_t n = 0;
+                for ( size_t i = 0; i < count; ++i )
+                {
+                    const ClusterLight& l = lights[ i ];
+                    const float depth = -l.position.z;
+                    const float dz = std::max( std::max( dn - depth, depth - df ), 0.f );
+                    const float dy = std::max( std::max( minY - l.position.y, l.position.y - maxY ), 0.f );
+                    const float dx = std::max( std::max( minX - l.position.x, l.position.x - maxX ), 0.f );
+                    const float rem = l.range * l.range - dz * dz - dy * dy;
+                    if ( rem < 0.f || dx * dx > rem )
+                    {
+                        continue;
+                    }
+                    if ( l.spotCosOuter > -1.f )
+                    {
+                        const float v[ 3 ] = { center[ 0 ] - l.position.x, center[ 1 ] - l.position.y, center[ 2 ] - l.position.z };
+                        const float along = v[ 0 ] * l.direction.x + v[ 1 ] * l.direction.y + v[ 2 ] * l.direction.z;
+                        const float sinOuter = sqrtf( std::max( 1.f - l.spotCosOuter * l.spotCosOuter, 0.f ) );
+                        const float lenSq = v[ 0 ] * v[ 0 ] + v[ 1 ] * v[ 1 ] + v[ 2 ] * v[ 2 ];
+                        const float closest = l.spotCosOuter * sqrtf( std::max( lenSq - along * along, 0.f ) ) - along * sinOuter;
+                        if ( closest > radius || along > radius + l.range || along < -radius )
+                        {
+                            continue;
+                        }
+                    }
+                    if ( n < grid.maxLightsPerCluster )
+                    {
+                        indices[ (size_t)c * grid.maxLightsPerCluster + n ] = (uint16_t)i;
+                    }
+                    ++n;
+                }
+                counts[ c ] = std::min( n, grid.maxLightsPerCluster );
+            }
+        }
+    }
+}
+
+static ClusterLight pointLight( float x, float y, float z, float range )
+{
+    ClusterLight l = {};
+    l.position = { x, y, z };
+    l.range = range;
+    l.color = { 1.f, 1.f, 1.f };
+    l.direction = { 0.f, 0.f, -1.f };
+    l.spotCosOuter = -1.f;
+    l.spotCosInner = -1.f;
+    return l;
+}
+
+static ClusterLight spotLight( float x, float y, float z, float range, float dx, float dy, float dz, float outerAngle )
+{
+    ClusterLight l = pointLight( x, y, z, range );
+    const float s = 1.f / sqrtf( dx * dx + dy * dy + dz * dz );
+    l.direction = { dx * s, dy * s, dz * s };
+    l.spotCosOuter = cosf( outerAngle );
+    l.spotCosInner = cosf( outerAngle * 0.7f );
+    return l;
+}
+
+// bins on the job system and compares every count and every listed index with the
+// per cluster loop, returns the number of clusters that differ
+static size_t compareWithReference( JobSystem& jobs, const ClusterGrid& grid, const std::vector<ClusterLight>& lights )
+{
+    LightClusters clusters( jobs, grid );
+    clusters.bin( lights.data(), lights.size() );
+
+    std::vector<uint32_t> counts( clusters.clusterCount() );
+    std::vector<uint16_t> indices( clusters.clusterCount() * grid.maxLightsPerCluster );
+    binPerCluster( grid, lights.data(), lights.size(), counts, indices );
+
+    size_t differing = 0;
+    size_t references = 0;
+    for ( size_t c = 0; c < clusters.clusterCount(); ++c )
+    {
+        bool same = clusters.counts()[ c ] == counts[ c ];
+        const size_t base = c * grid.maxLightsPerCluster;
+        for ( uint32_t i = 0; same && i < counts[ c ]; ++i )
+        {
+            same = clusters.indices()[ base + i ] == indices[ base + i ];
+        }
+        differing += !same;
+        references += counts[ c ];
+    }
+    CHECK( clusters.stats().references == references );
+    return differing;
+}
+
+int main()
+{
+    JobSystem jobs( 4 );
+    JobSystem serial( 1 );
+
+    // the benchmark's scene: 10k small lights through the frustum, every fourth a spot
+    const ClusterGrid grid = makeClusterGrid( 16, 9, 24, 256, kFovY, kAspect, 0.5f, 50.f, 1920, 1080 );
+    std::mt19937 rng( 1 );
+    std::uniform_real_distribution<float> u( 0.f, 1.f );
+    std::vector<ClusterLight> lights;
+    for ( size_t i = 0; i < 10000; ++i )
+    {
+        const float depth = 1.f + 44.f * u( rng );
+        const float x = ( 2.f * u( rng ) - 1.f ) * grid.tanHalfFovX * depth;
+        const float y = ( 2.f * u( rng ) - 1.f ) * grid.tanHalfFovY * depth;
+        const float range = 0.4f + 0.6f * u( rng );
+        if ( i % 4 == 0 )
+        {
+            const float a = 2.f * (float)M_PI * u( rng );
+            const float tilt = 0.5f * u( rng );
+            lights.push_back( spotLight( x, y, -depth, range * 2.f, sinf( tilt ) * cosf( a ), sinf( tilt ) * sinf( a ), -cosf( tilt ), 0.5f ) );
+        }
+        else
+        {
+            lights.push_back( pointLight( x, y, -depth, range ) );
+        }
+    }
+    CHECK( compareWithReference( jobs, grid, lights ) == 0 );
+    CHECK( compareWithReference( serial, grid, lights ) == 0 );
+
+    // lights sitting on tile and slice boundaries, reaching into the neighbours on
+    // both sides, including spots pointing along and across the boundary planes
+    lights.clear();
+    for ( uint32_t s = 1; s < grid.slices; s += 3 )
+    {
+        const float depth = exp2f( ( (float)s - grid.sliceBias ) / grid.sliceScale );
+        for ( uint32_t x = 1; x < grid.tilesX; x += 2 )
+        {
+            const float ndcX = -1.f + 2.f * (float)x / (float)grid.tilesX;
+            for ( uint32_t y = 1; y < grid.tilesY; y += 2 )
+            {
+                const float ndcY = 1.f - 2.f * (float)y / (float)grid.tilesY;
+                const float px = ndcX * grid.tanHalfFovX * depth;
+                const float py = ndcY * grid.tanHalfFovY * depth;
+                lights.push_back( pointLight( px, py, -depth, 0.05f * depth ) );
+                lights.push_back( spotLight( px, py, -depth, 0.2f * depth, 0.f, 0.f, -1.f, 0.3f ) );
+                lights.push_back( spotLight( px, py, -depth, 0.2f * depth, 1.f, 0.f, 0.f, 0.4f ) );
+                lights.push_back( spotLight( px, py, -depth, 0.2f * depth, 0.f, -1.f, 0.2f, 0.6f ) );
+            }
+        }
+    }
+    // and one spanning the whole depth range, behind the near plane and past the far one
+    lights.push_back( pointLight( 0.f, 0.f, -0.2f, 80.f ) );
+    lights.push_back( spotLight( 0.f, 0.f, 1.f, 70.f, 0.f, 0.f, -1.f, 0.2f ) );
+    CHECK( compareWithReference( jobs, grid, lights ) == 0 );
+
+    // a tight grid cap: the crowded clusters keep their lowest light indices and the
+    // rest are counted as dropped
+    const ClusterGrid capped = makeClusterGrid( 13, 7, 16, 8, kFovY, kAspect, 0.5f, 50.f, 1280, 720 );
+    lights.clear();
+    for ( size_t i = 0; i < 600; ++i )
+    {
+        const float depth = 4.f + 2.f * u( rng );
+        const float x = ( u( rng ) - 0.5f ) * depth * 0.4f;
+        const float y = ( u( rng ) - 0.5f ) * depth * 0.4f;
+        if ( i % 3 == 0 )
+        {
+            lights.push_back( spotLight( x, y, -depth, 3.f, u( rng ) - 0.5f, u( rng ) - 0.5f, -1.f, 0.6f ) );
+        }
+        else
+        {
+            lights.push_back( pointLight( x, y, -depth, 1.f + u( rng ) ) );
+        }
+    }
+    CHECK( compareWithReference( jobs, capped, lights ) == 0 );
+    CHECK( compareWithReference( serial, capped, lights ) == 0 );
+
+    LightClusters clusters( jobs, capped );
+    clusters.bin( lights.data(), lights.size() );
+    const LightClusterStats stats = clusters.stats();
+    CHECK( stats.dropped > 0 && stats.maxCount > capped.maxLightsPerCluster );
+    size_t full = 0;
+    for ( size_t c = 0; c < clusters.clusterCount(); ++c )
+    {
+        full += clusters.counts()[ c ] == capped.maxLightsPerCluster;
+    }
+    CHECK( full > 0 );
+
+    // no lights, no references
+    clusters.bin( lights.data(), 0 );
+    CHECK( clusters.stats().references == 0 && clusters.counts()[ 0 ] == 0 );
+
+    return checkResult();
+}
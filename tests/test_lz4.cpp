@@ -0,0 +1,138 @@
+/**
+  ******************************************************************************
+  * @file           : test_lz4.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "lz4.hpp"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+// buffers are sized exactly, so a build with -DPLAYGROUND_SANITIZE=ON catches any read
+// or write past them
+
+// from incompressible noise to long runs, with repeats at near and far offsets
+static std::vector<uint8_t> makeInput( std::mt19937& rng, size_t size )
+{
+    std::vector<uint8_t> data( size );
+    const uint32_t kind = rng() % 4;
+    for ( size_t i = 0; i < size; ++i )
+    {
+        switch ( kind )
+        {
+            case 0: data[ i ] = (uint8_t)rng(); break;
+            case 1: data[ i ] = (uint8_t)( rng() % 4 ); break;
+            case 2: data[ i ] = (uint8_t)( i / ( 1 + rng() % 300 ) ); break;
+            default:
+                data[ i ] = i >= 70000 && rng() % 8 ? data[ i - 70000 + rng() % 8 ] : i >= 12 && rng() % 3 ? data[ i - 1 - rng() % 12 ] : (uint8_t)rng();
+                break;
+        }
+    }
+    return data;
+}
+
+static void checkRoundTrip( std::mt19937& rng, size_t size )
+{
+    const std::vector<uint8_t> input = makeInput( rng, size );
+    for ( int level = kLz4MinLevel; level <= kLz4MaxLevel; ++level )
+    {
+        std::vector<uint8_t> packed( lz4CompressBound( size ) );
+        const size_t packedSize = lz4Compress( input.data(), size, packed.data(), packed.size(), level );
+        CHECK( packedSize > 0 && packedSize <= packed.size() );
+        packed.resize( packedSize );
+
+        std::vector<uint8_t> output( size );
+        CHECK( lz4Decompress( packed.data(), packed.size(), output.data(), output.size() ) );
+        CHECK( output == input );
+
+        // the size has to match exactly, one byte more or less fails
+        if ( size > 0 )
+        {
+            std::vector<uint8_t> shorter( size - 1 );
+            CHECK( !lz4Decompress( packed.data(), packed.size(), shorter.data(), shorter.size() ) );
+        }
+        std::vector<uint8_t> longer( size + 1 );
+        CHECK( !lz4Decompress( packed.data(), packed.size(), longer.data(), longer.size() ) );
+    }
+}
+
+// corrupt streams may decode to garbage but never touch memory outside the buffers
+static void checkCorruption( std::mt19937& rng, size_t size )
+{
+    const std::vector<uint8_t> input = makeInput( rng, size );
+    std::vector<uint8_t> packed( lz4CompressBound( size ) );
+    packed.resize( lz4Compress( input.data(), size, packed.data(), packed.size(), 1 + (int)( rng() % kLz4MaxLevel ) ) );
+
+    for ( int round = 0; round < 64; ++round )
+    {
+        std::vector<uint8_t> broken = packed;
+        switch ( rng() % 4 )
+        {
+            case 0:
+                broken[ rng() % broken.size() ] ^= (uint8_t)( 1 + rng() % 255 );
+                break;
+            case 1:
+                for ( int i = 0; i < 8; ++i )
+                {
+                    broken[ rng() % broken.size() ] = (uint8_t)rng();
+                }
+                break;
+            case 2:
+                broken.resize( rng() % broken.size() );
+                break;
+            default:
+                // lengths of 255s run past the end of the stream
+                broken[ rng() % broken.size() ] = 0xff;
+                broken.insert( broken.begin() + (long)( rng() % broken.size() ), 16, (uint8_t)0xff );
+                break;
+        }
+
+        const size_t outputSize = rng() % 4 ? size : rng() % ( 2 * size + 1 );
+        std::vector<uint8_t> output( outputSize );
+        std::vector<uint8_t> source( broken );
+        lz4Decompress( source.data(), source.size(), output.data(), output.size() );
+    }
+}
+
+int main()
+{
+    std::mt19937 rng( 1 );
+
+    // tiny inputs are all literals, the edges of the match limits, then real sizes
+    for ( size_t size = 0; size <= 40; ++size )
+    {
+        checkRoundTrip( rng, size );
+    }
+    for ( int i = 0; i < 24; ++i )
+    {
+        checkRoundTrip( rng, 1 + rng() % ( 256 << 10 ) );
+    }
+
+    for ( int i = 0; i < 200; ++i )
+    {
+        checkCorruption( rng, 1 + rng() % ( 16 << 10 ) );
+    }
+
+    // plain noise as a stream
+    for ( int i = 0; i < 2000; ++i )
+    {
+        std::vector<uint8_t> noise( rng() % 512 );
+        for ( uint8_t& b : noise )
+        {
+            b = (uint8_t)rng();
+        }
+        std::vector<uint8_t> output( rng() % 4096 );
+        lz4Decompress( noise.data(), noise.size(), output.data(), output.size() );
+    }
+
+    return checkResult();
+}
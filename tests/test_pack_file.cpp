@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file           : test_pack_file.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "job_system.hpp"
+#include "pack_file.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static std::vector<uint8_t> readFile( const char* path )
+{
+    std::vector<uint8_t> bytes;
+    FILE* f = fopen( path, "rb" );
+    if ( !f )
+    {
+        return bytes;
+    }
+    uint8_t buffer[ 4096 ];
+    for ( size_t n; ( n = fread( buffer, 1, sizeof( buffer ), f ) ) > 0; )
+    {
+        bytes.insert( bytes.end(), buffer, buffer + n );
+    }
+    fclose( f );
+    return bytes;
+}
+
+static bool writeFile( const char* path, const std::vector<uint8_t>& bytes )
+{
+    FILE* f = fopen( path, "wb" );
+    if ( !f )
+    {
+        return false;
+    }
+    const bool ok = fwrite( bytes.data(), 1, bytes.size(), f ) == bytes.size();
+    return fclose( f ) == 0 && ok;
+}
+
+// a pack with its header changed opens or not, whatever it claims
+static bool opensWith( const char* path, const std::vector<uint8_t>& pack, const PackHeader& header )
+{
+    std::vector<uint8_t> bytes = pack;
+    memcpy( bytes.data(), &header, sizeof( header ) );
+    PackReader reader;
+    return writeFile( path, bytes ) && reader.open( path );
+}
+
+int main()
+{
+    const char* path = "test_pack_file.tmp";
+    JobSystem jobs( 2 );
+
+    // one compressible entry over several chunks, one stored, one empty
+    std::vector<uint8_t> mesh( 3 * kPackChunkSize + 100 );
+    for ( size_t i = 0; i < mesh.size(); ++i )
+    {
+        mesh[ i ] = (uint8_t)( i / 64 );
+    }
+    std::vector<uint8_t> texture( 5000 );
+    for ( size_t i = 0; i < texture.size(); ++i )
+    {
+        texture[ i ] = (uint8_t)( i * 131 );
+    }
+
+    PackWriter writer( jobs );
+    writer.add( "mesh", mesh.data(), mesh.size(), 3 );
+    writer.add( "texture", texture.data(), texture.size(), 0 );
+    writer.add( "empty", nullptr, 0, 1 );
+    CHECK( writer.write( path ) );
+
+    {
+        PackReader reader;
+        CHECK( reader.open( path ) );
+        CHECK( reader.entryCount() == 3 );
+        const int m = reader.find( "mesh" );
+        const int t = reader.find( "texture" );
+        CHECK( m >= 0 && t >= 0 && reader.find( "missing" ) < 0 );
+        if ( m >= 0 && t >= 0 )
+        {
+            std::vector<uint8_t> out( mesh.size() );
+            CHECK( reader.read( jobs, (uint32_t)m, out.data() ) && out == mesh );
+            CHECK( reader.mapped( (uint32_t)m ) == nullptr );
+            const void* stored = reader.mapped( (uint32_t)t );
+            CHECK( stored && memcmp( stored, texture.data(), texture.size() ) == 0 );
+        }
+    }
+
+    const std::vector<uint8_t> pack = readFile( path );
+    CHECK( pack.size() > sizeof( PackHeader ) );
+    PackHeader header;
+    memcpy( &header, pack.data(), sizeof( header ) );
+
+    // counts whose sizes add up to the real toc size once the sum wraps: 2^27 more
+    // entries are 2^32 more bytes, taken back out of a names size that wraps below zero.
+    // the checksum covers the same bytes, so only bounding every part on its own helps.
+    // on an empty pack the entries would be read from past the end of the mapping
+    PackWriter emptyWriter( jobs );
+    CHECK( emptyWriter.write( path ) );
+    const std::vector<uint8_t> emptyPack = readFile( path );
+    CHECK( emptyPack.size() == sizeof( PackHeader ) );
+    PackHeader emptyHeader;
+    memcpy( &emptyHeader, emptyPack.data(), sizeof( emptyHeader ) );
+    CHECK( opensWith( path, emptyPack, emptyHeader ) );
+    emptyHeader.entryCount += 1u << 27;
+    emptyHeader.namesSize -= 1ull << 32;
+    CHECK( !opensWith( path, emptyPack, emptyHeader ) );
+
+    PackHeader wrapped = header;
+    wrapped.entryCount += 1u << 27;
+    wrapped.namesSize -= 1ull << 32;
+    CHECK( !opensWith( path, pack, wrapped ) );
+
+    PackHeader names = header;
+    names.namesSize = ~0ull;
+    CHECK( !opensWith( path, pack, names ) );
+
+    PackHeader chunks = header;
+    chunks.chunkCount = ~0u;
+    CHECK( !opensWith( path, pack, chunks ) );
+
+    // a toc byte flipped fails the checksum, a cut off file the bounds
+    std::vector<uint8_t> flipped = pack;
+    flipped[ sizeof( PackHeader ) + 3 ] ^= 1;
+    PackReader reader;
+    CHECK( writeFile( path, flipped ) && !reader.open( path ) );
+    const std::vector<uint8_t> truncated( pack.begin(), pack.begin() + (long)( sizeof( PackHeader ) + 8 ) );
+    CHECK( writeFile( path, truncated ) && !reader.open( path ) );
+
+    remove( path );
+    return checkResult();
+}
@@ -0,0 +1,155 @@
+/**
+  ******************************************************************************
+  * @file           : test_parallel_encoder.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "parallel_encoder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// what MTL::ParallelRenderCommandEncoder does with its children, on the cpu: each
+// child records its own commands, and they run in the order the children were made
+class StandInEncoder {
+private:
+    std::vector<size_t> _draws;
+    bool _ended = false;
+
+public:
+    void draw( size_t index ) { _draws.push_back( index ); }
+    void endEncoding() { _ended = true; }
+
+    const std::vector<size_t>& draws() const { return _draws; }
+    bool ended() const { return _ended; }
+};
+
+class StandInParallelEncoder {
+private:
+    std::vector<std::unique_ptr<StandInEncoder>> _children;
+    std::thread::id _creator;
+    bool _createdElsewhere = false;
+
+public:
+    StandInParallelEncoder() : _creator( std::this_thread::get_id() ) {}
+
+    StandInEncoder* renderCommandEncoder()
+    {
+        _createdElsewhere = _createdElsewhere || std::this_thread::get_id() != _creator;
+        _children.push_back( std::make_unique<StandInEncoder>() );
+        return _children.back().get();
+    }
+
+    size_t childCount() const { return _children.size(); }
+    bool createdElsewhere() const { return _createdElsewhere; }
+    bool allEnded() const
+    {
+        for ( const std::unique_ptr<StandInEncoder>& child : _children )
+        {
+            if ( !child->ended() )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // the draws as the gpu would see them
+    std::vector<size_t> execute() const
+    {
+        std::vector<size_t> draws;
+        for ( const std::unique_ptr<StandInEncoder>& child : _children )
+        {
+            draws.insert( draws.end(), child->draws().begin(), child->draws().end() );
+        }
+        return draws;
+    }
+};
+
+static void checkPartition( size_t drawCount, size_t partitionCount, size_t minDraws )
+{
+    const std::vector<DrawRange> ranges = partitionDraws( drawCount, partitionCount, minDraws );
+    if ( drawCount == 0 )
+    {
+        CHECK( ranges.empty() );
+        return;
+    }
+
+    CHECK( !ranges.empty() && ranges.size() <= std::max<size_t>( partitionCount, 1 ) );
+    CHECK( ranges.front().begin == 0 && ranges.back().end == drawCount );
+
+    size_t smallest = drawCount, largest = 0;
+    for ( size_t i = 0; i < ranges.size(); ++i )
+    {
+        CHECK( ranges[ i ].end > ranges[ i ].begin );
+        if ( i > 0 )
+        {
+            CHECK( ranges[ i ].begin == ranges[ i - 1 ].end );
+        }
+        smallest = std::min( smallest, ranges[ i ].end - ranges[ i ].begin );
+        largest = std::max( largest, ranges[ i ].end - ranges[ i ].begin );
+    }
+    CHECK( largest - smallest <= 1 );
+    CHECK( ranges.size() == 1 || smallest >= minDraws );
+}
+
+int main()
+{
+    for ( size_t drawCount : { 0, 1, 2, 7, 64, 100, 1000, 1001 } )
+    {
+        for ( size_t partitionCount : { 0, 1, 3, 4, 8, 16 } )
+        {
+            for ( size_t minDraws : { 0, 1, 10, 64 } )
+            {
+                checkPartition( drawCount, partitionCount, minDraws );
+            }
+        }
+    }
+
+    // 10 draws over 3 partitions: the remainder goes to the first range
+    const std::vector<DrawRange> ranges = partitionDraws( 10, 3, 1 );
+    CHECK( ranges.size() == 3 );
+    CHECK( ranges[0].end == 4 && ranges[1].end == 7 && ranges[2].end == 10 );
+
+    // too few draws for the minimum keeps them in one range
+    CHECK( partitionDraws( 50, 8, 64 ).size() == 1 );
+
+    // whichever worker finishes first, the draws execute in list order
+    JobSystem jobs( 4 );
+    for ( size_t drawCount : { 1, 5, 33, 4096 } )
+    {
+        StandInParallelEncoder parallel;
+        const size_t children = encodeParallel( jobs, &parallel, drawCount, 4, []( StandInEncoder* child, size_t begin, size_t end ) {
+            // later draws first would expose any reordering
+            std::this_thread::sleep_for( std::chrono::microseconds( begin == 0 ? 200 : 0 ) );
+            for ( size_t i = begin; i < end; ++i )
+            {
+                child->draw( i );
+            }
+        } );
+
+        CHECK( children == parallel.childCount() );
+        CHECK( children == partitionDraws( drawCount, jobs.threadCount(), 4 ).size() );
+        CHECK( !parallel.createdElsewhere() );
+        CHECK( parallel.allEnded() );
+
+        const std::vector<size_t> draws = parallel.execute();
+        CHECK( draws.size() == drawCount );
+        for ( size_t i = 0; i < draws.size(); ++i )
+        {
+            CHECK( draws[ i ] == i );
+        }
+    }
+
+    return checkResult();
+}
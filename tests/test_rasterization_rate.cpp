@@ -0,0 +1,241 @@
+/**
+  ******************************************************************************
+  * @file           : test_rasterization_rate.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "rasterization_rate.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+static constexpr uint32_t kColumns = 16;
+static constexpr uint32_t kRows = 9;
+
+struct Rect
+{
+    float u0, v0, u1, v1;
+};
+
+static void checkContent()
+{
+    const RateMapSettings settings = makeRateMapSettings( kColumns, kRows );
+    RateMapBuilder builder( settings );
+    std::mt19937 rng( 1 );
+    std::uniform_real_distribution<float> u( -0.2f, 1.2f );
+
+    // the density of the zones adds up to the area of the rects, in zones, with the
+    // parts off screen cut away
+    int wrongTotal = 0;
+    for ( int frame = 0; frame < 100; ++frame )
+    {
+        builder.beginFrame( 1920, 1080 );
+        double area = 0.0;
+        for ( int i = 0; i < 50; ++i )
+        {
+            const float a = u( rng ), b = u( rng ), c = u( rng ), d = u( rng );
+            const Rect r = { std::min( a, b ), std::min( c, d ), std::max( a, b ), std::max( c, d ) };
+            builder.addContent( r.u0, r.v0, r.u1, r.v1, 0.5f );
+            const float w = std::max( 0.f, std::min( r.u1, 1.f ) - std::max( r.u0, 0.f ) );
+            const float h = std::max( 0.f, std::min( r.v1, 1.f ) - std::max( r.v0, 0.f ) );
+            area += 0.5 * w * h;
+        }
+        double total = 0.0;
+        for ( uint32_t y = 0; y < kRows; ++y )
+        {
+            for ( uint32_t x = 0; x < kColumns; ++x )
+            {
+                total += builder.density( x, y );
+            }
+        }
+        wrongTotal += fabs( total - area * kColumns * kRows ) > 1e-3 * std::max( 1.0, area * kColumns * kRows );
+    }
+    CHECK( wrongTotal == 0 );
+
+    // a rect inside one zone only touches that zone, empty and off screen ones nothing
+    builder.beginFrame( 1920, 1080 );
+    builder.addContent( 2.2f / kColumns, 3.1f / kRows, 2.7f / kColumns, 3.6f / kRows, 2.f );
+    builder.addContent( 0.5f, 0.5f, 0.5f, 0.6f, 1.f );
+    builder.addContent( 1.1f, 0.2f, 1.5f, 0.4f, 1.f );
+    CHECK( fabsf( builder.density( 2, 3 ) - 2.f * 0.5f * 0.5f ) < 1e-5f );
+    double others = 0.0;
+    for ( uint32_t y = 0; y < kRows; ++y )
+    {
+        for ( uint32_t x = 0; x < kColumns; ++x )
+        {
+            others += ( x == 2 && y == 3 ) ? 0.f : builder.density( x, y );
+        }
+    }
+    CHECK( others == 0.0 );
+
+    // beginFrame() clears the last frame's content
+    builder.beginFrame( 1920, 1080 );
+    CHECK( builder.density( 2, 3 ) == 0.f );
+}
+
+static void checkRates()
+{
+    const RateMapSettings settings = makeRateMapSettings( kColumns, kRows );
+    RateMapBuilder builder( settings );
+    std::mt19937 rng( 2 );
+    std::uniform_real_distribution<float> u( -0.2f, 1.2f );
+
+    // every zone gets at least the rate it wants: the column and row rates are the
+    // highest of their zones, and no rate leaves minRate..1
+    int outOfRange = 0;
+    int belowZone = 0;
+    int notTight = 0;
+    for ( int frame = 0; frame < 100; ++frame )
+    {
+        builder.beginFrame( 1920, 1080 );
+        for ( int i = 0; i < 20; ++i )
+        {
+            const float a = u( rng ), b = u( rng ), c = u( rng ), d = u( rng );
+            builder.addContent( std::min( a, b ), std::min( c, d ), std::max( a, b ), std::max( c, d ), 1.f );
+        }
+        builder.build( u( rng ), u( rng ) );
+
+        for ( uint32_t x = 0; x < kColumns; ++x )
+        {
+            float highest = settings.minRate;
+            for ( uint32_t y = 0; y < kRows; ++y )
+            {
+                const float zone = builder.zoneRate( x, y );
+                outOfRange += zone < settings.minRate || zone > 1.f;
+                belowZone += builder.horizontal()[ x ] < zone || builder.vertical()[ y ] < zone;
+                highest = std::max( highest, zone );
+            }
+            notTight += builder.horizontal()[ x ] != highest;
+        }
+    }
+    CHECK( outOfRange == 0 );
+    CHECK( belowZone == 0 );
+    CHECK( notTight == 0 );
+
+    // no content is the lowest rate everywhere, whatever the focus
+    builder.beginFrame( 1920, 1080 );
+    builder.build( 0.5f, 0.5f );
+    CHECK( std::all_of( builder.horizontal(), builder.horizontal() + kColumns, [&]( float r ) { return r == settings.minRate; } ) );
+    CHECK( std::all_of( builder.vertical(), builder.vertical() + kRows, [&]( float r ) { return r == settings.minRate; } ) );
+
+    // full content is full rate at the focus and falls off away from it
+    builder.beginFrame( 1920, 1080 );
+    builder.addContent( 0.f, 0.f, 1.f, 1.f, 1.f );
+    builder.build( 0.5f, 0.5f );
+    CHECK( builder.horizontal()[ 7 ] == 1.f && builder.horizontal()[ 8 ] == 1.f && builder.vertical()[ 4 ] == 1.f );
+    CHECK( builder.horizontal()[ 0 ] < 0.6f && builder.horizontal()[ 15 ] < 0.6f );
+    CHECK( builder.horizontal()[ 0 ] == builder.horizontal()[ 15 ] );
+    for ( uint32_t x = 1; x < kColumns / 2; ++x )
+    {
+        CHECK( builder.horizontal()[ x ] >= builder.horizontal()[ x - 1 ] );
+    }
+
+    // and follows the focus
+    builder.build( 0.05f, 0.5f );
+    CHECK( builder.horizontal()[ 0 ] == 1.f );
+    CHECK( builder.horizontal()[ 15 ] == settings.minRate );
+
+    // half the full density wants half way between minRate and 1 at the focus
+    builder.beginFrame( 1920, 1080 );
+    builder.addContent( 0.f, 0.f, 1.f, 1.f, settings.fullDensity * 0.5f );
+    builder.build( 0.5f, 0.5f );
+    CHECK( fabsf( builder.zoneRate( 8, 4 ) - ( settings.minRate + ( 1.f - settings.minRate ) * 0.5f ) ) < 1e-5f );
+}
+
+static void checkCost()
+{
+    // a small screen, so the fragments can be counted pixel by pixel
+    constexpr uint32_t kWidth = 320;
+    constexpr uint32_t kHeight = 180;
+    const RateMapSettings settings = makeRateMapSettings( kColumns, kRows );
+    RateMapBuilder builder( settings );
+    std::mt19937 rng( 3 );
+    std::uniform_real_distribution<float> u( -0.2f, 1.2f );
+
+    int wrongCount = 0;
+    int outOfBounds = 0;
+    for ( int frame = 0; frame < 20; ++frame )
+    {
+        std::vector<Rect> rects;
+        builder.beginFrame( kWidth, kHeight );
+        for ( int i = 0; i < 30; ++i )
+        {
+            const float a = u( rng ), b = u( rng ), c = u( rng ), d = u( rng );
+            rects.push_back( { std::min( a, b ), std::min( c, d ), std::max( a, b ), std::max( c, d ) } );
+            builder.addContent( rects.back().u0, rects.back().v0, rects.back().u1, rects.back().v1, 1.f );
+        }
+        builder.build( u( rng ), u( rng ) );
+        const ShadingCost cost = builder.estimateCost();
+
+        // screenFragments is the pixels the rects cover at full rate, each counted once
+        // per rect it is in
+        double pixels = 0.0;
+        for ( const Rect& r : rects )
+        {
+            for ( uint32_t y = 0; y < kHeight; ++y )
+            {
+                const float v = ( (float)y + 0.5f ) / (float)kHeight;
+                for ( uint32_t x = 0; x < kWidth && v >= r.v0 && v < r.v1; ++x )
+                {
+                    const float s = ( (float)x + 0.5f ) / (float)kWidth;
+                    pixels += s >= r.u0 && s < r.u1;
+                }
+            }
+        }
+        wrongCount += fabs( pixels - cost.screenFragments ) > 0.02 * std::max( 1.0, pixels );
+        outOfBounds += cost.shadedFragments > cost.screenFragments + 1e-6 || cost.physicalWidth > kWidth || cost.physicalHeight > kHeight;
+        outOfBounds += fabs( cost.reduction - ( 1.0 - cost.shadedFragments / cost.screenFragments ) ) > 1e-9;
+    }
+    CHECK( wrongCount == 0 );
+    CHECK( outOfBounds == 0 );
+
+    // no content: every column and row at minRate, a quarter of the size per axis, and
+    // nothing to shade either way
+    builder.beginFrame( 1920, 1080 );
+    builder.addContent( 0.f, 0.f, 1.f, 1.f, 0.f );
+    builder.build( 0.5f, 0.5f );
+    ShadingCost cost = builder.estimateCost();
+    CHECK( cost.screenFragments == 0.0 && cost.reduction == 0.0 );
+    CHECK( cost.physicalWidth == 480 && cost.physicalHeight == 270 );
+
+    // no focus anywhere near and full content: minRate is all the focus allows
+    RateMapSettings edge = settings;
+    edge.focusRadius = 0.f;
+    edge.focusFalloff = 0.f;
+    RateMapBuilder low( edge );
+    low.beginFrame( 1920, 1080 );
+    low.addContent( 0.f, 0.f, 1.f, 1.f, 1.f );
+    low.build( -10.f, -10.f );
+    cost = low.estimateCost();
+    // a sixteenth of the fragments
+    CHECK( fabs( cost.screenFragments - 1920.0 * 1080.0 ) < 1.0 );
+    CHECK( fabs( cost.reduction - ( 1.0 - 1.0 / 16.0 ) ) < 1e-6 );
+
+    // full rate where it is all needed saves nothing
+    RateMapSettings wide = settings;
+    wide.focusRadius = 10.f;
+    RateMapBuilder full( wide );
+    full.beginFrame( 1920, 1080 );
+    full.addContent( 0.f, 0.f, 1.f, 1.f, 1.f );
+    full.build( 0.5f, 0.5f );
+    cost = full.estimateCost();
+    CHECK( cost.reduction == 0.0 );
+    CHECK( cost.physicalWidth == 1920 && cost.physicalHeight == 1080 );
+}
+
+int main()
+{
+    checkContent();
+    checkRates();
+    checkCost();
+    return checkResult();
+}
@@ -0,0 +1,216 @@
+/**
+  ******************************************************************************
+  * @file           : test_render_graph_plan.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "render_graph_plan.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using Handle = RenderGraphPlan::Handle;
+
+// every transient resource in use is aligned and shares no memory with another
+// resource alive at the same time
+static void checkPlacement( const RenderGraphPlan& plan )
+{
+    size_t peak = 0;
+    for ( Handle a = 0; a < plan.resourceCount(); ++a )
+    {
+        const RenderGraphPlan::Resource& ra = plan.resource( a );
+        if ( ra.imported || ra.firstUse < 0 )
+        {
+            continue;
+        }
+        CHECK( ra.offset % ra.align == 0 );
+        CHECK( ra.firstUse <= ra.lastUse );
+        peak = std::max( peak, ra.offset + ra.size );
+
+        for ( Handle b = a + 1; b < plan.resourceCount(); ++b )
+        {
+            const RenderGraphPlan::Resource& rb = plan.resource( b );
+            if ( rb.imported || rb.firstUse < 0 )
+            {
+                continue;
+            }
+            const bool liveTogether = ra.firstUse <= rb.lastUse && rb.firstUse <= ra.lastUse;
+            const bool overlap = ra.offset < rb.offset + rb.size && rb.offset < ra.offset + ra.size;
+            CHECK( !( liveTogether && overlap ) );
+        }
+    }
+    CHECK( peak == plan.peakBytes() );
+    CHECK( plan.peakBytes() <= plan.unaliasedBytes() );
+}
+
+int main()
+{
+    // the frame of 11-render-graph, with sizes in kb standing in for the heap's
+    RenderGraphPlan plan;
+    const Handle mandelbrot = plan.addResource( "mandelbrot", false );
+    const Handle sceneColor = plan.addResource( "sceneColor", false );
+    const Handle sceneDepth = plan.addResource( "sceneDepth", false );
+    const Handle bright = plan.addResource( "bright", false );
+    const Handle blurA = plan.addResource( "blurA", false );
+    const Handle blurB = plan.addResource( "blurB", false );
+    const Handle histogram = plan.addResource( "histogram", false );
+    const Handle backbuffer = plan.addResource( "backbuffer", true );
+
+    const Handle mandelbrotPass = plan.addPass( "mandelbrot" );
+    plan.write( mandelbrotPass, mandelbrot );
+    const Handle scenePass = plan.addPass( "scene" );
+    plan.read( scenePass, mandelbrot );
+    plan.write( scenePass, sceneColor );
+    plan.write( scenePass, sceneDepth );
+    const Handle histogramPass = plan.addPass( "histogram" );
+    plan.read( histogramPass, sceneColor );
+    plan.write( histogramPass, histogram );
+    const Handle brightPass = plan.addPass( "bright" );
+    plan.read( brightPass, sceneColor );
+    plan.write( brightPass, bright );
+    const Handle blurHPass = plan.addPass( "blurH" );
+    plan.read( blurHPass, bright );
+    plan.write( blurHPass, blurA );
+    const Handle blurVPass = plan.addPass( "blurV" );
+    plan.read( blurVPass, blurA );
+    plan.write( blurVPass, blurB );
+    const Handle compositePass = plan.addPass( "composite" );
+    plan.read( compositePass, sceneColor );
+    plan.read( compositePass, blurB );
+    plan.write( compositePass, backbuffer );
+
+    const size_t sizes[] = { 4096, 8192, 4096, 2048, 2048, 2048, 4, 0 };
+    std::vector<Handle> asked;
+    CHECK( plan.compile( [&]( Handle h ) {
+        asked.push_back( h );
+        return RenderGraphSizeAndAlign{ sizes[ h ] * 1024, h == histogram ? 256u : 65536u };
+    } ) );
+
+    // nothing reads the histogram, its pass goes and its buffer is never sized
+    CHECK( plan.culledPassCount() == 1 );
+    CHECK( !plan.pass( histogramPass ).live );
+    CHECK( plan.order().size() == 6 );
+    CHECK( plan.order().front() == mandelbrotPass && plan.order().back() == compositePass );
+    for ( Handle h : asked )
+    {
+        CHECK( h != histogram && h != backbuffer );
+    }
+    CHECK( plan.resource( histogram ).firstUse < 0 );
+
+    // lifetimes in steps of the live order
+    CHECK( plan.resource( mandelbrot ).firstUse == 0 && plan.resource( mandelbrot ).lastUse == 1 );
+    CHECK( plan.resource( sceneColor ).firstUse == 1 && plan.resource( sceneColor ).lastUse == 5 );
+    CHECK( plan.resource( sceneDepth ).firstUse == 1 && plan.resource( sceneDepth ).lastUse == 1 );
+    CHECK( plan.resource( blurB ).firstUse == 4 && plan.resource( blurB ).lastUse == 5 );
+
+    // the peak is the scene pass, where the mandelbrot, color and depth are all alive.
+    // the blur chain fits in what the mandelbrot and the depth leave behind
+    checkPlacement( plan );
+    CHECK( plan.peakBytes() == ( 4096 + 8192 + 4096 ) * 1024 );
+    CHECK( plan.unaliasedBytes() == ( 4096 + 8192 + 4096 + 3 * 2048 ) * 1024 );
+
+    // a side effect keeps a pass and what it reads, even with no consumer
+    plan.reset();
+    const Handle buffer = plan.addResource( "readback", false );
+    const Handle producer = plan.addPass( "produce" );
+    plan.write( producer, buffer );
+    const Handle unused = plan.addPass( "unused" );
+    plan.read( unused, buffer );
+    plan.compile( []( Handle ) { return RenderGraphSizeAndAlign{ 64, 16 }; } );
+    CHECK( plan.order().empty() && plan.culledPassCount() == 2 );
+
+    plan.reset();
+    const Handle buffer2 = plan.addResource( "readback", false );
+    const Handle producer2 = plan.addPass( "produce" );
+    plan.write( producer2, buffer2 );
+    const Handle readback = plan.addPass( "readback" );
+    plan.read( readback, buffer2 );
+    plan.markSideEffect( readback );
+    plan.compile( []( Handle ) { return RenderGraphSizeAndAlign{ 64, 16 }; } );
+    CHECK( plan.order().size() == 2 && plan.peakBytes() == 64 );
+
+    // passes run in declaration order, a consumer declared before its producer is refused
+    plan.reset();
+    const Handle late = plan.addResource( "late", false );
+    const Handle presented = plan.addResource( "backbuffer", true );
+    const Handle consumer = plan.addPass( "consume" );
+    plan.read( consumer, late );
+    plan.write( consumer, presented );
+    const Handle lateProducer = plan.addPass( "produce" );
+    plan.write( lateProducer, late );
+    asked.clear();
+    CHECK( !plan.compile( [&]( Handle h ) {
+        asked.push_back( h );
+        return RenderGraphSizeAndAlign{ 64, 16 };
+    } ) );
+    CHECK( !plan.compiled() && plan.order().empty() && asked.empty() && plan.peakBytes() == 0 );
+
+    // so is reading a transient resource nothing writes, an imported one is fine
+    plan.reset();
+    const Handle neverWritten = plan.addResource( "neverWritten", false );
+    const Handle history = plan.addResource( "history", true );
+    const Handle output = plan.addResource( "output", true );
+    const Handle reader = plan.addPass( "reader" );
+    plan.read( reader, history );
+    plan.read( reader, neverWritten );
+    plan.write( reader, output );
+    CHECK( !plan.compile( []( Handle ) { return RenderGraphSizeAndAlign{ 64, 16 }; } ) );
+    CHECK( !plan.compiled() );
+
+    plan.reset();
+    const Handle history2 = plan.addResource( "history", true );
+    const Handle output2 = plan.addResource( "output", true );
+    const Handle reader2 = plan.addPass( "reader" );
+    plan.read( reader2, history2 );
+    plan.write( reader2, output2 );
+    CHECK( plan.compile( []( Handle ) { return RenderGraphSizeAndAlign{ 64, 16 }; } ) );
+    CHECK( plan.compiled() && plan.order().size() == 1 );
+
+    // random chains of passes reading what earlier passes wrote or what was imported:
+    // whatever survives, placement stays sound
+    std::mt19937 rng( 7 );
+    for ( int graph = 0; graph < 200; ++graph )
+    {
+        plan.reset();
+        const size_t resourceCount = 4 + rng() % 40;
+        std::vector<Handle> readable;
+        for ( size_t r = 0; r < resourceCount; ++r )
+        {
+            const bool imported = rng() % 10 == 0;
+            const Handle h = plan.addResource( "r", imported );
+            if ( imported )
+            {
+                readable.push_back( h );
+            }
+        }
+        const size_t passCount = 2 + rng() % 30;
+        for ( size_t p = 0; p < passCount; ++p )
+        {
+            const Handle pass = plan.addPass( "p" );
+            for ( uint32_t i = readable.empty() ? 0 : rng() % 3; i > 0; --i )
+            {
+                plan.read( pass, readable[ rng() % readable.size() ] );
+            }
+            for ( uint32_t i = 1 + rng() % 2; i > 0; --i )
+            {
+                const Handle written = (Handle)( rng() % resourceCount );
+                plan.write( pass, written );
+                readable.push_back( written );
+            }
+        }
+        CHECK( plan.compile( [&]( Handle ) {
+            return RenderGraphSizeAndAlign{ (size_t)( 1 + rng() % 1000 ) * 256, (size_t)1 << ( rng() % 17 ) };
+        } ) );
+        checkPlacement( plan );
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,216 @@
+/**
+  ******************************************************************************
+  * @file           : test_shader_variants.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "shader_permutations.hpp"
+
+#include <algorithm>
+#include <vector>
+
+// stands in for the metal compiler: a variant is the index of its compile plus one,
+// every compile and release is recorded. the feature sets in failing do not compile
+// and give 0, the null pipeline
+struct StubCompiler
+{
+    std::vector<ShaderFeatures> compiled;
+    std::vector<int> released;
+    std::vector<ShaderFeatures> failing;
+
+    ShaderVariantSet<int>::CompileFn compileFn() {
+        return [this]( ShaderFeatures features ) {
+            compiled.push_back( features );
+            const bool fails = std::find( failing.begin(), failing.end(), features ) != failing.end();
+            return fails ? 0 : (int)compiled.size();
+        };
+    }
+
+    ShaderVariantSet<int>::ReleaseFn releaseFn() {
+        return [this]( int variant ) { released.push_back( variant ); };
+    }
+};
+
+static void checkHash()
+{
+    // the published fnv-1a values, and a seed chains hashes like one longer input
+    CHECK( shaderHash( "" ) == 0xcbf29ce484222325ull );
+    CHECK( shaderHash( "a" ) == 0xaf63dc4c8601ec8cull );
+    CHECK( shaderHash( "Frag", shaderHash( "vertexMain" ) ) == shaderHash( "vertexMainFrag" ) );
+    CHECK( shaderHash( "vertexMain" ) != shaderHash( "vertexMaim" ) );
+
+    // two programs, or two feature sets of one, are different keys and spread apart
+    const uint64_t a = shaderHash( "litVertex" );
+    const uint64_t b = shaderHash( "unlitVertex" );
+    ShaderVariantKeyHash hash;
+    CHECK( ( !( ShaderVariantKey{ a, 1 } == ShaderVariantKey{ b, 1 } ) ) );
+    CHECK( ( !( ShaderVariantKey{ a, 1 } == ShaderVariantKey{ a, 2 } ) ) );
+    CHECK( ( ShaderVariantKey{ a, 3 } == ShaderVariantKey{ a, 3 } ) );
+    CHECK( hash( ShaderVariantKey{ a, 1 } ) != hash( ShaderVariantKey{ b, 1 } ) );
+    CHECK( hash( ShaderVariantKey{ a, 1 } ) != hash( ShaderVariantKey{ a, 2 } ) );
+    CHECK( hash( ShaderVariantKey{ a, 0 } ) != hash( ShaderVariantKey{ a, 1u << 31 } ) );
+}
+
+static void checkSpace()
+{
+    PermutationSpace space;
+    const ShaderFeatures textured = space.addFeature( "TEXTURED" );
+    const ShaderFeatures normalMap = space.addFeature( "NORMAL_MAP" );
+    const ShaderFeatures lit = space.addFeature( "LIT" );
+    const ShaderFeatures unlit = space.addFeature( "UNLIT" );
+    CHECK( textured == 1 && normalMap == 2 && lit == 4 && unlit == 8 );
+    CHECK( space.featureCount() == 4 && space.allFeatures() == 15 );
+
+    space.require( normalMap, textured | lit );
+    space.exclude( lit, unlit );
+
+    CHECK( space.isValid( 0 ) );
+    CHECK( space.isValid( textured | lit ) );
+    CHECK( space.isValid( textured | normalMap | lit ) );
+    CHECK( !space.isValid( normalMap | lit ) );
+    CHECK( !space.isValid( textured | normalMap ) );
+    CHECK( !space.isValid( lit | unlit ) );
+    CHECK( !space.isValid( 16 ) );
+
+    // of the 16 combinations: 3 lighting choices times textured or not, and the
+    // normal map on top of textured and lit
+    const std::vector<ShaderFeatures> all = space.enumerate();
+    CHECK( all.size() == 7 );
+    CHECK( std::is_sorted( all.begin(), all.end() ) );
+    for ( ShaderFeatures f : all )
+    {
+        CHECK( space.isValid( f ) );
+    }
+
+    // what materials ask for: duplicates collapse, invalid sets are dropped, the rest
+    // come back in increasing order
+    const ShaderFeatures used[] = { textured | lit, lit, normalMap, textured | lit, 0, lit | unlit, lit };
+    const std::vector<ShaderFeatures> pruned = space.prune( used, sizeof( used ) / sizeof( used[0] ) );
+    CHECK( ( pruned == std::vector<ShaderFeatures>{ 0, lit, textured | lit } ) );
+
+    CHECK( space.describe( 0 ) == "none" );
+    CHECK( space.describe( textured | lit ) == "TEXTURED|LIT" );
+}
+
+static void checkCache()
+{
+    PermutationSpace space;
+    const ShaderFeatures textured = space.addFeature( "TEXTURED" );
+    const ShaderFeatures lit = space.addFeature( "LIT" );
+
+    StubCompiler compiler;
+    {
+        ShaderVariantSet<int> variants( space, shaderHash( "program" ), compiler.compileFn(), compiler.releaseFn() );
+
+        // the first get compiles, the next ones hit
+        const int a = variants.get( textured );
+        CHECK( variants.get( textured ) == a );
+        CHECK( variants.get( textured ) == a );
+        CHECK( compiler.compiled.size() == 1 && compiler.compiled[0] == textured );
+        CHECK( variants.misses() == 1 && variants.hits() == 2 );
+
+        const int b = variants.get( textured | lit );
+        CHECK( b != a );
+        CHECK( variants.compiledCount() == 2 && variants.misses() == 2 );
+        CHECK( variants.compileSeconds() >= 0.0 );
+    }
+    // the set releases every variant it compiled, once
+    std::vector<int> released = compiler.released;
+    std::sort( released.begin(), released.end() );
+    CHECK( ( released == std::vector<int>{ 1, 2 } ) );
+}
+
+static void checkFailures()
+{
+    PermutationSpace space;
+    const ShaderFeatures textured = space.addFeature( "TEXTURED" );
+    const ShaderFeatures lit = space.addFeature( "LIT" );
+    const ShaderFeatures unlit = space.addFeature( "UNLIT" );
+    space.exclude( lit, unlit );
+
+    StubCompiler compiler;
+    compiler.failing = { textured };
+    {
+        ShaderVariantSet<int> variants( space, shaderHash( "program" ), compiler.compileFn(), compiler.releaseFn() );
+
+        // a set the space does not allow is refused before the compiler sees it
+        CHECK( variants.get( lit | unlit ) == 0 );
+        CHECK( variants.get( lit | unlit ) == 0 );
+        CHECK( compiler.compiled.empty() && variants.compiledCount() == 0 );
+
+        // a failed compile is not cached, every get tries again
+        CHECK( variants.get( textured ) == 0 );
+        CHECK( variants.get( textured ) == 0 );
+        CHECK( ( compiler.compiled == std::vector<ShaderFeatures>{ textured, textured } ) );
+        CHECK( variants.compiledCount() == 0 && variants.hits() == 0 );
+
+        // once the compile goes through the variant sticks
+        compiler.failing.clear();
+        const int fixed = variants.get( textured );
+        CHECK( fixed != 0 && variants.get( textured ) == fixed );
+        CHECK( compiler.compiled.size() == 3 && variants.compiledCount() == 1 );
+
+        // prewarming skips the invalid set and leaves failures out of the cache
+        compiler.failing = { lit };
+        const ShaderFeatures used[] = { lit, lit | unlit, unlit };
+        CHECK( variants.prewarm( used, sizeof( used ) / sizeof( used[0] ) ) == 2 );
+        CHECK( variants.compiledCount() == 2 );
+    }
+    // only the variants that compiled are released
+    std::vector<int> released = compiler.released;
+    std::sort( released.begin(), released.end() );
+    CHECK( ( released == std::vector<int>{ 3, 5 } ) );
+}
+
+static void checkPrewarm()
+{
+    PermutationSpace space;
+    const ShaderFeatures textured = space.addFeature( "TEXTURED" );
+    const ShaderFeatures lit = space.addFeature( "LIT" );
+    const ShaderFeatures unlit = space.addFeature( "UNLIT" );
+    space.exclude( lit, unlit );
+
+    StubCompiler compiler;
+    ShaderVariantSet<int> variants( space, shaderHash( "program" ), compiler.compileFn(), compiler.releaseFn() );
+
+    // invalid and repeated sets are not compiled, the rest in increasing order
+    const ShaderFeatures used[] = { textured | lit, unlit, lit | unlit, textured | lit, unlit };
+    CHECK( variants.prewarm( used, sizeof( used ) / sizeof( used[0] ) ) == 2 );
+    CHECK( ( compiler.compiled == std::vector<ShaderFeatures>{ textured | lit, unlit } ) );
+
+    // prewarmed variants hit, a set nobody warmed still compiles on demand
+    variants.get( unlit );
+    variants.get( textured | lit );
+    CHECK( compiler.compiled.size() == 2 );
+    variants.get( textured | unlit );
+    CHECK( compiler.compiled.size() == 3 );
+
+    // prewarming again finds everything in the cache
+    CHECK( variants.prewarm( used, sizeof( used ) / sizeof( used[0] ) ) == 2 );
+    CHECK( compiler.compiled.size() == 3 );
+    CHECK( variants.compiledCount() == 3 );
+
+    // another program is another set of keys, the same features compile again
+    StubCompiler other;
+    ShaderVariantSet<int> otherVariants( space, shaderHash( "other" ), other.compileFn(), other.releaseFn() );
+    CHECK( otherVariants.program() != variants.program() );
+    otherVariants.get( unlit );
+    CHECK( other.compiled.size() == 1 );
+}
+
+int main()
+{
+    checkHash();
+    checkSpace();
+    checkCache();
+    checkFailures();
+    checkPrewarm();
+    return checkResult();
+}
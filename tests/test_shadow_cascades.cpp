@@ -0,0 +1,350 @@
+/**
+  ******************************************************************************
+  * @file           : test_shadow_cascades.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "shadow_cascades.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+static constexpr float kNearZ = 0.03f;
+static constexpr float kFarZ = 500.f;
+static const float kLight[ 3 ] = { -0.4f, -1.f, -0.3f };
+
+// metal's perspective with 0..1 depth, like Math::makePerspective
+static void makePerspective( float fovY, float aspect, float nearZ, float farZ, float* m )
+{
+    for ( int i = 0; i < 16; ++i )
+    {
+        m[ i ] = 0.f;
+    }
+    const float ys = 1.f / tanf( fovY * 0.5f );
+    const float zs = farZ / ( nearZ - farZ );
+    m[ 0 ] = ys / aspect;
+    m[ 5 ] = ys;
+    m[ 10 ] = zs;
+    m[ 11 ] = -1.f;
+    m[ 14 ] = nearZ * zs;
+}
+
+// world to view for a camera at eye turned by yaw and pitch, looking down -z at 0
+static void makeView( const float eye[ 3 ], float yaw, float pitch, float* m )
+{
+    const float f[ 3 ] = { sinf( yaw ) * cosf( pitch ), sinf( pitch ), -cosf( yaw ) * cosf( pitch ) };
+    float r[ 3 ] = { -f[ 2 ], 0.f, f[ 0 ] };
+    const float len = sqrtf( r[ 0 ] * r[ 0 ] + r[ 2 ] * r[ 2 ] );
+    r[ 0 ] /= len;
+    r[ 2 ] /= len;
+    const float u[ 3 ] = { r[ 1 ] * f[ 2 ] - r[ 2 ] * f[ 1 ], r[ 2 ] * f[ 0 ] - r[ 0 ] * f[ 2 ], r[ 0 ] * f[ 1 ] - r[ 1 ] * f[ 0 ] };
+    for ( int k = 0; k < 3; ++k )
+    {
+        m[ k * 4 + 0 ] = r[ k ];
+        m[ k * 4 + 1 ] = u[ k ];
+        m[ k * 4 + 2 ] = -f[ k ];
+        m[ k * 4 + 3 ] = 0.f;
+    }
+    m[ 12 ] = -( r[ 0 ] * eye[ 0 ] + r[ 1 ] * eye[ 1 ] + r[ 2 ] * eye[ 2 ] );
+    m[ 13 ] = -( u[ 0 ] * eye[ 0 ] + u[ 1 ] * eye[ 1 ] + u[ 2 ] * eye[ 2 ] );
+    m[ 14 ] = f[ 0 ] * eye[ 0 ] + f[ 1 ] * eye[ 1 ] + f[ 2 ] * eye[ 2 ];
+    m[ 15 ] = 1.f;
+}
+
+static void transformPoint( const float* m, const float p[ 3 ], float out[ 3 ] )
+{
+    for ( int r = 0; r < 3; ++r )
+    {
+        out[ r ] = m[ r ] * p[ 0 ] + m[ 4 + r ] * p[ 1 ] + m[ 8 + r ] * p[ 2 ] + m[ 12 + r ];
+    }
+}
+
+// a view space point to world space, the views above are rigid
+static void viewToWorld( const float* view, const float p[ 3 ], float out[ 3 ] )
+{
+    const float q[ 3 ] = { p[ 0 ] - view[ 12 ], p[ 1 ] - view[ 13 ], p[ 2 ] - view[ 14 ] };
+    for ( int k = 0; k < 3; ++k )
+    {
+        out[ k ] = view[ k * 4 + 0 ] * q[ 0 ] + view[ k * 4 + 1 ] * q[ 1 ] + view[ k * 4 + 2 ] * q[ 2 ];
+    }
+}
+
+static void checkSplits()
+{
+    float perspective[ 16 ], view[ 16 ];
+    makePerspective( 45.f * (float)M_PI / 180.f, 16.f / 9.f, kNearZ, kFarZ, perspective );
+    const float eye[ 3 ] = { 0.f, 2.f, 10.f };
+    makeView( eye, 0.f, 0.f, view );
+
+    // the cascades tile the depth range from the near plane to maxDistance
+    ShadowCascade cascades[ kMaxShadowCascades ];
+    fitShadowCascades( perspective, view, kLight, { 4, 2048, 150.f, 0.75f }, cascades );
+    CHECK( fabsf( cascades[ 0 ].splitNear - kNearZ ) < 1e-5f );
+    CHECK( cascades[ 3 ].splitFar == 150.f );
+    for ( uint32_t i = 0; i < 4; ++i )
+    {
+        CHECK( cascades[ i ].splitNear < cascades[ i ].splitFar );
+        CHECK( i == 0 || cascades[ i ].splitNear == cascades[ i - 1 ].splitFar );
+        // nearer cascades spend their texels on less of the scene
+        CHECK( i == 0 || cascades[ i ].texelSize > cascades[ i - 1 ].texelSize );
+    }
+
+    // lambda 0 splits evenly, 1 logarithmically
+    fitShadowCascades( perspective, view, kLight, { 4, 2048, 150.f, 0.f }, cascades );
+    const float step = ( 150.f - kNearZ ) / 4.f;
+    CHECK( fabsf( cascades[ 0 ].splitFar - ( kNearZ + step ) ) < 1e-3f );
+    CHECK( fabsf( cascades[ 1 ].splitFar - ( kNearZ + 2.f * step ) ) < 1e-3f );
+    fitShadowCascades( perspective, view, kLight, { 4, 2048, 150.f, 1.f }, cascades );
+    for ( uint32_t i = 0; i < 3; ++i )
+    {
+        const float expected = kNearZ * powf( 150.f / kNearZ, (float)( i + 1 ) / 4.f );
+        CHECK( fabsf( cascades[ i ].splitFar - expected ) < expected * 1e-4f );
+    }
+
+    // a far plane nearer than maxDistance ends the last cascade. it comes back out of
+    // the projection through m[ 10 ] + 1, which loses most of a float's bits
+    makePerspective( 45.f * (float)M_PI / 180.f, 16.f / 9.f, kNearZ, 60.f, perspective );
+    fitShadowCascades( perspective, view, kLight, { 2, 1024, 150.f, 0.5f }, cascades );
+    CHECK( fabsf( cascades[ 1 ].splitFar - 60.f ) < 60.f * 1e-3f );
+
+    // the light's axes are orthonormal, forward along the light
+    const ShadowCascade& c = cascades[ 0 ];
+    const float len = sqrtf( kLight[ 0 ] * kLight[ 0 ] + kLight[ 1 ] * kLight[ 1 ] + kLight[ 2 ] * kLight[ 2 ] );
+    for ( int k = 0; k < 3; ++k )
+    {
+        CHECK( fabsf( c.forward[ k ] - kLight[ k ] / len ) < 1e-6f );
+    }
+    CHECK( fabsf( c.right[ 0 ] * c.up[ 0 ] + c.right[ 1 ] * c.up[ 1 ] + c.right[ 2 ] * c.up[ 2 ] ) < 1e-6f );
+    CHECK( fabsf( c.right[ 0 ] * c.forward[ 0 ] + c.right[ 1 ] * c.forward[ 1 ] + c.right[ 2 ] * c.forward[ 2 ] ) < 1e-6f );
+
+    // straight down is the degenerate case for a y up basis
+    const float down[ 3 ] = { 0.f, -1.f, 0.f };
+    fitShadowCascades( perspective, view, down, { 1, 1024, 50.f, 0.5f }, cascades );
+    CHECK( std::isfinite( cascades[ 0 ].right[ 0 ] ) && std::isfinite( cascades[ 0 ].up[ 2 ] ) );
+    CHECK( fabsf( cascades[ 0 ].up[ 1 ] ) < 1e-6f );
+}
+
+static void checkFitAcrossPoses()
+{
+    float perspective[ 16 ], view[ 16 ];
+    makePerspective( 45.f * (float)M_PI / 180.f, 16.f / 9.f, kNearZ, kFarZ, perspective );
+    const ShadowCascadeSettings settings = { 4, 2048, 150.f, 0.75f };
+
+    ShadowCascade first[ kMaxShadowCascades ];
+    const float eye0[ 3 ] = { 0.f, 2.f, 10.f };
+    makeView( eye0, 0.f, 0.f, view );
+    fitShadowCascades( perspective, view, kLight, settings, first );
+
+    std::mt19937 rng( 1 );
+    std::uniform_real_distribution<float> u( -1.f, 1.f );
+    int sizeChanged = 0;
+    int outside = 0;
+    int offGrid = 0;
+    for ( int pose = 0; pose < 2000; ++pose )
+    {
+        const float eye[ 3 ] = { 50.f * u( rng ), 5.f + 10.f * u( rng ), 50.f * u( rng ) };
+        makeView( eye, 3.14f * u( rng ), 1.2f * u( rng ), view );
+        ShadowCascade cascades[ kMaxShadowCascades ];
+        fitShadowCascades( perspective, view, kLight, settings, cascades );
+
+        for ( uint32_t i = 0; i < settings.cascadeCount; ++i )
+        {
+            const ShadowCascade& c = cascades[ i ];
+
+            // the box never changes size when the camera moves or turns
+            sizeChanged += c.radius != first[ i ].radius || c.texelSize != first[ i ].texelSize;
+
+            // and only moves in whole texels
+            for ( int k = 0; k < 2; ++k )
+            {
+                const double texels = (double)c.center[ k ] / (double)c.texelSize;
+                offGrid += fabs( texels - std::round( texels ) ) > 1e-3 * std::max( 1.0, fabs( texels ) );
+            }
+
+            // every corner of the cascade's slice of the frustum lands inside its map
+            for ( int corner = 0; corner < 8; ++corner )
+            {
+                const float depth = ( corner & 4 ) ? c.splitFar : c.splitNear;
+                const float p[ 3 ] = { ( ( corner & 1 ) ? 1.f : -1.f ) * depth / perspective[ 0 ],
+                                       ( ( corner & 2 ) ? 1.f : -1.f ) * depth / perspective[ 5 ],
+                                       -depth };
+                float w[ 3 ], clip[ 3 ];
+                viewToWorld( view, p, w );
+                transformPoint( c.viewProjection, w, clip );
+                outside += fabsf( clip[ 0 ] ) > 1.0001f || fabsf( clip[ 1 ] ) > 1.0001f || clip[ 2 ] < -1e-4f || clip[ 2 ] > 1.0001f;
+            }
+        }
+    }
+    CHECK( sizeChanged == 0 );
+    CHECK( offGrid == 0 );
+    CHECK( outside == 0 );
+}
+
+static void checkTexelSnapping()
+{
+    float perspective[ 16 ], view[ 16 ];
+    makePerspective( 45.f * (float)M_PI / 180.f, 16.f / 9.f, kNearZ, kFarZ, perspective );
+    const ShadowCascadeSettings settings = { 4, 2048, 150.f, 0.75f };
+
+    // a point of the scene lands on the same spot within its texel however the camera
+    // creeps, so shadow edges do not crawl. half a texel of the first cascade per step
+    ShadowCascade reference[ kMaxShadowCascades ];
+    const float eye0[ 3 ] = { 1.f, 2.f, 3.f };
+    makeView( eye0, 0.3f, -0.2f, view );
+    fitShadowCascades( perspective, view, kLight, settings, reference );
+
+    const float point[ 3 ] = { 2.5f, 0.f, -7.f };
+    int offTexel = 0;
+    int moved = 0;
+    for ( int step = 1; step <= 64; ++step )
+    {
+        const float offset = 0.5f * reference[ 0 ].texelSize * (float)step;
+        const float eye[ 3 ] = { eye0[ 0 ] + offset, eye0[ 1 ], eye0[ 2 ] + 0.7f * offset };
+        makeView( eye, 0.3f, -0.2f, view );
+        ShadowCascade cascades[ kMaxShadowCascades ];
+        fitShadowCascades( perspective, view, kLight, settings, cascades );
+
+        for ( uint32_t i = 0; i < settings.cascadeCount; ++i )
+        {
+            float a[ 3 ], b[ 3 ];
+            transformPoint( reference[ i ].viewProjection, point, a );
+            transformPoint( cascades[ i ].viewProjection, point, b );
+            // clip units are radius world units, a texel is texelSize of them
+            for ( int k = 0; k < 2; ++k )
+            {
+                const double shift = (double)( b[ k ] - a[ k ] ) * cascades[ i ].radius / cascades[ i ].texelSize;
+                offTexel += fabs( shift - std::round( shift ) ) > 1e-2;
+                moved += i == 0 && fabs( shift ) > 0.5;
+            }
+        }
+    }
+    CHECK( offTexel == 0 );
+    // the first cascade did follow the camera
+    CHECK( moved > 0 );
+}
+
+// the scalar test the simd loop makes 4 at a time
+static std::vector<uint32_t> cullReference( const ShadowCascade& c, const std::vector<float>& x, const std::vector<float>& y,
+                                            const std::vector<float>& z, const std::vector<float>& r, size_t count )
+{
+    std::vector<uint32_t> kept;
+    for ( size_t i = 0; i < count; ++i )
+    {
+        const float lx = c.right[ 0 ] * x[ i ] + c.right[ 1 ] * y[ i ] + c.right[ 2 ] * z[ i ] - c.center[ 0 ];
+        const float ly = c.up[ 0 ] * x[ i ] + c.up[ 1 ] * y[ i ] + c.up[ 2 ] * z[ i ] - c.center[ 1 ];
+        const float lz = c.forward[ 0 ] * x[ i ] + c.forward[ 1 ] * y[ i ] + c.forward[ 2 ] * z[ i ] - c.center[ 2 ];
+        const float reach = r[ i ] + c.radius;
+        if ( fabsf( lx ) <= reach && fabsf( ly ) <= reach && lz <= reach )
+        {
+            kept.push_back( (uint32_t)i );
+        }
+    }
+    return kept;
+}
+
+static void checkCulling()
+{
+    float perspective[ 16 ], view[ 16 ];
+    makePerspective( 45.f * (float)M_PI / 180.f, 16.f / 9.f, kNearZ, kFarZ, perspective );
+    const ShadowCascadeSettings settings = { 4, 2048, 150.f, 0.75f };
+
+    std::mt19937 rng( 2 );
+    std::uniform_real_distribution<float> u( -1.f, 1.f );
+    constexpr size_t kCasters = 4099;
+    std::vector<float> x( kCasters ), y( kCasters ), z( kCasters ), r( kCasters );
+    for ( size_t i = 0; i < kCasters; ++i )
+    {
+        x[ i ] = 200.f * u( rng );
+        y[ i ] = 20.f * u( rng );
+        z[ i ] = 200.f * u( rng );
+        r[ i ] = 3.f * fabsf( u( rng ) );
+    }
+
+    int mismatches = 0;
+    int missed = 0;
+    size_t keptTotal = 0;
+    std::vector<uint32_t> visible( kCasters );
+    for ( int pose = 0; pose < 20; ++pose )
+    {
+        const float eye[ 3 ] = { 50.f * u( rng ), 5.f, 50.f * u( rng ) };
+        makeView( eye, 3.f * u( rng ), 0.5f * u( rng ), view );
+        ShadowCascade cascades[ kMaxShadowCascades ];
+        fitShadowCascades( perspective, view, kLight, settings, cascades );
+
+        for ( uint32_t i = 0; i < settings.cascadeCount; ++i )
+        {
+            const ShadowCascade& c = cascades[ i ];
+
+            // counts that are not a multiple of 4 go through the scalar tail, every one
+            // of them has to agree with the reference, in order
+            for ( size_t count : { kCasters, kCasters - 1, kCasters - 2, kCasters - 3, (size_t)3, (size_t)0 } )
+            {
+                const ShadowCasters casters = { x.data(), y.data(), z.data(), r.data(), count };
+                const size_t n = cullShadowCasters( c, casters, visible.data() );
+                const std::vector<uint32_t> expected = cullReference( c, x, y, z, r, count );
+                mismatches += n != expected.size() || !std::equal( expected.begin(), expected.end(), visible.begin() );
+            }
+
+            // conservative: a caster whose centre is in the map, or anywhere between the
+            // map and the light, is never culled
+            const ShadowCasters casters = { x.data(), y.data(), z.data(), r.data(), kCasters };
+            const size_t n = cullShadowCasters( c, casters, visible.data() );
+            keptTotal += n;
+            size_t k = 0;
+            for ( size_t j = 0; j < kCasters; ++j )
+            {
+                const float p[ 3 ] = { x[ j ], y[ j ], z[ j ] };
+                float clip[ 3 ];
+                transformPoint( c.viewProjection, p, clip );
+                const bool inMap = fabsf( clip[ 0 ] ) <= 1.f && fabsf( clip[ 1 ] ) <= 1.f && clip[ 2 ] <= 1.f;
+                const bool kept = k < n && visible[ k ] == j;
+                k += kept;
+                missed += inMap && !kept;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+    CHECK( missed == 0 );
+    // the scene is wider than the cascades, so culling has to drop some
+    CHECK( keptTotal > 0 && keptTotal < (size_t)20 * 4 * kCasters );
+
+    // behind the box, away from the light, is culled; in front of it, towards the
+    // light, is kept for the clamped depth to flatten
+    const float eye[ 3 ] = { 0.f, 2.f, 10.f };
+    makeView( eye, 0.f, 0.f, view );
+    ShadowCascade cascades[ kMaxShadowCascades ];
+    fitShadowCascades( perspective, view, kLight, settings, cascades );
+    const ShadowCascade& c = cascades[ 0 ];
+    float px[ 4 ], py[ 4 ], pz[ 4 ], pr[ 4 ] = { 0.1f, 0.1f, 0.1f, 0.1f };
+    const float distance[ 4 ] = { 0.f, -3.f * c.radius, -100.f * c.radius, 3.f * c.radius };
+    for ( int i = 0; i < 4; ++i )
+    {
+        // the box centre moved along the light by distance
+        const float d = c.center[ 2 ] + distance[ i ];
+        px[ i ] = c.right[ 0 ] * c.center[ 0 ] + c.up[ 0 ] * c.center[ 1 ] + c.forward[ 0 ] * d;
+        py[ i ] = c.right[ 1 ] * c.center[ 0 ] + c.up[ 1 ] * c.center[ 1 ] + c.forward[ 1 ] * d;
+        pz[ i ] = c.right[ 2 ] * c.center[ 0 ] + c.up[ 2 ] * c.center[ 1 ] + c.forward[ 2 ] * d;
+    }
+    uint32_t kept[ 4 ];
+    CHECK( cullShadowCasters( c, { px, py, pz, pr, 4 }, kept ) == 3 );
+    CHECK( kept[ 0 ] == 0 && kept[ 1 ] == 1 && kept[ 2 ] == 2 );
+}
+
+int main()
+{
+    checkSplits();
+    checkFitAcrossPoses();
+    checkTexelSnapping();
+    checkCulling();
+    return checkResult();
+}
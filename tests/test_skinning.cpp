@@ -0,0 +1,98 @@
+/**
+  ******************************************************************************
+  * @file           : test_skinning.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "job_system.hpp"
+#include "skinning.hpp"
+
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+// a RangeFn only refers to its callable, one that could be kept would dangle
+static_assert( !std::is_copy_constructible<JobSystem::RangeFn>::value, "RangeFn must not be copied" );
+
+static Transform makeTransform( float angle, float tx, float ty, float sx, float sy, float sz )
+{
+    Transform t = {};
+    t.rotation = { 0.f, 0.f, sinf( angle * 0.5f ), cosf( angle * 0.5f ) };
+    t.translation = { tx, ty, 0.f };
+    t.scale = { sx, sy, sz };
+    return t;
+}
+
+static SkinnedVertex makeVertex( float x, float y, float z, float nx, float ny, float nz, float weight )
+{
+    SkinnedVertex v = {};
+    v.position = { x, y, z };
+    v.normal = { nx, ny, nz };
+    v.joints = { 0, 1, 0, 0 };
+    v.weights = { 1.f - weight, weight, 0.f, 0.f };
+    return v;
+}
+
+int main()
+{
+    // two joints, the child turned and squashed along one axis
+    const int parents[] = { -1, 0 };
+    const Transform bind[] = { makeTransform( 0.f, 0.f, 0.f, 1.f, 1.f, 1.f ), makeTransform( 0.f, 0.f, -1.f, 1.f, 1.f, 1.f ) };
+    shader_layout::host_float4x4 inverseBind[ 2 ];
+    AnimationSampler::toMatrices( bind, 2, inverseBind );
+    Skeleton skeleton( parents, inverseBind, 2 );
+
+    const Transform pose[] = { makeTransform( 0.f, 0.f, 0.f, 1.f, 1.f, 1.f ), makeTransform( 0.6f, 0.f, 1.f, 3.f, 0.5f, 1.f ) };
+    shader_layout::host_float4x4 palette[ 2 ];
+    skeleton.computePalette( pose, palette );
+
+    // the root is untouched, its palette entry is the identity
+    CHECK( palette[0].columns[0].x == 1.f && palette[0].columns[1].y == 1.f && palette[0].columns[3].y == 0.f );
+
+    // a slanted face across the squashed joint: after skinning the normal stays
+    // perpendicular to the face, which the skin matrix itself would not keep it
+    const float inv = 1.f / sqrtf( 2.f );
+    const SkinnedVertex face[] = {
+        makeVertex( 0.f, 1.f, 0.f, inv, inv, 0.f, 1.f ),
+        makeVertex( 1.f, 0.f, 0.f, inv, inv, 0.f, 1.f ),
+        makeVertex( 0.f, 1.f, 1.f, inv, inv, 0.f, 1.f ),
+    };
+    SkinnedOutput skinned[ 3 ];
+    CpuSkinning::skin( face, 0, 3, palette, skinned );
+
+    const float e0[] = { skinned[1].position.x - skinned[0].position.x, skinned[1].position.y - skinned[0].position.y, skinned[1].position.z - skinned[0].position.z };
+    const float e1[] = { skinned[2].position.x - skinned[0].position.x, skinned[2].position.y - skinned[0].position.y, skinned[2].position.z - skinned[0].position.z };
+    const shader_layout::host_float3& n = skinned[0].normal;
+    CHECK( fabsf( n.x * e0[0] + n.y * e0[1] + n.z * e0[2] ) < 1e-5f );
+    CHECK( fabsf( n.x * e1[0] + n.y * e1[1] + n.z * e1[2] ) < 1e-5f );
+    CHECK( fabsf( n.x * n.x + n.y * n.y + n.z * n.z - 1.f ) < 1e-5f );
+
+    // the job system splits the same work, the results match to the bit
+    std::vector<SkinnedVertex> vertices;
+    for ( int i = 0; i < 10000; ++i )
+    {
+        const float a = 0.01f * (float)i;
+        vertices.push_back( makeVertex( cosf( a ), 2.f * (float)i / 10000.f, sinf( a ), cosf( a ), 0.f, sinf( a ), (float)( i % 5 ) / 4.f ) );
+    }
+    std::vector<SkinnedOutput> serial( vertices.size() ), parallel( vertices.size() );
+    CpuSkinning::skin( vertices.data(), 0, vertices.size(), palette, serial.data() );
+    JobSystem jobs( 4 );
+    CpuSkinning::skinParallel( jobs, vertices.data(), vertices.size(), palette, parallel.data() );
+    bool same = true;
+    for ( size_t i = 0; i < vertices.size(); ++i )
+    {
+        same = same && serial[ i ].position.x == parallel[ i ].position.x && serial[ i ].position.y == parallel[ i ].position.y
+                    && serial[ i ].position.z == parallel[ i ].position.z && serial[ i ].normal.x == parallel[ i ].normal.x
+                    && serial[ i ].normal.y == parallel[ i ].normal.y && serial[ i ].normal.z == parallel[ i ].normal.z;
+    }
+    CHECK( same );
+
+    return checkResult();
+}
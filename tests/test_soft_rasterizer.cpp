@@ -0,0 +1,397 @@
+/**
+  ******************************************************************************
+  * @file           : test_soft_rasterizer.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "job_system.hpp"
+#include "soft_rasterizer.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static constexpr uint32_t kSize = 128;
+
+static void identity4( float* m )
+{
+    memset( m, 0, 16 * sizeof( float ) );
+    m[ 0 ] = m[ 5 ] = m[ 10 ] = m[ 15 ] = 1.f;
+}
+
+static void identity3( float* m )
+{
+    memset( m, 0, 9 * sizeof( float ) );
+    m[ 0 ] = m[ 4 ] = m[ 8 ] = 1.f;
+}
+
+// a flat triangle in pixels, y down, at one depth
+struct ScreenTriangle
+{
+    float x[ 3 ], y[ 3 ];
+    float z;
+    float color[ 3 ];
+};
+
+// vertices on quarter pixels of a power of two target: clip space, screen space and
+// every edge function at a pixel centre are exact in float, so the rasterizer has to
+// match this per pixel walk bit for bit, fill rule included
+static void rasterizeReference( const ScreenTriangle& t, uint8_t* color, uint16_t* depth )
+{
+    double x[ 3 ] = { t.x[ 0 ], t.x[ 1 ], t.x[ 2 ] };
+    double y[ 3 ] = { t.y[ 0 ], t.y[ 1 ], t.y[ 2 ] };
+    if ( ( x[ 1 ] - x[ 0 ] ) * ( y[ 2 ] - y[ 0 ] ) - ( x[ 2 ] - x[ 0 ] ) * ( y[ 1 ] - y[ 0 ] ) < 0.0 )
+    {
+        std::swap( x[ 1 ], x[ 2 ] );
+        std::swap( y[ 1 ], y[ 2 ] );
+    }
+
+    const uint16_t z = (uint16_t)( t.z * 65535.f + 0.5f );
+    for ( uint32_t py = 0; py < kSize; ++py )
+    {
+        for ( uint32_t px = 0; px < kSize; ++px )
+        {
+            bool inside = true;
+            for ( int e = 0; e < 3 && inside; ++e )
+            {
+                const int a = ( e + 1 ) % 3;
+                const int b = ( e + 2 ) % 3;
+                const double edgeA = y[ a ] - y[ b ];
+                const double edgeB = x[ b ] - x[ a ];
+                const double w = edgeA * ( px + 0.5 - x[ a ] ) + edgeB * ( py + 0.5 - y[ a ] );
+                // top left: an edge through a centre owns it when it is a left or top edge
+                const bool owns = edgeA > 0.0 || ( edgeA == 0.0 && edgeB > 0.0 );
+                inside = w > 0.0 || ( w == 0.0 && owns );
+            }
+            const size_t pixel = (size_t)py * kSize + px;
+            if ( !inside || z >= depth[ pixel ] )
+            {
+                continue;
+            }
+            depth[ pixel ] = z;
+            for ( int c = 0; c < 3; ++c )
+            {
+                color[ pixel * 4 + c ] = (uint8_t)( t.color[ c ] * 255.f + 0.5f );
+            }
+            color[ pixel * 4 + 3 ] = 255;
+        }
+    }
+}
+
+static void drawTriangle( SoftRasterizer& rasterizer, const ScreenTriangle& t )
+{
+    SoftVertex vertices[ 3 ] = {};
+    for ( int i = 0; i < 3; ++i )
+    {
+        vertices[ i ].position[ 0 ] = t.x[ i ] / ( kSize * 0.5f ) - 1.f;
+        vertices[ i ].position[ 1 ] = 1.f - t.y[ i ] / ( kSize * 0.5f );
+        vertices[ i ].position[ 2 ] = t.z;
+    }
+    const uint16_t indices[ 3 ] = { 0, 1, 2 };
+
+    SoftInstance instance;
+    identity4( instance.transform );
+    identity3( instance.normalTransform );
+    memcpy( instance.color, t.color, sizeof( t.color ) );
+    instance.color[ 3 ] = 1.f;
+
+    SoftCamera camera;
+    identity4( camera.projection );
+    identity4( camera.world );
+    identity3( camera.normalTransform );
+
+    SoftDraw draw = {};
+    draw.vertices = vertices;
+    draw.vertexCount = 3;
+    draw.indices = indices;
+    draw.indexCount = 3;
+    draw.instances = &instance;
+    draw.instanceCount = 1;
+    draw.shading = 0;
+    draw.cullBack = false;
+    rasterizer.draw( camera, draw );
+}
+
+// flat triangles across all four bins, overlapping at different depths, a quad whose
+// edges and shared diagonal run through pixel centres and a sliver under a pixel tall
+static void checkGoldenImage()
+{
+    const ScreenTriangle triangles[] = {
+        { { 4.25f, 120.5f, 60.f }, { 10.f, 30.75f, 122.f }, 0.5f, { 0.8f, 0.2f, 0.2f } },
+        { { 20.5f, 100.5f, 100.5f }, { 20.5f, 20.5f, 100.5f }, 0.3f, { 0.2f, 0.8f, 0.2f } },
+        { { 20.5f, 100.5f, 20.5f }, { 20.5f, 100.5f, 100.5f }, 0.3f, { 0.2f, 0.2f, 0.8f } },
+        { { 0.f, 128.f, 0.f }, { 0.f, 0.f, 64.f }, 0.8f, { 0.8f, 0.8f, 0.2f } },
+        { { 10.5f, 118.f, 10.5f }, { 110.f, 111.25f, 111.f }, 0.1f, { 0.2f, 0.8f, 0.8f } },
+    };
+    const size_t triangleCount = sizeof( triangles ) / sizeof( triangles[ 0 ] );
+
+    std::vector<uint8_t> golden( kSize * kSize * 4 );
+    std::vector<uint16_t> goldenDepth( kSize * kSize, 65535 );
+    for ( size_t i = 0; i < kSize * kSize; ++i )
+    {
+        golden[ i * 4 + 0 ] = golden[ i * 4 + 1 ] = golden[ i * 4 + 2 ] = 26;
+        golden[ i * 4 + 3 ] = 255;
+    }
+    for ( const ScreenTriangle& t : triangles )
+    {
+        rasterizeReference( t, golden.data(), goldenDepth.data() );
+    }
+
+    JobSystem jobs( 1 );
+    SoftRasterizer rasterizer( jobs, kSize, kSize, false );
+    const float clearColor[ 4 ] = { 0.1f, 0.1f, 0.1f, 1.f };
+    rasterizer.clear( clearColor );
+    for ( const ScreenTriangle& t : triangles )
+    {
+        drawTriangle( rasterizer, t );
+    }
+
+    // colours go through perspective correct interpolation, a unit of rounding is fine
+    const SoftImageDiff diff = compareImages( rasterizer.color(), golden.data(), kSize * kSize, 1 );
+    CHECK( diff.mismatched == 0 );
+    CHECK( diff.maxDelta <= 1 );
+    // so does depth, and the same pixels pass the depth test
+    size_t depthMismatches = 0;
+    for ( size_t i = 0; i < goldenDepth.size(); ++i )
+    {
+        depthMismatches += std::abs( (int)rasterizer.depth()[ i ] - (int)goldenDepth[ i ] ) > 1 ? 1 : 0;
+    }
+    CHECK( depthMismatches == 0 );
+
+    // the two halves of the quad leave no gap on their diagonal
+    for ( uint32_t y = 21; y < 100; ++y )
+    {
+        for ( uint32_t x = 21; x < 100; ++x )
+        {
+            CHECK( rasterizer.depth()[ y * kSize + x ] != 65535 );
+        }
+    }
+
+    const SoftRasterStats stats = rasterizer.stats();
+    CHECK( stats.triangles == triangleCount );
+    CHECK( stats.culled == 0 && stats.clipped == 0 );
+}
+
+static void checkCulling()
+{
+    JobSystem jobs( 1 );
+    SoftRasterizer rasterizer( jobs, kSize, kSize, false );
+    const float clearColor[ 4 ] = { 0.f, 0.f, 0.f, 1.f };
+    rasterizer.clear( clearColor );
+
+    // y down on screen, so this winding is clockwise in clip space: a back face
+    const ScreenTriangle back = { { 10.f, 100.f, 10.f }, { 10.f, 10.f, 100.f }, 0.5f, { 1.f, 1.f, 1.f } };
+    SoftVertex vertices[ 3 ] = {};
+    for ( int i = 0; i < 3; ++i )
+    {
+        vertices[ i ].position[ 0 ] = back.x[ i ] / ( kSize * 0.5f ) - 1.f;
+        vertices[ i ].position[ 1 ] = 1.f - back.y[ i ] / ( kSize * 0.5f );
+        vertices[ i ].position[ 2 ] = back.z;
+    }
+    const uint16_t front[ 3 ] = { 0, 2, 1 };
+    const uint16_t reversed[ 3 ] = { 0, 1, 2 };
+
+    SoftInstance instance;
+    identity4( instance.transform );
+    identity3( instance.normalTransform );
+    instance.color[ 0 ] = instance.color[ 1 ] = instance.color[ 2 ] = instance.color[ 3 ] = 1.f;
+    SoftCamera camera;
+    identity4( camera.projection );
+    identity4( camera.world );
+    identity3( camera.normalTransform );
+
+    SoftDraw draw = {};
+    draw.vertices = vertices;
+    draw.vertexCount = 3;
+    draw.indices = reversed;
+    draw.indexCount = 3;
+    draw.instances = &instance;
+    draw.instanceCount = 1;
+    draw.cullBack = true;
+    rasterizer.draw( camera, draw );
+    CHECK( rasterizer.stats().culled == 1 && rasterizer.stats().pixels == 0 );
+
+    draw.indices = front;
+    rasterizer.draw( camera, draw );
+    CHECK( rasterizer.stats().culled == 1 && rasterizer.stats().pixels > 0 );
+
+    // past the far plane, or entirely off screen, nothing is set up
+    rasterizer.resetStats();
+    for ( SoftVertex& v : vertices )
+    {
+        v.position[ 2 ] = 1.5f;
+    }
+    rasterizer.draw( camera, draw );
+    CHECK( rasterizer.stats().culled == 1 && rasterizer.stats().pixels == 0 );
+}
+
+// the cube grid of the samples with a perspective camera, textured and lit, plus one
+// cube through the near plane
+struct CubeScene
+{
+    std::vector<SoftVertex> vertices;
+    std::vector<uint16_t> indices;
+    std::vector<SoftInstance> instances;
+    std::vector<uint8_t> texels;
+    SoftTexture texture;
+    SoftCamera camera;
+
+    explicit CubeScene( float aspect ) {
+        // each face spans u x v with u x v = n, so 0 1 2 / 0 2 3 winds counter clockwise
+        // seen from outside
+        const float faces[ 6 ][ 3 ][ 3 ] = {
+            { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } }, { { -1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } },
+            { { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } }, { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },
+            { { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 } }, { { 0, 0, -1 }, { 0, 1, 0 }, { 1, 0, 0 } },
+        };
+        const float corners[ 4 ][ 2 ] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+        for ( const auto& face : faces )
+        {
+            const uint16_t base = (uint16_t)vertices.size();
+            for ( const auto& corner : corners )
+            {
+                SoftVertex v;
+                for ( int k = 0; k < 3; ++k )
+                {
+                    v.position[ k ] = 0.5f * ( face[ 0 ][ k ] + corner[ 0 ] * face[ 1 ][ k ] + corner[ 1 ] * face[ 2 ][ k ] );
+                    v.normal[ k ] = face[ 0 ][ k ];
+                }
+                v.texcoord[ 0 ] = corner[ 0 ] * 0.5f + 0.5f;
+                v.texcoord[ 1 ] = corner[ 1 ] * 0.5f + 0.5f;
+                vertices.push_back( v );
+            }
+            for ( uint16_t i : { 0, 1, 2, 0, 2, 3 } )
+            {
+                indices.push_back( base + i );
+            }
+        }
+
+        for ( int z = 0; z < 10; ++z )
+        {
+            for ( int y = 0; y < 10; ++y )
+            {
+                for ( int x = 0; x < 10; ++x )
+                {
+                    addInstance( ( x - 4.5f ) * 1.2f, ( y - 4.5f ) * 1.2f, -4.f - z * 1.5f, 0.6f, 0.3f * ( x + y + z ) );
+                }
+            }
+        }
+        addInstance( 0.6f, 0.f, -0.3f, 1.f, 0.f );
+
+        const uint32_t size = 64;
+        for ( uint32_t y = 0; y < size; ++y )
+        {
+            for ( uint32_t x = 0; x < size; ++x )
+            {
+                const bool odd = ( ( x / 8 ) ^ ( y / 8 ) ) & 1;
+                texels.insert( texels.end(), { (uint8_t)( odd ? 255 : 40 ), (uint8_t)( x * 4 ), (uint8_t)( y * 4 ), 255 } );
+            }
+        }
+        texture = { texels.data(), size, size };
+
+        // metal's depth range, 0 at near and 1 at far
+        const float nearZ = 0.1f, farZ = 40.f;
+        const float f = 1.f / tanf( 0.5f );
+        memset( camera.projection, 0, sizeof( camera.projection ) );
+        camera.projection[ 0 ] = f / aspect;
+        camera.projection[ 5 ] = f;
+        camera.projection[ 10 ] = farZ / ( nearZ - farZ );
+        camera.projection[ 11 ] = -1.f;
+        camera.projection[ 14 ] = nearZ * farZ / ( nearZ - farZ );
+        identity4( camera.world );
+        identity3( camera.normalTransform );
+    }
+
+    void addInstance( float x, float y, float z, float scale, float angle ) {
+        SoftInstance instance;
+        const float c = cosf( angle ), s = sinf( angle );
+        identity4( instance.transform );
+        instance.transform[ 0 ] = scale * c;
+        instance.transform[ 2 ] = -scale * s;
+        instance.transform[ 5 ] = scale;
+        instance.transform[ 8 ] = scale * s;
+        instance.transform[ 10 ] = scale * c;
+        instance.transform[ 12 ] = x;
+        instance.transform[ 13 ] = y;
+        instance.transform[ 14 ] = z;
+        identity3( instance.normalTransform );
+        instance.normalTransform[ 0 ] = c;
+        instance.normalTransform[ 2 ] = -s;
+        instance.normalTransform[ 6 ] = s;
+        instance.normalTransform[ 8 ] = c;
+        instance.color[ 0 ] = 0.3f + 0.07f * ( instances.size() % 10 );
+        instance.color[ 1 ] = 0.9f - 0.05f * ( instances.size() % 13 );
+        instance.color[ 2 ] = 0.5f;
+        instance.color[ 3 ] = 1.f;
+        instances.push_back( instance );
+    }
+
+    SoftDraw draw() const {
+        SoftDraw d = {};
+        d.vertices = vertices.data();
+        d.vertexCount = vertices.size();
+        d.indices = indices.data();
+        d.indexCount = indices.size();
+        d.instances = instances.data();
+        d.instanceCount = instances.size();
+        d.shading = kSoftTextured | kSoftLit;
+        d.texture = &texture;
+        d.cullBack = true;
+        return d;
+    }
+};
+
+// bins own their pixels and walk the chunks in submission order, so the image is the
+// same whatever thread rasterises which bin
+static void checkThreadDeterminism()
+{
+    const uint32_t width = 320, height = 180;
+    const CubeScene scene( (float)width / (float)height );
+    const float clearColor[ 4 ] = { 0.1f, 0.1f, 0.1f, 1.f };
+
+    JobSystem single( 1 );
+    SoftRasterizer reference( single, width, height );
+    reference.clear( clearColor );
+    reference.draw( scene.camera, scene.draw() );
+
+    JobSystem pool( 4 );
+    SoftRasterizer parallel( pool, width, height );
+    for ( int frame = 0; frame < 3; ++frame )
+    {
+        parallel.resetStats();
+        parallel.clear( clearColor );
+        parallel.draw( scene.camera, scene.draw() );
+
+        CHECK( memcmp( parallel.color(), reference.color(), (size_t)width * height * 4 ) == 0 );
+        CHECK( memcmp( parallel.depth(), reference.depth(), (size_t)width * height * sizeof( uint16_t ) ) == 0 );
+
+        const SoftRasterStats a = reference.stats();
+        const SoftRasterStats b = parallel.stats();
+        CHECK( a.triangles == b.triangles && a.culled == b.culled && a.clipped == b.clipped );
+        CHECK( a.binEntries == b.binEntries && a.pixels == b.pixels );
+    }
+
+    // the scene is worth checking: more than one chunk of triangles, the near cube cut,
+    // back faces culled and most of the screen drawn
+    const SoftRasterStats stats = reference.stats();
+    CHECK( stats.triangles == scene.instances.size() * 12 );
+    CHECK( stats.clipped > 0 );
+    CHECK( stats.culled >= stats.triangles / 3 );
+    CHECK( stats.pixels > (size_t)width * height / 2 );
+}
+
+int main()
+{
+    checkGoldenImage();
+    checkCulling();
+    checkThreadDeterminism();
+    return checkResult();
+}
@@ -0,0 +1,201 @@
+/**
+  ******************************************************************************
+  * @file           : test_staging_batcher.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "resource_policy.hpp"
+#include "staging_batcher.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+static constexpr size_t kChunkSize = 4096;
+
+// host memory in place of shared MTL::Buffers, counts what is made and released
+struct HostChunks
+{
+    std::atomic<size_t> created{ 0 };
+    std::atomic<size_t> released{ 0 };
+    bool fail = false;
+};
+
+static std::shared_ptr<StagingBatcher> makeBatcher( HostChunks& host )
+{
+    return std::make_shared<StagingBatcher>( kChunkSize,
+        [&host]( size_t capacity ) -> StagingChunk {
+            if ( host.fail )
+            {
+                return {};
+            }
+            ++host.created;
+            uint8_t* memory = (uint8_t*)malloc( capacity );
+            return { memory, memory, capacity };
+        },
+        [&host]( const StagingChunk& chunk ) {
+            ++host.released;
+            free( chunk.handle );
+        } );
+}
+
+static void checkPolicies()
+{
+    // private and staged for static data everywhere, the cpu never maps it
+    for ( bool unified : { false, true } )
+    {
+        const StoragePolicy s = chooseStoragePolicy( ResourceUsage::Static, unified );
+        CHECK( s.storage == ResourceStorage::Private && s.staged && !s.synchronized );
+
+        const StoragePolicy streaming = chooseStoragePolicy( ResourceUsage::Streaming, unified );
+        CHECK( streaming.storage == ResourceStorage::Shared && !streaming.staged && !streaming.synchronized );
+    }
+
+    // data the gpu reads more than once gets a gpu side copy without unified memory
+    for ( ResourceUsage usage : { ResourceUsage::Dynamic, ResourceUsage::Readback } )
+    {
+        const StoragePolicy unified = chooseStoragePolicy( usage, true );
+        CHECK( unified.storage == ResourceStorage::Shared && !unified.staged && !unified.synchronized );
+
+        const StoragePolicy discrete = chooseStoragePolicy( usage, false );
+        CHECK( discrete.storage == ResourceStorage::Managed && !discrete.staged && discrete.synchronized );
+    }
+
+    // textures never end up shared on a discrete gpu, and keep the buffer policy otherwise
+    for ( ResourceUsage usage : { ResourceUsage::Static, ResourceUsage::Dynamic, ResourceUsage::Streaming, ResourceUsage::Readback } )
+    {
+        const StoragePolicy discrete = chooseTexturePolicy( usage, false );
+        CHECK( discrete.storage != ResourceStorage::Shared );
+        CHECK( discrete.synchronized == ( discrete.storage == ResourceStorage::Managed ) );
+
+        const StoragePolicy unified = chooseTexturePolicy( usage, true );
+        const StoragePolicy buffer = chooseStoragePolicy( usage, true );
+        CHECK( unified.storage == buffer.storage && unified.staged == buffer.staged && unified.synchronized == buffer.synchronized );
+    }
+    CHECK( chooseTexturePolicy( ResourceUsage::Streaming, false ).storage == ResourceStorage::Managed );
+}
+
+static void checkStaging()
+{
+    HostChunks host;
+    {
+        std::shared_ptr<StagingBatcher> batcher = makeBatcher( host );
+
+        // aligned offsets, the data lands where the placement says
+        uint8_t data[ kChunkSize ];
+        for ( size_t i = 0; i < sizeof( data ); ++i )
+        {
+            data[ i ] = (uint8_t)( i * 7 );
+        }
+        std::vector<StagingPlacement> placements;
+        for ( size_t i = 0; i < 10; ++i )
+        {
+            const size_t align = i % 2 ? 256 : 16;
+            StagingPlacement p;
+            CHECK( batcher->stage( data, 3 + i * 97, align, p ) );
+            CHECK( p.offset % align == 0 );
+            CHECK( p.offset + 3 + i * 97 <= batcher->chunk( p.chunk ).capacity );
+            CHECK( memcmp( batcher->chunk( p.chunk ).memory + p.offset, data, 3 + i * 97 ) == 0 );
+            placements.push_back( p );
+        }
+
+        // filling a chunk rolls over into the next, ranges in one chunk never overlap
+        CHECK( batcher->openChunkCount() > 1 );
+        for ( size_t i = 1; i < placements.size(); ++i )
+        {
+            const StagingPlacement& a = placements[ i - 1 ];
+            const StagingPlacement& b = placements[ i ];
+            CHECK( b.chunk == a.chunk + 1 || ( b.chunk == a.chunk && b.offset >= a.offset + 3 + ( i - 1 ) * 97 ) );
+        }
+
+        // an oversized upload gets a chunk of its own, released rather than recycled
+        std::vector<uint8_t> big( kChunkSize * 3, 0x5a );
+        StagingPlacement p;
+        CHECK( batcher->stage( big.data(), big.size(), 16, p ) );
+        CHECK( p.offset == 0 && batcher->chunk( p.chunk ).capacity == big.size() );
+
+        const size_t chunks = batcher->openChunkCount();
+        const size_t created = host.created;
+        const uint64_t serial = batcher->closeBatch();
+        CHECK( batcher->openChunkCount() == 0 && batcher->inFlightBatches() == 1 );
+        batcher->batchCompleted( serial );
+        CHECK( batcher->inFlightBatches() == 0 );
+        CHECK( batcher->freeChunks() == chunks - 1 && host.released == 1 );
+
+        // the next batches come out of the free list without new chunks
+        for ( size_t i = 0; i < chunks - 1; ++i )
+        {
+            CHECK( batcher->stage( data, kChunkSize, 16, p ) );
+        }
+        CHECK( host.created == created );
+        batcher->batchCompleted( batcher->closeBatch() );
+
+        // a failed chunk is reported, nothing is placed
+        host.fail = true;
+        for ( size_t i = 0; i < chunks; ++i )
+        {
+            batcher->stage( data, kChunkSize, 16, p );
+        }
+        CHECK( !batcher->stage( data, kChunkSize, 16, p ) );
+        host.fail = false;
+
+        // left open and in flight, the destructor takes care of both
+        batcher->closeBatch();
+        CHECK( batcher->stage( data, 100, 16, p ) );
+    }
+    CHECK( host.created == host.released );
+}
+
+// batches complete on other threads and out of order, the way command buffers call back,
+// and the owner lets go of the batcher while some are still in flight
+static void checkCompletion()
+{
+    HostChunks host;
+    std::vector<std::thread> gpu;
+    {
+        std::shared_ptr<StagingBatcher> batcher = makeBatcher( host );
+        std::mt19937 rng( 7 );
+        std::vector<uint8_t> data( kChunkSize * 2 );
+
+        for ( size_t batch = 0; batch < 64; ++batch )
+        {
+            const size_t copies = 1 + rng() % 12;
+            for ( size_t i = 0; i < copies; ++i )
+            {
+                StagingPlacement p;
+                CHECK( batcher->stage( data.data(), 1 + rng() % ( kChunkSize + kChunkSize / 4 ), 16, p ) );
+            }
+            const uint64_t serial = batcher->closeBatch();
+            const unsigned delay = rng() % 2000;
+            gpu.emplace_back( [batcher, serial, delay]() {
+                std::this_thread::sleep_for( std::chrono::microseconds( delay ) );
+                batcher->batchCompleted( serial );
+            } );
+        }
+    }
+    for ( std::thread& t : gpu )
+    {
+        t.join();
+    }
+    CHECK( host.created > 0 && host.created == host.released );
+}
+
+int main()
+{
+    checkPolicies();
+    checkStaging();
+    checkCompletion();
+    return checkResult();
+}
@@ -0,0 +1,334 @@
+/**
+  ******************************************************************************
+  * @file           : test_temporal_upscale.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "temporal_upscale.hpp"
+#include "check.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+static constexpr uint32_t kInputWidth = 64;
+static constexpr uint32_t kInputHeight = 64;
+static constexpr uint32_t kOutputWidth = 128;
+static constexpr uint32_t kOutputHeight = 128;
+
+// metal's perspective with 0..1 depth, like Math::makePerspective
+static void makePerspective( float fovY, float aspect, float nearZ, float farZ, float* m )
+{
+    memset( m, 0, 16 * sizeof( float ) );
+    const float ys = 1.f / tanf( fovY * 0.5f );
+    const float zs = farZ / ( nearZ - farZ );
+    m[ 0 ] = ys / aspect;
+    m[ 5 ] = ys;
+    m[ 10 ] = zs;
+    m[ 11 ] = -1.f;
+    m[ 14 ] = nearZ * zs;
+}
+
+static void makeTranslation( float x, float z, float* m )
+{
+    memset( m, 0, 16 * sizeof( float ) );
+    m[ 0 ] = m[ 5 ] = m[ 10 ] = m[ 15 ] = 1.f;
+    m[ 12 ] = x;
+    m[ 14 ] = z;
+}
+
+// column major like simd
+static void transform( const float* m, const float p[ 4 ], float out[ 4 ] )
+{
+    for ( int r = 0; r < 4; ++r )
+    {
+        out[ r ] = m[ r ] * p[ 0 ] + m[ 4 + r ] * p[ 1 ] + m[ 8 + r ] * p[ 2 ] + m[ 12 + r ] * p[ 3 ];
+    }
+}
+
+static void multiply( const float* a, const float* b, float* out )
+{
+    for ( int c = 0; c < 4; ++c )
+    {
+        for ( int r = 0; r < 4; ++r )
+        {
+            float s = 0.f;
+            for ( int k = 0; k < 4; ++k )
+            {
+                s += a[ k * 4 + r ] * b[ c * 4 + k ];
+            }
+            out[ c * 4 + r ] = s;
+        }
+    }
+}
+
+// a striped disk of radius 0.25 on a striped background, both with edges finer than
+// an input pixel so the upscaler has detail to recover
+struct Scene
+{
+    float diskU = 0.5f;
+
+    bool inDisk( float u, float v ) const
+    {
+        const float dx = u - diskU, dy = v - 0.5f;
+        return dx * dx + dy * dy < 0.0625f;
+    }
+
+    void sample( float u, float v, float* color ) const
+    {
+        if ( inDisk( u, v ) )
+        {
+            const float t = fmodf( ( u - diskU ) * 23.f + ( v - 0.5f ) * 5.f + 4.f, 1.f ) < 0.5f ? 1.f : 0.3f;
+            color[ 0 ] = t;
+            color[ 1 ] = 0.5f * t;
+            color[ 2 ] = 0.2f;
+        }
+        else
+        {
+            const float s = fmodf( u * 7.3f + v * 3.1f, 1.f ) < 0.5f ? 0.8f : 0.1f;
+            color[ 0 ] = color[ 1 ] = color[ 2 ] = s;
+        }
+        color[ 3 ] = 1.f;
+    }
+
+    // one sample per input pixel at its centre plus the jitter. the disk moves by
+    // velocity uv a frame, its motion points back by as much
+    void render( float jitterX, float jitterY, float velocity, bool withMotion, std::vector<float>& color, std::vector<float>& motion ) const
+    {
+        for ( uint32_t y = 0; y < kInputHeight; ++y )
+        {
+            for ( uint32_t x = 0; x < kInputWidth; ++x )
+            {
+                const float u = ( (float)x + 0.5f + jitterX ) / (float)kInputWidth;
+                const float v = ( (float)y + 0.5f + jitterY ) / (float)kInputHeight;
+                const size_t i = (size_t)y * kInputWidth + x;
+                sample( u, v, &color[ i * 4 ] );
+                motion[ i * 2 + 0 ] = withMotion && inDisk( u, v ) ? -velocity : 0.f;
+                motion[ i * 2 + 1 ] = 0.f;
+            }
+        }
+    }
+
+    // mean absolute error against the scene supersampled 8 x 8 per output pixel
+    double error( const float* output ) const
+    {
+        double e = 0.0;
+        for ( uint32_t y = 0; y < kOutputHeight; ++y )
+        {
+            for ( uint32_t x = 0; x < kOutputWidth; ++x )
+            {
+                float reference[ 3 ] = {};
+                for ( int sy = 0; sy < 8; ++sy )
+                {
+                    for ( int sx = 0; sx < 8; ++sx )
+                    {
+                        float c[ 4 ];
+                        sample( ( (float)x + ( (float)sx + 0.5f ) / 8.f ) / (float)kOutputWidth,
+                                ( (float)y + ( (float)sy + 0.5f ) / 8.f ) / (float)kOutputHeight, c );
+                        for ( int k = 0; k < 3; ++k )
+                        {
+                            reference[ k ] += c[ k ] / 64.f;
+                        }
+                    }
+                }
+                for ( int k = 0; k < 3; ++k )
+                {
+                    e += fabs( output[ ( (size_t)y * kOutputWidth + x ) * 4 + k ] - reference[ k ] );
+                }
+            }
+        }
+        return e / ( (double)kOutputWidth * kOutputHeight * 3.0 );
+    }
+};
+
+static void checkHalton()
+{
+    CHECK( halton( 0, 2 ) == 0.f );
+    CHECK( halton( 1, 2 ) == 0.5f );
+    CHECK( halton( 2, 2 ) == 0.25f );
+    CHECK( halton( 3, 2 ) == 0.75f );
+    CHECK( fabsf( halton( 1, 3 ) - 1.f / 3.f ) < 1e-7f );
+    CHECK( fabsf( halton( 5, 3 ) - ( 2.f / 3.f + 1.f / 9.f ) ) < 1e-6f );
+}
+
+static void checkJitter()
+{
+    TemporalJitter jitter;
+
+    // 8 phases per output pixel an input pixel covers, never fewer than 8
+    jitter.reset( 100, 100, 100, 100 );
+    CHECK( jitter.phaseCount() == 8 );
+    jitter.reset( 1280, 720, 1920, 1080 );
+    CHECK( jitter.phaseCount() == 18 );
+    jitter.reset( 960, 540, 1920, 1080 );
+    CHECK( jitter.phaseCount() == 32 );
+
+    // the offsets stay inside the pixel, centre on it and repeat after phaseCount
+    CHECK( jitter.x() == 0.f && jitter.y() == 0.f );
+    double meanX = 0.0, meanY = 0.0;
+    float firstX = 0.f, firstY = 0.f;
+    for ( uint32_t i = 0; i < jitter.phaseCount(); ++i )
+    {
+        jitter.advance();
+        CHECK( jitter.phase() == i );
+        CHECK( jitter.x() >= -0.5f && jitter.x() < 0.5f && jitter.y() >= -0.5f && jitter.y() < 0.5f );
+        if ( i == 0 )
+        {
+            firstX = jitter.x();
+            firstY = jitter.y();
+        }
+        meanX += jitter.x();
+        meanY += jitter.y();
+    }
+    CHECK( fabs( meanX / jitter.phaseCount() ) < 0.02 );
+    CHECK( fabs( meanY / jitter.phaseCount() ) < 0.03 );
+    jitter.advance();
+    CHECK( jitter.phase() == 0 && jitter.x() == firstX && jitter.y() == firstY );
+
+    // a jittered projection moves every point by minus the jitter in pixels, y down,
+    // and leaves its depth alone
+    float projection[ 16 ], jittered[ 16 ];
+    makePerspective( 0.8f, 16.f / 9.f, 0.1f, 100.f, projection );
+    memcpy( jittered, projection, sizeof( projection ) );
+    jitter.advance();
+    jitter.apply( jittered, 960, 540 );
+
+    const float p[ 4 ] = { 1.3f, -0.7f, -5.f, 1.f };
+    float a[ 4 ], b[ 4 ];
+    transform( projection, p, a );
+    transform( jittered, p, b );
+    const float shiftX = ( b[ 0 ] / b[ 3 ] - a[ 0 ] / a[ 3 ] ) * 0.5f * 960.f;
+    const float shiftY = ( a[ 1 ] / a[ 3 ] - b[ 1 ] / b[ 3 ] ) * 0.5f * 540.f;
+    CHECK( fabsf( shiftX + jitter.x() ) < 1e-3f );
+    CHECK( fabsf( shiftY + jitter.y() ) < 1e-3f );
+    CHECK( fabsf( b[ 2 ] / b[ 3 ] - a[ 2 ] / a[ 3 ] ) < 1e-6f );
+}
+
+static void checkMotionHistory()
+{
+    MotionHistory history( 3 );
+    float viewProjection[ 16 ];
+    makePerspective( 0.8f, 1.f, 0.1f, 100.f, viewProjection );
+    float first[ 3 ][ 16 ];
+
+    // the first frame has no history: previous is the current frame, no motion
+    CHECK( history.beginFrame( 64, 64 ) );
+    history.setViewProjection( viewProjection );
+    for ( size_t i = 0; i < 3; ++i )
+    {
+        makeTranslation( (float)i, -5.f, first[ i ] );
+        history.setTransform( i, first[ i ] );
+    }
+    CHECK( memcmp( history.previousTransform( 1 ), history.transform( 1 ), 16 * sizeof( float ) ) == 0 );
+    CHECK( memcmp( history.previousViewProjection(), history.viewProjection(), 16 * sizeof( float ) ) == 0 );
+
+    // the next one keeps the last frame's transforms as previous
+    CHECK( !history.beginFrame( 64, 64 ) );
+    history.setViewProjection( viewProjection );
+    for ( size_t i = 0; i < 3; ++i )
+    {
+        float m[ 16 ];
+        makeTranslation( (float)i * 1.1f, -5.f, m );
+        history.setTransform( i, m );
+    }
+    CHECK( memcmp( history.previousTransform( 2 ), first[ 2 ], 16 * sizeof( float ) ) == 0 );
+    CHECK( history.transform( 2 )[ 12 ] == 2.2f );
+
+    // instance 2 moved 0.2 to the right at 5 units, its origin's motion points back
+    // left by the uv that covers
+    const float origin[ 4 ] = { 0.f, 0.f, 0.f, 1.f };
+    float previousMatrix[ 16 ], currentMatrix[ 16 ], previous[ 4 ], current[ 4 ], motion[ 2 ];
+    multiply( history.previousViewProjection(), history.previousTransform( 2 ), previousMatrix );
+    multiply( history.viewProjection(), history.transform( 2 ), currentMatrix );
+    transform( previousMatrix, origin, previous );
+    transform( currentMatrix, origin, current );
+    motionVector( current, previous, motion );
+    CHECK( fabsf( motion[ 0 ] + 0.2f * viewProjection[ 0 ] / 5.f * 0.5f ) < 1e-6f );
+    CHECK( fabsf( motion[ 1 ] ) < 1e-7f );
+
+    // a new input size or a camera cut starts over
+    CHECK( history.beginFrame( 32, 32 ) );
+    history.setTransform( 0, first[ 0 ] );
+    CHECK( memcmp( history.previousTransform( 0 ), first[ 0 ], 16 * sizeof( float ) ) == 0 );
+    CHECK( !history.beginFrame( 32, 32 ) );
+    CHECK( !history.reset() );
+    history.invalidate();
+    CHECK( history.beginFrame( 32, 32 ) );
+    CHECK( history.reset() );
+}
+
+static void checkUpscaler()
+{
+    Scene scene;
+    TemporalJitter jitter;
+    std::vector<float> color( (size_t)kInputWidth * kInputHeight * 4 );
+    std::vector<float> motion( (size_t)kInputWidth * kInputHeight * 2 );
+
+    // a still scene: jittered frames accumulate detail one frame does not have, the
+    // same frame over and over does not
+    CpuTemporalUpscaler single( kInputWidth, kInputHeight, kOutputWidth, kOutputHeight );
+    scene.render( 0.f, 0.f, 0.f, false, color, motion );
+    single.encode( color.data(), motion.data(), 0.f, 0.f, true );
+    const double singleError = scene.error( single.output() );
+
+    CpuTemporalUpscaler still( kInputWidth, kInputHeight, kOutputWidth, kOutputHeight );
+    CpuTemporalUpscaler accumulated( kInputWidth, kInputHeight, kOutputWidth, kOutputHeight );
+    jitter.reset( kInputWidth, kInputHeight, kOutputWidth, kOutputHeight );
+    for ( int frame = 0; frame < 64; ++frame )
+    {
+        scene.render( 0.f, 0.f, 0.f, false, color, motion );
+        still.encode( color.data(), motion.data(), 0.f, 0.f, frame == 0 );
+        jitter.advance();
+        scene.render( jitter.x(), jitter.y(), 0.f, false, color, motion );
+        accumulated.encode( color.data(), motion.data(), jitter.x(), jitter.y(), frame == 0 );
+    }
+    const double stillError = scene.error( still.output() );
+    const double accumulatedError = scene.error( accumulated.output() );
+    CHECK( accumulatedError < 0.6 * singleError );
+    CHECK( accumulatedError < 0.6 * stillError );
+
+    // a moving disk: its history is only found by following the motion vectors
+    const float velocity = 1.5f / (float)kOutputWidth;
+    double movingError[ 2 ];
+    for ( int withMotion = 0; withMotion < 2; ++withMotion )
+    {
+        CpuTemporalUpscaler upscaler( kInputWidth, kInputHeight, kOutputWidth, kOutputHeight );
+        jitter.reset( kInputWidth, kInputHeight, kOutputWidth, kOutputHeight );
+        scene.diskU = 0.3f;
+        for ( int frame = 0; frame < 64; ++frame )
+        {
+            scene.diskU += velocity;
+            jitter.advance();
+            scene.render( jitter.x(), jitter.y(), velocity, withMotion != 0, color, motion );
+            upscaler.encode( color.data(), motion.data(), jitter.x(), jitter.y(), frame == 0 );
+        }
+        movingError[ withMotion ] = scene.error( upscaler.output() );
+    }
+    CHECK( movingError[ 1 ] < movingError[ 0 ] );
+    scene.diskU = 0.5f;
+
+    // reset drops the history, the output is what a new upscaler makes of the frame
+    CpuTemporalUpscaler used( kInputWidth, kInputHeight, kOutputWidth, kOutputHeight );
+    CpuTemporalUpscaler fresh( kInputWidth, kInputHeight, kOutputWidth, kOutputHeight );
+    scene.render( 0.2f, 0.1f, 0.f, false, color, motion );
+    used.encode( color.data(), motion.data(), 0.2f, 0.1f, true );
+    scene.render( -0.3f, 0.3f, 0.f, false, color, motion );
+    used.encode( color.data(), motion.data(), -0.3f, 0.3f, true );
+    fresh.encode( color.data(), motion.data(), -0.3f, 0.3f, true );
+    CHECK( memcmp( used.output(), fresh.output(), (size_t)kOutputWidth * kOutputHeight * 4 * sizeof( float ) ) == 0 );
+}
+
+int main()
+{
+    checkHalton();
+    checkJitter();
+    checkMotionHistory();
+    checkUpscaler();
+    return checkResult();
+}
@@ -0,0 +1,152 @@
+/**
+  ******************************************************************************
+  * @file           : test_tlsf_allocator.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+#include "check.hpp"
+#include "tlsf_allocator.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+static constexpr uint64_t kGranularity = 256;
+
+// the live allocations never overlap, sit inside the range at their alignment and add
+// up to what the allocator reports as used
+static void checkLive( const TlsfAllocator& tlsf, std::vector<TlsfAllocation> live, const std::vector<uint64_t>& aligns )
+{
+    uint64_t used = 0;
+    for ( size_t i = 0; i < live.size(); ++i )
+    {
+        CHECK( live[ i ].offset % aligns[ i ] == 0 );
+        CHECK( live[ i ].offset + live[ i ].size <= tlsf.capacity() );
+        used += live[ i ].size;
+    }
+
+    std::sort( live.begin(), live.end(), []( const TlsfAllocation& a, const TlsfAllocation& b ) { return a.offset < b.offset; } );
+    for ( size_t i = 1; i < live.size(); ++i )
+    {
+        CHECK( live[ i - 1 ].offset + live[ i - 1 ].size <= live[ i ].offset );
+    }
+
+    const TlsfStats stats = tlsf.stats();
+    CHECK( stats.usedBytes == used );
+    CHECK( stats.allocationCount == live.size() );
+    CHECK( stats.largestFreeBytes <= stats.freeBytes );
+}
+
+static void fuzz( uint32_t seed, uint64_t capacity, size_t steps )
+{
+    std::mt19937 rng( seed );
+    TlsfAllocator tlsf( capacity, kGranularity );
+    std::vector<TlsfAllocation> live;
+    std::vector<uint64_t> aligns;
+
+    for ( size_t step = 0; step < steps; ++step )
+    {
+        const uint32_t op = rng() % 100;
+        if ( op < 55 || live.empty() )
+        {
+            // mostly small, now and then a large one, sizes that are not granule multiples
+            const uint64_t size = rng() % 8 == 0 ? 1 + rng() % ( capacity / 8 ) : 1 + rng() % 16384;
+            const uint64_t align = (uint64_t)1 << ( rng() % 17 );
+            TlsfAllocation a;
+            if ( tlsf.allocate( size, align, a ) )
+            {
+                CHECK( a.size >= size && a.size % kGranularity == 0 );
+                live.push_back( a );
+                aligns.push_back( std::max( align, kGranularity ) );
+            }
+        }
+        else if ( op < 98 )
+        {
+            const size_t i = rng() % live.size();
+            tlsf.free( live[ i ] );
+            live[ i ] = live.back();
+            aligns[ i ] = aligns.back();
+            live.pop_back();
+            aligns.pop_back();
+        }
+        else
+        {
+            // moves only go down, then the sources are freed the way a caller would
+            std::vector<TlsfAllocator::Move> moves;
+            const size_t moved = tlsf.defragment( 1 + rng() % 8, moves );
+            CHECK( moved == moves.size() );
+            for ( const TlsfAllocator::Move& m : moves )
+            {
+                CHECK( m.to.offset < m.from.offset && m.to.size == m.from.size );
+                for ( size_t i = 0; i < live.size(); ++i )
+                {
+                    if ( live[ i ].block == m.from.block && live[ i ].offset == m.from.offset )
+                    {
+                        live[ i ] = m.to;
+                    }
+                }
+                tlsf.free( m.from );
+            }
+        }
+
+        if ( step % 64 == 0 )
+        {
+            checkLive( tlsf, live, aligns );
+        }
+    }
+    checkLive( tlsf, live, aligns );
+
+    // with everything freed the neighbours merge back into the whole range
+    for ( const TlsfAllocation& a : live )
+    {
+        tlsf.free( a );
+    }
+    const TlsfStats stats = tlsf.stats();
+    CHECK( stats.usedBytes == 0 && stats.allocationCount == 0 );
+    CHECK( stats.freeBlockCount == 1 && stats.largestFreeBytes == tlsf.capacity() );
+}
+
+int main()
+{
+    // an exact fit takes the whole range, one more byte does not fit
+    TlsfAllocator tlsf( 1 << 20, kGranularity );
+    TlsfAllocation whole, more;
+    CHECK( tlsf.allocate( 1 << 20, kGranularity, whole ) && whole.offset == 0 );
+    CHECK( !tlsf.allocate( 1, 1, more ) );
+    tlsf.free( whole );
+    CHECK( !tlsf.allocate( ( 1 << 20 ) + 1, 1, more ) );
+
+    // aligned above the granularity, the whole range still fits at offset 0: a
+    // dedicated heap is sized for its one texture, not for the worst case padding
+    for ( uint64_t align : { 16384ull, 65536ull } )
+    {
+        TlsfAllocator dedicated( 100 << 20, kGranularity );
+        TlsfAllocation texture;
+        CHECK( dedicated.allocate( 100 << 20, align, texture ) && texture.offset == 0 && texture.size == 100 << 20 );
+        CHECK( !dedicated.allocate( 1, 1, more ) );
+        dedicated.free( texture );
+        CHECK( dedicated.stats().freeBlockCount == 1 );
+    }
+
+    // and past a small allocation the first aligned offset is taken, when the rest
+    // only fits there
+    TlsfAllocator padded( 1 << 20, kGranularity );
+    TlsfAllocation small, aligned;
+    CHECK( padded.allocate( kGranularity, kGranularity, small ) && small.offset == 0 );
+    CHECK( padded.allocate( ( 1 << 20 ) - 65536, 65536, aligned ) && aligned.offset == 65536 );
+    CHECK( !padded.allocate( 65536, 65536, more ) );
+    CHECK( padded.allocate( 65536 - kGranularity, kGranularity, more ) && more.offset == kGranularity );
+
+    for ( uint32_t seed = 1; seed <= 16; ++seed )
+    {
+        fuzz( seed, (uint64_t)( 1 + seed % 4 ) << 22, 20000 );
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,247 @@
+/**
+  ******************************************************************************
+  * @file           : test_unique_ptr.cpp
+  * @author         : toastoffee
+  * @brief          : None
+  * @attention      : None
+  * @date           : 2026/10/18
+  ******************************************************************************
+  */
+
+
+
+// NS::UniquePtr on the stub runtime: every retain and release is a message the stub
+// counts, so ownership moves can be checked to cost none
+#define NS_PRIVATE_IMPLEMENTATION
+
+#include <Foundation/NSObject.hpp>
+#include <Foundation/NSSharedPtr.hpp>
+
+#include "check.hpp"
+#include "objc_stub.hpp"
+
+#include <utility>
+
+class Resource : public NS::Referencing<Resource>
+{
+};
+
+class Texture : public NS::Referencing<Texture, Resource>
+{
+};
+
+// the object behind the wrappers, alloc hands out the first reference
+struct StubObject
+{
+    objc_object header;
+    long references;
+};
+
+static size_t s_retains = 0;
+static size_t s_releases = 0;
+
+static StubObject* retain( StubObject* self, SEL )
+{
+    ++self->references;
+    ++s_retains;
+    return self;
+}
+
+static void release( StubObject* self, SEL )
+{
+    --self->references;
+    ++s_releases;
+}
+
+static Class s_class;
+
+static StubObject makeObject()
+{
+    return { { s_class }, 1 };
+}
+
+template <class _Class>
+static _Class* as( StubObject& object )
+{
+    return reinterpret_cast<_Class*>( &object );
+}
+
+// messages sent since the last call
+static size_t messages()
+{
+    static size_t last = 0;
+    const size_t now = objcStubCounts().messages;
+    const size_t sent = now - last;
+    last = now;
+    return sent;
+}
+
+static void checkOwnership()
+{
+    StubObject a = makeObject();
+    StubObject b = makeObject();
+    messages();
+    {
+        // taking over a new object's reference, moving and borrowing send nothing
+        NS::UniquePtr<Resource> first = NS::TransferPtr( as<Resource>( a ) );
+        NS::UniquePtr<Resource> second = std::move( first );
+        CHECK( !first && second.get() == as<Resource>( a ) );
+        CHECK( second.operator->() == as<Resource>( a ) );
+
+        NS::UniquePtr<Resource> third;
+        third = std::move( second );
+        CHECK( !second && third );
+
+        // moving onto itself keeps the object
+        NS::UniquePtr<Resource>& alias = third;
+        third = std::move( alias );
+        CHECK( third.get() == as<Resource>( a ) );
+        CHECK( messages() == 0 && a.references == 1 );
+
+        // moving onto an owner releases what it held
+        NS::UniquePtr<Resource> other = NS::TransferPtr( as<Resource>( b ) );
+        other = std::move( third );
+        CHECK( messages() == 1 && b.references == 0 );
+        CHECK( other.get() == as<Resource>( a ) );
+    }
+    // the last owner releases once
+    CHECK( messages() == 1 && a.references == 0 );
+}
+
+static void checkRetainAndShare()
+{
+    StubObject a = makeObject();
+    messages();
+    {
+        // a borrowed object is retained once and released once
+        NS::UniquePtr<Resource> owner = NS::RetainPtr( as<Resource>( a ) );
+        CHECK( messages() == 1 && a.references == 2 );
+
+        // share() is the one copy, an extra reference the SharedPtr gives back
+        {
+            NS::SharedPtr<Resource> shared = owner.share();
+            CHECK( messages() == 1 && a.references == 3 );
+            CHECK( shared.get() == owner.get() );
+        }
+        CHECK( messages() == 1 && a.references == 2 );
+    }
+    CHECK( messages() == 1 && a.references == 1 );
+}
+
+static void checkResetAndDetach()
+{
+    StubObject a = makeObject();
+    StubObject b = makeObject();
+    messages();
+
+    // resetting nothing sends nothing, not even to nil
+    NS::UniquePtr<Resource> empty;
+    empty.reset();
+    CHECK( messages() == 0 );
+
+    NS::UniquePtr<Resource> owner = NS::TransferPtr( as<Resource>( a ) );
+    owner.reset();
+    CHECK( !owner && messages() == 1 && a.references == 0 );
+
+    // detach hands the reference out, the caller releases it
+    owner = NS::TransferPtr( as<Resource>( b ) );
+    Resource* released = owner.detach();
+    CHECK( !owner && released == as<Resource>( b ) );
+    CHECK( messages() == 0 && b.references == 1 );
+    released->release();
+    CHECK( messages() == 1 && b.references == 0 );
+}
+
+static void checkConversion()
+{
+    StubObject a = makeObject();
+    messages();
+    {
+        // a texture owner moves into a resource owner without a message
+        NS::UniquePtr<Texture> texture = NS::TransferPtr( as<Texture>( a ) );
+        NS::UniquePtr<Resource> resource = std::move( texture );
+        CHECK( !texture && resource.get() == as<Resource>( a ) );
+        CHECK( messages() == 0 && a.references == 1 );
+    }
+    CHECK( messages() == 1 && a.references == 0 );
+}
+
+// a renderer's frames: the resources it owns are used a few times a frame. passed as a
+// SharedPtr by value every use is a retain and a release, borrowed from a UniquePtr none
+static size_t useByValue( NS::SharedPtr<Resource> resource )
+{
+    return resource ? 1 : 0;
+}
+
+static size_t useBorrowed( Resource* resource )
+{
+    return resource ? 1 : 0;
+}
+
+static void checkFrames()
+{
+    static constexpr int kObjects = 8;
+    static constexpr int kFrames = 1000;
+    static constexpr int kUses = 8;
+
+    StubObject objects[ kObjects ];
+    for ( StubObject& object : objects )
+    {
+        object = makeObject();
+    }
+
+    s_retains = s_releases = 0;
+    size_t uses = 0;
+    {
+        NS::SharedPtr<Resource> shared[ kObjects ];
+        for ( int i = 0; i < kObjects; ++i )
+        {
+            shared[ i ] = NS::RetainPtr( as<Resource>( objects[ i ] ) );
+        }
+        for ( int frame = 0; frame < kFrames; ++frame )
+        {
+            for ( int use = 0; use < kUses; ++use )
+            {
+                uses += useByValue( shared[ ( frame + use ) % kObjects ] );
+            }
+        }
+    }
+    CHECK( s_retains == kObjects + (size_t)kFrames * kUses && s_releases == s_retains );
+
+    s_retains = s_releases = 0;
+    {
+        NS::UniquePtr<Resource> owned[ kObjects ];
+        for ( int i = 0; i < kObjects; ++i )
+        {
+            owned[ i ] = NS::RetainPtr( as<Resource>( objects[ i ] ) );
+        }
+        for ( int frame = 0; frame < kFrames; ++frame )
+        {
+            for ( int use = 0; use < kUses; ++use )
+            {
+                uses += useBorrowed( owned[ ( frame + use ) % kObjects ].get() );
+            }
+        }
+    }
+    CHECK( s_retains == kObjects && s_releases == kObjects );
+    CHECK( uses == 2 * (size_t)kFrames * kUses );
+
+    for ( const StubObject& object : objects )
+    {
+        CHECK( object.references == 1 );
+    }
+}
+
+int main()
+{
+    s_class = objc_lookUpClass( "StubObject" );
+    class_addMethod( s_class, sel_registerName( "retain" ), (IMP)&retain, "@@:" );
+    class_addMethod( s_class, sel_registerName( "release" ), (IMP)&release, "v@:" );
+
+    checkOwnership();
+    checkRetainAndShare();
+    checkResetAndDetach();
+    checkConversion();
+    checkFrames();
+    return checkResult();
+}